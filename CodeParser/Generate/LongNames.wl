@@ -45,6 +45,14 @@ validateLongNameMap[m_] := (
     Print["LongName map is not ordered"];
     Quit[1]
   ];
+
+  (*
+  isRaw and isUndocumentedLongName look up names by code point
+  *)
+  If[!DuplicateFreeQ[longNameToCharacterCode /@ Keys[m]],
+    Print["LongName map has duplicate code points"];
+    Quit[1]
+  ];
 )
 
 
@@ -194,13 +202,131 @@ $lexSortedImportedLongNames = lexSort[Keys[importedLongNames]];
 
 
 (*
-\r\n is technically multi-byte...
+Classes of multi-byte characters
+
+Each code point has a bitmask of classes, and the tokenizer dispatches on the bitmask with a single lookup
+
+The bits are the same as MBCLASS_ in LongNames.h
+*)
+mbClassBits = <|
+  PunctuationCharacter -> 16^^01,
+  WhitespaceCharacter -> 16^^02,
+  NewlineCharacter -> 16^^04,
+  UninterpretableCharacter -> 16^^08,
+  UnsupportedCharacter -> 16^^10
+|>;
+
+mbClassNotStrangeLetterlikeBit = 16^^20;
+
+mbClassLinearSyntaxBit = 16^^40;
+
+(*
+The same as the positive CODEPOINT_LINEARSYNTAX_ code points in CodePoint.h
+*)
+linearSyntaxCodePoints = {16^^f7c0, 16^^f7c1, 16^^f7c2, 16^^f7c5, 16^^f7c6, 16^^f7c7, 16^^f7c8, 16^^f7c9, 16^^f7ca, 16^^f7cb, 16^^f7cc, 16^^f7cd};
+
+(*
+Two-stage table of classes
+
+The code points are split into blocks of 256, and blocks with the same classes are only stored once
+
+Stage 1 is the index of the block of each code point, and stage 2 is the blocks
+
+Block 0 has no classes, and code points past the last block have no classes
+*)
+mbClassBlockSize = 256;
+
+buildMBClassTable[] :=
+Module[{classes, addClass, blockCount, blocks, uniqueBlocks, stage1},
+  Print["building multi-byte class table... \[WatchIcon]"];
+
+  classes = <||>;
+
+  addClass[point_, bit_] :=
+    classes[point] = BitOr[Lookup[classes, point, 0], bit];
+
+  KeyValueMap[
+    If[KeyExistsQ[mbClassBits, #2[[1]]],
+      addClass[#2[[2]], mbClassBits[#2[[1]]]]
+    ]&
+    ,
+    importedLongNames
+  ];
+
+  Scan[addClass[longNameToCharacterCode[#], mbClassNotStrangeLetterlikeBit]&, importedNotStrangeLetterlikeLongNames];
+
+  Scan[addClass[#, mbClassLinearSyntaxBit]&, linearSyntaxCodePoints];
+
+  blockCount = Quotient[Max[Keys[classes]], mbClassBlockSize] + 1;
+
+  blocks = Table[Lookup[classes, mbClassBlockSize b + i, 0], {b, 0, blockCount - 1}, {i, 0, mbClassBlockSize - 1}];
+
+  uniqueBlocks = DeleteDuplicates[Prepend[blocks, ConstantArray[0, mbClassBlockSize]]];
+
+  If[Length[uniqueBlocks] > 256,
+    Print["multi-byte class block index does not fit in uint8_t"];
+    Quit[1]
+  ];
+
+  stage1 = (FirstPosition[uniqueBlocks, #, {Missing[]}, {1}][[1]] - 1)& /@ blocks;
+
+  {stage1, Flatten[uniqueBlocks]}
+]
+
+{mbClassStage1, mbClassStage2} = buildMBClassTable[];
+
+
+
+
+(*
+Minimal perfect hash of long names
+
+Hash and displace: every name is first hashed with seed 0 into one of longNameHashBucketCount buckets
+
+Then, starting with the largest buckets, find the smallest seed for each bucket that sends all of its names to
+free slots
 
-Put CodePoint`CRLF before actual code points
+The same FNV-1a hash is implemented in C++ in LongNames::findLongName
 *)
-mbNewlines = toGlobal /@ ( { CodePoint`CRLF } ~Join~ ( ("CodePoint`LongName`"<>#)& /@ SortBy[importedNewlineLongNames, longNameToCharacterCode]));
+fnv1a[seed_Integer, name_String] :=
+  Fold[Mod[BitXor[#1, #2] * 16777619, 2^32]&, BitXor[2166136261, seed], ToCharacterCode[name, "UTF8"]]
 
+longNameHashBucketCount = Ceiling[Length[$lexSortedImportedLongNames] / 2];
 
+buildLongNameHash[names_] :=
+Module[{n, buckets, order, seeds, slots, d, s},
+  Print["building LongName hash... \[WatchIcon]"];
+
+  n = Length[names];
+
+  buckets = GroupBy[Range[n], Mod[fnv1a[0, names[[#]]], longNameHashBucketCount]&];
+
+  order = SortBy[Keys[buckets], {-Length[buckets[#]]&, Identity}];
+
+  seeds = ConstantArray[0, longNameHashBucketCount];
+  slots = ConstantArray[-1, n];
+
+  Do[
+    d = 1;
+    While[
+      s = Mod[fnv1a[d, names[[#]]], n]& /@ buckets[b];
+      !(DuplicateFreeQ[s] && AllTrue[s, slots[[# + 1]] == -1&])
+      ,
+      d++
+    ];
+    seeds[[b + 1]] = d;
+    MapThread[(slots[[#1 + 1]] = #2 - 1)&, {s, buckets[b]}];
+    ,
+    {b, order}
+  ];
+
+  If[Max[seeds] >= 2^16,
+    Print["LongName hash seed does not fit in uint16_t"];
+    Quit[1]
+  ];
+
+  {seeds, slots}
+]
 
 longNameToCodePointMapNames = {
 "//",
@@ -218,6 +344,45 @@ longNameToCodePointMapPoints = {
   (Row[{toGlobal["CodePoint`LongName`"<>#], ","}]& /@ $lexSortedImportedLongNames) ~Join~
   {"}};", ""};
 
+{longNameHashSeeds, longNameHashSlots} = buildLongNameHash[$lexSortedImportedLongNames];
+
+longNameHashSource = {
+"//",
+"// Seed of each bucket",
+"//",
+"std::array<uint16_t, LONGNAMES_HASH_BUCKETS> LongNameHash_seeds {{"} ~Join~
+  (Row[{#, ","}]& /@ longNameHashSeeds) ~Join~
+  {"}};", "",
+"//",
+"// Index into LongNameToCodePointMap_names of the name in each slot",
+"//",
+"std::array<uint16_t, LONGNAMES_COUNT> LongNameHash_slots {{"} ~Join~
+  (Row[{#, ","}]& /@ longNameHashSlots) ~Join~
+  {"}};", "",
+"static uint32_t longNameHash(uint32_t seed, const unsigned char *name, size_t len) {",
+"  uint32_t h = 2166136261u ^ seed;",
+"  for (size_t i = 0; i < len; i++) {",
+"    h ^= name[i];",
+"    h *= 16777619u;",
+"  }",
+"  return h;",
+"}",
+"",
+"//",
+"//",
+"//",
+"int LongNames::findLongName(const unsigned char *name, size_t len) {",
+"  auto seed = LongNameHash_seeds[longNameHash(0, name, len) % LONGNAMES_HASH_BUCKETS];",
+"  auto idx = LongNameHash_slots[longNameHash(seed, name, len) % LONGNAMES_COUNT];",
+"  const auto& candidate = LongNameToCodePointMap_names[idx];",
+"  if (candidate.size() != len || memcmp(candidate.data(), name, len) != 0) {",
+"    return -1;",
+"  }",
+"  return idx;",
+"}",
+""
+};
+
 codePointToLongNameMapPoints = {
 "//",
 "//",
@@ -234,44 +399,25 @@ codePointToLongNameMapNames = {
   (Row[{escapeString[#], ","}] & /@ SortBy[Keys[importedLongNames], longNameToCharacterCode]) ~Join~
   {"}};", ""};
 
-rawSet = {
-"//",
-"//",
-"//",
-"std::array<std::string, RAWLONGNAMES_COUNT> RawSet {{"} ~Join~
-(Row[{"{", "\""<>#<>"\"", "}", ","}]& /@ lexSort[importedRawLongNames]) ~Join~
-{"}};",
-"
-//
-//
-//
-bool LongNames::isRaw(std::string LongNameStr) {
-  auto it =  std::lower_bound(RawSet.begin(), RawSet.end(), LongNameStr);
-  return it != RawSet.end() && *it == LongNameStr;
-}
-"};
-
-
-
-notStrangeLetterlikeSource = 
+rawSource = 
   {
     "//",
+    "// RawDoubleQuote and RawBackslash map to string meta characters, which are not ordered by character code, so use a switch instead of a search",
     "//",
-    "//",
-    "std::array<codepoint, MBNOTSTRANGELETTERLIKECODEPOINTS_COUNT> mbNotStrangeLetterlikeCodePoints {{"} ~Join~
-    (Row[{toGlobal["CodePoint`LongName`"<>#], ","}]& /@ SortBy[importedNotStrangeLetterlikeLongNames, longNameToCharacterCode]) ~Join~
-    {"}};",
-    "",
-    "//",
-    "//",
-    "//",
-    "bool LongNames::isMBNotStrangeLetterlike(codepoint point) { ",
-    "auto it = std::lower_bound(mbNotStrangeLetterlikeCodePoints.begin(), mbNotStrangeLetterlikeCodePoints.end(), point);",
-    "return it != mbNotStrangeLetterlikeCodePoints.end() && *it == point;",
-    "}",
-    ""
+    "bool LongNames::isRaw(codepoint point) {",
+    "switch (point) {"} ~Join~
+    (Row[{"case", " ", toGlobal["CodePoint`LongName`"<>#], ":"}]& /@ SortBy[importedRawLongNames, longNameToCharacterCode]) ~Join~
+    {
+      "return true;",
+      "default:",
+      "return false;",
+      "}",
+      "}",
+      ""
   };
 
+
+
 asciiReplacementsSource = 
   {
     "//",
@@ -320,95 +466,20 @@ replacementGraphicalSource =
     ""
   };
 
-punctuationSource = 
-  {
-    "//",
-    "//",
-    "//",
-    "std::array<codepoint, MBPUNCTUATIONCODEPOINTS_COUNT> mbPunctuationCodePoints {{"} ~Join~
-    (Row[{toGlobal["CodePoint`LongName`"<>#], ","}]& /@ SortBy[importedPunctuationLongNames, longNameToCharacterCode]) ~Join~
-    {"}};", "",
-    "//",
-    "//",
-    "//",
-    "bool LongNames::isMBPunctuation(codepoint point) { ",
-    "auto it = std::lower_bound(mbPunctuationCodePoints.begin(), mbPunctuationCodePoints.end(), point);",
-    "return it != mbPunctuationCodePoints.end() && *it == point;",
-    "}",
-    ""
-  };
-
-whitespaceSource = 
-  {
-    "//",
-    "//",
-    "//",
-    "std::array<codepoint, MBWHITESPACECODEPOINTS_COUNT> mbWhitespaceCodePoints {{"} ~Join~
-    (Row[{toGlobal["CodePoint`LongName`"<>#], ","}]& /@ SortBy[importedWhitespaceLongNames, longNameToCharacterCode]) ~Join~
-    {"}};", "",
-    "//",
-    "//",
-    "//",
-    "bool LongNames::isMBWhitespace(codepoint point) {",
-    "auto it = std::lower_bound(mbWhitespaceCodePoints.begin(), mbWhitespaceCodePoints.end(), point);",
-    "return it != mbWhitespaceCodePoints.end() && *it == point;",
-    "}",
-    ""
-  };
-
-newlineSource = 
-  {
-    "//",
-    "//",
-    "//",
-    "std::array<codepoint, MBNEWLINECODEPOINTS_COUNT> mbNewlineCodePoints {{"} ~Join~
-    (Row[{#, ","}]& /@ mbNewlines) ~Join~
-    {"}};", "",
-    "//",
-    "//",
-    "//",
-    "bool LongNames::isMBNewline(codepoint point) {",
-    "auto it = std::lower_bound(mbNewlineCodePoints.begin(), mbNewlineCodePoints.end(), point);",
-    "return it != mbNewlineCodePoints.end() && *it == point;",
-    "}",
-    ""
-  };
-
-uninterpretableSource = 
-  {
-    "//",
-    "//",
-    "//",
-    "std::array<codepoint, MBUNINTERPRETABLECODEPOINTS_COUNT> mbUninterpretableCodePoints {{"} ~Join~
-    (Row[{toGlobal["CodePoint`LongName`"<>#], ","}]& /@ SortBy[importedUninterpretableLongNames, longNameToCharacterCode]) ~Join~
-    {"}};", "",
-    "//",
-    "//",
-    "//",
-    "bool LongNames::isMBUninterpretable(codepoint point) {",
-    "auto it = std::lower_bound(mbUninterpretableCodePoints.begin(), mbUninterpretableCodePoints.end(), point);",
-    "return it != mbUninterpretableCodePoints.end() && *it == point;",
-    "}",
-    ""
-  };
-
-unsupportedSource = 
+mbClassSource = 
   {
     "//",
+    "// Index into MBClass_stage2 of the block of each 256 code points",
     "//",
-    "//",
-    "std::array<codepoint, UNSUPPORTEDLONGNAMESCODEPOINTS_COUNT> unsupportedLongNameCodePoints {{"} ~Join~
-    (Row[{toGlobal["CodePoint`LongName`"<>#], ","}]& /@ SortBy[importedUnsupportedLongNames, Identity]) ~Join~
+    "std::array<uint8_t, MBCLASS_STAGE1_COUNT> MBClass_stage1 {{"} ~Join~
+    (StringRiffle[ToString /@ #, ", "] <> ","& /@ Partition[mbClassStage1, UpTo[16]]) ~Join~
     {"}};", "",
     "//",
+    "// MBCLASS_ bits of each code point in each block",
     "//",
-    "//",
-    "bool LongNames::isUnsupportedLongNameCodePoint(codepoint point) {",
-    "auto it =  std::lower_bound(unsupportedLongNameCodePoints.begin(), unsupportedLongNameCodePoints.end(), point);",
-    "return it != unsupportedLongNameCodePoints.end() && *it == point;",
-    "}",
-    ""
-  };
+    "std::array<uint8_t, MBCLASS_STAGE2_COUNT> MBClass_stage2 {{"} ~Join~
+    (StringRiffle[ToString /@ #, ", "] <> ","& /@ Partition[mbClassStage2, UpTo[16]]) ~Join~
+    {"}};", ""};
 
 LongNameCodePointToOperatorSource = 
   {
@@ -444,48 +515,105 @@ longNamesCPPHeader = {
 
 #include \"CodePoint.h\" // for codepoint
 
+#include <cstddef> // for size_t
+#include <cstdint> // for uint8_t, uint16_t
 #include <string>
 #include <array>
 #include <map>
 #include <vector>
 
 constexpr size_t LONGNAMES_COUNT = " <> ToString[Length[importedLongNames]] <> ";
+constexpr size_t LONGNAMES_HASH_BUCKETS = " <> ToString[longNameHashBucketCount] <> ";
 constexpr size_t RAWLONGNAMES_COUNT = " <> ToString[Length[importedRawLongNames]] <> ";
 
-constexpr size_t MBNOTSTRANGELETTERLIKECODEPOINTS_COUNT = " <> ToString[Length[importedNotStrangeLetterlikeLongNames]] <> ";
-constexpr size_t MBPUNCTUATIONCODEPOINTS_COUNT = " <> ToString[Length[importedPunctuationLongNames]] <> ";
-constexpr size_t MBWHITESPACECODEPOINTS_COUNT = " <> ToString[Length[importedWhitespaceLongNames]] <> ";
-constexpr size_t MBNEWLINECODEPOINTS_COUNT = " <> ToString[Length[mbNewlines]] <> ";
-constexpr size_t MBUNINTERPRETABLECODEPOINTS_COUNT = " <> ToString[Length[importedUninterpretableLongNames]] <> ";
-constexpr size_t UNSUPPORTEDLONGNAMESCODEPOINTS_COUNT = " <> ToString[Length[importedUnsupportedLongNames]] <> ";
+constexpr size_t MBCLASS_STAGE1_COUNT = " <> ToString[Length[mbClassStage1]] <> ";
+constexpr size_t MBCLASS_STAGE2_COUNT = " <> ToString[Length[mbClassStage2]] <> ";
+
+//
+// Classes of multi-byte characters, from LongNames::mbClass
+//
+// Long names have at most 1 of the first 5 classes, and letterlike long names have none of them
+//
+constexpr uint8_t MBCLASS_PUNCTUATION(0x01);
+constexpr uint8_t MBCLASS_WHITESPACE(0x02);
+constexpr uint8_t MBCLASS_NEWLINE(0x04);
+constexpr uint8_t MBCLASS_UNINTERPRETABLE(0x08);
+constexpr uint8_t MBCLASS_UNSUPPORTED(0x10);
+constexpr uint8_t MBCLASS_NOTSTRANGELETTERLIKE(0x20);
+constexpr uint8_t MBCLASS_LINEARSYNTAX(0x40);
+//
+// Only for the negative string meta code points, which are not in the table
+//
+constexpr uint8_t MBCLASS_STRINGMETA(0x80);
 
 extern std::array<std::string, LONGNAMES_COUNT> LongNameToCodePointMap_names;
 extern std::array<codepoint, LONGNAMES_COUNT> LongNameToCodePointMap_points;
 extern std::array<codepoint, LONGNAMES_COUNT> CodePointToLongNameMap_points;
 extern std::array<std::string, LONGNAMES_COUNT> CodePointToLongNameMap_names;
 
+extern std::array<uint16_t, LONGNAMES_HASH_BUCKETS> LongNameHash_seeds;
+extern std::array<uint16_t, LONGNAMES_COUNT> LongNameHash_slots;
+
+extern std::array<uint8_t, MBCLASS_STAGE1_COUNT> MBClass_stage1;
+extern std::array<uint8_t, MBCLASS_STAGE2_COUNT> MBClass_stage2;
+
 //
 // Collection of utility functions for codepoints and long names
 //
 class LongNames {
 public:
     
-    static bool isMBNotStrangeLetterlike(codepoint point);
-
-    static bool isMBPunctuation(codepoint point);
-
-    static bool isMBWhitespace(codepoint point);
-
-    static bool isMBNewline(codepoint point);
-
-    static bool isMBUninterpretable(codepoint point);
-
-    static bool isUnsupportedLongNameCodePoint(codepoint point);
-
+    //
+    // MBCLASS_ bits of point
+    //
+    // Negative code points have no classes here
+    //
+    static uint8_t mbClass(codepoint point) {
+        auto u = static_cast<uint32_t>(point);
+        if (u >= MBCLASS_STAGE1_COUNT * 256) {
+            return 0;
+        }
+        return MBClass_stage2[MBClass_stage1[u >> 8] * 256 + (u & 0xff)];
+    }
+    
+    static bool isMBNotStrangeLetterlike(codepoint point) {
+        return (mbClass(point) & MBCLASS_NOTSTRANGELETTERLIKE) != 0;
+    }
+    
+    static bool isMBPunctuation(codepoint point) {
+        return (mbClass(point) & MBCLASS_PUNCTUATION) != 0;
+    }
+    
+    static bool isMBWhitespace(codepoint point) {
+        return (mbClass(point) & MBCLASS_WHITESPACE) != 0;
+    }
+    
+    //
+    // \\r\\n is technically multi-byte
+    //
+    static bool isMBNewline(codepoint point) {
+        return point == CODEPOINT_CRLF || (mbClass(point) & MBCLASS_NEWLINE) != 0;
+    }
+    
+    static bool isMBUninterpretable(codepoint point) {
+        return (mbClass(point) & MBCLASS_UNINTERPRETABLE) != 0;
+    }
+    
+    static bool isUnsupportedLongNameCodePoint(codepoint point) {
+        return (mbClass(point) & MBCLASS_UNSUPPORTED) != 0;
+    }
+    
     //
     // Is this \\[Raw] something?
     //
-    static bool isRaw(std::string LongNameStr);
+    static bool isRaw(codepoint point);
+
+    //
+    // Index of name in LongNameToCodePointMap_names, or -1 if name is not a long name
+    //
+    // Uses a minimal perfect hash, so there is no allocation and no search
+    //
+    static int findLongName(const unsigned char *name, size_t len);
 
     static std::vector<std::string> asciiReplacements(codepoint point);
 
@@ -516,22 +644,18 @@ longNamesCPPSource = {
 
 #include \"LongNames.h\"
 
-#include <algorithm> // for std::lower_bound
 #include <cassert>
+#include <cstring> // for memcmp
 "} ~Join~
 longNameToCodePointMapNames ~Join~
 longNameToCodePointMapPoints ~Join~
+longNameHashSource ~Join~
 codePointToLongNameMapPoints ~Join~
 codePointToLongNameMapNames ~Join~
-rawSet ~Join~
-notStrangeLetterlikeSource ~Join~
+rawSource ~Join~
 asciiReplacementsSource ~Join~
 replacementGraphicalSource ~Join~
-punctuationSource ~Join~
-whitespaceSource ~Join~
-newlineSource ~Join~
-uninterpretableSource ~Join~
-unsupportedSource ~Join~
+mbClassSource ~Join~
 LongNameCodePointToOperatorSource;
 
 Print["exporting LongNames.cpp"];
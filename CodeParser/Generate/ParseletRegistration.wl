@@ -194,7 +194,7 @@ parseletRegistrationCPPSource = {
 #include \"ParseletRegistration.h\"
 
 #include \"Parselet.h\" // for SymbolParselet, UnderParselet, etc.
-#include \"ByteDecoder.h\" // for TheByteDecoder
+#include \"ByteDecoder.h\" // for ByteDecoder
 
 #include <cassert>
 
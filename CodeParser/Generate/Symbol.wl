@@ -88,22 +88,24 @@ Module[{ctxt},
 
 
 symbols = Union[Join[
-    {Blank, BlankSequence, BlankNullSequence, EndOfFile, Integer, Integral, Integrate, Null, Out, Optional, Pattern,
+    {All, Blank, BlankSequence, BlankNullSequence, EndOfFile, Integer, Integral, Integrate, Null, Out, Optional, Part, Pattern,
       Rational, Real, Slot, SlotSequence, String, Symbol, TagSet, TagSetDelayed, TagUnset, Unset, Whitespace},
     {CodeParser`Library`MakeLeafNode,
-      CodeParser`Library`MakeErrorNode, CodeParser`Library`MakeUnterminatedTokenErrorNeedsReparseNode,
+      CodeParser`Library`MakeErrorNode,
       CodeParser`Library`MakePrefixNode,
       CodeParser`Library`MakeBinaryNode, CodeParser`Library`MakeInfixNode,
             CodeParser`Library`MakeTernaryNode, CodeParser`Library`MakePostfixNode, CodeParser`Library`MakeCallNode,
             CodeParser`Library`MakeGroupNode,
             CodeParser`Library`MakeCompoundNode,
             CodeParser`Library`MakeSyntaxErrorNode,
-            CodeParser`Library`MakeGroupMissingCloserNode, CodeParser`Library`MakeUnterminatedGroupNeedsReparseNode,
+            CodeParser`Library`MakeGroupMissingCloserNode, CodeParser`Library`MakeUnterminatedGroupNode,
             CodeParser`Library`MakePrefixBinaryNode,
             CodeParser`Library`MakeSyntaxIssue, CodeParser`Library`MakeReplaceTextCodeAction, CodeParser`Library`MakeInsertTextCodeAction,
             CodeParser`Library`MakeFormatIssue, CodeParser`Library`MakeDeleteTextCodeAction, CodeParser`Library`MakeDeleteTriviaCodeAction,
             CodeParser`Library`MakeEncodingIssue,
-            CodeParser`Library`MakeInsertTextAfterCodeAction, CodeParser`Library`MakeSourceCharacterNode, CodeParser`Library`MakeSafeStringNode},
+            CodeParser`Library`MakeInsertTextAfterCodeAction, CodeParser`Library`MakeSourceCharacterNode, CodeParser`Library`MakeSafeStringNode,
+            CodeParser`Library`MakeAbstractLeafNode, CodeParser`Library`MakeAbstractCallNode, CodeParser`Library`MakeAbstractFallbackNode,
+            CodeParser`Library`MakeAbstractTopLevelFallbackNode, CodeParser`Library`MakeAbstractSource},
     {CodeParser`InternalInvalid, CodeParser`PatternBlank, CodeParser`PatternBlankSequence,
       CodeParser`PatternBlankNullSequence, CodeParser`PatternOptionalDefault},
     {CodeParser`SourceCharacter},
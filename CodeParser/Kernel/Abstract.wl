@@ -5,6 +5,16 @@ Aggregate
 Abstract
 
 
+(*
+For abstract syntax that comes from the library
+*)
+abstractNativeContainer
+
+abstractFallback
+
+topLevelFallback
+
+
 
 $AggregateParseProgress
 
@@ -401,18 +411,68 @@ abstract[PrefixBinaryNode[op_, {_, operand1_, operand2_}, data_]] := CallNode[To
 
 
 abstract[ContainerNode[tag_, childrenIn_, dataIn_]] :=
-Catch[
-Module[{abstracted, issues, issues1, issues2, data, abstractedChildren, node, reportIssues, children},
+Module[{abstractedChildren, issues1},
 
-	children = childrenIn;
+	{abstractedChildren, issues1} = abstractTopLevelChildren[childrenIn, (tag === File)];
 
-	data = dataIn;
+	abstractContainer[tag, abstractedChildren, issues1, dataIn]
+]
 
-	reportIssues = (tag === File);
 
-	issues = {};
+(*
+The children of a container that was abstracted by the library
+
+Nodes that the library did not abstract were given back as abstractFallback[cst], so abstract them here
+
+Strange top-level children were given back as topLevelFallback[cst], so give their issues here
+
+Tokens are normalized as in Abstract, but only inside of the nodes given back: the library gives back any node that
+has a token that needs normalizing
+*)
+abstractNativeContainer[tag_, childrenIn_, dataIn_] :=
+Block[{$RecursionLimit = Infinity},
+Module[{children, abstractedChildren, issues1, issuesMaybe, normalizeData, data},
+
+	normalizeData = KeyTake[dataIn, {"SimpleLineContinuations", "ComplexLineContinuations", "EmbeddedNewlines", "EmbeddedTabs"}];
+
+	data = KeyDrop[dataIn, Keys[normalizeData]];
+
+	children = childrenIn /. abstractFallback[cst_] :> abstract[normalizeFallback[aggregate[cst], normalizeData]];
+
+	{abstractedChildren, issuesMaybe} =
+		Reap[
+			Replace[children, topLevelFallback[cst_] :>
+				With[{agg = normalizeFallback[aggregate[cst], normalizeData]},
+					Sow[topLevelChildIssues[agg, (tag === File)]];
+					abstract[agg]
+				], {1}]
+			,
+			_
+			,
+			Flatten[#2]&
+		];
+
+	If[issuesMaybe == {},
+		issues1 = {}
+		,
+		issues1 = issuesMaybe[[1]]
+	];
+
+	abstractContainer[tag, abstractedChildren, issues1, data]
+]]
 
-	{abstractedChildren, issues1} = abstractTopLevelChildren[children, reportIssues];
+
+normalizeFallback[agg_, <||>] :=
+	agg
+
+normalizeFallback[agg_, normalizeData_] :=
+	normalizeTokens[ContainerNode[File, {agg}, normalizeData]][[2, 1]]
+
+
+abstractContainer[tag_, abstractedChildren_, issues1_, dataIn_] :=
+Module[{abstracted, issues, issues2, data, node},
+
+	data = dataIn;
 
 	{abstracted, issues2} = abstractTopLevel[abstractedChildren];
 
@@ -426,8 +486,7 @@ Module[{abstracted, issues, issues1, issues2, data, abstractedChildren, node, re
 	node = ContainerNode[tag, abstracted, data];
 
 	node
-]]
-
+]
 
 
 matchingOperatorPatterns[CallNode[LeafNode[Symbol, "EndPackage", _], {}, _]] = _PackageNode
@@ -167,7 +167,6 @@ TernaryOptionalPattern
 (* node symbols *)
 LeafNode
 ErrorNode
-UnterminatedTokenErrorNeedsReparseNode
 BoxNode
 CodeNode
 DirectiveNode
@@ -189,7 +188,6 @@ ContainerNode
 SyntaxErrorNode
 GroupMissingCloserNode
 UnterminatedGroupNode
-UnterminatedGroupNeedsReparseNode
 (*
 GroupMissingOpenerNode is only used in Boxes
 *)
@@ -272,7 +270,6 @@ Needs["CodeParser`Node`"]
 Needs["CodeParser`Abstract`"]
 Needs["CodeParser`Boxes`"]
 Needs["CodeParser`Definitions`"]
-Needs["CodeParser`Error`"]
 Needs["CodeParser`Library`"]
 Needs["CodeParser`Quirks`"]
 Needs["CodeParser`Shims`"]
@@ -304,6 +301,62 @@ setupShims[]
 
 
 
+(*
+The UTF-8 bytes of s as a ByteArray, which the library reads in place
+
+Falls back to a list of bytes where ByteArray[{}] is not valid
+*)
+utf8Bytes[s_String] :=
+  Replace[StringToByteArray[s, "UTF8"], Except[_?ByteArrayQ] :> ToCharacterCode[s, "UTF8"]]
+
+(*
+When running serially and every input is a ByteArray, call byteArrayFunc on each input so that the library reads the
+kernel's memory in place, instead of each input being copied over a link as a list of integers
+
+Otherwise call listableFunc with lists of integers
+
+args are given to both as they are, except that booleans are given to listableFunc as 0 or 1
+*)
+bytesListable[listableFunc_, byteArrayFunc_, bytess_List, threadCount_, args___] :=
+  If[threadCount <= 1 && AllTrue[bytess, ByteArrayQ],
+    byteArrayListable[byteArrayFunc, bytess, args]
+    ,
+    libraryFunctionWrapper[listableFunc, Replace[bytess, ba_?ByteArrayQ :> Normal[ba], {1}], Sequence @@ Replace[{args}, b:(True | False) :> Boole[b], {1}], threadCount]
+  ]
+
+(*
+Built with the expr library, byteArrayFunc returns a pointer to the result, which is taken as in ExprTest
+
+Otherwise a tree cannot be returned through an MArgument, so the library still sends the whole tree over the callback
+link and sets $ByteArrayResult by evaluating it there
+*)
+byteArrayListable[byteArrayFunc_, bas_List, args___] :=
+Catch[
+  Function[{ba},
+    Block[{$ByteArrayResult, res, e},
+
+      res = libraryFunctionWrapper[byteArrayFunc, ba, args];
+
+      If[FailureQ[res],
+        Throw[res]
+      ];
+
+      If[IntegerQ[res],
+
+        e = CodeParser`Library`Private`$exprCompiledLibFuns["Expr_FromPointer"][res];
+
+        CodeParser`Library`Private`$exprCompiledLibFuns["Expr_Release"][e];
+
+        e
+        ,
+        $ByteArrayResult
+      ]
+    ]
+  ] /@ bas
+]
+
+
+
 CodeConcreteParse::usage = "CodeConcreteParse[code] returns a concrete syntax tree by interpreting code as WL input. \
 code can be a string, a file, or a list of bytes."
 
@@ -312,7 +365,8 @@ Options[CodeConcreteParse] = {
   SourceConvention -> "LineColumn",
   "TabWidth" :> $DefaultTabWidth,
   ContainerNode -> Automatic,
-  "FileFormat" -> Automatic
+  "FileFormat" -> Automatic,
+  "ThreadCount" -> 1
 }
 
 CodeConcreteParse[s_String, opts:OptionsPattern[]] :=
@@ -339,7 +393,7 @@ Module[{csts, bytess, encoding, fileFormat, firstLineIsShebang},
     Throw[Failure["OnlyUTF8Supported", <|"CharacterEncoding"->encoding|>]]
   ];
 
-  bytess = ToCharacterCode[ss, "UTF8"];
+  bytess = utf8Bytes /@ ss;
 
   Switch[fileFormat,
     "Script",
@@ -355,34 +409,20 @@ Module[{csts, bytess, encoding, fileFormat, firstLineIsShebang},
     Throw[csts]
   ];
 
-  csts =
-    MapThread[Function[{cst, bytes},
-      
-        Block[{UnterminatedGroupNeedsReparseNode, UnterminatedTokenErrorNeedsReparseNode},
-
-          UnterminatedGroupNeedsReparseNode[args___] := reparseUnterminatedGroupNode[{args}, bytes, FilterRules[{opts}, Options[reparseUnterminatedGroupNode]]];
-          UnterminatedTokenErrorNeedsReparseNode[args___] := reparseUnterminatedTokenErrorNode[{args}, bytes, FilterRules[{opts}, Options[reparseUnterminatedTokenErrorNode]]];
-
-          cst
-        ]
-      ]
-      ,
-      {csts, bytess}
-    ];
-
   csts
 ]]
 
 
 Options[concreteParseStringListable] = Options[CodeConcreteParse]
 
-concreteParseStringListable[bytess:{{_Integer...}...}, firstLineIsShebang_, OptionsPattern[]] :=
+concreteParseStringListable[bytess:{({_Integer...} | _?ByteArrayQ)...}, firstLineIsShebang_, OptionsPattern[]] :=
 Catch[
-Module[{res, convention, container, tabWidth},
+Module[{res, convention, container, tabWidth, threadCount},
 
   convention = OptionValue[SourceConvention];
   container = OptionValue[ContainerNode];
   tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
 
   (*
   The <||> will be filled in with Source later
@@ -403,7 +443,7 @@ Module[{res, convention, container, tabWidth},
   $ConcreteParseTime = Quantity[0, "Seconds"];
 
   Block[{$StructureSrcArgs = parseConvention[convention]},
-  res = libraryFunctionWrapper[concreteParseBytesListableFunc, bytess, convention, tabWidth, Boole[firstLineIsShebang]];
+  res = bytesListable[concreteParseBytesListableFunc, concreteParseByteArrayFunc, bytess, threadCount, convention, tabWidth, firstLineIsShebang];
   ];
 
   $ConcreteParseProgress = 100;
@@ -430,7 +470,9 @@ Options[CodeParse] = {
   SourceConvention -> "LineColumn",
   "TabWidth" :> $DefaultTabWidth,
   ContainerNode -> Automatic,
-  "FileFormat" -> Automatic
+  "FileFormat" -> Automatic,
+  "ThreadCount" -> 1,
+  "NativeAbstract" -> False
 }
 
 (*
@@ -456,6 +498,10 @@ CodeParse[ss:{_String, _String...}, opts:OptionsPattern[]] :=
 Catch[
 Module[{csts, asts, aggs},
   
+  If[nativeAbstractQ[opts],
+    Throw[abstractParseListable[utf8Bytes /@ ss, String, OptionValue["FileFormat"] === "Script", opts]]
+  ];
+
   csts = CodeConcreteParse[ss, opts];
 
   If[FailureQ[csts],
@@ -487,15 +533,22 @@ Module[{csts},
   csts[[1]]
 ]]
 
-CodeConcreteParse[fs:{File[_String], File[_String]...}, opts:OptionsPattern[]] :=
+
+
+Options[readFileBytes] = Options[CodeConcreteParse]
+
+(*
+returns {bytess, firstLineIsShebang}, or {failure, Null}
+*)
+readFileBytes[fs_List, opts:OptionsPattern[]] :=
 Catch[
-Module[{csts, encoding, fulls, bytess, fileFormat, firstLineIsShebang, exts},
+Module[{encoding, fulls, bytess, fileFormat, firstLineIsShebang, exts},
 
   encoding = OptionValue[CharacterEncoding];
   fileFormat = OptionValue["FileFormat"];
 
   If[encoding =!= "UTF8",
-    Throw[Failure["OnlyUTF8Supported", <|"CharacterEncoding"->encoding|>]]
+    Throw[{Failure["OnlyUTF8Supported", <|"CharacterEncoding"->encoding|>], Null}]
   ];
 
   (*
@@ -507,7 +560,7 @@ Module[{csts, encoding, fulls, bytess, fileFormat, firstLineIsShebang, exts},
   *)
   fulls = FindFile /@ fs;
   If[AnyTrue[fulls, FailureQ],
-    Throw[Failure["FindFileFailed", <|"FileNames"->fs|>]]
+    Throw[{Failure["FindFileFailed", <|"FileNames"->fs|>], Null}]
   ];
 
   Switch[fileFormat,
@@ -534,7 +587,22 @@ Module[{csts, encoding, fulls, bytess, fileFormat, firstLineIsShebang, exts},
 
   but this is slow
   *)
-  bytess = (Normal[ReadByteArray[#]] /. EndOfFile -> {})& /@ fulls;
+  bytess = (ReadByteArray[#] /. EndOfFile -> {})& /@ fulls;
+
+  {bytess, firstLineIsShebang}
+]]
+
+
+
+CodeConcreteParse[fs:{File[_String], File[_String]...}, opts:OptionsPattern[]] :=
+Catch[
+Module[{csts, bytess, firstLineIsShebang},
+
+  {bytess, firstLineIsShebang} = readFileBytes[fs, opts];
+
+  If[FailureQ[bytess],
+    Throw[bytess]
+  ];
 
   csts = concreteParseFileListable[bytess, firstLineIsShebang, opts];
 
@@ -546,21 +614,6 @@ Module[{csts, encoding, fulls, bytess, fileFormat, firstLineIsShebang, exts},
     Throw[csts]
   ];
 
-  csts =
-    MapThread[Function[{cst, bytes},
-    
-        Block[{UnterminatedGroupNeedsReparseNode, UnterminatedTokenErrorNeedsReparseNode},
-
-          UnterminatedGroupNeedsReparseNode[args___] := reparseUnterminatedGroupNode[{args}, bytes, FilterRules[{opts}, Options[reparseUnterminatedGroupNode]]];
-          UnterminatedTokenErrorNeedsReparseNode[args___] := reparseUnterminatedTokenErrorNode[{args}, bytes, FilterRules[{opts}, Options[reparseUnterminatedTokenErrorNode]]];
-
-          cst
-        ]
-      ]
-      ,
-      {csts, bytess}
-    ];
-
   csts
 ]]
 
@@ -568,13 +621,14 @@ Module[{csts, encoding, fulls, bytess, fileFormat, firstLineIsShebang, exts},
 
 Options[concreteParseFileListable] = Options[CodeConcreteParse]
 
-concreteParseFileListable[bytess:{{_Integer...}...}, firstLineIsShebang_, OptionsPattern[]] :=
+concreteParseFileListable[bytess:{({_Integer...} | _?ByteArrayQ)...}, firstLineIsShebang_, OptionsPattern[]] :=
 Catch[
-Module[{res, convention, container, containerWasAutomatic, tabWidth},
+Module[{res, convention, container, containerWasAutomatic, tabWidth, threadCount},
 
   convention = OptionValue[SourceConvention];
   container = OptionValue[ContainerNode];
   tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
 
   (*
   The <||> will be filled in with Source later
@@ -596,7 +650,7 @@ Module[{res, convention, container, containerWasAutomatic, tabWidth},
   $ConcreteParseTime = Quantity[0, "Seconds"];
 
   Block[{$StructureSrcArgs = parseConvention[convention]},
-  res = libraryFunctionWrapper[concreteParseBytesListableFunc, bytess, convention, tabWidth, Boole[firstLineIsShebang]];
+  res = bytesListable[concreteParseBytesListableFunc, concreteParseByteArrayFunc, bytess, threadCount, convention, tabWidth, firstLineIsShebang];
   ];
 
   $ConcreteParseProgress = 100;
@@ -657,7 +711,18 @@ Module[{asts},
 
 CodeParse[fs:{File[_String], File[_String]...}, opts:OptionsPattern[]] :=
 Catch[
-Module[{csts, asts, aggs},
+Module[{csts, asts, aggs, bytess, firstLineIsShebang},
+
+  If[nativeAbstractQ[opts],
+
+    {bytess, firstLineIsShebang} = readFileBytes[fs, FilterRules[{opts}, Options[readFileBytes]]];
+
+    If[FailureQ[bytess],
+      Throw[bytess]
+    ];
+
+    Throw[abstractParseListable[bytess, File, firstLineIsShebang, opts]]
+  ];
 
   csts = CodeConcreteParse[fs, opts];
 
@@ -714,22 +779,6 @@ Module[{csts, encoding, fileFormat, firstLineIsShebang},
     Throw[csts]
   ];
 
-  csts =
-    MapThread[Function[{cst, bytes},
-      
-        Block[{UnterminatedGroupNeedsReparseNode, UnterminatedTokenErrorNeedsReparseNode},
-
-          UnterminatedGroupNeedsReparseNode[args___] := reparseUnterminatedGroupNode[{args}, bytes, FilterRules[{opts}, Options[reparseUnterminatedGroupNode]]];
-          UnterminatedTokenErrorNeedsReparseNode[args___] := reparseUnterminatedTokenErrorNode[{args}, bytes, FilterRules[{opts}, Options[reparseUnterminatedTokenErrorNode]]];
-
-          cst
-        ]
-
-      ]
-      ,
-      {csts, bytess}
-    ];
-
   csts
 ]]
 
@@ -739,11 +788,12 @@ Options[concreteParseBytesListable] = Options[CodeConcreteParse]
 
 concreteParseBytesListable[bytess:{{_Integer...}...}, firstLineIsShebang_, OptionsPattern[]] :=
 Catch[
-Module[{res, convention, container, tabWidth},
+Module[{res, convention, container, tabWidth, threadCount},
 
   convention = OptionValue[SourceConvention];
   container = OptionValue[ContainerNode];
   tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
 
   (*
   The <||> will be filled in with Source later
@@ -764,7 +814,7 @@ Module[{res, convention, container, tabWidth},
   $ConcreteParseTime = Quantity[0, "Seconds"];
 
   Block[{$StructureSrcArgs = parseConvention[convention]},
-  res = libraryFunctionWrapper[concreteParseBytesListableFunc, bytess, convention, tabWidth, Boole[firstLineIsShebang]];
+  res = libraryFunctionWrapper[concreteParseBytesListableFunc, bytess, convention, tabWidth, Boole[firstLineIsShebang], threadCount];
   ];
 
   $ConcreteParseProgress = 100;
@@ -801,6 +851,10 @@ CodeParse[bytess:{{_Integer, _Integer...}...}, opts:OptionsPattern[]] :=
 Catch[
 Module[{csts, asts, aggs},
 
+  If[nativeAbstractQ[opts],
+    Throw[abstractParseListable[bytess, Byte, OptionValue["FileFormat"] === "Script", opts]]
+  ];
+
   csts = CodeConcreteParse[bytess, opts];
 
   If[FailureQ[csts],
@@ -819,6 +873,60 @@ Module[{csts, asts, aggs},
 
 
 
+(*
+The library abstracts what it can when "NativeAbstract" -> True
+
+The library does not know about custom containers or the FlattenTimes quirk
+*)
+nativeAbstractQ[opts___] :=
+  TrueQ[OptionValue[CodeParse, {opts}, "NativeAbstract"]] &&
+    OptionValue[CodeParse, {opts}, ContainerNode] === Automatic &&
+    !TrueQ[Lookup[$Quirks, "FlattenTimes", False]]
+
+
+Options[abstractParseListable] = Options[CodeParse]
+
+abstractParseListable[bytess:{({_Integer...} | _?ByteArrayQ)...}, tag_, firstLineIsShebang_, opts:OptionsPattern[]] :=
+Catch[
+Module[{res, convention, tabWidth, threadCount, encoding},
+
+  encoding = OptionValue[CharacterEncoding];
+  convention = OptionValue[SourceConvention];
+  tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
+
+  If[encoding =!= "UTF8",
+    Throw[Failure["OnlyUTF8Supported", <|"CharacterEncoding"->encoding|>]]
+  ];
+
+  Block[{$StructureSrcArgs = parseConvention[convention]},
+  res = bytesListable[abstractParseBytesListableFunc, abstractParseByteArrayFunc, bytess, threadCount, convention, tabWidth, firstLineIsShebang, tag === File];
+  ];
+
+  If[FailureQ[res],
+    Throw[res]
+  ];
+
+  (*
+  The # here is { {exprs}, {issues}, {simple line conts}, {complex line conts}, {embedded newlines}, {embedded tabs}, src }
+
+  src is {} when there are no top-level nodes
+  *)
+  abstractNativeContainer[tag, #[[1]],
+    <| If[!empty[#[[2]]], SyntaxIssues -> #[[2]], Nothing],
+       If[!empty[#[[3]]], "SimpleLineContinuations" -> #[[3]], Nothing],
+       If[!empty[#[[4]]], "ComplexLineContinuations" -> #[[4]], Nothing],
+       If[!empty[#[[5]]], "EmbeddedNewlines" -> #[[5]], Nothing],
+       If[!empty[#[[6]]], "EmbeddedTabs" -> #[[6]], Nothing],
+       If[tag === File && #[[7]] =!= {}, Source -> #[[7]], Nothing] |>
+  ]& /@ res
+]]
+
+
+
+
+
+
 CodeConcreteParse[{}, opts:OptionsPattern[]] :=
 Catch[
 Module[{},
@@ -845,7 +953,8 @@ Options[CodeTokenize] = {
   CharacterEncoding -> "UTF8",
   SourceConvention -> "LineColumn",
   "TabWidth" :> $DefaultTabWidth,
-  "FileFormat" -> Automatic
+  "FileFormat" -> Automatic,
+  "ThreadCount" -> 1
 }
 
 CodeTokenize[s_String, opts:OptionsPattern[]] :=
@@ -874,24 +983,25 @@ Options[tokenizeStringListable] = Options[CodeTokenize]
 
 tokenizeStringListable[ss:{_String...}, OptionsPattern[]] :=
 Catch[
-Module[{res, bytess, encoding, convention, tabWidth},
+Module[{res, bytess, encoding, convention, tabWidth, threadCount},
 
   encoding = OptionValue[CharacterEncoding];
   convention = OptionValue[SourceConvention];
   tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
 
   If[encoding =!= "UTF8",
     Throw[Failure["OnlyUTF8Supported", <|"CharacterEncoding"->encoding|>]]
   ];
 
-  bytess = ToCharacterCode[ss, "UTF8"];
+  bytess = utf8Bytes /@ ss;
 
   $ConcreteParseProgress = 0;
   $ConcreteParseStart = Now;
   $ConcreteParseTime = Quantity[0, "Seconds"];
 
   Block[{$StructureSrcArgs = parseConvention[convention]},
-  res = libraryFunctionWrapper[tokenizeBytesListableFunc, bytess, convention, tabWidth, Boole[False]];
+  res = bytesListable[tokenizeBytesListableFunc, tokenizeByteArrayFunc, bytess, threadCount, convention, tabWidth, False];
   ];
 
   $ConcreteParseProgress = 100;
@@ -933,11 +1043,12 @@ Options[tokenizeFileListable] = Options[CodeTokenize]
 
 tokenizeFileListable[fs:{File[_String]...}, OptionsPattern[]] :=
 Catch[
-Module[{encoding, res, fulls, bytess, convention, tabWidth, fileFormat, firstLineIsShebang, exts},
+Module[{encoding, res, fulls, bytess, convention, tabWidth, fileFormat, firstLineIsShebang, exts, threadCount},
 
   encoding = OptionValue[CharacterEncoding];
   convention = OptionValue[SourceConvention];
   tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
   fileFormat = OptionValue["FileFormat"];
 
   If[encoding =!= "UTF8",
@@ -973,14 +1084,14 @@ Module[{encoding, res, fulls, bytess, convention, tabWidth, fileFormat, firstLin
 
   but this is slow
   *)
-  bytess = (Normal[ReadByteArray[#]] /. EndOfFile -> {})& /@ fulls;
+  bytess = (ReadByteArray[#] /. EndOfFile -> {})& /@ fulls;
 
   $ConcreteParseProgress = 0;
   $ConcreteParseStart = Now;
   $ConcreteParseTime = Quantity[0, "Seconds"];
 
   Block[{$StructureSrcArgs = parseConvention[convention]},
-  res = libraryFunctionWrapper[tokenizeBytesListableFunc, bytess, convention, tabWidth, Boole[firstLineIsShebang]];
+  res = bytesListable[tokenizeBytesListableFunc, tokenizeByteArrayFunc, bytess, threadCount, convention, tabWidth, firstLineIsShebang];
   ];
 
   $ConcreteParseProgress = 100;
@@ -1022,11 +1133,12 @@ Options[tokenizeBytesListable] = Options[CodeTokenize]
 
 tokenizeBytesListable[bytess:{{_Integer...}...}, OptionsPattern[]] :=
 Catch[
-Module[{encoding, res, convention, tabWidth},
+Module[{encoding, res, convention, tabWidth, threadCount},
 
   encoding = OptionValue[CharacterEncoding];
   convention = OptionValue[SourceConvention];
   tabWidth = OptionValue["TabWidth"];
+  threadCount = Replace[OptionValue["ThreadCount"], Automatic :> $ProcessorCount];
 
   If[encoding =!= "UTF8",
     Throw[Failure["OnlyUTF8Supported", <|"CharacterEncoding"->encoding|>]]
@@ -1037,7 +1149,7 @@ Module[{encoding, res, convention, tabWidth},
   $ConcreteParseTime = Quantity[0, "Seconds"];
 
   Block[{$StructureSrcArgs = parseConvention[convention]},
-  res = libraryFunctionWrapper[tokenizeBytesListableFunc, bytess, convention, tabWidth, Boole[False]];
+  res = libraryFunctionWrapper[tokenizeBytesListableFunc, bytess, convention, tabWidth, Boole[False], threadCount];
   ];
 
   $ConcreteParseProgress = 100;
@@ -11,7 +11,12 @@ libraryFunctionWrapper
 library functions calling INTO lib
 *)
 concreteParseBytesListableFunc
+abstractParseBytesListableFunc
 tokenizeBytesListableFunc
+tokenizeBytesArraysFunc
+concreteParseByteArrayFunc
+abstractParseByteArrayFunc
+tokenizeByteArrayFunc
 concreteParseLeafFunc
 safeStringFunc
 
@@ -26,7 +31,6 @@ library functions coming FROM lib
 *)
 MakeLeafNode
 MakeErrorNode
-MakeUnterminatedTokenErrorNeedsReparseNode
 
 MakePrefixNode
 MakeBinaryNode
@@ -41,12 +45,18 @@ MakeCompoundNode
 
 MakeSyntaxErrorNode
 MakeGroupMissingCloserNode
-MakeUnterminatedGroupNeedsReparseNode
+MakeUnterminatedGroupNode
 MakeAbstractSyntaxErrorNode
 
 MakeSourceCharacterNode
 MakeSafeStringNode
 
+MakeAbstractLeafNode
+MakeAbstractCallNode
+MakeAbstractFallbackNode
+MakeAbstractTopLevelFallbackNode
+MakeAbstractSource
+
 MakeSyntaxIssue
 MakeFormatIssue
 MakeEncodingIssue
@@ -57,9 +67,7 @@ MakeInsertTextAfterCodeAction
 MakeDeleteTextCodeAction
 MakeDeleteTriviaCodeAction
 
-(*
 SetConcreteParseProgress
-*)
 
 
 
@@ -68,6 +76,7 @@ Blocked when returning from library
 *)
 $StructureSrcArgs
 parseConvention
+$ByteArrayResult
 
 
 
@@ -246,12 +255,31 @@ Module[{res, loaded, linkObject},
 	loaded
 ]]
 
+(*
+Built with the expr library, the _ByteArray_ functions return a pointer to the result instead of setting $ByteArrayResult
+
+Without the expr library, the input is read in place, but the result is still sent over the callback link, so
+that path does not save the cost of MathLink for the result, and the caller must Block $ByteArrayResult
+*)
+byteArrayReturnType[] :=
+	If[FileExistsQ[$exprLib], Integer, "Void"]
+
 loadAllFuncs[] := (
 
 concreteParseBytesListableFunc := (setupLibraries[]; concreteParseBytesListableFunc = loadFunc["ConcreteParseBytes_Listable_LibraryLink", LinkObject, LinkObject]);
 
+abstractParseBytesListableFunc := (setupLibraries[]; abstractParseBytesListableFunc = loadFunc["AbstractParseBytes_Listable_LibraryLink", LinkObject, LinkObject]);
+
 tokenizeBytesListableFunc := (setupLibraries[]; tokenizeBytesListableFunc = loadFunc["TokenizeBytes_Listable_LibraryLink", LinkObject, LinkObject]);
 
+tokenizeBytesArraysFunc := (setupLibraries[]; tokenizeBytesArraysFunc = loadFunc["TokenizeBytesArrays_LibraryLink", {{LibraryDataType[ByteArray], "Constant"}, "UTF8String", Integer, "Boolean"}, "DataStore"]);
+
+concreteParseByteArrayFunc := (setupLibraries[]; concreteParseByteArrayFunc = loadFunc["ConcreteParseByteArray_LibraryLink", {{LibraryDataType[ByteArray], "Constant"}, "UTF8String", Integer, "Boolean"}, byteArrayReturnType[]]);
+
+abstractParseByteArrayFunc := (setupLibraries[]; abstractParseByteArrayFunc = loadFunc["AbstractParseByteArray_LibraryLink", {{LibraryDataType[ByteArray], "Constant"}, "UTF8String", Integer, "Boolean", "Boolean"}, byteArrayReturnType[]]);
+
+tokenizeByteArrayFunc := (setupLibraries[]; tokenizeByteArrayFunc = loadFunc["TokenizeByteArray_LibraryLink", {{LibraryDataType[ByteArray], "Constant"}, "UTF8String", Integer, "Boolean"}, byteArrayReturnType[]]);
+
 concreteParseLeafFunc := (setupLibraries[]; concreteParseLeafFunc = loadFunc["ConcreteParseLeaf_LibraryLink", LinkObject, LinkObject]);
 
 safeStringFunc := (setupLibraries[]; safeStringFunc = loadFunc["SafeString_LibraryLink", LinkObject, LinkObject]);
@@ -349,13 +377,14 @@ Module[{res},
 
 
 (*
+Called by the library as the input is read, every 64KB when the percentage changes
+*)
 SetConcreteParseProgress[prog_] := (
 	$ConcreteParseProgress = prog;
 	If[prog == 100,
 		$ConcreteParseTime = Now - $ConcreteParseStart;
 	];
 )
-*)
 
 
 parseConvention["LineColumn"] = structureSrcArgsLineColumn
@@ -375,9 +404,6 @@ MakeLeafNode[tag_, payload_, srcArgs___] :=
 MakeErrorNode[tag_, payload_, srcArgs___] :=
 	ErrorNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
 
-MakeUnterminatedTokenErrorNeedsReparseNode[tag_, payload_, srcArgs___] :=
-	UnterminatedTokenErrorNeedsReparseNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
-
 MakePrefixNode[tag_, payload_, srcArgs___] :=
 	PrefixNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
 
@@ -411,13 +437,35 @@ MakeSyntaxErrorNode[tag_, payload_, srcArgs___] :=
 MakeGroupMissingCloserNode[tag_, payload_, srcArgs___] :=
 	GroupMissingCloserNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
 
-MakeUnterminatedGroupNeedsReparseNode[tag_, payload_, srcArgs___] :=
-	UnterminatedGroupNeedsReparseNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
+MakeUnterminatedGroupNode[tag_, payload_, srcArgs___] :=
+	UnterminatedGroupNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
 
 MakeAbstractSyntaxErrorNode[tag_, payload_, srcArgs___] :=
 	AbstractSyntaxErrorNode[tag, payload, <| Source -> $StructureSrcArgs[srcArgs] |>]
 
 
+(*
+Abstract nodes that are made by the library and are not in the input, such as the -1 in  a - b
+*)
+MakeAbstractLeafNode[tag_, payload_] :=
+	LeafNode[tag, payload, <||>]
+
+MakeAbstractCallNode[head_, payload_] :=
+	CallNode[head, payload, <||>]
+
+(*
+Concrete nodes that the library did not abstract
+*)
+MakeAbstractFallbackNode[cst_] :=
+	CodeParser`Abstract`abstractFallback[cst]
+
+MakeAbstractTopLevelFallbackNode[cst_] :=
+	CodeParser`Abstract`topLevelFallback[cst]
+
+MakeAbstractSource[srcArgs___] :=
+	$StructureSrcArgs[srcArgs]
+
+
 
 MakeSyntaxIssue[tag_String, msg_String, severity_String, srcArgs___Integer, confidence_Real] :=
 	SyntaxIssue[tag, msg, severity, <| Source -> $StructureSrcArgs[srcArgs], ConfidenceLevel -> confidence |>]
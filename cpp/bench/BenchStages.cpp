@@ -0,0 +1,711 @@
+
+#include "API.h"
+#include "CSTWriter.h" // for CSTWriter
+#include "LongNames.h" // for LongNames::findLongName
+
+#include "benchmark/benchmark.h"
+
+#include <algorithm> // for lower_bound
+#include <atomic>
+#include <cstdlib> // for malloc, free
+#include <fstream>
+#include <memory> // for unique_ptr
+#include <new> // for bad_alloc
+#include <sstream>
+#include <string>
+#include <vector>
+
+//
+// Every stage of the pipeline, timed separately
+//
+// Run with  --benchmark_format=json  or  --benchmark_out=FILE --benchmark_out_format=json  to keep results for
+// comparing commits
+//
+// Counters:
+//   bytes_per_second   bytes of input
+//   tokens             tokens of input per second
+//   heapAllocs         calls to operator new per iteration
+//   arenaAllocs        arena allocations per iteration
+//   lexesPerToken      times that parseExpressions lexed a token, per token of input
+//   peekHitsPerToken   times that parseExpressions found a token in the peek cache instead, per token of input
+//   parsedBytesPerEdit bytes that IncrementalParserSession parsed again, per edit
+//
+// tokenize and parseExpressions are also run with each of the SKIP_ bits of ParserSessionBits, and with
+// FAST_PATH_POLICY, to see what each kind of bookkeeping costs
+//
+
+//
+// Count every call to operator new, including from inside the library
+//
+static std::atomic<size_t> heapAllocationCount(0);
+
+void *operator new(size_t size) {
+
+    heapAllocationCount++;
+
+    if (auto p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+static const std::vector<std::string> corpus = {
+    "comments.wl",
+    "inputs-0001.txt",
+    "inputs-0002.txt",
+    "inputs-0003.txt",
+    "inputs-0004.txt",
+    "inputs-0005.txt",
+    "inputs-characternameoperations.txt",
+    "inputs-characternames.txt",
+    "inputs-characternamestrings.txt",
+    "inputs-contexts.txt",
+    "inputs-integers.txt",
+    "inputs-nestedsymbolicarithmetic.txt",
+    "inputs-random.txt",
+    "inputs-reals.txt",
+    "inputs-specialchararacters.txt",
+    "inputs-symbolicarithmetic.txt",
+    "inputs-symbolicarithmetic2.txt",
+    "inputs-symbolicarithmetic3.txt",
+    "inputs-symbolicarithmetic4.txt",
+    "linearsyntax.wl",
+    "package.wl",
+    "script.wl",
+    "stackoverflow1.txt",
+    "stackoverflow2.txt",
+    "stackoverflow3.txt",
+};
+
+//
+// One or more buffers that are processed together in each iteration
+//
+struct Input {
+
+    std::string name;
+
+    std::vector<std::vector<unsigned char>> bufs;
+
+    size_t bytes;
+    size_t tokens;
+};
+
+static std::vector<unsigned char> readCorpusFile(const std::string& name) {
+
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/" + name, std::ios::binary);
+
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+//
+// A package with many short definitions
+//
+static std::vector<unsigned char> large() {
+
+    std::string str = "BeginPackage[\"Foo`\"]\n\n";
+
+    for (size_t i = 0; i < 10000; i++) {
+        str += "f" + std::to_string(i) + "[x_, y_:1] := Module[{z = x + y}, (* comment *) g[z, \"str\"]]\n";
+    }
+
+    str += "EndPackage[]\n";
+
+    return std::vector<unsigned char>(str.begin(), str.end());
+}
+
+//
+// Groups and operators nested depth levels deep
+//
+// The time per byte should not depend on depth, because parsing and visiting trees keep their stacks in the heap
+//
+static std::vector<unsigned char> deep(size_t depth) {
+
+    std::string str;
+
+    for (size_t i = 0; i < depth; i++) {
+        str += (i % 2 == 0) ? "f[a + {" : "(b * ";
+    }
+
+    str += "x";
+
+    for (size_t i = depth; i > 0; i--) {
+        str += ((i - 1) % 2 == 0) ? "}]" : ")";
+    }
+
+    str += "\n";
+
+    return std::vector<unsigned char>(str.begin(), str.end());
+}
+
+//
+// Lines that each produce several issues: a strange letterlike character, an unexpected character in a string,
+// and an unexpected escape
+//
+// The time to sort and collect issues should stay a small part of parsing
+//
+static std::vector<unsigned char> issues(size_t lines) {
+
+    std::string str;
+
+    for (size_t i = 0; i < lines; i++) {
+        str += "x\\[DiscretionaryHyphen]y" + std::to_string(i) + " + \"a\x01" "b\" \\:0001 c\n";
+    }
+
+    return std::vector<unsigned char>(str.begin(), str.end());
+}
+
+static void init(ParserSession& session, const std::vector<unsigned char>& buf, ParserSessionPolicy policy = INCLUDE_SOURCE, SourceConvention srcConvention = SOURCECONVENTION_LINECOLUMN) {
+    session.init(BufferAndLength(buf.data(), buf.size()), nullptr, policy, srcConvention, DEFAULT_TAB_WIDTH, false);
+}
+
+static Input makeInput(const std::string& name, std::vector<std::vector<unsigned char>> bufs) {
+
+    Input I;
+
+    I.name = name;
+    I.bufs = std::move(bufs);
+    I.bytes = 0;
+    I.tokens = 0;
+
+    ParserSession session;
+
+    for (auto& buf : I.bufs) {
+
+        I.bytes += buf.size();
+
+        init(session, buf);
+
+        auto N = session.tokenize();
+
+        I.tokens += session.tokenizer->getTokenCount();
+
+        session.releaseAllNodes();
+
+        session.deinit();
+    }
+
+    return I;
+}
+
+//
+// Sessions that stay initialized with the parsed input, for the stages that work on trees
+//
+struct Parsed {
+
+    std::vector<std::unique_ptr<ParserSession>> sessions;
+    std::vector<Node *> nodes;
+
+    Parsed(const Input& I) : sessions(), nodes() {
+
+        for (auto& buf : I.bufs) {
+
+            sessions.push_back(std::unique_ptr<ParserSession>(new ParserSession()));
+
+            init(*sessions.back(), buf);
+
+            nodes.push_back(sessions.back()->parseExpressions());
+        }
+    }
+
+    ~Parsed() {
+
+        for (size_t i = 0; i < sessions.size(); i++) {
+
+            sessions[i]->releaseAllNodes();
+
+            sessions[i]->deinit();
+        }
+    }
+};
+
+//
+// Set the counters that every stage reports
+//
+class Counters {
+
+    benchmark::State& state;
+    const Input& input;
+    const std::vector<ParserSession *> sessions;
+
+    size_t heapStart;
+    size_t arenaStart;
+
+    size_t arenaAllocations() const {
+
+        size_t count = 0;
+
+        for (auto S : sessions) {
+            count += S->arena->getAllocationCount();
+        }
+
+        return count;
+    }
+
+public:
+
+    Counters(benchmark::State& state, const Input& input, std::vector<ParserSession *> sessions) : state(state), input(input), sessions(sessions), heapStart(heapAllocationCount), arenaStart(arenaAllocations()) {}
+
+    ~Counters() {
+
+        auto iterations = static_cast<size_t>(state.iterations());
+
+        state.SetBytesProcessed(static_cast<int64_t>(iterations * input.bytes));
+
+        state.counters["tokens"] = benchmark::Counter(static_cast<double>(iterations * input.tokens), benchmark::Counter::kIsRate);
+        state.counters["heapAllocs"] = benchmark::Counter(static_cast<double>(heapAllocationCount - heapStart), benchmark::Counter::kAvgIterations);
+        state.counters["arenaAllocs"] = benchmark::Counter(static_cast<double>(arenaAllocations() - arenaStart), benchmark::Counter::kAvgIterations);
+    }
+};
+
+//
+// Stages that go from bytes to nodes, and release the nodes before the next iteration
+//
+static void BenchSessionFunc(benchmark::State& state, const Input& I, ParserSessionFunc f, ParserSessionPolicy policy) {
+
+    ParserSession session;
+
+    Counters C(state, I, {&session});
+
+    for (auto _ : state) {
+
+        for (auto& buf : I.bufs) {
+
+            init(session, buf, policy);
+
+            auto N = (session.*f)();
+
+            benchmark::DoNotOptimize(N);
+
+            session.releaseAllNodes();
+
+            session.deinit();
+        }
+    }
+}
+
+//
+// Each source convention has its own specialization of the byte decoder
+//
+static void BenchListSourceCharacters(benchmark::State& state, const Input& I, SourceConvention srcConvention) {
+
+    ParserSession session;
+
+    Counters C(state, I, {&session});
+
+    for (auto _ : state) {
+
+        for (auto& buf : I.bufs) {
+
+            init(session, buf, INCLUDE_SOURCE, srcConvention);
+
+            auto N = session.listSourceCharacters();
+
+            benchmark::DoNotOptimize(N);
+
+            session.releaseAllNodes();
+
+            session.deinit();
+        }
+    }
+}
+
+//
+// The same tokens as tokenize, as columns instead of nodes
+//
+static void BenchTokenizeArrays(benchmark::State& state, const Input& I) {
+
+    ParserSession session;
+
+    TokenArrays A;
+
+    Counters C(state, I, {&session});
+
+    for (auto _ : state) {
+
+        for (auto& buf : I.bufs) {
+
+            init(session, buf);
+
+            session.tokenizeArrays(A);
+
+            benchmark::DoNotOptimize(A.Toks.data());
+
+            session.deinit();
+        }
+    }
+}
+
+//
+// Only parsing is timed, releasing is timed by BenchReleaseAllNodes
+//
+static void BenchParseExpressions(benchmark::State& state, const Input& I, ParserSessionPolicy policy) {
+
+    std::vector<std::unique_ptr<ParserSession>> sessions;
+    std::vector<ParserSession *> ptrs;
+
+    for (size_t i = 0; i < I.bufs.size(); i++) {
+        sessions.push_back(std::unique_ptr<ParserSession>(new ParserSession()));
+        ptrs.push_back(sessions.back().get());
+    }
+
+    std::vector<Node *> nodes(I.bufs.size());
+
+    Counters C(state, I, ptrs);
+
+    for (auto _ : state) {
+
+        for (size_t i = 0; i < I.bufs.size(); i++) {
+
+            init(*sessions[i], I.bufs[i], policy);
+
+            nodes[i] = sessions[i]->parseExpressions();
+        }
+
+        benchmark::DoNotOptimize(nodes.data());
+
+        state.PauseTiming();
+
+        for (size_t i = 0; i < I.bufs.size(); i++) {
+
+            sessions[i]->releaseAllNodes();
+
+            sessions[i]->deinit();
+        }
+
+        state.ResumeTiming();
+    }
+
+    //
+    // The counts are from the last iteration, and are the same for every iteration
+    //
+    size_t lexes = 0;
+    size_t peekHits = 0;
+
+    for (auto& S : sessions) {
+        lexes += S->tokenizer->getLexCount();
+        peekHits += S->tokenizer->getPeekHitCount();
+    }
+
+    state.counters["lexesPerToken"] = static_cast<double>(lexes) / I.tokens;
+    state.counters["peekHitsPerToken"] = static_cast<double>(peekHits) / I.tokens;
+}
+
+//
+// One input split into chunks that are parsed on state.range(0) threads
+//
+// Real time is what matters, and arenaAllocs is not counted, because the sessions belong to the ParallelParserSession
+//
+static void BenchParseExpressionsParallel(benchmark::State& state, const Input& I) {
+
+    ParallelParserSession parallel(static_cast<size_t>(state.range(0)));
+
+    Counters C(state, I, {});
+
+    for (auto _ : state) {
+
+        for (auto& buf : I.bufs) {
+
+            parallel.init(BufferAndLength(buf.data(), buf.size()), INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+
+            auto N = parallel.parseExpressions(nullptr);
+
+            benchmark::DoNotOptimize(N);
+
+            state.PauseTiming();
+
+            parallel.deinit();
+
+            state.ResumeTiming();
+        }
+    }
+}
+
+//
+// Every buffer of the input parsed by a ParserSessionPool with state.range(0) threads
+//
+// Real time is what matters, and arenaAllocs is not counted, because the sessions belong to the pool
+//
+static void BenchParseExpressionsPool(benchmark::State& state, const Input& I) {
+
+    ParserSessionPool pool(static_cast<size_t>(state.range(0)));
+
+    std::vector<BufferAndLength> bufs;
+    for (auto& buf : I.bufs) {
+        bufs.push_back(BufferAndLength(buf.data(), buf.size()));
+    }
+
+    Counters C(state, I, {});
+
+    for (auto _ : state) {
+
+        pool.run(bufs, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false, &ParserSession::parseExpressions, nullptr);
+
+        benchmark::DoNotOptimize(pool.node(0));
+
+        state.PauseTiming();
+
+        pool.release();
+
+        state.ResumeTiming();
+    }
+}
+
+//
+// Only releasing is timed
+//
+static void BenchReleaseAllNodes(benchmark::State& state, const Input& I) {
+
+    std::vector<std::unique_ptr<ParserSession>> sessions;
+    std::vector<ParserSession *> ptrs;
+
+    for (size_t i = 0; i < I.bufs.size(); i++) {
+        sessions.push_back(std::unique_ptr<ParserSession>(new ParserSession()));
+        ptrs.push_back(sessions.back().get());
+    }
+
+    std::vector<Node *> nodes(I.bufs.size());
+
+    Counters C(state, I, ptrs);
+
+    for (auto _ : state) {
+
+        state.PauseTiming();
+
+        for (size_t i = 0; i < I.bufs.size(); i++) {
+
+            init(*sessions[i], I.bufs[i]);
+
+            nodes[i] = sessions[i]->parseExpressions();
+        }
+
+        state.ResumeTiming();
+
+        for (size_t i = 0; i < I.bufs.size(); i++) {
+            sessions[i]->releaseAllNodes();
+        }
+
+        state.PauseTiming();
+
+        for (size_t i = 0; i < I.bufs.size(); i++) {
+            sessions[i]->deinit();
+        }
+
+        state.ResumeTiming();
+    }
+}
+
+//
+// The text of print, but into a string instead of being written out
+//
+static void BenchPrint(benchmark::State& state, const Input& I) {
+
+    Parsed P(I);
+
+    std::vector<ParserSession *> ptrs;
+    for (auto& S : P.sessions) {
+        ptrs.push_back(S.get());
+    }
+
+    std::ostringstream s;
+
+    Counters C(state, I, ptrs);
+
+    for (auto _ : state) {
+
+        for (size_t i = 0; i < P.nodes.size(); i++) {
+
+            s.str("");
+
+            P.nodes[i]->print(P.sessions[i].get(), s);
+        }
+
+        benchmark::DoNotOptimize(s);
+    }
+}
+
+//
+// Node::put needs a MathLink link, so the binary format of CSTWriter stands in for it
+//
+static void BenchWriteBinary(benchmark::State& state, const Input& I) {
+
+    Parsed P(I);
+
+    std::vector<ParserSession *> ptrs;
+    std::vector<std::unique_ptr<CSTWriter>> writers;
+    for (auto& S : P.sessions) {
+        ptrs.push_back(S.get());
+        writers.push_back(std::unique_ptr<CSTWriter>(new CSTWriter(S.get())));
+    }
+
+    std::ostringstream s;
+
+    Counters C(state, I, ptrs);
+
+    for (auto _ : state) {
+
+        for (size_t i = 0; i < P.nodes.size(); i++) {
+
+            s.str("");
+
+            writers[i]->write(P.nodes[i], s);
+        }
+
+        benchmark::DoNotOptimize(s);
+    }
+}
+
+//
+// Type a byte into the middle of the text and remove it again, with IncrementalParserSession
+//
+// Compare with parseExpressions/large, which parses all of the same text
+//
+static void BenchIncrementalEdit(benchmark::State& state, const std::vector<unsigned char>& buf) {
+
+    IncrementalParserSession incremental;
+
+    incremental.init(BufferAndLength(buf.data(), buf.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+
+    auto off = buf.size() / 2;
+    while (buf[off - 1] != '\n') {
+        off++;
+    }
+
+    const unsigned char typed = 'h';
+
+    size_t parsed = 0;
+
+    for (auto _ : state) {
+
+        if (!incremental.edit(off, 0, BufferAndLength(&typed, 1))) {
+            state.SkipWithError("edit failed");
+            break;
+        }
+
+        parsed += incremental.getLastParsedSize();
+
+        if (!incremental.edit(off, 1, BufferAndLength())) {
+            state.SkipWithError("edit failed");
+            break;
+        }
+
+        parsed += incremental.getLastParsedSize();
+    }
+
+    state.counters["parsedBytesPerEdit"] = benchmark::Counter(static_cast<double>(parsed) / 2, benchmark::Counter::kAvgIterations);
+
+    incremental.deinit();
+}
+
+//
+// Look up every long name with the perfect hash
+//
+static void BenchFindLongName(benchmark::State& state) {
+
+    for (auto _ : state) {
+
+        for (auto& N : LongNameToCodePointMap_names) {
+            benchmark::DoNotOptimize(LongNames::findLongName(reinterpret_cast<const unsigned char *>(N.data()), N.size()));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * LONGNAMES_COUNT));
+}
+
+//
+// Look up every long name with the binary search over std::string that the perfect hash replaced
+//
+static void BenchFindLongNameBinarySearch(benchmark::State& state) {
+
+    for (auto _ : state) {
+
+        for (auto& N : LongNameToCodePointMap_names) {
+
+            //
+            // Copy, as the old lookup did when it made a std::string from the characters between \[ and ]
+            //
+            auto str = std::string(N.data(), N.size());
+
+            benchmark::DoNotOptimize(std::lower_bound(LongNameToCodePointMap_names.begin(), LongNameToCodePointMap_names.end(), str));
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * LONGNAMES_COUNT));
+}
+
+struct Policy {
+
+    std::string name;
+
+    ParserSessionPolicy policy;
+};
+
+static const std::vector<Policy> policies = {
+    {"skipIssues", INCLUDE_SOURCE | SKIP_ISSUES},
+    {"skipEmbeddedNewlinesAndTabs", INCLUDE_SOURCE | SKIP_EMBEDDED_NEWLINES_AND_TABS},
+    {"skipLineContinuations", INCLUDE_SOURCE | SKIP_LINE_CONTINUATIONS},
+    {"skipLongNameSuggestions", INCLUDE_SOURCE | SKIP_LONG_NAME_SUGGESTIONS},
+    {"fastPath", INCLUDE_SOURCE | FAST_PATH_POLICY},
+    {"fastPathNoSource", FAST_PATH_POLICY},
+};
+
+int main(int argc, char *argv[]) {
+
+    std::vector<std::vector<unsigned char>> corpusBufs;
+    for (auto& name : corpus) {
+        corpusBufs.push_back(readCorpusFile(name));
+    }
+
+    std::vector<Input> inputs;
+    inputs.push_back(makeInput("corpus", std::move(corpusBufs)));
+    inputs.push_back(makeInput("large", {large()}));
+    inputs.push_back(makeInput("issues", {issues(20000)}));
+    inputs.push_back(makeInput("deep1000", {deep(1000)}));
+    inputs.push_back(makeInput("deep100000", {deep(100000)}));
+    inputs.push_back(makeInput("deep1000000", {deep(1000000)}));
+
+    for (auto& I : inputs) {
+
+        benchmark::RegisterBenchmark(("listSourceCharacters/" + I.name).c_str(), BenchListSourceCharacters, I, SOURCECONVENTION_LINECOLUMN)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("listSourceCharacters/" + I.name + "/sourceCharacterIndex").c_str(), BenchListSourceCharacters, I, SOURCECONVENTION_SOURCECHARACTERINDEX)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("tokenize/" + I.name).c_str(), BenchSessionFunc, I, &ParserSession::tokenize, INCLUDE_SOURCE)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("tokenizeArrays/" + I.name).c_str(), BenchTokenizeArrays, I)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("parseExpressions/" + I.name).c_str(), BenchParseExpressions, I, INCLUDE_SOURCE)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("parseExpressionsParallel/" + I.name).c_str(), BenchParseExpressionsParallel, I)->Unit(benchmark::kMillisecond)->UseRealTime()->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+        benchmark::RegisterBenchmark(("parseExpressionsPool/" + I.name).c_str(), BenchParseExpressionsPool, I)->Unit(benchmark::kMillisecond)->UseRealTime()->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+        benchmark::RegisterBenchmark(("print/" + I.name).c_str(), BenchPrint, I)->Unit(benchmark::kMillisecond);
+        benchmark::RegisterBenchmark(("writeBinary/" + I.name).c_str(), BenchWriteBinary, I)->Unit(benchmark::kMillisecond);
+
+        //
+        // Releasing takes so little time next to parsing that the usual search for an iteration count would parse
+        // for minutes
+        //
+        benchmark::RegisterBenchmark(("releaseAllNodes/" + I.name).c_str(), BenchReleaseAllNodes, I)->Unit(benchmark::kMicrosecond)->Iterations(20);
+
+        for (auto& P : policies) {
+            benchmark::RegisterBenchmark(("tokenize/" + I.name + "/" + P.name).c_str(), BenchSessionFunc, I, &ParserSession::tokenize, P.policy)->Unit(benchmark::kMillisecond);
+            benchmark::RegisterBenchmark(("parseExpressions/" + I.name + "/" + P.name).c_str(), BenchParseExpressions, I, P.policy)->Unit(benchmark::kMillisecond);
+        }
+    }
+
+    benchmark::RegisterBenchmark("incrementalEdit/large", BenchIncrementalEdit, large())->Unit(benchmark::kMicrosecond);
+
+    benchmark::RegisterBenchmark("findLongName", BenchFindLongName)->Unit(benchmark::kMicrosecond);
+    benchmark::RegisterBenchmark("findLongName/binarySearch", BenchFindLongNameBinarySearch)->Unit(benchmark::kMicrosecond);
+
+    benchmark::Initialize(&argc, argv);
+
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return EXIT_FAILURE;
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+
+    benchmark::Shutdown();
+
+    return EXIT_SUCCESS;
+}
@@ -3,7 +3,14 @@
 
 #include "Node.h" // for NodePtr, Node, etc.
 #include "Source.h" // for BufferAndLength
+#include "Parser.h" // for ParserPtr
+#include "Tokenizer.h" // for TokenizerPtr
+#include "CharacterDecoder.h" // for CharacterDecoderPtr
+#include "ByteDecoder.h" // for ByteDecoderPtr
+#include "ByteBuffer.h" // for ByteBufferPtr
+#include "Arena.h" // for ArenaPtr
 #include "ExprLibrary.h" // for expr
+#include "TokenArrays.h" // for TokenArrays
 
 //
 // Despite being mentioned here:
@@ -33,16 +40,17 @@
 
 #include <memory> // for unique_ptr
 #include <functional> // for function with GCC and MSVC
+#include <vector>
+#include <atomic> // for atomic
+#include <unordered_map>
 
 
 
-class ParserSession;
 class ScopedMLByteArray;
 class ScopedMLUTF8String;
 class ScopedMLString;
 class ScopedMLEnvironmentParameter;
 
-using ParserSessionPtr = std::unique_ptr<ParserSession>;
 using ScopedMLByteArrayPtr = std::unique_ptr<ScopedMLByteArray>;
 using ScopedMLUTF8StringPtr = std::unique_ptr<ScopedMLUTF8String>;
 using ScopedMLStringPtr = std::unique_ptr<ScopedMLString>;
@@ -95,21 +103,134 @@ enum ParserSessionBits : uint8_t {
     // Include Source in returned nodes?
     //
     INCLUDE_SOURCE = 0x01,
+    
+    //
+    // Do not collect issues in any stage
+    //
+    // The same as building with NISSUES, but chosen for each session
+    //
+    SKIP_ISSUES = 0x02,
+    
+    //
+    // Do not collect EmbeddedNewlines and EmbeddedTabs
+    //
+    SKIP_EMBEDDED_NEWLINES_AND_TABS = 0x04,
+    
+    //
+    // Do not collect SimpleLineContinuations and ComplexLineContinuations
+    //
+    SKIP_LINE_CONTINUATIONS = 0x08,
+    
+    //
+    // Do not ask the kernel for suggestions for unrecognized long names such as \[Alpa]
+    //
+    SKIP_LONG_NAME_SUGGESTIONS = 0x10,
+    
+    //
+    // Abstract gives issues for strange top-level expressions, as for a File
+    //
+    REPORT_TOPLEVEL_ISSUES = 0x20,
 };
 
 using ParserSessionPolicy = uint8_t;
 
+//
+// For when only the structure is needed, such as for  codeparser -check  or a token stream
+//
+// Without INCLUDE_SOURCE as well, nothing that is returned needs SourceLocations, so they are not tracked at all
+//
+const ParserSessionPolicy FAST_PATH_POLICY = SKIP_ISSUES | SKIP_EMBEDDED_NEWLINES_AND_TABS | SKIP_LINE_CONTINUATIONS | SKIP_LONG_NAME_SUGGESTIONS;
+
+//
+// A top-level expression or top-level trivia, with the issues and locations that belong to it
+//
+struct TopLevelExpression {
+    
+    Node *Expr;
+    
+    //
+    // The first token of Expr, which is TOKEN_TOPLEVELNEWLINE for the newlines between top-level expressions
+    //
+    TokenEnum Tok;
+    
+    //
+    // Everything that was consumed, including trivia
+    //
+    BufferAndLength Buf;
+    Source Src;
+    
+    //
+    // ByteDecoder::furthest after parsing this expression and the ones before it
+    //
+    Buffer Furthest;
+    
+    IssueVector Issues;
+    SourceLocationVector SimpleLineContinuations;
+    SourceLocationVector ComplexLineContinuations;
+    SourceLocationVector EmbeddedNewlines;
+    SourceLocationVector EmbeddedTabs;
+    
+    //
+    // How far Expr, Issues, and the locations are still to be moved
+    //
+    // Walking every tree after an edit would cost more than parsing the edit, so they are moved only when they are
+    // needed
+    //
+    SourceShift Pending;
+    
+    TopLevelExpression();
+    
+    //
+    // Move everything by S, after an edit before the expression
+    //
+    // Buf, Src, and Furthest are moved now, and the rest is added to Pending
+    //
+    void shift(const SourceShift& S);
+    
+    void applyPending();
+};
+
 //
 // A parser session
 //
+// A session owns its own pipeline: ByteBuffer -> ByteDecoder -> CharacterDecoder -> Tokenizer -> Parser
+//
+// Every stage holds a pointer back to the session that owns it, and parselets are given the session explicitly,
+// so there is no process-wide state and different sessions may be used concurrently on different threads
+//
 class ParserSession {
     
     BufferAndLength bufAndLen;
     
+#if !NABORT
+    //
+    // Set once an abort has been seen, and stays set until the next init
+    //
+    // Atomic so that another thread may abort the session with abort() while it parses
+    //
+    mutable std::atomic<bool> abortFlag;
+    
+    //
+    // The number of isAbort() calls left before currentAbortQ is asked again
+    //
+    mutable uint32_t abortBudget;
+#endif // !NABORT
+    
     NodePtr concreteParseLeaf0(int mode);
     
 public:
     
+    ByteBufferPtr byteBuffer;
+    ByteDecoderPtr byteDecoder;
+    CharacterDecoderPtr characterDecoder;
+    TokenizerPtr tokenizer;
+    ParserPtr parser;
+    
+    //
+    // All nodes made by this session live here
+    //
+    ArenaPtr arena;
+    
 #if !NABORT
     std::function<bool ()> currentAbortQ;
 #endif // !NABORT
@@ -127,20 +248,340 @@ public:
     
     
     Node *parseExpressions();
+    
+    //
+    // The same as parseExpressions, but with the expressions abstracted
+    //
+    // See abstractExpressions
+    //
+    Node *abstractParseExpressions();
+    
+    //
+    // Parse the next top-level expression, or the next top-level trivia
+    //
+    // Returns the same List[CollectedExpressions, CollectedIssues, ...] as parseExpressions, but with a single
+    // expression and only the issues and locations that belong to it
+    //
+    // Returns nullptr at the end of the input, or when aborted
+    //
+    // The returned node may be released before the next call, so that memory is bounded by the largest top-level
+    // expression instead of the whole input
+    //
+    Node *nextTopLevelExpression();
+    
+    //
+    // Same as nextTopLevelExpression(), but give the issues and locations as they are instead of as nodes
+    //
+    // Returns false at the end of the input, or when aborted
+    //
+    bool nextTopLevelExpression(TopLevelExpression& T);
+    
+    //
+    // Start parsing at buf instead of at the start of the input, as if everything before buf had been parsed
+    //
+    // loc is the location of buf, and buf must be at the start of a top-level expression
+    //
+    // Only valid right after init
+    //
+    void seek(Buffer buf, SourceLocation loc);
+    
     Node *tokenize();
+    
+    //
+    // Same tokens as tokenize(), but as columns in A instead of as nodes
+    //
+    // A is cleared first
+    //
+    void tokenizeArrays(TokenArrays& A);
+    
+    //
+    // Same tokens as tokenizeArrays(A), but written to columns that have room for capacity tokens
+    //
+    // Returns the number of tokens written. The columns are full if that is capacity, and the next call continues with
+    // the tokens that did not fit
+    //
+    size_t tokenizeArrays(uint16_t *Toks, uint32_t *Starts, uint32_t *Ends, Source *Srcs, size_t capacity);
+    
     Node *listSourceCharacters();
     Node *concreteParseLeaf(StringifyMode mode);
     
-    void releaseNode(Node *N);
+    //
+    // Release every node made by this session since the last release
+    //
+    // All nodes live in the one arena, so any node still held by the caller is invalid afterwards
+    //
+    void releaseAllNodes();
+    
+    //
+    // The input given to init
+    //
+    BufferAndLength getInput() const;
     
 #if !NABORT
-    bool isAbort() const;
+    //
+    // Checked on every token, so currentAbortQ is only asked once every ABORT_CHECK_INTERVAL calls, and in between
+    // this is a decrement and the load of a flag
+    //
+    bool isAbort() const {
+        
+        if (abortFlag.load(std::memory_order_relaxed)) {
+            return true;
+        }
+        
+        if (--abortBudget != 0) {
+            return false;
+        }
+        
+        return pollAbort();
+    }
+    
+    //
+    // Ask currentAbortQ now, and start a new budget
+    //
+    // Also called by the ByteBuffer every so many bytes, so that an abort during a very long token is seen as soon as
+    // the token is finished
+    //
+    bool pollAbort() const;
+    
+    //
+    // Make isAbort() return true from now until the next init
+    //
+    // May be called from any thread
+    //
+    void abort();
     
     NodePtr handleAbort() const;
 #endif // !NABORT
+    
+#if USE_EXPR_LIB
+    //
+    // The symbol Name as an expression, made the first time that it is asked for and kept until the session is
+    // destroyed
+    //
+    // Name must be a string that lives as long as the session, such as the name of a Symbol
+    //
+    expr symbolExpr(const char *Name);
+    
+private:
+    
+    std::unordered_map<const char *, expr> SymbolExprs;
+#endif // USE_EXPR_LIB
 };
 
-extern ParserSessionPtr TheParserSession;
+using ParserSessionFunc = Node *(ParserSession::*)();
+
+//
+// A session for text that is edited many times, such as the buffer of an editor
+//
+// The top-level expressions are kept between edits
+//
+// Every top-level expression is parsed the same no matter what comes before it, so after an edit, parsing starts
+// again after the last expression that did not read as far as the edit, even while peeking ahead. It stops at the
+// first top-level newline after the edit that is also in the old text at the same place. The expressions after that
+// are kept, and moved by the lines or characters that the edit added or removed
+//
+// Nodes that are no longer used stay in the arena until everything is parsed again, which happens once they take
+// more space than the text
+//
+class IncrementalParserSession {
+    
+    ParserSession session;
+    
+    WolframLibraryData libData;
+    ParserSessionPolicy policy;
+    SourceConvention srcConvention;
+    uint32_t tabWidth;
+    bool firstLineIsShebang;
+    
+    //
+    // Kept nodes point into text, so text is given room to grow, and everything is parsed again if it must move
+    //
+    std::vector<unsigned char> text;
+    
+    std::vector<TopLevelExpression> exprs;
+    
+    //
+    // False if parsing was aborted, and exprs do not cover the text
+    //
+    bool complete;
+    
+    //
+    // Bytes of the expressions that were thrown away since the arena was reset
+    //
+    size_t garbageSize;
+    
+    size_t lastParsedSize;
+    
+    //
+    // The result is not made in the arena, so that asking for it after every edit does not grow the arena
+    //
+    std::vector<std::unique_ptr<Node>> result;
+    
+    
+    void parseAll();
+    
+    size_t offset(Buffer buf) const;
+    
+public:
+    
+    IncrementalParserSession();
+    
+    void init(BufferAndLength bufAndLen, WolframLibraryData libData, ParserSessionPolicy policy, SourceConvention srcConvention, uint32_t tabWidth, bool firstLineIsShebang);
+    
+    void deinit();
+    
+    //
+    // Replace the removed bytes at offset with inserted
+    //
+    // Returns false if the bytes are not all in the text
+    //
+    bool edit(size_t offset, size_t removed, BufferAndLength inserted);
+    
+    //
+    // The same List[CollectedExpressions, CollectedIssues, ...] that ParserSession::parseExpressions would give for
+    // the text
+    //
+    // Valid until the next call to edit, parseExpressions, or deinit
+    //
+    Node *parseExpressions();
+    
+    //
+    // Bytes that were parsed by the last init or edit
+    //
+    size_t getLastParsedSize() const;
+    
+    ParserSession *getSession();
+};
+
+//
+// A pool of sessions for running many independent inputs concurrently
+//
+// Each worker thread owns one session and pulls the next input from a shared counter
+//
+// Nodes are kept in input order, together with the session that created them, so that they can be printed or put
+// in order from the calling thread after all workers have finished
+//
+class ParserSessionPool {
+    
+    std::vector<std::unique_ptr<ParserSession>> sessions;
+    
+    std::vector<Node *> nodes;
+    std::vector<ParserSession *> owners;
+    
+    //
+    // char instead of bool, so that different threads write different bytes
+    //
+    std::vector<char> missedSuggestions;
+    
+#if !NABORT
+    std::atomic<bool> aborted;
+#endif // !NABORT
+    
+public:
+    
+    ParserSessionPool(size_t threadCount);
+    
+    ~ParserSessionPool();
+    
+    //
+    // Run F on every input
+    //
+    // Workers are not given libData and never call back into the kernel
+    // abortQ is polled from the calling thread while the workers run
+    //
+    void run(const std::vector<BufferAndLength>& inputs, ParserSessionPolicy policy, SourceConvention srcConvention, uint32_t tabWidth, bool firstLineIsShebang, ParserSessionFunc F, std::function<bool ()> abortQ);
+    
+    Node *node(size_t i) const;
+    
+    ParserSession *session(size_t i) const;
+    
+    //
+    // Whether input i wanted a long name suggestion that the worker could not ask the kernel for
+    //
+    // The node for input i is then missing the suggestion, and the input must be parsed again with libData to give
+    // the same result as parsing it serially
+    //
+    bool missedSuggestion(size_t i) const;
+    
+    void release();
+};
+
+//
+// A single large input parsed on several threads
+//
+// The input is pre-scanned for top-level newlines that are outside of groups, strings, and comments, and that follow
+// something that can end an expression. It is split at the lines that follow them into chunks, and each chunk is
+// parsed by its own session, seeked to the location that the chunk is expected to start at
+//
+// The pre-scan only guesses. A chunk is known to be parsed the same as it would be serially once the chunk before it
+// stops exactly at its start, at the expected location. If any chunk does not, then the input is parsed serially instead
+//
+class ParallelParserSession {
+    
+    std::vector<std::unique_ptr<ParserSession>> sessions;
+    
+    BufferAndLength bufAndLen;
+    ParserSessionPolicy policy;
+    SourceConvention srcConvention;
+    uint32_t tabWidth;
+    bool firstLineIsShebang;
+    
+    //
+    // Like IncrementalParserSession, the result is not made in an arena
+    //
+    std::vector<std::unique_ptr<Node>> result;
+    
+    //
+    // Whether the last result was parsed serially by the first session
+    //
+    bool serial;
+    
+#if !NABORT
+    std::atomic<bool> aborted;
+#endif // !NABORT
+    
+    Node *parseSerially(std::function<bool ()> abortQ);
+    
+    void release();
+    
+public:
+    
+    ParallelParserSession(size_t threadCount);
+    
+    ~ParallelParserSession();
+    
+    //
+    // Sessions are not given libData and never call back into the kernel
+    //
+    void init(BufferAndLength bufAndLen, ParserSessionPolicy policy, SourceConvention srcConvention, uint32_t tabWidth, bool firstLineIsShebang);
+    
+    void deinit();
+    
+    //
+    // The same List[CollectedExpressions, CollectedIssues, ...] that ParserSession::parseExpressions would give
+    //
+    // abortQ is polled from the calling thread while the chunks are parsed. If it returns true, then the result has
+    // the expressions of the chunks before the first one that was not finished
+    //
+    // Valid until the next call to parseExpressions or deinit
+    //
+    Node *parseExpressions(std::function<bool ()> abortQ);
+    
+    //
+    // Whether the last call to parseExpressions fell back to parsing serially
+    //
+    bool wasSerial() const;
+    
+    //
+    // For printing, putting, or writing the result
+    //
+    ParserSession *getSession();
+    
+    //
+    // The starts of the chunks after the first, at most count - 1 of them and roughly evenly spaced
+    //
+    static std::vector<Buffer> split(BufferAndLength bufAndLen, bool firstLineIsShebang, size_t count);
+};
 
 
 EXTERN_C DLLEXPORT mint WolframLibrary_getVersion();
@@ -149,13 +590,52 @@ EXTERN_C DLLEXPORT int WolframLibrary_initialize(WolframLibraryData libData);
 
 EXTERN_C DLLEXPORT void WolframLibrary_uninitialize(WolframLibraryData libData);
 
+//
+// TokenizeBytesArrays_LibraryLink[bytes, convention, tabWidth, firstLineIsShebang]
+//
+// bytes is a "Constant" ByteArray that is tokenized in place, like the _ByteArray_ functions
+//
+// Returns a DataStore of the NumericArrays of TokenArrays: tokens as "UnsignedInteger16", byte starts and ends as
+// "UnsignedInteger32", and sources as "UnsignedInteger32" with dimensions {n, 2, 2}
+//
+EXTERN_C DLLEXPORT int TokenizeBytesArrays_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res);
+
 
 #if USE_MATHLINK
 
 EXTERN_C DLLEXPORT int ConcreteParseBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp);
 
+//
+// AbstractParseBytes_Listable_LibraryLink[{bytess, convention, tabWidth, firstLineIsShebang, isFile, (threadCount)}]
+//
+// Returns a List of the same List[CollectedExpressions, CollectedIssues, ...] that ConcreteParseBytes gives, with the
+// expressions abstracted and with the Source of the container at the end
+//
+EXTERN_C DLLEXPORT int AbstractParseBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp);
+
 EXTERN_C DLLEXPORT int TokenizeBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp);
 
+//
+// ConcreteParseByteArray_LibraryLink[bytes, convention, tabWidth, firstLineIsShebang]
+//
+// bytes is a "Constant" ByteArray that is parsed in place, without being copied over a link
+//
+// Returns nothing, the result is set to CodeParser`Library`$ByteArrayResult by evaluating on the callback link
+//
+// With USE_EXPR_LIB, returns a pointer to the result built with Node::toExpr instead
+//
+EXTERN_C DLLEXPORT int ConcreteParseByteArray_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res);
+
+//
+// AbstractParseByteArray_LibraryLink[bytes, convention, tabWidth, firstLineIsShebang, isFile]
+//
+EXTERN_C DLLEXPORT int AbstractParseByteArray_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res);
+
+//
+// TokenizeByteArray_LibraryLink[bytes, convention, tabWidth, firstLineIsShebang]
+//
+EXTERN_C DLLEXPORT int TokenizeByteArray_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res);
+
 EXTERN_C DLLEXPORT int ConcreteParseLeaf_LibraryLink(WolframLibraryData libData, MLINK mlp);
 
 EXTERN_C DLLEXPORT int SafeString_LibraryLink(WolframLibraryData libData, MLINK mlp);
@@ -295,4 +775,13 @@ public:
     MLINK get();
 };
 
+//
+// Read and discard packets up to and including the ReturnPacket of an evaluation sent with processMathLink
+//
+// Message and text packets may come before the ReturnPacket and are discarded too
+//
+// Returns false if the link fails before a ReturnPacket, which can happen during an abort
+//
+bool drainToReturnPacket(MLINK link);
+
 #endif // USE_MATHLINK
@@ -0,0 +1,135 @@
+
+#pragma once
+
+#include "Node.h" // for Node, NodeSeq
+#include "Source.h" // for Source, BufferAndLength
+#include "Symbol.h" // for SymbolPtr
+
+#include <ostream>
+
+//
+// Abstract syntax, as in CodeParser`Abstract
+//
+// Only the rules that do not make issues or rewrite strings are done here. Any node that is not handled is given to
+// the kernel as a fallback node that holds its concrete syntax, and the kernel abstracts that node itself
+//
+
+//
+// LeafNode[Integer, "-1", data]
+//
+// Made for leaves that are not in the input, such as the -1 of  a - b  or the symbols of  ToNode[Times]
+//
+// HasSrc is false for leaves that have <||> for data
+//
+class AbstractLeafNode : public Node {
+    const SymbolPtr& Tag;
+    const BufferAndLength Str;
+    const Source Src;
+    const bool HasSrc;
+public:
+    AbstractLeafNode(const SymbolPtr& Tag, BufferAndLength Str, Source Src, bool HasSrc) : Node(), Tag(Tag), Str(Str), Src(Src), HasSrc(HasSrc) {}
+    
+#if USE_MATHLINK
+    void put(ParserSession *session, MLINK mlp) const override;
+#endif // USE_MATHLINK
+    
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    Source getSource() const override {
+        return Src;
+    }
+};
+
+//
+// CallNode[head, {args}, data]
+//
+// Unlike the concrete CallNode, the head is a single node and not a list
+//
+class AbstractCallNode : public Node {
+    NodeSeq Head;
+    const Source Src;
+    const bool HasSrc;
+public:
+    AbstractCallNode(NodeSeq Head, NodeSeq Args, Source Src, bool HasSrc) : Node(std::move(Args)), Head(std::move(Head)), Src(Src), HasSrc(HasSrc) {}
+    
+    //
+    // The head, then the args
+    //
+    const NodeSeq* childSeq(size_t i) const override;
+    
+#if USE_MATHLINK
+    void putOpen(ParserSession *session, MLINK mlp, size_t i) const override;
+    void putClose(ParserSession *session, MLINK mlp) const override;
+#endif // USE_MATHLINK
+    
+#if USE_EXPR_LIB
+    void toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const override;
+    void toExprClose(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void printOpen(ParserSession *session, std::ostream&, size_t i) const override;
+    void printClose(ParserSession *session, std::ostream&) const override;
+    
+    Source getSource() const override {
+        return Src;
+    }
+};
+
+//
+// MakeAbstractFallbackNode[cst] or MakeAbstractTopLevelFallbackNode[cst]
+//
+// The kernel aggregates and abstracts cst itself
+//
+class AbstractFallbackNode : public Node {
+    const SymbolPtr& MakeSym;
+public:
+    AbstractFallbackNode(const SymbolPtr& MakeSym, NodeSeq Args) : Node(std::move(Args)), MakeSym(MakeSym) {}
+    
+#if USE_MATHLINK
+    void putOpen(ParserSession *session, MLINK mlp, size_t i) const override;
+#endif // USE_MATHLINK
+    
+#if USE_EXPR_LIB
+    void toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const override;
+#endif // USE_EXPR_LIB
+    
+    void printOpen(ParserSession *session, std::ostream&, size_t i) const override;
+    void printClose(ParserSession *session, std::ostream&) const override;
+};
+
+//
+// The Source of a File container: from the start of the first top-level node to the end of the last, including
+// trivia
+//
+// {} if there are no top-level nodes
+//
+class AbstractContainerSourceNode : public Node {
+    const Source Src;
+    const bool Empty;
+public:
+    AbstractContainerSourceNode(Source Src, bool Empty) : Node(), Src(Src), Empty(Empty) {}
+    
+#if USE_MATHLINK
+    void put(ParserSession *session, MLINK mlp) const override;
+#endif // USE_MATHLINK
+    
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+};
+
+//
+// Abstract the List[CollectedExpressions, CollectedIssues, ...] that ParserSession::parseExpressions returns
+//
+// Returns the same list with the expressions abstracted, and with an AbstractContainerSourceNode at the end
+//
+// Errors, and tokens with line continuations or embedded newlines or tabs, are only handled by the kernel, so the
+// smallest nodes that have them are given back to the kernel
+//
+Node *abstractExpressions(ParserSession *session, Node *Parsed);
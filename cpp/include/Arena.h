@@ -0,0 +1,177 @@
+#pragma once
+
+#include <vector>
+#include <memory> // for unique_ptr
+#include <cstddef> // for size_t, max_align_t
+#include <cstdint> // for uintptr_t
+#include <type_traits> // for true_type
+#include <new> // for placement new
+#include <utility> // for forward
+
+class Arena;
+using ArenaPtr = std::unique_ptr<Arena>;
+
+//
+// A bump allocator
+//
+// Memory is handed out from large chunks and is only reclaimed all at once by reset()
+//
+// Chunks are kept across resets, so a session that is reused for many inputs stops calling malloc once it has
+// seen its largest input
+//
+// Only very large allocations, such as the children of a huge Call, still go to the heap each time
+//
+class Arena {
+    
+    struct Chunk {
+        std::unique_ptr<unsigned char[]> data;
+        size_t size;
+    };
+    
+    struct Destructor {
+        void *obj;
+        void (*destroy)(void *);
+    };
+    
+    std::vector<Chunk> chunks;
+    
+    //
+    // Allocations too large for a chunk get their own memory, which is freed on reset()
+    //
+    std::vector<std::unique_ptr<unsigned char[]>> large;
+    
+    //
+    // Index of the chunk currently being allocated from
+    //
+    size_t current;
+    
+    unsigned char *ptr;
+    unsigned char *end;
+    
+    std::vector<Destructor> destructors;
+    
+    size_t allocationCount;
+    size_t chunkAllocationCount;
+    
+    
+    void *allocateSlow(size_t size, size_t align);
+    
+    template <typename T>
+    static void destroy(void *obj) {
+        static_cast<T *>(obj)->~T();
+    }
+
+public:
+
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+    
+    //
+    // Allocations larger than this get their own memory
+    //
+    static const size_t LARGE_ALLOCATION_SIZE = DEFAULT_CHUNK_SIZE / 4;
+    
+    Arena();
+    
+    Arena(const Arena&) = delete;
+    
+    Arena& operator=(const Arena&) = delete;
+    
+    ~Arena();
+    
+    void *allocate(size_t size, size_t align = alignof(std::max_align_t)) {
+        
+        allocationCount++;
+        
+        auto p = reinterpret_cast<unsigned char *>((reinterpret_cast<uintptr_t>(ptr) + (align - 1)) & ~static_cast<uintptr_t>(align - 1));
+        
+        if (!ptr || p > end || size > static_cast<size_t>(end - p)) {
+            return allocateSlow(size, align);
+        }
+        
+        ptr = p + size;
+        
+        return p;
+    }
+    
+    //
+    // Construct a T in the arena
+    //
+    // The destructor of T is never run, so T must not own memory outside of the arena
+    //
+    template <typename T, typename... Args>
+    T *make(Args&&... args) {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+    
+    //
+    // Construct a T in the arena and run its destructor on reset()
+    //
+    template <typename T, typename... Args>
+    T *makeOwned(Args&&... args) {
+        
+        auto t = make<T>(std::forward<Args>(args)...);
+        
+        destructors.push_back(Destructor{t, &destroy<T>});
+        
+        return t;
+    }
+    
+    //
+    // Run pending destructors and make all memory available again
+    //
+    void reset();
+    
+    //
+    // Number of calls to allocate since construction
+    //
+    size_t getAllocationCount() const;
+    
+    //
+    // Number of chunks and large allocations requested from the heap since construction
+    //
+    size_t getChunkAllocationCount() const;
+    
+    //
+    // Total size of chunks currently held, not counting large allocations
+    //
+    size_t getCapacity() const;
+};
+
+//
+// Allocator for standard containers that live in an Arena
+//
+// deallocate does nothing, memory is reclaimed when the arena is reset
+//
+template <typename T>
+class ArenaAllocator {
+public:
+
+    using value_type = T;
+    
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    
+    Arena *arena;
+    
+    ArenaAllocator(Arena *arena) : arena(arena) {}
+    
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+    
+    T *allocate(size_t n) {
+        return static_cast<T *>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    
+    void deallocate(T *, size_t) {}
+    
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& other) const {
+        return arena == other.arena;
+    }
+    
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const {
+        return arena != other.arena;
+    }
+};
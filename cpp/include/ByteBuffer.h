@@ -17,10 +17,30 @@ using ByteBufferPtr = std::unique_ptr<ByteBuffer>;
 //
 class ByteBuffer {
     
+    ParserSession *session;
+    
     BufferAndLength origBufAndLen;
     
     WolframLibraryData libData;
     
+    //
+    // progress() is called when buffer reaches progressMark, every PROGRESS_INTERVAL bytes
+    //
+    Buffer progressMark;
+    
+    //
+    // The last percentage that was reported
+    //
+    size_t lastProgress;
+    
+    //
+    // Report the percentage of the input that has been read to the kernel, and poll for abort
+    //
+    // The checks in the parser are per token, and a single token may be very long. The token is still finished, but
+    // then the parser stops at its next check instead of after the rest of its budget
+    //
+    void progress();
+    
 public:
     
     Buffer buffer;
@@ -30,7 +50,7 @@ public:
     bool wasEOF;
     
     
-    ByteBuffer();
+    ByteBuffer(ParserSession *session);
     
     void init(BufferAndLength bufAndLen, WolframLibraryData libData = nullptr);
     
@@ -47,7 +67,19 @@ public:
     // Return current byte
     //
     unsigned char nextByte0();
+    
+    //
+    // Return pointer to the first byte in [p, e) that is not printable ASCII (0x20 - 0x7e), or is stop1 or stop2
+    //
+    // Return e if there is no such byte
+    //
+    // Scans 16 bytes at a time with SSE2, or 32 bytes at a time with AVX2 if USE_AVX2
+    //
+    static Buffer plainASCIIEnd(Buffer p, Buffer e, unsigned char stop1, unsigned char stop2);
+    
+    //
+    // Same as plainASCIIEnd, one byte at a time
+    //
+    static Buffer plainASCIIEnd_scalar(Buffer p, Buffer e, unsigned char stop1, unsigned char stop2);
 };
 
-extern ByteBufferPtr TheByteBuffer;
-
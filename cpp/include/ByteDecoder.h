@@ -1,40 +1,26 @@
 
 #pragma once
 
-#include "Source.h" // for IssuePtr, UTF8Status, etc.
+#include "Source.h" // for Issue, UTF8Status, etc.
 
 #include <set>
 #include <memory> // for unique_ptr
 
 class ByteDecoder;
-class SourceConventionManager;
 using ByteDecoderPtr = std::unique_ptr<ByteDecoder>;
-using SourceConventionManagerPtr = std::unique_ptr<SourceConventionManager>;
 
 //
 // How to manage advancing through SourceLocations
 //
-class SourceConventionManager {
-public:
-    
-    virtual SourceLocation newSourceLocation() = 0;
-    
-    virtual void newline(SourceLocation& loc) = 0;
-    
-    virtual void windowsNewline(SourceLocation& loc) = 0;
-    
-    void increment(SourceLocation& loc);
-    
-    virtual void tab(SourceLocation& loc) = 0;
-    
-    virtual ~SourceConventionManager() {}
-};
+// The decoder is specialized on the manager for the convention chosen in init(), so these are not virtual and
+// inline into the decoding loop
+//
 
 //
 // Handle next (non-newline) SourceLocation by incrementing column.
 // Handle next newline by incrementing line.
 //
-class LineColumnManager : public SourceConventionManager {
+class LineColumnManager {
     
     //
     // Use uint32_t here to match SourceLocation members
@@ -46,47 +32,119 @@ public:
     LineColumnManager(uint32_t TabWidth) : TabWidth(TabWidth) {}
     
     
-    SourceLocation newSourceLocation() override;
+    static SourceLocation newSourceLocation() {
+        return SourceLocation(1, 1);
+    }
     
-    void newline(SourceLocation& loc) override;
+    static void newline(SourceLocation& loc) {
+        loc.first++;
+        loc.second = 1;
+    }
     
-    void windowsNewline(SourceLocation& loc) override;
+    static void windowsNewline(SourceLocation& loc) {
+        loc.first++;
+        loc.second = 1;
+    }
     
-    void tab(SourceLocation& loc) override;
+    static void increment(SourceLocation& loc) {
+        loc.second++;
+    }
+    
+    void tab(SourceLocation& loc) const {
+        auto currentTabStop = TabWidth * ((loc.second - 1) / TabWidth) + 1;
+        loc.second = currentTabStop + TabWidth;
+    }
 };
 
 //
 // Handle next (non-newline) SourceLocation by incrementing index.
 // Handle next newline by incrementing index.
 //
-class SourceCharacterIndexManager : public SourceConventionManager {
+class SourceCharacterIndexManager {
+public:
     
-    SourceLocation newSourceLocation() override;
+    static SourceLocation newSourceLocation() {
+        return SourceLocation(0, 1);
+    }
     
-    void newline(SourceLocation& loc) override;
+    static void newline(SourceLocation& loc) {
+        loc.second++;
+    }
     
-    void windowsNewline(SourceLocation& loc) override;
+    static void windowsNewline(SourceLocation& loc) {
+        loc.second+=2;
+    }
     
-    void tab(SourceLocation& loc) override;
+    static void increment(SourceLocation& loc) {
+        loc.second++;
+    }
+    
+    static void tab(SourceLocation& loc) {
+        loc.second++;
+    }
 };
 
+//
+// Do not track SourceLocations at all
+//
+// Used when nothing that a session returns needs them
+//
+class NoSourceManager {
+public:
+    
+    static void newline(SourceLocation&) {}
+    
+    static void windowsNewline(SourceLocation&) {}
+    
+    static void increment(SourceLocation&) {}
+    
+    static void tab(SourceLocation&) {}
+};
+
+//
+// Make the manager for a convention
+//
+// Only LineColumnManager uses the tab width, the other managers have no state
+//
+template <typename SourceConventionManager>
+SourceConventionManager makeSourceConventionManager(uint32_t) {
+    return SourceConventionManager();
+}
+
+template <>
+inline LineColumnManager makeSourceConventionManager<LineColumnManager>(uint32_t TabWidth) {
+    return LineColumnManager(TabWidth);
+}
+
 //
 // Decode a sequence of UTF-8 encoded bytes into Source characters
 //
 class ByteDecoder {
 private:
     
-    IssuePtrSet Issues;
+    ParserSession *session;
+    
+    IssueVector Issues;
     
     UTF8Status status;
     
-    SourceConventionManagerPtr srcConventionManager;
+    SourceConvention srcConvention;
+    
+    uint32_t TabWidth;
+    
+    //
+    // False when the policy of the session does not need SourceLocations, and SrcLoc stays where init put it
+    //
+    bool trackSource;
     
     
     void strange(codepoint decoded, SourceLocation currentSourceCharacterStartLoc, double confidence);
     
     SourceCharacter invalid(SourceLocation errSrcLoc, NextPolicy policy);
     
+    template <typename SourceConventionManager>
+    SourceCharacter nextSourceCharacter0(NextPolicy policy);
+    
 public:
     
     Buffer lastBuf;
@@ -94,13 +152,30 @@ public:
     
     SourceLocation SrcLoc;
     
+    //
+    // The furthest that buffer has been left by nextSourceCharacter0 or skipPlainASCII since init, including while
+    // peeking
+    //
+    // Decoding a character may look at up to MAX_DECODER_LOOKAHEAD more bytes than this, to reject an invalid UTF-8
+    // sequence
+    //
+    Buffer furthest;
     
-    ByteDecoder();
+    static const size_t MAX_DECODER_LOOKAHEAD = 2;
+    
+    
+    ByteDecoder(ParserSession *session);
     
     void init(SourceConvention srcConvention, uint32_t TabWidth);
     
     void deinit();
     
+    SourceConvention getSourceConvention() const;
+    
+    uint32_t getTabWidth() const;
+    
+    bool getTrackSource() const;
+    
     //
     // Precondition: buffer is pointing to current SourceCharacter
     // Postcondition: buffer is pointing to next SourceCharacter
@@ -125,10 +200,29 @@ public:
     //
     SourceCharacter currentSourceCharacter(NextPolicy policy);
     
+    //
+    // Precondition: buffer is pointing to current SourceCharacter
+    // Postcondition: buffer is pointing to the first SourceCharacter that is not printable ASCII, or is stop1 or stop2
+    //
+    // Printable ASCII advances SrcLoc by 1 under every convention and never has issues, so a run of it
+    // can be skipped all at once
+    //
+    void skipPlainASCII(unsigned char stop1, unsigned char stop2);
+    
+    //
+    // The length of the valid UTF-8 sequence at p, or 0 if nextSourceCharacter0 would find it invalid
+    //
+    // A valid sequence advances SrcLoc by 1 character and an invalid one by 1 byte, so code that counts columns
+    // without decoding gets the same SourceLocations as the decoder
+    //
+    // \r, \n, and \t are valid sequences of length 1, but the decoder does not count them as 1 column
+    //
+    static size_t validSequenceLength(Buffer p, Buffer end);
+    
 #if !NISSUES
-    IssuePtrSet& getIssues();
+    IssueVector& getIssues();
     
-    void addIssue(IssuePtr);
+    void addIssue(Issue);
 #endif // !NISSUES
     
     void setStatus(UTF8Status status);
@@ -138,5 +232,3 @@ public:
     void clearStatus();
 };
 
-extern ByteDecoderPtr TheByteDecoder;
-
@@ -0,0 +1,322 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstddef> // for size_t
+#include <cstdint> // for uint32_t
+
+//
+// A flat binary encoding of a concrete syntax tree
+//
+// Written by CSTWriter and read by CSTReader
+//
+// This header and CSTReader.cpp do not depend on the rest of the parser, so that tools may read trees without
+// linking against it
+//
+// Layout, in the byte order of the writer:
+//
+// CSTHeader
+// CSTIssue[issueCount]
+// CSTNode[nodeCount]
+// uint32_t[childCount]         node indices, the children of a node are contiguous and come after it
+// CSTString[symbolCount]       names of symbols, issue tags, and severities, each only once
+// CSTAction[actionCount]
+// CSTLocation[locationCount]
+// unsigned char[stringsSize]   text that is not a slice of the input, such as issue messages
+//
+// Every section starts at a multiple of 8, so the sections may be used in place
+//
+// The text of leaves is not copied, it is given as an offset and length into the input that was parsed
+//
+// A stream may contain several trees one after another, such as the output of  codeparser -stream -binary
+//
+
+//
+// Bump when the layout changes
+//
+const uint32_t CST_VERSION = 2;
+
+//
+// "WCST" when the byte order of the reader matches the writer
+//
+const uint32_t CST_MAGIC = 0x54534357;
+
+//
+// The symbol of a node that does not have one, such as a Call
+//
+const uint32_t CST_NOSYMBOL = 0xffffffff;
+
+enum CSTNodeKind : uint8_t {
+    
+    CSTNODEKIND_LEAF,
+    CSTNODEKIND_ERROR,
+    CSTNODEKIND_PREFIX,
+    CSTNODEKIND_BINARY,
+    CSTNODEKIND_INFIX,
+    CSTNODEKIND_TERNARY,
+    CSTNODEKIND_POSTFIX,
+    CSTNODEKIND_PREFIXBINARY,
+    CSTNODEKIND_GROUP,
+    CSTNODEKIND_COMPOUND,
+    CSTNODEKIND_GROUPMISSINGCLOSER,
+    CSTNODEKIND_UNTERMINATEDGROUP,
+    CSTNODEKIND_CALL,
+    CSTNODEKIND_SYNTAXERROR,
+    
+    //
+    // Children are other nodes, as with every kind above
+    //
+    CSTNODEKIND_LIST,
+    
+    //
+    // Children are indices into the issues section
+    //
+    CSTNODEKIND_ISSUES,
+    
+    //
+    // Children are indices into the locations section
+    //
+    CSTNODEKIND_SOURCELOCATIONS,
+    
+    CSTNODEKIND_SOURCECHARACTER,
+    CSTNODEKIND_SAFESTRING,
+};
+
+//
+// Where the text of a node is
+//
+enum CSTText : uint8_t {
+    
+    CSTTEXT_NONE,
+    
+    //
+    // offset and length are into the input
+    //
+    CSTTEXT_INPUT,
+    
+    //
+    // offset and length are into the strings section
+    //
+    // Used for leaves with invalid UTF-8, which are given with the replacement characters that print and put use
+    //
+    CSTTEXT_STRINGS,
+};
+
+//
+// A slice of the strings section
+//
+struct CSTString {
+    uint32_t offset;
+    uint32_t length;
+};
+
+static_assert(sizeof(CSTString) == 8, "Check your assumptions");
+
+struct CSTLocation {
+    uint32_t first;
+    uint32_t second;
+};
+
+static_assert(sizeof(CSTLocation) == 8, "Check your assumptions");
+
+struct CSTSource {
+    CSTLocation Start;
+    CSTLocation End;
+};
+
+static_assert(sizeof(CSTSource) == 16, "Check your assumptions");
+
+struct CSTHeader {
+    
+    uint32_t magic;
+    uint32_t version;
+    
+    //
+    // SourceConvention of the locations
+    //
+    uint32_t srcConvention;
+    
+    //
+    // ParserSessionPolicy of the session that wrote the tree
+    //
+    uint32_t policy;
+    
+    //
+    // Size of the input that offsets refer to
+    //
+    uint32_t inputSize;
+    
+    uint32_t root;
+    
+    uint32_t issueCount;
+    uint32_t nodeCount;
+    uint32_t childCount;
+    uint32_t symbolCount;
+    uint32_t actionCount;
+    uint32_t locationCount;
+    uint32_t stringsSize;
+    
+    uint32_t reserved;
+};
+
+static_assert(sizeof(CSTHeader) == 56, "Check your assumptions");
+
+struct CSTNode {
+    
+    CSTNodeKind kind;
+    CSTText text;
+    
+    //
+    // TokenEnum value of leaves and error nodes
+    //
+    uint16_t tok;
+    
+    //
+    // Index into the symbols section
+    //
+    // The operator of operator nodes, the token symbol of leaves and error nodes, the error of syntax error nodes,
+    // and CST_NOSYMBOL otherwise
+    //
+    uint32_t symbol;
+    
+    //
+    // Index into the children section, or into the issues or locations sections
+    //
+    uint32_t firstChild;
+    uint32_t childCount;
+    
+    //
+    // The first headCount children of a Call are its head, the rest are its body
+    //
+    uint32_t headCount;
+    
+    uint32_t offset;
+    uint32_t length;
+    
+    CSTSource src;
+};
+
+static_assert(sizeof(CSTNode) == 44, "Check your assumptions");
+
+struct CSTIssue {
+    
+    //
+    // Only meaningful when hasConfidence is set
+    //
+    double confidence;
+    
+    CSTSource src;
+    
+    CSTString message;
+    
+    //
+    // Indices into the symbols section
+    //
+    uint32_t kind;
+    uint32_t tag;
+    uint32_t severity;
+    
+    //
+    // Index into the actions section
+    //
+    uint32_t firstAction;
+    uint32_t actionCount;
+    
+    uint32_t hasConfidence;
+};
+
+static_assert(sizeof(CSTIssue) == 56, "Check your assumptions");
+
+struct CSTAction {
+    
+    //
+    // Index into the symbols section
+    //
+    uint32_t kind;
+    
+    CSTString label;
+    
+    CSTSource src;
+    
+    //
+    // Replacement or insertion text, empty for deletions
+    //
+    CSTString text;
+};
+
+static_assert(sizeof(CSTAction) == 36, "Check your assumptions");
+
+//
+// Bytes of a tree or of its input, valid for as long as the reader and the input are
+//
+struct CSTSlice {
+    
+    const unsigned char *data;
+    size_t length;
+    
+    std::string str() const;
+};
+
+//
+// Reads trees written by CSTWriter
+//
+// Sections are used in place when the data is suitably aligned, and copied otherwise
+//
+class CSTReader {
+    
+    std::vector<uint64_t> copy;
+    
+    const CSTHeader *header;
+    const CSTIssue *issuesArr;
+    const CSTNode *nodesArr;
+    const uint32_t *childrenArr;
+    const CSTString *symbolsArr;
+    const CSTAction *actionsArr;
+    const CSTLocation *locationsArr;
+    const unsigned char *stringsArr;
+    
+    const unsigned char *input;
+    
+    bool validate() const;
+
+public:
+    
+    CSTReader();
+    
+    CSTReader(const CSTReader&) = delete;
+    
+    CSTReader& operator=(const CSTReader&) = delete;
+    
+    //
+    // Read the tree at the start of data
+    //
+    // input is the input that was parsed, and may be nullptr if the text of leaves is not needed
+    //
+    // Return the number of bytes of the tree, so that the next tree in a stream starts there, or 0 if data is not a
+    // valid tree
+    //
+    size_t read(const unsigned char *data, size_t len, const unsigned char *input, size_t inputLen);
+    
+    const CSTHeader& getHeader() const;
+    
+    const CSTNode& root() const;
+    
+    const CSTNode& node(uint32_t i) const;
+    
+    const CSTNode& child(const CSTNode& N, uint32_t i) const;
+    
+    const CSTIssue& issue(uint32_t i) const;
+    
+    const CSTAction& action(uint32_t i) const;
+    
+    CSTLocation location(uint32_t i) const;
+    
+    CSTSlice symbol(uint32_t i) const;
+    
+    CSTSlice string(CSTString S) const;
+    
+    //
+    // The text of a leaf, error, source character, or safe string node
+    //
+    CSTSlice text(const CSTNode& N) const;
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CSTFormat.h" // for CSTNode
+#include "Source.h" // for Source, Issue
+
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <ostream>
+
+class Node;
+
+//
+// Writes a tree in the format described in CSTFormat.h
+//
+// Nodes write themselves with Node::write, the same way that they print or put themselves
+//
+// A writer may be reused for many trees, and keeps its buffers between them
+//
+class CSTWriter {
+    
+    ParserSession *session;
+    
+    BufferAndLength input;
+    
+    std::vector<CSTIssue> issues;
+    std::vector<CSTNode> nodes;
+    std::vector<uint32_t> children;
+    std::vector<CSTString> symbols;
+    std::vector<CSTAction> actions;
+    std::vector<CSTLocation> locations;
+    std::string strings;
+    
+    //
+    // Indices of nodes that have been written, but not yet moved to the children of their parent
+    //
+    std::vector<uint32_t> pending;
+    
+    //
+    // For each open node, where its children start in pending
+    //
+    std::vector<size_t> frames;
+    
+    //
+    // Interned by address, names must be string literals or the names of symbols
+    //
+    std::unordered_map<const char *, uint32_t> symbolIndices;
+    
+    //
+    // Add a node without children of its own
+    //
+    uint32_t add(CSTNodeKind kind, uint32_t sym, Source Src);
+
+public:
+    
+    CSTWriter(ParserSession *session);
+    
+    void clear();
+    
+    //
+    // Write the tree N
+    //
+    // N must be the only tree written since the last clear
+    //
+    void write(const Node *N, std::ostream& s);
+    
+    uint32_t symbol(const char *name);
+    
+    CSTString string(const std::string& str);
+    
+    CSTSource source(Source Src) const;
+    
+    //
+    // Start a node, which is a child of the node that is currently open, if any
+    //
+    uint32_t open(CSTNodeKind kind, uint32_t sym, Source Src);
+    
+    //
+    // The children written so far are the head of the open Call
+    //
+    void markHead(uint32_t idx);
+    
+    void close(uint32_t idx);
+    
+    //
+    // A node without children, whose text is Buf
+    //
+    void leaf(CSTNodeKind kind, TokenEnum Tok, uint32_t sym, Source Src, BufferAndLength Buf);
+    
+    //
+    // A node without children, whose text is copied
+    //
+    void leaf(CSTNodeKind kind, const std::string& text);
+    
+    void collectedIssues(const IssueVector& Issues);
+    
+    void collectedSourceLocations(const SourceLocationVector& Locs);
+    
+    void action(const char *kind, const std::string& label, Source Src, const std::string& text);
+};
@@ -1,8 +1,9 @@
 
 #pragma once
 
-#include "Source.h" // for IssuePtr
+#include "Source.h" // for Issue
 #include "WLCharacter.h" // for WLCharacter
+#include "Arena.h" // for Arena
 
 #include "WolframLibrary.h"
 #undef True
@@ -23,11 +24,22 @@ using CharacterDecoderPtr = std::unique_ptr<CharacterDecoder>;
 //
 class CharacterDecoder {
     
-    IssuePtrSet Issues;
+    ParserSession *session;
     
-    std::set<SourceLocation> SimpleLineContinuations;
-    std::set<SourceLocation> ComplexLineContinuations;
-    std::set<SourceLocation> EmbeddedTabs;
+    IssueVector Issues;
+    
+    SourceLocationVector SimpleLineContinuations;
+    SourceLocationVector ComplexLineContinuations;
+    SourceLocationVector EmbeddedTabs;
+    
+    //
+    // Long name suggestions that issues refer to
+    //
+    // Kept until deinit, because issues found by peeking may outlive the nodes that were released since
+    //
+    // Also kept across init, because an IncrementalParserSession keeps issues while it parses the same text again
+    //
+    Arena Suggestions;
     
     
     WolframLibraryData libData;
@@ -57,14 +69,21 @@ class CharacterDecoder {
     //
     // Return empty string if no suggestion.
     //
-    std::string longNameSuggestion(BufferAndLength );
+    // The suggestion is copied into Suggestions, so that issues can refer to it
+    //
+    BufferAndLength longNameSuggestion(BufferAndLength );
     
 public:
     
     Buffer lastBuf;
     SourceLocation lastLoc;
     
-    CharacterDecoder();
+    //
+    // Whether a long name suggestion was wanted since init, but there was no libData to ask the kernel with
+    //
+    bool missedSuggestion;
+    
+    CharacterDecoder(ParserSession *session);
     
     void init(WolframLibraryData libData);
     
@@ -93,14 +112,14 @@ public:
     WLCharacter currentWLCharacter(Buffer tokenStartBuf, SourceLocation tokenStartLoc, NextPolicy policy);
     
 #if !NISSUES
-    IssuePtrSet& getIssues();
+    IssueVector& getIssues();
+    
+    void addIssue(Issue);
 #endif // !NISSUES
     
-    std::set<SourceLocation>& getSimpleLineContinuations();
+    SourceLocationVector& getSimpleLineContinuations();
     
-    std::set<SourceLocation>& getComplexLineContinuations();
+    SourceLocationVector& getComplexLineContinuations();
     
-    std::set<SourceLocation>& getEmbeddedTabs();
+    SourceLocationVector& getEmbeddedTabs();
 };
-
-extern CharacterDecoderPtr TheCharacterDecoder;
@@ -10,6 +10,9 @@
 #undef True
 #undef False
 
+#include <vector>
+#include <cstddef> // for size_t
+
 using expr = void *;
 
 
@@ -42,6 +45,63 @@ EXTERN_C expr Expr_CStringToIntegerExpr(const char*, mint, mbool);
 
 
 
+#if USE_EXPR_LIB
+
+class ParserSession;
+
+//
+// Builds an expression from the same sequence of calls that put makes on a link: function(head, n) is followed by
+// its n arguments
+//
+// An expression is inserted into its parent as soon as its last argument is given, so only the unfinished
+// expressions on the path from the root are kept
+//
+// Symbols that are arguments come from the session, which makes each of them once
+//
+// Heads are new symbols, because Expr_BuildExpr takes ownership of its head and there is no way to add a reference to
+// the session's
+//
+class ExprBuilder {
+  
+  struct Frame {
+    expr E;
+    mint Len;
+    mint Idx;
+  };
+  
+  ParserSession *session;
+  std::vector<Frame> Stack;
+  expr Result;
+  
+  void insert(expr e);
+  
+public:
+  ExprBuilder(ParserSession *session);
+  
+  ~ExprBuilder();
+  
+  void function(const char *Head, size_t Len);
+  
+  void symbol(const char *Name);
+  
+  void integer(int64_t i);
+  
+  void real(double d);
+  
+  void string(const unsigned char *Buf, size_t Len);
+  
+  //
+  // The finished expression, which the caller now owns
+  //
+  // nullptr if the expression was not finished, such as after an abort
+  //
+  expr get();
+};
+
+#endif // USE_EXPR_LIB
+
+
+
 #if USE_MATHLINK
 
 EXTERN_C DLLEXPORT int ExprTest_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res);
@@ -4,32 +4,63 @@
 #include "Source.h" // for Source
 #include "Symbol.h" // for SymbolPtr
 #include "Token.h" // for Token
+#include "Arena.h" // for Arena, ArenaAllocator
+#include "CSTFormat.h" // for CSTNodeKind
 
 #include <vector>
 #include <set>
 #include <memory> // for unique_ptr
 #include <ostream>
+#include <cstdint> // for uint32_t
 
 class Node;
 class LeafNode;
 class NodeSeqNode;
+class CSTWriter;
 
-using NodePtr = std::unique_ptr<Node>;
-using LeafNodePtr = std::unique_ptr<LeafNode>;
-using NodeSeqNodePtr = std::unique_ptr<NodeSeqNode>;
+//
+// Nodes are allocated in the Arena of the session that creates them, and are released all at once when the session
+// releases its nodes
+//
+// So NodePtr only expresses ownership within the tree, destroying a NodePtr does nothing
+//
+struct NodeDeleter {
+    void operator()(Node *) const {}
+};
+
+using NodePtr = std::unique_ptr<Node, NodeDeleter>;
+using LeafNodePtr = std::unique_ptr<LeafNode, NodeDeleter>;
+using NodeSeqNodePtr = std::unique_ptr<NodeSeqNode, NodeDeleter>;
 
 //
 // Used mainly for collecting trivia that has been eaten
 //
 class LeafSeq {
-    std::vector<LeafNodePtr> vec;
+    ParserSession *session;
+    std::vector<LeafNodePtr, ArenaAllocator<LeafNodePtr>> vec;
 public:
     bool moved;
     
-    LeafSeq() : vec(), moved(false) {}
+    LeafSeq(ParserSession *session);
+    
+    LeafSeq(LeafSeq&& other) : session(other.session), vec(std::move(other.vec)), moved(false) {
+        other.moved = true;
+    }
     
-    LeafSeq(LeafSeq&& other) : vec(std::move(other.vec)), moved(false) {
+    //
+    // Used for keeping trivia in a ParserFrame while an operand is parsed
+    //
+    LeafSeq& operator=(LeafSeq&& other) {
+        
+        assert(moved || vec.empty());
+        
+        session = other.session;
+        vec = std::move(other.vec);
+        moved = false;
+        
         other.moved = true;
+        
+        return *this;
     }
     
     ~LeafSeq();
@@ -44,10 +75,22 @@ public:
     void append(LeafNodePtr );
     
 #if USE_MATHLINK
-    void put0(MLINK ) const;
+    void put0(ParserSession *session, MLINK ) const;
 #endif // USE_MATHLINK
     
-    void print0(std::ostream& s) const;
+#if USE_EXPR_LIB
+    void toExpr0(ParserSession *session, ExprBuilder& B) const;
+#endif // USE_EXPR_LIB
+    
+    void print0(ParserSession *session, std::ostream& s) const;
+    
+    void write0(ParserSession *session, CSTWriter& W) const;
+    
+    void aggregate0(std::vector<const Node *>& V) const;
+    
+    void leaves0(std::vector<Node *>& V) const;
+    
+    void shift(const SourceShift& S) const;
 };
 
 //
@@ -60,14 +103,16 @@ public:
 //
 class NodeSeq {
     
-    std::vector<NodePtr> vec;
+    std::vector<NodePtr, ArenaAllocator<NodePtr>> vec;
     
 public:
     
-    NodeSeq() : vec() {}
-    NodeSeq(size_t i) : vec() {
-        vec.reserve(i);
-    }
+    //
+    // An empty sequence that is never appended to, such as the children of a leaf
+    //
+    NodeSeq() : vec(ArenaAllocator<NodePtr>(nullptr)) {}
+    
+    NodeSeq(ParserSession *session, size_t i = 0);
     
     bool empty() const;
     
@@ -77,20 +122,33 @@ public:
     
     void appendIfNonEmpty(LeafSeq );
     
-    const Node* first() const;
-    const Node* last() const;
-    
-#if USE_MATHLINK
-    void put(MLINK ) const;
-    
-    void put0(MLINK ) const;
-#endif // USE_MATHLINK
+    //
+    // The number of nodes in the sequence, without splicing LeafSeqNodes and NodeSeqNodes like size does
+    //
+    size_t count() const {
+        return vec.size();
+    }
     
-    void print(std::ostream& s ) const;
+    const NodePtr& at(size_t i) const {
+        return vec[i];
+    }
     
-    void print0(std::ostream& s ) const;
+    const Node* first() const;
+    const Node* last() const;
     
-    bool check() const;
+    //
+    // Append the nodes of the sequence to V as in CodeParser`Aggregate: trivia is skipped, and LeafSeqNodes and
+    // NodeSeqNodes are spliced
+    //
+    void aggregate(std::vector<const Node *>& V) const;
+    
+    //
+    // Append the LeafNodes and ErrorNodes under the nodes of the sequence to V in order, including trivia, as in
+    // Cases[seq, LeafNode[___] | ErrorNode[___], Infinity]
+    //
+    // UnterminatedGroupNodes are appended whole, their leaves were already chosen when they were made
+    //
+    void leaves(std::vector<Node *>& V) const;
 };
 
 //
@@ -104,7 +162,23 @@ public:
     Node() : Children() {}
     Node(NodeSeq Children);
     
-    virtual void print(std::ostream&) const = 0;
+    //
+    // print, put, toExpr, write, shift, and check go through the tree with NodeVisit, which keeps the path from the
+    // root in the heap instead of on the C++ stack
+    //
+    // A node with children is visited as printOpen(0), the children in childSeq(0), printOpen(1), the children in
+    // childSeq(1), and so on, then printClose
+    //
+    // A node without children overrides print, put, toExpr, and write themselves
+    //
+    // toExpr builds the same expression that put sends, directly as a kernel expression with ExprBuilder
+    //
+    virtual const NodeSeq* childSeq(size_t i) const;
+    
+    virtual void print(ParserSession *session, std::ostream&) const;
+    
+    virtual void printOpen(ParserSession *session, std::ostream&, size_t i) const {}
+    virtual void printClose(ParserSession *session, std::ostream&) const {}
 
     virtual Source getSource() const;
     
@@ -115,13 +189,61 @@ public:
     
     virtual Token lastToken() const;
     
+    //
+    // What kind of node this is, as in CSTFormat.h
+    //
+    virtual CSTNodeKind kind() const {
+        return CSTNODEKIND_LIST;
+    }
+    
+    //
+    // Append this node to V, as in NodeSeq::aggregate
+    //
+    virtual void aggregate(std::vector<const Node *>& V) const {
+        V.push_back(this);
+    }
+    
+    //
+    // Append this node to V, as in NodeSeq::leaves
+    //
+    virtual void leaves0(std::vector<Node *>& V) {
+        V.push_back(this);
+    }
+    
 #if USE_MATHLINK
-    virtual void put(MLINK mlp) const = 0;
+    virtual void put(ParserSession *session, MLINK mlp) const;
     
-    void putChildren(MLINK mlp) const;
+    virtual void putOpen(ParserSession *session, MLINK mlp, size_t i) const {}
+    virtual void putClose(ParserSession *session, MLINK mlp) const {}
 #endif // USE_MATHLINK
     
-    void printChildren(std::ostream& s) const;
+#if USE_EXPR_LIB
+    virtual void toExpr(ParserSession *session, ExprBuilder& B) const;
+    
+    virtual void toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const {}
+    virtual void toExprClose(ParserSession *session, ExprBuilder& B) const {}
+#endif // USE_EXPR_LIB
+    
+    //
+    // Write this node in the binary format of CSTFormat.h
+    //
+    virtual void write(ParserSession *session, CSTWriter& W) const;
+    
+    //
+    // Mark is kept by NodeVisit from writeOpen(0) until writeClose
+    //
+    virtual void writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const {}
+    virtual void writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const {}
+    
+    //
+    // Move this node and its children by S, after an edit before them
+    //
+    void shift(const SourceShift& S);
+    
+    //
+    // Move only this node
+    //
+    virtual void shift0(const SourceShift& S) {}
 
     const NodeSeq& getChildrenSafe() const {
         return Children;
@@ -133,6 +255,13 @@ public:
     
     virtual bool check() const;
     
+    //
+    // Check only this node
+    //
+    virtual bool check0() const {
+        return true;
+    }
+    
     virtual ~Node() {}
 };
 
@@ -160,10 +289,22 @@ public:
     const Node* last() const override;
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
+    
+    void aggregate(std::vector<const Node *>& V) const override;
+    
+    void leaves0(std::vector<Node *>& V) override;
+    
+    void shift0(const SourceShift& S) override;
 };
 
 //
@@ -181,11 +322,7 @@ public:
     const Node* first() const override;
     const Node* last() const override;
     
-#if USE_MATHLINK
-    void put(MLINK mlp) const override;
-#endif // USE_MATHLINK
-    
-    void print(std::ostream&) const override;
+    void aggregate(std::vector<const Node *>& V) const override;
 };
 
 //
@@ -194,14 +331,42 @@ public:
 class OperatorNode : public Node {
     SymbolPtr& Op;
     SymbolPtr& MakeSym;
+    //
+    // Computed once from the children, so that print and put do not walk down the tree at every level
+    //
+    Source Src;
 public:
-    OperatorNode(SymbolPtr& Op, SymbolPtr& MakeSym, NodeSeq Args) : Node(std::move(Args)), Op(Op), MakeSym(MakeSym) {}
+    OperatorNode(SymbolPtr& Op, SymbolPtr& MakeSym, NodeSeq Args) : Node(std::move(Args)), Op(Op), MakeSym(MakeSym), Src(Node::getSource()) {}
+    
+    OperatorNode(SymbolPtr& Op, SymbolPtr& MakeSym, NodeSeq Args, Source Src) : Node(std::move(Args)), Op(Op), MakeSym(MakeSym), Src(Src) {}
+    
+    Source getSource() const override {
+        return Src;
+    }
+    
+    SymbolPtr& getOp() const {
+        return Op;
+    }
+    
+    CSTNodeKind kind() const override;
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void putOpen(ParserSession *session, MLINK mlp, size_t i) const override;
+    void putClose(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const override;
+    void toExprClose(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void printOpen(ParserSession *session, std::ostream&, size_t i) const override;
+    void printClose(ParserSession *session, std::ostream&) const override;
+    
+    void writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const override;
+    void writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const override;
+    
+    void shift0(const SourceShift& S) override;
 };
 
 //
@@ -210,7 +375,7 @@ public:
 // These are Symbols, String, Integers, Reals, etc.
 //
 class LeafNode : public Node {
-    const Token Tok;
+    Token Tok;
 public:
 
     LeafNode(Token& Tok) : Node(), Tok(Tok) {}
@@ -218,10 +383,18 @@ public:
     LeafNode(Token&& Tok) : Node(), Tok(std::move(Tok)) {}
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
+    
+    void shift0(const SourceShift& S) override;
     
     Source getSource() const override {
         return Tok.Src;
@@ -235,8 +408,14 @@ public:
         return Tok;
     }
     
-    bool check() const override {
-        return true;
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_LEAF;
+    }
+    
+    void aggregate(std::vector<const Node *>& V) const override {
+        if (!Tok.Tok.isTrivia()) {
+            V.push_back(this);
+        }
     }
 };
 
@@ -245,7 +424,7 @@ public:
 //
 class ErrorNode : public Node {
 protected:
-    const Token Tok;
+    Token Tok;
 public:
     
     ErrorNode(Token& Tok) : Node(), Tok(Tok) {
@@ -257,10 +436,18 @@ public:
     }
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
+    
+    void shift0(const SourceShift& S) override;
     
     Source getSource() const override {
         return Tok.Src;
@@ -270,7 +457,11 @@ public:
         return Tok;
     }
     
-    bool check() const override {
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_ERROR;
+    }
+    
+    bool check0() const override {
         return false;
     }
 };
@@ -291,19 +482,6 @@ public:
     }
 };
 
-class UnterminatedTokenErrorNeedsReparseNode : public ErrorNode {
-public:
-    UnterminatedTokenErrorNeedsReparseNode(Token& Tok) : ErrorNode(Tok) {}
-    
-    UnterminatedTokenErrorNeedsReparseNode(Token&& Tok) : ErrorNode(Tok) {}
-    
-#if USE_MATHLINK
-    void put(MLINK mlp) const override;
-#endif // USE_MATHLINK
-    
-    void print(std::ostream&) const override;
-};
-
 //
 // PrefixNode
 //
@@ -371,18 +549,42 @@ public:
 //
 class CallNode : public Node {
     NodeSeq Head;
+    Source Src;
 public:
-    CallNode(NodeSeq Head, NodeSeq Body) : Node(std::move(Body)), Head(std::move(Head)) {}
+    CallNode(NodeSeq Head, NodeSeq Body);
+    
+    //
+    // The head, then the body
+    //
+    const NodeSeq* childSeq(size_t i) const override;
+    
+    const NodeSeq& getHead() const {
+        return Head;
+    }
+    
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_CALL;
+    }
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void putOpen(ParserSession *session, MLINK mlp, size_t i) const override;
+    void putClose(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const override;
+    void toExprClose(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
     
-    Source getSource() const override;
+    void printOpen(ParserSession *session, std::ostream&, size_t i) const override;
+    void printClose(ParserSession *session, std::ostream&) const override;
     
-    virtual bool check() const override;
+    void writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const override;
+    void writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const override;
+    
+    void shift0(const SourceShift& S) override;
+    
+    Source getSource() const override;
 };
 
 //
@@ -418,16 +620,37 @@ public:
 //
 class SyntaxErrorNode : public Node {
     const SyntaxError Err;
+    Source Src;
 public:
-    SyntaxErrorNode(SyntaxError Err, NodeSeq Args) : Node(std::move(Args)), Err(Err) {}
+    SyntaxErrorNode(SyntaxError Err, NodeSeq Args) : Node(std::move(Args)), Err(Err), Src(Node::getSource()) {}
+    
+    Source getSource() const override {
+        return Src;
+    }
+    
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_SYNTAXERROR;
+    }
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void putOpen(ParserSession *session, MLINK mlp, size_t i) const override;
+    void putClose(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const override;
+    void toExprClose(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
     
-    bool check() const override {
+    void printOpen(ParserSession *session, std::ostream&, size_t i) const override;
+    void printClose(ParserSession *session, std::ostream&) const override;
+    
+    void writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const override;
+    void writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const override;
+    
+    void shift0(const SourceShift& S) override;
+    
+    bool check0() const override {
         return false;
     }
 };
@@ -441,21 +664,23 @@ class GroupMissingCloserNode : public OperatorNode {
 public:
     GroupMissingCloserNode(SymbolPtr& Op, NodeSeq Args) : OperatorNode(Op, SYMBOL_CODEPARSER_LIBRARY_MAKEGROUPMISSINGCLOSERNODE, std::move(Args)) {}
     
-    bool check() const override {
+    bool check0() const override {
         return false;
     }
 };
 
 //
-// UnterminatedGroupNeedsReparseNode
+// UnterminatedGroupNode
 //
 // {
 //
-class UnterminatedGroupNeedsReparseNode : public OperatorNode {
+// Args are only the leaves of the group up to the end of Tokenizer::recoverUnterminated, and Src ends there
+//
+class UnterminatedGroupNode : public OperatorNode {
 public:
-    UnterminatedGroupNeedsReparseNode(SymbolPtr& Op, NodeSeq Args) : OperatorNode(Op, SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDGROUPNEEDSREPARSENODE, std::move(Args)) {}
+    UnterminatedGroupNode(SymbolPtr& Op, NodeSeq Args, Source Src) : OperatorNode(Op, SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDGROUPNODE, std::move(Args), Src) {}
     
-    bool check() const override {
+    bool check0() const override {
         return false;
     }
 };
@@ -468,11 +693,21 @@ class CollectedExpressionsNode : public Node {
 public:
     CollectedExpressionsNode(std::vector<NodePtr> Exprs) : Node(), Exprs(std::move(Exprs)) {}
     
+    const std::vector<NodePtr>& getExpressions() const {
+        return Exprs;
+    }
+    
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
     
     bool check() const override;
 };
@@ -481,15 +716,29 @@ public:
 //
 //
 class CollectedIssuesNode : public Node {
-    IssuePtrSet Issues;
+    IssueVector Issues;
 public:
-    CollectedIssuesNode(IssuePtrSet Issues) : Node(), Issues(std::move(Issues)) {}
+    CollectedIssuesNode(IssueVector Issues) : Node(), Issues(std::move(Issues)) {}
+    
+    const IssueVector& getIssues() const {
+        return Issues;
+    }
+    
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_ISSUES;
+    }
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
     
     bool check() const override;
 };
@@ -498,15 +747,29 @@ public:
 //
 //
 class CollectedSourceLocationsNode : public Node {
-    std::set<SourceLocation> SourceLocs;
+    SourceLocationVector SourceLocs;
 public:
-    CollectedSourceLocationsNode(std::set<SourceLocation> SourceLocs) : Node(), SourceLocs(std::move(SourceLocs)) {}
+    CollectedSourceLocationsNode(SourceLocationVector SourceLocs) : Node(), SourceLocs(std::move(SourceLocs)) {}
+    
+    const SourceLocationVector& getSourceLocations() const {
+        return SourceLocs;
+    }
+    
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_SOURCELOCATIONS;
+    }
     
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
 };
 
 //
@@ -517,11 +780,21 @@ class ListNode : public Node {
 public:
     ListNode(std::vector<NodePtr> N) : Node(), N(std::move(N)) {}
     
+    const std::vector<NodePtr>& getNodes() const {
+        return N;
+    }
+    
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
     
     bool check() const override;
 };
@@ -537,11 +810,21 @@ public:
     
     SourceCharacterNode(SourceCharacter&& Char) : Node(), Char(std::move(Char)) {}
     
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_SOURCECHARACTER;
+    }
+    
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
 };
 
 //
@@ -555,9 +838,19 @@ public:
     
     SafeStringNode(std::vector<unsigned char>&& safeBytes) : Node(), safeBytes(std::move(safeBytes)) {}
     
+    CSTNodeKind kind() const override {
+        return CSTNODEKIND_SAFESTRING;
+    }
+    
 #if USE_MATHLINK
-    void put(MLINK mlp) const override;
+    void put(ParserSession *session, MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream&) const override;
+#if USE_EXPR_LIB
+    void toExpr(ParserSession *session, ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
+    void print(ParserSession *session, std::ostream&) const override;
+    
+    void write(ParserSession *session, CSTWriter& W) const override;
 };
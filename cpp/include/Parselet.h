@@ -25,6 +25,13 @@ using ContextSensitiveInfixParseletPtr = ContextSensitiveInfixParselet *;
 //
 // Classes that derive from Parselet are responsible for parsing specific kinds of syntax
 //
+// Parselets do not return their nodes. A parselet ends with exactly one of Parser::parsePrefix, Parser::infixLoop,
+// or Parser::returnNode and returns to the Parser. A parselet that needs an operand pushes a ParserFrame first, and
+// finishes in a static continuation that is called with the operand.
+//
+// Parselets may call other parselets directly only as the last thing they do, or after pushing a frame. So the C++
+// stack stays shallow, however deeply the input is nested.
+//
 class Parselet {
 public:
     
@@ -39,7 +46,7 @@ public:
     //
     // Commonly referred to as NUD method in the literature
     //
-    virtual NodePtr parse(Token firstTok, ParserContext Ctxt) const = 0;
+    virtual void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const = 0;
     
     virtual ~PrefixParselet() {}
 };
@@ -52,7 +59,7 @@ public:
     //
     // Commonly referred to as LED method in the literature
     //
-    virtual NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const = 0;
+    virtual void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const = 0;
     
     virtual Precedence getPrecedence(ParserContext Ctxt) const = 0;
     
@@ -72,10 +79,13 @@ public:
 //
 class CallParselet : public InfixParselet {
     PrefixParseletPtr GP;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
 public:
     CallParselet(PrefixParseletPtr GP) : GP(std::move(GP)) {}
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_CALL;
@@ -88,7 +98,7 @@ public:
 class ContextSensitivePrefixParselet : virtual public Parselet {
 public:
     
-    virtual NodePtr parseContextSensitive(Token firstTok, ParserContext Ctxt) const = 0;
+    virtual NodePtr parseContextSensitive(ParserSession *session, Token firstTok, ParserContext Ctxt) const = 0;
     
     virtual ~ContextSensitivePrefixParselet() {}
 };
@@ -99,7 +109,7 @@ public:
 class ContextSensitiveInfixParselet : virtual public Parselet {
 public:
     
-    virtual NodePtr parseContextSensitive(NodeSeq Left, Token firstTok, ParserContext Ctxt) const = 0;
+    virtual void parseContextSensitive(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const = 0;
     
     virtual ~ContextSensitiveInfixParselet() {}
 };
@@ -110,7 +120,7 @@ public:
 class LeafParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -119,7 +129,7 @@ public:
 class PrefixEndOfFileParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -128,7 +138,7 @@ public:
 class PrefixErrorParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -137,7 +147,7 @@ public:
 class PrefixCloserParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -146,7 +156,7 @@ public:
 class PrefixToplevelCloserParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -155,7 +165,7 @@ public:
 class PrefixUnsupportedTokenParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -164,7 +174,7 @@ public:
 class PrefixCommaParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -173,7 +183,7 @@ public:
 class PrefixUnhandledParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -182,10 +192,13 @@ public:
 class PrefixOperatorParselet : public PrefixParselet {
     Precedence precedence;
     SymbolPtr& Op;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
 public:
     PrefixOperatorParselet(TokenEnum Tok, Precedence precedence, SymbolPtr& Op) : precedence(precedence), Op(Op) {}
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
     
     virtual Precedence getPrecedence(ParserContext Ctxt) const {
         return precedence;
@@ -198,7 +211,7 @@ public:
 class InfixImplicitTimesParselet : public InfixParselet {
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override;
     
@@ -211,7 +224,7 @@ public:
 class InfixAssertFalseParselet : public InfixParselet {
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_LOWEST;
@@ -235,7 +248,7 @@ public:
 class InfixToplevelNewlineParselet : public InfixParselet {
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         //
@@ -251,10 +264,13 @@ public:
 class BinaryOperatorParselet : public InfixParselet {
     Precedence precedence;
     SymbolPtr& Op;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
 public:
     BinaryOperatorParselet(TokenEnum Tok, Precedence precedence, SymbolPtr& Op) : precedence(precedence), Op(Op) {}
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return precedence;
@@ -271,10 +287,18 @@ public:
 class InfixOperatorParselet : public InfixParselet {
     Precedence precedence;
     SymbolPtr& Op;
+    
+    //
+    // One iteration of the loop over operators and operands, the loop continues in parse1 after the operand
+    //
+    void parseLoop(ParserSession *session, NodeSeq Args, Token OperandLastToken, ParserContext Ctxt, ParserContext CtxtIn) const;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
 public:
     InfixOperatorParselet(TokenEnum Tok, Precedence precedence, SymbolPtr& Op) : precedence(precedence), Op(Op) {}
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return precedence;
@@ -294,7 +318,7 @@ class PostfixOperatorParselet : public InfixParselet {
 public:
     PostfixOperatorParselet(TokenEnum Tok, Precedence precedence, SymbolPtr& Op) : precedence(precedence), Op(Op) {}
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return precedence;
@@ -311,10 +335,18 @@ public:
 class GroupParselet : public PrefixParselet {
     SymbolPtr& Op;
     Closer Closr;
+    
+    //
+    // One iteration of the loop over the elements, the loop continues in parse1 after the element
+    //
+    void parseLoop(ParserSession *session, NodeSeq Args, ParserContext Ctxt, ParserContext CtxtIn) const;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
 public:
     GroupParselet(TokenEnum Opener, SymbolPtr& Op) : Op(Op), Closr(GroupOpenerToCloser(Opener)) {}
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 
@@ -327,9 +359,9 @@ public:
 //
 class SymbolParselet : public PrefixParselet, public ContextSensitivePrefixParselet {
 public:
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
     
-    NodePtr parseContextSensitive(Token firstTok, ParserContext Ctxt) const override;
+    NodePtr parseContextSensitive(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -337,9 +369,14 @@ public:
 // multiple inheritance
 //
 class CommaParselet : public InfixParselet {
+    
+    void parseLoop(ParserSession *session, NodeSeq Args, Token lastOperatorToken, ParserContext Ctxt, ParserContext CtxtIn) const;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_COMMA;
@@ -355,9 +392,14 @@ public:
 // multiple inheritance
 //
 class SemiParselet : public InfixParselet {
+    
+    void parseLoop(ParserSession *session, NodeSeq Args, Token lastOperatorToken, ParserContext Ctxt, ParserContext CtxtIn) const;
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_SEMI;
@@ -377,7 +419,40 @@ class SemiSemiParselet : public PrefixParselet, public InfixParselet {
     //
     // Parses a single complete Span
     //
-    NodePtr parse0(NodeSeq Left, Token firstTok, ParserContext Ctxt) const;
+    // The Span is given to the frame on top
+    //
+    void parse0(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const;
+    
+    //
+    // a;;b  after b
+    //
+    static void parse01(ParserSession *session, ParserFrame& F, NodePtr FirstArg);
+    
+    //
+    // a;;b;;c  or  a;;;;c  after c
+    //
+    static void parse02(ParserSession *session, ParserFrame& F, NodePtr SecondArg);
+    
+    //
+    // One iteration of the loop over the Spans in a run, after the first Span
+    //
+    void parseLoop(ParserSession *session, NodeSeq Args, ParserContext Ctxt) const;
+    
+    //
+    // After the first Span
+    //
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
+    //
+    // After a general expression that ends the run
+    //
+    static void parse2(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
+    //
+    // After another Span
+    //
+    static void parse3(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
 public:
     
     //
@@ -391,7 +466,7 @@ public:
     //
     // Must also handle  ;;!b  where there is an implicit Times, but only a single Span
     //
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
     
     //
     // infix
@@ -404,7 +479,7 @@ public:
     //
     // Must also handle  a;;!b  where there is an implicit Times, but only a single Span
     //
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_SEMISEMI;
@@ -417,9 +492,14 @@ public:
 // It'd be weird if this were an "infix operator"
 //
 class TildeParselet : public InfixParselet {
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Middle);
+    
+    static void parse2(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         
@@ -435,6 +515,11 @@ public:
 // Something like  symbol:object  or  pattern:optional
 //
 class ColonParselet : public InfixParselet, public ContextSensitiveInfixParselet {
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
+    static void parse2(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
 public:
     
     //
@@ -443,14 +528,14 @@ public:
     // when parsing a in a:b  then ColonFlag is false
     // when parsing b in a:b  then ColonFlag is true
     //
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     //
     // Something like  pattern:optional
     //
     // Called from other parselets
     //
-    NodePtr parseContextSensitive(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parseContextSensitive(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_FAKE_OPTIONALCOLON;
@@ -469,9 +554,12 @@ public:
 // It'd be weird if this were an "infix operator"
 //
 class SlashColonParselet : public InfixParselet {
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Middle);
+    
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_SLASHCOLON;
@@ -482,20 +570,26 @@ public:
 // a /: b = c  and  a /: b = .  are handled here
 //
 class EqualParselet : public BinaryOperatorParselet {
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
 public:
     EqualParselet() : BinaryOperatorParselet(TOKEN_EQUAL, PRECEDENCE_EQUAL, SYMBOL_SET) {}
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
 // a /: b := c  is handled here
 //
 class ColonEqualParselet : public BinaryOperatorParselet {
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Right);
+    
 public:
     ColonEqualParselet() : BinaryOperatorParselet(TOKEN_COLONEQUAL, PRECEDENCE_COLONEQUAL, SYMBOL_SETDELAYED) {}
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
 };
 
 
@@ -503,9 +597,14 @@ public:
 // Something like  \[Integral] f \[DifferentialD] x
 //
 class IntegralParselet : public PrefixParselet {
+    
+    static void parse1(ParserSession *session, ParserFrame& F, NodePtr Operand);
+    
+    static void parse2(ParserSession *session, ParserFrame& F, NodePtr Variable);
+    
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -514,7 +613,7 @@ public:
 class ColonColonParselet : public InfixParselet {
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_COLONCOLON;
@@ -527,7 +626,7 @@ public:
 class GreaterGreaterParselet : public InfixParselet {
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_GREATERGREATER;
@@ -540,7 +639,7 @@ public:
 class GreaterGreaterGreaterParselet : public InfixParselet {
 public:
     
-    NodePtr parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const override;
     
     Precedence getPrecedence(ParserContext Ctxt) const override {
         return PRECEDENCE_GREATERGREATERGREATER;
@@ -553,7 +652,7 @@ public:
 class LessLessParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -572,7 +671,7 @@ public:
 class HashParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -581,7 +680,7 @@ public:
 class HashHashParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -590,7 +689,7 @@ public:
 class PercentParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -599,7 +698,7 @@ public:
 class PercentPercentParselet : public PrefixParselet {
 public:
     
-    NodePtr parse(Token firstTok, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token firstTok, ParserContext Ctxt) const override;
 };
 
 //
@@ -609,9 +708,9 @@ class UnderParselet : public PrefixParselet, public ContextSensitiveInfixParsele
     SymbolPtr& BOp;
     SymbolPtr& PBOp;
     
-    NodePtr parse0(Token TokIn, ParserContext Ctxt) const;
+    NodePtr parse0(ParserSession *session, Token TokIn, ParserContext Ctxt) const;
     
-    NodePtr parse1(NodePtr Blank, Token Tok, ParserContext Ctxt) const;
+    void parse1(ParserSession *session, NodePtr Blank, Token Tok, ParserContext Ctxt) const;
     
 public:
     
@@ -622,7 +721,7 @@ public:
     //
     // Something like  _  or  _a
     //
-    NodePtr parse(Token TokIn, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const override;
     
     //
     // infix
@@ -631,7 +730,7 @@ public:
     //
     // Called from other parselets
     //
-    NodePtr parseContextSensitive(NodeSeq Left, Token TokIn, ParserContext Ctxt) const override;
+    void parseContextSensitive(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const override;
 };
 
 //
@@ -639,7 +738,7 @@ public:
 //
 class UnderDotParselet : public PrefixParselet, public ContextSensitiveInfixParselet {
 
-    NodePtr parse0(Token TokIn, ParserContext Ctxt) const;
+    NodePtr parse0(ParserSession *session, Token TokIn, ParserContext Ctxt) const;
     
 public:
     
@@ -648,7 +747,7 @@ public:
     //
     // Something like  _.
     //
-    NodePtr parse(Token TokIn, ParserContext Ctxt) const override;
+    void parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const override;
     
     //
     // infix
@@ -657,5 +756,5 @@ public:
     //
     // Called from other parselets
     //
-    NodePtr parseContextSensitive(NodeSeq Left, Token TokIn, ParserContext Ctxt) const override;
+    void parseContextSensitive(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const override;
 };
@@ -2,16 +2,19 @@
 #pragma once
 
 #include "Node.h" // for LeafNodePtr, etc.
-#include "Source.h" // for IssuePtr
+#include "Source.h" // for Issue
 #include "Token.h" // for Token
 #include "Precedence.h" // for Precedence
 #include "TokenEnum.h" // for TokenEnum
 
 #include <set>
 #include <deque>
+#include <vector>
 #include <memory> // for unique_ptr
 
 class Parser;
+class PrefixParselet;
+struct ParserFrame;
 
 using ParserPtr = std::unique_ptr<Parser>;
 
@@ -80,16 +83,94 @@ struct ParserContext {
 static_assert(sizeof(ParserContext) == 2, "Check your assumptions");
 #endif // __clang__
 
+//
+// Called with the operand that a parselet asked for, and the frame that the parselet pushed before asking
+//
+using ParseletContinuation = void (*)(ParserSession *session, ParserFrame& F, NodePtr Operand);
+
+//
+// What a parselet needs to finish after its operand has been parsed
+//
+// Parselets do not call the parselet of their operand directly, because then the depth of the input would be the
+// depth of the C++ stack. Instead a parselet pushes a frame and asks the Parser for the operand, and the Parser calls
+// Resume with the operand when it is done.
+//
+// So nesting grows the vector of frames, and not the C++ stack
+//
+// Parselets build as much of Args as they can before asking for the operand, so a single LeafSeq of trivia is
+// enough. Resume must move Trivia out of the frame before doing anything else, so that trivia that is not used is
+// read again at the right time.
+//
+struct ParserFrame {
+    
+    ParseletContinuation Resume;
+    
+    //
+    // The parselet that pushed this frame, as the type that Resume expects
+    //
+    const void *P;
+    
+    ParserContext Ctxt;
+    ParserContext CtxtIn;
+    
+    Token Tok;
+    
+    NodeSeq Args;
+    
+    LeafSeq Trivia;
+    
+    ParserFrame(ParserSession *session, ParseletContinuation Resume, const void *P);
+};
+
+//
+// What the Parser does after a parselet returns
+//
+enum ParserStep : uint8_t {
+    //
+    // Parse StepTok with its prefix parselet
+    //
+    STEP_PREFIX,
+    
+    //
+    // Continue StepNode with infix parselets
+    //
+    STEP_INFIXLOOP,
+    
+    //
+    // Give StepNode to the frame on top, or return it
+    //
+    STEP_RETURN,
+};
+
 //
 //
 //
 class Parser {
 private:
     
-    IssuePtrSet Issues;
+    ParserSession *session;
+    
+    IssueVector Issues;
+    
+    //
+    // Frames are reused instead of being destroyed when they are popped, only the first FrameCount are in use
+    //
+    std::vector<ParserFrame> Frames;
+    size_t FrameCount;
+    
+    ParserStep Step;
+    Token StepTok;
+    ParserContext StepCtxt;
+    NodePtr StepNode;
+    
+    ParserFrame& pushFrame0(ParseletContinuation Resume, const void *P);
+    
+    void infixLoop0(NodePtr Left, ParserContext Ctxt);
+    
+    static void infixLoop1(ParserSession *session, ParserFrame& F, NodePtr Right);
     
 public:
-    Parser();
+    Parser(ParserSession *session);
     
     void init(bool firstLineIsShebang);
     
@@ -105,12 +186,79 @@ public:
     Token currentToken_stringifyAsFile() const;
     
 #if !NISSUES
-    IssuePtrSet& getIssues();
+    IssueVector& getIssues();
 
-    void addIssue(IssuePtr);
+    void addIssue(Issue);
 #endif // !NISSUES
     
-    NodePtr infixLoop(NodePtr Left, ParserContext Ctxt);
+    //
+    // Parse a complete expression, starting with firstTok and the prefix parselet P
+    //
+    // The only entry point into parselets
+    //
+    NodePtr parse(PrefixParselet *P, Token firstTok, ParserContext Ctxt);
+    
+    //
+    // Parselets end with exactly one of parsePrefix, infixLoop, or returnNode and then return
+    //
+    
+    //
+    // Parse the operand that starts with firstTok, and give it to the frame on top
+    //
+    void parsePrefix(Token firstTok, ParserContext Ctxt) {
+        
+        assert(FrameCount > 0);
+        
+        Step = STEP_PREFIX;
+        StepTok = firstTok;
+        StepCtxt = Ctxt;
+    }
+    
+    //
+    // Continue parsing with Left as the left operand of infix parselets
+    //
+    void infixLoop(NodePtr Left, ParserContext Ctxt) {
+        
+        Step = STEP_INFIXLOOP;
+        StepNode = std::move(Left);
+        StepCtxt = Ctxt;
+    }
+    
+    //
+    // N is complete
+    //
+    void returnNode(NodePtr N) {
+        
+        Step = STEP_RETURN;
+        StepNode = std::move(N);
+    }
+    
+    ParserFrame& pushFrame(ParseletContinuation Resume, const void *P) {
+        
+        if (FrameCount == Frames.size()) {
+            return pushFrame0(Resume, P);
+        }
+        
+        //
+        // Args and Trivia of a popped frame have been moved out
+        //
+        auto& F = Frames[FrameCount];
+        
+        F.Resume = Resume;
+        F.P = P;
+        F.Ctxt = ParserContext();
+        F.CtxtIn = ParserContext();
+        F.Tok = Token();
+        
+        FrameCount++;
+        
+        return F;
+    }
+    
+    //
+    // Push a frame that continues with infix parselets after the node that is given to it
+    //
+    void pushInfixLoop(ParserContext Ctxt);
     
     ~Parser();
 
@@ -120,5 +268,3 @@ public:
     Token eatTriviaButNotToplevelNewlines_stringifyAsFile(Token firstTok, ParserContext Ctxt, LeafSeq&);
 };
 
-extern ParserPtr TheParser;
-
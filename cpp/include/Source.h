@@ -3,6 +3,7 @@
 
 #include "TokenEnum.h" // for TokenEnum
 #include "CodePoint.h" // for codepoint
+#include "WLCharacter.h" // for WLCharacter
 
 #if USE_MATHLINK
 #include "mathlink.h"
@@ -10,24 +11,33 @@
 #endif // USE_MATHLINK
 
 #include <set>
+#include <vector>
 #include <string>
 #include <cassert>
 #include <iterator>
 #include <array>
 #include <memory> // for unique_ptr
+#include <cstddef> // for ptrdiff_t
 
 class Issue;
 class CodeAction;
+class ParserSession;
+class CSTWriter;
+class ExprBuilder;
 
-class IssuePtrCompare;
+class IssueCompare;
 class CodeActionPtrCompare;
 
 using Buffer = const unsigned char *;
 using MBuffer = unsigned char *;
-using IssuePtr = std::shared_ptr<Issue>;
 using CodeActionPtr = std::unique_ptr<CodeAction>;
 
-using IssuePtrSet = std::set<IssuePtr, IssuePtrCompare>;
+//
+// Issues and SourceLocations are appended as they are found, possibly more than once
+//
+// They are sorted and deduplicated once when collected, see ParserSession::parseExpressions
+//
+using IssueVector = std::vector<Issue>;
 using CodeActionPtrSet = std::set<CodeActionPtr, CodeActionPtrCompare>;
 
 //
@@ -75,6 +85,10 @@ struct BufferAndLength {
     void putUTF8String(MLINK ) const;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExprUTF8String(ExprBuilder& B) const;
+#endif // USE_EXPR_LIB
+    
     BufferAndLength createNiceBufferAndLength(std::string *str) const;
 };
 
@@ -185,41 +199,47 @@ enum SyntaxError : uint8_t {
     SYNTAXERROR_EXPECTEDSET,
 };
 
-std::string SyntaxErrorToString(SyntaxError Err);
-
-
-typedef const std::string SyntaxIssueTag;
-
-//
-//
-//
-SyntaxIssueTag SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER = "UnrecognizedCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNSUPPORTEDCHARACTER = "UnsupportedCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNDOCUMENTEDCHARACTER = "UndocumentedCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE = "UnexpectedEscapeSequence";
-SyntaxIssueTag SYNTAXISSUETAG_UNEXPECTEDCHARACTER = "UnexpectedCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNEXPECTEDNEWLINECHARACTER = "UnexpectedNewlineCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER = "UnexpectedSpaceCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER = "UnexpectedLetterlikeCharacter";
-SyntaxIssueTag SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX = "UndocumentedSlotSyntax";
-SyntaxIssueTag SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES = "UnexpectedImplicitTimes";
-SyntaxIssueTag SYNTAXISSUETAG_COMMA = "Comma";
+const char *SyntaxErrorToString(SyntaxError Err);
 
-typedef const std::string FormatIssueTag;
 
 //
-// xxx
+// Issues are kept as small records, and their tags, messages, and code actions are only turned into strings when
+// they are printed or put
 //
-FormatIssueTag FORMATISSUETAG_INSERTSPACE = "InsertSpace";
-
-
-typedef const std::string EncodingIssueTag;
+enum IssueKind : uint8_t {
+    ISSUEKIND_SYNTAX,
+    ISSUEKIND_FORMAT,
+    ISSUEKIND_ENCODING,
+};
 
-EncodingIssueTag ENCODINGISSUETAG_INVALIDCHARACTERENCODING = "InvalidCharacterEncoding";
-EncodingIssueTag ENCODINGISSUETAG_UNEXPECTEDCARRIAGERETURN = "UnexpectedCarriageReturn";
-EncodingIssueTag ENCODINGISSUETAG_UNEXPECTEDCHARACTER = "UnexpectedCharacter";
+const char *IssueKindSymbolName(IssueKind Kind);
 
+enum IssueTag : uint8_t {
+    
+    SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER,
+    SYNTAXISSUETAG_UNSUPPORTEDCHARACTER,
+    SYNTAXISSUETAG_UNDOCUMENTEDCHARACTER,
+    SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE,
+    SYNTAXISSUETAG_UNEXPECTEDCHARACTER,
+    SYNTAXISSUETAG_UNEXPECTEDNEWLINECHARACTER,
+    SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER,
+    SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER,
+    SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX,
+    SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES,
+    SYNTAXISSUETAG_COMMA,
+    
+    FORMATISSUETAG_INSERTSPACE,
+    
+    ENCODINGISSUETAG_INVALIDCHARACTERENCODING,
+    ENCODINGISSUETAG_UNEXPECTEDCARRIAGERETURN,
+    
+    //
+    // Same string as the syntax tag, so they are the same tag
+    //
+    ENCODINGISSUETAG_UNEXPECTEDCHARACTER = SYNTAXISSUETAG_UNEXPECTEDCHARACTER,
+};
 
+const char *IssueTagToString(IssueTag Tag);
 
 //
 // Used to be just SEVERITY_ERROR, etc.,
@@ -227,22 +247,202 @@ EncodingIssueTag ENCODINGISSUETAG_UNEXPECTEDCHARACTER = "UnexpectedCharacter";
 // c:\users\brenton\dropbox\wolfram\ast\ast\cpp\include\SyntaxIssue.h(19): warning C4005: 'SEVERITY_ERROR': macro redefinition
 // C:\Program Files (x86)\Windows Kits\10\include\10.0.17763.0\shared\winerror.h(28563): note: see previous definition of 'SEVERITY_ERROR'
 //
-typedef const std::string SyntaxIssueSeverity;
-
-SyntaxIssueSeverity SYNTAXISSUESEVERITY_REMARK = "Remark";
-SyntaxIssueSeverity SYNTAXISSUESEVERITY_WARNING = "Warning";
-SyntaxIssueSeverity SYNTAXISSUESEVERITY_ERROR = "Error";
-SyntaxIssueSeverity SYNTAXISSUESEVERITY_FATAL = "Fatal";
-
-typedef const std::string FormatIssueSeverity;
+enum IssueSeverity : uint8_t {
+    
+    SYNTAXISSUESEVERITY_REMARK,
+    SYNTAXISSUESEVERITY_WARNING,
+    SYNTAXISSUESEVERITY_ERROR,
+    SYNTAXISSUESEVERITY_FATAL,
+    
+    FORMATISSUESEVERITY_FORMATTING,
+    
+    ENCODINGISSUESEVERITY_WARNING = SYNTAXISSUESEVERITY_WARNING,
+    ENCODINGISSUESEVERITY_ERROR = SYNTAXISSUESEVERITY_ERROR,
+    ENCODINGISSUESEVERITY_FATAL = SYNTAXISSUESEVERITY_FATAL,
+};
 
-FormatIssueSeverity FORMATISSUESEVERITY_FORMATTING = "Formatting";
+const char *IssueSeverityToString(IssueSeverity Sev);
 
-typedef const std::string EncodingIssueSeverity;
+//
+// The message of an issue
+//
+// Char is a character stored in the issue
+// Buf is a slice of the input stored in the issue, starting with the character after the backslash
+//
+enum IssueMessage : uint8_t {
+    
+    //
+    // Unexpected ``\r`` character.
+    //
+    ISSUEMESSAGE_UNEXPECTEDCARRIAGERETURN,
+    
+    //
+    // Unexpected character: ``"Char" (Char)``.
+    //
+    // Char is formatted as a SourceCharacter
+    //
+    ISSUEMESSAGE_UNEXPECTEDENCODEDCHARACTER,
+    
+    //
+    // Invalid UTF-8 sequence.
+    //
+    ISSUEMESSAGE_INVALIDUTF8SEQUENCE,
+    
+    //
+    // Extra ``,``.
+    //
+    ISSUEMESSAGE_EXTRACOMMA,
+    
+    //
+    // Unexpected implicit ``Times`` between ``Spans``.
+    //
+    ISSUEMESSAGE_UNEXPECTEDIMPLICITTIMESBETWEENSPANS,
+    
+    //
+    // Unexpected space character: ``"Char" (Char)``.
+    //
+    ISSUEMESSAGE_UNEXPECTEDSPACECHARACTER,
+    
+    //
+    // Unexpected newline character: ``Char``.
+    //
+    ISSUEMESSAGE_UNEXPECTEDNEWLINECHARACTER,
+    
+    //
+    // Unexpected letterlike character: ``"Char" (Char)``.
+    //
+    // or just ``Char`` if Char is escaped
+    //
+    ISSUEMESSAGE_UNEXPECTEDLETTERLIKECHARACTER,
+    
+    //
+    // Unexpected character: ``Char``.
+    //
+    ISSUEMESSAGE_UNEXPECTEDCHARACTER,
+    
+    //
+    // The name following ``#`` is not documented to allow the **`** character.
+    //
+    ISSUEMESSAGE_UNDOCUMENTEDSLOTBACKTICK,
+    
+    //
+    // The name following ``#`` is not documented to allow the ``$`` character.
+    //
+    ISSUEMESSAGE_UNDOCUMENTEDSLOTDOLLAR,
+    
+    //
+    // The name following ``#`` is not documented to allow the ``"`` character.
+    //
+    ISSUEMESSAGE_UNDOCUMENTEDSLOTDOUBLEQUOTE,
+    
+    //
+    // Suspicious syntax.
+    //
+    ISSUEMESSAGE_SUSPICIOUSSYNTAX,
+    
+    //
+    // Put a space between ``-`` and ``>`` to reduce ambiguity
+    //
+    ISSUEMESSAGE_SPACEBETWEENMINUSGREATER,
+    ISSUEMESSAGE_SPACEBETWEENMINUSEQUAL,
+    ISSUEMESSAGE_SPACEBETWEENGREATEREQUAL,
+    ISSUEMESSAGE_SPACEBETWEENPLUSEQUAL,
+    
+    //
+    // Unrecognized character: ``\Buf``.
+    //
+    ISSUEMESSAGE_UNRECOGNIZEDCHARACTER,
+    
+    //
+    // Unsupported character: ``\Buf``.
+    //
+    ISSUEMESSAGE_UNSUPPORTEDCHARACTER,
+    
+    //
+    // Undocumented character: ``\Buf``.
+    //
+    ISSUEMESSAGE_UNDOCUMENTEDCHARACTER,
+    
+    //
+    // Unexpected escape sequence: ``\\Buf``.
+    //
+    ISSUEMESSAGE_UNEXPECTEDESCAPESEQUENCE,
+    
+    //
+    // Unrecognized character ``\Buf``.
+    //
+    ISSUEMESSAGE_UNRECOGNIZEDESCAPE,
+    
+    //
+    // Unrecognized character ``\\Char``.
+    //
+    ISSUEMESSAGE_UNRECOGNIZEDESCAPEDCHARACTER,
+};
 
-EncodingIssueSeverity ENCODINGISSUESEVERITY_WARNING = "Warning";
-EncodingIssueSeverity ENCODINGISSUESEVERITY_ERROR = "Error";
-EncodingIssueSeverity ENCODINGISSUESEVERITY_FATAL = "Fatal";
+//
+// The code actions of an issue
+//
+// Src is the Source of the issue
+//
+enum IssueAction : uint8_t {
+    
+    ISSUEACTION_NONE,
+    
+    //
+    // Replace Src with Char, and with each of the ASCII replacements for Char
+    //
+    ISSUEACTION_REPLACEWITHGRAPHICAL,
+    
+    //
+    // Delete ``,`` at Src
+    //
+    ISSUEACTION_DELETECOMMA,
+    
+    //
+    // Insert a space at the start of Src
+    //
+    ISSUEACTION_INSERTSPACE,
+    
+    //
+    // Insert ``*`` at the start of Src
+    //
+    ISSUEACTION_INSERTSTAR,
+    
+    //
+    // Replace Src with \\Buf
+    //
+    ISSUEACTION_ESCAPEBACKSLASH,
+    
+    //
+    // Insert ``]`` at the end of Src to form \[Suggestion]
+    //
+    ISSUEACTION_INSERTCLOSESQUARE,
+    
+    //
+    // Replace Src with \[Suggestion]
+    //
+    ISSUEACTION_REPLACEWITHSUGGESTION,
+    
+    //
+    // Insert ``[`` after the \ to form \[Buf
+    //
+    ISSUEACTION_INSERTOPENSQUARE,
+    
+    //
+    // Replace Src with \[BufXXX] and with \:BufXXX
+    //
+    ISSUEACTION_REPLACEWITHLONGNAMEOR4HEX,
+    
+    //
+    // Replace Src with \[BufXXX]
+    //
+    ISSUEACTION_REPLACEWITHLONGNAME,
+    
+    //
+    // Replace Src with \:Bufxxx
+    //
+    ISSUEACTION_REPLACEWITH4HEX,
+};
 
 
 //
@@ -370,16 +570,27 @@ struct SourceLocation {
     void putStructured(MLINK mlp) const;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const;
+    
+    void toExprStructured(ExprBuilder& B) const;
+#endif // USE_EXPR_LIB
+    
     void print(std::ostream& s) const;
 };
 
 static_assert(sizeof(SourceLocation) == 8, "Check your assumptions");
 
+bool operator==(SourceLocation a, SourceLocation b);
+bool operator!=(SourceLocation a, SourceLocation b);
+
 //
 // For LineContinuations and EmbeddedNewlines
 //
 bool operator<(SourceLocation a, SourceLocation b);
 
+using SourceLocationVector = std::vector<SourceLocation>;
+
 //
 // For googletest
 //
@@ -409,6 +620,12 @@ struct Source {
     void putStructured(MLINK mlp) const;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const;
+    
+    void toExprStructured(ExprBuilder& B) const;
+#endif // USE_EXPR_LIB
+    
     void print(std::ostream& s) const;
     
     size_t size() const;
@@ -426,13 +643,43 @@ bool operator<(Source a, Source b);
 //
 void PrintTo(const Source&, std::ostream*);
 
+//
+// How far text that follows an edit has moved
+//
+// Text is only ever moved from the start of a line, so under LineColumn only the line changes, and under
+// SourceCharacterIndex only the index changes
+//
+// first and second are added modulo 2^32, so that text may also move back
+//
+struct SourceShift {
+    
+    ptrdiff_t bytes;
+    uint32_t first;
+    uint32_t second;
+    
+    void apply(SourceLocation& L) const;
+    
+    void apply(Source& Src) const;
+    
+    //
+    // A buffer that is null does not point into the input, and is not moved
+    //
+    void apply(BufferAndLength& B) const;
+    
+    void apply(Issue& I) const;
+    
+    void apply(SourceLocationVector& Locs) const;
+};
+
 
 //
-// For std::set
+// For sorting IssueVector
 //
-class IssuePtrCompare {
+// Issues with the same start and tag are considered duplicates
+//
+class IssueCompare {
 public:
-    bool operator() (const IssuePtr &L, const IssuePtr &R) const;
+    bool operator() (const Issue &L, const Issue &R) const;
 };
 
 //
@@ -444,31 +691,50 @@ public:
 };
 
 //
+// An issue is a plain record
 //
+// Buf points into the input and Suggestion points into the CharacterDecoder, so an issue must be printed or put before
+// the input is freed or the session is deinited
 //
 class Issue {
 public:
-
-    const SyntaxIssueTag Tag;
-    const std::string Msg;
-    const SyntaxIssueSeverity Sev;
-    const Source Src;
-    const double Val;
-    const CodeActionPtrSet Actions;
     
-    Issue(std::string Tag, std::string Msg, std::string Sev, Source Src, double Val, CodeActionPtrSet Actions);
+    Source Src;
+    double Val;
+    
+    BufferAndLength Buf;
+    BufferAndLength Suggestion;
+    
+    WLCharacter Char;
+    
+    IssueKind Kind;
+    IssueTag Tag;
+    IssueSeverity Sev;
+    IssueMessage Msg;
+    IssueAction Act;
+    
+    Issue(IssueKind Kind, IssueTag Tag, IssueMessage Msg, IssueSeverity Sev, Source Src, double Val, IssueAction Act = ISSUEACTION_NONE, WLCharacter Char = WLCharacter(0), BufferAndLength Buf = BufferAndLength(), BufferAndLength Suggestion = BufferAndLength());
     
     Source getSource() const;
     
+    std::string getMessage() const;
+    
+    CodeActionPtrSet getActions() const;
+    
 #if USE_MATHLINK
-    virtual void put(MLINK mlp) const = 0;
+    void put(MLINK mlp) const;
 #endif // USE_MATHLINK
     
-    virtual void print(std::ostream& s) const = 0;
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const;
+#endif // USE_EXPR_LIB
     
-    virtual bool check() const = 0;
+    void print(std::ostream& s) const;
     
-    virtual ~Issue() {}
+    //
+    // ExtraComma issues are not fatal, but they still return false for check()
+    //
+    bool check() const;
 };
 
 //
@@ -490,8 +756,14 @@ public:
     virtual void put(MLINK mlp) const = 0;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    virtual void toExpr(ExprBuilder& B) const = 0;
+#endif // USE_EXPR_LIB
+    
     virtual void print(std::ostream& s) const = 0;
     
+    virtual void write(CSTWriter& W) const = 0;
+    
     virtual ~CodeAction() {}
 };
 
@@ -509,7 +781,13 @@ public:
     void put(MLINK mlp) const override;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
     void print(std::ostream& s) const override;
+    
+    void write(CSTWriter& W) const override;
 };
 
 //
@@ -525,7 +803,13 @@ public:
     void put(MLINK mlp) const override;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
     void print(std::ostream& s) const override;
+    
+    void write(CSTWriter& W) const override;
 };
 
 //
@@ -541,7 +825,13 @@ public:
     void put(MLINK mlp) const override;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
     void print(std::ostream& s) const override;
+    
+    void write(CSTWriter& W) const override;
 };
 
 //
@@ -556,7 +846,13 @@ public:
     void put(MLINK mlp) const override;
 #endif // USE_MATHLINK
     
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
+    
     void print(std::ostream& s) const override;
+    
+    void write(CSTWriter& W) const override;
 };
 
 //
@@ -571,63 +867,11 @@ public:
     void put(MLINK mlp) const override;
 #endif // USE_MATHLINK
     
-    void print(std::ostream& s) const override;
-};
-
-//
-//
-//
-class SyntaxIssue : public Issue {
-public:
-    SyntaxIssue(SyntaxIssueTag Tag, std::string Msg, SyntaxIssueSeverity Sev, Source Src, double Con, CodeActionPtrSet Actions) : Issue(Tag, Msg, Sev, Src, Con, std::move(Actions)) {}
-    
-#if USE_MATHLINK
-    void put(MLINK mlp) const override;
-#endif // USE_MATHLINK
-
-    void print(std::ostream& s) const override;
-    
-    bool check() const override;
-};
-
-//
-// ExtraCommaIssue is special because it is not fatal, but it should return false for check()
-//
-class ExtraCommaIssue : public SyntaxIssue {
-public:
-    ExtraCommaIssue(Source Src, CodeActionPtrSet Actions);
-    
-    bool check() const override;
-};
-
-//
-//
-//
-class FormatIssue : public Issue {
-public:
-    FormatIssue(FormatIssueTag Tag, std::string Msg, FormatIssueSeverity Sev, Source Src, CodeActionPtrSet Actions) : Issue(Tag, Msg, Sev, Src, 0.0, std::move(Actions)) {}
-    
-#if USE_MATHLINK
-    void put(MLINK mlp) const override;
-#endif // USE_MATHLINK
-    
-    void print(std::ostream& s) const override;
-    
-    bool check() const override;
-};
-
-//
-//
-//
-class EncodingIssue : public Issue {
-public:
-    EncodingIssue(EncodingIssueTag Tag, std::string Msg, EncodingIssueSeverity Sev, Source Src, double Con, CodeActionPtrSet Actions) : Issue(Tag, Msg, Sev, Src, Con, std::move(Actions)) {}
-    
-#if USE_MATHLINK
-    void put(MLINK mlp) const override;
-#endif // USE_MATHLINK
+#if USE_EXPR_LIB
+    void toExpr(ExprBuilder& B) const override;
+#endif // USE_EXPR_LIB
     
     void print(std::ostream& s) const override;
     
-    bool check() const override;
+    void write(CSTWriter& W) const override;
 };
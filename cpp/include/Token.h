@@ -18,6 +18,14 @@ struct Token {
     Token();
     Token(TokenEnum Tok, BufferAndLength BufLen, Source Src);
     
+    //
+    // The Source is only printed if the policy of session has INCLUDE_SOURCE
+    //
+    void print(ParserSession *session, std::ostream&) const;
+    
+    //
+    // Always print the Source
+    //
     void print(std::ostream&) const;
 };
 
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Source.h" // for Source
+
+#include <vector>
+#include <ostream>
+#include <cstddef> // for size_t
+#include <cstdint> // for uint16_t, uint32_t
+
+//
+// The tokens of an input as columns, without making any nodes
+//
+// Filled by ParserSession::tokenizeArrays, for tools such as syntax highlighters and indexers that only need the
+// kind and the extent of every token
+//
+// Arrays may be reused for many inputs, and keep their capacity between them
+//
+struct TokenArrays {
+
+    //
+    // TokenEnum values
+    //
+    std::vector<uint16_t> Toks;
+
+    //
+    // Byte offsets from the start of the input, End is one past the last byte
+    //
+    std::vector<uint32_t> Starts;
+    std::vector<uint32_t> Ends;
+
+    std::vector<Source> Srcs;
+
+
+    void clear();
+
+    void reserve(size_t n);
+
+    size_t size() const;
+
+    //
+    // Write the arrays as they are in memory, in the byte order of the writer:
+    //
+    // TokenArraysHeader
+    // uint16_t[count]      Toks
+    // uint32_t[count]      Starts
+    // uint32_t[count]      Ends
+    // uint32_t[4 * count]  Srcs, as Start.first, Start.second, End.first, End.second
+    //
+    // Every array starts at a multiple of 8
+    //
+    void write(std::ostream& s, SourceConvention srcConvention) const;
+};
+
+//
+// "WTOK" when the byte order of the reader matches the writer
+//
+const uint32_t TOKENARRAYS_MAGIC = 0x4b4f5457;
+
+//
+// Bump when the layout changes
+//
+const uint32_t TOKENARRAYS_VERSION = 1;
+
+struct TokenArraysHeader {
+
+    uint32_t magic;
+    uint32_t version;
+
+    //
+    // SourceConvention of Srcs
+    //
+    uint32_t srcConvention;
+
+    uint32_t count;
+};
+
+static_assert(sizeof(TokenArraysHeader) == 16, "Check your assumptions");
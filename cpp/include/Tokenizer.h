@@ -4,8 +4,8 @@
 #include "WLCharacter.h" // for WLCharacter
 #include "Token.h" // for Token
 
-#include <set>
 #include <memory> // for unique_ptr
+#include <array>
 
 class Tokenizer;
 using TokenizerPtr = std::unique_ptr<Tokenizer>;
@@ -27,15 +27,61 @@ struct NumberTokenizationContext {
 };
 
 
+//
+// A token that was lexed by currentToken
+//
+struct PeekEntry {
+    Buffer Buf;
+    bool WasEOF;
+    NextPolicy Policy;
+    Token Tok;
+    
+    PeekEntry() : Buf(), WasEOF(), Policy(), Tok() {}
+};
+
 //
 // Tokenizer takes a stream of WL characters and tokenizes them
 //
 class Tokenizer {
     
-    IssuePtrSet Issues;
+    ParserSession *session;
+    
+    IssueVector Issues;
+    
+    SourceLocationVector EmbeddedNewlines;
+    SourceLocationVector EmbeddedTabs;
+    
+    //
+    // The parser peeks at the same token many times before consuming it, possibly with different policies
+    //
+    // A token lexed at the same position with the same policy is the same token, so it is remembered here instead of
+    // being lexed again
+    //
+    // Lexing appends issues and locations to vectors, so a token that falls out of the cache and is lexed again appends
+    // them a second time, and the duplicates are removed by sortAndDedupe when the session collects them
+    //
+    static const size_t PEEK_CACHE_SIZE = 4;
+    
+    std::array<PeekEntry, PEEK_CACHE_SIZE> PeekCache;
+    size_t PeekCacheNext;
+    
+    size_t LexCount;
+    size_t PeekHitCount;
+    size_t TokenCount;
+    
+    //
+    // The last result of recoverUnterminated, which is the same for any Start in the same chunk before RecoverEnd
+    //
+    // Nested groups that are not closed are recovered from the inside out, so keying on the chunk end keeps both  ((((  EOF
+    // and a file with  f[  on each line linear
+    //
+    Buffer RecoverStart;
+    Buffer RecoverEnd;
+    SourceLocation RecoverEndLoc;
+    size_t RecoverScanCount;
     
-    std::set<SourceLocation> EmbeddedNewlines;
-    std::set<SourceLocation> EmbeddedTabs;
+    
+    void clearPeekCache();
     
     
     void backupAndWarn(Buffer resetBuf, SourceLocation resetLoc);
@@ -152,7 +198,7 @@ class Tokenizer {
     
     
 public:
-    Tokenizer();
+    Tokenizer(ParserSession *session);
     
     void init();
 
@@ -170,17 +216,51 @@ public:
     Token currentToken_stringifyAsSymbolSegment();
     Token currentToken_stringifyAsFile();
 
+    //
+    // Recover from a group or token that starts at Start and is not terminated before the end of the input
+    //
+    // The rest of the input may be a large file, so only the first chunk of lines is kept. A new chunk starts at a line
+    // that looks like the start of a new top-level expression: an annotation comment like  (* ::Package:: *) , a common
+    // directive like  Begin[  , or an assignment like  x = 1
+    //
+    // Returns the end of the last non-empty line of the first chunk, not including the newline, and sets End to its
+    // SourceLocation
+    //
+    Buffer recoverUnterminated(Buffer Start, SourceLocation StartLoc, SourceLocation& End);
+    
+    //
+    // Tok with its text and Source cut at the end of recoverUnterminated
+    //
+    Token recoverUnterminatedToken(Token Tok);
+    
 #if !NISSUES
-    void addIssue(IssuePtr);
+    void addIssue(Issue);
 
-    IssuePtrSet& getIssues();
+    IssueVector& getIssues();
 #endif // !NISSUES
     
-    std::set<SourceLocation>& getEmbeddedNewlines();
+    SourceLocationVector& getEmbeddedNewlines();
+    
+    SourceLocationVector& getEmbeddedTabs();
     
-    std::set<SourceLocation>& getEmbeddedTabs();
+    //
+    // Number of calls to nextToken0 since init
+    //
+    size_t getLexCount() const;
     
+    //
+    // Number of calls to currentToken since init that were answered from the peek cache
+    //
+    size_t getPeekHitCount() const;
+    
+    //
+    // Number of tokens consumed by nextToken since init
+    //
+    size_t getTokenCount() const;
+    
+    //
+    // Number of calls to recoverUnterminated since init that were not answered from the last result
+    //
+    size_t getRecoverScanCount() const;
 };
 
-extern TokenizerPtr TheTokenizer;
-
@@ -7,7 +7,10 @@
 #include <string>
 #include <unordered_set> // for unordered_set
 
-extern std::unordered_set<std::string> undocumentedLongNames;
+//
+// Code points of the long names that are undocumented
+//
+extern std::unordered_set<codepoint> undocumentedLongNames;
 
 
 std::ostream& set_graphical(std::ostream& stream);
@@ -28,7 +31,7 @@ int get_safe_i();
 class Utils {
 public:
     
-    static bool isUndocumentedLongName(std::string s);
+    static bool isUndocumentedLongName(codepoint point);
     
     static bool isMBNonCharacter(codepoint point);
     
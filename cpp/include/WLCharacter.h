@@ -107,9 +107,17 @@ struct WLCharacter {
     
     bool isSign() const;
     
+    //
+    // MBCLASS_ bits from LongNames.h, including the negative code points for linear syntax, string meta, and \r\n
+    //
+    // Classify a multi-byte character with a single table lookup, and then test the bits
+    //
+    uint8_t mbClass() const;
+    
     bool isMBLinearSyntax() const;
     bool isMBStringMeta() const;
     bool isMBLetterlike() const;
+    bool isMBLetterlike(uint8_t cls) const;
     bool isMBStrangeLetterlike() const;
     bool isMBPunctuation() const;
     bool isMBWhitespace() const;
@@ -1,22 +1,41 @@
 
-#include "ByteDecoder.h" // for TheByteDecoder
-#include "ByteBuffer.h" // for TheByteBuffer
-#include "API.h" // for TheParserSession
+#include "ByteDecoder.h" // for ByteDecoder
+#include "ByteBuffer.h" // for ByteBuffer
+#include "API.h" // for ParserSession
+#include "CSTWriter.h" // for CSTWriter
 
 #include "Source.h" // for MBuffer
 
 #include <memory> // for unique_ptr
 #include <iostream>
-#include <fstream> // for ofstream
+#include <fstream> // for ofstream, ifstream
 #include <cstdio> // for rewind
 #include <cstdlib> // for EXIT_SUCCESS
+#include <string>
+#include <vector>
+#include <algorithm> // for sort
+#include <chrono> // for steady_clock
+#ifdef _WIN32
+#include <windows.h> // for FindFirstFileA
+#include <io.h> // for _setmode
+#include <fcntl.h> // for _O_BINARY
+#else
+#include <sys/mman.h> // for mmap
+#include <sys/stat.h> // for fstat
+#include <fcntl.h> // for open
+#include <unistd.h> // for close
+#include <dirent.h> // for opendir
+#endif // _WIN32
 
 class ScopedFileBuffer;
 using ScopedFileBufferPtr = std::unique_ptr<ScopedFileBuffer>;
 
 enum APIMode {
     EXPRESSION,
+    ABSTRACT,
+    STREAM,
     TOKENIZE,
+    TOKENARRAYS,
     LEAF,
     SOURCECHARACTERS,
 };
@@ -27,6 +46,7 @@ enum OutputMode {
     PUT,
     PRINT_DRYRUN,
     CHECK,
+    BINARY,
 };
 
 
@@ -34,12 +54,28 @@ int readStdIn(APIMode mode, OutputMode outputMode, bool skipFirstLine);
 
 int readFile(std::string file, APIMode mode, OutputMode outputMode, bool firstLineIsShebang);
 
+int readFiles(const std::vector<std::string>& files, APIMode mode, OutputMode outputMode, bool firstLineIsShebang);
+
+bool readFileList(std::string listFile, std::vector<std::string>& files);
+
+bool readDirectory(std::string dir, std::vector<std::string>& files);
+
+bool outputNode(ParserSession& session, CSTWriter& writer, Node *N, APIMode mode, OutputMode outputMode);
+
+void outputTokenArrays(const TokenArrays& A, OutputMode outputMode);
+
+//
+// A file that has lexical scope
+//
+// The file is mapped read-only where mmap is available, and read into memory otherwise
+//
 class ScopedFileBuffer {
 
     MBuffer buf;
     size_t len;
 
     bool inited;
+    bool mapped;
 
 public:
 
@@ -59,14 +95,20 @@ public:
 int main(int argc, char *argv[]) {
     
     auto file = false;
+    auto files = false;
     auto tokenize = false;
+    auto arrays = false;
     auto leaf = false;
     auto outputMode = PRINT;
     auto sourceCharacters = false;
+    auto stream = false;
+    auto abstract = false;
     auto firstLineIsShebang = false;
     
     std::string fileInput;
     
+    std::vector<std::string> filesInput;
+    
     for (int i = 1; i < argc; i++) {
         auto arg = std::string(argv[i]);
         if (arg == "-file") {
@@ -76,10 +118,48 @@ int main(int argc, char *argv[]) {
             i++;
             fileInput = std::string(argv[i]);
 
+        } else if (arg == "-files") {
+            
+            //
+            // A file with one path on each line
+            //
+            
+            files = true;
+            
+            i++;
+            if (i == argc || !readFileList(std::string(argv[i]), filesInput)) {
+                return EXIT_FAILURE;
+            }
+            
+        } else if (arg == "-dir") {
+            
+            //
+            // Every .wl and .m file in a directory and its subdirectories
+            //
+            
+            files = true;
+            
+            i++;
+            if (i == argc || !readDirectory(std::string(argv[i]), filesInput)) {
+                return EXIT_FAILURE;
+            }
+            
         } else if (arg == "-tokenize") {
             
             tokenize = true;
             
+        } else if (arg == "-arrays") {
+            
+            //
+            // With -tokenize, write the tokens as the columns of TokenArrays.h to stdout instead of as nodes
+            //
+            
+            arrays = true;
+            
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif // _WIN32
+            
         } else if (arg == "-leaf") {
             
             leaf = true;
@@ -92,14 +172,42 @@ int main(int argc, char *argv[]) {
             
             outputMode = PUT;
             
+        } else if (arg == "-dryrun") {
+            
+            //
+            // Do all of the work of printing, but write nothing
+            //
+            
+            outputMode = PRINT_DRYRUN;
+            
         } else if (arg == "-sc") {
             
             sourceCharacters = true;
             
+        } else if (arg == "-stream") {
+            
+            stream = true;
+            
+        } else if (arg == "-abstract") {
+            
+            abstract = true;
+            
         } else if (arg == "-check") {
             
             outputMode = CHECK;
             
+        } else if (arg == "-binary") {
+            
+            //
+            // Write trees in the format of CSTFormat.h to stdout
+            //
+            
+            outputMode = BINARY;
+            
+#ifdef _WIN32
+            _setmode(_fileno(stdout), _O_BINARY);
+#endif // _WIN32
+            
         } else if (arg == "-firstLineIsShebang") {
             
             firstLineIsShebang = true;
@@ -109,17 +217,38 @@ int main(int argc, char *argv[]) {
         }
     }
     
+    //
+    // CSTFormat.h only has concrete syntax
+    //
+    if (abstract && outputMode == BINARY) {
+        return EXIT_FAILURE;
+    }
+    
     int result;
     
-    if (file) {
+    auto tokenizeMode = arrays ? TOKENARRAYS : TOKENIZE;
+    
+    auto expressionMode = abstract ? ABSTRACT : EXPRESSION;
+    
+    if (files) {
+        if (tokenize) {
+            result = readFiles(filesInput, tokenizeMode, outputMode, firstLineIsShebang);
+        } else if (stream) {
+            result = readFiles(filesInput, STREAM, outputMode, firstLineIsShebang);
+        } else {
+            result = readFiles(filesInput, expressionMode, outputMode, firstLineIsShebang);
+        }
+    } else if (file) {
         if (leaf) {
             result = readFile(fileInput, LEAF, outputMode, firstLineIsShebang);
         } else if (sourceCharacters) {
             result = readFile(fileInput, SOURCECHARACTERS, outputMode, firstLineIsShebang);
         } else if (tokenize) {
-            result = readFile(fileInput, TOKENIZE, outputMode, firstLineIsShebang);
+            result = readFile(fileInput, tokenizeMode, outputMode, firstLineIsShebang);
+        } else if (stream) {
+            result = readFile(fileInput, STREAM, outputMode, firstLineIsShebang);
         } else {
-            result = readFile(fileInput, EXPRESSION, outputMode, firstLineIsShebang);
+            result = readFile(fileInput, expressionMode, outputMode, firstLineIsShebang);
         }
     } else {
         if (leaf) {
@@ -127,9 +256,11 @@ int main(int argc, char *argv[]) {
         } else if (sourceCharacters) {
             result = readStdIn(SOURCECHARACTERS, outputMode, firstLineIsShebang);
         } else if (tokenize) {
-            result = readStdIn(TOKENIZE, outputMode, firstLineIsShebang);
+            result = readStdIn(tokenizeMode, outputMode, firstLineIsShebang);
+        } else if (stream) {
+            result = readStdIn(STREAM, outputMode, firstLineIsShebang);
         } else {
-            result = readStdIn(EXPRESSION, outputMode, firstLineIsShebang);
+            result = readStdIn(expressionMode, outputMode, firstLineIsShebang);
         }
     }
     
@@ -142,7 +273,9 @@ int readStdIn(APIMode mode, OutputMode outputMode, bool firstLineIsShebang) {
     std::cout << ">>> ";
     std::getline(std::cin, input);
     
-    TheParserSession = ParserSessionPtr(new ParserSession());
+    ParserSession session;
+    
+    CSTWriter writer(&session);
     
     WolframLibraryData libData = nullptr;
     
@@ -154,35 +287,53 @@ int readStdIn(APIMode mode, OutputMode outputMode, bool firstLineIsShebang) {
         
         auto inputBufAndLen = BufferAndLength(inputStr, input.size());
         
-        TheParserSession->init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        session.init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
     
-        auto N = TheParserSession->tokenize();
+        auto N = session.tokenize();
         
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
-            }
-                break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
+        outputNode(session, writer, N, mode, outputMode);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+    } else if (mode == TOKENARRAYS) {
+        
+        auto inputStr = reinterpret_cast<Buffer>(input.c_str());
+        
+        auto inputBufAndLen = BufferAndLength(inputStr, input.size());
+        
+        session.init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        
+        TokenArrays A;
+        
+        session.tokenizeArrays(A);
+        
+        outputTokenArrays(A, outputMode);
+        
+        session.deinit();
+        
+    } else if (mode == STREAM) {
+        
+        auto inputStr = reinterpret_cast<Buffer>(input.c_str());
+        
+        auto inputBufAndLen = BufferAndLength(inputStr, input.size());
+        
+        session.init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        
+        //
+        // Each top-level expression is printed and released before the next one is parsed
+        //
+        while (auto N = session.nextTopLevelExpression()) {
+            
+            if (!outputNode(session, writer, N, mode, outputMode)) {
+                result = EXIT_FAILURE;
             }
-                break;
-            case NONE: case CHECK:
-                break;
+            
+            session.releaseAllNodes();
         }
         
-        TheParserSession->releaseNode(N);
-        
-        TheParserSession->deinit();
+        session.deinit();
         
     } else if (mode == SOURCECHARACTERS) {
         
@@ -190,37 +341,17 @@ int readStdIn(APIMode mode, OutputMode outputMode, bool firstLineIsShebang) {
         
         auto inputBufAndLen = BufferAndLength(inputStr, input.size());
         
-        TheByteBuffer->init(inputBufAndLen, libData);
-        TheByteDecoder->init(SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+        session.byteBuffer->init(inputBufAndLen, libData);
+        session.byteDecoder->init(SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
     
-        auto N = TheParserSession->listSourceCharacters();
+        auto N = session.listSourceCharacters();
     
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
-            }
-                break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
-            }
-                break;
-            case NONE: case CHECK:
-                break;
-        }
+        outputNode(session, writer, N, mode, outputMode);
         
-        TheParserSession->releaseNode(N);
+        session.releaseAllNodes();
         
-        TheByteDecoder->deinit();
-        TheByteBuffer->deinit();
+        session.byteDecoder->deinit();
+        session.byteBuffer->deinit();
         
     } else if (mode == LEAF) {
         
@@ -228,37 +359,17 @@ int readStdIn(APIMode mode, OutputMode outputMode, bool firstLineIsShebang) {
         
         auto inputBufAndLen = BufferAndLength(inputStr, input.size());
         
-        TheParserSession->init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        session.init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
         
         auto stringifyMode = STRINGIFYMODE_NORMAL;
         
-        auto N = TheParserSession->concreteParseLeaf(stringifyMode);
+        auto N = session.concreteParseLeaf(stringifyMode);
     
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
-            }
-                break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
-            }
-                break;
-            case NONE: case CHECK:
-                break;
-        }
+        outputNode(session, writer, N, mode, outputMode);
         
-        TheParserSession->releaseNode(N);
+        session.releaseAllNodes();
         
-        TheParserSession->deinit();
+        session.deinit();
         
     } else {
         
@@ -266,41 +377,17 @@ int readStdIn(APIMode mode, OutputMode outputMode, bool firstLineIsShebang) {
         
         auto inputBufAndLen = BufferAndLength(inputStr, input.size());
         
-        TheParserSession->init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        session.init(inputBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
         
-        auto N = TheParserSession->parseExpressions();
+        auto N = (mode == ABSTRACT) ? session.abstractParseExpressions() : session.parseExpressions();
         
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
-            }
-                break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
-            }
-                break;
-            case CHECK: {
-                if (!N->check()) {
-                    result = EXIT_FAILURE;
-                }
-            }
-                break;
-            case NONE:
-                break;
+        if (!outputNode(session, writer, N, mode, outputMode)) {
+            result = EXIT_FAILURE;
         }
         
-        TheParserSession->releaseNode(N);
+        session.releaseAllNodes();
         
-        TheParserSession->deinit();
+        session.deinit();
     }
     
     return result;
@@ -321,7 +408,7 @@ int readFile(std::string file, APIMode mode, OutputMode outputMode, bool firstLi
 #endif // USE_MATHLINK
             }
                 break;
-            case PRINT_DRYRUN:
+            case PRINT_DRYRUN: case BINARY:
                 break;
             case NONE: case CHECK:
                 break;
@@ -329,7 +416,9 @@ int readFile(std::string file, APIMode mode, OutputMode outputMode, bool firstLi
         return EXIT_FAILURE;
     }
     
-    TheParserSession = ParserSessionPtr(new ParserSession());
+    ParserSession session;
+    
+    CSTWriter writer(&session);
     
     WolframLibraryData libData = nullptr;
     
@@ -339,122 +428,442 @@ int readFile(std::string file, APIMode mode, OutputMode outputMode, bool firstLi
         
         auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
         
-        TheParserSession->init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        session.init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
         
-        auto N = TheParserSession->tokenize();
+        auto N = session.tokenize();
         
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
-            }
-                break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
+        outputNode(session, writer, N, mode, outputMode);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+    } else if (mode == TOKENARRAYS) {
+        
+        auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
+        
+        session.init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        
+        TokenArrays A;
+        
+        session.tokenizeArrays(A);
+        
+        outputTokenArrays(A, outputMode);
+        
+        session.deinit();
+        
+    } else if (mode == STREAM) {
+        
+        auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
+        
+        session.init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        
+        //
+        // Each top-level expression is printed and released before the next one is parsed
+        //
+        while (auto N = session.nextTopLevelExpression()) {
+            
+            if (!outputNode(session, writer, N, mode, outputMode)) {
+                result = EXIT_FAILURE;
             }
-                break;
-            case NONE: case CHECK:
-                break;
+            
+            session.releaseAllNodes();
         }
         
-        TheParserSession->releaseNode(N);
-        
-        TheParserSession->deinit();
+        session.deinit();
         
     } else if (mode == LEAF) {
         
         auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
         
-        TheParserSession->init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        session.init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
         
         auto stringifyMode = STRINGIFYMODE_NORMAL;
         
-        auto N = TheParserSession->concreteParseLeaf(stringifyMode);
+        auto N = session.concreteParseLeaf(stringifyMode);
     
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
+        outputNode(session, writer, N, mode, outputMode);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+    } else {
+        
+        auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
+        
+        auto policy = (mode == ABSTRACT) ? (INCLUDE_SOURCE | REPORT_TOPLEVEL_ISSUES) : INCLUDE_SOURCE;
+        
+        session.init(fBufAndLen, libData, policy, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        
+        auto N = (mode == ABSTRACT) ? session.abstractParseExpressions() : session.parseExpressions();
+        
+        if (!outputNode(session, writer, N, mode, outputMode)) {
+            result = EXIT_FAILURE;
+        }
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+    }
+    
+    return result;
+}
+
+//
+// Parse many files with a single session
+//
+// Nodes are printed or put as they would be by readFile, and a summary of throughput is written to stderr at the end
+//
+int readFiles(const std::vector<std::string>& files, APIMode mode, OutputMode outputMode, bool firstLineIsShebang) {
+    
+    ParserSession session;
+    
+    CSTWriter writer(&session);
+    
+    WolframLibraryData libData = nullptr;
+    
+    int result = EXIT_SUCCESS;
+    
+    //
+    // Kept between files, so that the arrays only grow for the largest file
+    //
+    TokenArrays A;
+    
+    size_t fileCount = 0;
+    size_t byteCount = 0;
+    
+    auto start = std::chrono::steady_clock::now();
+    
+    for (auto& file : files) {
+        
+        auto fb = ScopedFileBufferPtr(new ScopedFileBuffer(reinterpret_cast<Buffer>(file.c_str()), file.size()));
+        
+        if (fb->fail()) {
+            
+            if (outputMode == PRINT) {
+                std::cout << "file open failed: " << file << "\n";
             }
+            
+            result = EXIT_FAILURE;
+            
+            continue;
+        }
+        
+        fileCount++;
+        byteCount += fb->getLen();
+        
+        auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
+        
+        auto policy = (mode == ABSTRACT) ? (INCLUDE_SOURCE | REPORT_TOPLEVEL_ISSUES) : INCLUDE_SOURCE;
+        
+        session.init(fBufAndLen, libData, policy, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+        
+        if (mode == TOKENARRAYS) {
+            
+            session.tokenizeArrays(A);
+            
+            outputTokenArrays(A, outputMode);
+            
+            session.deinit();
+            
+            continue;
+        }
+        
+        while (true) {
+            
+            Node *N;
+            
+            if (mode == TOKENIZE) {
+                N = session.tokenize();
+            } else if (mode == STREAM) {
+                N = session.nextTopLevelExpression();
+            } else if (mode == ABSTRACT) {
+                N = session.abstractParseExpressions();
+            } else {
+                N = session.parseExpressions();
+            }
+            
+            if (!N) {
                 break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
             }
+            
+            if (!outputNode(session, writer, N, mode, outputMode)) {
+                
+                std::cout << file << "\n";
+                
+                result = EXIT_FAILURE;
+            }
+            
+            session.releaseAllNodes();
+            
+            if (mode != STREAM) {
                 break;
-            case NONE: case CHECK:
+            }
+        }
+        
+        session.deinit();
+    }
+    
+    auto secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    
+    std::cerr << fileCount << " files, " << byteCount << " bytes in " << secs << "s: " << (fileCount / secs) << " files/s, " << (byteCount / secs) << " bytes/s\n";
+    
+    return result;
+}
+
+//
+// Print, put, or write N as outputMode asks
+//
+// Only parsed expressions are checked, and false is returned if the check fails
+//
+bool outputNode(ParserSession& session, CSTWriter& writer, Node *N, APIMode mode, OutputMode outputMode) {
+    
+    switch (outputMode) {
+        case PRINT:
+            N->print(&session, std::cout);
+            std::cout << "\n";
+            break;
+        case PUT: {
+#if USE_MATHLINK
+            ScopedMLLoopbackLink loop;
+            N->put(&session, loop.get());
+#endif // USE_MATHLINK
+        }
+            break;
+        case PRINT_DRYRUN: {
+            std::ofstream nullStream;
+            N->print(&session, nullStream);
+            nullStream << "\n";
+        }
+            break;
+        case BINARY:
+            writer.write(N, std::cout);
+            break;
+        case CHECK: {
+            
+            if (mode != EXPRESSION && mode != ABSTRACT && mode != STREAM) {
                 break;
+            }
+            
+            if (!N->check()) {
+                return false;
+            }
         }
+            break;
+        case NONE:
+            break;
+    }
+    
+    return true;
+}
+
+void outputTokenArrays(const TokenArrays& A, OutputMode outputMode) {
+    
+    switch (outputMode) {
+        case PRINT: case BINARY:
+            A.write(std::cout, SOURCECONVENTION_LINECOLUMN);
+            break;
+        case PRINT_DRYRUN: {
+            std::ofstream nullStream;
+            A.write(nullStream, SOURCECONVENTION_LINECOLUMN);
+        }
+            break;
+        case PUT: case NONE: case CHECK:
+            break;
+    }
+}
+
+//
+// Read the paths in listFile, one on each line
+//
+bool readFileList(std::string listFile, std::vector<std::string>& files) {
+    
+    std::ifstream in(listFile);
+    
+    if (!in) {
+        return false;
+    }
+    
+    std::string line;
+    
+    while (std::getline(in, line)) {
         
-        TheParserSession->releaseNode(N);
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
         
-        TheParserSession->deinit();
+        if (line.empty()) {
+            continue;
+        }
         
-    } else {
+        files.push_back(line);
+    }
+    
+    return true;
+}
+
+static bool isSourceFile(const std::string& name) {
+    
+    auto endsWith = [&name](const std::string& ext) {
+        return name.size() > ext.size() && name.compare(name.size() - ext.size(), ext.size(), ext) == 0;
+    };
+    
+    return endsWith(".wl") || endsWith(".m");
+}
+
+//
+// Find every .wl and .m file under dir, in sorted order so that output is the same on every run
+//
+bool readDirectory(std::string dir, std::vector<std::string>& files) {
+    
+    std::vector<std::string> found;
+    
+    std::vector<std::string> pending;
+    pending.push_back(dir);
+    
+    while (!pending.empty()) {
         
-        auto fBufAndLen = BufferAndLength(fb->getBuf(), fb->getLen());
+        auto d = pending.back();
+        pending.pop_back();
         
-        TheParserSession->init(fBufAndLen, libData, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, firstLineIsShebang);
+#ifndef _WIN32
         
-        auto N = TheParserSession->parseExpressions();
+        auto D = opendir(d.c_str());
         
-        switch (outputMode) {
-            case PRINT:
-                N->print(std::cout);
-                std::cout << "\n";
-                break;
-            case PUT: {
-#if USE_MATHLINK
-                ScopedMLLoopbackLink loop;
-                N->put(loop.get());
-#endif // USE_MATHLINK
+        if (!D) {
+            
+            if (d == dir) {
+                return false;
             }
-                break;
-            case PRINT_DRYRUN: {
-                std::ofstream nullStream;
-                N->print(nullStream);
-                nullStream << "\n";
+            
+            continue;
+        }
+        
+        while (auto E = readdir(D)) {
+            
+            auto name = std::string(E->d_name);
+            
+            if (name == "." || name == "..") {
+                continue;
             }
-                break;
-            case NONE:
-                break;
-            case CHECK: {
-                if (!N->check()) {
-                    result = EXIT_FAILURE;
-                }
+            
+            auto path = d + "/" + name;
+            
+            struct stat st;
+            
+            if (stat(path.c_str(), &st) == -1) {
+                continue;
+            }
+            
+            if (S_ISDIR(st.st_mode)) {
+                pending.push_back(path);
+            } else if (S_ISREG(st.st_mode) && isSourceFile(name)) {
+                found.push_back(path);
             }
-                break;
         }
         
-        TheParserSession->releaseNode(N);
+        closedir(D);
+        
+#else
+        
+        WIN32_FIND_DATAA data;
+        
+        auto H = FindFirstFileA((d + "\\*").c_str(), &data);
+        
+        if (H == INVALID_HANDLE_VALUE) {
+            
+            if (d == dir) {
+                return false;
+            }
+            
+            continue;
+        }
+        
+        do {
+            
+            auto name = std::string(data.cFileName);
+            
+            if (name == "." || name == "..") {
+                continue;
+            }
+            
+            auto path = d + "\\" + name;
+            
+            if (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                pending.push_back(path);
+            } else if (isSourceFile(name)) {
+                found.push_back(path);
+            }
+            
+        } while (FindNextFileA(H, &data));
+        
+        FindClose(H);
         
-        TheParserSession->deinit();
+#endif // _WIN32
     }
     
-    TheParserSession.reset(nullptr);
+    std::sort(found.begin(), found.end());
     
-    return result;
+    files.insert(files.end(), found.begin(), found.end());
+    
+    return true;
 }
 
-ScopedFileBuffer::ScopedFileBuffer(Buffer inStrIn, size_t inLen) : buf(), len(), inited(false) {
+ScopedFileBuffer::ScopedFileBuffer(Buffer inStrIn, size_t inLen) : buf(), len(), inited(false), mapped(false) {
     
     auto inStr = reinterpret_cast<const char *>(inStrIn);
     
+#ifndef _WIN32
+    
+    int fd = open(inStr, O_RDONLY);
+    
+    if (fd == -1) {
+        return;
+    }
+    
+    struct stat st;
+    
+    if (fstat(fd, &st) == -1 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return;
+    }
+    
+    len = st.st_size;
+    
+    if (len == 0) {
+        
+        //
+        // Cannot map an empty file
+        //
+        
+        close(fd);
+        
+        inited = true;
+        
+        return;
+    }
+    
+    auto m = mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    
+    //
+    // The mapping stays valid after the descriptor is closed
+    //
+    close(fd);
+    
+    if (m == MAP_FAILED) {
+        return;
+    }
+    
+    madvise(m, len, MADV_SEQUENTIAL);
+    
+    buf = static_cast<MBuffer>(m);
+    
+    inited = true;
+    mapped = true;
+    
+#else
+    
     FILE * file = fopen(inStr, "rb");
     
     if (file == NULL) {
@@ -462,11 +871,13 @@ ScopedFileBuffer::ScopedFileBuffer(Buffer inStrIn, size_t inLen) : buf(), len(),
     }
     
     if (fseek(file, 0, SEEK_END)) {
+        fclose(file);
         return;
     }
     
     auto res = ftell(file);
     if (res < 0) {
+        fclose(file);
         return;
     }
     len = res;
@@ -484,6 +895,8 @@ ScopedFileBuffer::ScopedFileBuffer(Buffer inStrIn, size_t inLen) : buf(), len(),
     }
     
     fclose(file);
+    
+#endif // _WIN32
 }
 
 ScopedFileBuffer::~ScopedFileBuffer() {
@@ -491,8 +904,14 @@ ScopedFileBuffer::~ScopedFileBuffer() {
     if (!inited) {
         return;
     }
-
+    
+#ifndef _WIN32
+    if (mapped) {
+        munmap(buf, len);
+    }
+#else
     delete[] buf;
+#endif // _WIN32
 }
 
 Buffer ScopedFileBuffer::getBuf() const {
@@ -10,6 +10,10 @@
 #include "ByteBuffer.h" // for ByteBuffer
 #include "ByteEncoder.h" // for ByteEncoder
 #include "Utils.h" // for undocumentedLongNames
+#include "LongNames.h" // for LongNames::findLongName
+#include "Abstract.h" // for abstractExpressions
+
+#include "WolframIOLibraryFunctions.h" // for DataStore
 
 #include <memory> // for unique_ptr
 #ifdef WINDOWS_MATHLINK
@@ -18,30 +22,127 @@
 #endif // WINDOWS_MATHLINK
 #include <vector>
 #include <set>
+#include <thread> // for thread
+#include <mutex> // for mutex
+#include <condition_variable> // for condition_variable
+#include <chrono> // for milliseconds
+#include <algorithm> // for min, max, stable_sort, unique, stable_partition, partition_point
+#include <iterator> // for make_move_iterator
+#include <cstring> // for strlen, memcpy
+#include <cctype> // for isalnum
 
 bool validatePath(WolframLibraryData libData, const unsigned char *inStr, size_t len);
 
+#if !NISSUES
+//
+// Stable, so that the first of several duplicate issues is the one that is kept
+//
+static void sortAndDedupe(IssueVector& issues) {
+    
+    auto cmp = IssueCompare();
+    
+    std::stable_sort(issues.begin(), issues.end(), cmp);
+    
+    issues.erase(std::unique(issues.begin(), issues.end(), [&cmp](const Issue& a, const Issue& b) { return !cmp(a, b) && !cmp(b, a); }), issues.end());
+}
+#endif // !NISSUES
+
+static void sortAndDedupe(SourceLocationVector& locs) {
+    
+    std::sort(locs.begin(), locs.end());
+    
+    locs.erase(std::unique(locs.begin(), locs.end()), locs.end());
+}
+
+#if !NISSUES
+//
+// Move the issues that start before loc into to, and keep the others in from
+//
+static void takeBefore(IssueVector& from, IssueVector& to, SourceLocation loc) {
+    
+    auto it = std::stable_partition(from.begin(), from.end(), [loc](const Issue& I) { return I.getSource().Start < loc; });
+    
+    to.insert(to.end(), from.begin(), it);
+    
+    from.erase(from.begin(), it);
+}
+#endif // !NISSUES
+
+static void takeBefore(SourceLocationVector& from, SourceLocationVector& to, SourceLocation loc) {
+    
+    auto it = std::stable_partition(from.begin(), from.end(), [loc](SourceLocation L) { return L < loc; });
+    
+    to.insert(to.end(), from.begin(), it);
+    
+    from.erase(from.begin(), it);
+}
+
+
+TopLevelExpression::TopLevelExpression() : Expr(), Tok(), Buf(), Src(), Furthest(), Issues(), SimpleLineContinuations(), ComplexLineContinuations(), EmbeddedNewlines(), EmbeddedTabs(), Pending() {}
+
+void TopLevelExpression::shift(const SourceShift& S) {
+    
+    S.apply(Buf);
+    S.apply(Src);
+    
+    Furthest += S.bytes;
+    
+    Pending.bytes += S.bytes;
+    Pending.first += S.first;
+    Pending.second += S.second;
+}
+
+void TopLevelExpression::applyPending() {
+    
+    if (Pending.bytes == 0 && Pending.first == 0 && Pending.second == 0) {
+        return;
+    }
+    
+    Expr->shift(Pending);
+    
+    for (auto& I : Issues) {
+        Pending.apply(I);
+    }
+    
+    Pending.apply(SimpleLineContinuations);
+    Pending.apply(ComplexLineContinuations);
+    Pending.apply(EmbeddedNewlines);
+    Pending.apply(EmbeddedTabs);
+    
+    Pending = SourceShift();
+}
+
 
 ParserSession::ParserSession() : bufAndLen(),
 #if !NABORT
+abortFlag(false),
+abortBudget(1),
+#endif // !NABORT
+byteBuffer(new ByteBuffer(this)),
+byteDecoder(new ByteDecoder(this)),
+characterDecoder(new CharacterDecoder(this)),
+tokenizer(new Tokenizer(this)),
+parser(new Parser(this)),
+arena(new Arena()),
+#if !NABORT
 currentAbortQ(),
 #endif // !NABORT
-policy() {
-    
-    TheByteBuffer = ByteBufferPtr(new ByteBuffer());
-    TheByteDecoder = ByteDecoderPtr(new ByteDecoder());
-    TheCharacterDecoder = CharacterDecoderPtr(new CharacterDecoder());
-    TheTokenizer = TokenizerPtr(new Tokenizer());
-    TheParser = ParserPtr(new Parser());
-}
+policy() {}
 
 ParserSession::~ParserSession() {
 
-    TheParser.reset(nullptr);
-    TheTokenizer.reset(nullptr);
-    TheCharacterDecoder.reset(nullptr);
-    TheByteDecoder.reset(nullptr);
-    TheByteBuffer.reset(nullptr);
+    arena.reset(nullptr);
+    parser.reset(nullptr);
+    tokenizer.reset(nullptr);
+    characterDecoder.reset(nullptr);
+    byteDecoder.reset(nullptr);
+    byteBuffer.reset(nullptr);
+    
+#if USE_EXPR_LIB
+    for (auto& P : SymbolExprs) {
+        Expr_Release(P.second);
+    }
+#endif // USE_EXPR_LIB
 }
 
 void ParserSession::init(BufferAndLength bufAndLenIn, WolframLibraryData libData, ParserSessionPolicy policyIn, SourceConvention srcConvention, uint32_t tabWidth, bool firstLineIsShebang) {
@@ -54,11 +155,19 @@ void ParserSession::init(BufferAndLength bufAndLenIn, WolframLibraryData libData
         return;
     }
     
-    TheByteBuffer->init(bufAndLen, libData);
-    TheByteDecoder->init(srcConvention, tabWidth);
-    TheCharacterDecoder->init(libData);
-    TheTokenizer->init();
-    TheParser->init(firstLineIsShebang);
+#if !NABORT
+    //
+    // The first check asks currentAbortQ
+    //
+    abortFlag = false;
+    abortBudget = 1;
+#endif // !NABORT
+    
+    byteBuffer->init(bufAndLen, libData);
+    byteDecoder->init(srcConvention, tabWidth);
+    characterDecoder->init(libData);
+    tokenizer->init();
+    parser->init(firstLineIsShebang);
     
     if (libData) {
         
@@ -81,11 +190,15 @@ void ParserSession::init(BufferAndLength bufAndLenIn, WolframLibraryData libData
 
 void ParserSession::deinit() {
     
-    TheParser->deinit();
-    TheTokenizer->deinit();
-    TheCharacterDecoder->deinit();
-    TheByteDecoder->deinit();
-    TheByteBuffer->deinit();
+    parser->deinit();
+    tokenizer->deinit();
+    characterDecoder->deinit();
+    byteDecoder->deinit();
+    byteBuffer->deinit();
+}
+
+BufferAndLength ParserSession::getInput() const {
+    return bufAndLen;
 }
 
 Node *ParserSession::parseExpressions() {
@@ -103,13 +216,13 @@ Node *ParserSession::parseExpressions() {
         while (true) {
             
 #if !NABORT
-            if (TheParserSession->isAbort()) {
+            if (isAbort()) {
                 
                 break;
             }
 #endif // !NABORT
             
-            auto peek = TheParser->currentToken(Ctxt, TOPLEVEL);
+            auto peek = parser->currentToken(Ctxt, TOPLEVEL);
             
             if (peek.Tok == TOKEN_ENDOFFILE) {
                 break;
@@ -117,9 +230,9 @@ Node *ParserSession::parseExpressions() {
             
             if (peek.Tok.isTrivia()) {
                 
-                exprs.push_back(LeafNodePtr(new LeafNode(std::move(peek))));
+                exprs.push_back(LeafNodePtr(arena->make<LeafNode>(std::move(peek))));
                 
-                TheParser->nextToken(peek);
+                parser->nextToken(peek);
                 
                 continue;
             }
@@ -130,17 +243,17 @@ Node *ParserSession::parseExpressions() {
             //
             if (peek.Tok.isCloser()) {
                 
-                Expr = contextSensitivePrefixToplevelCloserParselet->parse(peek, Ctxt);
+                Expr = parser->parse(contextSensitivePrefixToplevelCloserParselet, peek, Ctxt);
                 
             } else {
-                Expr = prefixParselets[peek.Tok.value()]->parse(peek, Ctxt);
+                Expr = parser->parse(prefixParselets[peek.Tok.value()], peek, Ctxt);
             }
             
             exprs.push_back(std::move(Expr));
             
         } // while (true)
         
-        NodePtr Collected = NodePtr(new CollectedExpressionsNode(std::move(exprs)));
+        NodePtr Collected = NodePtr(arena->makeOwned<CollectedExpressionsNode>(std::move(exprs)));
         
         nodes.push_back(std::move(Collected));
     }
@@ -153,72 +266,213 @@ Node *ParserSession::parseExpressions() {
     // Collect all issues from the various components
     //
     {
-        IssuePtrSet issues;
+        IssueVector issues;
         
 #if !NISSUES
-        auto& ParserIssues = TheParser->getIssues();
+        auto& ParserIssues = parser->getIssues();
         for (auto& I : ParserIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
         
-        auto& TokenizerIssues = TheTokenizer->getIssues();
+        auto& TokenizerIssues = tokenizer->getIssues();
         for (auto& I : TokenizerIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
         
-        auto& CharacterDecoderIssues = TheCharacterDecoder->getIssues();
+        auto& CharacterDecoderIssues = characterDecoder->getIssues();
         for (auto& I : CharacterDecoderIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
         
-        auto& ByteDecoderIssues = TheByteDecoder->getIssues();
+        auto& ByteDecoderIssues = byteDecoder->getIssues();
         for (auto& I : ByteDecoderIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
+        
+        sortAndDedupe(issues);
 #endif // !NISSUES
         
-        nodes.push_back(NodePtr(new CollectedIssuesNode(std::move(issues))));
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedIssuesNode>(std::move(issues))));
     }
     
     {
-        auto& SimpleLineContinuations = TheCharacterDecoder->getSimpleLineContinuations();
-
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(SimpleLineContinuations))));
+        auto& SimpleLineContinuations = characterDecoder->getSimpleLineContinuations();
+        
+        sortAndDedupe(SimpleLineContinuations);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(SimpleLineContinuations))));
     }
     
     {
-        auto& ComplexLineContinuations = TheCharacterDecoder->getComplexLineContinuations();
+        auto& ComplexLineContinuations = characterDecoder->getComplexLineContinuations();
         
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(ComplexLineContinuations))));
+        sortAndDedupe(ComplexLineContinuations);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(ComplexLineContinuations))));
     }
     
     {
-        auto& EmbeddedNewlines = TheTokenizer->getEmbeddedNewlines();
-
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(EmbeddedNewlines))));
+        auto& EmbeddedNewlines = tokenizer->getEmbeddedNewlines();
+        
+        sortAndDedupe(EmbeddedNewlines);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(EmbeddedNewlines))));
     }
     
     {
-        std::set<SourceLocation> tabs;
+        SourceLocationVector tabs;
         
-        auto& TokenizerEmbeddedTabs = TheTokenizer->getEmbeddedTabs();
+        auto& TokenizerEmbeddedTabs = tokenizer->getEmbeddedTabs();
         for (auto& T : TokenizerEmbeddedTabs) {
-            tabs.insert(T);
+            tabs.push_back(T);
         }
         
-        auto& CharacterDecoderEmbeddedTabs = TheCharacterDecoder->getEmbeddedTabs();
+        auto& CharacterDecoderEmbeddedTabs = characterDecoder->getEmbeddedTabs();
         for (auto& T : CharacterDecoderEmbeddedTabs) {
-            tabs.insert(T);
+            tabs.push_back(T);
         }
         
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(tabs))));
+        sortAndDedupe(tabs);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(tabs))));
+    }
+    
+    auto N = arena->makeOwned<ListNode>(std::move(nodes));
+    
+    return N;
+}
+
+Node *ParserSession::nextTopLevelExpression() {
+    
+    TopLevelExpression T;
+    
+    if (!nextTopLevelExpression(T)) {
+        return nullptr;
+    }
+    
+    std::vector<NodePtr> nodes;
+    
+    {
+        std::vector<NodePtr> exprs;
+        
+        exprs.push_back(NodePtr(T.Expr));
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedExpressionsNode>(std::move(exprs))));
     }
     
-    auto N = new ListNode(std::move(nodes));
+    nodes.push_back(NodePtr(arena->makeOwned<CollectedIssuesNode>(std::move(T.Issues))));
+    nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(T.SimpleLineContinuations))));
+    nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(T.ComplexLineContinuations))));
+    nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(T.EmbeddedNewlines))));
+    nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(T.EmbeddedTabs))));
+    
+    auto N = arena->makeOwned<ListNode>(std::move(nodes));
     
     return N;
 }
 
+bool ParserSession::nextTopLevelExpression(TopLevelExpression& T) {
+    
+#if !NABORT
+    if (isAbort()) {
+        return false;
+    }
+#endif // !NABORT
+    
+    ParserContext Ctxt;
+    
+    auto peek = parser->currentToken(Ctxt, TOPLEVEL);
+    
+    if (peek.Tok == TOKEN_ENDOFFILE) {
+        return false;
+    }
+    
+    auto startBuf = byteBuffer->buffer;
+    auto startLoc = byteDecoder->SrcLoc;
+    
+    T.Tok = peek.Tok;
+    
+    if (peek.Tok.isTrivia()) {
+        
+        T.Expr = arena->make<LeafNode>(std::move(peek));
+        
+        parser->nextToken(peek);
+        
+    } else if (peek.Tok.isCloser()) {
+        
+        T.Expr = parser->parse(contextSensitivePrefixToplevelCloserParselet, peek, Ctxt).release();
+        
+    } else {
+        
+        T.Expr = parser->parse(prefixParselets[peek.Tok.value()], peek, Ctxt).release();
+    }
+    
+    //
+    // Everything before here belongs to this expression
+    //
+    // Anything after here was found by peeking ahead, and is kept for the expression that it belongs to
+    //
+    auto end = byteDecoder->SrcLoc;
+    
+    T.Buf = BufferAndLength(startBuf, byteBuffer->buffer - startBuf);
+    T.Src = Source(startLoc, end);
+    T.Furthest = byteDecoder->furthest;
+    T.Pending = SourceShift();
+    
+    T.Issues.clear();
+    
+#if !NISSUES
+    //
+    // The parser only adds issues for what it has consumed
+    //
+    auto& ParserIssues = parser->getIssues();
+    for (auto& I : ParserIssues) {
+        T.Issues.push_back(I);
+    }
+    ParserIssues.clear();
+    
+    takeBefore(tokenizer->getIssues(), T.Issues, end);
+    takeBefore(characterDecoder->getIssues(), T.Issues, end);
+    takeBefore(byteDecoder->getIssues(), T.Issues, end);
+    
+    sortAndDedupe(T.Issues);
+#endif // !NISSUES
+    
+    T.SimpleLineContinuations.clear();
+    
+    takeBefore(characterDecoder->getSimpleLineContinuations(), T.SimpleLineContinuations, end);
+    
+    sortAndDedupe(T.SimpleLineContinuations);
+    
+    T.ComplexLineContinuations.clear();
+    
+    takeBefore(characterDecoder->getComplexLineContinuations(), T.ComplexLineContinuations, end);
+    
+    sortAndDedupe(T.ComplexLineContinuations);
+    
+    T.EmbeddedNewlines.clear();
+    
+    takeBefore(tokenizer->getEmbeddedNewlines(), T.EmbeddedNewlines, end);
+    
+    sortAndDedupe(T.EmbeddedNewlines);
+    
+    T.EmbeddedTabs.clear();
+    
+    takeBefore(tokenizer->getEmbeddedTabs(), T.EmbeddedTabs, end);
+    takeBefore(characterDecoder->getEmbeddedTabs(), T.EmbeddedTabs, end);
+    
+    sortAndDedupe(T.EmbeddedTabs);
+    
+    return true;
+}
+
+void ParserSession::seek(Buffer buf, SourceLocation loc) {
+    
+    byteBuffer->buffer = buf;
+    byteDecoder->SrcLoc = loc;
+    byteDecoder->furthest = buf;
+}
+
 Node *ParserSession::tokenize() {
     
     std::vector<NodePtr> nodes;
@@ -229,7 +483,7 @@ Node *ParserSession::tokenize() {
         // No need to check isAbort() inside tokenizer loops
         //
         
-        auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+        auto Tok = tokenizer->currentToken(TOPLEVEL);
         
         if (Tok.Tok == TOKEN_ENDOFFILE) {
             break;
@@ -237,22 +491,83 @@ Node *ParserSession::tokenize() {
         
         NodePtr N;
         if (Tok.Tok.isError()) {
-            N = NodePtr(new ErrorNode(Tok));
+            N = NodePtr(arena->make<ErrorNode>(Tok));
         } else {
-            N = NodePtr(new LeafNode(Tok));
+            N = NodePtr(arena->make<LeafNode>(Tok));
         }
         
         nodes.push_back(std::move(N));
         
-        TheTokenizer->nextToken(Tok);
+        tokenizer->nextToken(Tok);
         
     } // while (true)
     
-    auto N = new ListNode(std::move(nodes));
+    auto N = arena->makeOwned<ListNode>(std::move(nodes));
     
     return N;
 }
 
+void ParserSession::tokenizeArrays(TokenArrays& A) {
+    
+    A.clear();
+    
+    //
+    // Tokens are usually several bytes, so the arrays seldom grow after this
+    //
+    A.reserve(bufAndLen.length() / 4);
+    
+    while (true) {
+        
+        //
+        // No need to check isAbort() inside tokenizer loops
+        //
+        
+        auto Tok = tokenizer->currentToken(TOPLEVEL);
+        
+        if (Tok.Tok == TOKEN_ENDOFFILE) {
+            break;
+        }
+        
+        A.Toks.push_back(Tok.Tok.value());
+        A.Starts.push_back(static_cast<uint32_t>(Tok.BufLen.buffer - bufAndLen.buffer));
+        A.Ends.push_back(static_cast<uint32_t>(Tok.BufLen.end - bufAndLen.buffer));
+        A.Srcs.push_back(Tok.Src);
+        
+        tokenizer->nextToken(Tok);
+        
+    } // while (true)
+}
+
+size_t ParserSession::tokenizeArrays(uint16_t *Toks, uint32_t *Starts, uint32_t *Ends, Source *Srcs, size_t capacity) {
+    
+    size_t n = 0;
+    
+    while (n < capacity) {
+        
+        //
+        // No need to check isAbort() inside tokenizer loops
+        //
+        
+        auto Tok = tokenizer->currentToken(TOPLEVEL);
+        
+        if (Tok.Tok == TOKEN_ENDOFFILE) {
+            break;
+        }
+        
+        Toks[n] = Tok.Tok.value();
+        Starts[n] = static_cast<uint32_t>(Tok.BufLen.buffer - bufAndLen.buffer);
+        Ends[n] = static_cast<uint32_t>(Tok.BufLen.end - bufAndLen.buffer);
+        Srcs[n] = Tok.Src;
+        
+        n++;
+        
+        tokenizer->nextToken(Tok);
+        
+    } // while (n < capacity)
+    
+    return n;
+}
+
 Node *ParserSession::listSourceCharacters() {
     
     std::vector<NodePtr> nodes;
@@ -263,19 +578,19 @@ Node *ParserSession::listSourceCharacters() {
         // No need to check isAbort() inside tokenizer loops
         //
         
-        auto Char = TheByteDecoder->nextSourceCharacter0(TOPLEVEL);
+        auto Char = byteDecoder->nextSourceCharacter0(TOPLEVEL);
         
         if (Char.isEndOfFile()) {
             break;
         }
         
-        auto N = NodePtr(new SourceCharacterNode(Char));
+        auto N = NodePtr(arena->make<SourceCharacterNode>(Char));
         
         nodes.push_back(std::move(N));
         
     } // while (true)
     
-    auto N = new ListNode(std::move(nodes));
+    auto N = arena->makeOwned<ListNode>(std::move(nodes));
     
     return N;
 }
@@ -285,30 +600,30 @@ NodePtr ParserSession::concreteParseLeaf0(int mode) {
     
     switch (mode) {
         case STRINGIFYMODE_NORMAL: {
-            auto Tok = TheTokenizer->nextToken0(TOPLEVEL);
+            auto Tok = tokenizer->nextToken0(TOPLEVEL);
             
             if (Tok.Tok.isError()) {
-                return NodePtr(new ErrorNode(Tok));
+                return NodePtr(arena->make<ErrorNode>(Tok));
             } else {
-                return NodePtr(new LeafNode(Tok));
+                return NodePtr(arena->make<LeafNode>(Tok));
             }
         }
         case STRINGIFYMODE_SYMBOLSEGMENT: {
-            auto Tok = TheTokenizer->nextToken0_stringifyAsSymbolSegment();
+            auto Tok = tokenizer->nextToken0_stringifyAsSymbolSegment();
             
             if (Tok.Tok.isError()) {
-                return NodePtr(new ErrorNode(Tok));
+                return NodePtr(arena->make<ErrorNode>(Tok));
             } else {
-                return NodePtr(new LeafNode(Tok));
+                return NodePtr(arena->make<LeafNode>(Tok));
             }
         }
         case STRINGIFYMODE_FILE: {
-            auto Tok = TheTokenizer->nextToken0_stringifyAsFile();
+            auto Tok = tokenizer->nextToken0_stringifyAsFile();
             
             if (Tok.Tok.isError()) {
-                return NodePtr(new ErrorNode(Tok));
+                return NodePtr(arena->make<ErrorNode>(Tok));
             } else {
-                return NodePtr(new LeafNode(Tok));
+                return NodePtr(arena->make<LeafNode>(Tok));
             }
         }
         default: {
@@ -332,7 +647,7 @@ Node *ParserSession::concreteParseLeaf(StringifyMode mode) {
         
         exprs.push_back(std::move(node));
         
-        NodePtr Collected = NodePtr(new CollectedExpressionsNode(std::move(exprs)));
+        NodePtr Collected = NodePtr(arena->makeOwned<CollectedExpressionsNode>(std::move(exprs)));
         
         nodes.push_back(std::move(Collected));
     }
@@ -341,143 +656,1418 @@ Node *ParserSession::concreteParseLeaf(StringifyMode mode) {
     // Collect all issues from the various components
     //
     {
-        IssuePtrSet issues;
+        IssueVector issues;
         
 #if !NISSUES
-        auto& ParserIssues = TheParser->getIssues();
+        auto& ParserIssues = parser->getIssues();
         for (auto& I : ParserIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
         
-        auto& TokenizerIssues = TheTokenizer->getIssues();
+        auto& TokenizerIssues = tokenizer->getIssues();
         for (auto& I : TokenizerIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
         
-        auto& CharacterDecoderIssues = TheCharacterDecoder->getIssues();
+        auto& CharacterDecoderIssues = characterDecoder->getIssues();
         for (auto& I : CharacterDecoderIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
         
-        auto& ByteDecoderIssues = TheByteDecoder->getIssues();
+        auto& ByteDecoderIssues = byteDecoder->getIssues();
         for (auto& I : ByteDecoderIssues) {
-            issues.insert(std::move(I));
+            issues.push_back(std::move(I));
         }
+        
+        sortAndDedupe(issues);
 #endif // !NISSUES
         
-        nodes.push_back(NodePtr(new CollectedIssuesNode(std::move(issues))));
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedIssuesNode>(std::move(issues))));
+    }
+    
+    {
+        auto& SimpleLineContinuations = characterDecoder->getSimpleLineContinuations();
+        
+        sortAndDedupe(SimpleLineContinuations);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(SimpleLineContinuations))));
+    }
+    
+    {
+        auto& ComplexLineContinuations = characterDecoder->getComplexLineContinuations();
+        
+        sortAndDedupe(ComplexLineContinuations);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(ComplexLineContinuations))));
+    }
+    
+    {
+        auto& EmbeddedNewlines = tokenizer->getEmbeddedNewlines();
+        
+        sortAndDedupe(EmbeddedNewlines);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(EmbeddedNewlines))));
     }
     
-    {
-        auto& SimpleLineContinuations = TheCharacterDecoder->getSimpleLineContinuations();
-        
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(SimpleLineContinuations))));
-    }
+    {
+        SourceLocationVector tabs;
+        
+        auto& TokenizerEmbeddedTabs = tokenizer->getEmbeddedTabs();
+        for (auto& T : TokenizerEmbeddedTabs) {
+            tabs.push_back(T);
+        }
+        
+        auto& CharacterDecoderEmbeddedTabs = characterDecoder->getEmbeddedTabs();
+        for (auto& T : CharacterDecoderEmbeddedTabs) {
+            tabs.push_back(T);
+        }
+        
+        sortAndDedupe(tabs);
+        
+        nodes.push_back(NodePtr(arena->makeOwned<CollectedSourceLocationsNode>(std::move(tabs))));
+    }
+    
+    auto N = arena->makeOwned<ListNode>(std::move(nodes));
+    
+    return N;
+}
+
+//
+// Does the file currently have permission to be read?
+//
+bool validatePath(WolframLibraryData libData, BufferAndLength bufAndLen) {
+    
+    if (!libData) {
+        //
+        // If running as a stand-alone executable, then always valid
+        //
+        return true;
+    }
+    
+    auto inStr1 = reinterpret_cast<const char *>(bufAndLen.buffer);
+    
+    auto inStr2 = const_cast<char *>(inStr1);
+    
+    auto valid = libData->validatePath(inStr2, 'R');
+    return valid;
+}
+
+Node *ParserSession::abstractParseExpressions() {
+    
+    auto N = parseExpressions();
+    
+    return abstractExpressions(this, N);
+}
+
+void ParserSession::releaseAllNodes() {
+    
+    //
+    // Nodes do not own anything outside of the arena, except for the few that were made with makeOwned
+    //
+    arena->reset();
+}
+
+#if !NABORT
+//
+// Asking the kernel is a call into another library, so it is not done for every token
+//
+// Parsing even the slowest tokens takes well under a microsecond, so an abort is still seen within a millisecond
+//
+static const uint32_t ABORT_CHECK_INTERVAL = 1024;
+
+bool ParserSession::pollAbort() const {
+    
+    abortBudget = ABORT_CHECK_INTERVAL;
+    
+    if (abortFlag.load()) {
+        return true;
+    }
+    
+    if (currentAbortQ && currentAbortQ()) {
+        abortFlag = true;
+    }
+    
+    return abortFlag.load();
+}
+
+void ParserSession::abort() {
+    abortFlag = true;
+}
+
+NodePtr ParserSession::handleAbort() const {
+    
+    auto buf = byteBuffer->buffer;
+    auto loc = byteDecoder->SrcLoc;
+    
+    auto A = Token(TOKEN_ERROR_ABORTED, BufferAndLength(buf), Source(loc));
+    
+    auto Aborted = NodePtr(arena->make<ErrorNode>(A));
+    
+    return Aborted;
+}
+#endif // !NABORT
+
+#if USE_EXPR_LIB
+expr ParserSession::symbolExpr(const char *Name) {
+    
+    auto it = SymbolExprs.find(Name);
+    if (it != SymbolExprs.end()) {
+        return it->second;
+    }
+    
+    auto S = Expr_MEncodedStringToSymbolExpr(reinterpret_cast<const unsigned char *>(Name));
+    
+    SymbolExprs[Name] = S;
+    
+    return S;
+}
+#endif // USE_EXPR_LIB
+
+
+ParserSessionPool::ParserSessionPool(size_t threadCount) : sessions(), nodes(), owners(), missedSuggestions()
+#if !NABORT
+, aborted(false)
+#endif // !NABORT
+{
+    
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    
+    for (size_t i = 0; i < threadCount; i++) {
+        sessions.push_back(std::unique_ptr<ParserSession>(new ParserSession()));
+    }
+}
+
+ParserSessionPool::~ParserSessionPool() {
+    
+    release();
+}
+
+//
+// Run work(w) on its own thread for every w < workerCount, and wait for all of them
+//
+// poll is called from the calling thread every 10ms while the workers run
+//
+static void runWorkers(size_t workerCount, const std::function<void (size_t)>& work, const std::function<void ()>& poll) {
+    
+    std::mutex m;
+    std::condition_variable cv;
+    size_t finished = 0;
+    
+    std::vector<std::thread> threads;
+    threads.reserve(workerCount);
+    
+    for (size_t w = 0; w < workerCount; w++) {
+        
+        threads.push_back(std::thread([&, w]() {
+            
+            work(w);
+            
+            {
+                std::lock_guard<std::mutex> lock(m);
+                finished++;
+            }
+            cv.notify_one();
+        }));
+    }
+    
+    {
+        std::unique_lock<std::mutex> lock(m);
+        
+        while (finished < workerCount) {
+            
+            cv.wait_for(lock, std::chrono::milliseconds(10));
+            
+            poll();
+        }
+    }
+    
+    for (auto& T : threads) {
+        T.join();
+    }
+}
+
+void ParserSessionPool::run(const std::vector<BufferAndLength>& inputs, ParserSessionPolicy policy, SourceConvention srcConvention, uint32_t tabWidth, bool firstLineIsShebang, ParserSessionFunc F, std::function<bool ()> abortQ) {
+    
+    release();
+    
+    nodes.assign(inputs.size(), nullptr);
+    owners.assign(inputs.size(), nullptr);
+    missedSuggestions.assign(inputs.size(), 0);
+    
+#if !NABORT
+    aborted = false;
+#endif // !NABORT
+    
+    std::atomic<size_t> next(0);
+    
+    auto workerCount = std::min(sessions.size(), inputs.size());
+    
+    runWorkers(workerCount, [&](size_t w) {
+        
+        auto S = sessions[w].get();
+            
+        while (true) {
+                
+            auto i = next++;
+                
+            if (i >= inputs.size()) {
+                break;
+            }
+                
+            S->init(inputs[i], nullptr, policy, srcConvention, tabWidth, firstLineIsShebang);
+                
+#if !NABORT
+            //
+            // The calling thread aborts the sessions directly, but init clears that
+            //
+            if (aborted) {
+                S->abort();
+            }
+#endif // !NABORT
+                
+            nodes[i] = (S->*F)();
+            owners[i] = S;
+            missedSuggestions[i] = S->characterDecoder->missedSuggestion;
+                
+            S->deinit();
+        }
+    }, [&]() {
+#if !NABORT
+        if (abortQ && abortQ()) {
+            
+            aborted = true;
+            
+            for (auto& S : sessions) {
+                S->abort();
+            }
+        }
+#endif // !NABORT
+    });
+    
+#if !NABORT
+    //
+    // Nodes are put from the calling thread, so sessions may query the caller directly again
+    //
+    for (auto& S : sessions) {
+        S->currentAbortQ = abortQ;
+    }
+#endif // !NABORT
+}
+
+Node *ParserSessionPool::node(size_t i) const {
+    return nodes[i];
+}
+
+ParserSession *ParserSessionPool::session(size_t i) const {
+    return owners[i];
+}
+
+bool ParserSessionPool::missedSuggestion(size_t i) const {
+    return missedSuggestions[i];
+}
+
+void ParserSessionPool::release() {
+    
+    //
+    // Each session made the nodes of every input that it ran, so resetting each session once releases all of them
+    //
+    for (auto& S : sessions) {
+        S->releaseAllNodes();
+    }
+    
+    nodes.clear();
+    owners.clear();
+    missedSuggestions.clear();
+}
+
+
+//
+// Make the same List[CollectedExpressions, CollectedIssues, ...] as ParserSession::parseExpressions out of exprs
+//
+// The nodes that are made are kept in result, and not in an arena
+//
+// Every other node is made in an arena, but the arena of a session is only reset as a whole. An
+// IncrementalParserSession keeps most of its expressions in the arena across edits, and makes a new result after
+// every edit. Made in the arena, every old result would stay there until the next full parse. Kept in result, the
+// old nodes are freed as soon as the next result replaces them
+//
+// Only the containers are here. The expressions themselves are still in the arena of the session that parsed them
+//
+static Node *collectTopLevelExpressions(std::vector<TopLevelExpression>& exprs, std::vector<std::unique_ptr<Node>>& result) {
+    
+    std::vector<NodePtr> Exprs;
+    IssueVector Issues;
+    SourceLocationVector SimpleLineContinuations;
+    SourceLocationVector ComplexLineContinuations;
+    SourceLocationVector EmbeddedNewlines;
+    SourceLocationVector EmbeddedTabs;
+    
+    Exprs.reserve(exprs.size());
+    
+    for (auto& T : exprs) {
+        
+        T.applyPending();
+        
+        Exprs.push_back(NodePtr(T.Expr));
+        
+        Issues.insert(Issues.end(), T.Issues.begin(), T.Issues.end());
+        
+        SimpleLineContinuations.insert(SimpleLineContinuations.end(), T.SimpleLineContinuations.begin(), T.SimpleLineContinuations.end());
+        ComplexLineContinuations.insert(ComplexLineContinuations.end(), T.ComplexLineContinuations.begin(), T.ComplexLineContinuations.end());
+        EmbeddedNewlines.insert(EmbeddedNewlines.end(), T.EmbeddedNewlines.begin(), T.EmbeddedNewlines.end());
+        EmbeddedTabs.insert(EmbeddedTabs.end(), T.EmbeddedTabs.begin(), T.EmbeddedTabs.end());
+    }
+    
+    std::vector<NodePtr> nodes;
+    
+    result.push_back(std::unique_ptr<Node>(new CollectedExpressionsNode(std::move(Exprs))));
+    result.push_back(std::unique_ptr<Node>(new CollectedIssuesNode(std::move(Issues))));
+    result.push_back(std::unique_ptr<Node>(new CollectedSourceLocationsNode(std::move(SimpleLineContinuations))));
+    result.push_back(std::unique_ptr<Node>(new CollectedSourceLocationsNode(std::move(ComplexLineContinuations))));
+    result.push_back(std::unique_ptr<Node>(new CollectedSourceLocationsNode(std::move(EmbeddedNewlines))));
+    result.push_back(std::unique_ptr<Node>(new CollectedSourceLocationsNode(std::move(EmbeddedTabs))));
+    
+    for (auto& R : result) {
+        nodes.push_back(NodePtr(R.get()));
+    }
+    
+    result.push_back(std::unique_ptr<Node>(new ListNode(std::move(nodes))));
+    
+    return result.back().get();
+}
+
+
+IncrementalParserSession::IncrementalParserSession() : session(), libData(), policy(), srcConvention(), tabWidth(), firstLineIsShebang(), text(), exprs(), complete(), garbageSize(), lastParsedSize(), result() {}
+
+void IncrementalParserSession::init(BufferAndLength bufAndLen, WolframLibraryData libDataIn, ParserSessionPolicy policyIn, SourceConvention srcConventionIn, uint32_t tabWidthIn, bool firstLineIsShebangIn) {
+    
+    libData = libDataIn;
+    policy = policyIn;
+    srcConvention = srcConventionIn;
+    tabWidth = tabWidthIn;
+    firstLineIsShebang = firstLineIsShebangIn;
+    
+    std::vector<unsigned char> newText;
+    
+    newText.reserve(2 * bufAndLen.length() + 4096);
+    
+    newText.insert(newText.end(), bufAndLen.buffer, bufAndLen.end);
+    
+    text.swap(newText);
+    
+    parseAll();
+}
+
+void IncrementalParserSession::deinit() {
+    
+    result.clear();
+    exprs.clear();
+    
+    session.arena->reset();
+    
+    session.deinit();
+    
+    text.clear();
+    text.shrink_to_fit();
+}
+
+void IncrementalParserSession::parseAll() {
+    
+    result.clear();
+    exprs.clear();
+    
+    session.arena->reset();
+    
+    session.deinit();
+    
+    session.init(BufferAndLength(text.data(), text.size()), libData, policy, srcConvention, tabWidth, firstLineIsShebang);
+    
+    TopLevelExpression T;
+    
+    while (session.nextTopLevelExpression(T)) {
+        exprs.push_back(std::move(T));
+    }
+    
+    complete = true;
+    
+#if !NABORT
+    if (session.isAbort()) {
+        complete = false;
+    }
+#endif // !NABORT
+    
+    garbageSize = 0;
+    
+    lastParsedSize = text.size();
+}
+
+size_t IncrementalParserSession::offset(Buffer buf) const {
+    return buf - text.data();
+}
+
+bool IncrementalParserSession::edit(size_t off, size_t removed, BufferAndLength inserted) {
+    
+    if (off > text.size() || removed > text.size() - off) {
+        return false;
+    }
+    
+    auto insertedSize = inserted.length();
+    auto newSize = text.size() - removed + insertedSize;
+    
+    if (!complete || newSize > text.capacity() || garbageSize > text.size()) {
+        
+        std::vector<unsigned char> newText;
+        
+        newText.reserve(2 * newSize + 4096);
+        
+        newText.insert(newText.end(), text.begin(), text.begin() + off);
+        newText.insert(newText.end(), inserted.buffer, inserted.end);
+        newText.insert(newText.end(), text.begin() + off + removed, text.end());
+        
+        text.swap(newText);
+        
+        parseAll();
+        
+        return true;
+    }
+    
+    result.clear();
+    
+    //
+    // Keep everything that did not read as far as the edit
+    //
+    // Furthest only grows from one expression to the next, so this is a prefix
+    //
+    auto keep = static_cast<size_t>(std::partition_point(exprs.begin(), exprs.end(), [this, off](const TopLevelExpression& T) { return offset(T.Furthest) + ByteDecoder::MAX_DECODER_LOOKAHEAD < off; }) - exprs.begin());
+    
+    //
+    // The first old expression that starts after the edit
+    //
+    auto next = static_cast<size_t>(std::partition_point(exprs.begin() + keep, exprs.end(), [this, off, removed](const TopLevelExpression& T) { return offset(T.Buf.buffer) < off + removed; }) - exprs.begin());
+    
+    //
+    // The capacity was checked above, so the text does not move and the kept expressions before the edit stay valid
+    //
+    // The old expressions after the edit still point at the old offsets, until they are shifted
+    //
+    text.erase(text.begin() + off, text.begin() + off + removed);
+    text.insert(text.begin() + off, inserted.buffer, inserted.end);
+    
+    auto start = (keep > 0) ? offset(exprs[keep - 1].Buf.end) : 0;
+    
+    session.init(BufferAndLength(text.data(), text.size()), libData, policy, srcConvention, tabWidth, firstLineIsShebang && keep == 0);
+    
+    if (keep > 0) {
+        
+        session.seek(exprs[keep - 1].Buf.end, exprs[keep - 1].Src.End);
+        
+        //
+        // The kept expressions may have peeked past where parsing starts again
+        //
+        session.byteDecoder->furthest = std::max(session.byteDecoder->furthest, exprs[keep - 1].Furthest);
+    }
+    
+    std::vector<TopLevelExpression> parsed;
+    
+    //
+    // If nothing is found again, then everything after the edit was parsed again
+    //
+    auto resync = exprs.size();
+    
+    SourceShift S;
+    S.bytes = static_cast<ptrdiff_t>(insertedSize) - static_cast<ptrdiff_t>(removed);
+    S.first = 0;
+    S.second = 0;
+    
+    TopLevelExpression T;
+    
+    while (session.nextTopLevelExpression(T)) {
+        
+        auto newStart = offset(T.Buf.buffer);
+        auto isNewline = (T.Tok == TOKEN_TOPLEVELNEWLINE);
+        
+        parsed.push_back(std::move(T));
+        
+        if (!isNewline || newStart < off + insertedSize) {
+            continue;
+        }
+        
+        //
+        // Where this newline was before the edit
+        //
+        auto oldStart = newStart - insertedSize + removed;
+        
+        while (next < exprs.size() && offset(exprs[next].Buf.buffer) < oldStart) {
+            next++;
+        }
+        
+        if (next == exprs.size()) {
+            continue;
+        }
+        
+        auto& Old = exprs[next];
+        
+        if (offset(Old.Buf.buffer) != oldStart || Old.Tok != TOKEN_TOPLEVELNEWLINE) {
+            continue;
+        }
+        
+        //
+        // Both newlines end at the start of the same line of text
+        //
+        auto& New = parsed.back();
+        
+        S.first = New.Src.End.first - Old.Src.End.first;
+        S.second = New.Src.End.second - Old.Src.End.second;
+        
+        resync = next + 1;
+        
+        break;
+    }
+    
+#if !NABORT
+    if (resync == exprs.size() && session.isAbort()) {
+        complete = false;
+    }
+#endif // !NABORT
+    
+    lastParsedSize = (parsed.empty() ? start : offset(parsed.back().Buf.end)) - start;
+    
+    for (auto i = keep; i < resync; i++) {
+        garbageSize += exprs[i].Buf.length();
+    }
+    
+    if (S.bytes != 0 || S.first != 0 || S.second != 0) {
+        for (auto i = resync; i < exprs.size(); i++) {
+            exprs[i].shift(S);
+        }
+    }
+    
+    exprs.erase(exprs.begin() + keep, exprs.begin() + resync);
+    exprs.insert(exprs.begin() + keep, std::make_move_iterator(parsed.begin()), std::make_move_iterator(parsed.end()));
+    
+    //
+    // The expressions that were parsed again may have peeked further than the old ones that follow them
+    //
+    for (auto i = keep + parsed.size(); 0 < i && i < exprs.size() && exprs[i].Furthest < exprs[i - 1].Furthest; i++) {
+        exprs[i].Furthest = exprs[i - 1].Furthest;
+    }
+    
+    return true;
+}
+
+Node *IncrementalParserSession::parseExpressions() {
+    
+    result.clear();
+    
+    return collectTopLevelExpressions(exprs, result);
+}
+
+size_t IncrementalParserSession::getLastParsedSize() const {
+    return lastParsedSize;
+}
+
+ParserSession *IncrementalParserSession::getSession() {
+    return &session;
+}
+
+
+//
+// Smaller chunks are not worth handing to another thread
+//
+static const size_t PARALLEL_MIN_CHUNK_SIZE = 64 * 1024;
+
+//
+// More chunks than threads, so that a chunk that is slow to parse does not hold up the others
+//
+static const size_t PARALLEL_CHUNKS_PER_THREAD = 4;
+
+//
+// Estimate where the ByteDecoder is after reading [buf, end), starting at loc
+//
+// Only a guess: invalid UTF-8, or end not being at the start of a line under LineColumn, makes it wrong,
+// so the result is checked against where the previous chunk actually stopped
+//
+static SourceLocation advanceLocation(SourceLocation loc, Buffer buf, Buffer end) {
+    
+    if (loc == SourceLocation(0, 0)) {
+        
+        //
+        // Not tracking
+        //
+        return loc;
+    }
+    
+    if (loc.first == 0) {
+        
+        //
+        // SourceCharacterIndex: one for every character, and \r\n is 2
+        //
+        uint32_t count = 0;
+        
+        for (auto p = buf; p < end; p++) {
+            
+            //
+            // Do not count UTF-8 continuation bytes
+            //
+            count += ((*p & 0xc0) != 0x80);
+        }
+        
+        return SourceLocation(0, loc.second + count);
+    }
+    
+    //
+    // LineColumn: \n, \r\n, and \r are each one newline
+    //
+    uint32_t lines = 0;
+    
+    for (auto p = buf; p < end; p++) {
+        lines += (*p == '\n') || (*p == '\r' && (p + 1 == end || *(p + 1) != '\n'));
+    }
+    
+    return SourceLocation(loc.first + lines, 1);
+}
+
+ParallelParserSession::ParallelParserSession(size_t threadCount) : sessions(), bufAndLen(), policy(), srcConvention(), tabWidth(), firstLineIsShebang(), result(), serial()
+#if !NABORT
+, aborted(false)
+#endif // !NABORT
+{
+    
+    if (threadCount == 0) {
+        threadCount = 1;
+    }
+    
+    for (size_t i = 0; i < threadCount; i++) {
+        sessions.push_back(std::unique_ptr<ParserSession>(new ParserSession()));
+    }
+}
+
+ParallelParserSession::~ParallelParserSession() {
+    
+    release();
+}
+
+void ParallelParserSession::init(BufferAndLength bufAndLenIn, ParserSessionPolicy policyIn, SourceConvention srcConventionIn, uint32_t tabWidthIn, bool firstLineIsShebangIn) {
+    
+    bufAndLen = bufAndLenIn;
+    policy = policyIn;
+    srcConvention = srcConventionIn;
+    tabWidth = tabWidthIn;
+    firstLineIsShebang = firstLineIsShebangIn;
+}
+
+void ParallelParserSession::deinit() {
+    
+    release();
+}
+
+void ParallelParserSession::release() {
+    
+    result.clear();
+    
+    for (auto& S : sessions) {
+        S->arena->reset();
+    }
+}
+
+Node *ParallelParserSession::parseSerially(std::function<bool ()> abortQ) {
+    
+    release();
+    
+    serial = true;
+    
+    auto& S = *sessions[0];
+    
+    S.init(bufAndLen, nullptr, policy, srcConvention, tabWidth, firstLineIsShebang);
+    
+#if !NABORT
+    S.currentAbortQ = abortQ;
+#endif // !NABORT
+    
+    auto N = S.parseExpressions();
+    
+    S.deinit();
+    
+    return N;
+}
+
+Node *ParallelParserSession::parseExpressions(std::function<bool ()> abortQ) {
+    
+    release();
+    
+    serial = false;
+    
+#if !NABORT
+    aborted = false;
+#endif // !NABORT
+    
+    auto chunkCount = std::min(PARALLEL_CHUNKS_PER_THREAD * sessions.size(), bufAndLen.length() / PARALLEL_MIN_CHUNK_SIZE);
+    
+    auto splits = split(bufAndLen, firstLineIsShebang, chunkCount);
+    
+    if (sessions.size() == 1 || splits.empty()) {
+        return parseSerially(abortQ);
+    }
+    
+    chunkCount = splits.size() + 1;
+    
+    //
+    // Where the first chunk starts, after any BOM or shebang line
+    //
+    auto& S0 = *sessions[0];
+    
+    S0.init(bufAndLen, nullptr, policy, srcConvention, tabWidth, firstLineIsShebang);
+    
+    auto originBuf = S0.byteBuffer->buffer;
+    auto origin = S0.byteDecoder->SrcLoc;
+    
+    S0.deinit();
+    
+    //
+    // Where each chunk is expected to start, so that its SourceLocations are already right and nothing is shifted afterwards
+    //
+    std::vector<SourceLocation> starts(chunkCount);
+    
+    starts[0] = origin;
+    
+    auto prev = originBuf;
+    
+    for (size_t i = 1; i < chunkCount; i++) {
+        starts[i] = advanceLocation(starts[i - 1], prev, splits[i - 1]);
+        prev = splits[i - 1];
+    }
+    
+    std::vector<std::vector<TopLevelExpression>> chunks(chunkCount);
+    
+    std::vector<SourceLocation> ends(chunkCount);
+    
+    //
+    // Whether each chunk stopped exactly at the start of the next one
+    //
+    // char instead of bool, so that different threads write different bytes
+    //
+    std::vector<char> finished(chunkCount, 0);
+    
+    std::atomic<size_t> next(0);
+    
+    runWorkers(std::min(sessions.size(), chunkCount), [&](size_t w) {
+        
+        auto& S = *sessions[w];
+        
+        while (true) {
+            
+            auto i = next++;
+            
+            if (i >= chunkCount) {
+                break;
+            }
+            
+            auto stop = (i == chunkCount - 1) ? bufAndLen.end : splits[i];
+            
+            //
+            // Give the whole input, so that the chunk may peek past its end just like when parsing serially
+            //
+            S.init(bufAndLen, nullptr, policy, srcConvention, tabWidth, firstLineIsShebang && i == 0);
+            
+#if !NABORT
+            //
+            // The calling thread aborts the sessions directly, but init clears that
+            //
+            if (aborted) {
+                S.abort();
+            }
+#endif // !NABORT
+            
+            if (i != 0) {
+                S.seek(splits[i - 1], starts[i]);
+            }
+            
+            TopLevelExpression T;
+            
+            while (S.byteBuffer->buffer < stop && S.nextTopLevelExpression(T)) {
+                chunks[i].push_back(std::move(T));
+            }
+            
+            ends[i] = S.byteDecoder->SrcLoc;
+            finished[i] = (S.byteBuffer->buffer == stop);
+            
+            S.deinit();
+        }
+    }, [&]() {
+#if !NABORT
+        if (abortQ && abortQ()) {
+            
+            aborted = true;
+            
+            for (auto& S : sessions) {
+                S->abort();
+            }
+        }
+#endif // !NABORT
+    });
+    
+#if !NABORT
+    auto wasAborted = aborted.load();
+#else
+    auto wasAborted = false;
+#endif // !NABORT
+    
+    std::vector<TopLevelExpression> exprs;
+    
+    for (size_t i = 0; i < chunkCount; i++) {
+        
+        if (!finished[i]) {
+            
+            if (wasAborted) {
+                break;
+            }
+            
+            //
+            // The chunk read past its end, so the split was not at the start of a top-level expression
+            //
+            return parseSerially(abortQ);
+        }
+        
+        if (i + 1 < chunkCount && !(ends[i] == starts[i + 1])) {
+            
+            //
+            // The estimate was off, e.g. because of invalid UTF-8, so every later chunk has wrong SourceLocations
+            //
+            return parseSerially(abortQ);
+        }
+        
+        for (auto& T : chunks[i]) {
+            exprs.push_back(std::move(T));
+        }
+    }
+    
+    return collectTopLevelExpressions(exprs, result);
+}
+
+bool ParallelParserSession::wasSerial() const {
+    return serial;
+}
+
+ParserSession *ParallelParserSession::getSession() {
+    return sessions[0].get();
+}
+
+std::vector<Buffer> ParallelParserSession::split(BufferAndLength bufAndLen, bool firstLineIsShebang, size_t count) {
+    
+    std::vector<Buffer> splits;
+    
+    if (count <= 1) {
+        return splits;
+    }
+    
+    auto len = bufAndLen.length();
+    auto end = bufAndLen.end;
+    
+    auto p = bufAndLen.buffer;
+    
+    if (firstLineIsShebang) {
+        while (p < end && *p != '\n') {
+            p++;
+        }
+    }
+    
+    auto target = bufAndLen.buffer + len / count;
+    
+    //
+    // Depth of ( [ { and <|
+    //
+    size_t depth = 0;
+    
+    //
+    // Depth of (*
+    //
+    size_t commentDepth = 0;
+    
+    auto inString = false;
+    
+    //
+    // Whether the last character that is not whitespace or in a comment can end an expression but not continue it,
+    // such as a letter, a closer, or ;
+    //
+    // Anything else, such as an operator or a non-ASCII character that may be one, is assumed to continue onto the
+    // next line
+    //
+    auto complete = false;
+    
+    while (p < end) {
+        
+        auto c = *p;
+        
+        if (inString) {
+            
+            if (c == '\\') {
+                
+                p++;
+                
+                if (p < end) {
+                    p++;
+                }
+                
+                continue;
+            }
+            
+            if (c == '"') {
+                
+                inString = false;
+                
+                complete = true;
+            }
+            
+            p++;
+            
+            continue;
+        }
+        
+        if (commentDepth > 0) {
+            
+            if (c == '(' && p + 1 < end && *(p + 1) == '*') {
+                
+                commentDepth++;
+                
+                p += 2;
+                
+                continue;
+            }
+            
+            if (c == '*' && p + 1 < end && *(p + 1) == ')') {
+                
+                commentDepth--;
+                
+                p += 2;
+                
+                continue;
+            }
+            
+            p++;
+            
+            continue;
+        }
+        
+        switch (c) {
+            case '\n': {
+                
+                if (depth == 0 && complete && p + 1 >= target && p + 1 < end) {
+                    
+                    splits.push_back(p + 1);
+                    
+                    if (splits.size() == count - 1) {
+                        return splits;
+                    }
+                    
+                    target = bufAndLen.buffer + (splits.size() + 1) * (len / count);
+                }
+                
+                break;
+            }
+            case ' ': case '\t': case '\r': {
+                break;
+            }
+            case '"': {
+                
+                inString = true;
+                
+                break;
+            }
+            case '(': {
+                
+                if (p + 1 < end && *(p + 1) == '*') {
+                    
+                    commentDepth = 1;
+                    
+                    p += 2;
+                    
+                    continue;
+                }
+                
+                depth++;
+                
+                complete = false;
+                
+                break;
+            }
+            case '[': case '{': {
+                
+                depth++;
+                
+                complete = false;
+                
+                break;
+            }
+            case ')': case ']': case '}': {
+                
+                if (depth > 0) {
+                    depth--;
+                }
+                
+                complete = true;
+                
+                break;
+            }
+            case '<': {
+                
+                if (p + 1 < end && *(p + 1) == '|') {
+                    
+                    depth++;
+                    
+                    p++;
+                }
+                
+                complete = false;
+                
+                break;
+            }
+            case '|': {
+                
+                if (p + 1 < end && *(p + 1) == '>') {
+                    
+                    if (depth > 0) {
+                        depth--;
+                    }
+                    
+                    complete = true;
+                    
+                    p += 2;
+                    
+                    continue;
+                }
+                
+                complete = false;
+                
+                break;
+            }
+            case '\\': {
+                
+                //
+                // A line continuation, which is skipped together with its newline, or the start of an escape such
+                // as \[Rule] that may be an operator
+                //
+                p++;
+                
+                if (p < end && *p == '[') {
+                    
+                    while (p < end && *p != ']') {
+                        p++;
+                    }
+                    
+                } else if (p + 1 < end && *p == '\r' && *(p + 1) == '\n') {
+                    
+                    p++;
+                }
+                
+                complete = false;
+                
+                break;
+            }
+            case ';': case '$': {
+                
+                complete = true;
+                
+                break;
+            }
+            default: {
+                
+                complete = (c < 0x80) && std::isalnum(c);
+                
+                break;
+            }
+        }
+        
+        p++;
+    }
+    
+    return splits;
+}
+
+
+DLLEXPORT mint WolframLibrary_getVersion() {
+    return WolframLibraryVersion;
+}
+
+DLLEXPORT int WolframLibrary_initialize(WolframLibraryData libData) {
+    
+    return 0;
+}
+
+DLLEXPORT void WolframLibrary_uninitialize(WolframLibraryData libData) {
+    
+}
+
+//
+// The columns of TokenArrays, as the NumericArrays that TokenizeBytesArrays_LibraryLink returns
+//
+static const size_t COLUMN_COUNT = 4;
+
+static const numericarray_data_t COLUMN_TYPES[COLUMN_COUNT] = {MNumericArray_Type_UBit16, MNumericArray_Type_UBit32, MNumericArray_Type_UBit32, MNumericArray_Type_UBit32};
+
+static const size_t COLUMN_SIZES[COLUMN_COUNT] = {sizeof(uint16_t), sizeof(uint32_t), sizeof(uint32_t), sizeof(Source)};
+
+static void freeColumns(WolframLibraryData libData, MNumericArray *cols, size_t count) {
+    
+    for (size_t i = 0; i < count; i++) {
+        libData->numericarrayLibraryFunctions->MNumericArray_free(cols[i]);
+    }
+}
+
+//
+// Make columns with room for n tokens, with the first count tokens of old if old is given
+//
+// Sources have dimensions {n, 2, 2}
+//
+static bool newColumns(WolframLibraryData libData, MNumericArray *cols, size_t n, const MNumericArray *old, size_t count) {
+    
+    auto naFuns = libData->numericarrayLibraryFunctions;
+    
+    auto len = static_cast<mint>(n);
+    
+    mint srcDims[] = {len, 2, 2};
+    
+    for (size_t i = 0; i < COLUMN_COUNT; i++) {
+        
+        auto isSrcs = (i == COLUMN_COUNT - 1);
+        
+        if (naFuns->MNumericArray_new(COLUMN_TYPES[i], isSrcs ? 3 : 1, isSrcs ? srcDims : &len, &cols[i]) != LIBRARY_NO_ERROR) {
+            
+            freeColumns(libData, cols, i);
+            
+            return false;
+        }
+        
+        if (old && count > 0) {
+            memcpy(naFuns->MNumericArray_getData(cols[i]), naFuns->MNumericArray_getData(old[i]), count * COLUMN_SIZES[i]);
+        }
+    }
+    
+    return true;
+}
+
+//
+// The bytes of a "Constant" ByteArray, in place and without copying
+//
+static int getBytes(WolframLibraryData libData, MArgument Arg, BufferAndLength& bufAndLen) {
+    
+    auto naFuns = libData->numericarrayLibraryFunctions;
+    
+    auto bytes = MArgument_getMNumericArray(Arg);
+    
+    if (naFuns->MNumericArray_getType(bytes) != MNumericArray_Type_UBit8) {
+        return LIBRARY_TYPE_ERROR;
+    }
+    
+    if (naFuns->MNumericArray_getRank(bytes) != 1) {
+        return LIBRARY_RANK_ERROR;
+    }
+    
+    bufAndLen = BufferAndLength(static_cast<Buffer>(naFuns->MNumericArray_getData(bytes)), static_cast<size_t>(naFuns->MNumericArray_getFlattenedLength(bytes)));
+    
+    return LIBRARY_NO_ERROR;
+}
+
+DLLEXPORT int TokenizeBytesArrays_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res) {
+    
+    if (Argc != 4) {
+        return LIBRARY_FUNCTION_ERROR;
+    }
+    
+    BufferAndLength bufAndLen;
+    
+    auto err = getBytes(libData, Args[0], bufAndLen);
+    if (err != LIBRARY_NO_ERROR) {
+        return err;
+    }
+    
+    auto conventionStr = MArgument_getUTF8String(Args[1]);
+    auto srcConvention = Utils::parseSourceConvention(conventionStr);
+    libData->UTF8String_disown(conventionStr);
+    
+    if (srcConvention == SOURCECONVENTION_UNKNOWN) {
+        return LIBRARY_FUNCTION_ERROR;
+    }
+    
+    auto tabWidth = static_cast<uint32_t>(MArgument_getInteger(Args[2]));
+    auto firstLineIsShebang = static_cast<bool>(MArgument_getBoolean(Args[3]));
+    
+    ParserSession session;
+    
+    session.init(bufAndLen, libData, INCLUDE_SOURCE, srcConvention, tabWidth, firstLineIsShebang);
+    
+    auto naFuns = libData->numericarrayLibraryFunctions;
+    
+    //
+    // Tokens are written straight into the NumericArrays
+    //
+    // Tokens are usually several bytes, so the columns seldom grow. They are grown like a vector when they do, and
+    // trimmed to the number of tokens at the end
+    //
+    auto capacity = bufAndLen.length() / 2 + 1;
+    
+    MNumericArray cols[COLUMN_COUNT];
     
-    {
-        auto& ComplexLineContinuations = TheCharacterDecoder->getComplexLineContinuations();
+    if (!newColumns(libData, cols, capacity, nullptr, 0)) {
         
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(ComplexLineContinuations))));
-    }
-    
-    {
-        auto& EmbeddedNewlines = TheTokenizer->getEmbeddedNewlines();
+        session.deinit();
         
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(EmbeddedNewlines))));
+        return LIBRARY_MEMORY_ERROR;
     }
     
-    {
-        std::set<SourceLocation> tabs;
+    size_t n = 0;
+    
+    while (true) {
         
-        auto& TokenizerEmbeddedTabs = TheTokenizer->getEmbeddedTabs();
-        for (auto& T : TokenizerEmbeddedTabs) {
-            tabs.insert(T);
+        n += session.tokenizeArrays(static_cast<uint16_t *>(naFuns->MNumericArray_getData(cols[0])) + n,
+                                    static_cast<uint32_t *>(naFuns->MNumericArray_getData(cols[1])) + n,
+                                    static_cast<uint32_t *>(naFuns->MNumericArray_getData(cols[2])) + n,
+                                    static_cast<Source *>(naFuns->MNumericArray_getData(cols[3])) + n,
+                                    capacity - n);
+        
+        if (n < capacity) {
+            break;
         }
         
-        auto& CharacterDecoderEmbeddedTabs = TheCharacterDecoder->getEmbeddedTabs();
-        for (auto& T : CharacterDecoderEmbeddedTabs) {
-            tabs.insert(T);
+        MNumericArray grown[COLUMN_COUNT];
+        
+        if (!newColumns(libData, grown, 2 * capacity, cols, n)) {
+            
+            freeColumns(libData, cols, COLUMN_COUNT);
+            
+            session.deinit();
+            
+            return LIBRARY_MEMORY_ERROR;
         }
         
-        nodes.push_back(NodePtr(new CollectedSourceLocationsNode(std::move(tabs))));
+        freeColumns(libData, cols, COLUMN_COUNT);
+        
+        std::copy(grown, grown + COLUMN_COUNT, cols);
+        
+        capacity *= 2;
     }
     
-    auto N = new ListNode(std::move(nodes));
+    session.deinit();
     
-    return N;
-}
-
-//
-// Does the file currently have permission to be read?
-//
-bool validatePath(WolframLibraryData libData, BufferAndLength bufAndLen) {
+    MNumericArray trimmed[COLUMN_COUNT];
     
-    if (!libData) {
-        //
-        // If running as a stand-alone executable, then always valid
-        //
-        return true;
+    auto ok = newColumns(libData, trimmed, n, cols, n);
+    
+    freeColumns(libData, cols, COLUMN_COUNT);
+    
+    if (!ok) {
+        return LIBRARY_MEMORY_ERROR;
     }
     
-    auto inStr1 = reinterpret_cast<const char *>(bufAndLen.buffer);
+    auto ds = libData->ioLibraryFunctions->createDataStore();
     
-    auto inStr2 = const_cast<char *>(inStr1);
+    for (size_t i = 0; i < COLUMN_COUNT; i++) {
+        libData->ioLibraryFunctions->DataStore_addMNumericArray(ds, trimmed[i]);
+    }
     
-    auto valid = libData->validatePath(inStr2, 'R');
-    return valid;
+    MArgument_setDataStore(Res, ds);
+    
+    return LIBRARY_NO_ERROR;
 }
 
-void ParserSession::releaseNode(Node *N) {
-    delete N;
-}
 
-#if !NABORT
-bool ParserSession::isAbort() const {
-    if (!currentAbortQ) {
-        return false;
+#if USE_MATHLINK
+
+//
+// Shared by the _Listable_ functions
+//
+// With threadCount > 1, inputs are run on a ParserSessionPool and the finished nodes are put in input order
+//
+// Workers cannot call back into the kernel, so an input that wanted a long name suggestion is parsed again on the
+// calling thread with libData. Unknown long names are rare, and the result does not depend on threadCount
+//
+static void putListable(WolframLibraryData libData, MLINK mlp, const std::vector<ScopedMLByteArrayPtr>& arrs, SourceConvention srcConvention, int tabWidth, bool skipFirstLine, int threadCount, ParserSessionPolicy policy, ParserSessionFunc F) {
+    
+    auto len = arrs.size();
+    
+    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(len))) {
+        assert(false);
     }
     
-    return currentAbortQ();
-}
-
-NodePtr ParserSession::handleAbort() const {
+    if (threadCount <= 1 || len <= 1) {
+        
+        ParserSession session;
+        
+        for (size_t i = 0; i < len; i++) {
+            
+            const auto& arr = arrs[i];
+            
+            auto bufAndLen = BufferAndLength(arr->get(), arr->getByteCount());
+            
+            session.init(bufAndLen, libData, policy, srcConvention, tabWidth, skipFirstLine);
+            
+            auto N = (session.*F)();
+            
+            N->put(&session, mlp);
+            
+            session.releaseAllNodes();
+            
+            session.deinit();
+        }
+        
+        return;
+    }
     
-    auto buf = TheByteBuffer->buffer;
-    auto loc = TheByteDecoder->SrcLoc;
+    std::vector<BufferAndLength> inputs;
+    inputs.reserve(len);
     
-    auto A = Token(TOKEN_ERROR_ABORTED, BufferAndLength(buf), Source(loc));
+    for (auto& arr : arrs) {
+        inputs.push_back(BufferAndLength(arr->get(), arr->getByteCount()));
+    }
     
-    auto Aborted = NodePtr(new ErrorNode(A));
+    std::function<bool ()> abortQ;
+    if (libData) {
+        abortQ = [libData]() {
+            //
+            // AbortQ() returns a mint
+            //
+            bool res = libData->AbortQ();
+            return res;
+        };
+    }
     
-    return Aborted;
-}
-#endif // !NABORT
-
-ParserSessionPtr TheParserSession = nullptr;
-
-
-
-
-DLLEXPORT mint WolframLibrary_getVersion() {
-    return WolframLibraryVersion;
-}
-
-DLLEXPORT int WolframLibrary_initialize(WolframLibraryData libData) {
+    ParserSessionPool pool(static_cast<size_t>(threadCount));
     
-    TheParserSession = ParserSessionPtr(new ParserSession);
+    pool.run(inputs, policy, srcConvention, tabWidth, skipFirstLine, F, abortQ);
     
-    return 0;
-}
-
-DLLEXPORT void WolframLibrary_uninitialize(WolframLibraryData libData) {
+    ParserSession session;
+    
+    for (size_t i = 0; i < len; i++) {
+        
+        if (!libData || !pool.missedSuggestion(i)) {
+            
+            pool.node(i)->put(pool.session(i), mlp);
+            
+            continue;
+        }
+        
+        session.init(inputs[i], libData, policy, srcConvention, tabWidth, skipFirstLine);
+        
+        auto N = (session.*F)();
+        
+        N->put(&session, mlp);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+    }
     
-    TheParserSession.reset(nullptr);
+    pool.release();
 }
 
-
-#if USE_MATHLINK
-
-DLLEXPORT int ConcreteParseBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp) {
+//
+// Read the arguments of a _Listable_ function and put the results
+//
+// Arguments are  {bytes...}, convention, tabWidth, skipFirstLine,  then isFile if hasIsFile, then an optional thread
+// count. The default is to parse serially
+//
+static int runListable(WolframLibraryData libData, MLINK mlp, bool hasIsFile, ParserSessionFunc F) {
     
     int mlLen;
     
@@ -485,9 +2075,11 @@ DLLEXPORT int ConcreteParseBytes_Listable_LibraryLink(WolframLibraryData libData
         return LIBRARY_FUNCTION_ERROR;
     }
     
-    auto len = static_cast<size_t>(mlLen);
+    auto argCount = static_cast<size_t>(mlLen);
+    
+    size_t requiredCount = hasIsFile ? 5 : 4;
     
-    if (len != 4) {
+    if (argCount != requiredCount && argCount != requiredCount + 1) {
         return LIBRARY_FUNCTION_ERROR;
     }
     
@@ -495,7 +2087,7 @@ DLLEXPORT int ConcreteParseBytes_Listable_LibraryLink(WolframLibraryData libData
         return LIBRARY_FUNCTION_ERROR;
     }
     
-    len = static_cast<size_t>(mlLen);
+    auto len = static_cast<size_t>(mlLen);
     
     auto arrs = std::vector<ScopedMLByteArrayPtr>();
     arrs.reserve(len);
@@ -528,109 +2120,177 @@ DLLEXPORT int ConcreteParseBytes_Listable_LibraryLink(WolframLibraryData libData
     
     auto skipFirstLine = static_cast<bool>(mlSkipFirstLine);
     
-    if (!MLNewPacket(mlp) ) {
-        return LIBRARY_FUNCTION_ERROR;
-    }
+    ParserSessionPolicy policy = INCLUDE_SOURCE;
     
-    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), mlLen)) {
-        assert(false);
-    }
-    for (size_t i = 0; i < len; i++) {
-        
-        const auto& arr = arrs[i];
-        
-        auto bufAndLen = BufferAndLength(arr->get(), arr->getByteCount());
+    if (hasIsFile) {
         
-        TheParserSession->init(bufAndLen, libData, INCLUDE_SOURCE, srcConvention, tabWidth, skipFirstLine);
-        
-        auto N = TheParserSession->parseExpressions();
-        
-        N->put(mlp);
-        
-        TheParserSession->releaseNode(N);
+        int mlIsFile;
+        if (!MLGetInteger(mlp, &mlIsFile)) {
+            return LIBRARY_FUNCTION_ERROR;
+        }
         
-        TheParserSession->deinit();
+        if (mlIsFile) {
+            policy |= REPORT_TOPLEVEL_ISSUES;
+        }
+    }
+    
+    int threadCount = 1;
+    if (argCount == requiredCount + 1) {
+        if (!MLGetInteger(mlp, &threadCount)) {
+            return LIBRARY_FUNCTION_ERROR;
+        }
+    }
+    
+    if (!MLNewPacket(mlp) ) {
+        return LIBRARY_FUNCTION_ERROR;
     }
     
+    putListable(libData, mlp, arrs, srcConvention, tabWidth, skipFirstLine, threadCount, policy, F);
+    
     return LIBRARY_NO_ERROR;
 }
 
+DLLEXPORT int ConcreteParseBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp) {
+    return runListable(libData, mlp, false, &ParserSession::parseExpressions);
+}
+    
+DLLEXPORT int AbstractParseBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp) {
+    return runListable(libData, mlp, true, &ParserSession::abstractParseExpressions);
+}
+
 DLLEXPORT int TokenizeBytes_Listable_LibraryLink(WolframLibraryData libData, MLINK mlp) {
+    return runListable(libData, mlp, false, &ParserSession::tokenize);
+}
+
+//
+// Shared by the _ByteArray_ functions
+//
+// Args are bytes, convention, tabWidth, firstLineIsShebang, and the bytes are parsed in place
+//
+// With USE_EXPR_LIB, the tree is built with toExpr and Res is set to a pointer to it, which the caller takes
+// with Expr_FromPointer
+//
+// Otherwise a tree cannot be returned through an MArgument, so this path still sends the whole tree over the callback
+// link as  CodeParser`Library`$ByteArrayResult = node  and the caller reads $ByteArrayResult afterward
+//
+static int putByteArray(WolframLibraryData libData, MArgument *Args, MArgument Res, ParserSessionPolicy policy, ParserSessionFunc F) {
     
-    int mlLen;
+    BufferAndLength bufAndLen;
     
-    if (!MLTestHead(mlp, SYMBOL_LIST->name(), &mlLen)) {
-        return LIBRARY_FUNCTION_ERROR;
+    auto err = getBytes(libData, Args[0], bufAndLen);
+    if (err != LIBRARY_NO_ERROR) {
+        return err;
     }
     
-    auto len = static_cast<size_t>(mlLen);
+    auto conventionStr = MArgument_getUTF8String(Args[1]);
+    auto srcConvention = Utils::parseSourceConvention(conventionStr);
+    libData->UTF8String_disown(conventionStr);
     
-    if (len != 4) {
+    if (srcConvention == SOURCECONVENTION_UNKNOWN) {
         return LIBRARY_FUNCTION_ERROR;
     }
     
-    if (!MLTestHead(mlp, SYMBOL_LIST->name(), &mlLen)) {
+    auto tabWidth = static_cast<uint32_t>(MArgument_getInteger(Args[2]));
+    auto firstLineIsShebang = static_cast<bool>(MArgument_getBoolean(Args[3]));
+    
+    ParserSession session;
+    
+    session.init(bufAndLen, libData, policy, srcConvention, tabWidth, firstLineIsShebang);
+    
+    auto N = (session.*F)();
+    
+#if USE_EXPR_LIB
+    
+    ExprBuilder B(&session);
+    
+    N->toExpr(&session, B);
+    
+    auto e = B.get();
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    if (!e) {
         return LIBRARY_FUNCTION_ERROR;
     }
-
-    len = static_cast<size_t>(mlLen);
     
-    auto arrs = std::vector<ScopedMLByteArrayPtr>();
-    arrs.reserve(len);
+    MArgument_setInteger(Res, Expr_Pointer(e));
     
-    for (size_t i = 0; i < len; i++) {
-        
-        auto arr = ScopedMLByteArrayPtr(new ScopedMLByteArray(mlp));
-        if (!arr->read()) {
-            return LIBRARY_FUNCTION_ERROR;
-        }
-        
-        arrs.push_back(std::move(arr));
+    return LIBRARY_NO_ERROR;
+    
+#else
+    
+    MLINK link = libData->getMathLink(libData);
+    if (!MLPutFunction(link, "EvaluatePacket", 1)) {
+        assert(false);
+    }
+    if (!MLPutFunction(link, SYMBOL_COMPOUNDEXPRESSION->name(), 2)) {
+        assert(false);
+    }
+    if (!MLPutFunction(link, SYMBOL_SET->name(), 2)) {
+        assert(false);
+    }
+    if (!MLPutSymbol(link, "CodeParser`Library`$ByteArrayResult")) {
+        assert(false);
     }
     
-    auto conventionStr = ScopedMLStringPtr(new ScopedMLString(mlp));
-    if (!conventionStr->read()) {
+    N->put(&session, link);
+    
+    if (!MLPutSymbol(link, SYMBOL_NULL->name())) {
+        assert(false);
+    }
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    if (!libData->processMathLink(link)) {
         return LIBRARY_FUNCTION_ERROR;
     }
-    auto srcConvention = Utils::parseSourceConvention(conventionStr->get());
     
-    int tabWidth;
-    if (!MLGetInteger(mlp, &tabWidth)) {
+    //
+    // Drain the ReturnPacket[Null] and any messages printed while evaluating
+    //
+    if (!drainToReturnPacket(link)) {
         return LIBRARY_FUNCTION_ERROR;
     }
     
-    int mlSkipFirstLine;
-    if (!MLGetInteger(mlp, &mlSkipFirstLine)) {
+    return LIBRARY_NO_ERROR;
+    
+#endif // USE_EXPR_LIB
+}
+
+DLLEXPORT int ConcreteParseByteArray_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res) {
+    
+    if (Argc != 4) {
         return LIBRARY_FUNCTION_ERROR;
     }
     
-    auto skipFirstLine = static_cast<bool>(mlSkipFirstLine);
+    return putByteArray(libData, Args, Res, INCLUDE_SOURCE, &ParserSession::parseExpressions);
+}
+
+DLLEXPORT int AbstractParseByteArray_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res) {
     
-    if (!MLNewPacket(mlp) ) {
+    if (Argc != 5) {
         return LIBRARY_FUNCTION_ERROR;
     }
     
-    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), mlLen)) {
-        assert(false);
+    ParserSessionPolicy policy = INCLUDE_SOURCE;
+    if (MArgument_getBoolean(Args[4])) {
+        policy |= REPORT_TOPLEVEL_ISSUES;
     }
-    for (size_t i = 0; i < len; i++) {
-        
-        const auto& arr = arrs[i];
-        
-        auto bufAndLen = BufferAndLength(arr->get(), arr->getByteCount());
-        
-        TheParserSession->init(bufAndLen, libData, INCLUDE_SOURCE, srcConvention, tabWidth, skipFirstLine);
-        
-        auto N = TheParserSession->tokenize();
-        
-        N->put(mlp);
-        
-        TheParserSession->releaseNode(N);
-        
-        TheParserSession->deinit();
+    
+    return putByteArray(libData, Args, Res, policy, &ParserSession::abstractParseExpressions);
+}
+
+DLLEXPORT int TokenizeByteArray_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *Args, MArgument Res) {
+    
+    if (Argc != 4) {
+        return LIBRARY_FUNCTION_ERROR;
     }
     
-    return LIBRARY_NO_ERROR;
+    return putByteArray(libData, Args, Res, INCLUDE_SOURCE, &ParserSession::tokenize);
 }
 
 DLLEXPORT int ConcreteParseLeaf_LibraryLink(WolframLibraryData libData, MLINK mlp) {
@@ -683,15 +2343,17 @@ DLLEXPORT int ConcreteParseLeaf_LibraryLink(WolframLibraryData libData, MLINK ml
     
     auto bufAndLen = BufferAndLength(inStr->get(), inStr->getByteCount());
     
-    TheParserSession->init(bufAndLen, libData, INCLUDE_SOURCE, srcConvention, tabWidth, skipFirstLine);
+    ParserSession session;
+    
+    session.init(bufAndLen, libData, INCLUDE_SOURCE, srcConvention, tabWidth, skipFirstLine);
     
-    auto N = TheParserSession->concreteParseLeaf(static_cast<StringifyMode>(stringifyMode));
+    auto N = session.concreteParseLeaf(static_cast<StringifyMode>(stringifyMode));
     
-    N->put(mlp);
+    N->put(&session, mlp);
     
-    TheParserSession->releaseNode(N);
+    session.releaseAllNodes();
     
-    TheParserSession->deinit();
+    session.deinit();
     
     return LIBRARY_NO_ERROR;
 }
@@ -726,17 +2388,8 @@ DLLEXPORT int SafeString_LibraryLink(WolframLibraryData libData, MLINK mlp) {
     //
     auto bufAndLen = BufferAndLength(arr->get(), arr->getByteCount(), UTF8STATUS_INVALID);
     
-    TheByteBuffer->init(bufAndLen, libData);
-    //
-    // Arbitrarily choose LineColumn convention, but it is not used
-    //
-    TheByteDecoder->init(SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
-    
     bufAndLen.putUTF8String(mlp);
     
-    TheByteDecoder->deinit();
-    TheByteBuffer->deinit();
-    
     return LIBRARY_NO_ERROR;
 }
 
@@ -782,7 +2435,18 @@ DLLEXPORT int SetupLongNames_LibraryLink(WolframLibraryData libData, MLINK mlp)
         
         const auto& str = strs[i];
         
-        undocumentedLongNames.insert(str->get());
+        auto name = str->get();
+        
+        auto idx = LongNames::findLongName(reinterpret_cast<const unsigned char *>(name), strlen(name));
+        
+        //
+        // Names that are not known here can never be found in the input, so there is no need to remember them
+        //
+        if (idx == -1) {
+            continue;
+        }
+        
+        undocumentedLongNames.insert(LongNameToCodePointMap_points[idx]);
     }
     
     //
@@ -951,5 +2615,25 @@ MLINK ScopedMLLoopbackLink::get() {
     return mlp;
 }
 
+bool drainToReturnPacket(MLINK link) {
+    
+    while (true) {
+        
+        auto pkt = MLNextPacket(link);
+        
+        if (pkt == ILLEGALPKT) {
+            return false;
+        }
+        
+        if (!MLNewPacket(link)) {
+            return false;
+        }
+        
+        if (pkt == RETURNPKT) {
+            return true;
+        }
+    }
+}
+
 #endif // USE_MATHLINK
 
@@ -0,0 +1,1672 @@
+
+#include "Abstract.h"
+
+#include "API.h" // for ParserSession
+#include "Symbol.h" // for SYMBOL_BLANK, etc.
+#include "TokenEnum.h" // for TOKEN_UNDER, etc.
+
+#if USE_MATHLINK
+#include "mathlink.h"
+#undef P
+#endif // USE_MATHLINK
+
+#include <vector>
+#include <string>
+#include <cstring> // for strlen, memcpy, memcmp
+#include <algorithm> // for binary_search, sort
+
+//
+// Nodes deeper than this are given to the kernel, so that abstracting does not overflow the C++ stack
+//
+const size_t ABSTRACT_MAX_DEPTH = 1024;
+
+static bool isLeaf(const Node *N, TokenEnum T) {
+    return N->kind() == CSTNODEKIND_LEAF && static_cast<const LeafNode *>(N)->getToken().Tok == T;
+}
+
+static bool isOperator(const Node *N, CSTNodeKind K, const SymbolPtr& Op) {
+    return N->kind() == K && static_cast<const OperatorNode *>(N)->getOp() == Op;
+}
+
+static bool isLeafText(const Node *N, TokenEnum T, const char *Str) {
+    
+    if (!isLeaf(N, T)) {
+        return false;
+    }
+    
+    auto BufLen = static_cast<const LeafNode *>(N)->getToken().BufLen;
+    
+    auto len = strlen(Str);
+    
+    return BufLen.length() == len && memcmp(BufLen.buffer, Str, len) == 0;
+}
+
+static std::vector<const Node *> aggregateChildren(const Node *N) {
+    
+    std::vector<const Node *> C;
+    
+    N->getChildrenSafe().aggregate(C);
+    
+    return C;
+}
+
+//
+// parenthesizedIntegerOrRealQ
+//
+static bool parenthesizedIntegerOrReal(const Node *N) {
+    
+    while (isOperator(N, CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPPAREN)) {
+        
+        auto C = aggregateChildren(N);
+        
+        if (C.size() != 3) {
+            return false;
+        }
+        
+        N = C[1];
+    }
+    
+    return isLeaf(N, TOKEN_INTEGER) || isLeaf(N, TOKEN_REAL);
+}
+
+static bool topLevelCompoundBenign(const Node *N);
+
+//
+// Benign nodes at top-level, as in topLevelChildIssues
+//
+static bool topLevelBenign(const Node *N) {
+    
+    switch (N->kind()) {
+        case CSTNODEKIND_CALL: {
+            return true;
+        }
+        case CSTNODEKIND_LEAF: {
+            return isLeaf(N, TOKEN_SYMBOL);
+        }
+        case CSTNODEKIND_BINARY: {
+            
+            auto& Op = static_cast<const OperatorNode *>(N)->getOp();
+            
+            return Op == SYMBOL_ADDTO || Op == SYMBOL_APPLY || Op == SYMBOL_CODEPARSER_BINARYAT ||
+                Op == SYMBOL_CODEPARSER_BINARYATATAT || Op == SYMBOL_CODEPARSER_BINARYSLASHSLASH || Op == SYMBOL_MAP ||
+                Op == SYMBOL_SET || Op == SYMBOL_SETDELAYED || Op == SYMBOL_SUBTRACTFROM || Op == SYMBOL_UNSET ||
+                Op == SYMBOL_UPSET || Op == SYMBOL_UPSETDELAYED || Op == SYMBOL_PUT || Op == SYMBOL_PUTAPPEND;
+        }
+        case CSTNODEKIND_TERNARY: {
+            
+            auto& Op = static_cast<const OperatorNode *>(N)->getOp();
+            
+            return Op == SYMBOL_TAGSET || Op == SYMBOL_TAGSETDELAYED || Op == SYMBOL_TAGUNSET;
+        }
+        case CSTNODEKIND_PREFIX: {
+            
+            auto& Op = static_cast<const OperatorNode *>(N)->getOp();
+            
+            return Op == SYMBOL_GET || Op == SYMBOL_PREDECREMENT || Op == SYMBOL_PREINCREMENT;
+        }
+        case CSTNODEKIND_POSTFIX: {
+            
+            auto& Op = static_cast<const OperatorNode *>(N)->getOp();
+            
+            return Op == SYMBOL_DECREMENT || Op == SYMBOL_INCREMENT;
+        }
+        case CSTNODEKIND_GROUP: {
+            return isOperator(N, CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPPAREN);
+        }
+        case CSTNODEKIND_INFIX: {
+            return isOperator(N, CSTNODEKIND_INFIX, SYMBOL_COMPOUNDEXPRESSION) && topLevelCompoundBenign(N);
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+//
+// The CompoundExpression rules of topLevelChildIssues that give no issues:
+//
+// x;  where x is benign, with  a ~f~ b  instead of TagUnset
+//
+// a = 1; b = 2;  and  a; b;  and  a; b
+//
+// Lists of declarations such as  {a, b};  are left to the kernel
+//
+static bool topLevelCompoundBenign(const Node *N) {
+    
+    auto C = aggregateChildren(N);
+    
+    if (C.size() < 3 || C.size() % 2 == 0) {
+        return false;
+    }
+    
+    auto ImplicitNull = isLeaf(C.back(), TOKEN_FAKE_IMPLICITNULL);
+    
+    if (C.size() == 3 && ImplicitNull) {
+        
+        auto X = C[0];
+        
+        switch (X->kind()) {
+            case CSTNODEKIND_TERNARY: {
+                
+                auto& Op = static_cast<const OperatorNode *>(X)->getOp();
+                
+                return Op == SYMBOL_TAGSET || Op == SYMBOL_TAGSETDELAYED || Op == SYMBOL_CODEPARSER_TERNARYTILDE;
+            }
+            case CSTNODEKIND_INFIX: {
+                return false;
+            }
+            default: {
+                
+                if (topLevelBenign(X)) {
+                    return true;
+                }
+            }
+        }
+    }
+    
+    auto Sets = ImplicitNull;
+    auto Symbols = true;
+    
+    auto Last = ImplicitNull ? C.size() - 1 : C.size();
+    
+    for (size_t i = 0; i < Last; i += 2) {
+        
+        auto X = C[i];
+        
+        if (!(isOperator(X, CSTNODEKIND_BINARY, SYMBOL_SET) || isOperator(X, CSTNODEKIND_BINARY, SYMBOL_SETDELAYED) || isOperator(X, CSTNODEKIND_BINARY, SYMBOL_UNSET))) {
+            Sets = false;
+        }
+        
+        if (!isLeaf(X, TOKEN_SYMBOL)) {
+            Symbols = false;
+        }
+    }
+    
+    return Sets || Symbols;
+}
+
+//
+// Each rule returns nullptr when it does not handle a node, and then abstract gives the node to the kernel
+//
+class Abstracter {
+    
+    ParserSession *session;
+    
+    size_t Depth;
+    
+    //
+    // The starts of the tokens that the kernel normalizes before abstracting: tokens with line continuations, and
+    // tokens with embedded newlines or tabs
+    //
+    // Sorted
+    //
+    std::vector<SourceLocation> UnnormalizedStarts;
+    
+    //
+    // Set when a rule looks at the text of one of those tokens, and then abstract gives the node to the kernel
+    //
+    bool TouchedUnnormalized;
+    
+    bool unnormalized(const Node *N) const {
+        
+        if (UnnormalizedStarts.empty() || N->kind() != CSTNODEKIND_LEAF) {
+            return false;
+        }
+        
+        auto Start = static_cast<const LeafNode *>(N)->getToken().Src.Start;
+        
+        return std::binary_search(UnnormalizedStarts.begin(), UnnormalizedStarts.end(), Start);
+    }
+    
+    //
+    // isLeafText, but the text of an unnormalized token is not the text that the kernel sees
+    //
+    bool leafText(const Node *N, TokenEnum T, const char *Str) {
+        
+        if (!isLeaf(N, T)) {
+            return false;
+        }
+        
+        if (unnormalized(N)) {
+            TouchedUnnormalized = true;
+        }
+        
+        return isLeafText(N, T, Str);
+    }
+    
+    NodePtr leaf(const SymbolPtr& Tag, BufferAndLength Str, Source Src, bool HasSrc) {
+        return NodePtr(session->arena->make<AbstractLeafNode>(Tag, Str, Src, HasSrc));
+    }
+    
+    //
+    // A string that lives as long as the nodes of the session
+    //
+    BufferAndLength string(const std::string& S) {
+        
+        auto Buf = static_cast<unsigned char *>(session->arena->allocate(S.size(), 1));
+        
+        memcpy(Buf, S.data(), S.size());
+        
+        return BufferAndLength(Buf, S.size());
+    }
+    
+    static BufferAndLength literal(const char *Str) {
+        return BufferAndLength(reinterpret_cast<Buffer>(Str), strlen(Str));
+    }
+    
+    //
+    // ToNode[sym]
+    //
+    NodePtr symbol(const SymbolPtr& Sym) {
+        return leaf(SYMBOL_SYMBOL, literal(Sym->name()), Source(), false);
+    }
+    
+    //
+    // ToNode[n]
+    //
+    NodePtr integer(const char *Str) {
+        return leaf(SYMBOL_INTEGER, literal(Str), Source(), false);
+    }
+    
+    NodePtr call(NodePtr Head, NodeSeq Args, Source Src, bool HasSrc) {
+        
+        NodeSeq H(session, 1);
+        
+        H.append(std::move(Head));
+        
+        return NodePtr(session->arena->make<AbstractCallNode>(std::move(H), std::move(Args), Src, HasSrc));
+    }
+    
+    NodePtr call(const SymbolPtr& Head, NodeSeq Args, Source Src) {
+        return call(symbol(Head), std::move(Args), Src, true);
+    }
+    
+    NodePtr call(const SymbolPtr& Head, NodePtr Arg, Source Src) {
+        
+        NodeSeq Args(session, 1);
+        
+        Args.append(std::move(Arg));
+        
+        return call(Head, std::move(Args), Src);
+    }
+    
+    NodePtr call(const SymbolPtr& Head, NodePtr Arg1, NodePtr Arg2, Source Src) {
+        
+        NodeSeq Args(session, 2);
+        
+        Args.append(std::move(Arg1));
+        Args.append(std::move(Arg2));
+        
+        return call(Head, std::move(Args), Src);
+    }
+    
+    NodePtr fallback(const SymbolPtr& MakeSym, const Node *N) {
+        
+        NodeSeq Args(session, 1);
+        
+        Args.append(NodePtr(const_cast<Node *>(N)));
+        
+        return NodePtr(session->arena->make<AbstractFallbackNode>(MakeSym, std::move(Args)));
+    }
+    
+    //
+    // possiblyNegatedZeroQ
+    //
+    bool possiblyNegatedZero(const Node *N) {
+        
+        while (true) {
+            
+            if (isOperator(N, CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPPAREN)) {
+                
+                auto C = aggregateChildren(N);
+                
+                if (C.size() != 3) {
+                    return false;
+                }
+                
+                N = C[1];
+                
+                continue;
+            }
+            
+            if (isOperator(N, CSTNODEKIND_PREFIX, SYMBOL_MINUS)) {
+                
+                auto C = aggregateChildren(N);
+                
+                if (C.size() != 2) {
+                    return false;
+                }
+                
+                N = C[1];
+                
+                continue;
+            }
+            
+            return leafText(N, TOKEN_INTEGER, "0");
+        }
+    }
+        
+    //
+    // The InfixBinaryAt quirk: in  a + f @ b , the kernel treats  f @ b  specially when f is the same as the operator
+    //
+    // Only checks for the quirk, and the kernel abstracts the node instead. Symbol names are compared both with and
+    // without context
+    //
+    bool infixBinaryAtQuirk(const Node *N, const SymbolPtr& Op) {
+        
+        if (!isOperator(N, CSTNODEKIND_BINARY, SYMBOL_CODEPARSER_BINARYAT)) {
+            return false;
+        }
+        
+        auto C = aggregateChildren(N);
+        
+        if (C.size() != 3) {
+            return false;
+        }
+        
+        auto Name = Op->name();
+        
+        if (leafText(C[0], TOKEN_SYMBOL, Name)) {
+            return true;
+        }
+        
+        auto Backtick = strrchr(Name, '`');
+        
+        if (Backtick && leafText(C[0], TOKEN_SYMBOL, Backtick + 1)) {
+            return true;
+        }
+        
+        return false;
+    }
+    
+    //
+    // negate
+    //
+    NodePtr negateNumber(const Node *N, Source Src) {
+        
+        auto Tok = static_cast<const LeafNode *>(N)->getToken();
+        
+        if (unnormalized(N)) {
+            TouchedUnnormalized = true;
+        }
+        
+        if (isLeafText(N, TOKEN_INTEGER, "0")) {
+            return leaf(SYMBOL_INTEGER, Tok.BufLen, Src, true);
+        }
+        
+        auto& Tag = (Tok.Tok == TOKEN_INTEGER) ? SYMBOL_INTEGER : SYMBOL_REAL;
+        
+        auto Str = std::string("-") + std::string(reinterpret_cast<const char *>(Tok.BufLen.buffer), Tok.BufLen.length());
+        
+        return leaf(Tag, string(Str), Src, true);
+    }
+    
+    NodePtr negate(const Node *N, Source Src) {
+        
+        //
+        // dig down into parens and negated zeros
+        //
+        while (true) {
+            
+            if (isLeaf(N, TOKEN_INTEGER) || isLeaf(N, TOKEN_REAL)) {
+                return negateNumber(N, Src);
+            }
+            
+            if (isOperator(N, CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPPAREN)) {
+                
+                auto C = aggregateChildren(N);
+                
+                if (C.size() == 3 && (possiblyNegatedZero(C[1]) || parenthesizedIntegerOrReal(C[1]))) {
+                    
+                    N = C[1];
+                    
+                    continue;
+                }
+            }
+            
+            if (isOperator(N, CSTNODEKIND_PREFIX, SYMBOL_MINUS)) {
+                
+                auto C = aggregateChildren(N);
+                
+                if (C.size() == 2 && possiblyNegatedZero(C[1])) {
+                    
+                    N = C[1];
+                    
+                    continue;
+                }
+            }
+            
+            break;
+        }
+        
+        NodeSeq Args(session);
+        
+        Args.append(integer("-1"));
+        
+        if (isOperator(N, CSTNODEKIND_INFIX, SYMBOL_TIMES)) {
+            
+            auto C = aggregateChildren(N);
+            
+            if (C.size() % 2 == 0) {
+                return nullptr;
+            }
+            
+            std::vector<const Node *> Operands;
+            
+            for (size_t i = 0; i < C.size(); i += 2) {
+                Operands.push_back(C[i]);
+            }
+            
+            if (!flattenTimes(Operands, Src, true, Args)) {
+                return nullptr;
+            }
+            
+        } else {
+            
+            if (!flattenTimes({N}, Src, true, Args)) {
+                return nullptr;
+            }
+        }
+        
+        return call(SYMBOL_TIMES, std::move(Args), Src);
+    }
+    
+    //
+    // flattenTimes, then processInfixBinaryAtQuirk if Quirk, then abstract
+    //
+    bool flattenTimes(const std::vector<const Node *>& Items, Source Src, bool Quirk, NodeSeq& Args) {
+        
+        for (auto N : Items) {
+            
+            if (isOperator(N, CSTNODEKIND_PREFIX, SYMBOL_MINUS)) {
+                
+                auto C = aggregateChildren(N);
+                
+                if (C.size() == 2 && (isLeaf(C[1], TOKEN_INTEGER) || isLeaf(C[1], TOKEN_REAL) || parenthesizedIntegerOrReal(C[1]))) {
+                    
+                    auto Negated = negate(C[1], Src);
+                    
+                    if (!Negated) {
+                        return false;
+                    }
+                    
+                    Args.append(std::move(Negated));
+                    
+                    continue;
+                }
+            }
+            
+            if (isOperator(N, CSTNODEKIND_INFIX, SYMBOL_TIMES)) {
+                
+                auto C = aggregateChildren(N);
+                
+                if (C.size() % 2 == 0 || Depth == ABSTRACT_MAX_DEPTH) {
+                    return false;
+                }
+                
+                std::vector<const Node *> Operands;
+                
+                for (size_t i = 0; i < C.size(); i += 2) {
+                    Operands.push_back(C[i]);
+                }
+                
+                Depth++;
+                
+                auto Flattened = flattenTimes(Operands, Src, Quirk, Args);
+                
+                Depth--;
+                
+                if (!Flattened) {
+                    return false;
+                }
+                
+                continue;
+            }
+            
+            if (Quirk && infixBinaryAtQuirk(N, SYMBOL_TIMES)) {
+                return false;
+            }
+            
+            Args.append(abstract(N));
+        }
+        
+        return true;
+    }
+    
+    //
+    // abstractGroupNode: abstract the children between the opener and the closer, and splice Commas
+    //
+    bool groupChildren(const std::vector<const Node *>& C, size_t Begin, size_t End, NodeSeq& Args) {
+        
+        for (auto i = Begin; i < End; i++) {
+            
+            auto N = C[i];
+            
+            if (!isOperator(N, CSTNODEKIND_INFIX, SYMBOL_CODEPARSER_COMMA)) {
+                
+                Args.append(abstract(N));
+                
+                continue;
+            }
+            
+            if (!commaChildren(aggregateChildren(N), Args)) {
+                return false;
+            }
+        }
+        
+        return true;
+    }
+    
+    //
+    // abstractComma
+    //
+    bool commaChildren(const std::vector<const Node *>& C, NodeSeq& Args) {
+        
+        if (C.size() % 2 == 0) {
+            return false;
+        }
+        
+        for (size_t i = 0; i < C.size(); i += 2) {
+            
+            if (isLeaf(C[i], TOKEN_FAKE_IMPLICITNULL)) {
+                
+                Args.append(leaf(SYMBOL_SYMBOL, literal(SYMBOL_NULL->name()), C[i]->getSource(), true));
+                
+                continue;
+            }
+            
+            Args.append(abstract(C[i]));
+        }
+        
+        return true;
+    }
+    
+    NodePtr abstractLeaf(const LeafNode *N) {
+        
+        if (unnormalized(N)) {
+            return nullptr;
+        }
+        
+        auto Tok = N->getToken();
+        
+        switch (Tok.Tok.value()) {
+            case TOKEN_UNDER.value(): {
+                return call(SYMBOL_BLANK, NodeSeq(session), Tok.Src);
+            }
+            case TOKEN_UNDERUNDER.value(): {
+                return call(SYMBOL_BLANKSEQUENCE, NodeSeq(session), Tok.Src);
+            }
+            case TOKEN_UNDERUNDERUNDER.value(): {
+                return call(SYMBOL_BLANKNULLSEQUENCE, NodeSeq(session), Tok.Src);
+            }
+            case TOKEN_UNDERDOT.value(): {
+                return call(SYMBOL_OPTIONAL, call(SYMBOL_BLANK, NodeSeq(session), Tok.Src), Tok.Src);
+            }
+            case TOKEN_HASH.value(): {
+                return call(SYMBOL_SLOT, integer("1"), Tok.Src);
+            }
+            case TOKEN_HASHHASH.value(): {
+                return call(SYMBOL_SLOTSEQUENCE, integer("1"), Tok.Src);
+            }
+            case TOKEN_PERCENT.value(): {
+                return call(SYMBOL_OUT, NodeSeq(session), Tok.Src);
+            }
+            case TOKEN_PERCENTPERCENT.value(): {
+                
+                //
+                // %% may also be spelled with escapes such as \.25
+                //
+                for (auto p = Tok.BufLen.buffer; p < Tok.BufLen.end; p++) {
+                    if (*p != '%') {
+                        return nullptr;
+                    }
+                }
+                
+                auto Count = std::string("-") + std::to_string(Tok.BufLen.length());
+                
+                return call(SYMBOL_OUT, leaf(SYMBOL_INTEGER, string(Count), Source(), false), Tok.Src);
+            }
+            case TOKEN_FAKE_IMPLICITONE.value(): {
+                return leaf(SYMBOL_INTEGER, literal("1"), Tok.Src, true);
+            }
+            case TOKEN_FAKE_IMPLICITALL.value(): {
+                return leaf(SYMBOL_SYMBOL, literal(SYMBOL_ALL->name()), Tok.Src, true);
+            }
+            default: {
+                return NodePtr(const_cast<LeafNode *>(N));
+            }
+        }
+    }
+    
+    NodePtr abstractCompound(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() != 2) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        if (Op == SYMBOL_BLANK || Op == SYMBOL_BLANKSEQUENCE || Op == SYMBOL_BLANKNULLSEQUENCE) {
+            return call(Op, abstract(C[1]), Src);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_PATTERNBLANK || Op == SYMBOL_CODEPARSER_PATTERNBLANKSEQUENCE || Op == SYMBOL_CODEPARSER_PATTERNBLANKNULLSEQUENCE) {
+            return call(SYMBOL_PATTERN, abstract(C[0]), abstract(C[1]), Src);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_PATTERNOPTIONALDEFAULT) {
+            
+            if (!isLeaf(C[1], TOKEN_UNDERDOT)) {
+                return nullptr;
+            }
+            
+            auto Blank = call(SYMBOL_BLANK, NodeSeq(session), C[1]->getSource());
+            
+            return call(SYMBOL_OPTIONAL, call(SYMBOL_PATTERN, abstract(C[0]), std::move(Blank), Src), Src);
+        }
+        
+        if (Op == SYMBOL_SLOT || Op == SYMBOL_SLOTSEQUENCE || Op == SYMBOL_OUT) {
+            
+            //
+            // #abc and #"abc" are abstracted to strings by the kernel
+            //
+            if (!isLeaf(C[1], TOKEN_INTEGER)) {
+                return nullptr;
+            }
+            
+            return call(Op, abstract(C[1]), Src);
+        }
+        
+        return nullptr;
+    }
+    
+    NodePtr abstractPrefix(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() != 2) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        if (Op == SYMBOL_MINUS) {
+            return negate(C[1], Src);
+        }
+        
+        if (Op == SYMBOL_PLUS) {
+            
+            //
+            // + +a  is the same as  +a
+            //
+            auto Rand = C[1];
+            
+            while (isOperator(Rand, CSTNODEKIND_PREFIX, SYMBOL_PLUS)) {
+                
+                auto RandC = aggregateChildren(Rand);
+                
+                if (RandC.size() != 2) {
+                    break;
+                }
+                
+                Rand = RandC[1];
+            }
+            
+            return call(SYMBOL_PLUS, abstract(Rand), Src);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_PREFIXNOT2 || Op == SYMBOL_CODEPARSER_PREFIXLINEARSYNTAXBANG) {
+            return nullptr;
+        }
+        
+        if (Op == SYMBOL_GET && isLeaf(C[1], TOKEN_STRING)) {
+            return nullptr;
+        }
+        
+        return call(Op, abstract(C[1]), Src);
+    }
+    
+    NodePtr abstractPostfix(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() != 2) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        if (Op == SYMBOL_HERMITIANCONJUGATE) {
+            return call(SYMBOL_CONJUGATETRANSPOSE, abstract(C[0]), Src);
+        }
+        
+        if (Op == SYMBOL_DERIVATIVE) {
+            
+            if (!isLeaf(C[1], TOKEN_SINGLEQUOTE)) {
+                return nullptr;
+            }
+            
+            //
+            // Collect all of the ' in f'''
+            //
+            size_t Order = 1;
+            
+            auto Body = C[0];
+            
+            while (isOperator(Body, CSTNODEKIND_POSTFIX, SYMBOL_DERIVATIVE)) {
+                
+                auto BodyC = aggregateChildren(Body);
+                
+                if (BodyC.size() != 2) {
+                    break;
+                }
+                
+                Order++;
+                
+                Body = BodyC[0];
+            }
+            
+            auto Derivative = call(symbol(SYMBOL_DERIVATIVE), NodeSeq(session), Source(), false);
+            
+            NodeSeq OrderArgs(session, 1);
+            
+            OrderArgs.append(leaf(SYMBOL_INTEGER, string(std::to_string(Order)), Source(), false));
+            
+            Derivative = call(symbol(SYMBOL_DERIVATIVE), std::move(OrderArgs), Source(), false);
+            
+            NodeSeq BodyArgs(session, 1);
+            
+            BodyArgs.append(abstract(Body));
+            
+            return call(std::move(Derivative), std::move(BodyArgs), Source(), false);
+        }
+        
+        return call(Op, abstract(C[0]), Src);
+    }
+    
+    NodePtr abstractBinary(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() != 3) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        auto Left = C[0];
+        auto Right = C[2];
+        
+        if (Op == SYMBOL_DIVIDE) {
+            
+            //
+            // a / b  is  Times[a, Power[b, -1]]
+            //
+            NodeSeq Args(session);
+            
+            if (!flattenTimes({Left}, Src, false, Args)) {
+                return nullptr;
+            }
+            
+            Args.append(call(SYMBOL_POWER, abstract(Right), integer("-1"), Src));
+            
+            return call(SYMBOL_TIMES, std::move(Args), Src);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_BINARYAT) {
+            
+            NodeSeq Args(session, 1);
+            
+            Args.append(abstract(Right));
+            
+            return call(abstract(Left), std::move(Args), Src, true);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_BINARYATATAT) {
+            
+            NodeSeq Args(session, 3);
+            
+            Args.append(abstract(Left));
+            Args.append(abstract(Right));
+            
+            NodeSeq Level(session, 1);
+            
+            Level.append(integer("1"));
+            
+            Args.append(call(symbol(SYMBOL_LIST), std::move(Level), Source(), false));
+            
+            return call(SYMBOL_APPLY, std::move(Args), Src);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_BINARYSLASHSLASH) {
+            
+            NodeSeq Args(session, 1);
+            
+            Args.append(abstract(Left));
+            
+            return call(abstract(Right), std::move(Args), Src, true);
+        }
+        
+        if ((Op == SYMBOL_PUT || Op == SYMBOL_PUTAPPEND) && isLeaf(Right, TOKEN_STRING)) {
+            return nullptr;
+        }
+        
+        if (Op == SYMBOL_PATTERN && !isLeaf(Left, TOKEN_SYMBOL)) {
+            return nullptr;
+        }
+        
+        if (Op == SYMBOL_PATTERNTEST && isOperator(Left, CSTNODEKIND_BINARY, SYMBOL_PATTERNTEST)) {
+            return nullptr;
+        }
+        
+        if (Op == SYMBOL_UNSET) {
+            return call(SYMBOL_UNSET, abstract(Left), Src);
+        }
+        
+        return call(Op, abstract(Left), abstract(Right), Src);
+    }
+    
+    NodePtr abstractInfix(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() % 2 == 0) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        if (Op == SYMBOL_CODEPARSER_INFIXINEQUALITY || Op == SYMBOL_MESSAGENAME) {
+            return nullptr;
+        }
+        
+        if (Op == SYMBOL_PLUS) {
+            return abstractPlus(C, Src);
+        }
+        
+        std::vector<const Node *> Operands;
+        
+        for (size_t i = 0; i < C.size(); i += 2) {
+            Operands.push_back(C[i]);
+        }
+        
+        if (Op == SYMBOL_TIMES) {
+            
+            NodeSeq Args(session);
+            
+            if (!flattenTimes(Operands, Src, true, Args)) {
+                return nullptr;
+            }
+            
+            return call(SYMBOL_TIMES, std::move(Args), Src);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_COMMA) {
+            
+            NodeSeq Args(session);
+            
+            if (!commaChildren(C, Args)) {
+                return nullptr;
+            }
+            
+            return call(SYMBOL_CODEPARSER_COMMA, std::move(Args), Src);
+        }
+        
+        if (Op == SYMBOL_COMPOUNDEXPRESSION) {
+            
+            NodeSeq Args(session);
+            
+            for (size_t i = 0; i < Operands.size(); i++) {
+                
+                auto O = Operands[i];
+                
+                //
+                // a;b;[]  is a strange call
+                //
+                if (i > 0 && (isOperator(O, CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPSQUARE) || isOperator(O, CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPDOUBLEBRACKET))) {
+                    return nullptr;
+                }
+                
+                if (isLeaf(O, TOKEN_FAKE_IMPLICITNULL)) {
+                    
+                    Args.append(leaf(SYMBOL_SYMBOL, literal(SYMBOL_NULL->name()), O->getSource(), true));
+                    
+                    continue;
+                }
+                
+                Args.append(abstract(O));
+            }
+            
+            return call(SYMBOL_COMPOUNDEXPRESSION, std::move(Args), Src);
+        }
+        
+        //
+        // SameQ and UnsameQ do not participate in the InfixBinaryAt quirk
+        //
+        auto Quirk = !(Op == SYMBOL_SAMEQ || Op == SYMBOL_UNSAMEQ);
+        
+        if (Quirk) {
+            for (auto O : Operands) {
+                if (infixBinaryAtQuirk(O, Op)) {
+                    return nullptr;
+                }
+            }
+        }
+        
+        NodeSeq Args(session, Operands.size());
+        
+        //
+        // make sure to reverse children of Divisible
+        //
+        if (Op == SYMBOL_DIVISIBLE) {
+            
+            for (auto it = Operands.rbegin(); it != Operands.rend(); ++it) {
+                Args.append(abstract(*it));
+            }
+            
+            return call(SYMBOL_DIVISIBLE, std::move(Args), Src);
+        }
+        
+        for (auto O : Operands) {
+            Args.append(abstract(O));
+        }
+        
+        return call(Op, std::move(Args), Src);
+    }
+    
+    //
+    // abstractPlus: a + b - c  is  Plus[a, b, Times[-1, c]]
+    //
+    NodePtr abstractPlus(const std::vector<const Node *>& C, Source Src) {
+        
+        NodeSeq Args(session);
+        
+        for (size_t i = 0; i < C.size(); i += 2) {
+            
+            auto Rand = C[i];
+            
+            if (i > 0) {
+                
+                auto Rator = C[i - 1];
+                
+                if (isLeaf(Rator, TOKEN_MINUS) || isLeaf(Rator, TOKEN_LONGNAME_MINUS)) {
+                    
+                    //
+                    // the Source of  - b
+                    //
+                    auto Negated = negate(Rand, Source(Rator->getSource().Start, Rand->getSource().End));
+                    
+                    if (!Negated) {
+                        return nullptr;
+                    }
+                    
+                    Args.append(std::move(Negated));
+                    
+                    continue;
+                }
+                
+                if (!(isLeaf(Rator, TOKEN_PLUS) || isLeaf(Rator, TOKEN_LONGNAME_IMPLICITPLUS))) {
+                    return nullptr;
+                }
+            }
+            
+            while (isOperator(Rand, CSTNODEKIND_PREFIX, SYMBOL_PLUS)) {
+                
+                auto RandC = aggregateChildren(Rand);
+                
+                if (RandC.size() != 2) {
+                    break;
+                }
+                
+                Rand = RandC[1];
+            }
+            
+            if (infixBinaryAtQuirk(Rand, SYMBOL_PLUS)) {
+                return nullptr;
+            }
+            
+            Args.append(abstract(Rand));
+        }
+        
+        return call(SYMBOL_PLUS, std::move(Args), Src);
+    }
+    
+    NodePtr abstractTernary(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() != 5) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        if (Op == SYMBOL_CODEPARSER_TERNARYTILDE) {
+            
+            if (isOperator(C[2], CSTNODEKIND_INFIX, SYMBOL_CODEPARSER_COMMA)) {
+                return nullptr;
+            }
+            
+            NodeSeq Args(session, 2);
+            
+            Args.append(abstract(C[0]));
+            Args.append(abstract(C[4]));
+            
+            return call(abstract(C[2]), std::move(Args), Src, true);
+        }
+        
+        if (Op == SYMBOL_TAGSET || Op == SYMBOL_TAGSETDELAYED || Op == SYMBOL_SPAN) {
+            
+            NodeSeq Args(session, 3);
+            
+            Args.append(abstract(C[0]));
+            Args.append(abstract(C[2]));
+            Args.append(abstract(C[4]));
+            
+            return call(Op, std::move(Args), Src);
+        }
+        
+        if (Op == SYMBOL_TAGUNSET && isLeaf(C[3], TOKEN_EQUAL) && isLeaf(C[4], TOKEN_DOT)) {
+            return call(SYMBOL_TAGUNSET, abstract(C[0]), abstract(C[2]), Src);
+        }
+        
+        return nullptr;
+    }
+    
+    NodePtr abstractPrefixBinary(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        if (C.size() != 3) {
+            return nullptr;
+        }
+        
+        auto& Op = N->getOp();
+        auto Src = N->getSource();
+        
+        if (Op == SYMBOL_INTEGRATE && (isOperator(C[2], CSTNODEKIND_PREFIX, SYMBOL_DIFFERENTIALD) || isOperator(C[2], CSTNODEKIND_PREFIX, SYMBOL_CAPITALDIFFERENTIALD))) {
+            
+            auto VarC = aggregateChildren(C[2]);
+            
+            if (VarC.size() != 2) {
+                return nullptr;
+            }
+            
+            return call(SYMBOL_INTEGRATE, abstract(C[1]), abstract(VarC[1]), Src);
+        }
+        
+        return call(Op, abstract(C[1]), abstract(C[2]), Src);
+    }
+    
+    NodePtr abstractGroup(const OperatorNode *N, const std::vector<const Node *>& C) {
+        
+        auto& Op = N->getOp();
+        
+        if (Op == SYMBOL_CODEPARSER_GROUPPAREN) {
+            
+            if (C.size() != 3 || isOperator(C[1], CSTNODEKIND_INFIX, SYMBOL_CODEPARSER_COMMA)) {
+                return nullptr;
+            }
+            
+            return abstract(C[1]);
+        }
+        
+        if (Op == SYMBOL_CODEPARSER_GROUPSQUARE || C.size() < 2) {
+            return nullptr;
+        }
+        
+        NodeSeq Args(session);
+        
+        if (!groupChildren(C, 1, C.size() - 1, Args)) {
+            return nullptr;
+        }
+        
+        return call(Op, std::move(Args), N->getSource());
+    }
+    
+    NodePtr abstractCall(const CallNode *N) {
+        
+        std::vector<const Node *> H;
+        
+        N->getHead().aggregate(H);
+        
+        auto B = aggregateChildren(N);
+        
+        if (H.empty() || B.size() != 1 || B[0]->kind() != CSTNODEKIND_GROUP) {
+            return nullptr;
+        }
+        
+        auto Head = H[0];
+        auto Outer = static_cast<const OperatorNode *>(B[0]);
+        auto OuterC = aggregateChildren(Outer);
+        
+        if (OuterC.size() < 2) {
+            return nullptr;
+        }
+        
+        if (Outer->getOp() == SYMBOL_CODEPARSER_GROUPSQUARE) {
+            
+            if (OuterC.size() == 3 && isOperator(OuterC[1], CSTNODEKIND_GROUP, SYMBOL_CODEPARSER_GROUPSQUARE)) {
+                
+                //
+                // a[[1]]
+                //
+                auto Inner = OuterC[1];
+                auto InnerC = aggregateChildren(Inner);
+                
+                if (InnerC.size() < 2) {
+                    return nullptr;
+                }
+                
+                //
+                // The kernel warns about  a[ [1] ] , and only checks with LineColumn
+                //
+                auto OuterSrc = Outer->getSource();
+                auto InnerSrc = Inner->getSource();
+                
+                if (OuterSrc.Start.first != 0) {
+                    
+                    if (OuterSrc.Start.second + 1 != InnerSrc.Start.second || InnerSrc.End.second + 1 != OuterSrc.End.second) {
+                        return nullptr;
+                    }
+                }
+                
+                return abstractPart(N, Head, InnerC);
+            }
+            
+            //
+            // f[x]
+            //
+            if (!callHead(Head)) {
+                return nullptr;
+            }
+            
+            NodeSeq Args(session);
+            
+            if (!groupChildren(OuterC, 1, OuterC.size() - 1, Args)) {
+                return nullptr;
+            }
+            
+            return call(abstract(Head), std::move(Args), N->getSource(), true);
+        }
+        
+        if (Outer->getOp() == SYMBOL_CODEPARSER_GROUPDOUBLEBRACKET) {
+            
+            //
+            // a\[LeftDoubleBracket]1\[RightDoubleBracket]
+            //
+            return abstractPart(N, Head, OuterC);
+        }
+        
+        return nullptr;
+    }
+    
+    //
+    // Part[head, args], where C is the group with the args
+    //
+    NodePtr abstractPart(const CallNode *N, const Node *Head, const std::vector<const Node *>& C) {
+        
+        if (!partHead(Head)) {
+            return nullptr;
+        }
+        
+        NodeSeq Args(session);
+        
+        Args.append(abstract(Head));
+        
+        if (!groupChildren(C, 1, C.size() - 1, Args)) {
+            return nullptr;
+        }
+        
+        return call(SYMBOL_PART, std::move(Args), N->getSource());
+    }
+    
+    //
+    // The heads that Part is not strange for
+    //
+    static bool partHead(const Node *Head) {
+        
+        switch (Head->kind()) {
+            case CSTNODEKIND_LEAF: {
+                return isLeaf(Head, TOKEN_SYMBOL) || isLeaf(Head, TOKEN_HASH) || isLeaf(Head, TOKEN_UNDER) ||
+                    isLeaf(Head, TOKEN_UNDERUNDER) || isLeaf(Head, TOKEN_UNDERUNDERUNDER);
+            }
+            case CSTNODEKIND_CALL: {
+                return true;
+            }
+            case CSTNODEKIND_COMPOUND: {
+                
+                auto& Op = static_cast<const OperatorNode *>(Head)->getOp();
+                
+                return Op == SYMBOL_BLANK || Op == SYMBOL_BLANKSEQUENCE || Op == SYMBOL_BLANKNULLSEQUENCE ||
+                    Op == SYMBOL_CODEPARSER_PATTERNBLANK || Op == SYMBOL_CODEPARSER_PATTERNBLANKSEQUENCE ||
+                    Op == SYMBOL_CODEPARSER_PATTERNBLANKNULLSEQUENCE || Op == SYMBOL_SLOT;
+            }
+            case CSTNODEKIND_INFIX: {
+                return isOperator(Head, CSTNODEKIND_INFIX, SYMBOL_COMPOUNDEXPRESSION);
+            }
+            case CSTNODEKIND_GROUP: {
+                
+                auto& Op = static_cast<const OperatorNode *>(Head)->getOp();
+                
+                return Op == SYMBOL_CODEPARSER_GROUPPAREN || Op == SYMBOL_LIST || Op == SYMBOL_ASSOCIATION;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+    
+    //
+    // The heads that a call is not strange for
+    //
+    static bool callHead(const Node *Head) {
+        
+        if (isLeaf(Head, TOKEN_STRING)) {
+            return true;
+        }
+        
+        if (isOperator(Head, CSTNODEKIND_BINARY, SYMBOL_PATTERNTEST)) {
+            return true;
+        }
+        
+        if (isOperator(Head, CSTNODEKIND_POSTFIX, SYMBOL_FUNCTION) || isOperator(Head, CSTNODEKIND_POSTFIX, SYMBOL_DERIVATIVE)) {
+            return true;
+        }
+        
+        return partHead(Head);
+    }
+    
+    NodePtr abstract0(const Node *N) {
+        
+        switch (N->kind()) {
+            case CSTNODEKIND_LEAF: {
+                return abstractLeaf(static_cast<const LeafNode *>(N));
+            }
+            case CSTNODEKIND_CALL: {
+                return abstractCall(static_cast<const CallNode *>(N));
+            }
+            case CSTNODEKIND_PREFIX: {
+                return abstractPrefix(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_BINARY: {
+                return abstractBinary(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_INFIX: {
+                return abstractInfix(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_TERNARY: {
+                return abstractTernary(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_POSTFIX: {
+                return abstractPostfix(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_PREFIXBINARY: {
+                return abstractPrefixBinary(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_GROUP: {
+                return abstractGroup(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            case CSTNODEKIND_COMPOUND: {
+                return abstractCompound(static_cast<const OperatorNode *>(N), aggregateChildren(N));
+            }
+            default: {
+                //
+                // errors
+                //
+                return nullptr;
+            }
+        }
+    }
+    
+public:
+    
+    Abstracter(ParserSession *session, std::vector<SourceLocation> UnnormalizedStarts) : session(session), Depth(0), UnnormalizedStarts(std::move(UnnormalizedStarts)), TouchedUnnormalized(false) {}
+    
+    //
+    // Never fails: any node that is not handled is given to the kernel
+    //
+    NodePtr abstract(const Node *N) {
+        
+        if (Depth == ABSTRACT_MAX_DEPTH) {
+            return fallback(SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTFALLBACKNODE, N);
+        }
+        
+        //
+        // Only the text that the rule for N looks at counts, the rules for the children say for themselves
+        //
+        auto OuterTouched = TouchedUnnormalized;
+        
+        TouchedUnnormalized = false;
+        
+        Depth++;
+        
+        auto A = abstract0(N);
+        
+        Depth--;
+        
+        if (TouchedUnnormalized) {
+            A = nullptr;
+        }
+        
+        TouchedUnnormalized = OuterTouched;
+        
+        if (!A) {
+            return fallback(SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTFALLBACKNODE, N);
+        }
+        
+        return A;
+    }
+    
+    //
+    // The kernel gives the issues for strange top-level nodes in files, so give it anything that is not benign
+    //
+    NodePtr abstractTopLevel(const Node *N, bool ReportIssues) {
+        
+        if (ReportIssues && !topLevelBenign(N)) {
+            return fallback(SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTTOPLEVELFALLBACKNODE, N);
+        }
+        
+        return abstract(N);
+    }
+};
+
+Node *abstractExpressions(ParserSession *session, Node *Parsed) {
+    
+    auto& Nodes = static_cast<ListNode *>(Parsed)->getNodes();
+    
+    assert(Nodes.size() == 6);
+    
+    auto Collected = static_cast<const CollectedExpressionsNode *>(Nodes[0].get());
+    
+    auto& Exprs = Collected->getExpressions();
+    
+    //
+    // Line continuations and embedded newlines and tabs are removed by the kernel, so leave the tokens that have them
+    // to the kernel
+    //
+    std::vector<SourceLocation> UnnormalizedStarts;
+    
+    for (size_t i = 2; i < 6; i++) {
+        
+        auto& Locs = static_cast<const CollectedSourceLocationsNode *>(Nodes[i].get())->getSourceLocations();
+        
+        UnnormalizedStarts.insert(UnnormalizedStarts.end(), Locs.begin(), Locs.end());
+    }
+    
+    std::sort(UnnormalizedStarts.begin(), UnnormalizedStarts.end());
+    
+    Abstracter A(session, std::move(UnnormalizedStarts));
+    
+    auto ReportIssues = ((session->policy & REPORT_TOPLEVEL_ISSUES) == REPORT_TOPLEVEL_ISSUES);
+    
+    std::vector<const Node *> TopLevel;
+    
+    for (auto& E : Exprs) {
+        E->aggregate(TopLevel);
+    }
+    
+    std::vector<NodePtr> Abstracted;
+    
+    for (auto N : TopLevel) {
+        Abstracted.push_back(A.abstractTopLevel(N, ReportIssues));
+    }
+    
+    std::vector<NodePtr> L;
+    
+    L.push_back(NodePtr(session->arena->makeOwned<CollectedExpressionsNode>(std::move(Abstracted))));
+    
+    for (size_t i = 1; i < 6; i++) {
+        L.push_back(NodePtr(Nodes[i].get()));
+    }
+    
+    Source Src;
+    
+    if (!Exprs.empty()) {
+        Src = Source(Exprs.front()->getSource(), Exprs.back()->getSource());
+    }
+    
+    L.push_back(NodePtr(session->arena->make<AbstractContainerSourceNode>(Src, Exprs.empty())));
+    
+    return session->arena->makeOwned<ListNode>(std::move(L));
+}
+
+
+#if USE_MATHLINK
+void AbstractLeafNode::put(ParserSession *session, MLINK mlp) const {
+    
+    if (HasSrc) {
+        
+        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), static_cast<int>(2 + 4))) {
+            assert(false);
+        }
+        
+    } else {
+        
+        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTLEAFNODE->name(), static_cast<int>(2))) {
+            assert(false);
+        }
+    }
+    
+    if (!MLPutSymbol(mlp, Tag->name())) {
+        assert(false);
+    }
+    
+    Str.putUTF8String(mlp);
+    
+    if (HasSrc) {
+        Src.put(mlp);
+    }
+}
+
+void AbstractCallNode::putOpen(ParserSession *session, MLINK mlp, size_t i) const {
+    
+    if (i == 0) {
+        
+        if (HasSrc) {
+            
+            if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name(), static_cast<int>(2 + 4))) {
+                assert(false);
+            }
+            
+            return;
+        }
+        
+        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTCALLNODE->name(), static_cast<int>(2))) {
+            assert(false);
+        }
+        
+        return;
+    }
+    
+    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Children.size()))) {
+        assert(false);
+    }
+}
+
+void AbstractCallNode::putClose(ParserSession *session, MLINK mlp) const {
+    
+    if (HasSrc) {
+        Src.put(mlp);
+    }
+}
+
+void AbstractFallbackNode::putOpen(ParserSession *session, MLINK mlp, size_t i) const {
+    
+    if (!MLPutFunction(mlp, MakeSym->name(), static_cast<int>(Children.size()))) {
+        assert(false);
+    }
+}
+
+void AbstractContainerSourceNode::put(ParserSession *session, MLINK mlp) const {
+    
+    if (Empty) {
+        
+        if (!MLPutFunction(mlp, SYMBOL_LIST->name(), 0)) {
+            assert(false);
+        }
+        
+        return;
+    }
+    
+    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTSOURCE->name(), static_cast<int>(4))) {
+        assert(false);
+    }
+    
+    Src.put(mlp);
+}
+#endif // USE_MATHLINK
+
+#if USE_EXPR_LIB
+void AbstractLeafNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    if (HasSrc) {
+        
+        B.function(SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), 2 + 4);
+        
+    } else {
+        
+        B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTLEAFNODE->name(), 2);
+    }
+    
+    B.symbol(Tag->name());
+    
+    Str.toExprUTF8String(B);
+    
+    if (HasSrc) {
+        Src.toExpr(B);
+    }
+}
+
+void AbstractCallNode::toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const {
+    
+    if (i == 0) {
+        
+        if (HasSrc) {
+            
+            B.function(SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name(), 2 + 4);
+            
+            return;
+        }
+        
+        B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTCALLNODE->name(), 2);
+        
+        return;
+    }
+    
+    B.function(SYMBOL_LIST->name(), Children.size());
+}
+
+void AbstractCallNode::toExprClose(ParserSession *session, ExprBuilder& B) const {
+    
+    if (HasSrc) {
+        Src.toExpr(B);
+    }
+}
+
+void AbstractFallbackNode::toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const {
+    
+    B.function(MakeSym->name(), Children.size());
+}
+
+void AbstractContainerSourceNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    if (Empty) {
+        
+        B.function(SYMBOL_LIST->name(), 0);
+        
+        return;
+    }
+    
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTSOURCE->name(), 4);
+    
+    Src.toExpr(B);
+}
+#endif // USE_EXPR_LIB
+
+
+void AbstractLeafNode::print(ParserSession *session, std::ostream& s) const {
+    
+    if (HasSrc) {
+        s << SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name() << "[";
+    } else {
+        s << SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTLEAFNODE->name() << "[";
+    }
+    
+    s << Tag->name();
+    s << ", ";
+    
+    Str.printUTF8String(s);
+    
+    if (HasSrc) {
+        
+        s << ", ";
+        
+        Src.print(s);
+    }
+    
+    s << "]";
+}
+
+const NodeSeq* AbstractCallNode::childSeq(size_t i) const {
+    
+    if (i == 0) {
+        return &Head;
+    }
+    
+    if (i == 1) {
+        return &Children;
+    }
+    
+    return nullptr;
+}
+
+void AbstractCallNode::printOpen(ParserSession *session, std::ostream& s, size_t i) const {
+    
+    if (i == 0) {
+        
+        if (HasSrc) {
+            s << SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name() << "[";
+        } else {
+            s << SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTCALLNODE->name() << "[";
+        }
+        
+        return;
+    }
+    
+    s << SYMBOL_LIST->name() << "[";
+}
+
+void AbstractCallNode::printClose(ParserSession *session, std::ostream& s) const {
+    
+    s << "]";
+    
+    if (HasSrc) {
+        
+        s << ", ";
+        
+        Src.print(s);
+    }
+    
+    s << "]";
+}
+
+void AbstractFallbackNode::printOpen(ParserSession *session, std::ostream& s, size_t i) const {
+    
+    s << MakeSym->name() << "[";
+}
+
+void AbstractFallbackNode::printClose(ParserSession *session, std::ostream& s) const {
+    
+    s << "]";
+}
+
+void AbstractContainerSourceNode::print(ParserSession *session, std::ostream& s) const {
+    
+    if (Empty) {
+        
+        s << SYMBOL_LIST->name() << "[]";
+        
+        return;
+    }
+    
+    s << SYMBOL_CODEPARSER_LIBRARY_MAKEABSTRACTSOURCE->name() << "[";
+    
+    Src.print(s);
+    
+    s << "]";
+}
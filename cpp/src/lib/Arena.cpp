@@ -0,0 +1,117 @@
+
+#include "Arena.h"
+
+const size_t Arena::DEFAULT_CHUNK_SIZE;
+const size_t Arena::LARGE_ALLOCATION_SIZE;
+
+Arena::Arena() : chunks(), large(), current(), ptr(), end(), destructors(), allocationCount(), chunkAllocationCount() {}
+
+Arena::~Arena() {
+    
+    reset();
+}
+
+void *Arena::allocateSlow(size_t size, size_t align) {
+    
+    if (size > LARGE_ALLOCATION_SIZE) {
+        
+        large.push_back(std::unique_ptr<unsigned char[]>(new unsigned char[size + align]));
+        
+        chunkAllocationCount++;
+        
+        auto base = large.back().get();
+        
+        return reinterpret_cast<unsigned char *>((reinterpret_cast<uintptr_t>(base) + (align - 1)) & ~static_cast<uintptr_t>(align - 1));
+    }
+    
+    //
+    // Move on to the next chunk that was kept from before a reset, or make a new one
+    //
+    while (true) {
+        
+        if (ptr) {
+            current++;
+        }
+        
+        if (current >= chunks.size()) {
+            break;
+        }
+        
+        auto& C = chunks[current];
+        
+        ptr = C.data.get();
+        end = ptr + C.size;
+        
+        auto p = reinterpret_cast<unsigned char *>((reinterpret_cast<uintptr_t>(ptr) + (align - 1)) & ~static_cast<uintptr_t>(align - 1));
+        
+        if (p <= end && size <= static_cast<size_t>(end - p)) {
+            
+            ptr = p + size;
+            
+            return p;
+        }
+    }
+    
+    auto chunkSize = DEFAULT_CHUNK_SIZE;
+    
+    chunks.push_back(Chunk{std::unique_ptr<unsigned char[]>(new unsigned char[chunkSize]), chunkSize});
+    
+    chunkAllocationCount++;
+    
+    current = chunks.size() - 1;
+    
+    ptr = chunks[current].data.get();
+    end = ptr + chunkSize;
+    
+    auto p = reinterpret_cast<unsigned char *>((reinterpret_cast<uintptr_t>(ptr) + (align - 1)) & ~static_cast<uintptr_t>(align - 1));
+    
+    ptr = p + size;
+    
+    return p;
+}
+
+void Arena::reset() {
+    
+    //
+    // Destroy in reverse order of construction
+    //
+    for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+        it->destroy(it->obj);
+    }
+    
+    destructors.clear();
+    
+    large.clear();
+    
+    current = 0;
+    
+    if (chunks.empty()) {
+        
+        ptr = nullptr;
+        end = nullptr;
+        
+        return;
+    }
+    
+    ptr = chunks[0].data.get();
+    end = ptr + chunks[0].size;
+}
+
+size_t Arena::getAllocationCount() const {
+    return allocationCount;
+}
+
+size_t Arena::getChunkAllocationCount() const {
+    return chunkAllocationCount;
+}
+
+size_t Arena::getCapacity() const {
+    
+    size_t accum = 0;
+    
+    for (auto& C : chunks) {
+        accum += C.size;
+    }
+    
+    return accum;
+}
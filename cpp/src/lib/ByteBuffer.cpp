@@ -1,7 +1,27 @@
 
 #include "ByteBuffer.h"
 
-ByteBuffer::ByteBuffer() : origBufAndLen(), libData(), buffer(), end(), wasEOF() {}
+#include "API.h" // for ParserSession
+
+#if USE_AVX2
+#include <immintrin.h>
+#define PLAIN_ASCII_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PLAIN_ASCII_SSE2 1
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h> // for _BitScanForward
+#endif
+
+ByteBuffer::ByteBuffer(ParserSession *session) : session(session), origBufAndLen(), libData(), progressMark(), lastProgress(), buffer(), end(), wasEOF() {}
+
+//
+// Large enough that progress() costs nothing next to reading the bytes, and small enough that an abort inside of a
+// long token is still seen quickly
+//
+static const size_t PROGRESS_INTERVAL = 64 * 1024;
 
 void ByteBuffer::init(BufferAndLength bufAndLenIn, WolframLibraryData libDataIn) {
   
@@ -14,6 +34,10 @@ void ByteBuffer::init(BufferAndLength bufAndLenIn, WolframLibraryData libDataIn)
     end = origBufAndLen.end;
     
     wasEOF = false;
+    
+    lastProgress = 0;
+    
+    progressMark = (origBufAndLen.length() > PROGRESS_INTERVAL) ? buffer + PROGRESS_INTERVAL : end;
 }
 
 
@@ -24,15 +48,6 @@ unsigned char ByteBuffer::nextByte0() {
     
     assert((origBufAndLen.buffer <= buffer && buffer <= end) && "Fix at call site");
     
-#if 0
-#ifndef NDEBUG
-    size_t oldProgress;
-    if (origBufAndLen.length() != 0) {
-        oldProgress = (100 * (buffer - origBufAndLen.buffer) / origBufAndLen.length());
-    }
-#endif // NDEBUG
-#endif // #if 0
-    
     if (buffer == end) {
         
         wasEOF = true;
@@ -43,46 +58,10 @@ unsigned char ByteBuffer::nextByte0() {
     auto b = *buffer;
     ++buffer;
     
-#if 0
-#ifndef NDEBUG
-    if (origBufAndLen.length() != 0) {
-        
-        size_t progress = (100 * (buffer - origBufAndLen.buffer) / origBufAndLen.length());
-        
-        if (progress != oldProgress) {
-            if (libData) {
-#if USE_MATHLINK
-                MLINK link = libData->getMathLink(libData);
-                if (!MLPutFunction(link, "EvaluatePacket", 1)) {
-                    assert(false);
-                }
-                if (!MLPutFunction(link, "CodeParser`Library`SetConcreteParseProgress", 1)) {
-                    assert(false);
-                }
-                if (!MLPutInteger(link, static_cast<int>(progress))) {
-                    assert(false);
-                }
-                if (libData->processMathLink(link)) {
-                    //
-                    // Do not assert here, Abort may cause error code
-                    //
-                    
-                    auto pkt = MLNextPacket(link);
-                    if (pkt == RETURNPKT) {
-                        if(!MLNewPacket(link)) {
-                            assert(false);
-                        }
-                    } else {
-                        assert(false);
-                    }
-                }
-#endif // USE_MATHLINK
-            }
-        }
+    if (buffer >= progressMark) {
+        progress();
     }
-#endif // NDEBUG
-#endif // #if 0
-    
+        
     //
     // if eof, then force 0xff to be returned
     //
@@ -92,20 +71,11 @@ unsigned char ByteBuffer::nextByte0() {
     //return b | ((*eof ^ 0xff) - 0xff);
     return b;
 }
-
+        
 void ByteBuffer::nextByte() {
     
     assert((origBufAndLen.buffer <= buffer && buffer <= end) && "Fix at call site");
     
-#if 0
-#ifndef NDEBUG
-    size_t oldProgress;
-    if (origBufAndLen.length() != 0) {
-        oldProgress = (100 * (buffer - origBufAndLen.buffer) / origBufAndLen.length());
-    }
-#endif // NDEBUG
-#endif // #if 0
-    
     if (buffer == end) {
         
         return;
@@ -113,45 +83,62 @@ void ByteBuffer::nextByte() {
     
     ++buffer;
     
-#if 0
-#ifndef NDEBUG
-    if (origBufAndLen.length() != 0) {
-        
-        size_t progress = (100 * (buffer - origBufAndLen.buffer) / origBufAndLen.length());
-        
-        if (progress != oldProgress) {
-            if (libData) {
+    if (buffer >= progressMark) {
+        progress();
+    }
+}
+
+void ByteBuffer::progress() {
+    
+    //
+    // buffer may have been moved past progressMark by the tokenizer skipping plain ASCII
+    //
+    progressMark = (static_cast<size_t>(end - buffer) > PROGRESS_INTERVAL) ? buffer + PROGRESS_INTERVAL : end;
+    
+    //
+    // The end is reached by every input, and the caller sets $ConcreteParseProgress to 100 itself, so small inputs
+    // never call back into the kernel
+    //
+    if (buffer == end) {
+        return;
+    }
+    
+#if !NABORT
+    session->pollAbort();
+#endif // !NABORT
+    
+    auto p = (100 * static_cast<size_t>(buffer - origBufAndLen.buffer) / origBufAndLen.length());
+    
+    if (p == lastProgress) {
+        return;
+    }
+    
+    lastProgress = p;
+    
+    if (!libData) {
+        return;
+    }
+    
 #if USE_MATHLINK
-                MLINK link = libData->getMathLink(libData);
-                if (!MLPutFunction(link, "EvaluatePacket", 1)) {
-                    assert(false);
-                }
-                if (!MLPutFunction(link, "CodeParser`Library`SetConcreteParseProgress", 1)) {
-                    assert(false);
-                }
-                if (!MLPutInteger(link, static_cast<int>(progress))) {
-                    assert(false);
-                }
-                if (libData->processMathLink(link)) {
-                    //
-                    // Do not assert here, Abort may cause error code
-                    //
-                    
-                    auto pkt = MLNextPacket(link);
-                    if (pkt == RETURNPKT) {
-                        if(!MLNewPacket(link)) {
-                            assert(false);
-                        }
-                    } else {
-                        assert(false);
-                    }
-                }
-#endif // USE_MATHLINK
-            }
-        }
+    MLINK link = libData->getMathLink(libData);
+    if (!MLPutFunction(link, "EvaluatePacket", 1)) {
+        assert(false);
     }
-#endif // NDEBUG
-#endif // #if 0
+    if (!MLPutFunction(link, "CodeParser`Library`SetConcreteParseProgress", 1)) {
+        assert(false);
+    }
+    if (!MLPutInteger(link, static_cast<int>(p))) {
+        assert(false);
+    }
+    //
+    // Do not assert here, an abort during the evaluation may fail the link or end it without a ReturnPacket
+    //
+    if (!libData->processMathLink(link) || !drainToReturnPacket(link)) {
+#if !NABORT
+        session->abort();
+#endif // !NABORT
+    }
+#endif // USE_MATHLINK
 }
 
 unsigned char ByteBuffer::currentByte() {
@@ -166,4 +153,93 @@ unsigned char ByteBuffer::currentByte() {
     return *buffer;
 }
 
-ByteBufferPtr TheByteBuffer = nullptr;
+#if PLAIN_ASCII_AVX2 || PLAIN_ASCII_SSE2
+//
+// Index of lowest set bit, mask must be non-zero
+//
+static inline int lowestBit(uint32_t mask) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward(&idx, mask);
+    return static_cast<int>(idx);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+#endif // PLAIN_ASCII_AVX2 || PLAIN_ASCII_SSE2
+
+Buffer ByteBuffer::plainASCIIEnd(Buffer p, Buffer e, unsigned char stop1, unsigned char stop2) {
+    
+    //
+    // Compare as signed bytes, so that 0x80 - 0xff are negative and fail the > 0x1f test
+    //
+    
+#if PLAIN_ASCII_AVX2
+    
+    const auto lo = _mm256_set1_epi8(0x1f);
+    const auto hi = _mm256_set1_epi8(0x7f);
+    const auto s1 = _mm256_set1_epi8(static_cast<char>(stop1));
+    const auto s2 = _mm256_set1_epi8(static_cast<char>(stop2));
+    
+    while (e - p >= 32) {
+        
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        
+        auto plain = _mm256_and_si256(_mm256_cmpgt_epi8(v, lo), _mm256_cmpgt_epi8(hi, v));
+        auto stop = _mm256_or_si256(_mm256_cmpeq_epi8(v, s1), _mm256_cmpeq_epi8(v, s2));
+        
+        auto mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_andnot_si256(stop, plain)));
+        
+        if (mask != 0) {
+            return p + lowestBit(mask);
+        }
+        
+        p += 32;
+    }
+    
+#elif PLAIN_ASCII_SSE2
+    
+    const auto lo = _mm_set1_epi8(0x1f);
+    const auto hi = _mm_set1_epi8(0x7f);
+    const auto s1 = _mm_set1_epi8(static_cast<char>(stop1));
+    const auto s2 = _mm_set1_epi8(static_cast<char>(stop2));
+    
+    while (e - p >= 16) {
+        
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        
+        auto plain = _mm_and_si128(_mm_cmpgt_epi8(v, lo), _mm_cmpgt_epi8(hi, v));
+        auto stop = _mm_or_si128(_mm_cmpeq_epi8(v, s1), _mm_cmpeq_epi8(v, s2));
+        
+        auto mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_andnot_si128(stop, plain))) ^ 0xffff;
+        
+        if (mask != 0) {
+            return p + lowestBit(mask);
+        }
+        
+        p += 16;
+    }
+    
+#endif // PLAIN_ASCII_AVX2
+    
+    //
+    // Tail, or everything if there is no SIMD
+    //
+    return plainASCIIEnd_scalar(p, e, stop1, stop2);
+}
+
+Buffer ByteBuffer::plainASCIIEnd_scalar(Buffer p, Buffer e, unsigned char stop1, unsigned char stop2) {
+    
+    while (p < e) {
+        
+        auto b = *p;
+        
+        if (b < 0x20 || b > 0x7e || b == stop1 || b == stop2) {
+            return p;
+        }
+        
+        ++p;
+    }
+    
+    return p;
+}
@@ -1,14 +1,14 @@
 
 #include "ByteDecoder.h"
 
-#include "ByteBuffer.h" // for TheByteBuffer
+#include "ByteBuffer.h" // for ByteBuffer
+#include "API.h" // for ParserSession
 #include "Utils.h" // for isMBNonCharacter, etc.
 #include "CodePoint.h" // for CODEPOINT_REPLACEMENT_CHARACTER, CODEPOINT_CRLF, etc.
-#include "LongNames.h"
 
-ByteDecoder::ByteDecoder() : Issues(), status(), srcConventionManager(), lastBuf(), lastLoc(), SrcLoc() {}
+ByteDecoder::ByteDecoder(ParserSession *session) : session(session), Issues(), status(), srcConvention(), TabWidth(), trackSource(), lastBuf(), lastLoc(), SrcLoc(), furthest() {}
 
-void ByteDecoder::init(SourceConvention srcConvention, uint32_t TabWidth) {
+void ByteDecoder::init(SourceConvention srcConventionIn, uint32_t TabWidthIn) {
     
     Issues.clear();
     
@@ -17,19 +17,44 @@ void ByteDecoder::init(SourceConvention srcConvention, uint32_t TabWidth) {
     lastBuf = nullptr;
     lastLoc = SourceLocation();
     
+    furthest = session->byteBuffer->buffer;
+    
+    srcConvention = srcConventionIn;
+    TabWidth = TabWidthIn;
+    
+    //
+    // Nodes, issues, and the collected locations are what need SourceLocations
+    //
+    auto policy = session->policy;
+    
+    trackSource = ((policy & INCLUDE_SOURCE) == INCLUDE_SOURCE);
+#if !NISSUES
+    trackSource |= ((policy & SKIP_ISSUES) != SKIP_ISSUES);
+#endif // !NISSUES
+    trackSource |= ((policy & SKIP_EMBEDDED_NEWLINES_AND_TABS) != SKIP_EMBEDDED_NEWLINES_AND_TABS);
+    trackSource |= ((policy & SKIP_LINE_CONTINUATIONS) != SKIP_LINE_CONTINUATIONS);
+    
+    if (!trackSource) {
+        
+        //
+        // Every token is at 0:0, which is also what the asserts in Token treat as having no columns to check
+        //
+        SrcLoc = SourceLocation(0, 0);
+        
+        return;
+    }
+    
     switch (srcConvention) {
         case SOURCECONVENTION_LINECOLUMN:
-            srcConventionManager = SourceConventionManagerPtr(new LineColumnManager(TabWidth));
+            SrcLoc = LineColumnManager::newSourceLocation();
             break;
         case SOURCECONVENTION_SOURCECHARACTERINDEX:
-            srcConventionManager = SourceConventionManagerPtr(new SourceCharacterIndexManager());
+            SrcLoc = SourceCharacterIndexManager::newSourceLocation();
             break;
         case SOURCECONVENTION_UNKNOWN:
             assert(false);
             break;
     }
-    
-    SrcLoc = srcConventionManager->newSourceLocation();
 }
 
 void ByteDecoder::deinit() {
@@ -37,6 +62,18 @@ void ByteDecoder::deinit() {
     Issues.clear();
 }
 
+SourceConvention ByteDecoder::getSourceConvention() const {
+    return srcConvention;
+}
+
+uint32_t ByteDecoder::getTabWidth() const {
+    return TabWidth;
+}
+
+bool ByteDecoder::getTrackSource() const {
+    return trackSource;
+}
+
 //
 // https://unicodebook.readthedocs.io/issues.html#strict-utf8-decoder
 //
@@ -61,12 +98,46 @@ void ByteDecoder::deinit() {
 // U+100000..U+10FFFF        F4      80..8F      80..BF      80..BF
 //
 SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
+    
+    auto c = SourceCharacter(CODEPOINT_ASSERTFALSE);
+    
+    if (!trackSource) {
+        
+        c = nextSourceCharacter0<NoSourceManager>(policy);
+        
+    } else {
+        
+        switch (srcConvention) {
+            case SOURCECONVENTION_LINECOLUMN:
+                c = nextSourceCharacter0<LineColumnManager>(policy);
+                break;
+            case SOURCECONVENTION_SOURCECHARACTERINDEX:
+                c = nextSourceCharacter0<SourceCharacterIndexManager>(policy);
+                break;
+            default:
+                assert(false);
+                c = nextSourceCharacter0<LineColumnManager>(policy);
+                break;
+        }
+    }
+    
+    if (session->byteBuffer->buffer > furthest) {
+        furthest = session->byteBuffer->buffer;
+    }
+    
+    return c;
+}
+
+template <typename SourceConventionManager>
+SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
+    
+    const auto srcConventionManager = makeSourceConventionManager<SourceConventionManager>(TabWidth);
 
 #if !NISSUES
     auto currentSourceCharacterStartLoc = SrcLoc;
 #endif // !NISSUES
     
-    auto firstByte = TheByteBuffer->nextByte0();
+    auto firstByte = session->byteBuffer->nextByte0();
     
     switch (firstByte) {
             //
@@ -74,16 +145,16 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             //
         case 0x0d: {
             
-            if (TheByteBuffer->currentByte() == 0x0a) {
+            if (session->byteBuffer->currentByte() == 0x0a) {
                 
-                TheByteBuffer->nextByte();
+                session->byteBuffer->nextByte();
                 
-                srcConventionManager->windowsNewline(SrcLoc);
+                srcConventionManager.windowsNewline(SrcLoc);
                 
                 return SourceCharacter(CODEPOINT_CRLF);
             }
             
-            srcConventionManager->newline(SrcLoc);
+            srcConventionManager.newline(SrcLoc);
             
 #if !NISSUES
             if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
@@ -92,7 +163,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // No CodeAction here
                 //
                 
-                auto I = IssuePtr(new EncodingIssue(ENCODINGISSUETAG_UNEXPECTEDCARRIAGERETURN, "Unexpected ``\\r`` character.", ENCODINGISSUESEVERITY_ERROR, Source(currentSourceCharacterStartLoc), 1.0, {}));
+                auto I = Issue(ISSUEKIND_ENCODING, ENCODINGISSUETAG_UNEXPECTEDCARRIAGERETURN, ISSUEMESSAGE_UNEXPECTEDCARRIAGERETURN, ENCODINGISSUESEVERITY_ERROR, Source(currentSourceCharacterStartLoc), 1.0);
                 
                 addIssue(std::move(I));
             }
@@ -105,14 +176,14 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             //
         case 0x0a:
             
-            srcConventionManager->newline(SrcLoc);
+            srcConventionManager.newline(SrcLoc);
             
             return SourceCharacter('\n');
         case 0x09:
             
             // Handle TAB specially
             
-            srcConventionManager->tab(SrcLoc);
+            srcConventionManager.tab(SrcLoc);
             
             return SourceCharacter(firstByte);
             
@@ -129,7 +200,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             
             const auto decoded = firstByte;
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -163,7 +234,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             
             // Valid
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
             const auto decoded = firstByte;
             
@@ -182,13 +253,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
                 
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -207,8 +278,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -218,7 +289,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             
             const auto decoded = (((firstByte & 0x1f) << 6) | (tmp & 0x3f));
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -251,13 +322,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -276,23 +347,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -304,8 +375,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -319,7 +390,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             }
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -353,13 +424,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -378,23 +449,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -406,8 +477,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -421,7 +492,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             
-                srcConventionManager->increment(SrcLoc);
+                srcConventionManager.increment(SrcLoc);
                 
                 return SourceCharacter(CODEPOINT_VIRTUAL_BOM);
             }
@@ -430,7 +501,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             }
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -465,13 +536,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -494,23 +565,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Related bugs: 376155
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -522,8 +593,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -537,7 +608,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             }
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -570,13 +641,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -595,23 +666,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -627,23 +698,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -655,8 +726,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -675,7 +746,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             }
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -708,13 +779,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -733,23 +804,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -765,23 +836,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -793,8 +864,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -813,7 +884,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             }
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -846,13 +917,13 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             // Buffer is possibly already pointing to EOF
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetEOF = TheByteBuffer->wasEOF;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetEOF = session->byteBuffer->wasEOF;
             auto resetLoc = SrcLoc;
             
-            auto tmp = TheByteBuffer->nextByte0();
+            auto tmp = session->byteBuffer->nextByte0();
                 
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
@@ -871,23 +942,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
                 
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -903,23 +974,23 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
             }
             
-            tmp = TheByteBuffer->nextByte0();
+            tmp = session->byteBuffer->nextByte0();
                 
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // EOF
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -931,8 +1002,8 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 // Invalid
                 //
                 
-                TheByteBuffer->buffer = resetBuf;
-                TheByteBuffer->wasEOF = resetEOF;
+                session->byteBuffer->buffer = resetBuf;
+                session->byteBuffer->wasEOF = resetEOF;
                 SrcLoc = resetLoc;
                 
                 return invalid(resetLoc, policy);
@@ -951,7 +1022,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
                 status = UTF8STATUS_NONCHARACTER_OR_BOM;
             }
             
-            srcConventionManager->increment(SrcLoc);
+            srcConventionManager.increment(SrcLoc);
             
 #if !NISSUES
             {
@@ -980,7 +1051,7 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
             //
         case 0xff: {
             
-            if (TheByteBuffer->wasEOF) {
+            if (session->byteBuffer->wasEOF) {
                 
                 //
                 // Do not increment Column
@@ -1012,49 +1083,120 @@ SourceCharacter ByteDecoder::nextSourceCharacter0(NextPolicy policy) {
 
 SourceCharacter ByteDecoder::currentSourceCharacter(NextPolicy policy) {
     
-    auto resetBuf = TheByteBuffer->buffer;
-    auto resetEOF = TheByteBuffer->wasEOF;
+    auto resetBuf = session->byteBuffer->buffer;
+    auto resetEOF = session->byteBuffer->wasEOF;
     auto resetLoc = SrcLoc;
     
     auto c = nextSourceCharacter0(policy);
     
-    lastBuf = TheByteBuffer->buffer;
+    lastBuf = session->byteBuffer->buffer;
     lastLoc = SrcLoc;
     
-    TheByteBuffer->buffer = resetBuf;
-    TheByteBuffer->wasEOF = resetEOF;
+    session->byteBuffer->buffer = resetBuf;
+    session->byteBuffer->wasEOF = resetEOF;
     SrcLoc = resetLoc;
     
     return c;
 }
 
+void ByteDecoder::skipPlainASCII(unsigned char stop1, unsigned char stop2) {
+    
+    auto buf = session->byteBuffer->buffer;
+    
+    auto plainEnd = ByteBuffer::plainASCIIEnd(buf, session->byteBuffer->end, stop1, stop2);
+    
+    session->byteBuffer->buffer = plainEnd;
+    
+    if (plainEnd > furthest) {
+        furthest = plainEnd;
+    }
+    
+    if (!trackSource) {
+        return;
+    }
+    
+    SrcLoc.second += static_cast<uint32_t>(plainEnd - buf);
+}
 
-void ByteDecoder::strange(codepoint decoded, SourceLocation currentSourceCharacterStartLoc, double confidence) {
+size_t ByteDecoder::validSequenceLength(Buffer p, Buffer end) {
     
-    auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
+    auto firstByte = *p;
     
-    auto safeEncodedCharStr = SourceCharacter(decoded).safeEncodedCharString();
-    auto graphicalStr = SourceCharacter(decoded).graphicalString();
+    if (firstByte < 0x80) {
+        return 1;
+    }
     
-    auto Src = Source(currentSourceCharacterStartLoc, currentSourceCharacterEndLoc);
+    //
+    // The range of the second byte, and the length of the sequence, as in the table above nextSourceCharacter0
+    //
+    unsigned char lo = 0x80;
+    unsigned char hi = 0xbf;
+    size_t len;
     
-    CodeActionPtrSet Actions;
-    Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``" + graphicalStr + "``", Src, graphicalStr)));
+    if (0xc2 <= firstByte && firstByte <= 0xdf) {
+        len = 2;
+    } else if (firstByte == 0xe0) {
+        lo = 0xa0;
+        len = 3;
+    } else if (firstByte == 0xed) {
+        hi = 0x9f;
+        len = 3;
+    } else if (0xe1 <= firstByte && firstByte <= 0xef) {
+        len = 3;
+    } else if (firstByte == 0xf0) {
+        lo = 0x90;
+        len = 4;
+    } else if (0xf1 <= firstByte && firstByte <= 0xf3) {
+        len = 4;
+    } else if (firstByte == 0xf4) {
+        hi = 0x8f;
+        len = 4;
+    } else {
+        return 0;
+    }
+    
+    if (static_cast<size_t>(end - p) < len) {
+        return 0;
+    }
+    
+    if (!(lo <= p[1] && p[1] <= hi)) {
+        return 0;
+    }
     
-    for (const auto& r : LongNames::asciiReplacements(decoded)) {
-        Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``" + LongNames::replacementGraphical(r) + "``", Src, r)));
+    for (size_t i = 2; i < len; i++) {
+        if (!(0x80 <= p[i] && p[i] <= 0xbf)) {
+            return 0;
+        }
     }
     
-    auto I = IssuePtr(new EncodingIssue(ENCODINGISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``\"" + safeEncodedCharStr + "\" (" + graphicalStr + ")``.", ENCODINGISSUESEVERITY_WARNING, Src, confidence, std::move(Actions)));
+    return len;
+}
+
+
+void ByteDecoder::strange(codepoint decoded, SourceLocation currentSourceCharacterStartLoc, double confidence) {
+    
+    auto currentSourceCharacterEndLoc = SrcLoc;
+    
+    auto Src = Source(currentSourceCharacterStartLoc, currentSourceCharacterEndLoc);
+    
+    //
+    // The message and the replacements are formatted from the code point when the issue is printed or put
+    //
+    auto I = Issue(ISSUEKIND_ENCODING, ENCODINGISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDENCODEDCHARACTER, ENCODINGISSUESEVERITY_WARNING, Src, confidence, ISSUEACTION_REPLACEWITHGRAPHICAL, WLCharacter(decoded));
     
-    Issues.insert(std::move(I));
+    addIssue(std::move(I));
 }
 
 SourceCharacter ByteDecoder::invalid(SourceLocation errSrcLoc, NextPolicy policy) {
     
     status = UTF8STATUS_INVALID;
     
-    srcConventionManager->increment(SrcLoc);
+    //
+    // Same for all conventions
+    //
+    if (trackSource) {
+        SrcLoc.second++;
+    }
     
 #if !NISSUES
     {
@@ -1062,9 +1204,9 @@ SourceCharacter ByteDecoder::invalid(SourceLocation errSrcLoc, NextPolicy policy
         // No CodeAction here
         //
         
-        auto I = IssuePtr(new EncodingIssue(ENCODINGISSUETAG_INVALIDCHARACTERENCODING, "Invalid UTF-8 sequence.", ENCODINGISSUESEVERITY_FATAL, Source(errSrcLoc, errSrcLoc.next()), 1.0, {}));
+        auto I = Issue(ISSUEKIND_ENCODING, ENCODINGISSUETAG_INVALIDCHARACTERENCODING, ISSUEMESSAGE_INVALIDUTF8SEQUENCE, ENCODINGISSUESEVERITY_FATAL, Source(errSrcLoc, errSrcLoc.next()), 1.0);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
@@ -1082,11 +1224,16 @@ SourceCharacter ByteDecoder::invalid(SourceLocation errSrcLoc, NextPolicy policy
 
 
 #if !NISSUES
-void ByteDecoder::addIssue(IssuePtr I) {
-    Issues.insert(std::move(I));
+void ByteDecoder::addIssue(Issue I) {
+    
+    if ((session->policy & SKIP_ISSUES) == SKIP_ISSUES) {
+        return;
+    }
+    
+    Issues.push_back(std::move(I));
 }
 
-IssuePtrSet& ByteDecoder::getIssues() {
+IssueVector& ByteDecoder::getIssues() {
     return Issues;
 }
 #endif // !NISSUES
@@ -1102,50 +1249,3 @@ UTF8Status ByteDecoder::getStatus() const {
 void ByteDecoder::clearStatus() {
     status = UTF8STATUS_NORMAL;
 }
-
-ByteDecoderPtr TheByteDecoder = nullptr;
-
-
-
-
-
-void SourceConventionManager::increment(SourceLocation& loc) {
-    loc.second++;
-};
-
-
-SourceLocation LineColumnManager::newSourceLocation() {
-    return SourceLocation(1, 1);
-};
-
-void LineColumnManager::newline(SourceLocation& loc) {
-    loc.first++;
-    loc.second = 1;
-};
-
-void LineColumnManager::windowsNewline(SourceLocation& loc) {
-    loc.first++;
-    loc.second = 1;
-};
-
-void LineColumnManager::tab(SourceLocation& loc) {
-    auto currentTabStop = TabWidth * ((loc.second - 1) / TabWidth) + 1;
-    loc.second = currentTabStop + TabWidth;
-};
-
-
-SourceLocation SourceCharacterIndexManager::newSourceLocation() {
-    return SourceLocation(0, 1);
-};
-
-void SourceCharacterIndexManager::newline(SourceLocation& loc) {
-    loc.second++;
-};
-
-void SourceCharacterIndexManager::windowsNewline(SourceLocation& loc) {
-    loc.second+=2;
-};
-
-void SourceCharacterIndexManager::tab(SourceLocation& loc) {
-    loc.second++;
-};
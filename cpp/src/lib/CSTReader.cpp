@@ -0,0 +1,255 @@
+
+#include "CSTFormat.h"
+
+#include <cstring> // for memcpy
+
+static size_t pad8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+std::string CSTSlice::str() const {
+    
+    if (!data) {
+        return "";
+    }
+    
+    return std::string(reinterpret_cast<const char *>(data), length);
+}
+
+CSTReader::CSTReader() : copy(), header(), issuesArr(), nodesArr(), childrenArr(), symbolsArr(), actionsArr(), locationsArr(), stringsArr(), input() {}
+
+size_t CSTReader::read(const unsigned char *data, size_t len, const unsigned char *inputIn, size_t inputLen) {
+    
+    header = nullptr;
+    
+    if (len < sizeof(CSTHeader)) {
+        return 0;
+    }
+    
+    CSTHeader H;
+    memcpy(&H, data, sizeof(CSTHeader));
+    
+    if (H.magic != CST_MAGIC || H.version != CST_VERSION) {
+        return 0;
+    }
+    
+    if (inputIn && inputLen != H.inputSize) {
+        return 0;
+    }
+    
+    //
+    // Compute in 64 bits so that huge counts in a corrupt header cannot wrap around
+    //
+    uint64_t offsets[8];
+    
+    offsets[0] = pad8(sizeof(CSTHeader));
+    offsets[1] = offsets[0] + pad8(static_cast<uint64_t>(H.issueCount) * sizeof(CSTIssue));
+    offsets[2] = offsets[1] + pad8(static_cast<uint64_t>(H.nodeCount) * sizeof(CSTNode));
+    offsets[3] = offsets[2] + pad8(static_cast<uint64_t>(H.childCount) * sizeof(uint32_t));
+    offsets[4] = offsets[3] + pad8(static_cast<uint64_t>(H.symbolCount) * sizeof(CSTString));
+    offsets[5] = offsets[4] + pad8(static_cast<uint64_t>(H.actionCount) * sizeof(CSTAction));
+    offsets[6] = offsets[5] + pad8(static_cast<uint64_t>(H.locationCount) * sizeof(CSTLocation));
+    offsets[7] = offsets[6] + pad8(H.stringsSize);
+    
+    auto size = offsets[7];
+    
+    if (size > len) {
+        return 0;
+    }
+    
+    auto base = data;
+    
+    if (reinterpret_cast<uintptr_t>(data) % alignof(uint64_t) != 0) {
+        
+        copy.resize(size / sizeof(uint64_t));
+        
+        memcpy(copy.data(), data, size);
+        
+        base = reinterpret_cast<const unsigned char *>(copy.data());
+    }
+    
+    header = reinterpret_cast<const CSTHeader *>(base);
+    issuesArr = reinterpret_cast<const CSTIssue *>(base + offsets[0]);
+    nodesArr = reinterpret_cast<const CSTNode *>(base + offsets[1]);
+    childrenArr = reinterpret_cast<const uint32_t *>(base + offsets[2]);
+    symbolsArr = reinterpret_cast<const CSTString *>(base + offsets[3]);
+    actionsArr = reinterpret_cast<const CSTAction *>(base + offsets[4]);
+    locationsArr = reinterpret_cast<const CSTLocation *>(base + offsets[5]);
+    stringsArr = base + offsets[6];
+    
+    input = inputIn;
+    
+    if (!validate()) {
+        
+        header = nullptr;
+        
+        return 0;
+    }
+    
+    return static_cast<size_t>(size);
+}
+
+//
+// Check every index and slice once, so that the accessors do not have to
+//
+bool CSTReader::validate() const {
+    
+    auto& H = *header;
+    
+    auto validString = [&H](CSTString S) {
+        return static_cast<uint64_t>(S.offset) + S.length <= H.stringsSize;
+    };
+    
+    if (H.nodeCount == 0 || H.root >= H.nodeCount) {
+        return false;
+    }
+    
+    for (uint32_t i = 0; i < H.symbolCount; i++) {
+        if (!validString(symbolsArr[i])) {
+            return false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < H.childCount; i++) {
+        if (childrenArr[i] >= H.nodeCount) {
+            return false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < H.nodeCount; i++) {
+        
+        auto& N = nodesArr[i];
+        
+        auto end = static_cast<uint64_t>(N.firstChild) + N.childCount;
+        
+        switch (N.kind) {
+            case CSTNODEKIND_ISSUES:
+                if (end > H.issueCount) {
+                    return false;
+                }
+                break;
+            case CSTNODEKIND_SOURCELOCATIONS:
+                if (end > H.locationCount) {
+                    return false;
+                }
+                break;
+            default:
+                if (N.kind > CSTNODEKIND_SAFESTRING || end > H.childCount || N.headCount > N.childCount) {
+                    return false;
+                }
+                
+                //
+                // The writer adds a node before its children, so a child that does not come after its parent can
+                // only be from a corrupt file, and may point back at an ancestor and make readers recurse forever
+                //
+                for (auto c = N.firstChild; c < end; c++) {
+                    if (childrenArr[c] <= i) {
+                        return false;
+                    }
+                }
+                break;
+        }
+        
+        if (N.symbol != CST_NOSYMBOL && N.symbol >= H.symbolCount) {
+            return false;
+        }
+        
+        auto textEnd = static_cast<uint64_t>(N.offset) + N.length;
+        
+        switch (N.text) {
+            case CSTTEXT_NONE:
+                break;
+            case CSTTEXT_INPUT:
+                if (textEnd > H.inputSize) {
+                    return false;
+                }
+                break;
+            case CSTTEXT_STRINGS:
+                if (textEnd > H.stringsSize) {
+                    return false;
+                }
+                break;
+            default:
+                return false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < H.issueCount; i++) {
+        
+        auto& I = issuesArr[i];
+        
+        if (I.kind >= H.symbolCount || I.tag >= H.symbolCount || I.severity >= H.symbolCount) {
+            return false;
+        }
+        
+        if (!validString(I.message)) {
+            return false;
+        }
+        
+        if (static_cast<uint64_t>(I.firstAction) + I.actionCount > H.actionCount) {
+            return false;
+        }
+    }
+    
+    for (uint32_t i = 0; i < H.actionCount; i++) {
+        
+        auto& A = actionsArr[i];
+        
+        if (A.kind >= H.symbolCount || !validString(A.label) || !validString(A.text)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
+const CSTHeader& CSTReader::getHeader() const {
+    return *header;
+}
+
+const CSTNode& CSTReader::root() const {
+    return nodesArr[header->root];
+}
+
+const CSTNode& CSTReader::node(uint32_t i) const {
+    return nodesArr[i];
+}
+
+const CSTNode& CSTReader::child(const CSTNode& N, uint32_t i) const {
+    return nodesArr[childrenArr[N.firstChild + i]];
+}
+
+const CSTIssue& CSTReader::issue(uint32_t i) const {
+    return issuesArr[i];
+}
+
+const CSTAction& CSTReader::action(uint32_t i) const {
+    return actionsArr[i];
+}
+
+CSTLocation CSTReader::location(uint32_t i) const {
+    return locationsArr[i];
+}
+
+CSTSlice CSTReader::symbol(uint32_t i) const {
+    return string(symbolsArr[i]);
+}
+
+CSTSlice CSTReader::string(CSTString S) const {
+    return CSTSlice{stringsArr + S.offset, S.length};
+}
+
+CSTSlice CSTReader::text(const CSTNode& N) const {
+    
+    switch (N.text) {
+        case CSTTEXT_INPUT:
+            if (!input) {
+                return CSTSlice{nullptr, N.length};
+            }
+            return CSTSlice{input + N.offset, N.length};
+        case CSTTEXT_STRINGS:
+            return CSTSlice{stringsArr + N.offset, N.length};
+        default:
+            return CSTSlice{nullptr, 0};
+    }
+}
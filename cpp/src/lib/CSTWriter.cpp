@@ -0,0 +1,270 @@
+
+#include "CSTWriter.h"
+
+#include "Node.h" // for Node
+#include "API.h" // for ParserSession
+#include "ByteDecoder.h" // for ByteDecoder
+
+#include <cstring> // for memset
+
+CSTWriter::CSTWriter(ParserSession *session) : session(session), input(), issues(), nodes(), children(), symbols(), actions(), locations(), strings(), pending(), frames(), symbolIndices() {}
+
+void CSTWriter::clear() {
+    
+    issues.clear();
+    nodes.clear();
+    children.clear();
+    symbols.clear();
+    actions.clear();
+    locations.clear();
+    strings.clear();
+    
+    pending.clear();
+    frames.clear();
+    
+    symbolIndices.clear();
+}
+
+static void writeSection(std::ostream& s, const void *data, size_t size) {
+    
+    s.write(static_cast<const char *>(data), size);
+    
+    //
+    // Pad to a multiple of 8
+    //
+    static const char zeros[8] = {};
+    
+    s.write(zeros, (8 - size % 8) % 8);
+}
+
+void CSTWriter::write(const Node *N, std::ostream& s) {
+    
+    clear();
+    
+    input = session->getInput();
+    
+    N->write(session, *this);
+    
+    assert(pending.size() == 1);
+    assert(frames.empty());
+    
+    CSTHeader H;
+    memset(&H, 0, sizeof(CSTHeader));
+    
+    H.magic = CST_MAGIC;
+    H.version = CST_VERSION;
+    H.srcConvention = session->byteDecoder->getSourceConvention();
+    H.policy = session->policy;
+    H.inputSize = static_cast<uint32_t>(input.length());
+    H.root = pending[0];
+    H.issueCount = static_cast<uint32_t>(issues.size());
+    H.nodeCount = static_cast<uint32_t>(nodes.size());
+    H.childCount = static_cast<uint32_t>(children.size());
+    H.symbolCount = static_cast<uint32_t>(symbols.size());
+    H.actionCount = static_cast<uint32_t>(actions.size());
+    H.locationCount = static_cast<uint32_t>(locations.size());
+    H.stringsSize = static_cast<uint32_t>(strings.size());
+    
+    s.write(reinterpret_cast<const char *>(&H), sizeof(CSTHeader));
+    
+    writeSection(s, issues.data(), issues.size() * sizeof(CSTIssue));
+    writeSection(s, nodes.data(), nodes.size() * sizeof(CSTNode));
+    writeSection(s, children.data(), children.size() * sizeof(uint32_t));
+    writeSection(s, symbols.data(), symbols.size() * sizeof(CSTString));
+    writeSection(s, actions.data(), actions.size() * sizeof(CSTAction));
+    writeSection(s, locations.data(), locations.size() * sizeof(CSTLocation));
+    writeSection(s, strings.data(), strings.size());
+}
+
+uint32_t CSTWriter::symbol(const char *name) {
+    
+    auto it = symbolIndices.find(name);
+    
+    if (it != symbolIndices.end()) {
+        return it->second;
+    }
+    
+    auto idx = static_cast<uint32_t>(symbols.size());
+    
+    symbols.push_back(string(name));
+    
+    symbolIndices[name] = idx;
+    
+    return idx;
+}
+
+CSTString CSTWriter::string(const std::string& str) {
+    
+    auto S = CSTString{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(str.size())};
+    
+    strings += str;
+    
+    return S;
+}
+
+CSTSource CSTWriter::source(Source Src) const {
+    return CSTSource{{Src.Start.first, Src.Start.second}, {Src.End.first, Src.End.second}};
+}
+
+uint32_t CSTWriter::add(CSTNodeKind kind, uint32_t sym, Source Src) {
+    
+    auto idx = static_cast<uint32_t>(nodes.size());
+    
+    CSTNode N;
+    memset(&N, 0, sizeof(CSTNode));
+    
+    N.kind = kind;
+    N.text = CSTTEXT_NONE;
+    N.symbol = sym;
+    N.src = source(Src);
+    
+    nodes.push_back(N);
+    
+    pending.push_back(idx);
+    
+    return idx;
+}
+
+uint32_t CSTWriter::open(CSTNodeKind kind, uint32_t sym, Source Src) {
+    
+    auto idx = add(kind, sym, Src);
+    
+    frames.push_back(pending.size());
+    
+    return idx;
+}
+
+void CSTWriter::markHead(uint32_t idx) {
+    nodes[idx].headCount = static_cast<uint32_t>(pending.size() - frames.back());
+}
+
+void CSTWriter::close(uint32_t idx) {
+    
+    auto start = frames.back();
+    frames.pop_back();
+    
+    auto& N = nodes[idx];
+    
+    N.firstChild = static_cast<uint32_t>(children.size());
+    N.childCount = static_cast<uint32_t>(pending.size() - start);
+    
+    children.insert(children.end(), pending.begin() + start, pending.end());
+    
+    pending.resize(start);
+}
+
+void CSTWriter::leaf(CSTNodeKind kind, TokenEnum Tok, uint32_t sym, Source Src, BufferAndLength Buf) {
+    
+    auto idx = add(kind, sym, Src);
+    
+    auto& N = nodes[idx];
+    
+    N.tok = Tok.value();
+    
+    if (Tok.isEmpty()) {
+        
+        //
+        // Nothing to point at
+        //
+        
+    } else if (Buf.status == UTF8STATUS_NORMAL && input.buffer <= Buf.buffer && Buf.end <= input.end) {
+        
+        N.text = CSTTEXT_INPUT;
+        N.offset = static_cast<uint32_t>(Buf.buffer - input.buffer);
+        N.length = static_cast<uint32_t>(Buf.length());
+        
+    } else {
+        
+        //
+        // Invalid UTF-8 is written the same as print and put write it
+        //
+        
+        std::string str;
+        
+        auto Nice = (Buf.status == UTF8STATUS_NORMAL) ? Buf : Buf.createNiceBufferAndLength(&str);
+        
+        auto S = string(std::string(reinterpret_cast<const char *>(Nice.buffer), Nice.length()));
+        
+        N.text = CSTTEXT_STRINGS;
+        N.offset = S.offset;
+        N.length = S.length;
+    }
+}
+
+void CSTWriter::leaf(CSTNodeKind kind, const std::string& text) {
+    
+    auto idx = add(kind, CST_NOSYMBOL, Source());
+    
+    auto S = string(text);
+    
+    auto& N = nodes[idx];
+    
+    N.text = CSTTEXT_STRINGS;
+    N.offset = S.offset;
+    N.length = S.length;
+}
+
+void CSTWriter::collectedIssues(const IssueVector& Issues) {
+    
+    //
+    // The children of an issues node are the issues themselves
+    //
+    auto idx = add(CSTNODEKIND_ISSUES, CST_NOSYMBOL, Source());
+    
+    nodes[idx].firstChild = static_cast<uint32_t>(issues.size());
+    nodes[idx].childCount = static_cast<uint32_t>(Issues.size());
+    
+    for (auto& I : Issues) {
+        
+        CSTIssue R;
+        memset(&R, 0, sizeof(CSTIssue));
+        
+        R.kind = symbol(IssueKindSymbolName(I.Kind));
+        R.tag = symbol(IssueTagToString(I.Tag));
+        R.severity = symbol(IssueSeverityToString(I.Sev));
+        R.message = string(I.getMessage());
+        R.src = source(I.getSource());
+        
+        //
+        // Only syntax issues have a confidence, the same as print and put
+        //
+        if (I.Kind == ISSUEKIND_SYNTAX) {
+            R.confidence = I.Val;
+            R.hasConfidence = 1;
+        }
+        
+        R.firstAction = static_cast<uint32_t>(actions.size());
+        
+        for (auto& A : I.getActions()) {
+            A->write(*this);
+        }
+        
+        R.actionCount = static_cast<uint32_t>(actions.size()) - R.firstAction;
+        
+        issues.push_back(R);
+    }
+}
+
+void CSTWriter::collectedSourceLocations(const SourceLocationVector& Locs) {
+    
+    auto idx = add(CSTNODEKIND_SOURCELOCATIONS, CST_NOSYMBOL, Source());
+    
+    nodes[idx].firstChild = static_cast<uint32_t>(locations.size());
+    nodes[idx].childCount = static_cast<uint32_t>(Locs.size());
+    
+    for (auto& L : Locs) {
+        locations.push_back(CSTLocation{L.first, L.second});
+    }
+}
+
+void CSTWriter::action(const char *kind, const std::string& label, Source Src, const std::string& text) {
+    
+    CSTAction A;
+    
+    A.kind = symbol(kind);
+    A.label = string(label);
+    A.src = source(Src);
+    A.text = string(text);
+    
+    actions.push_back(A);
+}
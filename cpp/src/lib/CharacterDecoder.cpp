@@ -1,14 +1,16 @@
 
 #include "CharacterDecoder.h"
 
-#include "ByteDecoder.h" // for TheByteDecoder
-#include "ByteBuffer.h" // for TheByteBuffer
+#include "ByteDecoder.h" // for ByteDecoder
+#include "ByteBuffer.h" // for ByteBuffer
 #include "Utils.h" // for isUnsupportedLongName, etc.
 #include "LongNames.h" // for LongNameToCodePointMap, etc.
-#include "API.h" // for ScopedMLUTF8String
+#include "API.h" // for ParserSession, ScopedMLUTF8String
 
+#include <cstring> // for memcpy
 
-CharacterDecoder::CharacterDecoder() : Issues(), SimpleLineContinuations(), ComplexLineContinuations(), EmbeddedTabs(), libData(), lastBuf(), lastLoc() {}
+
+CharacterDecoder::CharacterDecoder(ParserSession *session) : session(session), Issues(), SimpleLineContinuations(), ComplexLineContinuations(), EmbeddedTabs(), Suggestions(), libData(), lastBuf(), lastLoc(), missedSuggestion() {}
 
 void CharacterDecoder::init(WolframLibraryData libDataIn) {
     
@@ -21,6 +23,8 @@ void CharacterDecoder::init(WolframLibraryData libDataIn) {
     
     lastBuf = nullptr;
     lastLoc = SourceLocation();
+    
+    missedSuggestion = false;
 }
 
 
@@ -30,15 +34,17 @@ void CharacterDecoder::deinit() {
     SimpleLineContinuations.clear();
     ComplexLineContinuations.clear();
     EmbeddedTabs.clear();
+    
+    Suggestions.reset();
 }
 
 
 WLCharacter CharacterDecoder::nextWLCharacter0(Buffer tokenStartBuf, SourceLocation tokenStartLoc, NextPolicy policy) {
     
-    auto currentWLCharacterStartBuf = TheByteBuffer->buffer;
-    auto currentWLCharacterStartLoc = TheByteDecoder->SrcLoc;
+    auto currentWLCharacterStartBuf = session->byteBuffer->buffer;
+    auto currentWLCharacterStartLoc = session->byteDecoder->SrcLoc;
     
-    auto curSource = TheByteDecoder->nextSourceCharacter0(policy);
+    auto curSource = session->byteDecoder->nextSourceCharacter0(policy);
     
     //
     // Handle \
@@ -57,10 +63,10 @@ WLCharacter CharacterDecoder::nextWLCharacter0(Buffer tokenStartBuf, SourceLocat
         // There was a \
         //
         
-        auto escapedBuf = TheByteBuffer->buffer;
-        auto escapedLoc = TheByteDecoder->SrcLoc;
+        auto escapedBuf = session->byteBuffer->buffer;
+        auto escapedLoc = session->byteDecoder->SrcLoc;
         
-        curSource = TheByteDecoder->nextSourceCharacter0(policy);
+        curSource = session->byteDecoder->nextSourceCharacter0(policy);
     
         switch (curSource.to_point()) {
             case '\n':
@@ -169,18 +175,18 @@ WLCharacter CharacterDecoder::nextWLCharacter0(Buffer tokenStartBuf, SourceLocat
 
 WLCharacter CharacterDecoder::currentWLCharacter(Buffer tokenStartBuf, SourceLocation tokenStartLoc, NextPolicy policy) {
     
-    auto resetBuf = TheByteBuffer->buffer;
-    auto resetEOF = TheByteBuffer->wasEOF;
-    auto resetLoc = TheByteDecoder->SrcLoc;
+    auto resetBuf = session->byteBuffer->buffer;
+    auto resetEOF = session->byteBuffer->wasEOF;
+    auto resetLoc = session->byteDecoder->SrcLoc;
     
     auto c = nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
     
-    lastBuf = TheByteBuffer->buffer;
-    lastLoc = TheByteDecoder->SrcLoc;
+    lastBuf = session->byteBuffer->buffer;
+    lastLoc = session->byteDecoder->SrcLoc;
     
-    TheByteBuffer->buffer = resetBuf;
-    TheByteBuffer->wasEOF = resetEOF;
-    TheByteDecoder->SrcLoc = resetLoc;
+    session->byteBuffer->buffer = resetBuf;
+    session->byteBuffer->wasEOF = resetEOF;
+    session->byteDecoder->SrcLoc = resetLoc;
     
     return c;
 }
@@ -192,9 +198,9 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
     //
     // Do not write leading \[ or trailing ] to LongName
     //
-    auto longNameStartBuf = TheByteBuffer->buffer;
+    auto longNameStartBuf = session->byteBuffer->buffer;
     
-    auto curSource = TheByteDecoder->currentSourceCharacter(policy);
+    auto curSource = session->byteDecoder->currentSourceCharacter(policy);
     
     auto wellFormed = false;
     
@@ -209,10 +215,10 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
         
         atleast1DigitOrAlpha = true;
         
-        TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+        session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
         
-        curSource = TheByteDecoder->currentSourceCharacter(policy);
+        curSource = session->byteDecoder->currentSourceCharacter(policy);
         
         while (true) {
             
@@ -222,10 +228,10 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
             
             if (curSource.isAlphaOrDigit()) {
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                curSource = TheByteDecoder->currentSourceCharacter(policy);
+                curSource = session->byteDecoder->currentSourceCharacter(policy);
                 
             } else if (curSource == SourceCharacter(']')) {
                 
@@ -251,10 +257,10 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
         // Handle \[]
         //
         
-        TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+        session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
         
-        curSource = TheByteDecoder->currentSourceCharacter(policy);
+        curSource = session->byteDecoder->currentSourceCharacter(policy);
     }
     
     if (!wellFormed) {
@@ -266,13 +272,17 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
 #if !NISSUES
         if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
             
-            auto currentWLCharacterEndBuf = TheByteBuffer->buffer;
-            auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+            auto currentWLCharacterEndBuf = session->byteBuffer->buffer;
+            auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
             
             auto longNameEndBuf = currentWLCharacterEndBuf;
             
             auto longNameBufAndLen = BufferAndLength(longNameStartBuf, longNameEndBuf - longNameStartBuf);
-            auto longNameStr = std::string(reinterpret_cast<const char *>(longNameBufAndLen.buffer), longNameBufAndLen.length());
+            
+            //
+            // From the [ onward
+            //
+            auto escapedBufAndLen = BufferAndLength(openSquareBuf, longNameEndBuf - openSquareBuf);
             
             if (atleast1DigitOrAlpha) {
                 
@@ -284,17 +294,11 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
                 
                 auto suggestion = longNameSuggestion(longNameBufAndLen);
                 
-                CodeActionPtrSet Actions;
+                auto found = (LongNames::findLongName(longNameBufAndLen.buffer, longNameBufAndLen.length()) != -1);
                 
-                auto it = std::lower_bound(LongNameToCodePointMap_names.begin(), LongNameToCodePointMap_names.end(), longNameStr);
-                auto found = (it != LongNameToCodePointMap_names.end() && *it == longNameStr);
-                if (found) {
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert ``]`` to form ``\\[" + suggestion + "]``", Source(currentWLCharacterEndLoc), "]")));
-                }
-                
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character: ``\\[") + longNameStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, found ? ISSUEACTION_INSERTCLOSESQUARE : ISSUEACTION_NONE, WLCharacter(0), escapedBufAndLen, suggestion);
                 
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
                 
             } else {
                 
@@ -305,13 +309,9 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
                 // Something like \[*
                 //
                 
-                CodeActionPtrSet Actions;
-                
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\[" + longNameStr + "``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\\\[" + longNameStr)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_ESCAPEBACKSLASH, WLCharacter(0), escapedBufAndLen);
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character: ``\\[") + longNameStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
-                
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
             }
         }
         //
@@ -323,13 +323,13 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
             xxx;
             auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNLIKELYESCAPESEQUENCE, std::string("Unlikely escape sequence: ``\\\\[") + LongNameStr + "``", SYNTAXISSUESEVERITY_REMARK, Source(CharacterStart-1, Loc), 0.33, {}));
 
-            Issues.push_back(std::move(I));
+            addIssue(std::move(I));
         }
 #endif // #if 0
 #endif // !NISSUES
         
-        TheByteBuffer->buffer = openSquareBuf;
-        TheByteDecoder->SrcLoc = openSquareLoc;
+        session->byteBuffer->buffer = openSquareBuf;
+        session->byteDecoder->SrcLoc = openSquareLoc;
         
         return WLCharacter('\\');
     }
@@ -342,14 +342,12 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
     // if unlikelyEscapeChecking, then make sure to append all of the Source characters again
     //
     
-    auto longNameEndBuf = TheByteBuffer->buffer;
+    auto longNameEndBuf = session->byteBuffer->buffer;
     
     auto longNameBufAndLen = BufferAndLength(longNameStartBuf, longNameEndBuf - longNameStartBuf);
-    auto longNameStr = std::string(reinterpret_cast<const char *>(longNameBufAndLen.buffer), longNameBufAndLen.length());
     
-    auto it = std::lower_bound(LongNameToCodePointMap_names.begin(), LongNameToCodePointMap_names.end(), longNameStr);
-    auto found = (it != LongNameToCodePointMap_names.end() && *it == longNameStr);
-    if (!found) {
+    auto idx = LongNames::findLongName(longNameBufAndLen.buffer, longNameBufAndLen.length());
+    if (idx == -1) {
         
         //
         // Unrecognized name
@@ -358,28 +356,27 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
 #if !NISSUES
         if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
             
-            auto longNameEndLoc = TheByteDecoder->SrcLoc;
+            auto longNameEndLoc = session->byteDecoder->SrcLoc;
             
             //
             // Accomodate the ] character
             //
             auto currentWLCharacterEndLoc = longNameEndLoc.next();
             
-            auto suggestion = longNameSuggestion(longNameBufAndLen);
-            
-            CodeActionPtrSet Actions;
+            //
+            // From the [ to the ]
+            //
+            auto escapedBufAndLen = BufferAndLength(openSquareBuf, longNameEndBuf + 1 - openSquareBuf);
             
-            if (!suggestion.empty()) {
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + suggestion + "]``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\[" + suggestion + "]")));
-            }
+            auto suggestion = longNameSuggestion(longNameBufAndLen);
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character: ``\\[") + longNameStr + "]``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, suggestion.length() != 0 ? ISSUEACTION_REPLACEWITHSUGGESTION : ISSUEACTION_NONE, WLCharacter(0), escapedBufAndLen, suggestion);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
             
         } else if ((policy & ENABLE_UNLIKELY_ESCAPE_CHECKING) == ENABLE_UNLIKELY_ESCAPE_CHECKING) {
             
-            auto longNameEndLoc = TheByteDecoder->SrcLoc;
+            auto longNameEndLoc = session->byteDecoder->SrcLoc;
             
             //
             // Accomodate the ] character
@@ -388,22 +385,21 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
             
             auto previousBackslashLoc = currentWLCharacterStartLoc.previous();
             
-            auto suggestion = longNameSuggestion(longNameBufAndLen);
-            
-            CodeActionPtrSet Actions;
+            //
+            // From the [ to the ]
+            //
+            auto escapedBufAndLen = BufferAndLength(openSquareBuf, longNameEndBuf + 1 - openSquareBuf);
             
-            if (!suggestion.empty()) {
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + suggestion + "]``", Source(previousBackslashLoc, currentWLCharacterEndLoc), "\\[" + suggestion + "]")));
-            }
+            auto suggestion = longNameSuggestion(longNameBufAndLen);
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE, std::string("Unexpected escape sequence: ``\\\\[") + longNameStr + "]``.", SYNTAXISSUESEVERITY_REMARK, Source(previousBackslashLoc, currentWLCharacterEndLoc), 0.33, std::move(Actions)));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE, ISSUEMESSAGE_UNEXPECTEDESCAPESEQUENCE, SYNTAXISSUESEVERITY_REMARK, Source(previousBackslashLoc, currentWLCharacterEndLoc), 0.33, suggestion.length() != 0 ? ISSUEACTION_REPLACEWITHSUGGESTION : ISSUEACTION_NONE, WLCharacter(0), escapedBufAndLen, suggestion);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
         }
 #endif // !NISSUES
         
-        TheByteBuffer->buffer = openSquareBuf;
-        TheByteDecoder->SrcLoc = openSquareLoc;
+        session->byteBuffer->buffer = openSquareBuf;
+        session->byteDecoder->SrcLoc = openSquareLoc;
         
         return WLCharacter('\\');
     }
@@ -421,7 +417,7 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
         // If found and unlikelyEscapeChecking, then still come in here.
         //
         
-        auto longNameEndLoc = TheByteDecoder->SrcLoc;
+        auto longNameEndLoc = session->byteDecoder->SrcLoc;
         
         //
         // Accomodate the ] character
@@ -430,68 +426,66 @@ WLCharacter CharacterDecoder::handleLongName(Buffer currentWLCharacterStartBuf,
         
         auto previousBackslashLoc = currentWLCharacterStartLoc.previous();
         
-        auto suggestion = longNameSuggestion(longNameBufAndLen);
-        
-        CodeActionPtrSet Actions;
+        //
+        // From the [ to the ]
+        //
+        auto escapedBufAndLen = BufferAndLength(openSquareBuf, longNameEndBuf + 1 - openSquareBuf);
         
-        if (!suggestion.empty()) {
-            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + suggestion + "]``", Source(previousBackslashLoc, currentWLCharacterEndLoc), "\\[" + suggestion + "]")));
-        }
+        auto suggestion = longNameSuggestion(longNameBufAndLen);
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE, std::string("Unexpected escape sequence: ``\\\\[") + longNameStr + "]``.", SYNTAXISSUESEVERITY_REMARK, Source(previousBackslashLoc, currentWLCharacterEndLoc), 0.33, std::move(Actions)));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE, ISSUEMESSAGE_UNEXPECTEDESCAPESEQUENCE, SYNTAXISSUESEVERITY_REMARK, Source(previousBackslashLoc, currentWLCharacterEndLoc), 0.33, suggestion.length() != 0 ? ISSUEACTION_REPLACEWITHSUGGESTION : ISSUEACTION_NONE, WLCharacter(0), escapedBufAndLen, suggestion);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
     
-    auto idx = it - LongNameToCodePointMap_names.begin();
     auto point = LongNameToCodePointMap_points[idx];
     
 #if !NISSUES
     if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
         
-        auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+        auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto longNameBufAndLen = BufferAndLength(longNameStartBuf, longNameEndBuf - longNameStartBuf);
-        auto longNameStr = std::string(reinterpret_cast<const char *>(longNameBufAndLen.buffer), longNameBufAndLen.length());
+        //
+        // From the [ to the ]
+        //
+        auto escapedBufAndLen = BufferAndLength(openSquareBuf, longNameEndBuf + 1 - openSquareBuf);
         
         //
         // The well-formed, recognized name could still be unsupported or undocumented
         //
         if (LongNames::isUnsupportedLongNameCodePoint(point)) {
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNSUPPORTEDCHARACTER, std::string("Unsupported character: ``\\[") + longNameStr + "]``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, {}));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNSUPPORTEDCHARACTER, ISSUEMESSAGE_UNSUPPORTEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_NONE, WLCharacter(0), escapedBufAndLen);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
             
         } else if (Utils::isMBStrange(point)) {
             
             //
             // Just generally strange character is in the code
             //
-            auto c = WLCharacter(point, LongNames::isRaw(longNameStr) ? ESCAPE_RAW : ESCAPE_LONGNAME);
-            
-            auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
+            auto c = WLCharacter(point, LongNames::isRaw(point) ? ESCAPE_RAW : ESCAPE_LONGNAME);
             
-            auto graphicalStr = c.graphicalString();
+            auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, {}));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, ISSUEACTION_NONE, c);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
             
-        } else if (Utils::isUndocumentedLongName(longNameStr)) {
+        } else if (Utils::isUndocumentedLongName(point)) {
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNDOCUMENTEDCHARACTER, std::string("Undocumented character: ``\\[") + longNameStr + "]``.", SYNTAXISSUESEVERITY_REMARK, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, {}));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNDOCUMENTEDCHARACTER, ISSUEMESSAGE_UNDOCUMENTEDCHARACTER, SYNTAXISSUESEVERITY_REMARK, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_NONE, WLCharacter(0), escapedBufAndLen);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
         }
     }
 #endif // !NISSUES
     
-    if (LongNames::isRaw(longNameStr)) {
+    if (LongNames::isRaw(point)) {
         return WLCharacter(point, ESCAPE_RAW);
     } else {
         return WLCharacter(point, ESCAPE_LONGNAME);
@@ -503,16 +497,16 @@ WLCharacter CharacterDecoder::handle4Hex(Buffer currentWLCharacterStartBuf, Sour
     
     assert(*colonBuf == ':');
     
-    auto hexStartBuf = TheByteBuffer->buffer;
+    auto hexStartBuf = session->byteBuffer->buffer;
     
     for (auto i = 0; i < 4; i++) {
         
-        auto curSource = TheByteDecoder->currentSourceCharacter(policy);
+        auto curSource = session->byteDecoder->currentSourceCharacter(policy);
         
         if (curSource.isHex()) {
             
-            TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+            session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
             
         } else {
             
@@ -525,26 +519,21 @@ WLCharacter CharacterDecoder::handle4Hex(Buffer currentWLCharacterStartBuf, Sour
 #if !NISSUES
             if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
                 
-                auto currentWLCharacterEndBuf = TheByteBuffer->buffer;
-                auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+                auto currentWLCharacterEndBuf = session->byteBuffer->buffer;
+                auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
                 
                 auto hexEndBuf = currentWLCharacterEndBuf;
                 
-                auto hexBufAndLen = BufferAndLength(hexStartBuf, hexEndBuf - hexStartBuf);
-                auto hexStr = std::string(reinterpret_cast<const char *>(hexBufAndLen.buffer), hexBufAndLen.length());
-                
-                CodeActionPtrSet Actions;
+                auto escapedBufAndLen = BufferAndLength(colonBuf, hexEndBuf - colonBuf);
                 
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\:" + hexStr + "``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\\\:" + hexStr)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_ESCAPEBACKSLASH, WLCharacter(0), escapedBufAndLen);
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character: ``\\:") + hexStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
-                
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
             }
 #endif // !NISSUES
             
-            TheByteBuffer->buffer = colonBuf;
-            TheByteDecoder->SrcLoc = colonLoc;
+            session->byteBuffer->buffer = colonBuf;
+            session->byteDecoder->SrcLoc = colonLoc;
             
             return WLCharacter('\\');
         }
@@ -577,13 +566,11 @@ WLCharacter CharacterDecoder::handle4Hex(Buffer currentWLCharacterStartBuf, Sour
         
         auto c = WLCharacter(point, ESCAPE_4HEX);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
-        
-        auto graphicalStr = c.graphicalString();
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
         
     } else if (Utils::isMBStrange(point)) {
         //
@@ -592,13 +579,11 @@ WLCharacter CharacterDecoder::handle4Hex(Buffer currentWLCharacterStartBuf, Sour
         
         auto c = WLCharacter(point, ESCAPE_4HEX);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
-        
-        auto graphicalStr = c.graphicalString();
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
@@ -610,16 +595,16 @@ WLCharacter CharacterDecoder::handle2Hex(Buffer currentWLCharacterStartBuf, Sour
     
     assert(*dotBuf == '.');
     
-    auto hexStartBuf = TheByteBuffer->buffer;
+    auto hexStartBuf = session->byteBuffer->buffer;
     
     for (auto i = 0; i < 2; i++) {
         
-        auto curSource = TheByteDecoder->currentSourceCharacter(policy);
+        auto curSource = session->byteDecoder->currentSourceCharacter(policy);
         
         if (curSource.isHex()) {
             
-            TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+            session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
             
         } else {
             
@@ -632,26 +617,21 @@ WLCharacter CharacterDecoder::handle2Hex(Buffer currentWLCharacterStartBuf, Sour
 #if !NISSUES
             if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
                 
-                auto currentWLCharacterEndBuf = TheByteBuffer->buffer;
-                auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+                auto currentWLCharacterEndBuf = session->byteBuffer->buffer;
+                auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
                 
                 auto hexEndBuf = currentWLCharacterEndBuf;
                 
-                auto hexBufAndLen = BufferAndLength(hexStartBuf, hexEndBuf - hexStartBuf);
-                auto hexStr = std::string(reinterpret_cast<const char *>(hexBufAndLen.buffer), hexBufAndLen.length());
+                auto escapedBufAndLen = BufferAndLength(dotBuf, hexEndBuf - dotBuf);
                 
-                CodeActionPtrSet Actions;
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_ESCAPEBACKSLASH, WLCharacter(0), escapedBufAndLen);
                 
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\." + hexStr + "``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\\\." + hexStr)));
-                
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, "Unrecognized character: ``\\." + hexStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
-                
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
             }
 #endif // !NISSUES
             
-            TheByteBuffer->buffer = dotBuf;
-            TheByteDecoder->SrcLoc = dotLoc;
+            session->byteBuffer->buffer = dotBuf;
+            session->byteDecoder->SrcLoc = dotLoc;
             
             return WLCharacter('\\');
         }
@@ -682,13 +662,11 @@ WLCharacter CharacterDecoder::handle2Hex(Buffer currentWLCharacterStartBuf, Sour
         
         auto c = WLCharacter(point, ESCAPE_2HEX);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
-        
-        auto graphicalStr = c.graphicalString();
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
         
     } else if (Utils::isMBStrange(point)) {
         //
@@ -697,13 +675,11 @@ WLCharacter CharacterDecoder::handle2Hex(Buffer currentWLCharacterStartBuf, Sour
         
         auto c = WLCharacter(point, ESCAPE_2HEX);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto graphicalStr = c.graphicalString();
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, ISSUEACTION_NONE, c);
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, {}));
-        
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     };
 #endif // !NISSUES
     
@@ -719,12 +695,12 @@ WLCharacter CharacterDecoder::handleOctal(Buffer currentWLCharacterStartBuf, Sou
     
     for (auto i = 0; i < 3-1; i++) {
         
-        auto curSource = TheByteDecoder->currentSourceCharacter(policy);
+        auto curSource = session->byteDecoder->currentSourceCharacter(policy);
         
         if (curSource.isOctal()) {
             
-            TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+            session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
             
         } else {
             
@@ -737,26 +713,21 @@ WLCharacter CharacterDecoder::handleOctal(Buffer currentWLCharacterStartBuf, Sou
 #if !NISSUES
             if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
                 
-                auto currentWLCharacterEndBuf = TheByteBuffer->buffer;
-                auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+                auto currentWLCharacterEndBuf = session->byteBuffer->buffer;
+                auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
                 
                 auto octalEndBuf = currentWLCharacterEndBuf;
                 
-                auto octalBufAndLen = BufferAndLength(octalStartBuf, octalEndBuf - octalStartBuf);
-                auto octalStr = std::string(reinterpret_cast<const char *>(octalBufAndLen.buffer), octalBufAndLen.length());
-                
-                CodeActionPtrSet Actions;
-                
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\" + octalStr + "``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\\\" + octalStr)));
+                auto escapedBufAndLen = BufferAndLength(octalStartBuf, octalEndBuf - octalStartBuf);
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character: ``\\") + octalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_ESCAPEBACKSLASH, WLCharacter(0), escapedBufAndLen);
                 
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
             }
 #endif // !NISSUES
 
-            TheByteBuffer->buffer = firstOctalBuf;
-            TheByteDecoder->SrcLoc = firstOctalLoc;
+            session->byteBuffer->buffer = firstOctalBuf;
+            session->byteDecoder->SrcLoc = firstOctalLoc;
             
             return WLCharacter('\\');
         }
@@ -788,13 +759,11 @@ WLCharacter CharacterDecoder::handleOctal(Buffer currentWLCharacterStartBuf, Sou
         
         auto c = WLCharacter(point, ESCAPE_OCTAL);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto graphicalStr = c.graphicalString();
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, ISSUEACTION_NONE, c);
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, {}));
-        
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
         
     } else if (Utils::isMBStrange(point)) {
         //
@@ -803,13 +772,11 @@ WLCharacter CharacterDecoder::handleOctal(Buffer currentWLCharacterStartBuf, Sou
         
         auto c = WLCharacter(point, ESCAPE_OCTAL);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
-        
-        auto graphicalStr = c.graphicalString();
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     };
 #endif // !NISSUES
     
@@ -821,16 +788,16 @@ WLCharacter CharacterDecoder::handle6Hex(Buffer currentWLCharacterStartBuf, Sour
     
     assert(*barBuf == '|');
     
-    auto hexStartBuf = TheByteBuffer->buffer;
+    auto hexStartBuf = session->byteBuffer->buffer;
     
     for (auto i = 0; i < 6; i++) {
         
-        auto curSource = TheByteDecoder->currentSourceCharacter(policy);
+        auto curSource = session->byteDecoder->currentSourceCharacter(policy);
         
         if (curSource.isHex()) {
             
-            TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+            session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
             
         } else {
             
@@ -844,26 +811,21 @@ WLCharacter CharacterDecoder::handle6Hex(Buffer currentWLCharacterStartBuf, Sour
             
             if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
                 
-                auto currentWLCharacterEndBuf = TheByteBuffer->buffer;
-                auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+                auto currentWLCharacterEndBuf = session->byteBuffer->buffer;
+                auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
                 
                 auto hexEndBuf = currentWLCharacterEndBuf;
                 
-                auto hexBufAndLen = BufferAndLength(hexStartBuf, hexEndBuf - hexStartBuf);
-                auto hexStr = std::string(reinterpret_cast<const char *>(hexBufAndLen.buffer), hexBufAndLen.length());
-                
-                CodeActionPtrSet Actions;
+                auto escapedBufAndLen = BufferAndLength(barBuf, hexEndBuf - barBuf);
                 
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\|" + hexStr + "``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\\\|" + hexStr)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_ESCAPEBACKSLASH, WLCharacter(0), escapedBufAndLen);
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character: ``\\|") + hexStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
-                
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
             }
 #endif // !NISSUES
 
-            TheByteBuffer->buffer = barBuf;
-            TheByteDecoder->SrcLoc = barLoc;
+            session->byteBuffer->buffer = barBuf;
+            session->byteDecoder->SrcLoc = barLoc;
             
             return WLCharacter('\\');
         }
@@ -898,13 +860,11 @@ WLCharacter CharacterDecoder::handle6Hex(Buffer currentWLCharacterStartBuf, Sour
         
         auto c = WLCharacter(point, ESCAPE_6HEX);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
-        
-        auto graphicalStr = c.graphicalString();
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.95, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
         
     } else if (Utils::isMBStrange(point)) {
         //
@@ -913,13 +873,11 @@ WLCharacter CharacterDecoder::handle6Hex(Buffer currentWLCharacterStartBuf, Sour
         
         auto c = WLCharacter(point, ESCAPE_6HEX);
         
-        auto currentSourceCharacterEndLoc = TheByteDecoder->SrcLoc;
+        auto currentSourceCharacterEndLoc = session->byteDecoder->SrcLoc;
         
-        auto graphicalStr = c.graphicalString();
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_UNEXPECTEDCHARACTER, SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, ISSUEACTION_NONE, c);
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Unexpected character: ``" + graphicalStr + "``.", SYNTAXISSUESEVERITY_WARNING, Source(currentWLCharacterStartLoc, currentSourceCharacterEndLoc), 0.85, {}));
-        
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     };
 #endif // !NISSUES
     
@@ -931,7 +889,7 @@ SourceCharacter CharacterDecoder::handleLineContinuation(Buffer tokenStartBuf, S
     
     assert(c.to_point() == '\n' || c.to_point() == '\r' || c.to_point() == CODEPOINT_CRLF);
     
-    c = TheByteDecoder->currentSourceCharacter(policy);
+    c = session->byteDecoder->currentSourceCharacter(policy);
     
     //
     // Even though strings preserve the whitespace after a line continuation, and
@@ -956,24 +914,32 @@ SourceCharacter CharacterDecoder::handleLineContinuation(Buffer tokenStartBuf, S
                 //
                 // Must still count the embedded tab
                 
-                EmbeddedTabs.insert(tokenStartLoc);
+                if ((session->policy & SKIP_EMBEDDED_NEWLINES_AND_TABS) != SKIP_EMBEDDED_NEWLINES_AND_TABS) {
+                    EmbeddedTabs.push_back(tokenStartLoc);
+                }
             }
         }
         
-        TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+        session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
         
-        c = TheByteDecoder->currentSourceCharacter(policy);
+        c = session->byteDecoder->currentSourceCharacter(policy);
     }
     
-    if ((policy & COMPLEX_LINE_CONTINUATIONS) == COMPLEX_LINE_CONTINUATIONS) {
-        ComplexLineContinuations.insert(tokenStartLoc);
+    if ((session->policy & SKIP_LINE_CONTINUATIONS) == SKIP_LINE_CONTINUATIONS) {
+        
+        //
+        // Not collected
+        //
+        
+    } else if ((policy & COMPLEX_LINE_CONTINUATIONS) == COMPLEX_LINE_CONTINUATIONS) {
+        ComplexLineContinuations.push_back(tokenStartLoc);
     } else {
-        SimpleLineContinuations.insert(tokenStartLoc);
+        SimpleLineContinuations.push_back(tokenStartLoc);
     }
     
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
     
     return c;
 }
@@ -987,12 +953,12 @@ WLCharacter CharacterDecoder::handleBackslash(Buffer escapedBuf, SourceLocation
     // converting "\[Alpa]" into "\\[Alpa]", copying that, and then never giving any further warnings
     // when dealing with "\\[Alpa]"
     //
-    if ((policy & ENABLE_UNLIKELY_ESCAPE_CHECKING) == ENABLE_UNLIKELY_ESCAPE_CHECKING) {
+    if ((policy & ENABLE_UNLIKELY_ESCAPE_CHECKING) == ENABLE_UNLIKELY_ESCAPE_CHECKING && (session->policy & SKIP_ISSUES) != SKIP_ISSUES) {
         
-        auto resetBuf = TheByteBuffer->buffer;
-        auto resetLoc = TheByteDecoder->SrcLoc;
+        auto resetBuf = session->byteBuffer->buffer;
+        auto resetLoc = session->byteDecoder->SrcLoc;
         
-        auto test = TheByteDecoder->currentSourceCharacter(policy);
+        auto test = session->byteDecoder->currentSourceCharacter(policy);
         
         if (test.to_point() == '[') {
             
@@ -1003,8 +969,8 @@ WLCharacter CharacterDecoder::handleBackslash(Buffer escapedBuf, SourceLocation
             handleLongName(escapedBuf, escapedLoc, resetBuf, resetLoc, tmpPolicy);
         }
         
-        TheByteBuffer->buffer = resetBuf;
-        TheByteDecoder->SrcLoc = resetLoc;
+        session->byteBuffer->buffer = resetBuf;
+        session->byteDecoder->SrcLoc = resetLoc;
     }
 #endif // !NISSUES
     
@@ -1027,7 +993,7 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
     
     if ((policy & ENABLE_CHARACTER_DECODING_ISSUES) == ENABLE_CHARACTER_DECODING_ISSUES) {
         
-        auto currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
+        auto currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
         
         if (escapedChar.isUpper()) {
             
@@ -1039,7 +1005,7 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
             
             alnumRun += escapedChar.to_point();
             
-            auto curSource = TheByteDecoder->currentSourceCharacter(policy);
+            auto curSource = session->byteDecoder->currentSourceCharacter(policy);
             
             auto wellFormed = false;
             
@@ -1053,15 +1019,15 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
                     
                     alnumRun += curSource.to_point();
                     
-                    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                     
-                    curSource = TheByteDecoder->currentSourceCharacter(policy);
+                    curSource = session->byteDecoder->currentSourceCharacter(policy);
                     
                 } else if (curSource == SourceCharacter(']')) {
                     
-                    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                     
                     wellFormed = true;
                     
@@ -1081,8 +1047,7 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
             
             auto wellFormedAndFound = false;
             if (wellFormed) {
-                auto it = std::lower_bound(LongNameToCodePointMap_names.begin(), LongNameToCodePointMap_names.end(), alnumRun);
-                wellFormedAndFound = (it != LongNameToCodePointMap_names.end() && *it == alnumRun);
+                wellFormedAndFound = (LongNames::findLongName(reinterpret_cast<const unsigned char *>(alnumRun.data()), alnumRun.size()) != -1);
             }
             
             if (wellFormedAndFound) {
@@ -1091,59 +1056,49 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
                 // Something like \Alpha]
                 //
                 
-                currentWLCharacterEndLoc = TheByteDecoder->SrcLoc;
-                
-                auto curSourceGraphicalStr = alnumRun + "]";
-                
-                CodeActionPtrSet Actions;
+                currentWLCharacterEndLoc = session->byteDecoder->SrcLoc;
                 
-                Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert ``[`` to form ``\\[" + alnumRun + "]``", Source(currentWLCharacterStartLoc.next()), "[")));
+                //
+                // The alnum run and the ]
+                //
+                auto escapedBufAndLen = BufferAndLength(unhandledBuf, session->byteBuffer->buffer - unhandledBuf);
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character ``\\") + curSourceGraphicalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDESCAPE, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_INSERTOPENSQUARE, WLCharacter(0), escapedBufAndLen);
                 
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
                 
             } else {
                 
+                //
+                // escapedChar is ASCII, so it is the single byte at unhandledBuf
+                //
+                auto escapedBufAndLen = BufferAndLength(unhandledBuf, 1);
+                
                 if (escapedChar.isHex()) {
                     
-                    auto curSourceGraphicalStr = WLCharacter(escapedChar.to_point()).graphicalString();
-                    
-                    CodeActionPtrSet Actions;
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDESCAPE, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_REPLACEWITHLONGNAMEOR4HEX, WLCharacter(0), escapedBufAndLen);
                     
-                    Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + curSourceGraphicalStr + "XXX]``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\[" + curSourceGraphicalStr + "XXX]")));
-                    Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\:" + curSourceGraphicalStr + "XXX``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\:" + curSourceGraphicalStr + "XXX")));
-                    
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character ``\\") + curSourceGraphicalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
-                    
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                     
                 } else {
                     
-                    auto curSourceGraphicalStr = WLCharacter(escapedChar.to_point()).graphicalString();
-                    
-                    CodeActionPtrSet Actions;
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDESCAPE, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_REPLACEWITHLONGNAME, WLCharacter(0), escapedBufAndLen);
                     
-                    Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + curSourceGraphicalStr + "XXX]``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\[" + curSourceGraphicalStr + "XXX]")));
-                    
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character ``\\") + curSourceGraphicalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
-                    
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                     
                 }
             }
             
         } else if (escapedChar.isHex()) {
             
-            auto curSourceGraphicalStr = WLCharacter(escapedChar.to_point()).graphicalString();
-            
-            CodeActionPtrSet Actions;
-            
-            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\:" + curSourceGraphicalStr + "xxx``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\:" + curSourceGraphicalStr + "xxx")));
+            //
+            // escapedChar is ASCII, so it is the single byte at unhandledBuf
+            //
+            auto escapedBufAndLen = BufferAndLength(unhandledBuf, 1);
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character ``\\") + curSourceGraphicalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDESCAPE, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_REPLACEWITH4HEX, WLCharacter(0), escapedBufAndLen);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
             
         } else if (escapedChar.isEndOfFile()) {
             
@@ -1157,14 +1112,14 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
             // Anything else
             //
             
-            auto curSourceGraphicalStr = WLCharacter(escapedChar.to_point()).graphicalString();
+            auto c = WLCharacter(escapedChar.to_point());
             
-            if (curSourceGraphicalStr.size() > 1) {
+            if (c.graphicalString().size() > 1) {
                 
                 //
                 // Something like \<tab>
                 //
-                // curSourceGraphicalStr is now the 2 characters '\' 't'
+                // The graphical string is now the 2 characters '\' 't'
                 //
                 // This can now be confusing when reporting the issue.
                 // The correct number of backslashes is required.
@@ -1172,19 +1127,20 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
                 // Do the simple thing: No actions, and report the character with all escaped backslashes now
                 //
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character ``\\\\") + curSourceGraphicalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, {}));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDESCAPEDCHARACTER, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_NONE, c);
                 
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
                 
             } else {
                 
-                CodeActionPtrSet Actions;
-                
-                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\" + curSourceGraphicalStr + "``", Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), "\\\\" + curSourceGraphicalStr)));
+                //
+                // A single graphical character is a printable ASCII character, so it is the single byte at unhandledBuf
+                //
+                auto escapedBufAndLen = BufferAndLength(unhandledBuf, 1);
                 
-                auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, std::string("Unrecognized character ``\\") + curSourceGraphicalStr + "``.", SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, std::move(Actions)));
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER, ISSUEMESSAGE_UNRECOGNIZEDESCAPE, SYNTAXISSUESEVERITY_ERROR, Source(currentWLCharacterStartLoc, currentWLCharacterEndLoc), 1.0, ISSUEACTION_ESCAPEBACKSLASH, WLCharacter(0), escapedBufAndLen);
                 
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
                 
             }
         }
@@ -1202,38 +1158,57 @@ WLCharacter CharacterDecoder::handleUnhandledEscape(Buffer currentWLCharacterSta
     // The tokenizer will use the bad character to decide what to do
     //
     
-    TheByteBuffer->buffer = unhandledBuf;
-    TheByteDecoder->SrcLoc = unhandledLoc;
+    session->byteBuffer->buffer = unhandledBuf;
+    session->byteDecoder->SrcLoc = unhandledLoc;
     
     return WLCharacter('\\');
 }
 
 
 #if !NISSUES
-IssuePtrSet& CharacterDecoder::getIssues() {
+IssueVector& CharacterDecoder::getIssues() {
     return Issues;
 }
+
+void CharacterDecoder::addIssue(Issue I) {
+    
+    if ((session->policy & SKIP_ISSUES) == SKIP_ISSUES) {
+        return;
+    }
+    
+    Issues.push_back(std::move(I));
+}
 #endif // !NISSUES
 
-std::set<SourceLocation>& CharacterDecoder::getSimpleLineContinuations() {
+SourceLocationVector& CharacterDecoder::getSimpleLineContinuations() {
     return SimpleLineContinuations;
 }
 
-std::set<SourceLocation>& CharacterDecoder::getComplexLineContinuations() {
+SourceLocationVector& CharacterDecoder::getComplexLineContinuations() {
     return ComplexLineContinuations;
 }
 
-std::set<SourceLocation>& CharacterDecoder::getEmbeddedTabs() {
+SourceLocationVector& CharacterDecoder::getEmbeddedTabs() {
     return EmbeddedTabs;
 }
 
 
 #if USE_MATHLINK
 
-std::string CharacterDecoder::longNameSuggestion(BufferAndLength input) {
+BufferAndLength CharacterDecoder::longNameSuggestion(BufferAndLength input) {
+    
+    //
+    // Suggestions are only given in issues, so there is nothing to do without them either
+    //
+    if ((session->policy & (SKIP_LONG_NAME_SUGGESTIONS | SKIP_ISSUES)) != 0) {
+        return BufferAndLength();
+    }
     
     if (!libData) {
-        return "";
+        
+        missedSuggestion = true;
+        
+        return BufferAndLength();
     }
     
     MLINK link = libData->getMathLink(libData);
@@ -1257,20 +1232,31 @@ std::string CharacterDecoder::longNameSuggestion(BufferAndLength input) {
             assert(false);
         }
         
-        return reinterpret_cast<const char *>(str.get());
+        auto len = str.getByteCount();
+        
+        auto buf = static_cast<MBuffer>(Suggestions.allocate(len, 1));
+        
+        memcpy(buf, str.get(), len);
+        
+        return BufferAndLength(buf, len);
     }
     
-    return "";
+    return BufferAndLength();
 }
 
 #else
 
-std::string CharacterDecoder::longNameSuggestion(BufferAndLength input) {
+BufferAndLength CharacterDecoder::longNameSuggestion(BufferAndLength input) {
     
-    return "";
+    //
+    // There is never a kernel to ask
+    //
+    if ((session->policy & (SKIP_LONG_NAME_SUGGESTIONS | SKIP_ISSUES)) == 0) {
+        missedSuggestion = true;
+    }
+    
+    return BufferAndLength();
 }
 
 #endif // USE_MATHLINK
 
-CharacterDecoderPtr TheCharacterDecoder = nullptr;
-
@@ -1,7 +1,12 @@
 
 #include "ExprLibrary.h"
 
+#if USE_EXPR_LIB
+#include "API.h" // for ParserSession
+#endif // USE_EXPR_LIB
+
 #include <map>
+#include <cassert>
 
 std::map<expr, int> metadata;
 
@@ -93,3 +98,123 @@ DLLEXPORT int Get_LibraryLink(WolframLibraryData libData, mint Argc, MArgument *
 }
 
 #endif // USE_MATHLINK
+
+
+#if USE_EXPR_LIB
+
+ExprBuilder::ExprBuilder(ParserSession *session) : session(session), Stack(), Result(nullptr) {}
+
+ExprBuilder::~ExprBuilder() {
+
+  //
+  // Unfinished after an abort
+  //
+  for (auto& F : Stack) {
+    Expr_Release(F.E);
+  }
+
+  if (Result) {
+    Expr_Release(Result);
+  }
+}
+
+//
+// Takes ownership of e
+//
+void ExprBuilder::insert(expr e) {
+
+  while (true) {
+
+    if (Stack.empty()) {
+      assert(!Result);
+      Result = e;
+      return;
+    }
+
+    auto& F = Stack.back();
+
+    F.Idx++;
+    Expr_Insert(F.E, F.Idx, e);
+    Expr_Release(e);
+
+    if (F.Idx < F.Len) {
+      return;
+    }
+
+    //
+    // F is finished, so insert it into its parent
+    //
+    e = F.E;
+    Stack.pop_back();
+  }
+}
+
+void ExprBuilder::function(const char *Head, size_t Len) {
+
+  //
+  // BuildExpr releases its head with the expression, so giving it the session's symbol would release that symbol for
+  // every node with the same head
+  //
+  auto H = Expr_MEncodedStringToSymbolExpr(reinterpret_cast<const unsigned char *>(Head));
+
+  auto e = Expr_BuildExpr(H, static_cast<mint>(Len));
+
+  if (Len == 0) {
+    insert(e);
+    return;
+  }
+
+  Stack.push_back(Frame{e, static_cast<mint>(Len), 0});
+}
+
+void ExprBuilder::symbol(const char *Name) {
+
+  if (Stack.empty()) {
+    //
+    // The session keeps its symbols, so the caller gets a new one
+    //
+    insert(Expr_MEncodedStringToSymbolExpr(reinterpret_cast<const unsigned char *>(Name)));
+    return;
+  }
+
+  //
+  // Inserted without giving up the session's reference
+  //
+  auto& F = Stack.back();
+
+  F.Idx++;
+  Expr_Insert(F.E, F.Idx, session->symbolExpr(Name));
+
+  if (F.Idx < F.Len) {
+    return;
+  }
+
+  auto e = F.E;
+  Stack.pop_back();
+  insert(e);
+}
+
+void ExprBuilder::integer(int64_t i) {
+  insert(Expr_FromInteger64(i));
+}
+
+void ExprBuilder::real(double d) {
+  insert(Expr_FromReal64(d));
+}
+
+void ExprBuilder::string(const unsigned char *Buf, size_t Len) {
+  insert(Expr_UTF8BytesToStringExpr(Buf, static_cast<mint>(Len)));
+}
+
+expr ExprBuilder::get() {
+
+  if (!Stack.empty()) {
+    return nullptr;
+  }
+
+  auto e = Result;
+  Result = nullptr;
+  return e;
+}
+
+#endif // USE_EXPR_LIB
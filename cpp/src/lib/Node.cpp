@@ -1,13 +1,131 @@
 
 #include "Node.h"
 
-#include "Parser.h" // for TheParser
 #include "ByteEncoder.h" // for ByteEncoder
-#include "API.h" // for TheParserSession
-#include "ByteDecoder.h" // for TheByteDecoder
-#include "ByteBuffer.h" // for TheByteBuffer
+#include "API.h" // for ParserSession
+#include "ByteDecoder.h" // for ByteDecoder
+#include "ByteBuffer.h" // for ByteBuffer
+#include "CSTWriter.h" // for CSTWriter
 
 #include <numeric> // for accumulate
+#include <algorithm> // for reverse
+
+//
+// Where NodeVisit is inside a node: the child sequence, its index, and the index of the next child in it
+//
+template <typename P>
+struct NodeVisitFrame {
+    
+    P N;
+    const NodeSeq *Children;
+    size_t Seq;
+    size_t I;
+    uint32_t Mark;
+    
+    NodeVisitFrame(P N, const NodeSeq *Children) : N(N), Children(Children), Seq(0), I(0), Mark(0) {}
+};
+
+//
+// Visit Root and everything under it in order, without recursion
+//
+// V.leaf(N) visits a node without children, V.open(N, i, Mark) comes before the children in N->childSeq(i), V.next(N)
+// after each child of N, and V.close(N, Mark) after the last child
+//
+// The stack of unfinished nodes is V.Stack in the heap, so a tree that is nested 10^6 deep only costs 10^6 frames of
+// NodeVisitFrame, and a visitor that is used for many trees only allocates its stack once
+//
+// leaf and open may return false to stop the visit, and then NodeVisit returns false
+//
+template <typename P, typename Visitor>
+static bool NodeVisit(P Root, Visitor& V) {
+    
+    auto& Stack = V.Stack;
+    
+    Stack.clear();
+    
+    P N = Root;
+    
+    while (true) {
+        
+        //
+        // Enter N
+        //
+        
+        auto Finished = false;
+        
+        if (auto Children = N->childSeq(0)) {
+            
+            Stack.emplace_back(N, Children);
+            
+            if (!V.open(N, 0, Stack.back().Mark)) {
+                return false;
+            }
+            
+        } else {
+            
+            if (!V.leaf(N)) {
+                return false;
+            }
+            
+            Finished = true;
+        }
+        
+        //
+        // Find the next node to enter, closing the nodes that are finished on the way
+        //
+        
+        N = nullptr;
+        
+        while (!Stack.empty()) {
+            
+            auto& F = Stack.back();
+            
+            if (Finished) {
+                
+                V.next(F.N);
+                
+                Finished = false;
+            }
+            
+            if (F.I < F.Children->count()) {
+                
+                N = F.Children->at(F.I).get();
+                
+                F.I++;
+                
+                break;
+            }
+            
+            F.Seq++;
+            F.I = 0;
+            
+            F.Children = F.N->childSeq(F.Seq);
+            
+            if (F.Children) {
+                
+                if (!V.open(F.N, F.Seq, F.Mark)) {
+                    return false;
+                }
+                
+                continue;
+            }
+            
+            V.close(F.N, F.Mark);
+            
+            Stack.pop_back();
+            
+            Finished = true;
+        }
+        
+        if (!N) {
+            return true;
+        }
+    }
+}
+
+NodeSeq::NodeSeq(ParserSession *session, size_t i) : vec(ArenaAllocator<NodePtr>(session->arena.get())) {
+    vec.reserve(i);
+}
 
 void NodeSeq::append(NodePtr N) {
     vec.push_back(std::move(N));
@@ -15,7 +133,7 @@ void NodeSeq::append(NodePtr N) {
 
 void NodeSeq::appendIfNonEmpty(LeafSeq L) {
     if (!L.empty()) {
-        append(NodePtr(new LeafSeqNode(std::move(L))));
+        append(NodePtr(vec.get_allocator().arena->make<LeafSeqNode>(std::move(L))));
     }
 }
 
@@ -52,40 +170,63 @@ const Node* NodeSeq::last() const {
     return LL;
 }
 
-
-void NodeSeq::print(std::ostream& s) const {
-    
-    s << SYMBOL_LIST->name() << "[";
-    
-    print0(s);
-    
-    s << "]";
-}
-
-void NodeSeq::print0(std::ostream& s) const {
+void NodeSeq::aggregate(std::vector<const Node *>& V) const {
     
     for (auto& C : vec) {
-        C->print(s);
-        s << ", ";
+        C->aggregate(V);
     }
 }
 
-bool NodeSeq::check() const {
+void NodeSeq::leaves(std::vector<Node *>& V) const {
+    
+    //
+    // The nodes that are left, with the next one at the back
+    //
+    // Kept in the heap instead of recursing, as in NodeVisit
+    //
+    std::vector<Node *> Stack;
     
-    auto accum = std::accumulate(vec.begin(), vec.end(), true, [](bool a, const NodePtr& b){ return a && b->check(); });
+    for (auto it = vec.rbegin(); it != vec.rend(); ++it) {
+        Stack.push_back(it->get());
+    }
     
-    return accum;
+    while (!Stack.empty()) {
+        
+        auto N = Stack.back();
+        
+        Stack.pop_back();
+        
+        if (!N->childSeq(0) || N->kind() == CSTNODEKIND_UNTERMINATEDGROUP) {
+            
+            N->leaves0(V);
+            
+            continue;
+        }
+        
+        auto Mark = Stack.size();
+        
+        for (size_t i = 0; auto Children = N->childSeq(i); i++) {
+            
+            for (size_t j = 0; j < Children->count(); j++) {
+                Stack.push_back(Children->at(j).get());
+            }
+        }
+        
+        std::reverse(Stack.begin() + Mark, Stack.end());
+    }
 }
 
 
-void LeafSeq::print0(std::ostream& s) const {
+void LeafSeq::print0(ParserSession *session, std::ostream& s) const {
     
     for (auto& C : vec) {
-        C->print(s);
+        C->print(session, s);
         s << ", ";
     }
 }
 
+LeafSeq::LeafSeq(ParserSession *session) : session(session), vec(ArenaAllocator<LeafNodePtr>(session->arena.get())), moved(false) {}
+
 LeafSeq::~LeafSeq() {
     
     if (moved) {
@@ -107,8 +248,8 @@ LeafSeq::~LeafSeq() {
     
     auto T = First->getToken();
     
-    TheByteBuffer->buffer = T.BufLen.buffer;
-    TheByteDecoder->SrcLoc = T.Src.Start;
+    session->byteBuffer->buffer = T.BufLen.buffer;
+    session->byteDecoder->SrcLoc = T.Src.Start;
 }
 
 void LeafSeq::append(LeafNodePtr N) {
@@ -176,24 +317,98 @@ Token Node::lastToken() const {
     
     assert(!Children.empty());
     
-    auto Last = Children.last();
+    //
+    // Walk down the right edge in a loop instead of recursing at every level
+    //
+    const Node *N = this;
+    
+    while (!N->Children.empty()) {
+        N = N->Children.last();
+    }
+
+    assert(N != this);
+    
+    return N->lastToken();
+}
+
+const NodeSeq* Node::childSeq(size_t i) const {
+    
+    if (i == 0 && !Children.empty()) {
+        return &Children;
+    }
     
-    return Last->lastToken();
+    return nullptr;
 }
 
-void Node::printChildren(std::ostream& s) const {
+struct NodePrintVisitor {
+    
+    ParserSession *session;
+    std::ostream& s;
+    
+    std::vector<NodeVisitFrame<const Node *>> Stack;
+    
+    NodePrintVisitor(ParserSession *session, std::ostream& s) : session(session), s(s), Stack() {}
+    
+    bool leaf(const Node *N) {
+        
+        N->print(session, s);
+        
+        return true;
+    }
+    
+    bool open(const Node *N, size_t i, uint32_t& Mark) {
+        
+        N->printOpen(session, s, i);
+        
+        return true;
+    }
+    
+    void next(const Node *N) {
+        s << ", ";
+    }
+    
+    void close(const Node *N, uint32_t Mark) {
+        N->printClose(session, s);
+    }
+};
+
+void Node::print(ParserSession *session, std::ostream& s) const {
     
-    Children.print(s);
+    assert(childSeq(0));
+    
+    NodePrintVisitor V{session, s};
+    
+    NodeVisit(this, V);
 }
 
+struct NodeCheckVisitor {
+    
+    std::vector<NodeVisitFrame<const Node *>> Stack;
+    
+    bool leaf(const Node *N) {
+        return N->check0();
+    }
+    
+    bool open(const Node *N, size_t i, uint32_t& Mark) {
+        return N->check0();
+    }
+    
+    void next(const Node *N) {}
+    
+    void close(const Node *N, uint32_t Mark) {}
+};
+
 bool Node::check() const {
-    return Children.check();
+    
+    NodeCheckVisitor V;
+    
+    return NodeVisit(this, V);
 }
 
 
-void LeafSeqNode::print(std::ostream& s) const {
+void LeafSeqNode::print(ParserSession *session, std::ostream& s) const {
     
-    Children.print0(s);
+    Children.print0(session, s);
 }
 
 size_t LeafSeqNode::size() const {
@@ -225,19 +440,27 @@ const Node* NodeSeqNode::last() const {
     return Children.last();
 }
 
-void NodeSeqNode::print(std::ostream& s) const {
-    
-    Children.print0(s);
+void NodeSeqNode::aggregate(std::vector<const Node *>& V) const {
+    Children.aggregate(V);
 }
 
-void OperatorNode::print(std::ostream& s) const {
+//
+// A NodeSeqNode has no printOpen or printClose, so its children are spliced into its parent
+//
+    
+void OperatorNode::printOpen(ParserSession *session, std::ostream& s, size_t i) const {
     
     s << MakeSym->name() << "[";
     
     s << Op->name();
     s << ", ";
     
-    printChildren(s);
+    s << SYMBOL_LIST->name() << "[";
+}
+
+void OperatorNode::printClose(ParserSession *session, std::ostream& s) const {
+    
+    s << "]";
     s << ", ";
     
     getSource().print(s);
@@ -246,50 +469,15 @@ void OperatorNode::print(std::ostream& s) const {
 }
 
 
-void LeafNode::print(std::ostream& s) const {
-    
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
-        
-        auto& Sym = TokenToSymbol(Tok.Tok);
-        
-        s << SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name() << "[";
-        
-        s << Sym->name();
-        s << ", ";
-        
-        if (!Tok.Tok.isEmpty()) {
-            
-            Tok.BufLen.printUTF8String(s);
-        }
-        
-        s << ", ";
-        
-        Tok.Src.print(s);
-        
-        s << "]";
-        
-        return;
-    }
+void LeafNode::print(ParserSession *session, std::ostream& s) const {
     
-    auto& Sym = TokenToSymbol(Tok.Tok);
-    
-    s << SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name() << "[";
-    
-    s << Sym->name();
-    s << ", ";
-    
-    if (!Tok.Tok.isEmpty()) {
-        
-        Tok.BufLen.printUTF8String(s);
-    }
-    
-    s << "]";
+    Tok.print(session, s);
 }
 
 
-void ErrorNode::print(std::ostream& s) const {
+void ErrorNode::print(ParserSession *session, std::ostream& s) const {
     
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
+    if ((session->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
         
         auto& Sym = TokenToSymbol(Tok.Tok);
         
@@ -328,57 +516,26 @@ void ErrorNode::print(std::ostream& s) const {
 }
 
 
-void UnterminatedTokenErrorNeedsReparseNode::print(std::ostream& s) const {
-    
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
-        
-        auto& Sym = TokenToSymbol(Tok.Tok);
-        
-        s << SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDTOKENERRORNEEDSREPARSENODE->name() << "[";
-        
-        s << Sym->name();
-        s << ", ";
-        
-        if (!Tok.Tok.isEmpty()) {
-            
-            Tok.BufLen.printUTF8String(s);
-        }
-        
-        s << ", ";
-        
-        Tok.Src.print(s);
-        
-        s << "]";
-        
-        return;
-    }
-    
-    auto& Sym = TokenToSymbol(Tok.Tok);
+void CallNode::printOpen(ParserSession *session, std::ostream& s, size_t i) const {
     
-    s << SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDTOKENERRORNEEDSREPARSENODE->name() << "[";
+    if (i == 0) {
     
-    s << Sym->name();
-    s << ", ";
+        s << SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name() << "[";
     
-    if (!Tok.Tok.isEmpty()) {
+        s << SYMBOL_LIST->name() << "[";
         
-        Tok.BufLen.printUTF8String(s);
+        return;
     }
     
     s << "]";
+    s << ", ";
+    
+    s << SYMBOL_LIST->name() << "[";
 }
 
-
-void CallNode::print(std::ostream& s) const {
-    
-    auto Src = getSource();
-    
-    s << SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name() << "[";
-    
-    Head.print(s);
-    s << ", ";
+void CallNode::printClose(ParserSession *session, std::ostream& s) const {
     
-    printChildren(s);
+    s << "]";
     s << ", ";
     
     Src.print(s);
@@ -386,34 +543,39 @@ void CallNode::print(std::ostream& s) const {
     s << "]";
 }
 
-Source CallNode::getSource() const {
-    
-    const auto& First = Head.first();
+CallNode::CallNode(NodeSeq HeadIn, NodeSeq Body) : Node(std::move(Body)), Head(std::move(HeadIn)), Src(Head.first()->getSource(), Children.last()->getSource()) {}
+
+const NodeSeq* CallNode::childSeq(size_t i) const {
     
-    const auto& Children = getChildrenSafe();
-    const auto& Last = Children.last();
+    if (i == 0) {
+        return &Head;
+    }
     
-    auto FirstSrc = First->getSource();
-    auto LastSrc = Last->getSource();
+    if (i == 1) {
+        return &Children;
+    }
     
-    return Source(FirstSrc, LastSrc);
+    return nullptr;
 }
 
-bool CallNode::check() const {
-    return Children.check() && Head.check();
+Source CallNode::getSource() const {
+    return Src;
 }
 
 
-void SyntaxErrorNode::print(std::ostream& s) const {
-    
-    auto Src = getSource();
+void SyntaxErrorNode::printOpen(ParserSession *session, std::ostream& s, size_t i) const {
     
     s << SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXERRORNODE->name() << "[";
     
     s << SyntaxErrorToString(Err);
     s << ", ";
     
-    printChildren(s);
+    s << SYMBOL_LIST->name() << "[";
+}
+
+void SyntaxErrorNode::printClose(ParserSession *session, std::ostream& s) const {
+    
+    s << "]";
     s << ", ";
     
     Src.print(s);
@@ -422,12 +584,14 @@ void SyntaxErrorNode::print(std::ostream& s) const {
     s << "]";
 }
 
-void CollectedExpressionsNode::print(std::ostream& s) const {
+void CollectedExpressionsNode::print(ParserSession *session, std::ostream& s) const {
+    
+    NodePrintVisitor V{session, s};
     
     s << "List[";
     
     for (auto& E : Exprs) {
-        E->print(s);
+        NodeVisit(E.get(), V);
         s << ", ";
     }
     
@@ -436,18 +600,24 @@ void CollectedExpressionsNode::print(std::ostream& s) const {
 
 bool CollectedExpressionsNode::check() const {
     
-    auto accum = std::accumulate(Exprs.begin(), Exprs.end(), true, [](bool a, const NodePtr& b){ return a && b->check(); });
+    NodeCheckVisitor V;
     
-    return accum;
+    for (auto& E : Exprs) {
+        if (!NodeVisit(E.get(), V)) {
+            return false;
+        }
+    }
+    
+    return true;
 }
 
 
-void CollectedIssuesNode::print(std::ostream& s) const {
+void CollectedIssuesNode::print(ParserSession *session, std::ostream& s) const {
     
     s << "List[";
     
     for (auto& I : Issues) {
-        I->print(s);
+        I.print(s);
         s << ", ";
     }
     
@@ -456,13 +626,13 @@ void CollectedIssuesNode::print(std::ostream& s) const {
 
 bool CollectedIssuesNode::check() const {
     
-    auto accum = std::accumulate(Issues.begin(), Issues.end(), true, [](bool a, const IssuePtr& b){ return a && b->check(); });
+    auto accum = std::accumulate(Issues.begin(), Issues.end(), true, [](bool a, const Issue& b){ return a && b.check(); });
     
     return accum;
 }
 
 
-void CollectedSourceLocationsNode::print(std::ostream& s) const {
+void CollectedSourceLocationsNode::print(ParserSession *session, std::ostream& s) const {
     
     s << "List[";
     
@@ -475,12 +645,14 @@ void CollectedSourceLocationsNode::print(std::ostream& s) const {
 }
 
 
-void ListNode::print(std::ostream& s) const {
+void ListNode::print(ParserSession *session, std::ostream& s) const {
+    
+    NodePrintVisitor V{session, s};
     
     s << "List[";
     
     for (auto& NN : N) {
-        NN->print(s);
+        NodeVisit(NN.get(), V);
         s << ", ";
     }
     
@@ -495,7 +667,7 @@ bool ListNode::check() const {
 }
 
 
-void SourceCharacterNode::print(std::ostream& s) const {
+void SourceCharacterNode::print(ParserSession *session, std::ostream& s) const {
     
     s << SYMBOL_CODEPARSER_LIBRARY_MAKESOURCECHARACTERNODE->name() << "[";
     
@@ -506,7 +678,7 @@ void SourceCharacterNode::print(std::ostream& s) const {
     s << "]\n";
 }
 
-void SafeStringNode::print(std::ostream& s) const {
+void SafeStringNode::print(ParserSession *session, std::ostream& s) const {
     
     s << SYMBOL_CODEPARSER_LIBRARY_MAKESAFESTRINGNODE->name() << "[";
     
@@ -516,162 +688,452 @@ void SafeStringNode::print(std::ostream& s) const {
 }
 
 
+//
+// Nodes are written with the same structure that they are printed with: LeafSeqNode and NodeSeqNode are spliced into
+// their parent, and the head of a Call comes before its body
+//
 
-
-#if USE_MATHLINK
-
-void NodeSeq::put(MLINK mlp) const {
+void LeafSeq::write0(ParserSession *session, CSTWriter& W) const {
     
-    auto s = size();
-    
-    if(!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(s))) {
-        assert(false);
+    for (auto& C : vec) {
+        C->write(session, W);
     }
-    
-    put0(mlp);
 }
 
-void NodeSeq::put0(MLINK mlp) const {
+struct NodeWriteVisitor {
     
-    for (auto& C : vec) {
+    ParserSession *session;
+    CSTWriter& W;
+    
+    std::vector<NodeVisitFrame<const Node *>> Stack;
+    
+    NodeWriteVisitor(ParserSession *session, CSTWriter& W) : session(session), W(W), Stack() {}
+    
+    bool leaf(const Node *N) {
         
-#if !NABORT
-        //
-        // Check isAbort() inside loops
-        //
-        if (TheParserSession->isAbort()) {
-            
-            TheParserSession->handleAbort();
-            return;
-        }
-#endif // !NABORT
+        N->write(session, W);
         
-        C->put(mlp);
+        return true;
     }
-}
-
-void LeafSeq::put0(MLINK mlp) const {
     
-    for (auto& C : vec) {
+    bool open(const Node *N, size_t i, uint32_t& Mark) {
         
-#if !NABORT
-        //
-        // Check isAbort() inside loops
-        //
-        if (TheParserSession->isAbort()) {
-            
-            TheParserSession->handleAbort();
-            return;
-        }
-#endif // !NABORT
+        N->writeOpen(session, W, i, Mark);
         
-        C->put(mlp);
+        return true;
     }
-}
+    
+    void next(const Node *N) {}
+    
+    void close(const Node *N, uint32_t Mark) {
+        N->writeClose(session, W, Mark);
+    }
+};
 
-void Node::putChildren(MLINK mlp) const {
+void Node::write(ParserSession *session, CSTWriter& W) const {
+    
+    assert(childSeq(0));
     
-    Children.put(mlp);
+    NodeWriteVisitor V{session, W};
+    
+    NodeVisit(this, V);
 }
 
-void LeafSeqNode::put(MLINK mlp) const {
+void LeafSeqNode::write(ParserSession *session, CSTWriter& W) const {
     
-    Children.put0(mlp);
+    Children.write0(session, W);
 }
 
-void NodeSeqNode::put(MLINK mlp) const {
+void LeafSeq::aggregate0(std::vector<const Node *>& V) const {
     
-    Children.put0(mlp);
+    for (auto& C : vec) {
+        C->aggregate(V);
+    }
 }
 
-void OperatorNode::put(MLINK mlp) const {
+void LeafSeqNode::aggregate(std::vector<const Node *>& V) const {
+    
+    Children.aggregate0(V);
+}
 
-    if(!MLPutFunction(mlp, MakeSym->name(), static_cast<int>(2 + 4))) {
-        assert(false);
-    }
+void LeafSeq::leaves0(std::vector<Node *>& V) const {
     
-    if(!MLPutSymbol(mlp, Op->name())) {
-        assert(false);
+    for (auto& C : vec) {
+        V.push_back(C.get());
     }
-    
-    putChildren(mlp);
-    
-    getSource().put(mlp);
 }
 
-void LeafNode::put(MLINK mlp) const {
+void LeafSeqNode::leaves0(std::vector<Node *>& V) {
     
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
-
-        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), static_cast<int>(2 + 4))) {
-            assert(false);
-        }
-
-        auto& Sym = TokenToSymbol(Tok.Tok);
+    Children.leaves0(V);
+}
 
-        if (!MLPutSymbol(mlp, Sym->name())) {
-            assert(false);
-        }
+static CSTNodeKind OperatorNodeKind(const SymbolPtr& MakeSym) {
+    
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEPREFIXNODE) {
+        return CSTNODEKIND_PREFIX;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEBINARYNODE) {
+        return CSTNODEKIND_BINARY;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEINFIXNODE) {
+        return CSTNODEKIND_INFIX;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKETERNARYNODE) {
+        return CSTNODEKIND_TERNARY;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEPOSTFIXNODE) {
+        return CSTNODEKIND_POSTFIX;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEPREFIXBINARYNODE) {
+        return CSTNODEKIND_PREFIXBINARY;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEGROUPNODE) {
+        return CSTNODEKIND_GROUP;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKECOMPOUNDNODE) {
+        return CSTNODEKIND_COMPOUND;
+    }
+    if (MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEGROUPMISSINGCLOSERNODE) {
+        return CSTNODEKIND_GROUPMISSINGCLOSER;
+    }
+    
+    assert(MakeSym == SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDGROUPNODE);
+    
+    return CSTNODEKIND_UNTERMINATEDGROUP;
+}
 
-        Tok.BufLen.putUTF8String(mlp);
+CSTNodeKind OperatorNode::kind() const {
+    return OperatorNodeKind(MakeSym);
+}
 
-        Tok.Src.put(mlp);
+void OperatorNode::writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const {
+    
+    Mark = W.open(OperatorNodeKind(MakeSym), W.symbol(Op->name()), getSource());
+}
+    
+void OperatorNode::writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const {
+    
+    W.close(Mark);
+}
+
+void LeafNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    W.leaf(CSTNODEKIND_LEAF, Tok.Tok, W.symbol(TokenToSymbol(Tok.Tok)->name()), Tok.Src, Tok.BufLen);
+}
+
+void ErrorNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    W.leaf(CSTNODEKIND_ERROR, Tok.Tok, W.symbol(TokenToSymbol(Tok.Tok)->name()), Tok.Src, Tok.BufLen);
+}
 
+void CallNode::writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const {
+    
+    if (i == 0) {
+    
+        Mark = W.open(CSTNODEKIND_CALL, CST_NOSYMBOL, getSource());
+    
         return;
     }
 
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), static_cast<int>(2))) {
-        assert(false);
+    W.markHead(Mark);
+}
+    
+void CallNode::writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const {
+    
+    W.close(Mark);
+}
+    
+void SyntaxErrorNode::writeOpen(ParserSession *session, CSTWriter& W, size_t i, uint32_t& Mark) const {
+    
+    Mark = W.open(CSTNODEKIND_SYNTAXERROR, W.symbol(SyntaxErrorToString(Err)), getSource());
+}
+
+void SyntaxErrorNode::writeClose(ParserSession *session, CSTWriter& W, uint32_t Mark) const {
+    
+    W.close(Mark);
+}
+
+void CollectedExpressionsNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    NodeWriteVisitor V{session, W};
+    
+    auto idx = W.open(CSTNODEKIND_LIST, CST_NOSYMBOL, Source());
+    
+    for (auto& E : Exprs) {
+        NodeVisit(E.get(), V);
     }
+    
+    W.close(idx);
+}
 
-    auto& Sym = TokenToSymbol(Tok.Tok);
+void CollectedIssuesNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    W.collectedIssues(Issues);
+}
 
-    if (!MLPutSymbol(mlp, Sym->name())) {
-        assert(false);
+void CollectedSourceLocationsNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    W.collectedSourceLocations(SourceLocs);
+}
+
+void ListNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    NodeWriteVisitor V{session, W};
+    
+    auto idx = W.open(CSTNODEKIND_LIST, CST_NOSYMBOL, Source());
+    
+    for (auto& NN : N) {
+        NodeVisit(NN.get(), V);
     }
+    
+    W.close(idx);
+}
 
-    Tok.BufLen.putUTF8String(mlp);
+void SourceCharacterNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    auto val = Char.to_point();
+    
+    auto S = ByteEncoder::size(val);
+    
+    std::array<unsigned char, 4> Arr;
+    ByteEncoderState state;
+    
+    ByteEncoder::encodeBytes(Arr, val, &state);
+    
+    W.leaf(CSTNODEKIND_SOURCECHARACTER, std::string(reinterpret_cast<const char *>(Arr.data()), S));
+}
+
+void SafeStringNode::write(ParserSession *session, CSTWriter& W) const {
+    
+    W.leaf(CSTNODEKIND_SAFESTRING, std::string(reinterpret_cast<const char *>(safeBytes.data()), safeBytes.size()));
 }
 
-void ErrorNode::put(MLINK mlp) const {
+
+
+void LeafSeq::shift(const SourceShift& S) const {
     
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
+    for (auto& C : vec) {
+        C->shift(S);
+    }
+}
+
+struct NodeShiftVisitor {
+    
+    const SourceShift& S;
+    
+    std::vector<NodeVisitFrame<Node *>> Stack;
+    
+    NodeShiftVisitor(const SourceShift& S) : S(S), Stack() {}
+    
+    bool leaf(Node *N) {
         
-        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(), static_cast<int>(2 + 4))) {
-            assert(false);
+        N->shift0(S);
+        
+        return true;
+    }
+    
+    bool open(Node *N, size_t i, uint32_t& Mark) {
+        
+        if (i == 0) {
+            N->shift0(S);
         }
         
-        auto& Sym = TokenToSymbol(Tok.Tok);
+        return true;
+    }
+    
+    void next(Node *N) {}
+    
+    void close(Node *N, uint32_t Mark) {}
+};
+
+void Node::shift(const SourceShift& S) {
+    
+    NodeShiftVisitor V{S};
+    
+    NodeVisit(this, V);
+}
+
+void LeafSeqNode::shift0(const SourceShift& S) {
+    
+    Children.shift(S);
+}
+
+void OperatorNode::shift0(const SourceShift& S) {
+    
+    S.apply(Src);
+}
+
+void LeafNode::shift0(const SourceShift& S) {
+    
+    S.apply(Tok.Src);
+    S.apply(Tok.BufLen);
+}
+
+void ErrorNode::shift0(const SourceShift& S) {
+    
+    S.apply(Tok.Src);
+    S.apply(Tok.BufLen);
+}
+
+void CallNode::shift0(const SourceShift& S) {
+    
+    S.apply(Src);
+}
+
+void SyntaxErrorNode::shift0(const SourceShift& S) {
+    
+    S.apply(Src);
+}
+
+
+
+#if USE_MATHLINK
+
+struct NodePutVisitor {
+    
+    ParserSession *session;
+    MLINK mlp;
+    
+    std::vector<NodeVisitFrame<const Node *>> Stack;
+    
+    NodePutVisitor(ParserSession *session, MLINK mlp) : session(session), mlp(mlp), Stack() {}
+
+    bool leaf(const Node *N) {
         
-        if (!MLPutSymbol(mlp, Sym->name())) {
-            assert(false);
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return false;
         }
+#endif // !NABORT
         
-        Tok.BufLen.putUTF8String(mlp);
+        N->put(session, mlp);
         
-        Tok.Src.put(mlp);
+        return true;
+    }
+    
+    bool open(const Node *N, size_t i, uint32_t& Mark) {
         
-        return;
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return false;
+        }
+#endif // !NABORT
+        
+        N->putOpen(session, mlp, i);
+        
+        return true;
     }
     
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(), static_cast<int>(2))) {
+    void next(const Node *N) {}
+    
+    void close(const Node *N, uint32_t Mark) {
+        N->putClose(session, mlp);
+    }
+};
+
+void Node::put(ParserSession *session, MLINK mlp) const {
+    
+    assert(childSeq(0));
+    
+    NodePutVisitor V{session, mlp};
+    
+    NodeVisit(this, V);
+}
+
+void LeafSeq::put0(ParserSession *session, MLINK mlp) const {
+    
+    for (auto& C : vec) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return;
+        }
+#endif // !NABORT
+        
+        C->put(session, mlp);
+    }
+}
+
+void LeafSeqNode::put(ParserSession *session, MLINK mlp) const {
+    
+    Children.put0(session, mlp);
+}
+
+void OperatorNode::putOpen(ParserSession *session, MLINK mlp, size_t i) const {
+
+    if(!MLPutFunction(mlp, MakeSym->name(), static_cast<int>(2 + 4))) {
         assert(false);
     }
     
-    auto& Sym = TokenToSymbol(Tok.Tok);
+    if(!MLPutSymbol(mlp, Op->name())) {
+        assert(false);
+    }
     
-    if (!MLPutSymbol(mlp, Sym->name())) {
+    if(!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Children.size()))) {
         assert(false);
     }
+}
+
+void OperatorNode::putClose(ParserSession *session, MLINK mlp) const {
     
+    getSource().put(mlp);
+}
+
+void LeafNode::put(ParserSession *session, MLINK mlp) const {
+    
+    if ((session->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
+
+        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), static_cast<int>(2 + 4))) {
+            assert(false);
+        }
+
+        auto& Sym = TokenToSymbol(Tok.Tok);
+
+        if (!MLPutSymbol(mlp, Sym->name())) {
+            assert(false);
+        }
+
+        Tok.BufLen.putUTF8String(mlp);
+
+        Tok.Src.put(mlp);
+
+        return;
+    }
+
+    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), static_cast<int>(2))) {
+        assert(false);
+    }
+
+    auto& Sym = TokenToSymbol(Tok.Tok);
+
+    if (!MLPutSymbol(mlp, Sym->name())) {
+        assert(false);
+    }
+
     Tok.BufLen.putUTF8String(mlp);
 }
 
-void UnterminatedTokenErrorNeedsReparseNode::put(MLINK mlp) const {
+void ErrorNode::put(ParserSession *session, MLINK mlp) const {
     
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
+    if ((session->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
         
-        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDTOKENERRORNEEDSREPARSENODE->name(), static_cast<int>(2 + 4))) {
+        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(), static_cast<int>(2 + 4))) {
             assert(false);
         }
         
@@ -688,7 +1150,7 @@ void UnterminatedTokenErrorNeedsReparseNode::put(MLINK mlp) const {
         return;
     }
     
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDTOKENERRORNEEDSREPARSENODE->name(), static_cast<int>(2))) {
+    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(), static_cast<int>(2))) {
         assert(false);
     }
     
@@ -701,39 +1163,54 @@ void UnterminatedTokenErrorNeedsReparseNode::put(MLINK mlp) const {
     Tok.BufLen.putUTF8String(mlp);
 }
 
-void CallNode::put(MLINK mlp) const {
+void CallNode::putOpen(ParserSession *session, MLINK mlp, size_t i) const {
     
-    auto Src = getSource();
+    if (i == 0) {
     
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name(), static_cast<int>(2 + 4))) {
-        assert(false);
-    }
+        if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name(), static_cast<int>(2 + 4))) {
+            assert(false);
+        }
+    
+        if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Head.size()))) {
+            assert(false);
+        }
     
-    Head.put(mlp);
+        return;
+    }
     
-    putChildren(mlp);
+    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Children.size()))) {
+        assert(false);
+    }
+}
+
+void CallNode::putClose(ParserSession *session, MLINK mlp) const {
     
     Src.put(mlp);
 }
 
-void SyntaxErrorNode::put(MLINK mlp) const {
-    
-    auto Src = getSource();
+void SyntaxErrorNode::putOpen(ParserSession *session, MLINK mlp, size_t i) const {
     
     if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXERRORNODE->name(), static_cast<int>(2 + 4))) {
         assert(false);
     }
     
-    if (!MLPutSymbol(mlp, SyntaxErrorToString(Err).c_str())) {
+    if (!MLPutSymbol(mlp, SyntaxErrorToString(Err))) {
         assert(false);
     }
     
-    putChildren(mlp);
+    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Children.size()))) {
+        assert(false);
+    }
+}
+
+void SyntaxErrorNode::putClose(ParserSession *session, MLINK mlp) const {
     
     Src.put(mlp);
 }
 
-void CollectedExpressionsNode::put(MLINK mlp) const {
+void CollectedExpressionsNode::put(ParserSession *session, MLINK mlp) const {
+    
+    NodePutVisitor V{session, mlp};
     
     if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Exprs.size()))) {
         assert(false);
@@ -745,18 +1222,18 @@ void CollectedExpressionsNode::put(MLINK mlp) const {
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            TheParserSession->handleAbort();
+            session->handleAbort();
             return;
         }
 #endif // !NABORT
         
-        E->put(mlp);
+        NodeVisit(E.get(), V);
     }
 }
 
-void CollectedIssuesNode::put(MLINK mlp) const {
+void CollectedIssuesNode::put(ParserSession *session, MLINK mlp) const {
     
     if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(Issues.size()))) {
         assert(false);
@@ -768,18 +1245,18 @@ void CollectedIssuesNode::put(MLINK mlp) const {
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            TheParserSession->handleAbort();
+            session->handleAbort();
             return;
         }
 #endif // !NABORT
         
-        I->put(mlp);
+        I.put(mlp);
     }
 }
 
-void CollectedSourceLocationsNode::put(MLINK mlp) const {
+void CollectedSourceLocationsNode::put(ParserSession *session, MLINK mlp) const {
     
     if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(SourceLocs.size()))) {
         assert(false);
@@ -791,9 +1268,9 @@ void CollectedSourceLocationsNode::put(MLINK mlp) const {
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            TheParserSession->handleAbort();
+            session->handleAbort();
             return;
         }
 #endif // !NABORT
@@ -802,7 +1279,9 @@ void CollectedSourceLocationsNode::put(MLINK mlp) const {
     }
 }
 
-void ListNode::put(MLINK mlp) const {
+void ListNode::put(ParserSession *session, MLINK mlp) const {
+    
+    NodePutVisitor V{session, mlp};
     
     if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(N.size()))) {
         assert(false);
@@ -814,18 +1293,18 @@ void ListNode::put(MLINK mlp) const {
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            TheParserSession->handleAbort();
+            session->handleAbort();
             return;
         }
 #endif // !NABORT
         
-        NN->put(mlp);
+        NodeVisit(NN.get(), V);
     }
 }
 
-void SourceCharacterNode::put(MLINK mlp) const {
+void SourceCharacterNode::put(ParserSession *session, MLINK mlp) const {
     
     if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKESOURCECHARACTERNODE->name(), static_cast<int>(2))) {
         assert(false);
@@ -849,7 +1328,7 @@ void SourceCharacterNode::put(MLINK mlp) const {
     }
 }
 
-void SafeStringNode::put(MLINK mlp) const {
+void SafeStringNode::put(ParserSession *session, MLINK mlp) const {
     
     if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKESAFESTRINGNODE->name(), static_cast<int>(1))) {
         assert(false);
@@ -862,3 +1341,304 @@ void SafeStringNode::put(MLINK mlp) const {
 
 #endif // USE_MATHLINK
 
+#if USE_EXPR_LIB
+
+struct NodeToExprVisitor {
+    
+    ParserSession *session;
+    ExprBuilder& B;
+    
+    std::vector<NodeVisitFrame<const Node *>> Stack;
+    
+    NodeToExprVisitor(ParserSession *session, ExprBuilder& B) : session(session), B(B), Stack() {}
+    
+    bool leaf(const Node *N) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return false;
+        }
+#endif // !NABORT
+        
+        N->toExpr(session, B);
+        
+        return true;
+    }
+    
+    bool open(const Node *N, size_t i, uint32_t& Mark) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return false;
+        }
+#endif // !NABORT
+        
+        N->toExprOpen(session, B, i);
+        
+        return true;
+    }
+    
+    void next(const Node *N) {}
+    
+    void close(const Node *N, uint32_t Mark) {
+        N->toExprClose(session, B);
+    }
+};
+
+void Node::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    assert(childSeq(0));
+    
+    NodeToExprVisitor V{session, B};
+    
+    NodeVisit(this, V);
+}
+
+void LeafSeq::toExpr0(ParserSession *session, ExprBuilder& B) const {
+    
+    for (auto& C : vec) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return;
+        }
+#endif // !NABORT
+        
+        C->toExpr(session, B);
+    }
+}
+
+void LeafSeqNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    Children.toExpr0(session, B);
+}
+
+void OperatorNode::toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const {
+
+    B.function(MakeSym->name(), 2 + 4);
+    
+    B.symbol(Op->name());
+    
+    B.function(SYMBOL_LIST->name(), Children.size());
+}
+
+void OperatorNode::toExprClose(ParserSession *session, ExprBuilder& B) const {
+    
+    getSource().toExpr(B);
+}
+
+void LeafNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    if ((session->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
+
+        B.function(SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), 2 + 4);
+
+        auto& Sym = TokenToSymbol(Tok.Tok);
+
+        B.symbol(Sym->name());
+
+        Tok.BufLen.toExprUTF8String(B);
+
+        Tok.Src.toExpr(B);
+
+        return;
+    }
+
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(), 2);
+
+    auto& Sym = TokenToSymbol(Tok.Tok);
+
+    B.symbol(Sym->name());
+
+    Tok.BufLen.toExprUTF8String(B);
+}
+
+void ErrorNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    if ((session->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
+        
+        B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(), 2 + 4);
+        
+        auto& Sym = TokenToSymbol(Tok.Tok);
+        
+        B.symbol(Sym->name());
+        
+        Tok.BufLen.toExprUTF8String(B);
+        
+        Tok.Src.toExpr(B);
+        
+        return;
+    }
+    
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(), 2);
+    
+    auto& Sym = TokenToSymbol(Tok.Tok);
+    
+    B.symbol(Sym->name());
+    
+    Tok.BufLen.toExprUTF8String(B);
+}
+
+void CallNode::toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const {
+    
+    if (i == 0) {
+        
+        B.function(SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name(), 2 + 4);
+        
+        B.function(SYMBOL_LIST->name(), Head.size());
+        
+        return;
+    }
+    
+    B.function(SYMBOL_LIST->name(), Children.size());
+}
+
+void CallNode::toExprClose(ParserSession *session, ExprBuilder& B) const {
+    
+    Src.toExpr(B);
+}
+
+void SyntaxErrorNode::toExprOpen(ParserSession *session, ExprBuilder& B, size_t i) const {
+    
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXERRORNODE->name(), 2 + 4);
+    
+    B.symbol(SyntaxErrorToString(Err));
+    
+    B.function(SYMBOL_LIST->name(), Children.size());
+}
+
+void SyntaxErrorNode::toExprClose(ParserSession *session, ExprBuilder& B) const {
+    
+    Src.toExpr(B);
+}
+
+void CollectedExpressionsNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    NodeToExprVisitor V{session, B};
+    
+    B.function(SYMBOL_LIST->name(), Exprs.size());
+    
+    for (auto& E : Exprs) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return;
+        }
+#endif // !NABORT
+        
+        NodeVisit(E.get(), V);
+    }
+}
+
+void CollectedIssuesNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    B.function(SYMBOL_LIST->name(), Issues.size());
+    
+    for (auto& I : Issues) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return;
+        }
+#endif // !NABORT
+        
+        I.toExpr(B);
+    }
+}
+
+void CollectedSourceLocationsNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    B.function(SYMBOL_LIST->name(), SourceLocs.size());
+    
+    for (auto& L : SourceLocs) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return;
+        }
+#endif // !NABORT
+            
+        L.toExprStructured(B);
+    }
+}
+
+void ListNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    NodeToExprVisitor V{session, B};
+    
+    B.function(SYMBOL_LIST->name(), N.size());
+    
+    for (auto& NN : N) {
+        
+#if !NABORT
+        //
+        // Check isAbort() inside loops
+        //
+        if (session->isAbort()) {
+            
+            session->handleAbort();
+            return;
+        }
+#endif // !NABORT
+        
+        NodeVisit(NN.get(), V);
+    }
+}
+
+void SourceCharacterNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKESOURCECHARACTERNODE->name(), 2);
+    
+    B.symbol(SYMBOL_CODEPARSER_SOURCECHARACTER->name());
+    
+    auto val = Char.to_point();
+    
+    auto S = ByteEncoder::size(val);
+        
+    std::array<unsigned char, 4> Arr;
+    ByteEncoderState state;
+    
+    ByteEncoder::encodeBytes(Arr, val, &state);
+    
+    B.string(reinterpret_cast<Buffer>(Arr.data()), S);
+}
+
+void SafeStringNode::toExpr(ParserSession *session, ExprBuilder& B) const {
+    
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKESAFESTRINGNODE->name(), 1);
+    
+    B.string(reinterpret_cast<Buffer>(safeBytes.data()), safeBytes.size());
+}
+
+#endif // USE_EXPR_LIB
+
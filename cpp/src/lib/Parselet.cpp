@@ -5,34 +5,34 @@
 #include "ParseletRegistration.h"
 
 
-NodePtr LeafParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void LeafParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    auto Left = NodePtr(new LeafNode(TokIn));
+    auto Left = NodePtr(session->arena->make<LeafNode>(TokIn));
     
-    return TheParser->infixLoop(std::move(Left), Ctxt);
+    return session->parser->infixLoop(std::move(Left), Ctxt);
 }
 
 
-NodePtr PrefixErrorParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixErrorParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     assert(TokIn.Tok.isError());
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     NodePtr Error;
     if (TokIn.Tok.isUnterminated()) {
-        Error = NodePtr(new UnterminatedTokenErrorNeedsReparseNode(TokIn));
+        Error = NodePtr(session->arena->make<ErrorNode>(session->tokenizer->recoverUnterminatedToken(TokIn)));
     } else {
-        Error = NodePtr(new ErrorNode(TokIn));
+        Error = NodePtr(session->arena->make<ErrorNode>(TokIn));
     }
     
-    return Error;
+    return session->parser->returnNode(std::move(Error));
 }
 
 
-NodePtr PrefixCloserParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixCloserParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     assert(TokIn.Tok.isCloser());
         
@@ -47,11 +47,11 @@ NodePtr PrefixCloserParselet::parse(Token TokIn, ParserContext Ctxt) const {
     
     auto createdToken = Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(), Source());
     
-    return NodePtr(new ExpectedOperandErrorNode(createdToken));
+    return session->parser->returnNode(NodePtr(session->arena->make<ExpectedOperandErrorNode>(createdToken)));
 }
 
 
-NodePtr PrefixToplevelCloserParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixToplevelCloserParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     assert(TokIn.Tok.isCloser());
     
@@ -59,15 +59,15 @@ NodePtr PrefixToplevelCloserParselet::parse(Token TokIn, ParserContext Ctxt) con
     // if we are at the top, then make sure to take the token and report it
     //
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    auto Error = NodePtr(new ErrorNode(Token(TOKEN_ERROR_UNEXPECTEDCLOSER, TokIn.BufLen, TokIn.Src)));
+    auto Error = NodePtr(session->arena->make<ErrorNode>(Token(TOKEN_ERROR_UNEXPECTEDCLOSER, TokIn.BufLen, TokIn.Src)));
     
-    return Error;
+    return session->parser->returnNode(std::move(Error));
 }
 
 
-NodePtr PrefixEndOfFileParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixEndOfFileParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     //
     // Something like  a+<EOF>
@@ -77,21 +77,21 @@ NodePtr PrefixEndOfFileParselet::parse(Token TokIn, ParserContext Ctxt) const {
     
     auto createdToken = Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(), Source());
     
-    return NodePtr(new ExpectedOperandErrorNode(createdToken));
+    return session->parser->returnNode(NodePtr(session->arena->make<ExpectedOperandErrorNode>(createdToken)));
 }
 
 
-NodePtr PrefixUnsupportedTokenParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixUnsupportedTokenParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     auto createdToken = Token(TOKEN_ERROR_UNSUPPORTEDTOKEN, TokIn.BufLen, TokIn.Src);
     
-    return NodePtr(new ErrorNode(createdToken));
+    return session->parser->returnNode(NodePtr(session->arena->make<ErrorNode>(createdToken)));
 }
 
 
-NodePtr PrefixCommaParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixCommaParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     //
     // if the input is  f[a@,2]  then we want to return TOKEN_ERROR_EXPECTEDOPERAND
@@ -102,34 +102,30 @@ NodePtr PrefixCommaParselet::parse(Token TokIn, ParserContext Ctxt) const {
         
 #if !NISSUES
         {
-            CodeActionPtrSet Actions;
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_COMMA, ISSUEMESSAGE_EXTRACOMMA, SYNTAXISSUESEVERITY_ERROR, TokIn.Src, 1.0, ISSUEACTION_DELETECOMMA);
             
-            Actions.insert(CodeActionPtr(new DeleteTextCodeAction("Delete ``,``", TokIn.Src)));
-            
-            auto I = IssuePtr(new ExtraCommaIssue(TokIn.Src, std::move(Actions)));
-            
-            TheParser->addIssue(std::move(I));
+            session->parser->addIssue(std::move(I));
         }
 #endif // !NISSUES
         
         auto createdToken = Token(TOKEN_FAKE_IMPLICITNULL, BufferAndLength(TokIn.BufLen.buffer), Source(TokIn.Src.Start));
         
-        auto Left = NodePtr(new LeafNode(createdToken));
+        auto Left = NodePtr(session->arena->make<LeafNode>(createdToken));
         
-        return TheParser->infixLoop(std::move(Left), Ctxt);
+        return session->parser->infixLoop(std::move(Left), Ctxt);
         
     } else {
         
         auto createdToken = Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.buffer), Source(TokIn.Src.Start));
         
-        auto Left = NodePtr(new ExpectedOperandErrorNode(createdToken));
+        auto Left = NodePtr(session->arena->make<ExpectedOperandErrorNode>(createdToken));
         
-        return Left;
+        return session->parser->returnNode(std::move(Left));
     }
 }
 
 
-NodePtr PrefixUnhandledParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void PrefixUnhandledParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     assert(!TokIn.Tok.isPossibleBeginning() && "handle at call site");
     
@@ -138,7 +134,7 @@ NodePtr PrefixUnhandledParselet::parse(Token TokIn, ParserContext Ctxt) const {
     //
     Ctxt.Flag &= ~(PARSER_INSIDE_COLON | PARSER_INSIDE_TILDE);
     
-    auto NotPossible = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.buffer), Source(TokIn.Src.Start))));
+    auto NotPossible = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.buffer), Source(TokIn.Src.Start))));
     
     auto I = infixParselets[TokIn.Tok.value()];
     
@@ -158,7 +154,7 @@ NodePtr PrefixUnhandledParselet::parse(Token TokIn, ParserContext Ctxt) const {
         // Make sure that the error leaf is with the + and not the |
         //
         
-        return NotPossible;
+        return session->parser->returnNode(std::move(NotPossible));
     }
     
     //
@@ -169,28 +165,25 @@ NodePtr PrefixUnhandledParselet::parse(Token TokIn, ParserContext Ctxt) const {
     // Do not take next token
     //
     
-    NodeSeq LeftSeq(1);
+    NodeSeq LeftSeq(session, 1);
     LeftSeq.append(std::move(NotPossible));
     
-    auto NotPossible2 = infixParselets[TokIn.Tok.value()]->parse(std::move(LeftSeq), TokIn, Ctxt);
-    
-    return NotPossible2;
+    return infixParselets[TokIn.Tok.value()]->parse(session, std::move(LeftSeq), TokIn, Ctxt);
 }
 
 
-NodePtr InfixToplevelNewlineParselet::parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const {
+void InfixToplevelNewlineParselet::parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const {
     assert(false);
-    return nullptr;
 }
 
 
-NodePtr SymbolParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void SymbolParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    auto Sym = NodePtr(new LeafNode(TokIn));
+    auto Sym = NodePtr(session->arena->make<LeafNode>(TokIn));
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
     
     //
     // if we are here, then we know that Sym could bind to _
@@ -199,39 +192,39 @@ NodePtr SymbolParselet::parse(Token TokIn, ParserContext Ctxt) const {
     switch (Tok.Tok.value()) {
         case TOKEN_UNDER.value(): {
             
-            NodeSeq Args(1);
+            NodeSeq Args(session, 1);
             Args.append(std::move(Sym));
             
-            return contextSensitiveUnder1Parselet->parseContextSensitive(std::move(Args), Tok, Ctxt);
+            return contextSensitiveUnder1Parselet->parseContextSensitive(session, std::move(Args), Tok, Ctxt);
         }
         case TOKEN_UNDERUNDER.value(): {
             
-            NodeSeq Args(1);
+            NodeSeq Args(session, 1);
             Args.append(std::move(Sym));
             
-            return contextSensitiveUnder2Parselet->parseContextSensitive(std::move(Args), Tok, Ctxt);
+            return contextSensitiveUnder2Parselet->parseContextSensitive(session, std::move(Args), Tok, Ctxt);
         }
         case TOKEN_UNDERUNDERUNDER.value(): {
             
-            NodeSeq Args(1);
+            NodeSeq Args(session, 1);
             Args.append(std::move(Sym));
             
-            return contextSensitiveUnder3Parselet->parseContextSensitive(std::move(Args), Tok, Ctxt);
+            return contextSensitiveUnder3Parselet->parseContextSensitive(session, std::move(Args), Tok, Ctxt);
         }
         case TOKEN_UNDERDOT.value(): {
             
-            NodeSeq Args(1);
+            NodeSeq Args(session, 1);
             Args.append(std::move(Sym));
             
-            return contextSensitiveUnderDotParselet->parseContextSensitive(std::move(Args), Tok, Ctxt);
+            return contextSensitiveUnderDotParselet->parseContextSensitive(session, std::move(Args), Tok, Ctxt);
         }
             break;
         default: {
             
             {
-                LeafSeq Trivia1;
+                LeafSeq Trivia1(session);
                 
-                Tok = TheParser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia1);
+                Tok = session->parser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia1);
                 
                 //
                 // when parsing a in a:b  then PARSER_INSIDE_COLON bit is 0
@@ -245,48 +238,63 @@ NodePtr SymbolParselet::parse(Token TokIn, ParserContext Ctxt) const {
                     
                     if ((Ctxt.Flag & PARSER_INSIDE_COLON) != PARSER_INSIDE_COLON) {
                         
-                        NodeSeq Args(1 + 1);
+                        NodeSeq Args(session, 1 + 1);
                         Args.append(std::move(Sym));
                         Args.appendIfNonEmpty(std::move(Trivia1));
                         
-                        Sym = infixParselets[TOKEN_COLON.value()]->parse(std::move(Args), Tok, Ctxt);
+                        session->parser->pushInfixLoop(Ctxt);
+                        
+                        return infixParselets[TOKEN_COLON.value()]->parse(session, std::move(Args), Tok, Ctxt);
                     }
                 }
             }
             
-            return TheParser->infixLoop(std::move(Sym), Ctxt);
+            return session->parser->infixLoop(std::move(Sym), Ctxt);
         }
     }
     
     assert(false);
-    return nullptr;
 }
 
-NodePtr SymbolParselet::parseContextSensitive(Token TokIn, ParserContext Ctxt) const {
+NodePtr SymbolParselet::parseContextSensitive(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    auto Sym = NodePtr(new LeafNode(TokIn));
+    auto Sym = NodePtr(session->arena->make<LeafNode>(TokIn));
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     return Sym;
 }
 
 
-NodePtr PrefixOperatorParselet::parse(Token TokIn, ParserContext CtxtIn) const {
+void PrefixOperatorParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = getPrecedence(Ctxt);
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    NodePtr Left;
-    {
-        LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
         
-        auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
         
-        auto Operand = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void PrefixOperatorParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const PrefixOperatorParselet *>(F.P);
+    
+    auto TokIn = F.Tok;
+    
+    NodePtr Left;
+    {
+        auto Trivia1 = std::move(F.Trivia);
         
         if (Operand->isExpectedOperandError()) {
             
@@ -294,30 +302,29 @@ NodePtr PrefixOperatorParselet::parse(Token TokIn, ParserContext CtxtIn) const {
             // Reattach the ExpectedOperand Error to the operator for a better experience
             //
             
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+            auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
             
-            NodeSeq Args(1 + 1);
-            Args.append(NodePtr(new LeafNode(TokIn)));
+            NodeSeq Args(session, 1 + 1);
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
             Args.append(std::move(ProperExpectedOperandError));
-            Left = NodePtr(new PrefixNode(Op, std::move(Args)));
+            Left = NodePtr(session->arena->make<PrefixNode>(P->Op, std::move(Args)));
             
         } else {
             
-            NodeSeq Args(1 + 1 + 1);
-            Args.append(NodePtr(new LeafNode(TokIn)));
+            NodeSeq Args(session, 1 + 1 + 1);
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
             Args.appendIfNonEmpty(std::move(Trivia1));
             Args.append(std::move(Operand));
-            Left = NodePtr(new PrefixNode(Op, std::move(Args)));
+            Left = NodePtr(session->arena->make<PrefixNode>(P->Op, std::move(Args)));
         }
     }
     
-    return TheParser->infixLoop(std::move(Left), CtxtIn);
+    return session->parser->infixLoop(std::move(Left), F.CtxtIn);
 }
 
 
-NodePtr InfixImplicitTimesParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void InfixImplicitTimesParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     assert(false);
-    return nullptr;
 }
 
 
@@ -337,27 +344,41 @@ Token InfixImplicitTimesParselet::processImplicitTimes(Token TokIn, ParserContex
 }
 
 
-NodePtr InfixAssertFalseParselet::parse(NodeSeq Left, Token firstTok, ParserContext Ctxt) const {
+void InfixAssertFalseParselet::parse(ParserSession *session, NodeSeq Left, Token firstTok, ParserContext Ctxt) const {
     assert(false);
-    return nullptr;
 }
 
 
-NodePtr BinaryOperatorParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void BinaryOperatorParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = getPrecedence(Ctxt);
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    NodePtr L;
-    {
-        LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
+    
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Args = std::move(Left);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void BinaryOperatorParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Right) {
     
-        auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto P = static_cast<const BinaryOperatorParselet *>(F.P);
     
-        auto Right = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    auto TokIn = F.Tok;
+    
+    NodePtr L;
+    {
+        auto Trivia1 = std::move(F.Trivia);
         
         if (Right->isExpectedOperandError()) {
 
@@ -365,54 +386,71 @@ NodePtr BinaryOperatorParselet::parse(NodeSeq Left, Token TokIn, ParserContext C
             // Reattach the ExpectedOperand Error to the operator for a better experience
             //
             
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+            auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
             
-            NodeSeq Args(1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
+            NodeSeq Args(session, 1 + 1 + 1);
+            Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(F.Args))));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
             Args.append(std::move(ProperExpectedOperandError));
-            L = NodePtr(new BinaryNode(Op, std::move(Args)));
+            L = NodePtr(session->arena->make<BinaryNode>(P->Op, std::move(Args)));
             
         } else {
             
-            NodeSeq Args(1 + 1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
+            NodeSeq Args(session, 1 + 1 + 1 + 1);
+            Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(F.Args))));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
             Args.appendIfNonEmpty(std::move(Trivia1));
             Args.append(std::move(Right));
-            L = NodePtr(new BinaryNode(Op, std::move(Args)));
+            L = NodePtr(session->arena->make<BinaryNode>(P->Op, std::move(Args)));
         }
     }
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr InfixOperatorParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
-    
-    NodePtr L;
+void InfixOperatorParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
-    NodeSeq Args(1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
+    NodeSeq Args(session, 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = getPrecedence(Ctxt);
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     //
     // Unroll 1 iteration of the loop because we know that TokIn has already been read
     //
-    Token OperandLastToken;
-    {
-        LeafSeq Trivia2;
+    LeafSeq Trivia2(session);
         
-        auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok2 = TheParser->eatTrivia(Tok2, Ctxt, TOPLEVEL, Trivia2);
+    auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok2 = session->parser->eatTrivia(Tok2, Ctxt, TOPLEVEL, Trivia2);
         
-        auto Operand = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
         
-        OperandLastToken = Operand->lastToken();
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia2);
+    
+    return session->parser->parsePrefix(Tok2, Ctxt);
+}
+
+void InfixOperatorParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const InfixOperatorParselet *>(F.P);
+    
+    //
+    // The operator before Operand
+    //
+    auto Tok1 = F.Tok;
+    
+    auto OperandLastToken = Operand->lastToken();
+    {
+        auto Trivia2 = std::move(F.Trivia);
         
         if (Operand->isExpectedOperandError()) {
             
@@ -420,136 +458,121 @@ NodePtr InfixOperatorParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ct
             // Reattach the ExpectedOperand Error to the operator for a better experience
             //
             
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+            auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(Tok1.BufLen.end), Source(Tok1.Src.End))));
             
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(std::move(ProperExpectedOperandError));
+            F.Args.append(std::move(ProperExpectedOperandError));
             
         } else {
             
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.appendIfNonEmpty(std::move(Trivia2));
-            Args.append(std::move(Operand));
+            //
+            // Do not reserve inside loop
+            // Allow default resizing strategy, which is hopefully exponential
+            //
+            F.Args.appendIfNonEmpty(std::move(Trivia2));
+            F.Args.append(std::move(Operand));
         }
     }
     
-    while (true) {
+    return P->parseLoop(session, std::move(F.Args), OperandLastToken, F.Ctxt, F.CtxtIn);
+}
+
+void InfixOperatorParselet::parseLoop(ParserSession *session, NodeSeq Args, Token OperandLastToken, ParserContext Ctxt, ParserContext CtxtIn) const {
 
 #if !NABORT
-        //
-        // Check isAbort() inside loops
-        //
-        if (TheParserSession->isAbort()) {
+    //
+    // Check isAbort() inside loops
+    //
+    if (session->isAbort()) {
             
-            return TheParserSession->handleAbort();
-        }
+        return session->parser->returnNode(session->handleAbort());
+    }
 #endif // !NABORT
         
-        auto Tok1 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        {
-            LeafSeq Trivia1;
+    auto Tok1 = session->parser->currentToken(Ctxt, TOPLEVEL);
+    {
+        LeafSeq Trivia1(session);
             
-            Tok1 = TheParser->eatTriviaButNotToplevelNewlines(Tok1, Ctxt, TOPLEVEL, Trivia1);
+        Tok1 = session->parser->eatTriviaButNotToplevelNewlines(Tok1, Ctxt, TOPLEVEL, Trivia1);
             
-            auto I = infixParselets[Tok1.Tok.value()];
+        auto I = infixParselets[Tok1.Tok.value()];
             
-            Tok1 = I->processImplicitTimes(Tok1, Ctxt);
-            I = infixParselets[Tok1.Tok.value()];
+        Tok1 = I->processImplicitTimes(Tok1, Ctxt);
+        I = infixParselets[Tok1.Tok.value()];
             
+        //
+        // Cannot just compare tokens
+        //
+        // May be something like  a * b c \[Times] d
+        //
+        // and we want only a single Infix node created
+        //
+        if (I->getOp() != Op) {
+                
             //
-            // Cannot just compare tokens
-            //
-            // May be something like  a * b c \[Times] d
-            //
-            // and we want only a single Infix node created
+            // Tok.Tok != TokIn.Tok, so break
             //
-            if (I->getOp() != Op) {
-                
-                //
-                // Tok.Tok != TokIn.Tok, so break
-                //
                 
-                L = NodePtr(new InfixNode(Op, std::move(Args)));
+            auto L = NodePtr(session->arena->make<InfixNode>(Op, std::move(Args)));
                 
-                break;
-            }
+            return session->parser->infixLoop(std::move(L), CtxtIn);
+        }
             
-            if (Tok1.Tok == TOKEN_FAKE_IMPLICITTIMES) {
+        if (Tok1.Tok == TOKEN_FAKE_IMPLICITTIMES) {
                 
-                //
-                // Reattach the ImplicitTimes to the operand for a better experience
-                //
+            //
+            // Reattach the ImplicitTimes to the operand for a better experience
+            //
                 
-                Tok1 = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(OperandLastToken.BufLen.end), Source(OperandLastToken.Src.End));
+            Tok1 = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(OperandLastToken.BufLen.end), Source(OperandLastToken.Src.End));
                 
-                Args.append(NodePtr(new LeafNode(Tok1)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
                 
-            } else {
+        } else {
                 
-                TheParser->nextToken(Tok1);
+            session->parser->nextToken(Tok1);
                 
-                Args.appendIfNonEmpty(std::move(Trivia1));
-                Args.append(NodePtr(new LeafNode(Tok1)));
-            }
+            Args.appendIfNonEmpty(std::move(Trivia1));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
         }
+    }
         
+    LeafSeq Trivia2(session);
         
-        LeafSeq Trivia2;
-        
-        auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok2 = TheParser->eatTrivia(Tok2, Ctxt, TOPLEVEL, Trivia2);
-        
-        auto Operand = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
-        
-        OperandLastToken = Operand->lastToken();
-        
-        if (Operand->isExpectedOperandError()) {
-            
-            //
-            // Reattach the ExpectedOperand Error to the operator for a better experience
-            //
-            
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(Tok1.BufLen.end), Source(Tok1.Src.End))));
-            
-            Args.append(std::move(ProperExpectedOperandError));
-            
-            continue;
-        }
+    auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok2 = session->parser->eatTrivia(Tok2, Ctxt, TOPLEVEL, Trivia2);
         
-        //
-        // Do not reserve inside loop
-        // Allow default resizing strategy, which is hopefully exponential
-        //
-        Args.appendIfNonEmpty(std::move(Trivia2));
-        Args.append(std::move(Operand));
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.CtxtIn = CtxtIn;
+    F.Tok = Tok1;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia2);
         
-    } // while
-    
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->parsePrefix(Tok2, Ctxt);
 }
 
 
-NodePtr PostfixOperatorParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void PostfixOperatorParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    NodeSeq Args(1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-    Args.append(NodePtr(new LeafNode(TokIn)));
+    NodeSeq Args(session, 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     
-    auto L = NodePtr(new PostfixNode(Op, std::move(Args)));
+    auto L = NodePtr(session->arena->make<PostfixNode>(Op, std::move(Args)));
     
-    return TheParser->infixLoop(std::move(L), Ctxt);
+    return session->parser->infixLoop(std::move(L), Ctxt);
 }
 
 
-NodePtr GroupParselet::parse(Token firstTok, ParserContext CtxtIn) const {
+void GroupParselet::parse(ParserSession *session, Token firstTok, ParserContext CtxtIn) const {
     
     auto OpenerT = firstTok;
     
     auto Ctxt = CtxtIn;
     
-    TheParser->nextToken(firstTok);
+    session->parser->nextToken(firstTok);
     
     Ctxt.Closr = Closr;
     
@@ -559,8 +582,8 @@ NodePtr GroupParselet::parse(Token firstTok, ParserContext CtxtIn) const {
     Ctxt.Flag &= ~(PARSER_INSIDE_COLON | PARSER_INSIDE_TILDE);
     Ctxt.Prec = PRECEDENCE_LOWEST;
     
-    NodeSeq Args(1);
-    Args.append(NodePtr(new LeafNode(OpenerT)));
+    NodeSeq Args(session, 1);
+    Args.append(NodePtr(session->arena->make<LeafNode>(OpenerT)));
     
     //
     // There will only be 1 "good" node (either a LeafNode or a CommaNode)
@@ -570,177 +593,226 @@ NodePtr GroupParselet::parse(Token firstTok, ParserContext CtxtIn) const {
     // e.g. {1\\2}
     //
     
-    NodePtr group;
+    return parseLoop(session, std::move(Args), Ctxt, CtxtIn);
+}
     
-    while (true) {
+void GroupParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const GroupParselet *>(F.P);
+    
+    //
+    // Do not reserve inside loop
+    // Allow default resizing strategy, which is hopefully exponential
+    //
+    
+    //
+    // Always append here
+    //
+    F.Args.append(std::move(Operand));
+    
+    return P->parseLoop(session, std::move(F.Args), F.Ctxt, F.CtxtIn);
+}
+
+void GroupParselet::parseLoop(ParserSession *session, NodeSeq Args, ParserContext Ctxt, ParserContext CtxtIn) const {
         
 #if !NABORT
-        //
-        // Check isAbort() inside loops
-        //
-        if (TheParserSession->isAbort()) {
+    //
+    // Check isAbort() inside loops
+    //
+    if (session->isAbort()) {
             
-            return TheParserSession->handleAbort();
-        }
+        return session->parser->returnNode(session->handleAbort());
+    }
 #endif // !NABORT
         
-        LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
         
-        auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
         
-        if (TokenToCloser(Tok.Tok) == Closr) {
+    if (TokenToCloser(Tok.Tok) == Closr) {
             
-            //
-            // Everything is good
-            //
+        //
+        // Everything is good
+        //
             
-            TheParser->nextToken(Tok);
+        session->parser->nextToken(Tok);
             
-            //
-            // Do not reserve inside loop
-            // Allow default resizing strategy, which is hopefully exponential
-            //
-            Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(NodePtr(new LeafNode(Tok)));
+        //
+        // Do not reserve inside loop
+        // Allow default resizing strategy, which is hopefully exponential
+        //
+        Args.appendIfNonEmpty(std::move(Trivia1));
+        Args.append(NodePtr(session->arena->make<LeafNode>(Tok)));
             
-            group = NodePtr(new GroupNode(Op, std::move(Args)));
+        auto group = NodePtr(session->arena->make<GroupNode>(Op, std::move(Args)));
             
-            break;
-        }
+        return session->parser->infixLoop(std::move(group), CtxtIn);
+    }
         
-        if (Tok.Tok.isCloser()) {
+    if (Tok.Tok.isCloser()) {
             
+        //
+        // some other closer
+        //
+        // Something like  { ( }  or  { ) }
+        //
+        // Must choose which one to parse correctly.
+        //
+        // There are pros and cons with either choice here.
+        //
+        // But it is important to note that either choice here results in strictly better behavior than the FrontEnd choice to parse neither  { ( }  nor  { ) }  correctly.
+        //
+        // The FrontEnd parses  { ( }  as  RowBox[{RowBox[{"{", "("}], "}"}]  but it would be better to parse as  RowBox[{"{", someErrorThing["("], "}"}]
+        // The FrontEnd parses  { ) }  as  RowBox[{RowBox[{"{", ")"}], "}"}]  but it would be better to parse as  RowBox[{"{", someErrorThing[")"], "}"}]
+        //
+        auto arbitraryChoiceToBubbleBadCloserUpTheStack = true;
+            
+        if (arbitraryChoiceToBubbleBadCloserUpTheStack) {
+                
             //
-            // some other closer
-            //
-            // Something like  { ( }  or  { ) }
-            //
-            // Must choose which one to parse correctly.
-            //
-            // There are pros and cons with either choice here.
+            // Do not consume the bad closer now
+            // Bubble it up the stack
             //
-            // But it is important to note that either choice here results in strictly better behavior than the FrontEnd choice to parse neither  { ( }  nor  { ) }  correctly.
+            // This allows  { ( }  to be parsed as expected
             //
-            // The FrontEnd parses  { ( }  as  RowBox[{RowBox[{"{", "("}], "}"}]  but it would be better to parse as  RowBox[{"{", someErrorThing["("], "}"}]
-            // The FrontEnd parses  { ) }  as  RowBox[{RowBox[{"{", ")"}], "}"}]  but it would be better to parse as  RowBox[{"{", someErrorThing[")"], "}"}]
+            // But also makes  { ) }  get parsed as MissingCloser[ { ] UnexpectedCloser[ ) ] UnexpectedCloser[ } ]
             //
-            auto arbitraryChoiceToBubbleBadCloserUpTheStack = true;
-            
-            if (arbitraryChoiceToBubbleBadCloserUpTheStack) {
-                
-                //
-                // Do not consume the bad closer now
-                // Bubble it up the stack
-                //
-                // This allows  { ( }  to be parsed as expected
-                //
-                // But also makes  { ) }  get parsed as MissingCloser[ { ] UnexpectedCloser[ ) ] UnexpectedCloser[ } ]
-                //
                 
-                group = NodePtr(new GroupMissingCloserNode(Op, std::move(Args)));
+            auto group = NodePtr(session->arena->make<GroupMissingCloserNode>(Op, std::move(Args)));
                 
-                break;
+            return session->parser->infixLoop(std::move(group), CtxtIn);
                 
-            } else {
-                
-                //
-                // Consume the bad closer now
-                //
-                // This allows  { ) }  to be parsed as expected
-                //
-                // But also makes  { ( }  get parsed as MissingCloser[ {, MissingCloser[ (, UnexpectedCloser[ } ] ] ]
-                //
-                
-                //
-                // Allow PrefixCloserParselet to handle the error
-                //
-                Ctxt.Closr = CLOSER_OPEN;
-                
-                auto Error = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
-                
-                Ctxt.Closr = Closr;
+        } else {
                 
-                //
-                // Always append here
-                //
-                Args.appendIfNonEmpty(std::move(Trivia1));
-                Args.append(std::move(Error));
+            //
+            // Consume the bad closer now
+            //
+            // This allows  { ) }  to be parsed as expected
+            //
+            // But also makes  { ( }  get parsed as MissingCloser[ {, MissingCloser[ (, UnexpectedCloser[ } ] ] ]
+            //
                 
-                continue;
-            }
-        }
-        if (Tok.Tok == TOKEN_ENDOFFILE) {
-            
             //
-            // Handle something like   { a EOF
+            // Always append here
             //
+            Args.appendIfNonEmpty(std::move(Trivia1));
             
-            group = NodePtr(new UnterminatedGroupNeedsReparseNode(Op, std::move(Args)));
+            auto& F = session->parser->pushFrame(parse1, this);
+            F.Ctxt = Ctxt;
+            F.CtxtIn = CtxtIn;
+            F.Args = std::move(Args);
             
-            break;
+            //
+            // Allow PrefixCloserParselet to handle the error
+            //
+            Ctxt.Closr = CLOSER_OPEN;
+                
+            return session->parser->parsePrefix(Tok, Ctxt);
         }
-        
+    }
+    if (Tok.Tok == TOKEN_ENDOFFILE) {
+            
         //
-        // Handle the expression
+        // Handle something like   { a EOF
         //
-        
-        auto Operand = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
-        
+        // The group took the rest of the input, so only keep its leaves that are before the end of the first chunk of
+        // lines after the opener, as found by Tokenizer::recoverUnterminated
         //
-        // Do not reserve inside loop
-        // Allow default resizing strategy, which is hopefully exponential
+        // The structure of the rest is not useful: it was parsed inside of a group that is never closed
         //
+            
+        auto OpenerT = Args.first()->lastToken();
+        
+        SourceLocation End;
+        auto EndBuf = session->tokenizer->recoverUnterminated(OpenerT.BufLen.buffer, OpenerT.Src.Start, End);
+        
+        std::vector<Node *> Leaves;
+        Args.leaves(Leaves);
         
         //
-        // Always append here
+        // The nodes are moved from Args to Recovered, and the rest of Args is dropped
         //
-        Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(Operand));
+        NodeSeq Recovered(session);
         
-    } // while
+        for (auto L : Leaves) {
+            
+            //
+            // An UnterminatedGroupNode inside of this group that starts before EndBuf was recovered up to EndBuf also,
+            // so only its opener is checked instead of walking down to its last leaf
+            //
+            auto Tok = (L->kind() == CSTNODEKIND_UNTERMINATEDGROUP) ? L->getChildrenSafe().first()->lastToken() : L->lastToken();
+            
+            if (Tok.BufLen.buffer == nullptr || Tok.BufLen.end > EndBuf) {
+                continue;
+            }
+            
+            Recovered.append(NodePtr(L));
+        }
+        
+        auto group = NodePtr(session->arena->make<UnterminatedGroupNode>(Op, std::move(Recovered), Source(OpenerT.Src.Start, End)));
+            
+        return session->parser->infixLoop(std::move(group), CtxtIn);
+    }
+        
+    //
+    // Handle the expression
+    //
+        
+    //
+    // Always append here
+    //
+    Args.appendIfNonEmpty(std::move(Trivia1));
+        
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.CtxtIn = CtxtIn;
+    F.Args = std::move(Args);
     
-    return TheParser->infixLoop(std::move(group), CtxtIn);
+    return session->parser->parsePrefix(Tok, Ctxt);
 }
 
 
-NodePtr CallParselet::parse(NodeSeq Head, Token TokIn, ParserContext CtxtIn) const {
+void CallParselet::parse(ParserSession *session, NodeSeq Head, Token TokIn, ParserContext CtxtIn) const {
     
     //
     // if we used PRECEDENCE_CALL here, then e.g., a[]?b should technically parse as   a <call> []?b
     //
     
-    NodePtr L;
-    
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_HIGHEST;
     
-    auto Right = GP->parse(TokIn, Ctxt);
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.CtxtIn = CtxtIn;
+    F.Args = std::move(Head);
     
-    NodeSeq Args(1);
+    return GP->parse(session, TokIn, Ctxt);
+}
+
+void CallParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Right) {
+    
+    NodeSeq Args(session, 1);
     Args.append(std::move(Right));
     
-    L = NodePtr(new CallNode(std::move(Head), std::move(Args)));
+    auto L = NodePtr(session->arena->make<CallNode>(std::move(F.Args), std::move(Args)));
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr TildeParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
-    
-    NodePtr L;
+void TildeParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     auto FirstTilde = TokIn;
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_LOWEST;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
     
-    auto FirstTok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    FirstTok = TheParser->eatTrivia(FirstTok, Ctxt, TOPLEVEL, Trivia1);
+    auto FirstTok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    FirstTok = session->parser->eatTrivia(FirstTok, Ctxt, TOPLEVEL, Trivia1);
     
     Ctxt.Flag |= PARSER_INSIDE_TILDE;
     //
@@ -748,7 +820,27 @@ NodePtr TildeParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
     //
     Ctxt.Flag &= ~(PARSER_INSIDE_COLON);
     
-    auto Middle = prefixParselets[FirstTok.Tok.value()]->parse(FirstTok, Ctxt);
+    NodeSeq Args(session, 1 + 1 + 1 + 1 + 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(FirstTilde)));
+    
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.CtxtIn = CtxtIn;
+    F.Tok = FirstTilde;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(FirstTok, Ctxt);
+}
+
+void TildeParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Middle) {
+    
+    auto Trivia1 = std::move(F.Trivia);
+    
+    auto FirstTilde = F.Tok;
+    
+    auto Ctxt = F.Ctxt;
     
     if (Middle->isExpectedOperandError()) {
         
@@ -758,21 +850,18 @@ NodePtr TildeParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
         // Not structurally correct, so return SyntaxErrorNode
         //
         
-        auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(FirstTilde.BufLen.end), Source(FirstTilde.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(FirstTilde.BufLen.end), Source(FirstTilde.Src.End))));
         
-        NodeSeq Args(1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(FirstTilde)));
-        Args.append(std::move(ProperExpectedOperandError));
-        auto Error = NodePtr(new BinaryNode(SYMBOL_CODEPARSER_TERNARYTILDE, std::move(Args)));
+        F.Args.append(std::move(ProperExpectedOperandError));
+        auto Error = NodePtr(session->arena->make<BinaryNode>(SYMBOL_CODEPARSER_TERNARYTILDE, std::move(F.Args)));
         
-        return Error;
+        return session->parser->returnNode(std::move(Error));
     }
     
-    LeafSeq Trivia2;
+    LeafSeq Trivia2(session);
     
-    auto Tok1 = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok1 = TheParser->eatTrivia(Tok1, Ctxt, TOPLEVEL, Trivia2);
+    auto Tok1 = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok1 = session->parser->eatTrivia(Tok1, Ctxt, TOPLEVEL, Trivia2);
     
     if (Tok1.Tok != TOKEN_TILDE) {
         
@@ -782,18 +871,15 @@ NodePtr TildeParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
         // Not structurally correct, so return SyntaxErrorNode
         //
         
-        NodeSeq Args(1 + 1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(FirstTilde)));
-        Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(Middle));
+        F.Args.appendIfNonEmpty(std::move(Trivia1));
+        F.Args.append(std::move(Middle));
         
-        auto Error = NodePtr(new SyntaxErrorNode(SYNTAXERROR_EXPECTEDTILDE, std::move(Args)));
+        auto Error = NodePtr(session->arena->make<SyntaxErrorNode>(SYNTAXERROR_EXPECTEDTILDE, std::move(F.Args)));
         
-        return Error;
+        return session->parser->returnNode(std::move(Error));
     }
     
-    LeafSeq Trivia3;
+    LeafSeq Trivia3(session);
     
     //
     // Reset back to "outside" precedence
@@ -801,12 +887,28 @@ NodePtr TildeParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
     Ctxt.Prec = PRECEDENCE_TILDE;
     Ctxt.Flag &= (~PARSER_INSIDE_TILDE);
     
-    TheParser->nextToken(Tok1);
+    session->parser->nextToken(Tok1);
+    
+    auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok2 = session->parser->eatTrivia(Tok2, Ctxt, TOPLEVEL, Trivia3);
+    
+    F.Args.appendIfNonEmpty(std::move(Trivia1));
+    F.Args.append(std::move(Middle));
+    F.Args.appendIfNonEmpty(std::move(Trivia2));
+    F.Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
+    F.Args.appendIfNonEmpty(std::move(Trivia3));
     
-    auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok2 = TheParser->eatTrivia(Tok2, Ctxt, TOPLEVEL, Trivia3);
+    auto& F2 = session->parser->pushFrame(parse2, nullptr);
+    F2.CtxtIn = F.CtxtIn;
+    F2.Tok = Tok1;
+    F2.Args = std::move(F.Args);
+    
+    return session->parser->parsePrefix(Tok2, Ctxt);
+}
+
+void TildeParselet::parse2(ParserSession *session, ParserFrame& F, NodePtr Right) {
     
-    auto Right = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
+    auto Tok1 = F.Tok;
     
     if (Right->isExpectedOperandError()) {
         
@@ -816,39 +918,23 @@ NodePtr TildeParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
         // Structurally correct, so return TernaryNode
         //
         
-        auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(Tok1.BufLen.end), Source(Tok1.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(Tok1.BufLen.end), Source(Tok1.Src.End))));
         
-        NodeSeq Args(1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(FirstTilde)));
-        Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(Middle));
-        Args.appendIfNonEmpty(std::move(Trivia2));
-        Args.append(NodePtr(new LeafNode(Tok1)));
-        Args.appendIfNonEmpty(std::move(Trivia3));
-        Args.append(std::move(ProperExpectedOperandError));
-        auto Error = NodePtr(new TernaryNode(SYMBOL_CODEPARSER_TERNARYTILDE, std::move(Args)));
+        F.Args.append(std::move(ProperExpectedOperandError));
+        auto Error = NodePtr(session->arena->make<TernaryNode>(SYMBOL_CODEPARSER_TERNARYTILDE, std::move(F.Args)));
         
-        return Error;
+        return session->parser->returnNode(std::move(Error));
     }
     
-    NodeSeq Args(1 + 1 + 1 + 1 + 1 + 1 + 1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-    Args.append(NodePtr(new LeafNode(FirstTilde)));
-    Args.appendIfNonEmpty(std::move(Trivia1));
-    Args.append(std::move(Middle));
-    Args.appendIfNonEmpty(std::move(Trivia2));
-    Args.append(NodePtr(new LeafNode(Tok1)));
-    Args.appendIfNonEmpty(std::move(Trivia3));
-    Args.append(std::move(Right));
+    F.Args.append(std::move(Right));
     
-    L = NodePtr(new TernaryNode(SYMBOL_CODEPARSER_TERNARYTILDE, std::move(Args)));
+    auto L = NodePtr(session->arena->make<TernaryNode>(SYMBOL_CODEPARSER_TERNARYTILDE, std::move(F.Args)));
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr ColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void ColonParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     assert((CtxtIn.Flag & PARSER_INSIDE_COLON) != PARSER_INSIDE_COLON);
     
@@ -856,16 +942,38 @@ NodePtr ColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
     Ctxt.Prec = PRECEDENCE_FAKE_PATTERNCOLON;
     Ctxt.Flag |= PARSER_INSIDE_COLON;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    NodePtr Pat;
-    {
-        LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
         
-        auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
         
-        auto Right = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    NodeSeq Args(session, 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+    
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void ColonParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Right) {
+    
+    auto P = static_cast<const ColonParselet *>(F.P);
+    
+    auto TokIn = F.Tok;
+    
+    auto Ctxt = F.Ctxt;
+    
+    NodePtr Pat;
+    {
+        auto Trivia1 = std::move(F.Trivia);
         
         if (Right->isExpectedOperandError()) {
             
@@ -873,48 +981,41 @@ NodePtr ColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
             // Reattach the ExpectedOperand Error to the operator for a better experience
             //
             
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+            auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
             
-            NodeSeq Args(1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(std::move(ProperExpectedOperandError));
-            auto Error = NodePtr(new BinaryNode(SYMBOL_PATTERN, std::move(Args)));
+            F.Args.append(std::move(ProperExpectedOperandError));
+            auto Error = NodePtr(session->arena->make<BinaryNode>(SYMBOL_PATTERN, std::move(F.Args)));
             
-            return Error;
+            return session->parser->returnNode(std::move(Error));
         }
         
-        NodeSeq Args(1 + 1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(TokIn)));
-        Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(Right));
+        F.Args.appendIfNonEmpty(std::move(Trivia1));
+        F.Args.append(std::move(Right));
         
-        Pat = NodePtr(new BinaryNode(SYMBOL_PATTERN, std::move(Args)));
+        Pat = NodePtr(session->arena->make<BinaryNode>(SYMBOL_PATTERN, std::move(F.Args)));
         
-        LeafSeq Trivia2;
+        LeafSeq Trivia2(session);
         
-        Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok = TheParser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia2);
+        auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok = session->parser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia2);
         
         if (Tok.Tok == TOKEN_COLON) {
             
             Ctxt.Flag &= ~(PARSER_INSIDE_COLON);
             
-            NodeSeq PatSeq(1 + 1);
+            NodeSeq PatSeq(session, 1 + 1);
             PatSeq.append(std::move(Pat));
             PatSeq.appendIfNonEmpty(std::move(Trivia2));
             
-            auto L = parseContextSensitive(std::move(PatSeq), Tok, Ctxt);
-            return L;
+            return P->parseContextSensitive(session, std::move(PatSeq), Tok, Ctxt);
         }
     }
     
-    return TheParser->infixLoop(std::move(Pat), CtxtIn);
+    return session->parser->infixLoop(std::move(Pat), F.CtxtIn);
 }
 
 
-NodePtr ColonParselet::parseContextSensitive(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void ColonParselet::parseContextSensitive(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     //
     // when parsing a in a:b  then ColonFlag is false
@@ -922,19 +1023,34 @@ NodePtr ColonParselet::parseContextSensitive(NodeSeq Left, Token TokIn, ParserCo
     //
     assert((CtxtIn.Flag & PARSER_INSIDE_COLON) != PARSER_INSIDE_COLON);
     
-    NodePtr L;
-    
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_FAKE_OPTIONALCOLON;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
+    
+    LeafSeq Trivia1(session);
     
-    LeafSeq Trivia1;
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    NodeSeq Args(session, 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     
-    auto Right = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    auto& F = session->parser->pushFrame(parse2, this);
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void ColonParselet::parse2(ParserSession *session, ParserFrame& F, NodePtr Right) {
+    
+    auto Trivia1 = std::move(F.Trivia);
+    
+    auto TokIn = F.Tok;
     
     if (Right->isExpectedOperandError()) {
         
@@ -942,42 +1058,55 @@ NodePtr ColonParselet::parseContextSensitive(NodeSeq Left, Token TokIn, ParserCo
         // Reattach the ExpectedOperand Error to the operator for a better experience
         //
         
-        auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
         
-        NodeSeq Args(1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(TokIn)));
-        Args.append(std::move(ProperExpectedOperandError));
-        auto Error = NodePtr(new BinaryNode(SYMBOL_OPTIONAL, std::move(Args)));
+        F.Args.append(std::move(ProperExpectedOperandError));
+        auto Error = NodePtr(session->arena->make<BinaryNode>(SYMBOL_OPTIONAL, std::move(F.Args)));
         
-        return Error;
+        return session->parser->returnNode(std::move(Error));
     }
     
-    NodeSeq Args(1 + 1 + 1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-    Args.append(NodePtr(new LeafNode(TokIn)));
-    Args.appendIfNonEmpty(std::move(Trivia1));
-    Args.append(std::move(Right));
+    F.Args.appendIfNonEmpty(std::move(Trivia1));
+    F.Args.append(std::move(Right));
     
-    L = NodePtr(new BinaryNode(SYMBOL_OPTIONAL, std::move(Args)));
+    auto L = NodePtr(session->arena->make<BinaryNode>(SYMBOL_OPTIONAL, std::move(F.Args)));
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr SlashColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void SlashColonParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_SLASHCOLON;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
+    
+    LeafSeq Trivia1(session);
     
-    LeafSeq Trivia1;
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    NodeSeq Args(session, 1 + 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     
-    auto Middle = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.Tok = TokIn;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void SlashColonParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Middle) {
+    
+    auto Trivia1 = std::move(F.Trivia);
+    
+    auto TokIn = F.Tok;
+    
+    auto Ctxt = F.Ctxt;
     
     if (Middle->isExpectedOperandError()) {
         
@@ -985,52 +1114,39 @@ NodePtr SlashColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtI
         // Reattach the ExpectedOperand Error to the operator for a better experience
         //
         
-        auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
         
-        NodeSeq Args(1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(TokIn)));
-        Args.append(std::move(ProperExpectedOperandError));
-        auto Error = NodePtr(new BinaryNode(SYMBOL_TAGSET, std::move(Args)));
+        F.Args.append(std::move(ProperExpectedOperandError));
+        auto Error = NodePtr(session->arena->make<BinaryNode>(SYMBOL_TAGSET, std::move(F.Args)));
         
-        return Error;
+        return session->parser->returnNode(std::move(Error));
     }
     
-    LeafSeq Trivia2;
+    LeafSeq Trivia2(session);
     
-    Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia2);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia2);
     
     switch (Tok.Tok.value()) {
         case TOKEN_EQUAL.value(): {
             
-            NodeSeq Args(1 + 1 + 1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(std::move(Middle));
-            Args.appendIfNonEmpty(std::move(Trivia2));
+            F.Args.appendIfNonEmpty(std::move(Trivia1));
+            F.Args.append(std::move(Middle));
+            F.Args.appendIfNonEmpty(std::move(Trivia2));
             
             Ctxt.Flag |= PARSER_INSIDE_SLASHCOLON;
             
-            auto N = infixParselets[TOKEN_EQUAL.value()]->parse(std::move(Args), Tok, Ctxt);
-            
-            return N;
+            return infixParselets[TOKEN_EQUAL.value()]->parse(session, std::move(F.Args), Tok, Ctxt);
         }
         case TOKEN_COLONEQUAL.value(): {
             
-            NodeSeq Args(1 + 1 + 1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(std::move(Middle));
-            Args.appendIfNonEmpty(std::move(Trivia2));
+            F.Args.appendIfNonEmpty(std::move(Trivia1));
+            F.Args.append(std::move(Middle));
+            F.Args.appendIfNonEmpty(std::move(Trivia2));
             
             Ctxt.Flag |= PARSER_INSIDE_SLASHCOLON;
             
-            auto N = infixParselets[TOKEN_COLONEQUAL.value()]->parse(std::move(Args), Tok, Ctxt);
-            
-            return N;
+            return infixParselets[TOKEN_COLONEQUAL.value()]->parse(session, std::move(F.Args), Tok, Ctxt);
         }
         default: {
             
@@ -1041,33 +1157,28 @@ NodePtr SlashColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtI
             // a /: b =.
             //
             
-            NodeSeq Args(1 + 1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(std::move(Middle));
+            F.Args.appendIfNonEmpty(std::move(Trivia1));
+            F.Args.append(std::move(Middle));
             
-            auto Error = NodePtr(new SyntaxErrorNode(SYNTAXERROR_EXPECTEDSET, std::move(Args)));
+            auto Error = NodePtr(session->arena->make<SyntaxErrorNode>(SYNTAXERROR_EXPECTEDSET, std::move(F.Args)));
             
-            return Error;
+            return session->parser->returnNode(std::move(Error));
         }
     }
 }
 
 
-NodePtr EqualParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
-    
-    NodePtr L;
+void EqualParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_EQUAL;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
     
     if (Tok.Tok == TOKEN_DOT) {
         
@@ -1078,88 +1189,124 @@ NodePtr EqualParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
         // Spaces to Avoid
         //
         
-        TheParser->nextToken(Tok);
+        session->parser->nextToken(Tok);
         
-        NodeSeq Args(1 + 1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(TokIn)));
+        NodeSeq Args(session, 1 + 1 + 1 + 1);
+        Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+        Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
         Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(NodePtr(new LeafNode(Tok)));
+        Args.append(NodePtr(session->arena->make<LeafNode>(Tok)));
+        
+        NodePtr L;
         
         if ((Ctxt.Flag & PARSER_INSIDE_SLASHCOLON) == PARSER_INSIDE_SLASHCOLON) {
             
-            L = NodePtr(new TernaryNode(SYMBOL_TAGUNSET, std::move(Args)));
+            L = NodePtr(session->arena->make<TernaryNode>(SYMBOL_TAGUNSET, std::move(Args)));
             
         } else {
-            L = NodePtr(new BinaryNode(SYMBOL_UNSET, std::move(Args)));
+            L = NodePtr(session->arena->make<BinaryNode>(SYMBOL_UNSET, std::move(Args)));
         }
         
-    } else {
-        
-        auto wasInsideSlashColon = ((Ctxt.Flag & PARSER_INSIDE_SLASHCOLON) == PARSER_INSIDE_SLASHCOLON);
+        return session->parser->infixLoop(std::move(L), CtxtIn);
+    }
         
-        Ctxt.Flag &= ~(PARSER_INSIDE_SLASHCOLON);
+    //
+    // wasInsideSlashColon is kept in CtxtIn of the frame
+    //
+    Ctxt.Flag &= ~(PARSER_INSIDE_SLASHCOLON);
         
-        auto Right = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    NodeSeq Args(session, 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+    
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void EqualParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Right) {
+    
+    auto Trivia1 = std::move(F.Trivia);
+    
+    auto TokIn = F.Tok;
+    
+    auto wasInsideSlashColon = ((F.CtxtIn.Flag & PARSER_INSIDE_SLASHCOLON) == PARSER_INSIDE_SLASHCOLON);
         
-        if (Right->isExpectedOperandError()) {
-            
-            //
-            // Reattach the ExpectedOperand Error to the operator for a better experience
-            //
+    if (Right->isExpectedOperandError()) {
             
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+        //
+        // Reattach the ExpectedOperand Error to the operator for a better experience
+        //
             
-            NodeSeq Args(1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(std::move(ProperExpectedOperandError));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
             
-            if (wasInsideSlashColon) {
-                auto Error = NodePtr(new TernaryNode(SYMBOL_TAGSET, std::move(Args)));
-                return Error;
-            }
+        F.Args.append(std::move(ProperExpectedOperandError));
             
-            auto Error = NodePtr(new BinaryNode(SYMBOL_SET, std::move(Args)));
-            return Error;
+        if (wasInsideSlashColon) {
+            auto Error = NodePtr(session->arena->make<TernaryNode>(SYMBOL_TAGSET, std::move(F.Args)));
+            return session->parser->returnNode(std::move(Error));
         }
+            
+        auto Error = NodePtr(session->arena->make<BinaryNode>(SYMBOL_SET, std::move(F.Args)));
+        return session->parser->returnNode(std::move(Error));
+    }
         
-        NodeSeq Args(1 + 1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(TokIn)));
-        Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(Right));
+    F.Args.appendIfNonEmpty(std::move(Trivia1));
+    F.Args.append(std::move(Right));
+    
+    NodePtr L;
         
-        if (wasInsideSlashColon) {
-            L = NodePtr(new TernaryNode(SYMBOL_TAGSET, std::move(Args)));
-        } else {
-            L = NodePtr(new BinaryNode(SYMBOL_SET, std::move(Args)));
-        }
+    if (wasInsideSlashColon) {
+        L = NodePtr(session->arena->make<TernaryNode>(SYMBOL_TAGSET, std::move(F.Args)));
+    } else {
+        L = NodePtr(session->arena->make<BinaryNode>(SYMBOL_SET, std::move(F.Args)));
     }
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr ColonEqualParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
-    
-    NodePtr L;
+void ColonEqualParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_EQUAL;
     
-    TheParser->nextToken(TokIn);
-    
-    LeafSeq Trivia1;
+    session->parser->nextToken(TokIn);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    LeafSeq Trivia1(session);
     
-    auto wasInsideSlashColon = ((Ctxt.Flag & PARSER_INSIDE_SLASHCOLON) == PARSER_INSIDE_SLASHCOLON);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
     
+    //
+    // wasInsideSlashColon is kept in CtxtIn of the frame
+    //
     Ctxt.Flag &= ~(PARSER_INSIDE_SLASHCOLON);
     
-    auto Right = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    NodeSeq Args(session, 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+    
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Args = std::move(Args);
+    F.Trivia = std::move(Trivia1);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void ColonEqualParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Right) {
+    
+    auto Trivia1 = std::move(F.Trivia);
+    
+    auto TokIn = F.Tok;
+    
+    auto wasInsideSlashColon = ((F.CtxtIn.Flag & PARSER_INSIDE_SLASHCOLON) == PARSER_INSIDE_SLASHCOLON);
     
     if (Right->isExpectedOperandError()) {
         
@@ -1167,147 +1314,167 @@ NodePtr ColonEqualParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtI
         // Reattach the ExpectedOperand Error to the operator for a better experience
         //
         
-        auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
         
-        NodeSeq Args(1 + 1 + 1);
-        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-        Args.append(NodePtr(new LeafNode(TokIn)));
-        Args.append(std::move(ProperExpectedOperandError));
+        F.Args.append(std::move(ProperExpectedOperandError));
         
         if (wasInsideSlashColon) {
-            auto Error = NodePtr(new TernaryNode(SYMBOL_TAGSETDELAYED, std::move(Args)));
-            return Error;
+            auto Error = NodePtr(session->arena->make<TernaryNode>(SYMBOL_TAGSETDELAYED, std::move(F.Args)));
+            return session->parser->returnNode(std::move(Error));
         }
         
-        auto Error = NodePtr(new BinaryNode(SYMBOL_SETDELAYED, std::move(Args)));
-        return Error;
+        auto Error = NodePtr(session->arena->make<BinaryNode>(SYMBOL_SETDELAYED, std::move(F.Args)));
+        return session->parser->returnNode(std::move(Error));
     }
     
-    NodeSeq Args(1 + 1 + 1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-    Args.append(NodePtr(new LeafNode(TokIn)));
-    Args.appendIfNonEmpty(std::move(Trivia1));
-    Args.append(std::move(Right));
+    F.Args.appendIfNonEmpty(std::move(Trivia1));
+    F.Args.append(std::move(Right));
+    
+    NodePtr L;
     
     if (wasInsideSlashColon) {
         
-        L = NodePtr(new TernaryNode(SYMBOL_TAGSETDELAYED, std::move(Args)));
+        L = NodePtr(session->arena->make<TernaryNode>(SYMBOL_TAGSETDELAYED, std::move(F.Args)));
         
     } else {
-        L = NodePtr(new BinaryNode(SYMBOL_SETDELAYED, std::move(Args)));
+        L = NodePtr(session->arena->make<BinaryNode>(SYMBOL_SETDELAYED, std::move(F.Args)));
     }
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr IntegralParselet::parse(Token TokIn, ParserContext CtxtIn) const {
-    
-    NodePtr L;
+void IntegralParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_CLASS_INTEGRATIONOPERATORS;
     Ctxt.Flag |= PARSER_INSIDE_INTEGRAL;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia1);
     
-    auto operand = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    F.CtxtIn = CtxtIn;
+    F.Tok = TokIn;
+    F.Trivia = std::move(Trivia1);
     
-    if (operand->isExpectedOperandError()) {
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void IntegralParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto Trivia1 = std::move(F.Trivia);
+    
+    auto TokIn = F.Tok;
+    
+    auto Ctxt = F.Ctxt;
+    
+    if (Operand->isExpectedOperandError()) {
         
         //
         // Reattach the ExpectedOperand Error to the operator for a better experience
         //
         
-        auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
         
-        NodeSeq Args(1 + 1);
-        Args.append(NodePtr(new LeafNode(TokIn)));
+        NodeSeq Args(session, 1 + 1);
+        Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
         Args.append(std::move(ProperExpectedOperandError));
         
-        auto Error = NodePtr(new PrefixNode(SYMBOL_INTEGRAL, std::move(Args)));
-        return Error;
+        auto Error = NodePtr(session->arena->make<PrefixNode>(SYMBOL_INTEGRAL, std::move(Args)));
+        return session->parser->returnNode(std::move(Error));
     }
     
     Ctxt.Flag &= ~(PARSER_INSIDE_INTEGRAL);
     
-    LeafSeq Trivia2;
+    LeafSeq Trivia2(session);
     
-    Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-    Tok = TheParser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia2);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTrivia(Tok, Ctxt, TOPLEVEL, Trivia2);
     
     if (!Tok.Tok.isDifferentialD()) {
         
-        NodeSeq Args(1 + 1 + 1);
-        Args.append(NodePtr(new LeafNode(TokIn)));
+        NodeSeq Args(session, 1 + 1 + 1);
+        Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
         Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(operand));
+        Args.append(std::move(Operand));
         
-        L = NodePtr(new PrefixNode(SYMBOL_INTEGRAL, std::move(Args)));
+        auto L = NodePtr(session->arena->make<PrefixNode>(SYMBOL_INTEGRAL, std::move(Args)));
         
-    } else {
+        //
+        // Trivia2 is read again before the infix loop
+        //
+        return session->parser->infixLoop(std::move(L), F.CtxtIn);
+    }
         
-        auto variable = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    NodeSeq Args(session, 1 + 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+    Args.appendIfNonEmpty(std::move(Trivia1));
+    Args.append(std::move(Operand));
         
-        if (variable->isExpectedOperandError()) {
+    auto& F2 = session->parser->pushFrame(parse2, nullptr);
+    F2.CtxtIn = F.CtxtIn;
+    F2.Tok = TokIn;
+    F2.Args = std::move(Args);
+    F2.Trivia = std::move(Trivia2);
+    
+    return session->parser->parsePrefix(Tok, Ctxt);
+}
+
+void IntegralParselet::parse2(ParserSession *session, ParserFrame& F, NodePtr Variable) {
+    
+    auto Trivia2 = std::move(F.Trivia);
+    
+    auto TokIn = F.Tok;
+    
+    if (Variable->isExpectedOperandError()) {
             
-            //
-            // Reattach the ExpectedOperand Error to the operator for a better experience
-            //
+        //
+        // Reattach the ExpectedOperand Error to the operator for a better experience
+        //
             
-            auto ProperExpectedOperandError = NodePtr(new ExpectedOperandErrorNode(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+        auto ProperExpectedOperandError = NodePtr(session->arena->make<ExpectedOperandErrorNode>(Token(TOKEN_ERROR_EXPECTEDOPERAND, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
             
-            NodeSeq Args(1 + 1 + 1 + 1);
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(std::move(operand));
-            Args.append(std::move(ProperExpectedOperandError));
+        F.Args.append(std::move(ProperExpectedOperandError));
             
-            auto Error = NodePtr(new PrefixNode(SYMBOL_INTEGRATE, std::move(Args)));
-            return Error;
-        }
+        auto Error = NodePtr(session->arena->make<PrefixNode>(SYMBOL_INTEGRATE, std::move(F.Args)));
+        return session->parser->returnNode(std::move(Error));
+    }
         
-        NodeSeq Args(1 + 1 + 1 + 1 + 1);
-        Args.append(NodePtr(new LeafNode(TokIn)));
-        Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(std::move(operand));
-        Args.appendIfNonEmpty(std::move(Trivia2));
-        Args.append(std::move(variable));
+    F.Args.appendIfNonEmpty(std::move(Trivia2));
+    F.Args.append(std::move(Variable));
         
-        L = NodePtr(new PrefixBinaryNode(SYMBOL_INTEGRATE, std::move(Args)));
-    }
+    auto L = NodePtr(session->arena->make<PrefixBinaryNode>(SYMBOL_INTEGRATE, std::move(F.Args)));
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), F.CtxtIn);
 }
 
 
-NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void CommaParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
-    NodeSeq Args(1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
+    NodeSeq Args(session, 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
     
     auto lastOperatorToken = TokIn;
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = getPrecedence(Ctxt);
     
-    NodePtr L;
-    
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     //
     // Unroll 1 iteration of the loop because we know that TokIn has already been read
     //
     {
-        LeafSeq Trivia2;
+        LeafSeq Trivia2(session);
         
-        auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok2 = TheParser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
+        auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok2 = session->parser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
         
         if (infixParselets[Tok2.Tok.value()]->getOp() == SYMBOL_CODEPARSER_COMMA) {
             
@@ -1317,13 +1484,9 @@ NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
             
 #if !NISSUES
                 {
-                    CodeActionPtrSet Actions;
-                    
-                    Actions.insert(CodeActionPtr(new DeleteTextCodeAction("Delete ``,``", Tok2.Src)));
-                    
-                    auto I = IssuePtr(new ExtraCommaIssue(Tok2.Src, std::move(Actions)));
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_COMMA, ISSUEMESSAGE_EXTRACOMMA, SYNTAXISSUESEVERITY_ERROR, Tok2.Src, 1.0, ISSUEACTION_DELETECOMMA);
                     
-                    TheParser->addIssue(std::move(I));
+                    session->parser->addIssue(std::move(I));
                 }
 #endif // !NISSUES
             
@@ -1331,65 +1494,93 @@ NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
             
             lastOperatorToken = Tok2;
             
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
         } else {
             
-            auto Operand = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
             
-            if (Operand->isExpectedOperandError()) {
+            auto& F = session->parser->pushFrame(parse1, this);
+            F.Ctxt = Ctxt;
+            F.CtxtIn = CtxtIn;
+            F.Tok = TokIn;
+            F.Args = std::move(Args);
+            F.Trivia = std::move(Trivia2);
+            
+            return session->parser->parsePrefix(Tok2, Ctxt);
+        }
+    }
+    
+    return parseLoop(session, std::move(Args), lastOperatorToken, Ctxt, CtxtIn);
+}
+
+void CommaParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const CommaParselet *>(F.P);
+    
+    //
+    // The comma before Operand
+    //
+    auto Tok1 = F.Tok;
+    
+    {
+        auto Trivia2 = std::move(F.Trivia);
+            
+        if (Operand->isExpectedOperandError()) {
                 
-                //
-                // Something like  f[1,]
-                //
+            //
+            // Something like  f[1,]  or  f[1,2,]
+            //
                 
 #if !NISSUES
-                {
-                    CodeActionPtrSet Actions;
-                    
-                    Actions.insert(CodeActionPtr(new DeleteTextCodeAction("Delete ``,``", TokIn.Src)));
-                    
-                    auto I = IssuePtr(new ExtraCommaIssue(TokIn.Src, std::move(Actions)));
+            {
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_COMMA, ISSUEMESSAGE_EXTRACOMMA, SYNTAXISSUESEVERITY_ERROR, Tok1.Src, 1.0, ISSUEACTION_DELETECOMMA);
                     
-                    TheParser->addIssue(std::move(I));
-                }
+                session->parser->addIssue(std::move(I));
+            }
 #endif // !NISSUES
                 
-                //
-                // Convert the ExpectedOperand Error to ImplicitNull and reattach to the operator for a better experience
-                //
+            //
+            // Convert the ExpectedOperand Error to ImplicitNull and reattach to the operator for a better experience
+            //
                 
-                auto ProperImplicitNull = NodePtr(new LeafNode(Token(TOKEN_FAKE_IMPLICITNULL, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End))));
+            auto ProperImplicitNull = NodePtr(session->arena->make<LeafNode>(Token(TOKEN_FAKE_IMPLICITNULL, BufferAndLength(Tok1.BufLen.end), Source(Tok1.Src.End))));
                 
-                Args.append(NodePtr(new LeafNode(TokIn)));
-                Args.append(std::move(ProperImplicitNull));
+            F.Args.append(std::move(ProperImplicitNull));
                 
-            } else {
+        } else {
                 
-                Args.append(NodePtr(new LeafNode(TokIn)));
-                Args.appendIfNonEmpty(std::move(Trivia2));
-                Args.append(std::move(Operand));
-            }
+            //
+            // Do not reserve inside loop
+            // Allow default resizing strategy, which is hopefully exponential
+            //
+            F.Args.appendIfNonEmpty(std::move(Trivia2));
+            F.Args.append(std::move(Operand));
         }
     }
     
+    return P->parseLoop(session, std::move(F.Args), Tok1, F.Ctxt, F.CtxtIn);
+}
+
+void CommaParselet::parseLoop(ParserSession *session, NodeSeq Args, Token lastOperatorToken, ParserContext Ctxt, ParserContext CtxtIn) const {
+    
     while (true) {
         
 #if !NABORT
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            return TheParserSession->handleAbort();
+            return session->parser->returnNode(session->handleAbort());
         }
 #endif // !NABORT
         
-        LeafSeq Trivia1;
+        LeafSeq Trivia1(session);
         
-        auto Tok1 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok1 = TheParser->eatTriviaButNotToplevelNewlines(Tok1, Ctxt, TOPLEVEL, Trivia1);
+        auto Tok1 = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok1 = session->parser->eatTriviaButNotToplevelNewlines(Tok1, Ctxt, TOPLEVEL, Trivia1);
         
         //
         // Cannot just compare tokens
@@ -1400,9 +1591,9 @@ NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
         //
         if (infixParselets[Tok1.Tok.value()]->getOp() != SYMBOL_CODEPARSER_COMMA) {
             
-            L = NodePtr(new InfixNode(SYMBOL_CODEPARSER_COMMA, std::move(Args)));
+            auto L = NodePtr(session->arena->make<InfixNode>(SYMBOL_CODEPARSER_COMMA, std::move(Args)));
             
-            break;
+            return session->parser->infixLoop(std::move(L), CtxtIn);
         }
             
         lastOperatorToken = Tok1;
@@ -1411,12 +1602,12 @@ NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
         // Something like  a,b
         //
         
-        TheParser->nextToken(Tok1);
+        session->parser->nextToken(Tok1);
         
-        LeafSeq Trivia2;
+        LeafSeq Trivia2(session);
         
-        auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok2 = TheParser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
+        auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok2 = session->parser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
         
         if (infixParselets[Tok2.Tok.value()]->getOp() == SYMBOL_CODEPARSER_COMMA) {
             
@@ -1426,13 +1617,9 @@ NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
             
 #if !NISSUES
                 {
-                    CodeActionPtrSet Actions;
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_COMMA, ISSUEMESSAGE_EXTRACOMMA, SYNTAXISSUESEVERITY_ERROR, Tok2.Src, 1.0, ISSUEACTION_DELETECOMMA);
                     
-                    Actions.insert(CodeActionPtr(new DeleteTextCodeAction("Delete ``,``", Tok2.Src)));
-                    
-                    auto I = IssuePtr(new ExtraCommaIssue(Tok2.Src, std::move(Actions)));
-                    
-                    TheParser->addIssue(std::move(I));
+                    session->parser->addIssue(std::move(I));
                 }
 #endif // !NISSUES
             
@@ -1445,86 +1632,52 @@ NodePtr CommaParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) co
             // Allow default resizing strategy, which is hopefully exponential
             //
             Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(NodePtr(new LeafNode(Tok1)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
             continue;
         }
             
-        auto Operand = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
-        
-        if (Operand->isExpectedOperandError()) {
-            
-            //
-            // Something like  f[1,2,]
-            //
-            
-#if !NISSUES
-                {
-                    CodeActionPtrSet Actions;
-                    
-                    Actions.insert(CodeActionPtr(new DeleteTextCodeAction("Delete ``,``", Tok1.Src)));
-                    
-                    auto I = IssuePtr(new ExtraCommaIssue(Tok1.Src, std::move(Actions)));
-                    
-                    TheParser->addIssue(std::move(I));
-                }
-#endif // !NISSUES
-            
-            //
-            // Convert the ExpectedOperand Error to ImplicitNull and reattach to the operator for a better experience
-            //
-            
-            auto ProperImplicitNull = NodePtr(new LeafNode(Token(TOKEN_FAKE_IMPLICITNULL, BufferAndLength(Tok1.BufLen.end), Source(Tok1.Src.End))));
-            
-            //
-            // Do not reserve inside loop
-            // Allow default resizing strategy, which is hopefully exponential
-            //
-            Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(NodePtr(new LeafNode(Tok1)));
-            Args.append(std::move(ProperImplicitNull));
-            
-            continue;
-        }
-        
         //
         // Do not reserve inside loop
         // Allow default resizing strategy, which is hopefully exponential
         //
         Args.appendIfNonEmpty(std::move(Trivia1));
-        Args.append(NodePtr(new LeafNode(Tok1)));
-        Args.appendIfNonEmpty(std::move(Trivia2));
-        Args.append(std::move(Operand));
+        Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
+            
+        auto& F = session->parser->pushFrame(parse1, this);
+        F.Ctxt = Ctxt;
+        F.CtxtIn = CtxtIn;
+        F.Tok = Tok1;
+        F.Args = std::move(Args);
+        F.Trivia = std::move(Trivia2);
+        
+        return session->parser->parsePrefix(Tok2, Ctxt);
         
     } // while
-    
-    return TheParser->infixLoop(std::move(L), CtxtIn);
 }
 
 
-NodePtr SemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void SemiParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
-    NodeSeq Args(1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
+    NodeSeq Args(session, 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
     
     auto lastOperatorToken = TokIn;
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = getPrecedence(Ctxt);
     
-    NodePtr L;
-    
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     //
     // Unroll 1 iteration of the loop because we know that TokIn has already been read
     //
     {
-        LeafSeq Trivia2;
+        LeafSeq Trivia2(session);
         
-        auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok2 = TheParser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
+        auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok2 = session->parser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
         
         if (Tok2.Tok == TOKEN_SEMI) {
             
@@ -1536,16 +1689,21 @@ NodePtr SemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) con
             
             lastOperatorToken = Tok2;
             
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
         } else if (Tok2.Tok.isPossibleBeginning()) {
             
-            auto operand = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
-            
-            Args.append(NodePtr(new LeafNode(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
             Args.appendIfNonEmpty(std::move(Trivia2));
-            Args.append(std::move(operand));
+            
+            auto& F = session->parser->pushFrame(parse1, this);
+            F.Ctxt = Ctxt;
+            F.CtxtIn = CtxtIn;
+            F.Tok = lastOperatorToken;
+            F.Args = std::move(Args);
+            
+            return session->parser->parsePrefix(Tok2, Ctxt);
             
         } else {
             
@@ -1557,37 +1715,51 @@ NodePtr SemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) con
             
             auto Implicit = Token(TOKEN_FAKE_IMPLICITNULL, BufferAndLength(lastOperatorToken.BufLen.end), Source(lastOperatorToken.Src.End));
             
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
-            L = NodePtr(new InfixNode(SYMBOL_COMPOUNDEXPRESSION, std::move(Args)));
+            auto L = NodePtr(session->arena->make<InfixNode>(SYMBOL_COMPOUNDEXPRESSION, std::move(Args)));
             
-            goto SemiParseletExit;
+            return session->parser->infixLoop(std::move(L), CtxtIn);
         }
     }
     
+    return parseLoop(session, std::move(Args), lastOperatorToken, Ctxt, CtxtIn);
+}
+
+void SemiParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const SemiParselet *>(F.P);
+    
+    F.Args.append(std::move(Operand));
+    
+    return P->parseLoop(session, std::move(F.Args), F.Tok, F.Ctxt, F.CtxtIn);
+}
+
+void SemiParselet::parseLoop(ParserSession *session, NodeSeq Args, Token lastOperatorToken, ParserContext Ctxt, ParserContext CtxtIn) const {
+    
     while (true) {
         
 #if !NABORT
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            return TheParserSession->handleAbort();
+            return session->parser->returnNode(session->handleAbort());
         }
 #endif // !NABORT
         
-        LeafSeq Trivia1;
+        LeafSeq Trivia1(session);
         
-        auto Tok1 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok1 = TheParser->eatTriviaButNotToplevelNewlines(Tok1, Ctxt, TOPLEVEL, Trivia1);
+        auto Tok1 = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok1 = session->parser->eatTriviaButNotToplevelNewlines(Tok1, Ctxt, TOPLEVEL, Trivia1);
         
         if (Tok1.Tok != TOKEN_SEMI) {
             
-            L = NodePtr(new InfixNode(SYMBOL_COMPOUNDEXPRESSION, std::move(Args)));
+            auto L = NodePtr(session->arena->make<InfixNode>(SYMBOL_COMPOUNDEXPRESSION, std::move(Args)));
             
-            break;
+            return session->parser->infixLoop(std::move(L), CtxtIn);
         }
         
         lastOperatorToken = Tok1;
@@ -1596,12 +1768,12 @@ NodePtr SemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) con
         // Something like  a;b
         //
         
-        TheParser->nextToken(Tok1);
+        session->parser->nextToken(Tok1);
         
-        LeafSeq Trivia2;
+        LeafSeq Trivia2(session);
         
-        auto Tok2 = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok2 = TheParser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
+        auto Tok2 = session->parser->currentToken(Ctxt, TOPLEVEL);
+        Tok2 = session->parser->eatTriviaButNotToplevelNewlines(Tok2, Ctxt, TOPLEVEL, Trivia2);
         
         if (Tok2.Tok == TOKEN_SEMI) {
             
@@ -1618,21 +1790,26 @@ NodePtr SemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) con
             // Allow default resizing strategy, which is hopefully exponential
             //
             Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(NodePtr(new LeafNode(Tok1)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
         } else if (Tok2.Tok.isPossibleBeginning()) {
             
-            auto operand = prefixParselets[Tok2.Tok.value()]->parse(Tok2, Ctxt);
-            
             //
             // Do not reserve inside loop
             // Allow default resizing strategy, which is hopefully exponential
             //
             Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(NodePtr(new LeafNode(Tok1)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
             Args.appendIfNonEmpty(std::move(Trivia2));
-            Args.append(std::move(operand));
+            
+            auto& F = session->parser->pushFrame(parse1, this);
+            F.Ctxt = Ctxt;
+            F.CtxtIn = CtxtIn;
+            F.Tok = lastOperatorToken;
+            F.Args = std::move(Args);
+            
+            return session->parser->parsePrefix(Tok2, Ctxt);
             
         } else {
             
@@ -1649,28 +1826,24 @@ NodePtr SemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) con
             // Allow default resizing strategy, which is hopefully exponential
             //
             Args.appendIfNonEmpty(std::move(Trivia1));
-            Args.append(NodePtr(new LeafNode(Tok1)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
-            L = NodePtr(new InfixNode(SYMBOL_COMPOUNDEXPRESSION, std::move(Args)));
-            
-            break;
+            auto L = NodePtr(session->arena->make<InfixNode>(SYMBOL_COMPOUNDEXPRESSION, std::move(Args)));
+    
+            return session->parser->infixLoop(std::move(L), CtxtIn);
         }
-        
+
     } // while
-    
-SemiParseletExit:
-    
-    return TheParser->infixLoop(std::move(L), CtxtIn);
 }
 
 
-NodePtr ColonColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void ColonColonParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     
     NodePtr L;
     
-    NodeSeq Args(1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
+    NodeSeq Args(session, 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
     
     //
     // Not used here because of the special rules for tokenizing after ::
@@ -1679,7 +1852,7 @@ NodePtr ColonColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt)
     //Ctxt.Prec = PRECEDENCE_COLONCOLON;
     //Ctxt.Assoc = ASSOCIATIVITY_NONE;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     //
     // Unroll 1 iteration of the loop because we know that TokIn has already been read
@@ -1688,23 +1861,23 @@ NodePtr ColonColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt)
     // Special tokenization, so must do parsing here
     //
     
-    auto Tok2 = TheParser->currentToken_stringifyAsSymbolSegment();
+    auto Tok2 = session->parser->currentToken_stringifyAsSymbolSegment();
     
-    TheParser->nextToken(Tok2);
+    session->parser->nextToken(Tok2);
     
     NodePtr Operand;
     if (Tok2.Tok.isError()) {
         if (Tok2.Tok.isUnterminated()) {
-            Operand = NodePtr(new UnterminatedTokenErrorNeedsReparseNode(Tok2));
+            Operand = NodePtr(session->arena->make<ErrorNode>(session->tokenizer->recoverUnterminatedToken(Tok2)));
         } else {
-            Operand = NodePtr(new ErrorNode(Tok2));
+            Operand = NodePtr(session->arena->make<ErrorNode>(Tok2));
         }
     } else {
         assert(Tok2.Tok == TOKEN_STRING);
-        Operand = NodePtr(new LeafNode(Tok2));
+        Operand = NodePtr(session->arena->make<LeafNode>(Tok2));
     }
     
-    Args.append(NodePtr(new LeafNode(TokIn)));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     Args.append(std::move(Operand));
     
     while (true) {
@@ -1713,184 +1886,184 @@ NodePtr ColonColonParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt)
         //
         // Check isAbort() inside loops
         //
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
-            return TheParserSession->handleAbort();
+            return session->parser->returnNode(session->handleAbort());
         }
 #endif // !NABORT
         
         
-        auto Tok1 = TheParser->currentToken(Ctxt, TOPLEVEL);
+        auto Tok1 = session->parser->currentToken(Ctxt, TOPLEVEL);
         
         if (Tok1.Tok != TOKEN_COLONCOLON) {
             break;
         }
         
-        TheParser->nextToken(Tok1);
+        session->parser->nextToken(Tok1);
     
         //
         // Special tokenization, so must do parsing here
         //
     
-        auto Tok2 = TheParser->currentToken_stringifyAsSymbolSegment();
+        auto Tok2 = session->parser->currentToken_stringifyAsSymbolSegment();
     
-        TheParser->nextToken(Tok2);
+        session->parser->nextToken(Tok2);
     
         NodePtr Operand;
         if (Tok2.Tok.isError()) {
             if (Tok2.Tok.isUnterminated()) {
-                Operand = NodePtr(new UnterminatedTokenErrorNeedsReparseNode(Tok2));
+                Operand = NodePtr(session->arena->make<ErrorNode>(session->tokenizer->recoverUnterminatedToken(Tok2)));
             } else {
-                Operand = NodePtr(new ErrorNode(Tok2));
+                Operand = NodePtr(session->arena->make<ErrorNode>(Tok2));
             }
         } else {
             assert(Tok2.Tok == TOKEN_STRING);
-            Operand = NodePtr(new LeafNode(Tok2));
+            Operand = NodePtr(session->arena->make<LeafNode>(Tok2));
         }
         
         //
         // Do not reserve inside loop
         // Allow default resizing strategy, which is hopefully exponential
         //
-        Args.append(NodePtr(new LeafNode(Tok1)));
+        Args.append(NodePtr(session->arena->make<LeafNode>(Tok1)));
         Args.append(std::move(Operand));
         
     } // while
     
-    L = NodePtr(new InfixNode(SYMBOL_MESSAGENAME, std::move(Args)));
+    L = NodePtr(session->arena->make<InfixNode>(SYMBOL_MESSAGENAME, std::move(Args)));
     
-    return TheParser->infixLoop(std::move(L), Ctxt);
+    return session->parser->infixLoop(std::move(L), Ctxt);
 }
 
 
-NodePtr GreaterGreaterParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void GreaterGreaterParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     NodePtr L;
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_GREATERGREATER;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
     
     //
     // Special tokenization, so must do parsing here
     //
     
-    auto Tok = TheParser->currentToken_stringifyAsFile();
-    Tok = TheParser->eatTrivia_stringifyAsFile(Tok, Ctxt, Trivia1);
+    auto Tok = session->parser->currentToken_stringifyAsFile();
+    Tok = session->parser->eatTrivia_stringifyAsFile(Tok, Ctxt, Trivia1);
     
-    TheParser->nextToken(Tok);
+    session->parser->nextToken(Tok);
     
     NodePtr Operand;
     if (Tok.Tok.isError()) {
         if (Tok.Tok.isUnterminated()) {
-            Operand = NodePtr(new UnterminatedTokenErrorNeedsReparseNode(Tok));
+            Operand = NodePtr(session->arena->make<ErrorNode>(session->tokenizer->recoverUnterminatedToken(Tok)));
         } else {
-            Operand = NodePtr(new ErrorNode(Tok));
+            Operand = NodePtr(session->arena->make<ErrorNode>(Tok));
         }
     } else {
         assert(Tok.Tok == TOKEN_STRING);
-        Operand = NodePtr(new LeafNode(Tok));
+        Operand = NodePtr(session->arena->make<LeafNode>(Tok));
     }
     
-    NodeSeq Args(1 + 1 + 1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-    Args.append(NodePtr(new LeafNode(TokIn)));
+    NodeSeq Args(session, 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     Args.appendIfNonEmpty(std::move(Trivia1));
     Args.append(std::move(Operand));
     
-    L = NodePtr(new BinaryNode(SYMBOL_PUT, std::move(Args)));
+    L = NodePtr(session->arena->make<BinaryNode>(SYMBOL_PUT, std::move(Args)));
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), CtxtIn);
 }
 
 
-NodePtr GreaterGreaterGreaterParselet::parse(NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
+void GreaterGreaterGreaterParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext CtxtIn) const {
     
     NodePtr L;
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_GREATERGREATERGREATER;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
     
     //
     // Special tokenization, so must do parsing here
     //
     
-    auto Tok = TheParser->currentToken_stringifyAsFile();
-    Tok = TheParser->eatTrivia_stringifyAsFile(Tok, Ctxt, Trivia1);
+    auto Tok = session->parser->currentToken_stringifyAsFile();
+    Tok = session->parser->eatTrivia_stringifyAsFile(Tok, Ctxt, Trivia1);
     
-    TheParser->nextToken(Tok);
+    session->parser->nextToken(Tok);
     
     NodePtr Operand;
     if (Tok.Tok.isError()) {
         if (Tok.Tok.isUnterminated()) {
-            Operand = NodePtr(new UnterminatedTokenErrorNeedsReparseNode(Tok));
+            Operand = NodePtr(session->arena->make<ErrorNode>(session->tokenizer->recoverUnterminatedToken(Tok)));
         } else {
-            Operand = NodePtr(new ErrorNode(Tok));
+            Operand = NodePtr(session->arena->make<ErrorNode>(Tok));
         }
     } else {
         assert(Tok.Tok == TOKEN_STRING);
-        Operand = NodePtr(new LeafNode(Tok));
+        Operand = NodePtr(session->arena->make<LeafNode>(Tok));
     }
     
-    NodeSeq Args(1 + 1 + 1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-    Args.append(NodePtr(new LeafNode(TokIn)));
+    NodeSeq Args(session, 1 + 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     Args.appendIfNonEmpty(std::move(Trivia1));
     Args.append(std::move(Operand));
     
-    L = NodePtr(new BinaryNode(SYMBOL_PUTAPPEND, std::move(Args)));
+    L = NodePtr(session->arena->make<BinaryNode>(SYMBOL_PUTAPPEND, std::move(Args)));
 
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), CtxtIn);
 }
 
 
-NodePtr LessLessParselet::parse(Token TokIn, ParserContext CtxtIn) const {
+void LessLessParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     NodePtr L;
     
     auto Ctxt = CtxtIn;
     Ctxt.Prec = PRECEDENCE_LESSLESS;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    LeafSeq Trivia1;
+    LeafSeq Trivia1(session);
     
     //
     // Special tokenization, so must do parsing here
     //
     
-    auto Tok = TheParser->currentToken_stringifyAsFile();
-    Tok = TheParser->eatTrivia_stringifyAsFile(Tok, Ctxt, Trivia1);
+    auto Tok = session->parser->currentToken_stringifyAsFile();
+    Tok = session->parser->eatTrivia_stringifyAsFile(Tok, Ctxt, Trivia1);
     
-    TheParser->nextToken(Tok);
+    session->parser->nextToken(Tok);
     
     NodePtr Operand;
     if (Tok.Tok.isError()) {
         if (Tok.Tok.isUnterminated()) {
-            Operand = NodePtr(new UnterminatedTokenErrorNeedsReparseNode(Tok));
+            Operand = NodePtr(session->arena->make<ErrorNode>(session->tokenizer->recoverUnterminatedToken(Tok)));
         } else {
-            Operand = NodePtr(new ErrorNode(Tok));
+            Operand = NodePtr(session->arena->make<ErrorNode>(Tok));
         }
     } else {
         assert(Tok.Tok == TOKEN_STRING);
-        Operand = NodePtr(new LeafNode(Tok));
+        Operand = NodePtr(session->arena->make<LeafNode>(Tok));
     }
     
-    NodeSeq Args(1 + 1 + 1);
-    Args.append(NodePtr(new LeafNode(TokIn)));
+    NodeSeq Args(session, 1 + 1 + 1);
+    Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
     Args.appendIfNonEmpty(std::move(Trivia1));
     Args.append(std::move(Operand));
     
-    L = NodePtr(new PrefixNode(SYMBOL_GET, std::move(Args)));
+    L = NodePtr(session->arena->make<PrefixNode>(SYMBOL_GET, std::move(Args)));
     
-    return TheParser->infixLoop(std::move(L), CtxtIn);
+    return session->parser->infixLoop(std::move(L), CtxtIn);
 }
 
 
@@ -1927,112 +2100,112 @@ Token InfixDifferentialDParselet::processImplicitTimes(Token TokIn, ParserContex
 }
 
 
-NodePtr HashParselet::parse(Token TokIn, ParserContext CtxtIn) const {
+void HashParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     NodePtr Slot;
     
-    auto Tok = TheParser->currentToken(Ctxt, INSIDE_SLOT);
+    auto Tok = session->parser->currentToken(Ctxt, INSIDE_SLOT);
     
     switch (Tok.Tok.value()) {
         case TOKEN_INTEGER.value():
         case TOKEN_STRING.value(): {
             
-            TheParser->nextToken(Tok);
+            session->parser->nextToken(Tok);
             
-            NodeSeq Args(1 + 1);
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Tok)));
+            NodeSeq Args(session, 1 + 1);
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok)));
             
-            Slot = NodePtr(new CompoundNode(SYMBOL_SLOT, std::move(Args)));
+            Slot = NodePtr(session->arena->make<CompoundNode>(SYMBOL_SLOT, std::move(Args)));
         }
             break;
         default: {
             
-            Slot = NodePtr(new LeafNode(TokIn));
+            Slot = NodePtr(session->arena->make<LeafNode>(TokIn));
         }
             break;
     }
     
-    return TheParser->infixLoop(std::move(Slot), CtxtIn);
+    return session->parser->infixLoop(std::move(Slot), CtxtIn);
 }
 
 
-NodePtr HashHashParselet::parse(Token TokIn, ParserContext CtxtIn) const {
+void HashHashParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     NodePtr SlotSequence;
     
-    auto Tok = TheParser->currentToken(Ctxt, INSIDE_SLOTSEQUENCE);
+    auto Tok = session->parser->currentToken(Ctxt, INSIDE_SLOTSEQUENCE);
     
     switch (Tok.Tok.value()) {
         case TOKEN_INTEGER.value(): {
             
-            TheParser->nextToken(Tok);
+            session->parser->nextToken(Tok);
             
-            NodeSeq Args(1 + 1);
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Tok)));
+            NodeSeq Args(session, 1 + 1);
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok)));
             
-            SlotSequence = NodePtr(new CompoundNode(SYMBOL_SLOTSEQUENCE, std::move(Args)));
+            SlotSequence = NodePtr(session->arena->make<CompoundNode>(SYMBOL_SLOTSEQUENCE, std::move(Args)));
         }
             break;
         default: {
             
-            SlotSequence = NodePtr(new LeafNode(TokIn));
+            SlotSequence = NodePtr(session->arena->make<LeafNode>(TokIn));
         }
             break;
     }
     
-    return TheParser->infixLoop(std::move(SlotSequence), CtxtIn);
+    return session->parser->infixLoop(std::move(SlotSequence), CtxtIn);
 }
 
 
-NodePtr PercentParselet::parse(Token TokIn, ParserContext CtxtIn) const {
+void PercentParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     auto Ctxt = CtxtIn;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     NodePtr Out;
     
-    auto Tok = TheParser->currentToken(Ctxt, INSIDE_OUT);
+    auto Tok = session->parser->currentToken(Ctxt, INSIDE_OUT);
     
     switch (Tok.Tok.value()) {
         case TOKEN_INTEGER.value(): {
             
-            TheParser->nextToken(Tok);
+            session->parser->nextToken(Tok);
             
-            NodeSeq Args(1 + 1);
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Tok)));
+            NodeSeq Args(session, 1 + 1);
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Tok)));
             
-            Out = NodePtr(new CompoundNode(SYMBOL_OUT, std::move(Args)));
+            Out = NodePtr(session->arena->make<CompoundNode>(SYMBOL_OUT, std::move(Args)));
         }
             break;
         default: {
             
-            Out = NodePtr(new LeafNode(TokIn));
+            Out = NodePtr(session->arena->make<LeafNode>(TokIn));
         }
             break;
     }
     
-    return TheParser->infixLoop(std::move(Out), CtxtIn);
+    return session->parser->infixLoop(std::move(Out), CtxtIn);
 }
 
-NodePtr PercentPercentParselet::parse(Token TokIn, ParserContext CtxtIn) const {
+void PercentPercentParselet::parse(ParserSession *session, Token TokIn, ParserContext CtxtIn) const {
     
     NodePtr Out;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
 
-    Out = NodePtr(new LeafNode(TokIn));
+    Out = NodePtr(session->arena->make<LeafNode>(TokIn));
     
-    return TheParser->infixLoop(std::move(Out), CtxtIn);
+    return session->parser->infixLoop(std::move(Out), CtxtIn);
 }
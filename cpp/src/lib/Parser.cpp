@@ -1,12 +1,15 @@
 
 #include "Parser.h"
 
-#include "API.h" // for TheParserSession
+#include "API.h" // for ParserSession
 #include "Parselet.h" // for SymbolParselet, UnderParselet, etc.
 #include "Tokenizer.h" // for Tokenizer
 #include "ParseletRegistration.h"
 
-Parser::Parser() : Issues() {}
+ParserFrame::ParserFrame(ParserSession *session, ParseletContinuation Resume, const void *P) : Resume(Resume), P(P), Ctxt(), CtxtIn(), Tok(), Args(session), Trivia(session) {}
+
+
+Parser::Parser(ParserSession *session) : session(session), Issues(), Frames(), FrameCount(0), Step(STEP_RETURN), StepTok(), StepCtxt(), StepNode() {}
 
 Parser::~Parser() {}
 
@@ -24,7 +27,7 @@ void Parser::init(bool firstLineIsShebang) {
     
     ParserContext Ctxt;
     
-    auto peek = TheParser->currentToken(Ctxt, TOPLEVEL);
+    auto peek = currentToken(Ctxt, TOPLEVEL);
     
     if (peek.Tok != TOKEN_HASH) {
         //
@@ -32,9 +35,9 @@ void Parser::init(bool firstLineIsShebang) {
         //
     }
     
-    TheParser->nextToken(peek);
+    nextToken(peek);
     
-    peek = TheParser->currentToken(Ctxt, TOPLEVEL);
+    peek = currentToken(Ctxt, TOPLEVEL);
     
     if (peek.Tok != TOKEN_BANG) {
         //
@@ -42,18 +45,18 @@ void Parser::init(bool firstLineIsShebang) {
         //
     }
     
-    TheParser->nextToken(peek);
+    nextToken(peek);
     
     while (true) {
         
 #if !NABORT
-        if (TheParserSession->isAbort()) {
+        if (session->isAbort()) {
             
             break;
         }
 #endif // !NABORT
         
-        auto peek = TheParser->currentToken(Ctxt, TOPLEVEL);
+        auto peek = currentToken(Ctxt, TOPLEVEL);
         
         if (peek.Tok == TOKEN_ENDOFFILE) {
             break;
@@ -61,12 +64,12 @@ void Parser::init(bool firstLineIsShebang) {
         
         if (peek.Tok == TOKEN_TOPLEVELNEWLINE) {
             
-            TheParser->nextToken(peek);
+            nextToken(peek);
             
             break;
         }
         
-        TheParser->nextToken(peek);
+        nextToken(peek);
         
     } // while (true)
 }
@@ -74,11 +77,14 @@ void Parser::init(bool firstLineIsShebang) {
 void Parser::deinit() {
     
     Issues.clear();
+    
+    Frames.clear();
+    FrameCount = 0;
 }
 
 void Parser::nextToken(Token Tok) {
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
 }
 
 
@@ -92,7 +98,7 @@ Token Parser::nextToken0(ParserContext Ctxt, NextPolicy policy) {
     //   returnInternalNewlineMask is 0b000
     //
     auto returnInternalNewlineMask = static_cast<uint8_t>(insideGroup) << 2;
-    auto Tok = TheTokenizer->nextToken0(policy & ~(returnInternalNewlineMask));
+    auto Tok = session->tokenizer->nextToken0(policy & ~(returnInternalNewlineMask));
     
     return Tok;
 }
@@ -107,7 +113,7 @@ Token Parser::currentToken(ParserContext Ctxt, NextPolicy policy) const {
     //   returnInternalNewlineMask is 0b000
     //
     auto returnInternalNewlineMask = static_cast<uint8_t>(insideGroup) << 2;
-    auto Tok = TheTokenizer->currentToken(policy & ~(returnInternalNewlineMask));
+    auto Tok = session->tokenizer->currentToken(policy & ~(returnInternalNewlineMask));
     
     return Tok;
 }
@@ -115,94 +121,167 @@ Token Parser::currentToken(ParserContext Ctxt, NextPolicy policy) const {
 
 Token Parser::currentToken_stringifyAsSymbolSegment() const {
     
-    return TheTokenizer->currentToken_stringifyAsSymbolSegment();
+    return session->tokenizer->currentToken_stringifyAsSymbolSegment();
 }
 
 Token Parser::currentToken_stringifyAsFile() const {
     
-    return TheTokenizer->currentToken_stringifyAsFile();
+    return session->tokenizer->currentToken_stringifyAsFile();
 }
 
 #if !NISSUES
-IssuePtrSet& Parser::getIssues() {
+IssueVector& Parser::getIssues() {
     return Issues;
 }
 
 //
 // Only to be used by Parselets
 //
-void Parser::addIssue(IssuePtr I) {
-    Issues.insert(std::move(I));
+void Parser::addIssue(Issue I) {
+    
+    if ((session->policy & SKIP_ISSUES) == SKIP_ISSUES) {
+        return;
+    }
+    
+    Issues.push_back(std::move(I));
 }
 #endif // !NISSUES
 
 
-NodePtr Parser::infixLoop(NodePtr Left, ParserContext Ctxt) {
+NodePtr Parser::parse(PrefixParselet *P, Token firstTok, ParserContext Ctxt) {
+    
+    assert(FrameCount == 0);
+    
+    //
+    // The frame that is being resumed
+    //
+    ParserFrame F(session, nullptr, nullptr);
+    
+    P->parse(session, firstTok, Ctxt);
     
     while (true) {
         
+        switch (Step) {
+            case STEP_PREFIX: {
+                
+                prefixParselets[StepTok.Tok.value()]->parse(session, StepTok, StepCtxt);
+                
+                break;
+            }
+            case STEP_INFIXLOOP: {
+                
+                infixLoop0(std::move(StepNode), StepCtxt);
+                
+                break;
+            }
+            case STEP_RETURN: {
+                
+                if (FrameCount == 0) {
+                    return std::move(StepNode);
+                }
+                
+                FrameCount--;
+                
+                F = std::move(Frames[FrameCount]);
+                
+                F.Resume(session, F, std::move(StepNode));
+                
+                assert(F.Trivia.moved || F.Trivia.empty());
+                
+                break;
+            }
+        }
+    }
+}
+
+ParserFrame& Parser::pushFrame0(ParseletContinuation Resume, const void *P) {
+    
+    Frames.emplace_back(session, Resume, P);
+    
+    FrameCount++;
+    
+    return Frames.back();
+}
+
+void Parser::pushInfixLoop(ParserContext Ctxt) {
+    
+    auto& F = pushFrame(infixLoop1, this);
+    F.Ctxt = Ctxt;
+}
+
+//
+// One iteration of the infix loop
+//
+// If Left binds to an infix parselet, then push a frame that comes back here, and let the infix parselet parse its
+// operands
+//
+void Parser::infixLoop0(NodePtr Left, ParserContext Ctxt) {
+        
 #if !NABORT
-        if (TheParserSession->isAbort()) {
+    if (session->isAbort()) {
             
-            return TheParserSession->handleAbort();
-        }
+        return returnNode(session->handleAbort());
+    }
 #endif // !NABORT
         
-        auto token = currentToken(Ctxt, TOPLEVEL);
+    auto token = currentToken(Ctxt, TOPLEVEL);
         
-        InfixParseletPtr I;
-        Precedence TokenPrecedence;
+    InfixParseletPtr I;
+    Precedence TokenPrecedence;
         
-        NodeSeq LeftSeq;
-        {
-            LeafSeq Trivia1;
+    NodeSeq LeftSeq(session);
+    {
+        LeafSeq Trivia1(session);
             
-            token = eatTriviaButNotToplevelNewlines(token, Ctxt, TOPLEVEL, Trivia1);
+        token = eatTriviaButNotToplevelNewlines(token, Ctxt, TOPLEVEL, Trivia1);
             
-            I = infixParselets[token.Tok.value()];
+        I = infixParselets[token.Tok.value()];
             
-            token = I->processImplicitTimes(token, Ctxt);
-            I = infixParselets[token.Tok.value()];
+        token = I->processImplicitTimes(token, Ctxt);
+        I = infixParselets[token.Tok.value()];
             
-            TokenPrecedence = I->getPrecedence(Ctxt);
+        TokenPrecedence = I->getPrecedence(Ctxt);
             
-            //
-            // if (Ctxt.Prec > TokenPrecedence)
-            //   break;
-            // else if (Ctxt.Prec == TokenPrecedence && Ctxt.Prec.Associativity is NonRight)
-            //   break;
-            //
-            if ((Ctxt.Prec | 0x1) > TokenPrecedence) {
-                break;
-            }
+        //
+        // if (Ctxt.Prec > TokenPrecedence)
+        //   break;
+        // else if (Ctxt.Prec == TokenPrecedence && Ctxt.Prec.Associativity is NonRight)
+        //   break;
+        //
+        if ((Ctxt.Prec | 0x1) > TokenPrecedence) {
+            return returnNode(std::move(Left));
+        }
             
-            if (token.Tok == TOKEN_FAKE_IMPLICITTIMES) {
+        if (token.Tok == TOKEN_FAKE_IMPLICITTIMES) {
                 
-                //
-                // Reattach the ImplicitTimes to the operand for a better experience
-                //
+            //
+            // Reattach the ImplicitTimes to the operand for a better experience
+            //
                 
-                auto last = Left->lastToken();
+            auto last = Left->lastToken();
                 
-                token = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(last.BufLen.end), Source(last.Src.End));
+            token = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(last.BufLen.end), Source(last.Src.End));
                 
-                LeftSeq.append(std::move(Left));
+            LeftSeq.append(std::move(Left));
                 
-            } else {
+        } else {
                 
-                LeftSeq.append(std::move(Left));
-                LeftSeq.appendIfNonEmpty(std::move(Trivia1));
-            }
+            LeftSeq.append(std::move(Left));
+            LeftSeq.appendIfNonEmpty(std::move(Trivia1));
         }
+    }
         
-        auto Ctxt2 = Ctxt;
-        Ctxt2.Prec = TokenPrecedence;
+    pushInfixLoop(Ctxt);
+    
+    auto Ctxt2 = Ctxt;
+    Ctxt2.Prec = TokenPrecedence;
         
-        Left = I->parse(std::move(LeftSeq), token, Ctxt2);
+    return I->parse(session, std::move(LeftSeq), token, Ctxt2);
+}
         
-    } // while
+void Parser::infixLoop1(ParserSession *session, ParserFrame& F, NodePtr Right) {
     
-    return Left;
+    return session->parser->infixLoop0(std::move(Right), F.Ctxt);
 }
 
 Token Parser::eatTrivia(Token T, ParserContext Ctxt, NextPolicy policy, LeafSeq& Args) {
@@ -213,7 +292,7 @@ Token Parser::eatTrivia(Token T, ParserContext Ctxt, NextPolicy policy, LeafSeq&
         // No need to check isAbort() inside tokenizer loops
         //
         
-        Args.append(LeafNodePtr(new LeafNode(T)));
+        Args.append(LeafNodePtr(session->arena->make<LeafNode>(T)));
         
         nextToken(T);
         
@@ -231,7 +310,7 @@ Token Parser::eatTrivia_stringifyAsFile(Token T, ParserContext Ctxt, LeafSeq& Ar
         // No need to check isAbort() inside tokenizer loops
         //
         
-        Args.append(LeafNodePtr(new LeafNode(T)));
+        Args.append(LeafNodePtr(session->arena->make<LeafNode>(T)));
         
         nextToken(T);
         
@@ -249,7 +328,7 @@ Token Parser::eatTriviaButNotToplevelNewlines(Token T, ParserContext Ctxt, NextP
         // No need to check isAbort() inside tokenizer loops
         //
         
-        Args.append(LeafNodePtr(new LeafNode(T)));
+        Args.append(LeafNodePtr(session->arena->make<LeafNode>(T)));
         
         nextToken(T);
         
@@ -267,7 +346,7 @@ Token Parser::eatTriviaButNotToplevelNewlines_stringifyAsFile(Token T, ParserCon
         // No need to check isAbort() inside tokenizer loops
         //
         
-        Args.append(LeafNodePtr(new LeafNode(T)));
+        Args.append(LeafNodePtr(session->arena->make<LeafNode>(T)));
         
         nextToken(T);
         
@@ -276,5 +355,3 @@ Token Parser::eatTriviaButNotToplevelNewlines_stringifyAsFile(Token T, ParserCon
     
     return T;
 }
-
-ParserPtr TheParser = nullptr;
@@ -71,166 +71,191 @@
 //          ]
 
 
-NodePtr SemiSemiParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void SemiSemiParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
     auto Implicit = Token(TOKEN_FAKE_IMPLICITONE, BufferAndLength(TokIn.BufLen.buffer), Source(TokIn.Src.Start));
     
-    NodeSeq Left(1);
-    Left.append(NodePtr(new LeafNode(Implicit)));
+    NodeSeq Left(session, 1);
+    Left.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
     
-    return parse(std::move(Left), TokIn, Ctxt);
+    return parse(session, std::move(Left), TokIn, Ctxt);
 }
 
-NodePtr SemiSemiParselet::parse(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void SemiSemiParselet::parse(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     
-    auto Operand = parse0(std::move(Left), TokIn, Ctxt);
-    {
-        LeafSeq Trivia1;
+    auto& F = session->parser->pushFrame(parse1, this);
+    F.Ctxt = Ctxt;
+    
+    return parse0(session, std::move(Left), TokIn, Ctxt);
+}
+
+void SemiSemiParselet::parse1(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const SemiSemiParselet *>(F.P);
+    
+    auto Ctxt = F.Ctxt;
+    
+    LeafSeq Trivia1(session);
         
-        auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-        Tok = TheParser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia1);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia1);
         
-        if (!Tok.Tok.isPossibleBeginning()) {
+    if (!Tok.Tok.isPossibleBeginning()) {
             
-            //
-            // There is only a single ;; and there is no implicit Times
-            //
+        //
+        // There is only a single ;; and there is no implicit Times
+        //
             
-            goto retParse;
-        }
+        return session->parser->infixLoop(std::move(Operand), Ctxt);
+    }
         
-        if (Tok.Tok != TOKEN_SEMISEMI) {
+    if (Tok.Tok != TOKEN_SEMISEMI) {
             
-            //
-            // \[Integral];;x\[DifferentialD]x
-            //
+        //
+        // \[Integral];;x\[DifferentialD]x
+        //
             
-            goto retParse;
-        }
+        return session->parser->infixLoop(std::move(Operand), Ctxt);
+    }
         
-        NodeSeq Args(1 + 1);
-        Args.append(std::move(Operand));
-        Args.appendIfNonEmpty(std::move(Trivia1));
+    NodeSeq Args(session, 1 + 1);
+    Args.append(std::move(Operand));
+    Args.appendIfNonEmpty(std::move(Trivia1));
         
-        while (true) {
+    return P->parseLoop(session, std::move(Args), Ctxt);
+}
+
+void SemiSemiParselet::parseLoop(ParserSession *session, NodeSeq Args, ParserContext Ctxt) const {
             
 #if !NABORT
-            //
-            // Check isAbort() inside loops
-            //
-            if (TheParserSession->isAbort()) {
+    //
+    // Check isAbort() inside loops
+    //
+    if (session->isAbort()) {
                 
-                return TheParserSession->handleAbort();
-            }
+        return session->parser->returnNode(session->handleAbort());
+    }
 #endif // !NABORT
             
-            {
-                LeafSeq Trivia2;
+    LeafSeq Trivia2(session);
                 
-                auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
-                Tok = TheParser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia2);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
+    Tok = session->parser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia2);
                 
-                if (!Tok.Tok.isPossibleBeginning()) {
+    if (!Tok.Tok.isPossibleBeginning()) {
                     
-                    //
-                    // We are done, so return
-                    //
+        //
+        // We are done, so return
+        //
                     
-                    Operand = NodePtr(new InfixNode(SYMBOL_TIMES, std::move(Args)));
+        auto Operand = NodePtr(session->arena->make<InfixNode>(SYMBOL_TIMES, std::move(Args)));
                     
-                    goto retParse;
-                }
+        return session->parser->infixLoop(std::move(Operand), Ctxt);
+    }
+    
+    auto ImplicitTimes = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(Tok.BufLen.buffer), Source(Tok.Src.Start));
                 
-                if (Tok.Tok != TOKEN_SEMISEMI) {
+    if (Tok.Tok != TOKEN_SEMISEMI) {
                     
-                    //
-                    // Something like  \[Integral];;;;;;x\[DifferentialD]x
-                    //
-                    
-                    //
-                    // Lower precedence, so this is just a general expression
-                    //
-                    // Must also handle  a;;!b  where there is an Implicit Times, but only a single Span
-                    //
-                    
-                    Operand = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
-                    
-#if !NISSUES
-                    {
-                        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES, "Unexpected implicit ``Times`` between ``Spans``.", SYNTAXISSUESEVERITY_WARNING, Tok.Src, 0.75, {}));
-                        
-                        TheParser->addIssue(std::move(I));
-                    }
-#endif // !NISSUES
+        //
+        // Something like  \[Integral];;;;;;x\[DifferentialD]x
+        //
                     
-                    auto ImplicitTimes = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(Tok.BufLen.buffer), Source(Tok.Src.Start));
+        //
+        // Lower precedence, so this is just a general expression
+        //
+        // Must also handle  a;;!b  where there is an Implicit Times, but only a single Span
+        //
                     
-                    //
-                    // Could reserve here, if it were possible
-                    //
-                    Args.appendIfNonEmpty(std::move(Trivia2));
-                    Args.append(NodePtr(new LeafNode(ImplicitTimes)));
-                    Args.append(std::move(Operand));
+        //
+        // Could reserve here, if it were possible
+        //
+        Args.appendIfNonEmpty(std::move(Trivia2));
+        Args.append(NodePtr(session->arena->make<LeafNode>(ImplicitTimes)));
                         
-                    //
-                    // We are done here, so return
-                    //
+        auto& F = session->parser->pushFrame(parse2, this);
+        F.Ctxt = Ctxt;
+        F.Tok = Tok;
+        F.Args = std::move(Args);
                     
-                    Operand = NodePtr(new InfixNode(SYMBOL_TIMES, std::move(Args)));
-                    
-                    goto retParse;
-                }
-                
-                //
-                // Still within the ;;
-                //
+        return session->parser->parsePrefix(Tok, Ctxt);
+    }
                 
-                auto Implicit = Token(TOKEN_FAKE_IMPLICITONE, BufferAndLength(Tok.BufLen.buffer), Source(Tok.Src.Start));
+    //
+    // Still within the ;;
+    //
                 
-                NodeSeq Seq(1);
-                Seq.append(NodePtr(new LeafNode(Implicit)));
+    auto Implicit = Token(TOKEN_FAKE_IMPLICITONE, BufferAndLength(Tok.BufLen.buffer), Source(Tok.Src.Start));
                 
-                Operand = parse0(std::move(Seq), Tok, Ctxt);
+    NodeSeq Seq(session, 1);
+    Seq.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
                 
+    //
+    // Do not reserve inside loop
+    // Allow default resizing strategy, which is hopefully exponential
+    //
+    Args.appendIfNonEmpty(std::move(Trivia2));
+    Args.append(NodePtr(session->arena->make<LeafNode>(ImplicitTimes)));
+    
+    auto& F = session->parser->pushFrame(parse3, this);
+    F.Ctxt = Ctxt;
+    F.Tok = Tok;
+    F.Args = std::move(Args);
+    
+    return parse0(session, std::move(Seq), Tok, Ctxt);
+}
+            
+void SemiSemiParselet::parse2(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
 #if !NISSUES
-                {
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES, "Unexpected implicit ``Times`` between ``Spans``.", SYNTAXISSUESEVERITY_WARNING, Tok.Src, 0.75, {}));
-                    
-                    TheParser->addIssue(std::move(I));
-                }
+    {
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES, ISSUEMESSAGE_UNEXPECTEDIMPLICITTIMESBETWEENSPANS, SYNTAXISSUESEVERITY_WARNING, F.Tok.Src, 0.75);
+        
+        session->parser->addIssue(std::move(I));
+    }
 #endif // !NISSUES
-                
-                auto ImplicitTimes = Token(TOKEN_FAKE_IMPLICITTIMES, BufferAndLength(Tok.BufLen.buffer), Source(Tok.Src.Start));
-                
-                //
-                // Do not reserve inside loop
-                // Allow default resizing strategy, which is hopefully exponential
-                //
-                Args.appendIfNonEmpty(std::move(Trivia2));
-                Args.append(NodePtr(new LeafNode(ImplicitTimes)));
-                Args.append(std::move(Operand));
-            }
-            
-        } // while
+    
+    F.Args.append(std::move(Operand));
+    
+    //
+    // We are done here, so return
+    //
+    
+    auto Times = NodePtr(session->arena->make<InfixNode>(SYMBOL_TIMES, std::move(F.Args)));
+    
+    return session->parser->infixLoop(std::move(Times), F.Ctxt);
+}
+    
+void SemiSemiParselet::parse3(ParserSession *session, ParserFrame& F, NodePtr Operand) {
+    
+    auto P = static_cast<const SemiSemiParselet *>(F.P);
+    
+#if !NISSUES
+    {
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES, ISSUEMESSAGE_UNEXPECTEDIMPLICITTIMESBETWEENSPANS, SYNTAXISSUESEVERITY_WARNING, F.Tok.Src, 0.75);
+        
+        session->parser->addIssue(std::move(I));
     }
+#endif // !NISSUES
+    
+    F.Args.append(std::move(Operand));
     
-retParse:
-    return TheParser->infixLoop(std::move(Operand), Ctxt);
+    return P->parseLoop(session, std::move(F.Args), F.Ctxt);
 }
 
 
-NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void SemiSemiParselet::parse0(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     
     Ctxt.Prec = PRECEDENCE_SEMISEMI;
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    auto SecondTok = TheParser->currentToken(Ctxt, TOPLEVEL);
+    auto SecondTok = session->parser->currentToken(Ctxt, TOPLEVEL);
     
     {
-        LeafSeq Trivia1;
+        LeafSeq Trivia1(session);
         
-        SecondTok = TheParser->eatTriviaButNotToplevelNewlines(SecondTok, Ctxt, TOPLEVEL, Trivia1);
+        SecondTok = session->parser->eatTriviaButNotToplevelNewlines(SecondTok, Ctxt, TOPLEVEL, Trivia1);
         
         //
         // a;;
@@ -246,12 +271,12 @@ NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt)
             
             auto Implicit = Token(TOKEN_FAKE_IMPLICITALL, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End));
             
-            NodeSeq Args(1 + 1 + 1);
-            Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-            Args.append(NodePtr(new LeafNode(TokIn)));
-            Args.append(NodePtr(new LeafNode(Implicit)));
+            NodeSeq Args(session, 1 + 1 + 1);
+            Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
             
-            return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
+            return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(Args))));
         }
         
         if (SecondTok.Tok != TOKEN_SEMISEMI) {
@@ -261,115 +286,16 @@ NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt)
             //    ^SecondTok
             //
             
-            auto FirstArg = prefixParselets[SecondTok.Tok.value()]->parse(SecondTok, Ctxt);
-            
-            {
-                LeafSeq Trivia2;
-                
-                auto ThirdTok = TheParser->currentToken(Ctxt, TOPLEVEL);
-                ThirdTok = TheParser->eatTriviaButNotToplevelNewlines(ThirdTok, Ctxt, TOPLEVEL, Trivia2);
-                
-                if (!ThirdTok.Tok.isPossibleBeginning()) {
-                    
-                    //
-                    // a;;b&
-                    //     ^ThirdTok
-                    //
-                    
-                    NodeSeq Args(1 + 1 + 1 + 1);
-                    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                    Args.append(NodePtr(new LeafNode(TokIn)));
-                    Args.appendIfNonEmpty(std::move(Trivia1));
-                    Args.append(std::move(FirstArg));
-                    
-                    return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
-                }
-                
-                if (ThirdTok.Tok != TOKEN_SEMISEMI) {
-                    
-                    //
-                    // \[Integral];;x\[DifferentialD]x
-                    //               ^~~~~~~~~~~~~~~~ThirdTok
-                    //
-                    
-                    NodeSeq Args(1 + 1 + 1 + 1);
-                    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                    Args.append(NodePtr(new LeafNode(TokIn)));
-                    Args.appendIfNonEmpty(std::move(Trivia1));
-                    Args.append(std::move(FirstArg));
-                    
-                    return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
-                }
-                
-                //
-                // a;;b;;
-                //     ^~ThirdTok
-                //
-                
-                {
-                    // for RAII
-                    LeafSeq ThirdTokSeq;
-                    ThirdTokSeq.append(LeafNodePtr(new LeafNode(ThirdTok)));
-                    
-                    LeafSeq Trivia3;
-                    
-                    TheParser->nextToken(ThirdTok);
-                    
-                    auto FourthTok = TheParser->currentToken(Ctxt, TOPLEVEL);
-                    FourthTok = TheParser->eatTriviaButNotToplevelNewlines(FourthTok, Ctxt, TOPLEVEL, Trivia3);
-                    
-                    if (!FourthTok.Tok.isPossibleBeginning()) {
+            NodeSeq Args(session, 1 + 1 + 1 + 1 + 1 + 1 + 1 + 1);
+            Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+            Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+            Args.appendIfNonEmpty(std::move(Trivia1));
                         
-                        //
-                        // a;;b;;&
-                        //       ^FourthTok
-                        //
-                        
-                        NodeSeq Args(1 + 1 + 1 + 1);
-                        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                        Args.append(NodePtr(new LeafNode(TokIn)));
-                        Args.appendIfNonEmpty(std::move(Trivia1));
-                        Args.append(std::move(FirstArg));
-                        
-                        return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
-                    }
+            auto& F = session->parser->pushFrame(parse01, this);
+            F.Ctxt = Ctxt;
+            F.Args = std::move(Args);
                     
-                    if (FourthTok.Tok != TOKEN_SEMISEMI) {
-                        
-                        //
-                        // a;;b;;c
-                        //       ^FourthTok
-                        //
-                        
-                        auto SecondArg = prefixParselets[FourthTok.Tok.value()]->parse(FourthTok, Ctxt);
-                        
-                        NodeSeq Args(1 + 1 + 1 + 1 + 1 + 1 + 1 + 1);
-                        Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                        Args.append(NodePtr(new LeafNode(TokIn)));
-                        Args.appendIfNonEmpty(std::move(Trivia1));
-                        Args.append(std::move(FirstArg));
-                        Args.appendIfNonEmpty(std::move(Trivia2));
-                        Args.append(NodePtr(new LeafSeqNode(std::move(ThirdTokSeq))));
-                        Args.appendIfNonEmpty(std::move(Trivia3));
-                        Args.append(std::move(SecondArg));
-                        
-                        return NodePtr(new TernaryNode(SYMBOL_SPAN, std::move(Args)));
-                    }
-                    
-                    //
-                    // a;;b;;;;
-                    //       ^~FourthTok
-                    //
-                    
-                    NodeSeq Args(1 + 1 + 1 + 1);
-                    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                    Args.append(NodePtr(new LeafNode(TokIn)));
-                    Args.appendIfNonEmpty(std::move(Trivia1));
-                    Args.append(std::move(FirstArg));
-                    
-                    return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
-                }
-            }
+            return session->parser->parsePrefix(SecondTok, Ctxt);
         }
         
         //
@@ -379,15 +305,15 @@ NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt)
         
         {
             // for RAII
-            LeafSeq SecondTokSeq;
-            SecondTokSeq.append(LeafNodePtr(new LeafNode(SecondTok)));
+            LeafSeq SecondTokSeq(session);
+            SecondTokSeq.append(LeafNodePtr(session->arena->make<LeafNode>(SecondTok)));
             
-            LeafSeq Trivia2;
+            LeafSeq Trivia2(session);
             
-            TheParser->nextToken(SecondTok);
+            session->parser->nextToken(SecondTok);
             
-            auto ThirdTok = TheParser->currentToken(Ctxt, TOPLEVEL);
-            ThirdTok = TheParser->eatTriviaButNotToplevelNewlines(ThirdTok, Ctxt, TOPLEVEL, Trivia2);
+            auto ThirdTok = session->parser->currentToken(Ctxt, TOPLEVEL);
+            ThirdTok = session->parser->eatTriviaButNotToplevelNewlines(ThirdTok, Ctxt, TOPLEVEL, Trivia2);
             
             if (!ThirdTok.Tok.isPossibleBeginning()) {
                 
@@ -398,12 +324,12 @@ NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt)
                 
                 auto Implicit = Token(TOKEN_FAKE_IMPLICITALL, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End));
                 
-                NodeSeq Args(1 + 1 + 1);
-                Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                Args.append(NodePtr(new LeafNode(TokIn)));
-                Args.append(NodePtr(new LeafNode(Implicit)));
+                NodeSeq Args(session, 1 + 1 + 1);
+                Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+                Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+                Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
                 
-                return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
+                return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(Args))));
             }
             
             if (ThirdTok.Tok != TOKEN_SEMISEMI) {
@@ -413,20 +339,20 @@ NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt)
                 //      ^ThirdTok
                 //
                 
-                auto FirstArg = prefixParselets[ThirdTok.Tok.value()]->parse(ThirdTok, Ctxt);
-                
                 auto Implicit = Token(TOKEN_FAKE_IMPLICITALL, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End));
                 
-                NodeSeq Args(1 + 1 + 1 + 1 + 1 + 1 + 1);
-                Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                Args.append(NodePtr(new LeafNode(TokIn)));
-                Args.append(NodePtr(new LeafNode(Implicit)));
+                NodeSeq Args(session, 1 + 1 + 1 + 1 + 1 + 1 + 1);
+                Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+                Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+                Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
                 Args.appendIfNonEmpty(std::move(Trivia1));
-                Args.append(NodePtr(new LeafSeqNode(std::move(SecondTokSeq))));
+                Args.append(NodePtr(session->arena->make<LeafSeqNode>(std::move(SecondTokSeq))));
                 Args.appendIfNonEmpty(std::move(Trivia2));
-                Args.append(std::move(FirstArg));
                 
-                return NodePtr(new TernaryNode(SYMBOL_SPAN, std::move(Args)));
+                auto& F = session->parser->pushFrame(parse02, this);
+                F.Args = std::move(Args);
+                
+                return session->parser->parsePrefix(ThirdTok, Ctxt);
             }
             
             //
@@ -435,17 +361,113 @@ NodePtr SemiSemiParselet::parse0(NodeSeq Left, Token TokIn, ParserContext Ctxt)
             //
             
             {
-                LeafSeq Trivia3;
+                LeafSeq Trivia3(session);
                 
                 auto Implicit = Token(TOKEN_FAKE_IMPLICITALL, BufferAndLength(TokIn.BufLen.end), Source(TokIn.Src.End));
                 
-                NodeSeq Args(1 + 1 + 1);
-                Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
-                Args.append(NodePtr(new LeafNode(TokIn)));
-                Args.append(NodePtr(new LeafNode(Implicit)));
+                NodeSeq Args(session, 1 + 1 + 1);
+                Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
+                Args.append(NodePtr(session->arena->make<LeafNode>(TokIn)));
+                Args.append(NodePtr(session->arena->make<LeafNode>(Implicit)));
                 
-                return NodePtr(new BinaryNode(SYMBOL_SPAN, std::move(Args)));
+                return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(Args))));
             }
         }
     }
 }
+
+void SemiSemiParselet::parse01(ParserSession *session, ParserFrame& F, NodePtr FirstArg) {
+    
+    auto Ctxt = F.Ctxt;
+    
+    //
+    // Left, TokIn, Trivia1, FirstArg
+    //
+    F.Args.append(std::move(FirstArg));
+    
+    {
+        LeafSeq Trivia2(session);
+        
+        auto ThirdTok = session->parser->currentToken(Ctxt, TOPLEVEL);
+        ThirdTok = session->parser->eatTriviaButNotToplevelNewlines(ThirdTok, Ctxt, TOPLEVEL, Trivia2);
+        
+        if (!ThirdTok.Tok.isPossibleBeginning()) {
+            
+            //
+            // a;;b&
+            //     ^ThirdTok
+            //
+            
+            return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(F.Args))));
+        }
+        
+        if (ThirdTok.Tok != TOKEN_SEMISEMI) {
+            
+            //
+            // \[Integral];;x\[DifferentialD]x
+            //               ^~~~~~~~~~~~~~~~ThirdTok
+            //
+            
+            return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(F.Args))));
+        }
+        
+        //
+        // a;;b;;
+        //     ^~ThirdTok
+        //
+        
+        {
+            // for RAII
+            LeafSeq ThirdTokSeq(session);
+            ThirdTokSeq.append(LeafNodePtr(session->arena->make<LeafNode>(ThirdTok)));
+            
+            LeafSeq Trivia3(session);
+            
+            session->parser->nextToken(ThirdTok);
+            
+            auto FourthTok = session->parser->currentToken(Ctxt, TOPLEVEL);
+            FourthTok = session->parser->eatTriviaButNotToplevelNewlines(FourthTok, Ctxt, TOPLEVEL, Trivia3);
+            
+            if (!FourthTok.Tok.isPossibleBeginning()) {
+                
+                //
+                // a;;b;;&
+                //       ^FourthTok
+                //
+                
+                return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(F.Args))));
+            }
+            
+            if (FourthTok.Tok != TOKEN_SEMISEMI) {
+                
+                //
+                // a;;b;;c
+                //       ^FourthTok
+                //
+                
+                F.Args.appendIfNonEmpty(std::move(Trivia2));
+                F.Args.append(NodePtr(session->arena->make<LeafSeqNode>(std::move(ThirdTokSeq))));
+                F.Args.appendIfNonEmpty(std::move(Trivia3));
+                
+                auto& F2 = session->parser->pushFrame(parse02, F.P);
+                F2.Args = std::move(F.Args);
+                
+                return session->parser->parsePrefix(FourthTok, Ctxt);
+            }
+            
+            //
+            // a;;b;;;;
+            //       ^~FourthTok
+            //
+            
+            return session->parser->returnNode(NodePtr(session->arena->make<BinaryNode>(SYMBOL_SPAN, std::move(F.Args))));
+        }
+    }
+}
+
+void SemiSemiParselet::parse02(ParserSession *session, ParserFrame& F, NodePtr SecondArg) {
+    
+    F.Args.append(std::move(SecondArg));
+    
+    return session->parser->returnNode(NodePtr(session->arena->make<TernaryNode>(SYMBOL_SPAN, std::move(F.Args))));
+}
@@ -4,11 +4,14 @@
 #include "ByteDecoder.h" // for ByteDecoder
 #include "ByteEncoder.h" // for ByteEncoder
 #include "ByteBuffer.h" // for ByteBuffer
+#include "API.h" // for ParserSession
 #include "Symbol.h" // for SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXISSUE, etc.
 #include "Utils.h" // for isMBNewline, etc.
 //#include "WLCharacter.h" // for set_graphical
 #include "LongNames.h" // for CodePointToLongNameMap
+#include "CSTWriter.h" // for CSTWriter
 
+#include <cstring> // for strlen, strcmp
 #include <cctype> // for isalnum, isxdigit, isupper, isdigit, isalpha, ispunct, iscntrl with GCC and MSVC
 #include <sstream> // for ostringstream
 
@@ -54,15 +57,40 @@ void BufferAndLength::putUTF8String(MLINK mlp) const {
 }
 #endif // USE_MATHLINK
 
+#if USE_EXPR_LIB
+void BufferAndLength::toExprUTF8String(ExprBuilder& B) const {
+    
+    if (status == UTF8STATUS_NORMAL) {
+        
+        B.string(buffer, length());
+        
+        return;
+    }
+    
+    std::string str;
+    
+    auto niceBufAndLen = createNiceBufferAndLength(&str);
+    
+    niceBufAndLen.toExprUTF8String(B);
+}
+#endif // USE_EXPR_LIB
+
 
 BufferAndLength BufferAndLength::createNiceBufferAndLength(std::string *str) const {
     
     //
     // make new Buffer
     //
+    // Decode with a scratch session so that the state of any session that is currently parsing is left alone
+    //
+    
+    ParserSession session;
     
-    auto oldBuf = TheByteBuffer->buffer;
-    auto oldStatus = TheByteDecoder->getStatus();
+    //
+    // Arbitrarily choose LineColumn convention, but it is not used
+    //
+    session.byteBuffer->init(*this);
+    session.byteDecoder->init(SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
     
     //
     // This is an error path, so fine to use things like ostringstream
@@ -76,20 +104,14 @@ BufferAndLength BufferAndLength::createNiceBufferAndLength(std::string *str) con
     
     NextPolicy policy = 0;
     
-    //
-    // Simulating a new buffer here, so make sure to set both buffer AND wasEOF!
-    //
-    TheByteBuffer->buffer = buffer;
-    TheByteBuffer->wasEOF = false;
-    
     while (true) {
         
-        if (TheByteBuffer->buffer == end) {
+        if (session.byteBuffer->buffer == end) {
             break;
         }
-        assert(TheByteBuffer->buffer < end);
+        assert(session.byteBuffer->buffer < end);
         
-        auto c = TheByteDecoder->currentSourceCharacter(policy);
+        auto c = session.byteDecoder->currentSourceCharacter(policy);
         assert(!c.isEndOfFile());
         
         if (status == UTF8STATUS_NONCHARACTER_OR_BOM) {
@@ -110,11 +132,11 @@ BufferAndLength BufferAndLength::createNiceBufferAndLength(std::string *str) con
             newStrStream << c;
         }
         
-        TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+        session.byteBuffer->buffer = session.byteDecoder->lastBuf;
     }
     
-    TheByteBuffer->buffer = oldBuf;
-    TheByteDecoder->setStatus(oldStatus);
+    session.byteDecoder->deinit();
+    session.byteBuffer->deinit();
     
     *str = newStrStream.str();
     
@@ -137,17 +159,20 @@ bool operator!=(BufferAndLength a, BufferAndLength b) {
 
 
 
-bool IssuePtrCompare::operator() (const IssuePtr &L, const IssuePtr &R) const {
+bool IssueCompare::operator() (const Issue &L, const Issue &R) const {
     
-    if (L->getSource() < R->getSource()) {
+    if (L.getSource() < R.getSource()) {
         return true;
     }
     
-    if (L->Tag < R->Tag) {
-        return true;
+    if (R.getSource() < L.getSource()) {
+        return false;
     }
     
-    return false;
+    //
+    // Compare the strings, so that issues are in the same order as when tags were strings
+    //
+    return strcmp(IssueTagToString(L.Tag), IssueTagToString(R.Tag)) < 0;
 }
 
 
@@ -165,31 +190,213 @@ bool CodeActionPtrCompare::operator() (const CodeActionPtr &L, const CodeActionP
 }
 
 
-Issue::Issue(std::string Tag, std::string Msg, std::string Sev, Source Src, double Val, CodeActionPtrSet Actions) : Tag(Tag), Msg(Msg), Sev(Sev), Src(Src), Val(Val), Actions(std::move(Actions)) {}
+const char *IssueTagToString(IssueTag Tag) {
+    switch (Tag) {
+        case SYNTAXISSUETAG_UNRECOGNIZEDCHARACTER: return "UnrecognizedCharacter";
+        case SYNTAXISSUETAG_UNSUPPORTEDCHARACTER: return "UnsupportedCharacter";
+        case SYNTAXISSUETAG_UNDOCUMENTEDCHARACTER: return "UndocumentedCharacter";
+        case SYNTAXISSUETAG_UNEXPECTEDESCAPESEQUENCE: return "UnexpectedEscapeSequence";
+        case SYNTAXISSUETAG_UNEXPECTEDCHARACTER: return "UnexpectedCharacter";
+        case SYNTAXISSUETAG_UNEXPECTEDNEWLINECHARACTER: return "UnexpectedNewlineCharacter";
+        case SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER: return "UnexpectedSpaceCharacter";
+        case SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER: return "UnexpectedLetterlikeCharacter";
+        case SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX: return "UndocumentedSlotSyntax";
+        case SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES: return "UnexpectedImplicitTimes";
+        case SYNTAXISSUETAG_COMMA: return "Comma";
+        case FORMATISSUETAG_INSERTSPACE: return "InsertSpace";
+        case ENCODINGISSUETAG_INVALIDCHARACTERENCODING: return "InvalidCharacterEncoding";
+        case ENCODINGISSUETAG_UNEXPECTEDCARRIAGERETURN: return "UnexpectedCarriageReturn";
+        default:
+            assert(false);
+            return "";
+    }
+}
+
+const char *IssueSeverityToString(IssueSeverity Sev) {
+    switch (Sev) {
+        case SYNTAXISSUESEVERITY_REMARK: return "Remark";
+        case SYNTAXISSUESEVERITY_WARNING: return "Warning";
+        case SYNTAXISSUESEVERITY_ERROR: return "Error";
+        case SYNTAXISSUESEVERITY_FATAL: return "Fatal";
+        case FORMATISSUESEVERITY_FORMATTING: return "Formatting";
+        default:
+            assert(false);
+            return "";
+    }
+}
+
+const char *IssueKindSymbolName(IssueKind Kind) {
+    switch (Kind) {
+        case ISSUEKIND_SYNTAX: return SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXISSUE->name();
+        case ISSUEKIND_FORMAT: return SYMBOL_CODEPARSER_LIBRARY_MAKEFORMATISSUE->name();
+        case ISSUEKIND_ENCODING: return SYMBOL_CODEPARSER_LIBRARY_MAKEENCODINGISSUE->name();
+        default:
+            assert(false);
+            return "";
+    }
+}
+
+static std::string BufferString(BufferAndLength B) {
+    
+    if (B.length() == 0) {
+        return "";
+    }
+    
+    return std::string(reinterpret_cast<const char *>(B.buffer), B.length());
+}
+
+
+Issue::Issue(IssueKind Kind, IssueTag Tag, IssueMessage Msg, IssueSeverity Sev, Source Src, double Val, IssueAction Act, WLCharacter Char, BufferAndLength Buf, BufferAndLength Suggestion) : Src(Src), Val(Val), Buf(Buf), Suggestion(Suggestion), Char(Char), Kind(Kind), Tag(Tag), Sev(Sev), Msg(Msg), Act(Act) {}
 
 Source Issue::getSource() const {
     return Src;
 }
 
+std::string Issue::getMessage() const {
+    switch (Msg) {
+        case ISSUEMESSAGE_UNEXPECTEDCARRIAGERETURN:
+            return "Unexpected ``\\r`` character.";
+        case ISSUEMESSAGE_UNEXPECTEDENCODEDCHARACTER: {
+            
+            auto c = SourceCharacter(Char.to_point());
+            
+            return "Unexpected character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.";
+        }
+        case ISSUEMESSAGE_INVALIDUTF8SEQUENCE:
+            return "Invalid UTF-8 sequence.";
+        case ISSUEMESSAGE_EXTRACOMMA:
+            return "Extra ``,``.";
+        case ISSUEMESSAGE_UNEXPECTEDIMPLICITTIMESBETWEENSPANS:
+            return "Unexpected implicit ``Times`` between ``Spans``.";
+        case ISSUEMESSAGE_UNEXPECTEDSPACECHARACTER:
+            return "Unexpected space character: ``\"" + Char.safeEncodedCharString() + "\" (" + Char.graphicalString() + ")``.";
+        case ISSUEMESSAGE_UNEXPECTEDNEWLINECHARACTER:
+            return "Unexpected newline character: ``" + Char.graphicalString() + "``.";
+        case ISSUEMESSAGE_UNEXPECTEDLETTERLIKECHARACTER:
+            if (Char.escape() == ESCAPE_NONE) {
+                return "Unexpected letterlike character: ``\"" + Char.safeEncodedCharString() + "\" (" + Char.graphicalString() + ")``.";
+            }
+            return "Unexpected letterlike character: ``" + Char.graphicalString() + "``.";
+        case ISSUEMESSAGE_UNEXPECTEDCHARACTER:
+            return "Unexpected character: ``" + Char.graphicalString() + "``.";
+        case ISSUEMESSAGE_UNDOCUMENTEDSLOTBACKTICK:
+            return "The name following ``#`` is not documented to allow the **`** character.";
+        case ISSUEMESSAGE_UNDOCUMENTEDSLOTDOLLAR:
+            return "The name following ``#`` is not documented to allow the ``$`` character.";
+        case ISSUEMESSAGE_UNDOCUMENTEDSLOTDOUBLEQUOTE:
+            return "The name following ``#`` is not documented to allow the ``\"`` character.";
+        case ISSUEMESSAGE_SUSPICIOUSSYNTAX:
+            return "Suspicious syntax.";
+        case ISSUEMESSAGE_SPACEBETWEENMINUSGREATER:
+            return "Put a space between ``-`` and ``>`` to reduce ambiguity";
+        case ISSUEMESSAGE_SPACEBETWEENMINUSEQUAL:
+            return "Put a space between ``-`` and ``=`` to reduce ambiguity";
+        case ISSUEMESSAGE_SPACEBETWEENGREATEREQUAL:
+            return "Put a space between ``>`` and ``=`` to reduce ambiguity";
+        case ISSUEMESSAGE_SPACEBETWEENPLUSEQUAL:
+            return "Put a space between ``+`` and ``=`` to reduce ambiguity";
+        case ISSUEMESSAGE_UNRECOGNIZEDCHARACTER:
+            return "Unrecognized character: ``\\" + BufferString(Buf) + "``.";
+        case ISSUEMESSAGE_UNSUPPORTEDCHARACTER:
+            return "Unsupported character: ``\\" + BufferString(Buf) + "``.";
+        case ISSUEMESSAGE_UNDOCUMENTEDCHARACTER:
+            return "Undocumented character: ``\\" + BufferString(Buf) + "``.";
+        case ISSUEMESSAGE_UNEXPECTEDESCAPESEQUENCE:
+            return "Unexpected escape sequence: ``\\\\" + BufferString(Buf) + "``.";
+        case ISSUEMESSAGE_UNRECOGNIZEDESCAPE:
+            return "Unrecognized character ``\\" + BufferString(Buf) + "``.";
+        case ISSUEMESSAGE_UNRECOGNIZEDESCAPEDCHARACTER:
+            return "Unrecognized character ``\\\\" + Char.graphicalString() + "``.";
+        default:
+            assert(false);
+            return "";
+    }
+}
+
+CodeActionPtrSet Issue::getActions() const {
+    
+    CodeActionPtrSet Actions;
+    
+    switch (Act) {
+        case ISSUEACTION_NONE:
+            break;
+        case ISSUEACTION_REPLACEWITHGRAPHICAL: {
+            
+            auto graphicalStr = SourceCharacter(Char.to_point()).graphicalString();
+            
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``" + graphicalStr + "``", Src, graphicalStr)));
+            
+            for (const auto& r : LongNames::asciiReplacements(Char.to_point())) {
+                Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``" + LongNames::replacementGraphical(r) + "``", Src, r)));
+            }
+        }
+            break;
+        case ISSUEACTION_DELETECOMMA:
+            Actions.insert(CodeActionPtr(new DeleteTextCodeAction("Delete ``,``", Src)));
+            break;
+        case ISSUEACTION_INSERTSPACE:
+            Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(Src.Start), " ")));
+            break;
+        case ISSUEACTION_INSERTSTAR:
+            Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert ``*``", Source(Src.Start), "*")));
+            break;
+        case ISSUEACTION_ESCAPEBACKSLASH:
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\\\" + BufferString(Buf) + "``", Src, "\\\\" + BufferString(Buf))));
+            break;
+        case ISSUEACTION_INSERTCLOSESQUARE:
+            Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert ``]`` to form ``\\[" + BufferString(Suggestion) + "]``", Source(Src.End), "]")));
+            break;
+        case ISSUEACTION_REPLACEWITHSUGGESTION:
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + BufferString(Suggestion) + "]``", Src, "\\[" + BufferString(Suggestion) + "]")));
+            break;
+        case ISSUEACTION_INSERTOPENSQUARE: {
+            
+            auto Start = Src.Start;
+            
+            Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert ``[`` to form ``\\[" + BufferString(Buf) + "``", Source(Start.next()), "[")));
+        }
+            break;
+        case ISSUEACTION_REPLACEWITHLONGNAMEOR4HEX:
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + BufferString(Buf) + "XXX]``", Src, "\\[" + BufferString(Buf) + "XXX]")));
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\:" + BufferString(Buf) + "XXX``", Src, "\\:" + BufferString(Buf) + "XXX")));
+            break;
+        case ISSUEACTION_REPLACEWITHLONGNAME:
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\[" + BufferString(Buf) + "XXX]``", Src, "\\[" + BufferString(Buf) + "XXX]")));
+            break;
+        case ISSUEACTION_REPLACEWITH4HEX:
+            Actions.insert(CodeActionPtr(new ReplaceTextCodeAction("Replace with ``\\:" + BufferString(Buf) + "xxx``", Src, "\\:" + BufferString(Buf) + "xxx")));
+            break;
+        default:
+            assert(false);
+            break;
+    }
+    
+    return Actions;
+}
 
-void SyntaxIssue::print(std::ostream& s) const {
+void Issue::print(std::ostream& s) const {
     
-    s << SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXISSUE->name() << "[";
+    s << IssueKindSymbolName(Kind) << "[";
     
-    s << Tag.c_str() << ", ";
+    s << IssueTagToString(Tag) << ", ";
     
-    s << Msg.c_str() << ", ";
+    s << getMessage().c_str() << ", ";
     
-    s << Sev.c_str() << ", ";
+    s << IssueSeverityToString(Sev) << ", ";
     
     getSource().print(s);
     
     s << ", ";
     
-    s << Val;
-    s << ", ";
+    //
+    // Only syntax issues print their confidence
+    //
+    if (Kind == ISSUEKIND_SYNTAX) {
+        s << Val;
+        s << ", ";
+    }
     
-    for (auto& A : Actions) {
+    for (auto& A : getActions()) {
         A->print(s);
         s << ", ";
     }
@@ -197,18 +404,20 @@ void SyntaxIssue::print(std::ostream& s) const {
     s << "]";
 }
 
-bool SyntaxIssue::check() const {
+bool Issue::check() const {
+    
+    if (Kind == ISSUEKIND_FORMAT) {
+        return true;
+    }
+    
+    if (Msg == ISSUEMESSAGE_EXTRACOMMA) {
+        return false;
+    }
+    
     return Sev != SYNTAXISSUESEVERITY_FATAL;
 }
 
 
-ExtraCommaIssue::ExtraCommaIssue(Source Src, CodeActionPtrSet Actions) : SyntaxIssue(SYNTAXISSUETAG_COMMA, "Extra ``,``.", SYNTAXISSUESEVERITY_ERROR, Src, 1.0, std::move(Actions)) {}
-
-bool ExtraCommaIssue::check() const {
-    return false;
-}
-
-
 CodeAction::CodeAction(std::string Label, Source Src) : Label(Label), Src(Src) {}
 
 Source CodeAction::getSource() const {
@@ -293,65 +502,36 @@ void DeleteTriviaCodeAction::print(std::ostream& s) const {
     s << "]";
 }
 
-void FormatIssue::print(std::ostream& s) const {
-    
-    s << SYMBOL_CODEPARSER_LIBRARY_MAKEFORMATISSUE->name() << "[";
-    
-    s << Tag.c_str() << ", ";
-    
-    s << Msg.c_str() << ", ";
-    
-    s << Sev.c_str() << ", ";
-    
-    getSource().print(s);
-    
-    s << ", ";
+void ReplaceTextCodeAction::write(CSTWriter& W) const {
     
-    for (auto& A : Actions) {
-        A->print(s);
-        s << ", ";
-    }
-    
-    s << "]";
+    W.action(SYMBOL_CODEPARSER_LIBRARY_MAKEREPLACETEXTCODEACTION->name(), Label, getSource(), ReplacementText);
 }
 
-bool FormatIssue::check() const {
-    return true;
+void InsertTextCodeAction::write(CSTWriter& W) const {
+    
+    W.action(SYMBOL_CODEPARSER_LIBRARY_MAKEINSERTTEXTCODEACTION->name(), Label, getSource(), InsertionText);
 }
 
-
-void EncodingIssue::print(std::ostream& s) const {
-    
-    s << SYMBOL_CODEPARSER_LIBRARY_MAKEENCODINGISSUE->name() << "[";
-    
-    s << Tag.c_str() << ", ";
-    
-    s << Msg.c_str() << ", ";
-    
-    s << Sev.c_str() << ", ";
-    
-    getSource().print(s);
-    
-    s << ", ";
+void InsertTextAfterCodeAction::write(CSTWriter& W) const {
     
-    for (auto& A : Actions) {
-        A->print(s);
-        s << ", ";
-    }
-    
-    s << "]";
+    W.action(SYMBOL_CODEPARSER_LIBRARY_MAKEINSERTTEXTAFTERCODEACTION->name(), Label, getSource(), InsertionText);
 }
 
-bool EncodingIssue::check() const {
-    return Sev != ENCODINGISSUESEVERITY_FATAL;
+void DeleteTextCodeAction::write(CSTWriter& W) const {
+    
+    W.action(SYMBOL_CODEPARSER_LIBRARY_MAKEDELETETEXTCODEACTION->name(), Label, getSource(), "");
 }
 
+void DeleteTriviaCodeAction::write(CSTWriter& W) const {
+    
+    W.action(SYMBOL_CODEPARSER_LIBRARY_MAKEDELETETRIVIACODEACTION->name(), Label, getSource(), "");
+}
 
 //
 // SyntaxError
 //
 
-std::string SyntaxErrorToString(SyntaxError Err) {
+const char *SyntaxErrorToString(SyntaxError Err) {
     switch (Err) {
         case SYNTAXERROR_UNKNOWN: return "SyntaxError`Unknown";
         case SYNTAXERROR_EXPECTEDTILDE: return "SyntaxError`ExpectedTilde";
@@ -482,6 +662,39 @@ void PrintTo(const Source& Src, std::ostream* s) {
     Src.print(*s);
 }
 
+void SourceShift::apply(SourceLocation& L) const {
+    L.first += first;
+    L.second += second;
+}
+
+void SourceShift::apply(Source& Src) const {
+    apply(Src.Start);
+    apply(Src.End);
+}
+
+void SourceShift::apply(BufferAndLength& B) const {
+    
+    if (!B.buffer) {
+        return;
+    }
+    
+    B.buffer += bytes;
+    B.end += bytes;
+}
+
+void SourceShift::apply(Issue& I) const {
+    
+    apply(I.Src);
+    apply(I.Buf);
+}
+
+void SourceShift::apply(SourceLocationVector& Locs) const {
+    
+    for (auto& L : Locs) {
+        apply(L);
+    }
+}
+
 
 
 //
@@ -815,21 +1028,29 @@ SourceCharacter::SourceCharacter_iterator SourceCharacter::end() {
 
 
 #if USE_MATHLINK
-void SyntaxIssue::put(MLINK mlp) const {
+void Issue::put(MLINK mlp) const {
+    
+    auto Actions = getActions();
     
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXISSUE->name(), static_cast<int>(3 + 4 + 1 + Actions.size()))) {
+    if (!MLPutFunction(mlp, IssueKindSymbolName(Kind), static_cast<int>(3 + 4 + 1 + Actions.size()))) {
         assert(false);
     }
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Tag.c_str()), static_cast<int>(Tag.size()))) {
+    auto TagStr = IssueTagToString(Tag);
+    
+    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(TagStr), static_cast<int>(strlen(TagStr)))) {
         assert(false);
     }
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Msg.c_str()), static_cast<int>(Msg.size()))) {
+    auto MsgStr = getMessage();
+    
+    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(MsgStr.c_str()), static_cast<int>(MsgStr.size()))) {
         assert(false);
     }
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Sev.c_str()), static_cast<int>(Sev.size()))) {
+    auto SevStr = IssueSeverityToString(Sev);
+    
+    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(SevStr), static_cast<int>(strlen(SevStr)))) {
         assert(false);
     }
     
@@ -921,104 +1142,154 @@ void DeleteTriviaCodeAction::put(MLINK mlp) const {
     Src.put(mlp);
 }
 
-void FormatIssue::put(MLINK mlp) const {
-    
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEFORMATISSUE->name(), static_cast<int>(3 + 4 + 1 + Actions.size()))) {
+void SourceLocation::put(MLINK mlp) const {
+    if (!MLPutInteger(mlp, static_cast<int>(first))) {
         assert(false);
     }
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Tag.c_str()), static_cast<int>(Tag.size()))) {
+    if (!MLPutInteger(mlp, static_cast<int>(second))) {
         assert(false);
     }
+}
+
+void SourceLocation::putStructured(MLINK mlp) const {
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Msg.c_str()), static_cast<int>(Msg.size()))) {
+    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(2))) {
         assert(false);
     }
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Sev.c_str()), static_cast<int>(Sev.size()))) {
+    if (!MLPutInteger(mlp, static_cast<int>(first))) {
         assert(false);
     }
     
-    Src.put(mlp);
-    
-    if (!MLPutReal(mlp, Val)) {
+    if (!MLPutInteger(mlp, static_cast<int>(second))) {
         assert(false);
     }
+}
+
+void Source::put(MLINK mlp) const {
     
-    for (auto& A : Actions) {
-        A->put(mlp);
-    }
+    Start.put(mlp);
+    End.put(mlp);
 }
 
-void EncodingIssue::put(MLINK mlp) const {
+void Source::putStructured(MLINK mlp) const {
     
-    if (!MLPutFunction(mlp, SYMBOL_CODEPARSER_LIBRARY_MAKEENCODINGISSUE->name(), static_cast<int>(3 + 4 + 1 + Actions.size()))) {
+    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(2))) {
         assert(false);
     }
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Tag.c_str()), static_cast<int>(Tag.size()))) {
-        assert(false);
-    }
+    Start.putStructured(mlp);
+    End.putStructured(mlp);
+}
+
+#endif // USE_MATHLINK
+
+#if USE_EXPR_LIB
+void Issue::toExpr(ExprBuilder& B) const {
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Msg.c_str()), static_cast<int>(Msg.size()))) {
-        assert(false);
-    }
+    auto Actions = getActions();
     
-    if (!MLPutUTF8String(mlp, reinterpret_cast<Buffer>(Sev.c_str()), static_cast<int>(Sev.size()))) {
-        assert(false);
-    }
+    B.function(IssueKindSymbolName(Kind), 3 + 4 + 1 + Actions.size());
     
-    Src.put(mlp);
+    auto TagStr = IssueTagToString(Tag);
     
-    if (!MLPutReal(mlp, Val)) {
-        assert(false);
-    }
+    B.string(reinterpret_cast<Buffer>(TagStr), strlen(TagStr));
+    
+    auto MsgStr = getMessage();
+    
+    B.string(reinterpret_cast<Buffer>(MsgStr.c_str()), MsgStr.size());
+    
+    auto SevStr = IssueSeverityToString(Sev);
+    
+    B.string(reinterpret_cast<Buffer>(SevStr), strlen(SevStr));
+    
+    Src.toExpr(B);
+    
+    B.real(Val);
     
     for (auto& A : Actions) {
-        A->put(mlp);
+        A->toExpr(B);
     }
 }
 
-void SourceLocation::put(MLINK mlp) const {
-    if (!MLPutInteger(mlp, static_cast<int>(first))) {
-        assert(false);
-    }
+void ReplaceTextCodeAction::toExpr(ExprBuilder& B) const {
     
-    if (!MLPutInteger(mlp, static_cast<int>(second))) {
-        assert(false);
-    }
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEREPLACETEXTCODEACTION->name(), 1 + 4 + 1);
+    
+    B.string(reinterpret_cast<Buffer>(Label.c_str()), Label.size());
+    
+    Src.toExpr(B);
+    
+    B.string(reinterpret_cast<Buffer>(ReplacementText.c_str()), ReplacementText.size());
 }
 
-void SourceLocation::putStructured(MLINK mlp) const {
+void InsertTextCodeAction::toExpr(ExprBuilder& B) const {
     
-    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(2))) {
-        assert(false);
-    }
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEINSERTTEXTCODEACTION->name(), 1 + 4 + 1);
     
-    if (!MLPutInteger(mlp, static_cast<int>(first))) {
-        assert(false);
-    }
+    B.string(reinterpret_cast<Buffer>(Label.c_str()), Label.size());
     
-    if (!MLPutInteger(mlp, static_cast<int>(second))) {
-        assert(false);
-    }
+    Src.toExpr(B);
+    
+    B.string(reinterpret_cast<Buffer>(InsertionText.c_str()), InsertionText.size());
 }
 
-void Source::put(MLINK mlp) const {
+void InsertTextAfterCodeAction::toExpr(ExprBuilder& B) const {
     
-    Start.put(mlp);
-    End.put(mlp);
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEINSERTTEXTAFTERCODEACTION->name(), 1 + 4 + 1);
+    
+    B.string(reinterpret_cast<Buffer>(Label.c_str()), Label.size());
+    
+    Src.toExpr(B);
+    
+    B.string(reinterpret_cast<Buffer>(InsertionText.c_str()), InsertionText.size());
 }
 
-void Source::putStructured(MLINK mlp) const {
+void DeleteTextCodeAction::toExpr(ExprBuilder& B) const {
     
-    if (!MLPutFunction(mlp, SYMBOL_LIST->name(), static_cast<int>(2))) {
-        assert(false);
-    }
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEDELETETEXTCODEACTION->name(), 1 + 4);
     
-    Start.putStructured(mlp);
-    End.putStructured(mlp);
+    B.string(reinterpret_cast<Buffer>(Label.c_str()), Label.size());
+    
+    Src.toExpr(B);
 }
 
-#endif // USE_MATHLINK
+void DeleteTriviaCodeAction::toExpr(ExprBuilder& B) const {
+    
+    B.function(SYMBOL_CODEPARSER_LIBRARY_MAKEDELETETRIVIACODEACTION->name(), 1 + 4);
+    
+    B.string(reinterpret_cast<Buffer>(Label.c_str()), Label.size());
+    
+    Src.toExpr(B);
+}
+
+void SourceLocation::toExpr(ExprBuilder& B) const {
+    
+    B.integer(static_cast<int>(first));
+    B.integer(static_cast<int>(second));
+}
+
+void SourceLocation::toExprStructured(ExprBuilder& B) const {
+    
+    B.function(SYMBOL_LIST->name(), 2);
+    
+    B.integer(static_cast<int>(first));
+    B.integer(static_cast<int>(second));
+}
+
+void Source::toExpr(ExprBuilder& B) const {
+    
+    Start.toExpr(B);
+    End.toExpr(B);
+}
+
+void Source::toExprStructured(ExprBuilder& B) const {
+    
+    B.function(SYMBOL_LIST->name(), 2);
+    
+    Start.toExprStructured(B);
+    End.toExprStructured(B);
+}
+#endif // USE_EXPR_LIB
 
@@ -1,7 +1,8 @@
 
 #include "Token.h"
 
-#include "API.h" // for TheParserSession
+#include "Symbol.h" // for TokenToSymbol
+#include "API.h" // for ParserSession
 
 #include <cassert>
 
@@ -113,27 +114,11 @@ bool operator!=(Token a, Token b) {
     return a.Tok != b.Tok || a.BufLen != b.BufLen || a.Src != b.Src;
 }
 
-void Token::print(std::ostream& s) const {
+void Token::print(ParserSession *session, std::ostream& s) const {
     
-    if ((TheParserSession->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
-        
-        auto& Sym = TokenToSymbol(Tok);
-        
-        s << SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name() << "[";
-        
-        s << Sym->name();
-        s << ", ";
-        
-        if (!Tok.isEmpty()) {
-            
-            BufLen.printUTF8String(s);
-        }
-        
-        s << ", ";
+    if ((session->policy & INCLUDE_SOURCE) == INCLUDE_SOURCE) {
         
-        Src.print(s);
-        
-        s << "]";
+        print(s);
         
         return;
     }
@@ -153,6 +138,27 @@ void Token::print(std::ostream& s) const {
     s << "]";
 }
 
+void Token::print(std::ostream& s) const {
+    
+    auto& Sym = TokenToSymbol(Tok);
+    
+    s << SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name() << "[";
+    
+    s << Sym->name();
+    s << ", ";
+    
+    if (!Tok.isEmpty()) {
+        
+        BufLen.printUTF8String(s);
+    }
+    
+    s << ", ";
+    
+    Src.print(s);
+    
+    s << "]";
+}
+
 //
 // For googletest
 //
@@ -0,0 +1,50 @@
+
+#include "TokenArrays.h"
+
+void TokenArrays::clear() {
+    
+    Toks.clear();
+    Starts.clear();
+    Ends.clear();
+    Srcs.clear();
+}
+
+void TokenArrays::reserve(size_t n) {
+    
+    Toks.reserve(n);
+    Starts.reserve(n);
+    Ends.reserve(n);
+    Srcs.reserve(n);
+}
+
+size_t TokenArrays::size() const {
+    return Toks.size();
+}
+
+static void writeArray(std::ostream& s, const void *data, size_t size) {
+    
+    s.write(static_cast<const char *>(data), size);
+    
+    //
+    // Pad to a multiple of 8
+    //
+    static const char zeros[8] = {};
+    
+    s.write(zeros, (8 - size % 8) % 8);
+}
+
+void TokenArrays::write(std::ostream& s, SourceConvention srcConvention) const {
+    
+    TokenArraysHeader H;
+    
+    H.magic = TOKENARRAYS_MAGIC;
+    H.version = TOKENARRAYS_VERSION;
+    H.srcConvention = static_cast<uint32_t>(srcConvention);
+    H.count = static_cast<uint32_t>(size());
+    
+    writeArray(s, &H, sizeof(H));
+    writeArray(s, Toks.data(), Toks.size() * sizeof(uint16_t));
+    writeArray(s, Starts.data(), Starts.size() * sizeof(uint32_t));
+    writeArray(s, Ends.data(), Ends.size() * sizeof(uint32_t));
+    writeArray(s, Srcs.data(), Srcs.size() * sizeof(Source));
+}
@@ -1,19 +1,33 @@
 
 #include "Tokenizer.h"
 
-#include "CharacterDecoder.h" // for TheCharacterDecoder
-#include "ByteDecoder.h" // for TheByteDecoder
-#include "ByteBuffer.h" // for TheByteBuffer
+#include "CharacterDecoder.h" // for CharacterDecoder
+#include "ByteDecoder.h" // for ByteDecoder
+#include "ByteBuffer.h" // for ByteBuffer
+#include "API.h" // for ParserSession
 #include "Utils.h" // for strangeLetterlikeWarning
+#include "LongNames.h" // for MBCLASS_PUNCTUATION, etc.
 
+#include <cstring> // for memcmp, memchr, strlen
+#include <algorithm> // for min, max
 
-Tokenizer::Tokenizer() : Issues(), EmbeddedNewlines(), EmbeddedTabs() {}
+
+Tokenizer::Tokenizer(ParserSession *session) : session(session), Issues(), EmbeddedNewlines(), EmbeddedTabs(), PeekCache(), PeekCacheNext(), LexCount(), PeekHitCount(), TokenCount(), RecoverStart(), RecoverEnd(), RecoverEndLoc(), RecoverScanCount() {}
 
 void Tokenizer::init() {
     
     Issues.clear();
     EmbeddedNewlines.clear();
     EmbeddedTabs.clear();
+    
+    clearPeekCache();
+    
+    LexCount = 0;
+    PeekHitCount = 0;
+    TokenCount = 0;
+    
+    RecoverStart = nullptr;
+    RecoverScanCount = 0;
 }
 
 void Tokenizer::deinit() {
@@ -21,6 +35,20 @@ void Tokenizer::deinit() {
     Issues.clear();
     EmbeddedNewlines.clear();
     EmbeddedTabs.clear();
+    
+    clearPeekCache();
+}
+
+void Tokenizer::clearPeekCache() {
+    
+    //
+    // A new buffer may be at the same address as the old one, so forget everything
+    //
+    for (auto& E : PeekCache) {
+        E.Buf = nullptr;
+    }
+    
+    PeekCacheNext = 0;
 }
 
 // Precondition: buffer is pointing to current token
@@ -39,10 +67,12 @@ void Tokenizer::deinit() {
 //
 Token Tokenizer::nextToken0(NextPolicy policy) {
     
-    auto tokenStartBuf = TheByteBuffer->buffer;
-    auto tokenStartLoc = TheByteDecoder->SrcLoc;
+    LexCount++;
     
-    auto c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+    auto tokenStartBuf = session->byteBuffer->buffer;
+    auto tokenStartLoc = session->byteDecoder->SrcLoc;
+    
+    auto c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
     
     switch (c.to_point()) {
         
@@ -157,42 +187,48 @@ Token Tokenizer::nextToken0(NextPolicy policy) {
                 
                 return handleMBLinearSyntaxBlob(tokenStartBuf, tokenStartLoc, c, policy);
                 
-            } else if (c.isMBLinearSyntax()) {
+            }
+            
+            //
+            // A single table lookup for the rest, then test the bits in the same order as the WLCharacter::isMB functions
+            //
+            auto cls = c.mbClass();
+            
+            if (cls & MBCLASS_LINEARSYNTAX) {
                 
                 return handleNakedMBLinearSyntax(tokenStartBuf, tokenStartLoc, c, policy);
                 
-            } else if (c.isMBUninterpretable()) {
+            } else if (cls & MBCLASS_UNINTERPRETABLE) {
                 
                 return Token(TOKEN_ERROR_UNHANDLEDCHARACTER, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 
-            } else if (c.isMBStrangeWhitespace()) {
+            } else if (cls & MBCLASS_WHITESPACE) {
                 
+                //
+                // All multi-byte whitespace is strange
+                //
                 return handleMBStrangeWhitespace(tokenStartBuf, tokenStartLoc, c, policy);
                 
-            } else if (c.isMBWhitespace()) {
-                
-                return Token(TOKEN_WHITESPACE, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
-                
-            } else if (c.isMBStrangeNewline()) {
+            } else if (cls & MBCLASS_NEWLINE) {
                 
-                return handleMBStrangeNewline(tokenStartBuf, tokenStartLoc, c, policy);
-                
-            } else if (c.isMBNewline()) {
+                if (c.to_point() != CODEPOINT_CRLF) {
+                    return handleMBStrangeNewline(tokenStartBuf, tokenStartLoc, c, policy);
+                }
                 
                 //
                 // Return INTERNALNEWLINE or TOPLEVELNEWLINE, depending on policy
                 //
                 return Token(TOKEN_INTERNALNEWLINE.t() | (policy & RETURN_TOPLEVELNEWLINE), getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 
-            } else if (c.isMBPunctuation()) {
+            } else if (cls & MBCLASS_PUNCTUATION) {
                 
                 return handleMBPunctuation(tokenStartBuf, tokenStartLoc, c, policy);
                 
-            } else if (c.isMBStringMeta()) {
+            } else if (cls & MBCLASS_STRINGMETA) {
                 
                 return Token(TOKEN_ERROR_UNHANDLEDCHARACTER, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 
-            } else if (c.isMBUnsupported()) {
+            } else if ((cls & MBCLASS_UNSUPPORTED) && c.escape() == ESCAPE_LONGNAME) {
                 
                 return Token(TOKEN_ERROR_UNSUPPORTEDCHARACTER, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 
@@ -202,7 +238,7 @@ Token Tokenizer::nextToken0(NextPolicy policy) {
                 // if nothing else, then it is letterlike
                 //
                 
-                assert(c.isMBLetterlike());
+                assert(c.isMBLetterlike(cls));
                 
                 return handleSymbol(tokenStartBuf, tokenStartLoc, c, policy);
             }
@@ -213,12 +249,12 @@ Token Tokenizer::nextToken0(NextPolicy policy) {
 
 Token Tokenizer::nextToken0_stringifyAsSymbolSegment() {
     
-    auto tokenStartBuf = TheByteBuffer->buffer;
-    auto tokenStartLoc = TheByteDecoder->SrcLoc;
+    auto tokenStartBuf = session->byteBuffer->buffer;
+    auto tokenStartLoc = session->byteDecoder->SrcLoc;
     
     auto policy = INSIDE_STRINGIFY_AS_SYMBOLSEGMENT;
     
-    auto c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+    auto c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
     
     switch (c.to_point()) {
         case CODEPOINT_ENDOFFILE:
@@ -243,12 +279,12 @@ Token Tokenizer::nextToken0_stringifyAsSymbolSegment() {
 //
 Token Tokenizer::nextToken0_stringifyAsFile() {
     
-    auto tokenStartBuf = TheByteBuffer->buffer;
-    auto tokenStartLoc = TheByteDecoder->SrcLoc;
+    auto tokenStartBuf = session->byteBuffer->buffer;
+    auto tokenStartLoc = session->byteDecoder->SrcLoc;
     
     auto policy = INSIDE_STRINGIFY_AS_FILE;
     
-    auto c = TheByteDecoder->nextSourceCharacter0(policy);
+    auto c = session->byteDecoder->nextSourceCharacter0(policy);
     
     switch (c.to_point()) {
         case CODEPOINT_ENDOFFILE:
@@ -286,28 +322,53 @@ Token Tokenizer::nextToken0_stringifyAsFile() {
 
 void Tokenizer::nextToken(Token Tok) {
     
-    TheByteBuffer->buffer = Tok.BufLen.end;
-    TheByteBuffer->wasEOF = (Tok.Tok == TOKEN_ENDOFFILE);
+    session->byteBuffer->buffer = Tok.BufLen.end;
+    session->byteBuffer->wasEOF = (Tok.Tok == TOKEN_ENDOFFILE);
     
-    TheByteDecoder->SrcLoc = Tok.Src.End;
+    session->byteDecoder->SrcLoc = Tok.Src.End;
     
-    TheByteDecoder->clearStatus();
+    session->byteDecoder->clearStatus();
+    
+    TokenCount++;
 }
 
 
 Token Tokenizer::currentToken(NextPolicy policy) {
     
-    auto resetBuf = TheByteBuffer->buffer;
-    auto resetEOF = TheByteBuffer->wasEOF;
-    auto resetLoc = TheByteDecoder->SrcLoc;
+    auto resetBuf = session->byteBuffer->buffer;
+    auto resetEOF = session->byteBuffer->wasEOF;
+    auto resetLoc = session->byteDecoder->SrcLoc;
+    
+    //
+    // Cleared entries have a null Buf, and so may an empty input, which must not match them
+    //
+    if (resetBuf) {
+        for (auto& E : PeekCache) {
+            if (E.Buf == resetBuf && E.WasEOF == resetEOF && E.Policy == policy) {
+                
+                PeekHitCount++;
+                
+                return E.Tok;
+            }
+        }
+    }
     
     auto Tok = nextToken0(policy);
     
-    TheByteBuffer->buffer = resetBuf;
-    TheByteBuffer->wasEOF = resetEOF;
-    TheByteDecoder->SrcLoc = resetLoc;
+    session->byteBuffer->buffer = resetBuf;
+    session->byteBuffer->wasEOF = resetEOF;
+    session->byteDecoder->SrcLoc = resetLoc;
+    
+    session->byteDecoder->clearStatus();
+    
+    auto& E = PeekCache[PeekCacheNext];
+    
+    E.Buf = resetBuf;
+    E.WasEOF = resetEOF;
+    E.Policy = policy;
+    E.Tok = Tok;
     
-    TheByteDecoder->clearStatus();
+    PeekCacheNext = (PeekCacheNext + 1) % PEEK_CACHE_SIZE;
     
     return Tok;
 }
@@ -315,34 +376,34 @@ Token Tokenizer::currentToken(NextPolicy policy) {
 
 Token Tokenizer::currentToken_stringifyAsSymbolSegment() {
     
-    auto resetBuf = TheByteBuffer->buffer;
-    auto resetEOF = TheByteBuffer->wasEOF;
-    auto resetLoc = TheByteDecoder->SrcLoc;
+    auto resetBuf = session->byteBuffer->buffer;
+    auto resetEOF = session->byteBuffer->wasEOF;
+    auto resetLoc = session->byteDecoder->SrcLoc;
     
     auto Tok = nextToken0_stringifyAsSymbolSegment();
     
-    TheByteBuffer->buffer = resetBuf;
-    TheByteBuffer->wasEOF = resetEOF;
-    TheByteDecoder->SrcLoc = resetLoc;
+    session->byteBuffer->buffer = resetBuf;
+    session->byteBuffer->wasEOF = resetEOF;
+    session->byteDecoder->SrcLoc = resetLoc;
     
-    TheByteDecoder->clearStatus();
+    session->byteDecoder->clearStatus();
     
     return Tok;
 }
 
 Token Tokenizer::currentToken_stringifyAsFile() {
     
-    auto resetBuf = TheByteBuffer->buffer;
-    auto resetEOF = TheByteBuffer->wasEOF;
-    auto resetLoc = TheByteDecoder->SrcLoc;
+    auto resetBuf = session->byteBuffer->buffer;
+    auto resetEOF = session->byteBuffer->wasEOF;
+    auto resetLoc = session->byteDecoder->SrcLoc;
     
     auto Tok = nextToken0_stringifyAsFile();
     
-    TheByteBuffer->buffer = resetBuf;
-    TheByteBuffer->wasEOF = resetEOF;
-    TheByteDecoder->SrcLoc = resetLoc;
+    session->byteBuffer->buffer = resetBuf;
+    session->byteBuffer->wasEOF = resetEOF;
+    session->byteDecoder->SrcLoc = resetLoc;
     
-    TheByteDecoder->clearStatus();
+    session->byteDecoder->clearStatus();
     
     return Tok;
 }
@@ -353,9 +414,9 @@ inline Token Tokenizer::handleStrangeWhitespace(Buffer tokenStartBuf, SourceLoca
     
 #if !NISSUES
     {
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER, "Unexpected space character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(tokenStartLoc), 0.95, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER, ISSUEMESSAGE_UNEXPECTEDSPACECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(tokenStartLoc), 0.95, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
@@ -380,7 +441,7 @@ inline Token Tokenizer::handleComment(Buffer tokenStartBuf, SourceLocation token
     
     auto depth = 1;
     
-    c = TheByteDecoder->currentSourceCharacter(policy);
+    c = session->byteDecoder->currentSourceCharacter(policy);
     
     while (true) {
         
@@ -395,27 +456,27 @@ inline Token Tokenizer::handleComment(Buffer tokenStartBuf, SourceLocation token
         switch (c.to_point()) {
             case '(':
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                c = TheByteDecoder->currentSourceCharacter(policy);
+                c = session->byteDecoder->currentSourceCharacter(policy);
                 
                 if (c.to_point() == '*') {
                     
                     depth = depth + 1;
                     
-                    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                     
-                    c = TheByteDecoder->currentSourceCharacter(policy);
+                    c = session->byteDecoder->currentSourceCharacter(policy);
                 }
                 
                 break;
             case '*':
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                c = TheByteDecoder->currentSourceCharacter(policy);
+                c = session->byteDecoder->currentSourceCharacter(policy);
                 
                 if (c.to_point() == ')') {
                     
@@ -425,48 +486,57 @@ inline Token Tokenizer::handleComment(Buffer tokenStartBuf, SourceLocation token
                     
                     if (depth == 0) {
                         
-                        TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                        TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                        session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                        session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                         
                         return Token(TOKEN_COMMENT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                     }
                     
-                    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                     
-                    c = TheByteDecoder->currentSourceCharacter(policy);
+                    c = session->byteDecoder->currentSourceCharacter(policy);
                 }
                 break;
             case CODEPOINT_ENDOFFILE:
                 return Token(TOKEN_ERROR_UNTERMINATEDCOMMENT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
             case '\n': case '\r': case CODEPOINT_CRLF:
                 
-                EmbeddedNewlines.insert(tokenStartLoc);
+                if ((session->policy & SKIP_EMBEDDED_NEWLINES_AND_TABS) != SKIP_EMBEDDED_NEWLINES_AND_TABS) {
+                    EmbeddedNewlines.push_back(tokenStartLoc);
+                }
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                c = TheByteDecoder->currentSourceCharacter(policy);
+                c = session->byteDecoder->currentSourceCharacter(policy);
                 
                 break;
             
             case '\t':
                 
-                EmbeddedTabs.insert(tokenStartLoc);
+                if ((session->policy & SKIP_EMBEDDED_NEWLINES_AND_TABS) != SKIP_EMBEDDED_NEWLINES_AND_TABS) {
+                    EmbeddedTabs.push_back(tokenStartLoc);
+                }
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                c = TheByteDecoder->currentSourceCharacter(policy);
+                c = session->byteDecoder->currentSourceCharacter(policy);
                 
                 break;
                 
             default:
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                c = TheByteDecoder->currentSourceCharacter(policy);
+                //
+                // Nothing to do for the rest of a run of ordinary comment text
+                //
+                session->byteDecoder->skipPlainASCII('(', '*');
+                
+                c = session->byteDecoder->currentSourceCharacter(policy);
                 
                 break;
         }
@@ -480,7 +550,7 @@ inline Token Tokenizer::handleMBLinearSyntaxBlob(Buffer tokenStartBuf, SourceLoc
     
     auto depth = 1;
     
-    auto c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    auto c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     while (true) {
         
@@ -493,10 +563,10 @@ inline Token Tokenizer::handleMBLinearSyntaxBlob(Buffer tokenStartBuf, SourceLoc
                 
                 depth = depth + 1;
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 break;
             case CODEPOINT_LINEARSYNTAX_CLOSEPAREN:
@@ -505,16 +575,16 @@ inline Token Tokenizer::handleMBLinearSyntaxBlob(Buffer tokenStartBuf, SourceLoc
                 
                 if (depth == 0) {
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                     
                     return Token(TOKEN_LINEARSYNTAXBLOB, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 }
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 break;
             case CODEPOINT_ENDOFFILE:
@@ -522,10 +592,10 @@ inline Token Tokenizer::handleMBLinearSyntaxBlob(Buffer tokenStartBuf, SourceLoc
                 
             default:
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 break;
         }
@@ -570,21 +640,21 @@ inline Token Tokenizer::handleSymbol(Buffer tokenStartBuf, SourceLocation tokenS
             // It's hard to keep track of the ` characters, so just report the entire symbol. Oh well
             //
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, "The name following ``#`` is not documented to allow the **`** character.", SYNTAXISSUESEVERITY_REMARK, getTokenSource(tokenStartLoc), 0.33, {}));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, ISSUEMESSAGE_UNDOCUMENTEDSLOTBACKTICK, SYNTAXISSUESEVERITY_REMARK, getTokenSource(tokenStartLoc), 0.33);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
         }
 #endif // !NISSUES
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         if (c.isLetterlike() || c.isMBLetterlike()) {
             
-            auto letterlikeBuf = TheByteBuffer->buffer;
-            auto letterlikeLoc = TheByteDecoder->SrcLoc;
+            auto letterlikeBuf = session->byteBuffer->buffer;
+            auto letterlikeLoc = session->byteDecoder->SrcLoc;
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
             c = handleSymbolSegment(tokenStartBuf, tokenStartLoc, letterlikeBuf, letterlikeLoc, c, policy);
             
@@ -620,45 +690,27 @@ inline WLCharacter Tokenizer::handleSymbolSegment(Buffer tokenStartBuf, SourceLo
             // Something like  #$a
             //
             
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, "The name following ``#`` is not documented to allow the ``$`` character.", SYNTAXISSUESEVERITY_REMARK, getTokenSource(charLoc), 0.33, {}));
+            auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, ISSUEMESSAGE_UNDOCUMENTEDSLOTDOLLAR, SYNTAXISSUESEVERITY_REMARK, getTokenSource(charLoc), 0.33);
             
-            Issues.insert(std::move(I));
+            addIssue(std::move(I));
         }
     } else if (c.isStrangeLetterlike()) {
         
-        if (c.escape() == ESCAPE_NONE) {
-            
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.85, {}));
-            
-            TheTokenizer->addIssue(std::move(I));
-            
-        } else {
-            
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``" + c.graphicalString() + "``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.85, {}));
-            
-            TheTokenizer->addIssue(std::move(I));
-        }
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, ISSUEMESSAGE_UNEXPECTEDLETTERLIKECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.85, ISSUEACTION_NONE, c);
+        
+        addIssue(std::move(I));
         
     } else if (c.isMBStrangeLetterlike()) {
         
-        if (c.escape() == ESCAPE_NONE) {
-            
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.80, {}));
-            
-            TheTokenizer->addIssue(std::move(I));
-            
-        } else {
-            
-            auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``" + c.graphicalString() + "``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.80, {}));
-            
-            TheTokenizer->addIssue(std::move(I));
-        }
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, ISSUEMESSAGE_UNEXPECTEDLETTERLIKECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.80, ISSUEACTION_NONE, c);
+        
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
-    charLoc = TheByteDecoder->SrcLoc;
+    charLoc = session->byteDecoder->SrcLoc;
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     while (true) {
         
@@ -668,17 +720,17 @@ inline WLCharacter Tokenizer::handleSymbolSegment(Buffer tokenStartBuf, SourceLo
         
         if (c.isDigit()) {
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            charLoc = TheByteDecoder->SrcLoc;
+            charLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
         } else if (c.isLetterlike() || c.isMBLetterlike()) {
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
 #if !NISSUES
             if (c.to_point() == '$') {
@@ -689,46 +741,28 @@ inline WLCharacter Tokenizer::handleSymbolSegment(Buffer tokenStartBuf, SourceLo
                     // Something like  #$a
                     //
                     
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, "The name following ``#`` is not documented to allow the ``$`` character.", SYNTAXISSUESEVERITY_REMARK, getTokenSource(charLoc), 0.33, {}));
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, ISSUEMESSAGE_UNDOCUMENTEDSLOTDOLLAR, SYNTAXISSUESEVERITY_REMARK, getTokenSource(charLoc), 0.33);
                     
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                 }
                 
             } else if (c.isStrangeLetterlike()) {
                 
-                if (c.escape() == ESCAPE_NONE) {
-                    
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.85, {}));
-                    
-                    TheTokenizer->addIssue(std::move(I));
-                    
-                } else {
-                    
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``" + c.graphicalString() + "``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.85, {}));
-                    
-                    TheTokenizer->addIssue(std::move(I));
-                }
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, ISSUEMESSAGE_UNEXPECTEDLETTERLIKECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.85, ISSUEACTION_NONE, c);
+                
+                addIssue(std::move(I));
                 
             } else if (c.isMBStrangeLetterlike()) {
                 
-                if (c.escape() == ESCAPE_NONE) {
-                    
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.80, {}));
-                    
-                    TheTokenizer->addIssue(std::move(I));
-                    
-                } else {
-                    
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, "Unexpected letterlike character: ``" + c.graphicalString() + "``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.80, {}));
-                    
-                    TheTokenizer->addIssue(std::move(I));
-                }
+                auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDLETTERLIKECHARACTER, ISSUEMESSAGE_UNEXPECTEDLETTERLIKECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(charLoc), 0.80, ISSUEACTION_NONE, c);
+                
+                addIssue(std::move(I));
             }
 #endif // !NISSUES
             
-            charLoc = TheByteDecoder->SrcLoc;
+            charLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
         } else if (c.to_point() == '`') {
             
@@ -736,8 +770,8 @@ inline WLCharacter Tokenizer::handleSymbolSegment(Buffer tokenStartBuf, SourceLo
             // Advance past trailing `
             //
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
             break;
             
@@ -762,9 +796,9 @@ inline Token Tokenizer::handleString(Buffer tokenStartBuf, SourceLocation tokenS
         // Something like  #"a"
         //
         
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, "The name following ``#`` is not documented to allow the ``\"`` character.", SYNTAXISSUESEVERITY_REMARK, getTokenSource(tokenStartLoc), 0.33, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNDOCUMENTEDSLOTSYNTAX, ISSUEMESSAGE_UNDOCUMENTEDSLOTDOUBLEQUOTE, SYNTAXISSUESEVERITY_REMARK, getTokenSource(tokenStartLoc), 0.33);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
@@ -776,7 +810,12 @@ inline Token Tokenizer::handleString(Buffer tokenStartBuf, SourceLocation tokenS
         // No need to check isAbort() inside tokenizer loops
         //
         
-        c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+        //
+        // Nothing to do for a run of ordinary string characters
+        //
+        session->byteDecoder->skipPlainASCII('"', '\\');
+        
+        c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
         
         switch (c.to_point()) {
             case '"':
@@ -785,12 +824,16 @@ inline Token Tokenizer::handleString(Buffer tokenStartBuf, SourceLocation tokenS
                 return Token(TOKEN_ERROR_UNTERMINATEDSTRING, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
             case '\n': case '\r': case CODEPOINT_CRLF:
                 
-                EmbeddedNewlines.insert(tokenStartLoc);
+                if ((session->policy & SKIP_EMBEDDED_NEWLINES_AND_TABS) != SKIP_EMBEDDED_NEWLINES_AND_TABS) {
+                    EmbeddedNewlines.push_back(tokenStartLoc);
+                }
                 
                 break;
             case '\t':
                 
-                EmbeddedTabs.insert(tokenStartLoc);
+                if ((session->policy & SKIP_EMBEDDED_NEWLINES_AND_TABS) != SKIP_EMBEDDED_NEWLINES_AND_TABS) {
+                    EmbeddedTabs.push_back(tokenStartLoc);
+                }
                 
                 break;
         }
@@ -816,8 +859,8 @@ inline Token Tokenizer::handleString_stringifyAsSymbolSegment(Buffer tokenStartB
     
     if (c.isLetterlike() || c.isMBLetterlike()) {
         
-        auto letterlikeBuf = TheByteBuffer->buffer;
-        auto letterlikeLoc = TheByteDecoder->SrcLoc;
+        auto letterlikeBuf = session->byteBuffer->buffer;
+        auto letterlikeLoc = session->byteDecoder->SrcLoc;
         
         handleSymbolSegment(tokenStartBuf, tokenStartLoc, letterlikeBuf, letterlikeLoc, c, policy);
         
@@ -860,7 +903,7 @@ inline Token Tokenizer::handleString_stringifyAsFile(Buffer tokenStartBuf, Sourc
         case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
         case '$': case '`': case '/': case '.': case '\\': case '!': case '-': case '_': case ':': case '*': case '~': case '?': {
             
-            c = TheByteDecoder->currentSourceCharacter(policy);
+            c = session->byteDecoder->currentSourceCharacter(policy);
         }
             break;
         case '[': {
@@ -921,18 +964,18 @@ inline Token Tokenizer::handleString_stringifyAsFile(Buffer tokenStartBuf, Sourc
             case '0': case '1': case '2': case '3': case '4': case '5': case '6': case '7': case '8': case '9':
             case '$': case '`': case '/': case '.': case '\\': case '!': case '-': case '_': case ':': case '*': case '~': case '?': {
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
-                c = TheByteDecoder->currentSourceCharacter(policy);
+                c = session->byteDecoder->currentSourceCharacter(policy);
             }
                 break;
             case '[': {
                 
                 // handle matched pairs of [] enclosing any characters other than spaces, tabs, and newlines
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
                 int handled;
                 c = handleFileOpsBrackets(tokenStartLoc, c, policy, &handled);
@@ -963,7 +1006,7 @@ inline SourceCharacter Tokenizer::handleFileOpsBrackets(SourceLocation tokenStar
     
     auto depth = 1;
     
-    c = TheByteDecoder->currentSourceCharacter(policy);
+    c = session->byteDecoder->currentSourceCharacter(policy);
     
     bool breakWhile = false;
     while (true) {
@@ -983,8 +1026,8 @@ inline SourceCharacter Tokenizer::handleFileOpsBrackets(SourceLocation tokenStar
             case ' ': case '\t': case '\v': case '\f':
             case '\n': case '\r': case CODEPOINT_CRLF:
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
                 //
                 // Cannot have spaces in the string here, so bail out
@@ -1000,16 +1043,16 @@ inline SourceCharacter Tokenizer::handleFileOpsBrackets(SourceLocation tokenStar
                 return c;
             case '[':
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
                 depth = depth + 1;
                 
                 break;
             case ']':
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
                 depth = depth - 1;
                 
@@ -1022,8 +1065,8 @@ inline SourceCharacter Tokenizer::handleFileOpsBrackets(SourceLocation tokenStar
                 
                 if (c.isMBWhitespace() || c.isMBNewline()) {
                     
-                    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                     
                     *handled = UNTERMINATED_FILESTRING;
                     
@@ -1031,13 +1074,13 @@ inline SourceCharacter Tokenizer::handleFileOpsBrackets(SourceLocation tokenStar
                     
                 }
                 
-                TheByteBuffer->buffer = TheByteDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheByteDecoder->lastLoc;
+                session->byteBuffer->buffer = session->byteDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->byteDecoder->lastLoc;
                 
                 break;
         }
         
-        c = TheByteDecoder->currentSourceCharacter(policy);
+        c = session->byteDecoder->currentSourceCharacter(policy);
         
     } // while
     
@@ -1120,8 +1163,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
             
             leadingDigitsCount += leadingZeroCount;
             
-            nonZeroStartBuf = TheByteBuffer->buffer;
-            nonZeroStartLoc = TheByteDecoder->SrcLoc;
+            nonZeroStartBuf = session->byteBuffer->buffer;
+            nonZeroStartLoc = session->byteDecoder->SrcLoc;
         }
         
         
@@ -1129,8 +1172,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
         // Count the rest of the leading digits
         //
         
-        leadingDigitsEndBuf = TheByteBuffer->buffer;
-        leadingDigitsEndLoc = TheByteDecoder->SrcLoc;
+        leadingDigitsEndBuf = session->byteBuffer->buffer;
+        leadingDigitsEndLoc = session->byteDecoder->SrcLoc;
         
         if (c.isDigit()) {
             
@@ -1139,8 +1182,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
             
             leadingDigitsCount += count;
             
-            leadingDigitsEndBuf = TheByteBuffer->buffer;
-            leadingDigitsEndLoc = TheByteDecoder->SrcLoc;
+            leadingDigitsEndBuf = session->byteBuffer->buffer;
+            leadingDigitsEndLoc = session->byteDecoder->SrcLoc;
         }
         
         if ((policy & INTEGER_SHORT_CIRCUIT) == INTEGER_SHORT_CIRCUIT) {
@@ -1152,14 +1195,11 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 // Something like  #2.a
                 //
                 
-                auto dotLoc = TheByteDecoder->SrcLoc;
-                
-                CodeActionPtrSet Actions;
-                Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(dotLoc), " ")));
+                auto dotLoc = session->byteDecoder->SrcLoc;
                 
-                auto I = IssuePtr(new FormatIssue(FORMATISSUETAG_INSERTSPACE, "Suspicious syntax.", FORMATISSUESEVERITY_FORMATTING, getTokenSource(dotLoc), std::move(Actions)));
+                auto I = Issue(ISSUEKIND_FORMAT, FORMATISSUETAG_INSERTSPACE, ISSUEMESSAGE_SUSPICIOUSSYNTAX, FORMATISSUESEVERITY_FORMATTING, getTokenSource(dotLoc), 0.0, ISSUEACTION_INSERTSPACE);
                 
-                Issues.insert(std::move(I));
+                addIssue(std::move(I));
             }
 #endif // !NISSUES
             
@@ -1178,15 +1218,15 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 
                 if (c.to_point() == '^') {
                     
-                    caret1Buf = TheByteBuffer->buffer;
-                    caret1Loc = TheByteDecoder->SrcLoc;
+                    caret1Buf = session->byteBuffer->buffer;
+                    caret1Loc = session->byteDecoder->SrcLoc;
                     
                     assert(Utils::ifASCIIWLCharacter(*caret1Buf, '^'));
                     
                 } else if (c.to_point() == '*') {
                     
-                    starBuf = TheByteBuffer->buffer;
-                    starLoc = TheByteDecoder->SrcLoc;
+                    starBuf = session->byteBuffer->buffer;
+                    starLoc = session->byteDecoder->SrcLoc;
                     
                     assert(Utils::ifASCIIWLCharacter(*starBuf, '*'));
                 }
@@ -1194,8 +1234,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 //
                 // Preserve c, but advance buffer to next character
                 //
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 break;
                 
             default:
@@ -1216,7 +1256,7 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
             // Could be 16^^blah
             //
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() != '^') {
                 
@@ -1226,8 +1266,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 // Must now do surgery and back up
                 //
                 
-                TheByteBuffer->buffer = caret1Buf;
-                TheByteDecoder->SrcLoc = caret1Loc;
+                session->byteBuffer->buffer = caret1Buf;
+                session->byteDecoder->SrcLoc = caret1Loc;
                 
                 //
                 // Success!
@@ -1244,8 +1284,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
             // Must be a number
             //
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
             if (nonZeroStartBuf == caret1Buf) {
                 
@@ -1286,7 +1326,7 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 }
             }
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             //
             // What can come after ^^ ?
@@ -1306,8 +1346,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                             break;
                     }
                     
-                    leadingDigitsEndBuf = TheByteBuffer->buffer;
-                    leadingDigitsEndLoc = TheByteDecoder->SrcLoc;
+                    leadingDigitsEndBuf = session->byteBuffer->buffer;
+                    leadingDigitsEndLoc = session->byteDecoder->SrcLoc;
                     
                     switch (c.to_point()) {
                             //
@@ -1317,8 +1357,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                             
                             if (c.to_point() == '*') {
                                 
-                                starBuf = TheByteBuffer->buffer;
-                                starLoc = TheByteDecoder->SrcLoc;
+                                starBuf = session->byteBuffer->buffer;
+                                starLoc = session->byteDecoder->SrcLoc;
                                 
                                 assert(Utils::ifASCIIWLCharacter(*starBuf, '*'));
                             }
@@ -1326,8 +1366,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                             //
                             // Preserve c, but advance buffer to next character
                             //
-                            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                             break;
                         default:
                             //
@@ -1348,14 +1388,14 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                     // Something like  2^^.0
                     //
                     
-                    leadingDigitsEndBuf = TheByteBuffer->buffer;
-                    leadingDigitsEndLoc = TheByteDecoder->SrcLoc;
+                    leadingDigitsEndBuf = session->byteBuffer->buffer;
+                    leadingDigitsEndLoc = session->byteDecoder->SrcLoc;
                     
                     //
                     // Preserve c, but advance buffer to next character
                     //
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 }
                     break;
                 case CODEPOINT_ENDOFFILE: {
@@ -1367,10 +1407,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                     // Make sure that bad character is read
                     //
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                     
-                    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                     
                     return Token(TOKEN_ERROR_EXPECTEDDIGIT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 }
@@ -1385,10 +1425,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                     // Make sure that bad character is read
                     //
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                     
-                    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                     
                     return Token(TOKEN_ERROR_UNRECOGNIZEDDIGIT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 }
@@ -1400,7 +1440,7 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
     
     if (c.to_point() == '.') {
         
-        assert(Utils::ifASCIIWLCharacter(*(TheByteBuffer->buffer - 1), '.'));
+        assert(Utils::ifASCIIWLCharacter(*(session->byteBuffer->buffer - 1), '.'));
         
         int handled;
         c = handlePossibleFractionalPart(tokenStartBuf, tokenStartLoc, leadingDigitsEndBuf, leadingDigitsEndLoc, c, Ctxt.Base, policy, &handled, &Ctxt);
@@ -1441,8 +1481,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                         
                         if (c.to_point() == '*') {
                             
-                            starBuf = TheByteBuffer->buffer;
-                            starLoc = TheByteDecoder->SrcLoc;
+                            starBuf = session->byteBuffer->buffer;
+                            starLoc = session->byteDecoder->SrcLoc;
                             
                             assert(Utils::ifASCIIWLCharacter(*starBuf, '*'));
                         }
@@ -1450,8 +1490,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                         //
                         // Preserve c, but advance buffer to next character
                         //
-                        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                         break;
                     default:
                         
@@ -1477,8 +1517,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                         
                         if (c.to_point() == '*') {
                             
-                            starBuf = TheByteBuffer->buffer;
-                            starLoc = TheByteDecoder->SrcLoc;
+                            starBuf = session->byteBuffer->buffer;
+                            starLoc = session->byteDecoder->SrcLoc;
                             
                             assert(Utils::ifASCIIWLCharacter(*starBuf, '*'));
                         }
@@ -1486,8 +1526,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                         //
                         // Preserve c, but advance buffer to next character
                         //
-                        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                         break;
                     default:
                         
@@ -1516,7 +1556,7 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
         
         Ctxt.Real = true;
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         bool accuracy = false;
         bool sign = false;
@@ -1527,10 +1567,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
         
         if (c.to_point() == '`') {
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             accuracy = true;
         }
@@ -1542,8 +1582,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 // Something like  1.2`-
                 //
                 
-                signBuf = TheByteBuffer->buffer;
-                signLoc = TheByteDecoder->SrcLoc;
+                signBuf = session->byteBuffer->buffer;
+                signLoc = session->byteDecoder->SrcLoc;
                 
                 assert(Utils::ifASCIIWLCharacter(*signBuf, '-')  || Utils::ifASCIIWLCharacter(*signBuf, '+'));
                 
@@ -1551,10 +1591,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                 // Eat the sign
                 //
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 switch (c.to_point()) {
                         //
@@ -1588,8 +1628,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                             // Something like  1.2``->3
                             //
                             
-                            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                             
                             return Token(TOKEN_ERROR_EXPECTEDACCURACY, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                         }
@@ -1644,8 +1684,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
         switch (c.to_point()) {
             case '.': {
                 
-                auto dotBuf = TheByteBuffer->buffer;
-                auto dotLoc = TheByteDecoder->SrcLoc;
+                auto dotBuf = session->byteBuffer->buffer;
+                auto dotLoc = session->byteDecoder->SrcLoc;
                 
                 assert(Utils::ifASCIIWLCharacter(*dotBuf, '.'));
                 
@@ -1673,10 +1713,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                     //
                     
                     // look ahead
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                     
-                    auto NextChar = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                    auto NextChar = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                     
                     if (!NextChar.isDigit()) {
                         
@@ -1686,8 +1726,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                             // Something like  123``.EOF
                             //
                             
-                            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                             
                             return Token(TOKEN_ERROR_EXPECTEDDIGIT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                         }
@@ -1698,8 +1738,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                             // Something like  123`.+4
                             //
                             
-                            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                             
                             return Token(TOKEN_ERROR_EXPECTEDDIGIT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                         }
@@ -1736,10 +1776,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                     // actual decimal point
                     //
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                     
-                    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 }
                 
                 //
@@ -1795,10 +1835,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                     // Something like  1`+.a
                     //
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                     
-                    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                     
                     return Token(TOKEN_ERROR_EXPECTEDDIGIT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                 }
@@ -1822,25 +1862,25 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                         // Something like  123.45``*^6
                         //
                         
-                        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                         
-                        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                         
                         return Token(TOKEN_ERROR_EXPECTEDACCURACY, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                     }
                 }
                 
-                starBuf = TheByteBuffer->buffer;
-                starLoc = TheByteDecoder->SrcLoc;
+                starBuf = session->byteBuffer->buffer;
+                starLoc = session->byteDecoder->SrcLoc;
                 
                 assert(Utils::ifASCIIWLCharacter(*starBuf, '*'));
                 
                 //
                 // Preserve c, but advance buffer to next character
                 //
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 break;
             default: {
                 
@@ -1852,10 +1892,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
                         // Something like  123``EOF
                         //
                         
-                        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                         
-                        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                         
                         return Token(TOKEN_ERROR_EXPECTEDACCURACY, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
                     }
@@ -1876,7 +1916,7 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
     
     assert(Utils::ifASCIIWLCharacter(*starBuf, '*'));
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     if (c.to_point() != '^') {
         
@@ -1886,8 +1926,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
         // Must now do surgery and back up
         //
         
-        TheByteBuffer->buffer = starBuf;
-        TheByteDecoder->SrcLoc = starLoc;
+        session->byteBuffer->buffer = starBuf;
+        session->byteDecoder->SrcLoc = starLoc;
         
         //
         // Success!
@@ -1904,10 +1944,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
     // So now examine *^ notation
     //
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     switch (c.to_point()) {
         case '-':
@@ -1916,10 +1956,10 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
             // FALL THROUGH
             //
         case '+': {
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         }
             break;
     }
@@ -1930,8 +1970,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
         // Something like  123*^-<EOF>
         //
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         
         return Token(TOKEN_ERROR_EXPECTEDEXPONENT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
     }
@@ -1963,15 +2003,15 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
     
     assert(c.to_point() == '.');
     
-    auto dotBuf = TheByteBuffer->buffer;
-    auto dotLoc = TheByteDecoder->SrcLoc;
+    auto dotBuf = session->byteBuffer->buffer;
+    auto dotLoc = session->byteDecoder->SrcLoc;
     
     assert(Utils::ifASCIIWLCharacter(*dotBuf, '.'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
 
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     int handled;
     c = handlePossibleFractionalPartPastDot(tokenStartBuf, tokenStartLoc, dotBuf, dotLoc, c, Ctxt.Base, policy, &handled, &Ctxt);
@@ -1999,8 +2039,8 @@ inline Token Tokenizer::handleNumber(Buffer tokenStartBuf, SourceLocation tokenS
             // Make this an error; do NOT make this Dot[123*^0, 5]
             //
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
             return Token(TOKEN_ERROR_EXPECTEDEXPONENT, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
         }
@@ -2047,7 +2087,7 @@ inline WLCharacter Tokenizer::handlePossibleFractionalPart(Buffer tokenStartBuf,
     
     assert(c.to_point() == '.');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     return handlePossibleFractionalPartPastDot(tokenStartBuf, tokenStartLoc, dotBuf, dotLoc, c, base, policy, handled, Ctxt);
 }
@@ -2071,7 +2111,7 @@ inline WLCharacter Tokenizer::handlePossibleFractionalPartPastDot(Buffer tokenSt
         
         backupAndWarn(dotBuf, dotLoc);
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         *handled = BAILOUT;
 
@@ -2096,12 +2136,9 @@ inline WLCharacter Tokenizer::handlePossibleFractionalPartPastDot(Buffer tokenSt
                     // Something like  1.2.3
                     //
                     
-                    CodeActionPtrSet Actions;
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert ``*``", Source(dotLoc), "*")));
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES, ISSUEMESSAGE_SUSPICIOUSSYNTAX, SYNTAXISSUESEVERITY_ERROR, Source(dotLoc), 0.99, ISSUEACTION_INSERTSTAR);
                     
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDIMPLICITTIMES, "Suspicious syntax.", SYNTAXISSUESEVERITY_ERROR, Source(dotLoc), 0.99, std::move(Actions)));
-                    
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                 }
 #endif // !NISSUES
                 
@@ -2118,17 +2155,14 @@ void Tokenizer::backupAndWarn(Buffer resetBuf, SourceLocation resetLoc) {
     
 #if !NISSUES
     {
-        CodeActionPtrSet Actions;
-        Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(resetLoc), " ")));
-        
-        auto I = IssuePtr(new FormatIssue(FORMATISSUETAG_INSERTSPACE, "Suspicious syntax.", FORMATISSUESEVERITY_FORMATTING, Source(resetLoc), std::move(Actions)));
+        auto I = Issue(ISSUEKIND_FORMAT, FORMATISSUETAG_INSERTSPACE, ISSUEMESSAGE_SUSPICIOUSSYNTAX, FORMATISSUESEVERITY_FORMATTING, Source(resetLoc), 0.0, ISSUEACTION_INSERTSPACE);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
-    TheByteBuffer->buffer = resetBuf;
-    TheByteDecoder->SrcLoc = resetLoc;
+    session->byteBuffer->buffer = resetBuf;
+    session->byteDecoder->SrcLoc = resetLoc;
 }
 
 
@@ -2138,7 +2172,7 @@ inline WLCharacter Tokenizer::handleZeros(Buffer tokenStartBuf, SourceLocation t
     
     auto count = 1;
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     while (true) {
         
@@ -2151,10 +2185,10 @@ inline WLCharacter Tokenizer::handleZeros(Buffer tokenStartBuf, SourceLocation t
             break;
         }
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         count++;
         
@@ -2172,7 +2206,7 @@ inline WLCharacter Tokenizer::handleDigits(Buffer tokenStartBuf, SourceLocation
     
     auto count = 1;
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     while (true) {
         
@@ -2185,10 +2219,10 @@ inline WLCharacter Tokenizer::handleDigits(Buffer tokenStartBuf, SourceLocation
             break;
         }
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         count++;
         
@@ -2232,10 +2266,10 @@ inline WLCharacter Tokenizer::handleAlphaOrDigits(Buffer tokenStartBuf, SourceLo
             
         }
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         count++;
         
@@ -2250,7 +2284,7 @@ inline Token Tokenizer::handleColon(Buffer tokenStartBuf, SourceLocation tokenSt
     
     assert(c.to_point() == ':');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_COLON; // :
     
@@ -2258,22 +2292,22 @@ inline Token Tokenizer::handleColon(Buffer tokenStartBuf, SourceLocation tokenSt
         case ':': {
             Operator = TOKEN_COLONCOLON; // ::
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '=': {
             Operator = TOKEN_COLONEQUAL; // :=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '>': {
             Operator = TOKEN_COLONGREATER; // :>
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -2289,7 +2323,7 @@ inline Token Tokenizer::handleOpenParen(Buffer tokenStartBuf, SourceLocation tok
     
     auto Operator = TOKEN_OPENPAREN; // (
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     //
     // Comments must start literally with (*
@@ -2298,8 +2332,8 @@ inline Token Tokenizer::handleOpenParen(Buffer tokenStartBuf, SourceLocation tok
     if ((ParenChar.to_point() == '(' && ParenChar.escape() == ESCAPE_NONE) &&
         (c.to_point() == '*' && c.escape() == ESCAPE_NONE)) {
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         
         return handleComment(tokenStartBuf, tokenStartLoc, SourceCharacter(c.to_point()), policy);
     }
@@ -2318,7 +2352,7 @@ inline Token Tokenizer::handleDot(Buffer tokenStartBuf, SourceLocation tokenStar
     
     assert(c.to_point() == '.');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     if (c.isDigit()) {
         
@@ -2331,17 +2365,17 @@ inline Token Tokenizer::handleDot(Buffer tokenStartBuf, SourceLocation tokenStar
         
         Operator = TOKEN_DOTDOT; // ..
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         if (c.to_point() == '.') {
             
             Operator = TOKEN_DOTDOTDOT; // ...
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
     }
     
@@ -2352,7 +2386,7 @@ inline Token Tokenizer::handleEqual(Buffer tokenStartBuf, SourceLocation tokenSt
     
     assert(c.to_point() == '=');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_EQUAL; // =
     
@@ -2361,36 +2395,36 @@ inline Token Tokenizer::handleEqual(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_EQUALEQUAL; // ==
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '=') {
                 
                 Operator = TOKEN_EQUALEQUALEQUAL; // ===
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             }
         }
             break;
         case '!': {
             
-            auto bangBuf = TheByteBuffer->buffer;
-            auto bangLoc = TheByteDecoder->SrcLoc;
+            auto bangBuf = session->byteBuffer->buffer;
+            auto bangLoc = session->byteDecoder->SrcLoc;
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '=') {
                 
                 Operator = TOKEN_EQUALBANGEQUAL; // =!=
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
             } else {
                 
@@ -2413,7 +2447,7 @@ inline Token Tokenizer::handleUnder(Buffer tokenStartBuf, SourceLocation tokenSt
     
     assert(c.to_point() == '_');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_UNDER; // _
     
@@ -2422,17 +2456,17 @@ inline Token Tokenizer::handleUnder(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_UNDERUNDER; // __
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '_') {
                 
                 Operator = TOKEN_UNDERUNDERUNDER; // ___
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             }
             break;
         }
@@ -2440,14 +2474,15 @@ inline Token Tokenizer::handleUnder(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_UNDERDOT; // _.
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
 #if !NISSUES
-            {
-                auto afterLoc = TheByteDecoder->SrcLoc;
+            if ((session->policy & SKIP_ISSUES) != SKIP_ISSUES) {
+                
+                auto afterLoc = session->byteDecoder->SrcLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 if (c.to_point() == '.') {
                     
@@ -2463,12 +2498,9 @@ inline Token Tokenizer::handleUnder(Buffer tokenStartBuf, SourceLocation tokenSt
                     
                     auto dotLoc = afterLoc;
                     
-                    CodeActionPtrSet Actions;
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(dotLoc), " ")));
+                    auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDCHARACTER, ISSUEMESSAGE_SUSPICIOUSSYNTAX, SYNTAXISSUESEVERITY_ERROR, Source(dotLoc), 0.95, ISSUEACTION_INSERTSPACE);
                     
-                    auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDCHARACTER, "Suspicious syntax.", SYNTAXISSUESEVERITY_ERROR, Source(dotLoc), 0.95, std::move(Actions)));
-                    
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                 }
             }
 #endif // !NISSUES
@@ -2483,7 +2515,7 @@ inline Token Tokenizer::handleLess(Buffer tokenStartBuf, SourceLocation tokenSta
     
     assert(c.to_point() == '<');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_LESS; // <
     
@@ -2492,50 +2524,50 @@ inline Token Tokenizer::handleLess(Buffer tokenStartBuf, SourceLocation tokenSta
             
             Operator = TOKEN_LESSBAR; // <|
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '<': {
             
             Operator = TOKEN_LESSLESS; // <<
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '>': {
             
             Operator = TOKEN_LESSGREATER; // <>
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '=': {
             
             Operator = TOKEN_LESSEQUAL; // <=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '-': {
             
-            auto minusBuf = TheByteBuffer->buffer;
-            auto minusLoc = TheByteDecoder->SrcLoc;
+            auto minusBuf = session->byteBuffer->buffer;
+            auto minusLoc = session->byteDecoder->SrcLoc;
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '>') {
                 
                 Operator = TOKEN_LESSMINUSGREATER; // <->
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
             } else {
                 
@@ -2558,7 +2590,7 @@ inline Token Tokenizer::handleGreater(Buffer tokenStartBuf, SourceLocation token
     
     assert(c.to_point() == '>');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_GREATER; // >
     
@@ -2567,17 +2599,17 @@ inline Token Tokenizer::handleGreater(Buffer tokenStartBuf, SourceLocation token
             
             Operator = TOKEN_GREATERGREATER; // >>
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '>') {
                 
                 Operator = TOKEN_GREATERGREATERGREATER; // >>>
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             }
         }
             break;
@@ -2585,8 +2617,8 @@ inline Token Tokenizer::handleGreater(Buffer tokenStartBuf, SourceLocation token
             
             Operator = TOKEN_GREATEREQUAL; // >=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -2598,7 +2630,7 @@ inline Token Tokenizer::handleMinus(Buffer tokenStartBuf, SourceLocation tokenSt
     
     assert(c.to_point() == '-');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_MINUS; // -
     
@@ -2616,22 +2648,23 @@ inline Token Tokenizer::handleMinus(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_MINUSGREATER; // ->
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '-': {
             
             Operator = TOKEN_MINUSMINUS; // --
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
 #if !NISSUES
-            {
-                auto afterLoc = TheByteDecoder->SrcLoc;
+            if ((session->policy & SKIP_ISSUES) != SKIP_ISSUES) {
+                
+                auto afterLoc = session->byteDecoder->SrcLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 if (c.to_point() == '>') {
                     
@@ -2641,12 +2674,9 @@ inline Token Tokenizer::handleMinus(Buffer tokenStartBuf, SourceLocation tokenSt
                     
                     auto greaterLoc = afterLoc;
                     
-                    CodeActionPtrSet Actions;
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(greaterLoc), " ")));
+                    auto I = Issue(ISSUEKIND_FORMAT, FORMATISSUETAG_INSERTSPACE, ISSUEMESSAGE_SPACEBETWEENMINUSGREATER, FORMATISSUESEVERITY_FORMATTING, Source(greaterLoc), 0.0, ISSUEACTION_INSERTSPACE);
                     
-                    auto I = IssuePtr(new FormatIssue(FORMATISSUETAG_INSERTSPACE, "Put a space between ``-`` and ``>`` to reduce ambiguity", FORMATISSUESEVERITY_FORMATTING, Source(greaterLoc), std::move(Actions)));
-                    
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                     
                 } else if (c.to_point() == '=') {
                     
@@ -2656,12 +2686,9 @@ inline Token Tokenizer::handleMinus(Buffer tokenStartBuf, SourceLocation tokenSt
                     
                     auto equalLoc = afterLoc;
                     
-                    CodeActionPtrSet Actions;
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(equalLoc), " ")));
-                    
-                    auto I = IssuePtr(new FormatIssue(FORMATISSUETAG_INSERTSPACE, "Put a space between ``-`` and ``=`` to reduce ambiguity", FORMATISSUESEVERITY_FORMATTING, Source(equalLoc), std::move(Actions)));
+                    auto I = Issue(ISSUEKIND_FORMAT, FORMATISSUETAG_INSERTSPACE, ISSUEMESSAGE_SPACEBETWEENMINUSEQUAL, FORMATISSUESEVERITY_FORMATTING, Source(equalLoc), 0.0, ISSUEACTION_INSERTSPACE);
                     
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                 }
             }
 #endif // !NISSUES
@@ -2671,8 +2698,8 @@ inline Token Tokenizer::handleMinus(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_MINUSEQUAL; // -=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -2684,7 +2711,7 @@ inline Token Tokenizer::handleBar(Buffer tokenStartBuf, SourceLocation tokenStar
     
     assert(c.to_point() == '|');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_BAR; // |
     
@@ -2693,14 +2720,15 @@ inline Token Tokenizer::handleBar(Buffer tokenStartBuf, SourceLocation tokenStar
             
             Operator = TOKEN_BARGREATER; // |>
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
 #if !NISSUES
-            {
-                auto afterLoc = TheByteDecoder->SrcLoc;
+            if ((session->policy & SKIP_ISSUES) != SKIP_ISSUES) {
+                
+                auto afterLoc = session->byteDecoder->SrcLoc;
                 
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 if (c.to_point() == '=') {
                     
@@ -2710,12 +2738,9 @@ inline Token Tokenizer::handleBar(Buffer tokenStartBuf, SourceLocation tokenStar
                     
                     auto equalLoc = afterLoc;
                     
-                    CodeActionPtrSet Actions;
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(equalLoc), " ")));
+                    auto I = Issue(ISSUEKIND_FORMAT, FORMATISSUETAG_INSERTSPACE, ISSUEMESSAGE_SPACEBETWEENGREATEREQUAL, FORMATISSUESEVERITY_FORMATTING, Source(equalLoc), 0.0, ISSUEACTION_INSERTSPACE);
                     
-                    auto I = IssuePtr(new FormatIssue(FORMATISSUETAG_INSERTSPACE, "Put a space between ``>`` and ``=`` to reduce ambiguity", FORMATISSUESEVERITY_FORMATTING, Source(equalLoc), std::move(Actions)));
-                    
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                 }
             }
 #endif // !NISSUES
@@ -2726,27 +2751,27 @@ inline Token Tokenizer::handleBar(Buffer tokenStartBuf, SourceLocation tokenStar
             
             Operator = TOKEN_BARBAR; // ||
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
             
         case '-': {
             
-            auto barBuf = TheByteBuffer->buffer;
-            auto barLoc = TheByteDecoder->SrcLoc;
+            auto barBuf = session->byteBuffer->buffer;
+            auto barLoc = session->byteDecoder->SrcLoc;
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '>') {
                 
                 Operator = TOKEN_BARMINUSGREATER; // |->
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
             } else {
                 
@@ -2769,7 +2794,7 @@ inline Token Tokenizer::handleSemi(Buffer tokenStartBuf, SourceLocation tokenSta
     
     assert(c.to_point() == ';');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_SEMI; // ;
     
@@ -2777,8 +2802,8 @@ inline Token Tokenizer::handleSemi(Buffer tokenStartBuf, SourceLocation tokenSta
         
         Operator = TOKEN_SEMISEMI; // ;;
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     }
     
     return Token(Operator, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
@@ -2788,7 +2813,7 @@ inline Token Tokenizer::handleBang(Buffer tokenStartBuf, SourceLocation tokenSta
     
     assert(c.to_point() == '!');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_BANG; // !
     
@@ -2797,16 +2822,16 @@ inline Token Tokenizer::handleBang(Buffer tokenStartBuf, SourceLocation tokenSta
             
             Operator = TOKEN_BANGEQUAL; // !=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '!': {
             
             Operator = TOKEN_BANGBANG; // !!
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -2818,7 +2843,7 @@ inline Token Tokenizer::handleHash(Buffer tokenStartBuf, SourceLocation tokenSta
     
     assert(c.to_point() == '#');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_HASH; // #
     
@@ -2826,8 +2851,8 @@ inline Token Tokenizer::handleHash(Buffer tokenStartBuf, SourceLocation tokenSta
         
         Operator = TOKEN_HASHHASH; // ##
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     }
     
     return Token(Operator, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
@@ -2837,13 +2862,13 @@ inline Token Tokenizer::handlePercent(Buffer tokenStartBuf, SourceLocation token
     
     assert(c.to_point() == '%');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_PERCENT; // %
     
     if (c.to_point() == '%') {
         
-        c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+        c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
         
         Operator = TOKEN_PERCENTPERCENT; // %%
         
@@ -2858,10 +2883,10 @@ inline Token Tokenizer::handlePercent(Buffer tokenStartBuf, SourceLocation token
                 break;
             }
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
         } // while
     }
@@ -2873,7 +2898,7 @@ inline Token Tokenizer::handleAmp(Buffer tokenStartBuf, SourceLocation tokenStar
     
     assert(c.to_point() == '&');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_AMP; // &
     
@@ -2881,8 +2906,8 @@ inline Token Tokenizer::handleAmp(Buffer tokenStartBuf, SourceLocation tokenStar
         
         Operator = TOKEN_AMPAMP; // &&
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     }
     
     return Token(Operator, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
@@ -2894,34 +2919,34 @@ inline Token Tokenizer::handleSlash(Buffer tokenStartBuf, SourceLocation tokenSt
     
     auto Operator = TOKEN_SLASH; // /
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     switch (c.to_point()) {
         case '@': {
             
             Operator = TOKEN_SLASHAT; // /@
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case ';': {
             
             Operator = TOKEN_SLASHSEMI; // /;
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '.': {
             
-            auto dotBuf = TheByteBuffer->buffer;
-            auto dotLoc = TheByteDecoder->SrcLoc;
+            auto dotBuf = session->byteBuffer->buffer;
+            auto dotLoc = session->byteDecoder->SrcLoc;
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.isDigit()) {
                 
@@ -2943,34 +2968,34 @@ inline Token Tokenizer::handleSlash(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_SLASHSLASH; // //
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             switch (c.to_point()) {
                 case '.': {
                     
                     Operator = TOKEN_SLASHSLASHDOT; // //.
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 }
                     break;
                 case '@': {
                     
                     Operator = TOKEN_SLASHSLASHAT; // //@
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 }
                     break;
                 case '=': {
                     
                     Operator = TOKEN_SLASHSLASHEQUAL; // //=
                     
-                    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 }
                     break;
             }
@@ -2980,24 +3005,24 @@ inline Token Tokenizer::handleSlash(Buffer tokenStartBuf, SourceLocation tokenSt
             
             Operator = TOKEN_SLASHCOLON; // /:
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '=': {
             
             Operator = TOKEN_SLASHEQUAL; // /=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '*': {
             
             Operator = TOKEN_SLASHSTAR; // /*
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -3009,7 +3034,7 @@ inline Token Tokenizer::handleAt(Buffer tokenStartBuf, SourceLocation tokenStart
     
     assert(c.to_point() == '@');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_AT; // @
     
@@ -3018,17 +3043,17 @@ inline Token Tokenizer::handleAt(Buffer tokenStartBuf, SourceLocation tokenStart
             
             Operator = TOKEN_ATAT; // @@
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '@') {
                 
                 Operator = TOKEN_ATATAT; // @@@
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             }
         }
             break;
@@ -3036,8 +3061,8 @@ inline Token Tokenizer::handleAt(Buffer tokenStartBuf, SourceLocation tokenStart
             
             Operator = TOKEN_ATSTAR; // @*
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -3049,7 +3074,7 @@ inline Token Tokenizer::handlePlus(Buffer tokenStartBuf, SourceLocation tokenSta
     
     assert(c.to_point() == '+');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_PLUS; // +
     
@@ -3057,12 +3082,12 @@ inline Token Tokenizer::handlePlus(Buffer tokenStartBuf, SourceLocation tokenSta
         case '+': {
             Operator = TOKEN_PLUSPLUS; // ++
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
 #if !NISSUES
             {
-                c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+                c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
                 
                 if (c.to_point() == '=') {
                     
@@ -3070,14 +3095,11 @@ inline Token Tokenizer::handlePlus(Buffer tokenStartBuf, SourceLocation tokenSta
                     // Something like  a++=0
                     //
                     
-                    auto loc = TheByteDecoder->SrcLoc;
-                    
-                    CodeActionPtrSet Actions;
-                    Actions.insert(CodeActionPtr(new InsertTextCodeAction("Insert space", Source(loc), " ")));
+                    auto loc = session->byteDecoder->SrcLoc;
                     
-                    auto I = IssuePtr(new FormatIssue(FORMATISSUETAG_INSERTSPACE, "Put a space between ``+`` and ``=`` to reduce ambiguity", FORMATISSUESEVERITY_FORMATTING, Source(loc), std::move(Actions)));
+                    auto I = Issue(ISSUEKIND_FORMAT, FORMATISSUETAG_INSERTSPACE, ISSUEMESSAGE_SPACEBETWEENPLUSEQUAL, FORMATISSUESEVERITY_FORMATTING, Source(loc), 0.0, ISSUEACTION_INSERTSPACE);
                     
-                    Issues.insert(std::move(I));
+                    addIssue(std::move(I));
                 }
             }
 #endif // !NISSUES
@@ -3086,8 +3108,8 @@ inline Token Tokenizer::handlePlus(Buffer tokenStartBuf, SourceLocation tokenSta
         case '=': {
             Operator = TOKEN_PLUSEQUAL; // +=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -3099,7 +3121,7 @@ inline Token Tokenizer::handleTilde(Buffer tokenStartBuf, SourceLocation tokenSt
     
     assert(c.to_point() == '~');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_TILDE; // ~
     
@@ -3107,8 +3129,8 @@ inline Token Tokenizer::handleTilde(Buffer tokenStartBuf, SourceLocation tokenSt
         
         Operator = TOKEN_TILDETILDE; // ~~
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     }
     
     return Token(Operator, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
@@ -3118,7 +3140,7 @@ inline Token Tokenizer::handleQuestion(Buffer tokenStartBuf, SourceLocation toke
     
     assert(c.to_point() == '?');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_QUESTION; // ?
     
@@ -3126,8 +3148,8 @@ inline Token Tokenizer::handleQuestion(Buffer tokenStartBuf, SourceLocation toke
         
         Operator = TOKEN_QUESTIONQUESTION; // ??
         
-        TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-        TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+        session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+        session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     }
     
     return Token(Operator, getTokenBufferAndLength(tokenStartBuf), getTokenSource(tokenStartLoc));
@@ -3137,7 +3159,7 @@ inline Token Tokenizer::handleStar(Buffer tokenStartBuf, SourceLocation tokenSta
     
     assert(c.to_point() == '*');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_STAR; // *
     
@@ -3146,16 +3168,16 @@ inline Token Tokenizer::handleStar(Buffer tokenStartBuf, SourceLocation tokenSta
             
             Operator = TOKEN_STAREQUAL; // *=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
         case '*': {
             
             Operator = TOKEN_STARSTAR; // **
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -3167,24 +3189,24 @@ inline Token Tokenizer::handleCaret(Buffer tokenStartBuf, SourceLocation tokenSt
     
     assert(c.to_point() == '^');
     
-    c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
     
     auto Operator = TOKEN_CARET;
     
     switch (c.to_point()) {
         case ':': {
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             
-            c = TheCharacterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->currentWLCharacter(tokenStartBuf, tokenStartLoc, policy);
             
             if (c.to_point() == '=') {
                 
                 Operator = TOKEN_CARETCOLONEQUAL; // ^:=
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
                 
             } else {
                 
@@ -3194,16 +3216,16 @@ inline Token Tokenizer::handleCaret(Buffer tokenStartBuf, SourceLocation tokenSt
                 
                 Operator = TOKEN_ERROR_EXPECTEDEQUAL;
                 
-                TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-                TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+                session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+                session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
             }
         }
             break;
         case '=': {
             Operator = TOKEN_CARETEQUAL; // ^=
             
-            TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-            TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+            session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+            session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
         }
             break;
     }
@@ -3224,7 +3246,7 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
     
     assert(c.to_point() == '\\');
     
-    c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+    c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
     
     switch (c.to_point()) {
         case '[': {
@@ -3233,10 +3255,10 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
             // Try to reconstruct \[XXX]
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetLoc = TheByteDecoder->SrcLoc;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
             
             while (true) {
                 
@@ -3246,10 +3268,10 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
                 
                 if (c.isAlphaOrDigit()) {
                     
-                    resetBuf = TheByteBuffer->buffer;
-                    resetLoc = TheByteDecoder->SrcLoc;
+                    resetBuf = session->byteBuffer->buffer;
+                    resetLoc = session->byteDecoder->SrcLoc;
                     
-                    c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
                     
                 } else if (c.to_point() == ']') {
                     
@@ -3257,8 +3279,8 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
                     
                 } else {
                     
-                    TheByteBuffer->buffer = resetBuf;
-                    TheByteDecoder->SrcLoc = resetLoc;
+                    session->byteBuffer->buffer = resetBuf;
+                    session->byteDecoder->SrcLoc = resetLoc;
                     
                     break;
                 }
@@ -3272,10 +3294,10 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
             // Try to reconstruct \:XXXX
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetLoc = TheByteDecoder->SrcLoc;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
             
             for (auto i = 0; i < 4; i++) {
                 
@@ -3285,15 +3307,15 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
                 
                 if (c.isHex()) {
                     
-                    resetBuf = TheByteBuffer->buffer;
-                    resetLoc = TheByteDecoder->SrcLoc;
+                    resetBuf = session->byteBuffer->buffer;
+                    resetLoc = session->byteDecoder->SrcLoc;
                     
-                    c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
                     
                 } else {
                     
-                    TheByteBuffer->buffer = resetBuf;
-                    TheByteDecoder->SrcLoc = resetLoc;
+                    session->byteBuffer->buffer = resetBuf;
+                    session->byteDecoder->SrcLoc = resetLoc;
                     
                     break;
                 }
@@ -3307,10 +3329,10 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
             // Try to reconstruct \.XX
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetLoc = TheByteDecoder->SrcLoc;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
             
             for (auto i = 0; i < 2; i++) {
                 
@@ -3320,15 +3342,15 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
                 
                 if (c.isHex()) {
                     
-                    resetBuf = TheByteBuffer->buffer;
-                    resetLoc = TheByteDecoder->SrcLoc;
+                    resetBuf = session->byteBuffer->buffer;
+                    resetLoc = session->byteDecoder->SrcLoc;
                     
-                    c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
                     
                 } else {
                     
-                    TheByteBuffer->buffer = resetBuf;
-                    TheByteDecoder->SrcLoc = resetLoc;
+                    session->byteBuffer->buffer = resetBuf;
+                    session->byteDecoder->SrcLoc = resetLoc;
                     
                     break;
                 }
@@ -3342,10 +3364,10 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
             // Try to reconstruct \XXX
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetLoc = TheByteDecoder->SrcLoc;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
             
             for (auto i = 0; i < 3; i++) {
                 
@@ -3355,15 +3377,15 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
                 
                 if (c.isOctal()) {
                     
-                    resetBuf = TheByteBuffer->buffer;
-                    resetLoc = TheByteDecoder->SrcLoc;
+                    resetBuf = session->byteBuffer->buffer;
+                    resetLoc = session->byteDecoder->SrcLoc;
                     
-                    c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
                     
                 } else {
                     
-                    TheByteBuffer->buffer = resetBuf;
-                    TheByteDecoder->SrcLoc = resetLoc;
+                    session->byteBuffer->buffer = resetBuf;
+                    session->byteDecoder->SrcLoc = resetLoc;
                     
                     break;
                 }
@@ -3377,10 +3399,10 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
             // Try to reconstruct \|XXXXXX
             //
             
-            auto resetBuf = TheByteBuffer->buffer;
-            auto resetLoc = TheByteDecoder->SrcLoc;
+            auto resetBuf = session->byteBuffer->buffer;
+            auto resetLoc = session->byteDecoder->SrcLoc;
             
-            c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+            c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
             
             for (auto i = 0; i < 6; i++) {
                 
@@ -3390,15 +3412,15 @@ inline Token Tokenizer::handleUnhandledBackslash(Buffer tokenStartBuf, SourceLoc
                 
                 if (c.isHex()) {
                     
-                    resetBuf = TheByteBuffer->buffer;
-                    resetLoc = TheByteDecoder->SrcLoc;
+                    resetBuf = session->byteBuffer->buffer;
+                    resetLoc = session->byteDecoder->SrcLoc;
                     
-                    c = TheCharacterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
+                    c = session->characterDecoder->nextWLCharacter0(tokenStartBuf, tokenStartLoc, policy);
                     
                 } else {
                     
-                    TheByteBuffer->buffer = resetBuf;
-                    TheByteDecoder->SrcLoc = resetLoc;
+                    session->byteBuffer->buffer = resetBuf;
+                    session->byteDecoder->SrcLoc = resetLoc;
                     
                     break;
                 }
@@ -3427,9 +3449,9 @@ inline Token Tokenizer::handleMBStrangeNewline(Buffer tokenStartBuf, SourceLocat
     
 #if !NISSUES
     {
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDNEWLINECHARACTER, "Unexpected newline character: ``" + c.graphicalString() + "``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(tokenStartLoc), 0.85, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDNEWLINECHARACTER, ISSUEMESSAGE_UNEXPECTEDNEWLINECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(tokenStartLoc), 0.85, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
@@ -3445,9 +3467,9 @@ inline Token Tokenizer::handleMBStrangeWhitespace(Buffer tokenStartBuf, SourceLo
     
 #if !NISSUES
     {
-        auto I = IssuePtr(new SyntaxIssue(SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER, "Unexpected space character: ``\"" + c.safeEncodedCharString() + "\" (" + c.graphicalString() + ")``.", SYNTAXISSUESEVERITY_WARNING, getTokenSource(tokenStartLoc), 0.85, {}));
+        auto I = Issue(ISSUEKIND_SYNTAX, SYNTAXISSUETAG_UNEXPECTEDSPACECHARACTER, ISSUEMESSAGE_UNEXPECTEDSPACECHARACTER, SYNTAXISSUESEVERITY_WARNING, getTokenSource(tokenStartLoc), 0.85, ISSUEACTION_NONE, c);
         
-        Issues.insert(std::move(I));
+        addIssue(std::move(I));
     }
 #endif // !NISSUES
     
@@ -3497,34 +3519,283 @@ inline Token Tokenizer::handleNakedMBLinearSyntax(Buffer tokenStartBuf, SourceLo
     
 }
 
+//
+// Lines that start with one of these and then [ start a new chunk
+//
+static const char *const ChunkDirectives[] = {
+    "BeginPackage", "Begin", "Needs", "End", "EndPackage", "Clear", "ClearAll", "SetOptions", "SetAttributes",
+    "System`Private`NewContextPath", "System`Private`RestoreContextPath", "Protect", "Unprotect", "Package",
+    "PackageImport", "PackageScope", "PackageExport", "Get", "SetDelayed", "UpSetDelayed", "TagSetDelayed"
+};
+
+//
+// Does the line from p to lineEnd start a new chunk?
+//
+// A chunk starts with an annotation comment, one of ChunkDirectives followed by [, or a line that starts with a
+// letter or $ and has = in it
+//
+static bool isChunkStart(Buffer p, Buffer lineEnd) {
+    
+    auto len = static_cast<size_t>(lineEnd - p);
+    
+    if (len == 0) {
+        return false;
+    }
+    
+    //
+    // Annotation comment
+    //
+    // (* ::Package:: *)
+    //
+    if (len >= 2 && p[0] == '(' && p[1] == '*') {
+        
+        auto q = p + 2;
+        
+        while (q < lineEnd && (*q == ' ' || *q == '\t')) {
+            q++;
+        }
+        
+        return q < lineEnd && *q == ':';
+    }
+    
+    //
+    // Directive
+    //
+    // Begin["`Private`"]
+    //
+    for (auto D : ChunkDirectives) {
+        
+        auto n = strlen(D);
+        
+        if (n < len && memcmp(p, D, n) == 0 && p[n] == '[') {
+            return true;
+        }
+    }
+    
+    //
+    // Assignment
+    //
+    // x = 1
+    //
+    if (('a' <= p[0] && p[0] <= 'z') || ('A' <= p[0] && p[0] <= 'Z') || p[0] == '$') {
+        return memchr(p + 1, '=', len - 1) != nullptr;
+    }
+    
+    return false;
+}
+
+template <typename SourceConventionManager>
+static Buffer recoverUnterminated0(Buffer p, Buffer end, SourceLocation& Loc, uint32_t TabWidth) {
+    
+    const auto M = makeSourceConventionManager<SourceConventionManager>(TabWidth);
+    
+    auto GoodBuf = p;
+    auto GoodLoc = Loc;
+    
+    auto first = true;
+    
+    while (true) {
+        
+        auto lineStart = p;
+        auto lineEnd = p;
+        
+        while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') {
+            lineEnd++;
+        }
+        
+        if (!first && isChunkStart(lineStart, lineEnd)) {
+            break;
+        }
+        
+        while (p < lineEnd) {
+            
+            if (*p == '\t') {
+                
+                M.tab(Loc);
+                
+                p++;
+                
+                continue;
+            }
+            
+            //
+            // Count characters the same as the decoder: 1 for each valid UTF-8 sequence, and 1 for each byte that is
+            // not part of one
+            //
+            auto len = ByteDecoder::validSequenceLength(p, lineEnd);
+            
+            M.increment(Loc);
+            
+            p += (len == 0) ? 1 : len;
+        }
+        
+        if (first || lineEnd > lineStart) {
+            
+            GoodBuf = lineEnd;
+            GoodLoc = Loc;
+        }
+        
+        if (p == end) {
+            break;
+        }
+        
+        if (*p == '\r' && p + 1 < end && *(p + 1) == '\n') {
+            
+            M.windowsNewline(Loc);
+            
+            p += 2;
+            
+        } else {
+            
+            M.newline(Loc);
+            
+            p++;
+        }
+        
+        first = false;
+    }
+    
+    Loc = GoodLoc;
+    
+    return GoodBuf;
+}
+
+//
+// Is there a chunk start in the lines after the line of p, up to and including the line of stop
+//
+static bool chunkStartBefore(Buffer p, Buffer stop, Buffer end) {
+    
+    while (true) {
+        
+        while (p < stop && *p != '\n' && *p != '\r') {
+            p++;
+        }
+        
+        if (p == stop) {
+            return false;
+        }
+        
+        if (*p == '\r' && p + 1 < end && *(p + 1) == '\n') {
+            p += 2;
+        } else {
+            p++;
+        }
+        
+        auto lineEnd = p;
+        
+        while (lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r') {
+            lineEnd++;
+        }
+        
+        if (isChunkStart(p, lineEnd)) {
+            return true;
+        }
+    }
+}
+
+Buffer Tokenizer::recoverUnterminated(Buffer Start, SourceLocation StartLoc, SourceLocation& End) {
+    
+    //
+    // Any Start from RecoverStart to RecoverEnd is in the same chunk, and so is any earlier Start with no chunk start
+    // in between
+    //
+    if (RecoverStart && Start < RecoverEnd && (Start >= RecoverStart || !chunkStartBefore(Start, RecoverStart, RecoverEnd))) {
+        
+        RecoverStart = std::min(Start, RecoverStart);
+        
+        End = RecoverEndLoc;
+        
+        return RecoverEnd;
+    }
+    
+    RecoverScanCount++;
+    
+    auto end = session->byteBuffer->end;
+    auto TabWidth = session->byteDecoder->getTabWidth();
+    
+    End = StartLoc;
+    
+    if (!session->byteDecoder->getTrackSource()) {
+        
+        RecoverEnd = recoverUnterminated0<NoSourceManager>(Start, end, End, TabWidth);
+        
+    } else {
+        
+        switch (session->byteDecoder->getSourceConvention()) {
+            case SOURCECONVENTION_LINECOLUMN:
+                RecoverEnd = recoverUnterminated0<LineColumnManager>(Start, end, End, TabWidth);
+                break;
+            case SOURCECONVENTION_SOURCECHARACTERINDEX:
+                RecoverEnd = recoverUnterminated0<SourceCharacterIndexManager>(Start, end, End, TabWidth);
+                break;
+            default:
+                assert(false);
+                RecoverEnd = recoverUnterminated0<LineColumnManager>(Start, end, End, TabWidth);
+                break;
+        }
+    }
+    
+    RecoverStart = Start;
+    RecoverEndLoc = End;
+    
+    return RecoverEnd;
+}
+
+Token Tokenizer::recoverUnterminatedToken(Token Tok) {
+    
+    SourceLocation End;
+    
+    auto EndBuf = recoverUnterminated(Tok.BufLen.buffer, Tok.Src.Start, End);
+    
+    return Token(Tok.Tok, BufferAndLength(Tok.BufLen.buffer, EndBuf - Tok.BufLen.buffer, Tok.BufLen.status), Source(Tok.Src.Start, End));
+}
+
 Source Tokenizer::getTokenSource(SourceLocation tokStartLoc) const {
-    auto loc = TheByteDecoder->SrcLoc;
+    auto loc = session->byteDecoder->SrcLoc;
     return Source(tokStartLoc, loc);
 }
 
 BufferAndLength Tokenizer::getTokenBufferAndLength(Buffer tokStartBuf) const {
-    auto buf = TheByteBuffer->buffer;
-    auto status = TheByteDecoder->getStatus();
+    auto buf = session->byteBuffer->buffer;
+    auto status = session->byteDecoder->getStatus();
     return BufferAndLength(tokStartBuf, buf - tokStartBuf, status);
 }
 
 #if !NISSUES
-void Tokenizer::addIssue(IssuePtr I) {
-    Issues.insert(std::move(I));
+void Tokenizer::addIssue(Issue I) {
+    
+    if ((session->policy & SKIP_ISSUES) == SKIP_ISSUES) {
+        return;
+    }
+    
+    Issues.push_back(std::move(I));
 }
 
-IssuePtrSet& Tokenizer::getIssues() {
+IssueVector& Tokenizer::getIssues() {
     return Issues;
 }
 #endif // !NISSUES
 
-std::set<SourceLocation>& Tokenizer::getEmbeddedNewlines() {
+SourceLocationVector& Tokenizer::getEmbeddedNewlines() {
     return EmbeddedNewlines;
 }
 
-std::set<SourceLocation>& Tokenizer::getEmbeddedTabs() {
+SourceLocationVector& Tokenizer::getEmbeddedTabs() {
     return EmbeddedTabs;
 }
 
+size_t Tokenizer::getLexCount() const {
+    return LexCount;
+}
+
+size_t Tokenizer::getPeekHitCount() const {
+    return PeekHitCount;
+}
 
-TokenizerPtr TheTokenizer = nullptr;
+size_t Tokenizer::getTokenCount() const {
+    return TokenCount;
+}
+
+size_t Tokenizer::getRecoverScanCount() const {
+    return RecoverScanCount;
+}
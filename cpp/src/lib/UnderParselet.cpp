@@ -1,26 +1,27 @@
 
 #include "Parselet.h"
 #include "ParseletRegistration.h" // for contextSensitiveSymbolParselet
+#include "API.h" // for ParserSession
 
-NodePtr UnderParselet::parse0(Token TokIn, ParserContext Ctxt) const {
+NodePtr UnderParselet::parse0(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    auto Under = NodePtr(new LeafNode(TokIn));
+    auto Under = NodePtr(session->arena->make<LeafNode>(TokIn));
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     NodePtr Blank;
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
     
     if (Tok.Tok == TOKEN_SYMBOL) {
         
-        auto Sym2 = contextSensitiveSymbolParselet->parseContextSensitive(Tok, Ctxt);
+        auto Sym2 = contextSensitiveSymbolParselet->parseContextSensitive(session, Tok, Ctxt);
         
-        NodeSeq Args(1 + 1);
+        NodeSeq Args(session, 1 + 1);
         Args.append(std::move(Under));
         Args.append(std::move(Sym2));
         
-        Blank = NodePtr(new CompoundNode(BOp, std::move(Args)));
+        Blank = NodePtr(session->arena->make<CompoundNode>(BOp, std::move(Args)));
         
     } else if (Tok.Tok == TOKEN_ERROR_EXPECTEDLETTERLIKE) {
         
@@ -30,15 +31,15 @@ NodePtr UnderParselet::parse0(Token TokIn, ParserContext Ctxt) const {
         // It's nice to include the error inside of the blank
         //
         
-        auto parselet = prefixParselets[Tok.Tok.value()];
+        session->parser->nextToken(Tok);
         
-        auto ErrorSym2 = parselet->parse(Tok, Ctxt);
+        auto ErrorSym2 = NodePtr(session->arena->make<ErrorNode>(Tok));
         
-        NodeSeq Args(1 + 1);
+        NodeSeq Args(session, 1 + 1);
         Args.append(std::move(Under));
         Args.append(std::move(ErrorSym2));
         
-        Blank = NodePtr(new CompoundNode(BOp, std::move(Args)));
+        Blank = NodePtr(session->arena->make<CompoundNode>(BOp, std::move(Args)));
         
     } else {
         Blank = std::move(Under);
@@ -47,12 +48,12 @@ NodePtr UnderParselet::parse0(Token TokIn, ParserContext Ctxt) const {
     return Blank;
 }
 
-NodePtr UnderParselet::parse1(NodePtr Blank, Token Tok, ParserContext Ctxt) const {
+void UnderParselet::parse1(ParserSession *session, NodePtr Blank, Token Tok, ParserContext Ctxt) const {
     
     {
-        LeafSeq Trivia1;
+        LeafSeq Trivia1(session);
         
-        Tok = TheParser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia1);
+        Tok = session->parser->eatTriviaButNotToplevelNewlines(Tok, Ctxt, TOPLEVEL, Trivia1);
         
         //
         // For something like _:\"\"  when parsing _
@@ -68,70 +69,72 @@ NodePtr UnderParselet::parse1(NodePtr Blank, Token Tok, ParserContext Ctxt) cons
             
             if ((Ctxt.Flag & PARSER_INSIDE_COLON) != PARSER_INSIDE_COLON) {
                 
-                NodeSeq BlankSeq(1 + 1);
+                NodeSeq BlankSeq(session, 1 + 1);
                 BlankSeq.append(std::move(Blank));
                 BlankSeq.appendIfNonEmpty(std::move(Trivia1));
                 
-                Blank = contextSensitiveColonParselet->parseContextSensitive(std::move(BlankSeq), Tok, Ctxt);
+                session->parser->pushInfixLoop(Ctxt);
+                
+                return contextSensitiveColonParselet->parseContextSensitive(session, std::move(BlankSeq), Tok, Ctxt);
             }
         }
     }
     
-    return TheParser->infixLoop(std::move(Blank), Ctxt);
+    return session->parser->infixLoop(std::move(Blank), Ctxt);
 }
 
-NodePtr UnderParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void UnderParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    auto Blank = parse0(TokIn, Ctxt);
+    auto Blank = parse0(session, TokIn, Ctxt);
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
     
-    return parse1(std::move(Blank), Tok, Ctxt);
+    return parse1(session, std::move(Blank), Tok, Ctxt);
 }
 
-NodePtr UnderParselet::parseContextSensitive(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void UnderParselet::parseContextSensitive(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     
-    NodeSeq Args(1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
+    NodeSeq Args(session, 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
     
-    auto Blank = parse0(TokIn, Ctxt);
+    auto Blank = parse0(session, TokIn, Ctxt);
     Args.append(NodePtr(std::move(Blank)));
     
-    auto Pat = NodePtr(new CompoundNode(PBOp, std::move(Args)));
+    auto Pat = NodePtr(session->arena->make<CompoundNode>(PBOp, std::move(Args)));
     
-    auto Tok = TheParser->currentToken(Ctxt, TOPLEVEL);
+    auto Tok = session->parser->currentToken(Ctxt, TOPLEVEL);
     
-    return parse1(std::move(Pat), Tok, Ctxt);
+    return parse1(session, std::move(Pat), Tok, Ctxt);
 }
 
 
-NodePtr UnderDotParselet::parse0(Token TokIn, ParserContext Ctxt) const {
+NodePtr UnderDotParselet::parse0(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    auto UnderDot = NodePtr(new LeafNode(TokIn));
+    auto UnderDot = NodePtr(session->arena->make<LeafNode>(TokIn));
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
     return UnderDot;
 }
 
-NodePtr UnderDotParselet::parse(Token TokIn, ParserContext Ctxt) const {
+void UnderDotParselet::parse(ParserSession *session, Token TokIn, ParserContext Ctxt) const {
     
-    auto Blank = parse0(TokIn, Ctxt);
+    auto Blank = parse0(session, TokIn, Ctxt);
     
-    TheParser->nextToken(TokIn);
+    session->parser->nextToken(TokIn);
     
-    return TheParser->infixLoop(std::move(Blank), Ctxt);
+    return session->parser->infixLoop(std::move(Blank), Ctxt);
 }
 
-NodePtr UnderDotParselet::parseContextSensitive(NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
+void UnderDotParselet::parseContextSensitive(ParserSession *session, NodeSeq Left, Token TokIn, ParserContext Ctxt) const {
     
-    NodeSeq Args(1 + 1);
-    Args.append(NodePtr(new NodeSeqNode(std::move(Left))));
+    NodeSeq Args(session, 1 + 1);
+    Args.append(NodePtr(session->arena->make<NodeSeqNode>(std::move(Left))));
     
-    auto Blank = parse0(TokIn, Ctxt);
+    auto Blank = parse0(session, TokIn, Ctxt);
     Args.append(NodePtr(std::move(Blank)));
     
-    auto Pat = NodePtr(new CompoundNode(SYMBOL_CODEPARSER_PATTERNOPTIONALDEFAULT, std::move(Args)));
+    auto Pat = NodePtr(session->arena->make<CompoundNode>(SYMBOL_CODEPARSER_PATTERNOPTIONALDEFAULT, std::move(Args)));
     
-    return TheParser->infixLoop(std::move(Pat), Ctxt);
+    return session->parser->infixLoop(std::move(Pat), Ctxt);
 }
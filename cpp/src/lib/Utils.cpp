@@ -7,10 +7,10 @@
 #include <cassert>
 #include <cctype> // for isalnum, isxdigit, isupper, isdigit, isalpha, ispunct, iscntrl with GCC and MSVC
 
-std::unordered_set<std::string> undocumentedLongNames;
+std::unordered_set<codepoint> undocumentedLongNames;
 
-bool Utils::isUndocumentedLongName(std::string s) {
-    return undocumentedLongNames.find(s) != undocumentedLongNames.end();
+bool Utils::isUndocumentedLongName(codepoint point) {
+    return undocumentedLongNames.find(point) != undocumentedLongNames.end();
 }
 
 
@@ -436,35 +436,20 @@ bool WLCharacter::isSign() const {
 // Multi-byte character properties
 //
 
-bool WLCharacter::isMBLinearSyntax() const {
+//
+// The negative code points are not in the LongNames table
+//
+uint8_t WLCharacter::mbClass() const {
     
     auto val = to_point();
     
-    switch (val) {
-        case CODEPOINT_LINEARSYNTAX_CLOSEPAREN:
-        case CODEPOINT_LINEARSYNTAX_BANG:
-        case CODEPOINT_LINEARSYNTAX_AT:
-        case CODEPOINT_LINEARSYNTAX_PERCENT:
-        case CODEPOINT_LINEARSYNTAX_CARET:
-        case CODEPOINT_LINEARSYNTAX_AMP:
-        case CODEPOINT_LINEARSYNTAX_STAR:
-        case CODEPOINT_LINEARSYNTAX_OPENPAREN:
-        case CODEPOINT_LINEARSYNTAX_UNDER:
-        case CODEPOINT_LINEARSYNTAX_PLUS:
-        case CODEPOINT_LINEARSYNTAX_SLASH:
-        case CODEPOINT_LINEARSYNTAX_BACKTICK:
-        case CODEPOINT_LINEARSYNTAX_SPACE:
-            return true;
-        default:
-            return false;
+    if (val >= 0) {
+        return LongNames::mbClass(val);
     }
-}
 
-bool WLCharacter::isMBStringMeta() const {
-    
-    auto val = to_point();
-    
     switch (val) {
+        case CODEPOINT_LINEARSYNTAX_SPACE:
+            return MBCLASS_LINEARSYNTAX;
         case CODEPOINT_STRINGMETA_OPEN:
         case CODEPOINT_STRINGMETA_CLOSE:
         case CODEPOINT_STRINGMETA_BACKSLASH:
@@ -474,21 +459,29 @@ bool WLCharacter::isMBStringMeta() const {
         case CODEPOINT_STRINGMETA_LINEFEED:
         case CODEPOINT_STRINGMETA_CARRIAGERETURN:
         case CODEPOINT_STRINGMETA_TAB:
-            return true;
+            return MBCLASS_STRINGMETA;
+        case CODEPOINT_CRLF:
+            return MBCLASS_NEWLINE;
         default:
-            return false;
+            return 0;
     }
 }
 
+bool WLCharacter::isMBLinearSyntax() const {
+    return (mbClass() & MBCLASS_LINEARSYNTAX) != 0;
+}
+
+bool WLCharacter::isMBStringMeta() const {
+    return (mbClass() & MBCLASS_STRINGMETA) != 0;
+}
+
 bool WLCharacter::isMBUnsupported() const {
     
     auto esc = escape();
     
     if (esc == ESCAPE_LONGNAME) {
         
-        auto val = to_point();
-        
-        if (LongNames::isUnsupportedLongNameCodePoint(val)) {
+        if ((mbClass() & MBCLASS_UNSUPPORTED) != 0) {
             return true;
         }
     }
@@ -511,10 +504,6 @@ bool WLCharacter::isMBLetterlike() const {
         return false;
     }
     
-    if (isMBPunctuation()) {
-        return false;
-    }
-    
     //
     // Must handle all of the specially defined CodePoints
     //
@@ -528,31 +517,19 @@ bool WLCharacter::isMBLetterlike() const {
         return false;
     }
     
-    if (val == CODEPOINT_CRLF) {
-        return false;
-    }
-    
-    if (isMBLinearSyntax()) {
-        return false;
-    }
-    
-    if (isMBStringMeta()) {
-        return false;
-    }
-    
-    if (isMBWhitespace()) {
-        return false;
-    }
-    
-    if (isMBNewline()) {
-        return false;
-    }
+    return isMBLetterlike(mbClass());
+}
+
+//
+// Same as isMBLetterlike() for a character that is already known to be multi-byte, given its mbClass()
+//
+bool WLCharacter::isMBLetterlike(uint8_t cls) const {
     
-    if (isMBUninterpretable()) {
+    if ((cls & (MBCLASS_PUNCTUATION | MBCLASS_WHITESPACE | MBCLASS_NEWLINE | MBCLASS_UNINTERPRETABLE | MBCLASS_LINEARSYNTAX | MBCLASS_STRINGMETA)) != 0) {
         return false;
     }
     
-    if (isMBUnsupported()) {
+    if ((cls & MBCLASS_UNSUPPORTED) != 0 && escape() == ESCAPE_LONGNAME) {
         return false;
     }
     
@@ -568,9 +545,7 @@ bool WLCharacter::isMBStrangeLetterlike() const {
         return false;
     }
     
-    auto val = to_point();
-    
-    return !LongNames::isMBNotStrangeLetterlike(val);
+    return (mbClass() & MBCLASS_NOTSTRANGELETTERLIKE) == 0;
 }
 
 bool WLCharacter::isMBStrangeWhitespace() const {
@@ -621,31 +596,19 @@ bool WLCharacter::isMBControl() const {
 }
 
 bool WLCharacter::isMBNewline() const {
-    
-    auto val = to_point();
-    
-    return LongNames::isMBNewline(val);
+    return (mbClass() & MBCLASS_NEWLINE) != 0;
 }
 
 bool WLCharacter::isMBWhitespace() const {
-    
-    auto val = to_point();
-    
-    return LongNames::isMBWhitespace(val);
+    return (mbClass() & MBCLASS_WHITESPACE) != 0;
 }
 
 bool WLCharacter::isMBPunctuation() const {
-    
-    auto val = to_point();
-    
-    return LongNames::isMBPunctuation(val);
+    return (mbClass() & MBCLASS_PUNCTUATION) != 0;
 }
 
 bool WLCharacter::isMBUninterpretable() const {
-    
-    auto val = to_point();
-    
-    return LongNames::isMBUninterpretable(val);
+    return (mbClass() & MBCLASS_UNINTERPRETABLE) != 0;
 }
 
 char fromDigitLookup[] = {
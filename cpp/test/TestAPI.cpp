@@ -9,16 +9,18 @@
 #include <sstream>
 
 
+static std::unique_ptr<ParserSession> session;
+
 class APITest : public ::testing::Test {
 protected:
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -41,13 +43,13 @@ TEST_F(APITest, Bug1) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->concreteParseLeaf(STRINGIFYMODE_NORMAL);
+    auto N = session->concreteParseLeaf(STRINGIFYMODE_NORMAL);
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -63,13 +65,13 @@ TEST_F(APITest, Hang1) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -85,13 +87,13 @@ TEST_F(APITest, Crash1) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -107,13 +109,13 @@ TEST_F(APITest, Crash2) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -129,13 +131,13 @@ TEST_F(APITest, Crash3) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -151,13 +153,13 @@ TEST_F(APITest, Crash4) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -173,13 +175,13 @@ TEST_F(APITest, Crash5) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -195,13 +197,13 @@ TEST_F(APITest, Crash6) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -217,13 +219,13 @@ TEST_F(APITest, Crash7) {
     
     auto bufAndLen = BufferAndLength(str, strIn.size());
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_UNKNOWN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_UNKNOWN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -239,13 +241,13 @@ TEST_F(APITest, Crash8) {
     
     auto bufAndLen = BufferAndLength(arr, 6);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_SOURCECHARACTERINDEX, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_SOURCECHARACTERINDEX, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
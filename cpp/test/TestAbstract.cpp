@@ -0,0 +1,167 @@
+
+#include "API.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <string>
+#include <memory>
+
+static std::unique_ptr<ParserSession> session;
+
+class AbstractTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        
+        session = std::unique_ptr<ParserSession>(new ParserSession);
+    }
+    
+    static void TearDownTestSuite() {
+        
+        session.reset(nullptr);
+    }
+};
+
+//
+// Print the expressions and the container Source that abstractParseExpressions returns
+//
+static std::string abstractAndPrint(const std::string& input, ParserSessionPolicy policy = INCLUDE_SOURCE) {
+    
+    auto str = reinterpret_cast<Buffer>(input.c_str());
+    
+    session->init(BufferAndLength(str, input.size()), nullptr, policy, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session->abstractParseExpressions();
+    
+    auto& nodes = static_cast<ListNode *>(N)->getNodes();
+    
+    std::ostringstream s;
+    
+    nodes[0]->print(session.get(), s);
+    
+    s << " ";
+    
+    nodes[6]->print(session.get(), s);
+    
+    session->releaseAllNodes();
+    
+    session->deinit();
+    
+    return s.str();
+}
+
+TEST_F(AbstractTest, Plus) {
+    
+    EXPECT_EQ(abstractAndPrint("a+b"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Plus], List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], CodeParser`Library`MakeLeafNode[Symbol, b, 1314], ], 1114], ] CodeParser`Library`MakeAbstractSource[1114]");
+}
+
+//
+// a - 1  is  Plus[a, -1]  with the Source of  - 1
+//
+TEST_F(AbstractTest, Minus) {
+    
+    EXPECT_EQ(abstractAndPrint("a-1"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Plus], List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], CodeParser`Library`MakeLeafNode[Integer, -1, 1214], ], 1114], ] CodeParser`Library`MakeAbstractSource[1114]");
+}
+
+TEST_F(AbstractTest, Negate) {
+    
+    EXPECT_EQ(abstractAndPrint("-(a)"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Times], List[CodeParser`Library`MakeAbstractLeafNode[Integer, -1], CodeParser`Library`MakeLeafNode[Symbol, a, 1314], ], 1115], ] CodeParser`Library`MakeAbstractSource[1115]");
+}
+
+TEST_F(AbstractTest, Part) {
+    
+    EXPECT_EQ(abstractAndPrint("a[[1]]"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Part], List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], CodeParser`Library`MakeLeafNode[Integer, 1, 1415], ], 1117], ] CodeParser`Library`MakeAbstractSource[1117]");
+}
+
+TEST_F(AbstractTest, List) {
+    
+    EXPECT_EQ(abstractAndPrint("{a,b}"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, List], List[CodeParser`Library`MakeLeafNode[Symbol, a, 1213], CodeParser`Library`MakeLeafNode[Symbol, b, 1415], ], 1116], ] CodeParser`Library`MakeAbstractSource[1116]");
+}
+
+TEST_F(AbstractTest, Derivative) {
+    
+    EXPECT_EQ(abstractAndPrint("f''"), "List[CodeParser`Library`MakeAbstractCallNode[CodeParser`Library`MakeAbstractCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Derivative], List[CodeParser`Library`MakeAbstractLeafNode[Integer, 2], ]], List[CodeParser`Library`MakeLeafNode[Symbol, f, 1112], ]], ] CodeParser`Library`MakeAbstractSource[1114]");
+}
+
+//
+// Errors are abstracted by the kernel, but only the nodes that have them
+//
+TEST_F(AbstractTest, Fallback) {
+    
+    EXPECT_EQ(abstractAndPrint("{a, (b}"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, List], List[CodeParser`Library`MakeLeafNode[Symbol, a, 1213], CodeParser`Library`MakeAbstractFallbackNode[CodeParser`Library`MakeGroupMissingCloserNode[CodeParser`GroupParen, List[CodeParser`Library`MakeLeafNode[Token`OpenParen, (, 1516], CodeParser`Library`MakeLeafNode[Symbol, b, 1617], ], 1517], ], ], 1118], ] CodeParser`Library`MakeAbstractSource[1118]");
+}
+
+//
+// Tokens with line continuations or embedded newlines or tabs are normalized by the kernel, so only those tokens are
+// given to the kernel
+//
+TEST_F(AbstractTest, LineContinuation) {
+    
+    EXPECT_EQ(abstractAndPrint("f[a\\\nb]"), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeLeafNode[Symbol, f, 1112], List[CodeParser`Library`MakeAbstractFallbackNode[CodeParser`Library`MakeLeafNode[Symbol, a\\\nb, 1322], ], ], 1123], ] CodeParser`Library`MakeAbstractSource[1123]");
+}
+
+TEST_F(AbstractTest, EmbeddedTab) {
+    
+    EXPECT_EQ(abstractAndPrint("x = \"a\tb\""), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Set], List[CodeParser`Library`MakeLeafNode[Symbol, x, 1112], CodeParser`Library`MakeAbstractFallbackNode[CodeParser`Library`MakeLeafNode[String, \"a\tb\", 15111], ], ], 11111], ] CodeParser`Library`MakeAbstractSource[11111]");
+}
+
+//
+// The whole node is given to the kernel when its rule looks at the text of such a token
+//
+TEST_F(AbstractTest, NegateLineContinuation) {
+    
+    EXPECT_EQ(abstractAndPrint("a-1\\\n2"), "List[CodeParser`Library`MakeAbstractFallbackNode[CodeParser`Library`MakeInfixNode[Plus, List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], , CodeParser`Library`MakeLeafNode[Token`Minus, -, 1213], CodeParser`Library`MakeLeafNode[Integer, 1\\\n2, 1322], ], 1122], ], ] CodeParser`Library`MakeAbstractSource[1122]");
+}
+
+//
+// Nodes that are not handled are given to the kernel as concrete syntax
+//
+TEST_F(AbstractTest, FallbackNode) {
+    
+    EXPECT_EQ(abstractAndPrint("a>b>c"), "List[CodeParser`Library`MakeAbstractFallbackNode[CodeParser`Library`MakeInfixNode[CodeParser`InfixInequality, List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], , CodeParser`Library`MakeLeafNode[Token`Greater, >, 1213], CodeParser`Library`MakeLeafNode[Symbol, b, 1314], CodeParser`Library`MakeLeafNode[Token`Greater, >, 1415], CodeParser`Library`MakeLeafNode[Symbol, c, 1516], ], 1116], ], ] CodeParser`Library`MakeAbstractSource[1116]");
+}
+
+//
+// Only strange top-level nodes in files are given to the kernel
+//
+TEST_F(AbstractTest, TopLevel) {
+    
+    EXPECT_EQ(abstractAndPrint("a+b", INCLUDE_SOURCE | REPORT_TOPLEVEL_ISSUES), "List[CodeParser`Library`MakeAbstractTopLevelFallbackNode[CodeParser`Library`MakeInfixNode[Plus, List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], , CodeParser`Library`MakeLeafNode[Token`Plus, +, 1213], CodeParser`Library`MakeLeafNode[Symbol, b, 1314], ], 1114], ], ] CodeParser`Library`MakeAbstractSource[1114]");
+    
+    EXPECT_EQ(abstractAndPrint("f[x]", INCLUDE_SOURCE | REPORT_TOPLEVEL_ISSUES), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeLeafNode[Symbol, f, 1112], List[CodeParser`Library`MakeLeafNode[Symbol, x, 1314], ], 1115], ] CodeParser`Library`MakeAbstractSource[1115]");
+}
+
+//
+// CompoundExpressions at top-level in files that give no issues
+//
+TEST_F(AbstractTest, TopLevelCompound) {
+    
+    EXPECT_EQ(abstractAndPrint("a=1;b=2;", INCLUDE_SOURCE | REPORT_TOPLEVEL_ISSUES), "List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, CompoundExpression], List[CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Set], List[CodeParser`Library`MakeLeafNode[Symbol, a, 1112], CodeParser`Library`MakeLeafNode[Integer, 1, 1314], ], 1114], CodeParser`Library`MakeCallNode[CodeParser`Library`MakeAbstractLeafNode[Symbol, Set], List[CodeParser`Library`MakeLeafNode[Symbol, b, 1516], CodeParser`Library`MakeLeafNode[Integer, 2, 1718], ], 1518], CodeParser`Library`MakeLeafNode[Symbol, Null, 1919], ], 1119], ] CodeParser`Library`MakeAbstractSource[1119]");
+    
+    EXPECT_EQ(abstractAndPrint("f[x];1+1", INCLUDE_SOURCE | REPORT_TOPLEVEL_ISSUES), "List[CodeParser`Library`MakeAbstractTopLevelFallbackNode[CodeParser`Library`MakeInfixNode[CompoundExpression, List[CodeParser`Library`MakeCallNode[List[CodeParser`Library`MakeLeafNode[Symbol, f, 1112], ], List[CodeParser`Library`MakeGroupNode[CodeParser`GroupSquare, List[CodeParser`Library`MakeLeafNode[Token`OpenSquare, [, 1213], CodeParser`Library`MakeLeafNode[Symbol, x, 1314], CodeParser`Library`MakeLeafNode[Token`CloseSquare, ], 1415], ], 1215], ], 1115], , CodeParser`Library`MakeLeafNode[Token`Semi, ;, 1516], CodeParser`Library`MakeInfixNode[Plus, List[CodeParser`Library`MakeLeafNode[Integer, 1, 1617], , CodeParser`Library`MakeLeafNode[Token`Plus, +, 1718], CodeParser`Library`MakeLeafNode[Integer, 1, 1819], ], 1619], ], 1119], ], ] CodeParser`Library`MakeAbstractSource[1119]");
+}
+
+TEST_F(AbstractTest, Empty) {
+    
+    EXPECT_EQ(abstractAndPrint(""), "List[] List[]");
+}
+
+//
+// Deep nodes are given to the kernel instead of overflowing the stack
+//
+TEST_F(AbstractTest, Deep) {
+    
+    std::string input = std::string(100000, '{') + std::string(100000, '}');
+    
+    auto str = reinterpret_cast<Buffer>(input.c_str());
+    
+    session->init(BufferAndLength(str, input.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session->abstractParseExpressions();
+    
+    EXPECT_NE(N, nullptr);
+    
+    session->releaseAllNodes();
+    
+    session->deinit();
+}
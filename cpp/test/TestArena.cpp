@@ -0,0 +1,155 @@
+
+#include "Arena.h"
+
+#include "API.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <vector>
+#include <string>
+
+class ArenaTest : public ::testing::Test {
+protected:
+
+};
+
+TEST_F(ArenaTest, Alignment) {
+    
+    Arena A;
+    
+    A.allocate(1, 1);
+    
+    auto p = A.allocate(sizeof(double), alignof(double));
+    
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(p) % alignof(double), 0u);
+}
+
+//
+// Large allocations get their own memory and do not use up chunks
+//
+TEST_F(ArenaTest, Large) {
+    
+    Arena A;
+    
+    A.allocate(64);
+    
+    auto capacity = A.getCapacity();
+    
+    auto p = static_cast<unsigned char *>(A.allocate(Arena::DEFAULT_CHUNK_SIZE * 2));
+    
+    p[Arena::DEFAULT_CHUNK_SIZE * 2 - 1] = 1;
+    
+    EXPECT_EQ(A.getCapacity(), capacity);
+    EXPECT_EQ(A.getChunkAllocationCount(), 2u);
+}
+
+//
+// Chunks are kept across resets
+//
+TEST_F(ArenaTest, Reuse) {
+    
+    Arena A;
+    
+    for (size_t i = 0; i < 3 * Arena::DEFAULT_CHUNK_SIZE / 64; i++) {
+        A.allocate(64);
+    }
+    
+    auto chunks = A.getChunkAllocationCount();
+    
+    EXPECT_GE(chunks, 3u);
+    
+    A.reset();
+    
+    for (size_t i = 0; i < 3 * Arena::DEFAULT_CHUNK_SIZE / 64; i++) {
+        A.allocate(64);
+    }
+    
+    EXPECT_EQ(A.getChunkAllocationCount(), chunks);
+}
+
+struct Counted {
+    
+    int *count;
+    
+    Counted(int *count) : count(count) {}
+    
+    ~Counted() {
+        (*count)++;
+    }
+};
+
+TEST_F(ArenaTest, Owned) {
+    
+    int count = 0;
+    
+    {
+        Arena A;
+        
+        A.make<Counted>(&count);
+        A.makeOwned<Counted>(&count);
+        A.makeOwned<Counted>(&count);
+        
+        A.reset();
+        
+        EXPECT_EQ(count, 2);
+        
+        A.makeOwned<Counted>(&count);
+    }
+    
+    EXPECT_EQ(count, 3);
+}
+
+//
+// The arena replaces a heap allocation for every node and sequence with a few chunks, and later parses reuse them
+//
+// Parsing and releasing are timed by the parseExpressions and releaseAllNodes benchmarks
+//
+TEST_F(ArenaTest, ParseAndRelease) {
+    
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/inputs-symbolicarithmetic.txt", std::ios::binary);
+    
+    auto file = std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    ASSERT_FALSE(file.empty());
+    
+    std::vector<unsigned char> bytes;
+    for (int i = 0; i < 10; i++) {
+        bytes.insert(bytes.end(), file.begin(), file.end());
+        bytes.push_back('\n');
+    }
+    
+    ParserSession session;
+    
+    const int iterations = 5;
+    
+    size_t firstChunks = 0;
+    
+    for (int i = 0; i < iterations; i++) {
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session.parseExpressions();
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+        if (i == 0) {
+            firstChunks = session.arena->getChunkAllocationCount();
+        }
+    }
+    
+    auto allocations = session.arena->getAllocationCount() / iterations;
+    auto chunks = session.arena->getChunkAllocationCount();
+    
+    //
+    // Every allocation in the arena used to be a separate call to new, and a separate call to delete when released
+    //
+    EXPECT_LT(firstChunks, allocations);
+    
+    //
+    // Later parses reuse the chunks from the first
+    //
+    EXPECT_EQ(chunks, firstChunks);
+}
@@ -7,16 +7,18 @@
 #include <sstream>
 
 
+static std::unique_ptr<ParserSession> session;
+
 class BufferAndLengthTest : public ::testing::Test {
 protected:
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -24,7 +26,7 @@ protected:
     }
     
     void TearDown() override {
-        TheParserSession->deinit();
+        session->deinit();
     }
 };
 
@@ -36,7 +38,7 @@ TEST_F(BufferAndLengthTest, Hang1) {
     // The actual test for the hang is with this buffer created to have length < 5.
     // But I have added an assert against that possibility, so this is no longer a direct test.
     //
-    TheParserSession->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
 
     auto bufLen = BufferAndLength(arr, 5, UTF8STATUS_INVALID);
 
@@ -7,18 +7,24 @@
 #include "gtest/gtest.h"
 
 #include <sstream>
+#include <fstream>
+#include <vector>
+#include <string>
+#include <utility>
 
 
+static std::unique_ptr<ParserSession> session;
+
 class ByteDecoderTest : public ::testing::Test {
 protected:
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -26,7 +32,7 @@ protected:
     }
     
     void TearDown() override {
-        TheParserSession->deinit();
+        session->deinit();
     }
 };
 
@@ -36,41 +42,41 @@ TEST_F(ByteDecoderTest, Basic1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('2'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 0u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 0u);
 }
 
 //
@@ -80,41 +86,41 @@ TEST_F(ByteDecoderTest, Basic2) {
     
     const unsigned char arr[] = {'1', '+', 206, 177};
     
-    TheParserSession->init(BufferAndLength(arr, 4), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 4), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(0x03b1));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 0u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 0u);
 }
 
 //
@@ -124,82 +130,82 @@ TEST_F(ByteDecoderTest, Basic3) {
     
     const unsigned char arr[] = {'1', '+', 0xE2, 0x9A, 0xA1};
     
-    TheParserSession->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(0x26A1));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 0u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 0u);
 }
 
 TEST_F(ByteDecoderTest, Invalid1) {
     
     const unsigned char arr[] = {'1', '+', 0xf8};
     
-    TheParserSession->init(BufferAndLength(arr, 3), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 3), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 1u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 1u);
 }
 
 //
@@ -211,41 +217,41 @@ TEST_F(ByteDecoderTest, Invalid2) {
     
     const unsigned char arr[] = {'1', '+', 206};
     
-    TheParserSession->init(BufferAndLength(arr, 3), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 3), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-//    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+//    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 1u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 1u);
 }
 
 //
@@ -255,42 +261,42 @@ TEST_F(ByteDecoderTest, Invalid3) {
     
     const unsigned char arr[] = {'1', '+', 0xE2};
     
-    TheParserSession->init(BufferAndLength(arr, 3), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 3), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0xE2 byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 1u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 1u);
 }
 
 //
@@ -300,50 +306,50 @@ TEST_F(ByteDecoderTest, Invalid4) {
     
     const unsigned char arr[] = {'1', '+', 0xE2, 0x9A};
     
-    TheParserSession->init(BufferAndLength(arr, 4), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 4), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0xE2 byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0x9A byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 2u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 2u);
 }
 
 //
@@ -353,63 +359,63 @@ TEST_F(ByteDecoderTest, Surrogate1) {
     
     const unsigned char arr[] = {'1', '+', 0xed, 0xa0, 0x80};
     
-    TheParserSession->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 0);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 0);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 1);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 1);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0xED byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 2);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 2);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0xA0 byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 3);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 3);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0x80 byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 4);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 4);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 5);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 5);
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 3u);
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 3u);
 }
 
 //
@@ -419,62 +425,166 @@ TEST_F(ByteDecoderTest, Surrogate2) {
     
     const unsigned char arr[] = {'1', '+', 0xed, 0xb0, 0x80};
     
-    TheParserSession->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    auto c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('1'));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 0);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 0);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter('+'));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 1);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 1);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0xED byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 2);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 2);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0xB0 byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 3);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 3);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     // from 0x80 byte
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_REPLACEMENT_CHARACTER));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 4);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 4);
     
-    //    TheByteDecoder->nextSourceCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheByteDecoder->lastBuf;
+    //    session->byteDecoder->nextSourceCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->byteDecoder->lastBuf;
     
-    c = TheByteDecoder->currentSourceCharacter(TOPLEVEL);
+    c = session->byteDecoder->currentSourceCharacter(TOPLEVEL);
     
     EXPECT_EQ(c, SourceCharacter(CODEPOINT_ENDOFFILE));
     
-    EXPECT_EQ(TheByteBuffer->buffer, arr + 5);
+    EXPECT_EQ(session->byteBuffer->buffer, arr + 5);
+    
+    EXPECT_EQ(session->byteDecoder->getIssues().size(), 3u);
+}
+
+//
+// Return how many characters listSourceCharacters gives for bytes, and where the decoder stopped
+//
+static std::pair<size_t, SourceLocation> listSourceCharactersEnd(const std::vector<unsigned char>& bytes, SourceConvention srcConvention) {
+        
+    session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, srcConvention, DEFAULT_TAB_WIDTH, false);
+        
+    auto N = session->listSourceCharacters();
+        
+    auto count = static_cast<ListNode *>(N)->getNodes().size();
+    
+    auto loc = session->byteDecoder->SrcLoc;
+    
+    session->releaseAllNodes();
+        
+    session->deinit();
+        
+    return std::make_pair(count, loc);
+}
+
+//
+// Each convention is decoded by its own specialization, and they must see the same characters
+//
+// Throughput under each convention is measured by the listSourceCharacters benchmarks
+//
+TEST_F(ByteDecoderTest, ListSourceCharactersConventions) {
+    
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/inputs-random.txt", std::ios::binary);
+    
+    auto bytes = std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    ASSERT_FALSE(bytes.empty());
     
-    EXPECT_EQ(TheByteDecoder->getIssues().size(), 3u);
+    auto lineColumn = listSourceCharactersEnd(bytes, SOURCECONVENTION_LINECOLUMN);
+    auto sourceCharacterIndex = listSourceCharactersEnd(bytes, SOURCECONVENTION_SOURCECHARACTERINDEX);
+    
+    EXPECT_GT(lineColumn.first, 0u);
+    EXPECT_EQ(lineColumn.first, sourceCharacterIndex.first);
+    
+    EXPECT_GT(lineColumn.second.first, 1u);
+    
+    //
+    // Every character is 1 index, except for \r\n which is 2
+    //
+    EXPECT_GE(sourceCharacterIndex.second.second, sourceCharacterIndex.first + 1);
 }
 
+static const std::vector<std::string> plainASCIICorpus = {
+    "comments.wl",
+    "inputs-characternamestrings.txt",
+    "inputs-random.txt",
+    "inputs-specialchararacters.txt",
+    "linearsyntax.wl",
+    "package.wl",
+    "script.wl",
+};
+
+//
+// The SIMD scan must stop at exactly the same byte as the scalar scan, from every starting offset
+//
+TEST_F(ByteDecoderTest, PlainASCIIEndMatchesScalar) {
+    
+    std::vector<std::vector<unsigned char>> inputs;
+    
+    for (auto& name : plainASCIICorpus) {
+        
+        std::ifstream in(std::string(TESTS_FILES_DIR) + "/" + name, std::ios::binary);
+        
+        inputs.push_back(std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>()));
+        
+        ASSERT_FALSE(inputs.back().empty()) << name;
+    }
+    
+    //
+    // Every byte value at every position of a block of 'a'
+    //
+    for (int b = 0; b < 256; b++) {
+        for (size_t pos = 0; pos < 40; pos++) {
+            
+            std::vector<unsigned char> bytes(40, 'a');
+            bytes[pos] = static_cast<unsigned char>(b);
+            
+            inputs.push_back(bytes);
+        }
+    }
+    
+    const std::vector<std::pair<unsigned char, unsigned char>> stops = { {'(', '*'}, {'"', '\\'} };
+    
+    for (auto& bytes : inputs) {
+        
+        auto e = bytes.data() + bytes.size();
+        
+        for (auto& s : stops) {
+            for (auto p = bytes.data(); p < e; p++) {
+                
+                auto expected = ByteBuffer::plainASCIIEnd_scalar(p, e, s.first, s.second);
+                
+                auto actual = ByteBuffer::plainASCIIEnd(p, e, s.first, s.second);
+                
+                ASSERT_EQ(actual - p, expected - p);
+            }
+        }
+    }
+}
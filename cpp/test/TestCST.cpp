@@ -0,0 +1,580 @@
+
+#include "CSTWriter.h"
+#include "CSTFormat.h"
+#include "API.h"
+#include "Symbol.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <fstream>
+#include <vector>
+#include <string>
+
+static const std::vector<std::string> corpus = {
+    "comments.wl",
+    "inputs-0001.txt",
+    "inputs-0002.txt",
+    "inputs-0003.txt",
+    "inputs-0004.txt",
+    "inputs-0005.txt",
+    "inputs-characternameoperations.txt",
+    "inputs-characternames.txt",
+    "inputs-characternamestrings.txt",
+    "inputs-contexts.txt",
+    "inputs-integers.txt",
+    "inputs-random.txt",
+    "inputs-reals.txt",
+    "inputs-specialchararacters.txt",
+    "inputs-symbolicarithmetic.txt",
+    "linearsyntax.wl",
+    "package.wl",
+    "script.wl",
+};
+
+static std::vector<unsigned char> readCorpusFile(const std::string& name) {
+    
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/" + name, std::ios::binary);
+    
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+//
+// Print a tree that was read back, the same way that Node::print prints the tree that was written
+//
+class CSTPrinter {
+    
+    const CSTReader& R;
+    std::ostream& s;
+    
+    void printSource(CSTSource Src) {
+        s << Src.Start.first << Src.Start.second << Src.End.first << Src.End.second;
+    }
+    
+    void printChildren(const CSTNode& N, uint32_t begin, uint32_t end) {
+        
+        s << "List[";
+        
+        for (auto i = begin; i < end; i++) {
+            printNode(R.child(N, i));
+            s << ", ";
+        }
+        
+        s << "]";
+    }
+    
+    void printIssue(const CSTIssue& I) {
+        
+        s << R.symbol(I.kind).str() << "[";
+        s << R.symbol(I.tag).str() << ", ";
+        s << R.string(I.message).str().c_str() << ", ";
+        s << R.symbol(I.severity).str() << ", ";
+        
+        printSource(I.src);
+        s << ", ";
+        
+        if (I.hasConfidence) {
+            s << I.confidence;
+            s << ", ";
+        }
+        
+        for (auto i = I.firstAction; i < I.firstAction + I.actionCount; i++) {
+            
+            auto& A = R.action(i);
+            
+            auto kind = R.symbol(A.kind).str();
+            
+            s << kind << "[";
+            s << R.string(A.label).str() << ", ";
+            
+            printSource(A.src);
+            s << ", ";
+            
+            if (kind != SYMBOL_CODEPARSER_LIBRARY_MAKEDELETETEXTCODEACTION->name() && kind != SYMBOL_CODEPARSER_LIBRARY_MAKEDELETETRIVIACODEACTION->name()) {
+                s << R.string(A.text).str() << ", ";
+            }
+            
+            s << "], ";
+        }
+        
+        s << "]";
+    }
+
+public:
+    
+    CSTPrinter(const CSTReader& R, std::ostream& s) : R(R), s(s) {}
+    
+    void printNode(const CSTNode& N) {
+        
+        const char *make = nullptr;
+        
+        switch (N.kind) {
+            case CSTNODEKIND_LEAF: make = SYMBOL_CODEPARSER_LIBRARY_MAKELEAFNODE->name(); break;
+            case CSTNODEKIND_ERROR: make = SYMBOL_CODEPARSER_LIBRARY_MAKEERRORNODE->name(); break;
+            case CSTNODEKIND_PREFIX: make = SYMBOL_CODEPARSER_LIBRARY_MAKEPREFIXNODE->name(); break;
+            case CSTNODEKIND_BINARY: make = SYMBOL_CODEPARSER_LIBRARY_MAKEBINARYNODE->name(); break;
+            case CSTNODEKIND_INFIX: make = SYMBOL_CODEPARSER_LIBRARY_MAKEINFIXNODE->name(); break;
+            case CSTNODEKIND_TERNARY: make = SYMBOL_CODEPARSER_LIBRARY_MAKETERNARYNODE->name(); break;
+            case CSTNODEKIND_POSTFIX: make = SYMBOL_CODEPARSER_LIBRARY_MAKEPOSTFIXNODE->name(); break;
+            case CSTNODEKIND_PREFIXBINARY: make = SYMBOL_CODEPARSER_LIBRARY_MAKEPREFIXBINARYNODE->name(); break;
+            case CSTNODEKIND_GROUP: make = SYMBOL_CODEPARSER_LIBRARY_MAKEGROUPNODE->name(); break;
+            case CSTNODEKIND_COMPOUND: make = SYMBOL_CODEPARSER_LIBRARY_MAKECOMPOUNDNODE->name(); break;
+            case CSTNODEKIND_GROUPMISSINGCLOSER: make = SYMBOL_CODEPARSER_LIBRARY_MAKEGROUPMISSINGCLOSERNODE->name(); break;
+            case CSTNODEKIND_UNTERMINATEDGROUP: make = SYMBOL_CODEPARSER_LIBRARY_MAKEUNTERMINATEDGROUPNODE->name(); break;
+            case CSTNODEKIND_CALL: make = SYMBOL_CODEPARSER_LIBRARY_MAKECALLNODE->name(); break;
+            case CSTNODEKIND_SYNTAXERROR: make = SYMBOL_CODEPARSER_LIBRARY_MAKESYNTAXERRORNODE->name(); break;
+            default: break;
+        }
+        
+        switch (N.kind) {
+            case CSTNODEKIND_LEAF: case CSTNODEKIND_ERROR: {
+                
+                s << make << "[";
+                s << R.symbol(N.symbol).str() << ", ";
+                s << R.text(N).str() << ", ";
+                
+                printSource(N.src);
+                
+                s << "]";
+            }
+                break;
+            case CSTNODEKIND_CALL: {
+                
+                s << make << "[";
+                
+                printChildren(N, 0, N.headCount);
+                s << ", ";
+                
+                printChildren(N, N.headCount, N.childCount);
+                s << ", ";
+                
+                printSource(N.src);
+                
+                s << "]";
+            }
+                break;
+            case CSTNODEKIND_SYNTAXERROR: {
+                
+                s << make << "[";
+                s << R.symbol(N.symbol).str() << ", ";
+                
+                printChildren(N, 0, N.childCount);
+                s << ", ";
+                
+                printSource(N.src);
+                s << ", ";
+                
+                s << "]";
+            }
+                break;
+            case CSTNODEKIND_LIST: {
+                
+                s << "List[";
+                
+                for (uint32_t i = 0; i < N.childCount; i++) {
+                    printNode(R.child(N, i));
+                    s << ", ";
+                }
+                
+                s << "]";
+            }
+                break;
+            case CSTNODEKIND_ISSUES: {
+                
+                s << "List[";
+                
+                for (auto i = N.firstChild; i < N.firstChild + N.childCount; i++) {
+                    printIssue(R.issue(i));
+                    s << ", ";
+                }
+                
+                s << "]";
+            }
+                break;
+            case CSTNODEKIND_SOURCELOCATIONS: {
+                
+                s << "List[";
+                
+                for (auto i = N.firstChild; i < N.firstChild + N.childCount; i++) {
+                    auto L = R.location(i);
+                    s << L.first << L.second;
+                    s << ", ";
+                }
+                
+                s << "]";
+            }
+                break;
+            case CSTNODEKIND_SOURCECHARACTER: case CSTNODEKIND_SAFESTRING: {
+                
+                //
+                // Not printed by these tests
+                //
+                assert(false);
+            }
+                break;
+            default: {
+                
+                s << make << "[";
+                s << R.symbol(N.symbol).str() << ", ";
+                
+                printChildren(N, 0, N.childCount);
+                s << ", ";
+                
+                printSource(N.src);
+                
+                s << "]";
+            }
+                break;
+        }
+    }
+};
+
+static std::unique_ptr<ParserSession> session;
+
+class CSTTest : public ::testing::Test {
+protected:
+    static void SetUpTestSuite() {
+        
+        session = std::unique_ptr<ParserSession>(new ParserSession());
+    }
+    
+    static void TearDownTestSuite() {
+        
+        session.reset(nullptr);
+    }
+    
+    void SetUp() override {
+        
+    }
+    
+    void TearDown() override {
+        
+    }
+};
+
+//
+// An empty LeafSeqNode or NodeSeqNode prints as an extra ", ", but it is not a node of its own when put or written
+//
+static std::string removeEmptySequences(const std::string& str) {
+    
+    std::string res;
+    res.reserve(str.size());
+    
+    for (size_t i = 0; i < str.size(); i++) {
+        
+        if (str.compare(i, 2, ", ") == 0 && (res.size() >= 2 && res.compare(res.size() - 2, 2, ", ") == 0)) {
+            i++;
+            continue;
+        }
+        
+        if (str.compare(i, 2, ", ") == 0 && (!res.empty() && res.back() == '[')) {
+            i++;
+            continue;
+        }
+        
+        res.push_back(str[i]);
+    }
+    
+    return res;
+}
+
+//
+// Print N, and write N and print what is read back
+//
+static void printBoth(Node *N, const std::vector<unsigned char>& bytes, std::string& printed, std::string& roundTripped) {
+    
+    std::ostringstream p;
+    
+    N->print(session.get(), p);
+    
+    printed = removeEmptySequences(p.str());
+    
+    std::ostringstream w;
+    
+    CSTWriter writer(session.get());
+    
+    writer.write(N, w);
+    
+    auto data = w.str();
+    
+    CSTReader reader;
+    
+    auto size = reader.read(reinterpret_cast<const unsigned char *>(data.data()), data.size(), bytes.data(), bytes.size());
+    
+    ASSERT_EQ(size, data.size());
+    
+    std::ostringstream r;
+    
+    CSTPrinter(reader, r).printNode(reader.root());
+    
+    roundTripped = removeEmptySequences(r.str());
+}
+
+//
+// Everything that is printed can be recovered from the binary tree and the input
+//
+TEST_F(CSTTest, RoundTrip) {
+    
+    for (auto& name : corpus) {
+        
+        auto bytes = readCorpusFile(name);
+        
+        session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session->parseExpressions();
+        
+        std::string printed;
+        std::string roundTripped;
+        
+        printBoth(N, bytes, printed, roundTripped);
+        
+        EXPECT_EQ(printed, roundTripped) << name;
+        
+        session->releaseAllNodes();
+        
+        session->deinit();
+    }
+}
+
+TEST_F(CSTTest, RoundTripTokens) {
+    
+    for (auto& name : corpus) {
+        
+        auto bytes = readCorpusFile(name);
+        
+        session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session->tokenize();
+        
+        std::string printed;
+        std::string roundTripped;
+        
+        printBoth(N, bytes, printed, roundTripped);
+        
+        EXPECT_EQ(printed, roundTripped) << name;
+        
+        session->releaseAllNodes();
+        
+        session->deinit();
+    }
+}
+
+//
+// Issues with code actions, invalid UTF-8, syntax errors, and unterminated groups
+//
+TEST_F(CSTTest, RoundTripErrors) {
+    
+    std::vector<std::string> inputs = {
+        "a ~ b",
+        "a /: b",
+        "f[1,,2]",
+        "{1, 2",
+        "\"abc",
+        "\\[Alpa] + \\[Alpha",
+        "a\xff b",
+        "a->-b",
+        "1 +\r\n 2",
+        "a::b::c::d",
+        "#\"a\" #a`b",
+        "f[x][[1]];; ;;",
+    };
+    
+    for (auto& input : inputs) {
+        
+        auto bytes = std::vector<unsigned char>(input.begin(), input.end());
+        
+        session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session->parseExpressions();
+        
+        std::string printed;
+        std::string roundTripped;
+        
+        printBoth(N, bytes, printed, roundTripped);
+        
+        EXPECT_EQ(printed, roundTripped) << input;
+        
+        session->releaseAllNodes();
+        
+        session->deinit();
+    }
+}
+
+//
+// Trees written one after another are read one after another
+//
+TEST_F(CSTTest, Stream) {
+    
+    auto input = std::string("a+b\nf[x]\n\n{1,2\n");
+    
+    auto bytes = std::vector<unsigned char>(input.begin(), input.end());
+    
+    CSTWriter writer(session.get());
+    
+    std::ostringstream w;
+    std::vector<std::string> printed;
+    
+    session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    while (auto N = session->nextTopLevelExpression()) {
+        
+        std::ostringstream p;
+        
+        N->print(session.get(), p);
+        
+        printed.push_back(removeEmptySequences(p.str()));
+        
+        writer.write(N, w);
+        
+        session->releaseAllNodes();
+    }
+    
+    session->deinit();
+    
+    auto data = w.str();
+    
+    auto p = reinterpret_cast<const unsigned char *>(data.data());
+    auto e = p + data.size();
+    
+    size_t count = 0;
+    
+    while (p < e) {
+        
+        CSTReader reader;
+        
+        auto size = reader.read(p, e - p, bytes.data(), bytes.size());
+        
+        ASSERT_GT(size, 0u);
+        ASSERT_LT(count, printed.size());
+        
+        std::ostringstream r;
+        
+        CSTPrinter(reader, r).printNode(reader.root());
+        
+        EXPECT_EQ(removeEmptySequences(r.str()), printed[count]);
+        
+        p += size;
+        count++;
+    }
+    
+    EXPECT_EQ(count, printed.size());
+}
+
+TEST_F(CSTTest, Invalid) {
+    
+    auto input = std::string("f[x, y] + 1");
+    
+    auto bytes = std::vector<unsigned char>(input.begin(), input.end());
+    
+    session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session->parseExpressions();
+    
+    std::ostringstream w;
+    
+    CSTWriter(session.get()).write(N, w);
+    
+    session->releaseAllNodes();
+    
+    session->deinit();
+    
+    auto data = w.str();
+    
+    //
+    // Copy to an address that is not aligned, so that the reader has to copy
+    //
+    auto unaligned = std::vector<unsigned char>(data.size() + 1);
+    std::copy(data.begin(), data.end(), unaligned.begin() + 1);
+    
+    CSTReader reader;
+    
+    EXPECT_EQ(reader.read(unaligned.data() + 1, data.size(), bytes.data(), bytes.size()), data.size());
+    
+    EXPECT_EQ(reader.read(unaligned.data() + 1, data.size() - 1, bytes.data(), bytes.size()), 0u);
+    
+    EXPECT_EQ(reader.read(unaligned.data() + 1, data.size(), bytes.data(), bytes.size() - 1), 0u);
+    
+    auto corrupt = data;
+    corrupt[0] = 'X';
+    
+    EXPECT_EQ(reader.read(reinterpret_cast<const unsigned char *>(corrupt.data()), corrupt.size(), nullptr, 0), 0u);
+    
+    //
+    // Point the first child of the root somewhere else
+    //
+    corrupt = data;
+    
+    CSTHeader H;
+    memcpy(&H, corrupt.data(), sizeof(CSTHeader));
+    
+    auto childrenOffset = sizeof(CSTHeader) + ((H.issueCount * sizeof(CSTIssue) + 7) & ~7) + ((H.nodeCount * sizeof(CSTNode) + 7) & ~7);
+    
+    uint32_t bad = H.nodeCount;
+    memcpy(&corrupt[childrenOffset], &bad, sizeof(uint32_t));
+    
+    EXPECT_EQ(reader.read(reinterpret_cast<const unsigned char *>(corrupt.data()), corrupt.size(), nullptr, 0), 0u);
+    
+    //
+    // Point a child back at its parent, which is in range but is a cycle
+    //
+    corrupt = data;
+    
+    auto nodesOffset = sizeof(CSTHeader) + ((H.issueCount * sizeof(CSTIssue) + 7) & ~7);
+    
+    auto found = false;
+    
+    for (uint32_t i = 0; i < H.nodeCount && !found; i++) {
+        
+        CSTNode C;
+        memcpy(&C, &corrupt[nodesOffset + i * sizeof(CSTNode)], sizeof(CSTNode));
+        
+        if (C.kind == CSTNODEKIND_ISSUES || C.kind == CSTNODEKIND_SOURCELOCATIONS || C.childCount == 0) {
+            continue;
+        }
+        
+        memcpy(&corrupt[childrenOffset + C.firstChild * sizeof(uint32_t)], &i, sizeof(uint32_t));
+        
+        found = true;
+    }
+    
+    ASSERT_TRUE(found);
+    
+    EXPECT_EQ(reader.read(reinterpret_cast<const unsigned char *>(corrupt.data()), corrupt.size(), nullptr, 0), 0u);
+}
+
+//
+// The binary tree is smaller than the printed tree
+//
+TEST_F(CSTTest, Size) {
+    
+    auto file = readCorpusFile("inputs-symbolicarithmetic.txt");
+    
+    ASSERT_FALSE(file.empty());
+    
+    std::vector<unsigned char> bytes;
+    for (int i = 0; i < 10; i++) {
+        bytes.insert(bytes.end(), file.begin(), file.end());
+        bytes.push_back('\n');
+    }
+    
+    session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session->parseExpressions();
+    
+    std::ostringstream p;
+    
+    N->print(session.get(), p);
+    
+    std::ostringstream w;
+    
+    CSTWriter(session.get()).write(N, w);
+    
+    session->releaseAllNodes();
+    
+    session->deinit();
+    
+    auto printed = p.str().size();
+    auto written = w.str().size();
+    
+    EXPECT_LT(written, printed);
+}
@@ -10,16 +10,18 @@
 #include <sstream>
 
 
+static std::unique_ptr<ParserSession> session;
+
 class CharacterDecoderTest : public ::testing::Test {
 protected:
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -27,7 +29,7 @@ protected:
     }
     
     void TearDown() override {
-        TheParserSession->deinit();
+        session->deinit();
     }
 };
 
@@ -37,30 +39,30 @@ TEST_F(CharacterDecoderTest, Basic1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('2'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -71,27 +73,27 @@ TEST_F(CharacterDecoderTest, LongName) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(0x03b1, ESCAPE_LONGNAME));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -102,30 +104,30 @@ TEST_F(CharacterDecoderTest, 4Hex) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(0x03b1, ESCAPE_4HEX));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -136,30 +138,30 @@ TEST_F(CharacterDecoderTest, 2Hex) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(242, ESCAPE_2HEX));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -170,30 +172,30 @@ TEST_F(CharacterDecoderTest, Octal) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(219, ESCAPE_OCTAL));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -204,30 +206,30 @@ TEST_F(CharacterDecoderTest, 6Hex) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(242, ESCAPE_6HEX));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -238,30 +240,30 @@ TEST_F(CharacterDecoderTest, Raw) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('^', ESCAPE_RAW));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -272,86 +274,86 @@ TEST_F(CharacterDecoderTest, LongNameError1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-//    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+//    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('\\'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('['));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('A'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('l'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('p'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('h'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('a'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('2'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -362,86 +364,86 @@ TEST_F(CharacterDecoderTest, LongNameError2) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('\\'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('['));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('A'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('l'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('p'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('a'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(']'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('2'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -452,72 +454,72 @@ TEST_F(CharacterDecoderTest, 4HexError1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('\\'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(':'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('0'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('3'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('b'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('+'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('1'));
     
-    //    TheCharacterDecoder->nextWLCharacter(TOPLEVEL);
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    //    session->characterDecoder->nextWLCharacter(TOPLEVEL);
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -528,41 +530,41 @@ TEST_F(CharacterDecoderTest, LineContinuation1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('a'));
     
-    EXPECT_EQ(TheCharacterDecoder->lastBuf, str + 1);
+    EXPECT_EQ(session->characterDecoder->lastBuf, str + 1);
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('b'));
     
-    EXPECT_EQ(TheCharacterDecoder->lastBuf, str + 2);
+    EXPECT_EQ(session->characterDecoder->lastBuf, str + 2);
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('c'));
     
-    EXPECT_EQ(TheCharacterDecoder->lastBuf, str + 5);
+    EXPECT_EQ(session->characterDecoder->lastBuf, str + 5);
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('d'));
     
-    EXPECT_EQ(TheCharacterDecoder->lastBuf, str + 6);
+    EXPECT_EQ(session->characterDecoder->lastBuf, str + 6);
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -573,33 +575,33 @@ TEST_F(CharacterDecoderTest, LineContinuation2) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('a'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('b'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('c'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('d'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -610,33 +612,33 @@ TEST_F(CharacterDecoderTest, LineContinuation3) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('a'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('b'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('c'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter('d'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(INSIDE_SYMBOL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, INSIDE_SYMBOL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
 }
@@ -650,31 +652,31 @@ TEST_F(CharacterDecoderTest, UnexpectedEscapeSequence) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('"'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(0x03b1, ESCAPE_LONGNAME));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter('"'));
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
     
-    c = TheCharacterDecoder->currentWLCharacter(TOPLEVEL);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, TOPLEVEL);
     
     EXPECT_EQ(c, WLCharacter(CODEPOINT_ENDOFFILE));
     
-    auto& Issues = TheCharacterDecoder->getIssues();
+    auto& Issues = session->characterDecoder->getIssues();
     
     EXPECT_EQ(Issues.size(), (size_t) 0);
 }
@@ -11,16 +11,18 @@
 #include <sstream>
 
 
+static std::unique_ptr<ParserSession> session;
+
 class CrashTest : public ::testing::Test {
 protected:
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -38,26 +40,26 @@ TEST_F(CrashTest, Crash0_characters) {
     
     auto bufAndLen = BufferAndLength(arr, 3);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
     auto policy = TOPLEVEL;
     
-    auto c = TheCharacterDecoder->currentWLCharacter(policy);
+    auto c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, policy);
     
     EXPECT_EQ(c.to_point(), '1');
     
-    EXPECT_EQ(TheCharacterDecoder->lastBuf, arr + 1);
-    EXPECT_EQ(TheCharacterDecoder->lastLoc, SourceLocation(1, 2));
+    EXPECT_EQ(session->characterDecoder->lastBuf, arr + 1);
+    EXPECT_EQ(session->characterDecoder->lastLoc, SourceLocation(1, 2));
     
     
-    TheByteBuffer->buffer = TheCharacterDecoder->lastBuf;
-    TheByteDecoder->SrcLoc = TheCharacterDecoder->lastLoc;
+    session->byteBuffer->buffer = session->characterDecoder->lastBuf;
+    session->byteDecoder->SrcLoc = session->characterDecoder->lastLoc;
     
-    c = TheCharacterDecoder->currentWLCharacter(policy);
+    c = session->characterDecoder->currentWLCharacter(session->byteBuffer->buffer, session->byteDecoder->SrcLoc, policy);
     
     EXPECT_EQ(c.to_point(), CODEPOINT_ENDOFFILE);
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -68,23 +70,23 @@ TEST_F(CrashTest, Crash0_tokens) {
     
     auto bufAndLen = BufferAndLength(arr, 3);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
     auto policy = TOPLEVEL;
     
-    auto Tok = TheTokenizer->currentToken(policy);
+    auto Tok = session->tokenizer->currentToken(policy);
     
     EXPECT_EQ(Tok.Tok.value(), TOKEN_INTEGER);
     EXPECT_EQ(Tok.Src, Source(SourceLocation(1, 1), SourceLocation(1, 2)));
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
     
-    Tok = TheTokenizer->currentToken(policy);
+    Tok = session->tokenizer->currentToken(policy);
     
     EXPECT_EQ(Tok.Tok.value(), TOKEN_ENDOFFILE);
     EXPECT_EQ(Tok.Src, Source(SourceLocation(1, 2), SourceLocation(2, 1)));
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -95,13 +97,13 @@ TEST_F(CrashTest, Crash1) {
     
     auto bufAndLen = BufferAndLength(arr, 7);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -116,13 +118,13 @@ TEST_F(CrashTest, StackOverflow1) {
     
     auto bufAndLen = BufferAndLength(arr, 1600);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -134,13 +136,13 @@ TEST_F(CrashTest, Crash2) {
     
     auto bufAndLen = BufferAndLength(arr, 6);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -151,13 +153,13 @@ TEST_F(CrashTest, Crash3) {
     
     auto bufAndLen = BufferAndLength(arr, 7);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -168,13 +170,13 @@ TEST_F(CrashTest, Crash4) {
     
     auto bufAndLen = BufferAndLength(arr, 17);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -185,13 +187,13 @@ TEST_F(CrashTest, Crash5) {
     
     auto bufAndLen = BufferAndLength(arr, 6);
     
-    TheParserSession->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_SOURCECHARACTERINDEX, DEFAULT_TAB_WIDTH);
+    session->init(bufAndLen, nullptr, INCLUDE_SOURCE, SOURCECONVENTION_SOURCECHARACTERINDEX, DEFAULT_TAB_WIDTH, false);
     
-    auto N = TheParserSession->parseExpressions();
+    auto N = session->parseExpressions();
     
-    TheParserSession->releaseNode(N);
+    session->releaseAllNodes();
     
-    TheParserSession->deinit();
+    session->deinit();
     
     SUCCEED();
 }
@@ -0,0 +1,147 @@
+#include "LongNames.h"
+
+#include "gtest/gtest.h"
+
+#include <fstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstring>
+
+class LongNamesTest : public ::testing::Test {
+protected:
+
+};
+
+static int findLongName(const std::string& name) {
+    return LongNames::findLongName(reinterpret_cast<const unsigned char *>(name.data()), name.size());
+}
+
+//
+// Every long name is found at its own index
+//
+TEST_F(LongNamesTest, AllNames) {
+    
+    for (size_t i = 0; i < LONGNAMES_COUNT; i++) {
+        EXPECT_EQ(findLongName(LongNameToCodePointMap_names[i]), static_cast<int>(i)) << LongNameToCodePointMap_names[i];
+    }
+}
+
+TEST_F(LongNamesTest, NotNames) {
+    
+    EXPECT_EQ(findLongName(""), -1);
+    EXPECT_EQ(findLongName("Alpa"), -1);
+    EXPECT_EQ(findLongName("alpha"), -1);
+    EXPECT_EQ(findLongName("Alphaa"), -1);
+    EXPECT_EQ(findLongName("Alph"), -1);
+    EXPECT_EQ(findLongName("RawAlpha"), -1);
+    EXPECT_EQ(findLongName(std::string("Alpha\0", 6)), -1);
+}
+
+TEST_F(LongNamesTest, Raw) {
+    
+    EXPECT_TRUE(LongNames::isRaw(LongNameToCodePointMap_points[findLongName("RawComma")]));
+    EXPECT_TRUE(LongNames::isRaw(LongNameToCodePointMap_points[findLongName("RawDoubleQuote")]));
+    EXPECT_FALSE(LongNames::isRaw(LongNameToCodePointMap_points[findLongName("Alpha")]));
+}
+
+//
+// Every long name has the class of its character category, and nothing else has a class except linear syntax
+//
+TEST_F(LongNamesTest, MBClass) {
+    
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_ALPHA), MBCLASS_NOTSTRANGELETTERLIKE);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_WOLF), 0);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_EQUAL), MBCLASS_PUNCTUATION);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_NONBREAKINGSPACE), MBCLASS_WHITESPACE);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_LINESEPARATOR), MBCLASS_NEWLINE);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_LEFTSKELETON), MBCLASS_UNINTERPRETABLE);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LONGNAME_INLINEPART), MBCLASS_UNSUPPORTED);
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_LINEARSYNTAX_BANG), MBCLASS_LINEARSYNTAX);
+    
+    EXPECT_EQ(LongNames::mbClass(CODEPOINT_STRINGMETA_TAB), 0);
+    EXPECT_EQ(LongNames::mbClass(0x10ffff), 0);
+    EXPECT_EQ(LongNames::mbClass(0x110000), 0);
+    
+    EXPECT_TRUE(LongNames::isMBNewline(CODEPOINT_CRLF));
+    
+    size_t count = 0;
+    
+    for (codepoint point = 0; point <= 0x10ffff; point++) {
+        if (LongNames::mbClass(point) != 0) {
+            count++;
+        }
+    }
+    
+    size_t expected = 12;
+    
+    for (size_t i = 0; i < LONGNAMES_COUNT; i++) {
+        
+        auto point = CodePointToLongNameMap_points[i];
+        
+        auto cls = LongNames::mbClass(point);
+        
+        if (cls != 0) {
+            expected++;
+        }
+        
+        //
+        // At most 1 of the character categories
+        //
+        auto category = cls & (MBCLASS_PUNCTUATION | MBCLASS_WHITESPACE | MBCLASS_NEWLINE | MBCLASS_UNINTERPRETABLE | MBCLASS_UNSUPPORTED);
+        
+        EXPECT_EQ(category & (category - 1), 0) << CodePointToLongNameMap_names[i];
+        
+        if (cls & MBCLASS_NOTSTRANGELETTERLIKE) {
+            EXPECT_EQ(category, 0) << CodePointToLongNameMap_names[i];
+        }
+    }
+    
+    EXPECT_EQ(count, expected);
+}
+
+//
+// The perfect hash agrees with the binary search over std::string that it replaced, for every long name in
+// Tests/files/inputs-characternames.txt
+//
+TEST_F(LongNamesTest, MatchesBinarySearch) {
+    
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/inputs-characternames.txt", std::ios::binary);
+    
+    auto bytes = std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    ASSERT_FALSE(bytes.empty());
+    
+    //
+    // The names between \[ and ]
+    //
+    std::vector<std::string> names;
+    
+    for (size_t i = 0; i + 2 < bytes.size(); i++) {
+        
+        if (bytes[i] != '\\' || bytes[i + 1] != '[') {
+            continue;
+        }
+        
+        auto start = i + 2;
+        auto end = start;
+        while (end < bytes.size() && bytes[end] != ']') {
+            end++;
+        }
+        
+        names.push_back(std::string(reinterpret_cast<const char *>(bytes.data() + start), end - start));
+        
+        i = end;
+    }
+    
+    ASSERT_FALSE(names.empty());
+    
+    for (auto& N : names) {
+    
+        auto it = std::lower_bound(LongNameToCodePointMap_names.begin(), LongNameToCodePointMap_names.end(), N);
+    
+        auto expected = (it != LongNameToCodePointMap_names.end() && *it == N) ? static_cast<int>(it - LongNameToCodePointMap_names.begin()) : -1;
+    
+        EXPECT_EQ(findLongName(N), expected) << N;
+    }
+}
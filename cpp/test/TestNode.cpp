@@ -1,6 +1,7 @@
 
 #include "Node.h"
 
+#include "API.h"
 #include "ByteDecoder.h"
 #include "ByteBuffer.h"
 #include "Source.h"
@@ -8,6 +9,7 @@
 #include "gtest/gtest.h"
 
 #include <sstream>
+#include <vector>
 
 class NodeTest : public ::testing::Test {
 protected:
@@ -16,29 +18,179 @@ protected:
 
 TEST_F(NodeTest, Bug1) {
 
-    NodeSeq Args;
-
     std::string input = "a_.";
     
-    TheByteBuffer = std::unique_ptr<ByteBuffer>(new ByteBuffer);
-    TheByteDecoder = std::unique_ptr<ByteDecoder>(new ByteDecoder);
+    auto session = std::unique_ptr<ParserSession>(new ParserSession);
+    
+    NodeSeq Args(session.get());
     
-    TheByteBuffer->init(BufferAndLength(Buffer(input.c_str() + 0), 3));
-    TheByteDecoder->init(SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->byteBuffer->init(BufferAndLength(Buffer(input.c_str() + 0), 3));
+    session->byteDecoder->init(SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
     
     auto T1 = Token(TOKEN_SYMBOL, BufferAndLength(Buffer(input.c_str() + 0), 1), Source(SourceLocation(1, 1), SourceLocation(1, 2)));
-    Args.append(std::unique_ptr<Node>(new LeafNode(T1)));
+    Args.append(NodePtr(session->arena->make<LeafNode>(T1)));
     
     auto T2 = Token(TOKEN_UNDERDOT, BufferAndLength(Buffer(input.c_str() + 1), 2), Source(SourceLocation(1, 2), SourceLocation(1, 4)));
-    Args.append(std::unique_ptr<Node>(new LeafNode(T2)));
+    Args.append(NodePtr(session->arena->make<LeafNode>(T2)));
 
-    auto N = std::unique_ptr<Node>(new CompoundNode(SYMBOL_CODEPARSER_PATTERNOPTIONALDEFAULT, std::move(Args)));
+    auto N = NodePtr(session->arena->make<CompoundNode>(SYMBOL_CODEPARSER_PATTERNOPTIONALDEFAULT, std::move(Args)));
 
     auto NSource = N->getSource();
 
     EXPECT_EQ(NSource.Start, SourceLocation(1, 1));
     EXPECT_EQ(NSource.End, SourceLocation(1, 4));
     
-    TheByteDecoder->deinit();
-    TheByteBuffer->deinit();
+    session->releaseAllNodes();
+    
+    session->byteDecoder->deinit();
+    session->byteBuffer->deinit();
+}
+
+//
+// Leaves only print their Source when it was asked for
+//
+TEST_F(NodeTest, LeafPrintPolicy) {
+    
+    std::string input = "a";
+    
+    auto session = std::unique_ptr<ParserSession>(new ParserSession);
+    
+    auto T = Token(TOKEN_SYMBOL, BufferAndLength(Buffer(input.c_str()), 1), Source(SourceLocation(1, 1), SourceLocation(1, 2)));
+    
+    auto N = session->arena->make<LeafNode>(T);
+    
+    std::ostringstream withSource;
+    
+    session->policy = INCLUDE_SOURCE;
+    
+    N->print(session.get(), withSource);
+    
+    EXPECT_EQ(withSource.str(), "CodeParser`Library`MakeLeafNode[Symbol, a, 1112]");
+    
+    std::ostringstream withoutSource;
+    
+    session->policy = 0;
+    
+    N->print(session.get(), withoutSource);
+    
+    EXPECT_EQ(withoutSource.str(), "CodeParser`Library`MakeLeafNode[Symbol, a]");
+    
+    session->releaseAllNodes();
+}
+
+//
+// A leaf that counts how many times its Source is asked for
+//
+class CountingLeafNode : public LeafNode {
+public:
+    
+    mutable size_t count;
+    
+    CountingLeafNode(Token& Tok) : LeafNode(Tok), count(0) {}
+    
+    Source getSource() const override {
+        
+        count++;
+        
+        return LeafNode::getSource();
+    }
+};
+
+//
+// Every level of  - - - ... a  has its Source, and it is computed once when the level is made
+//
+// Asking for it again, or printing, must not walk down to  a  from every level, which would be quadratic in the depth
+//
+// How long printing deep trees takes is measured by the print benchmark with the deep inputs
+//
+TEST_F(NodeTest, DeepNestingSourceIsStored) {
+    
+    const size_t depth = 4000;
+    
+    std::string input;
+    for (size_t i = 0; i < depth; i++) {
+        input += "- ";
+    }
+    input += "a";
+    
+    auto buf = reinterpret_cast<Buffer>(input.c_str());
+    
+    auto session = std::unique_ptr<ParserSession>(new ParserSession);
+    
+    session->policy = INCLUDE_SOURCE;
+    
+    auto col = static_cast<uint32_t>(2 * depth + 1);
+    
+    auto A = Token(TOKEN_SYMBOL, BufferAndLength(buf + 2 * depth, 1), Source(SourceLocation(1, col), SourceLocation(1, col + 1)));
+    
+    auto Leaf = session->arena->make<CountingLeafNode>(A);
+    
+    std::vector<Node *> levels;
+    
+    Node *N = Leaf;
+    
+    for (size_t i = depth; i > 0; i--) {
+        
+        col = static_cast<uint32_t>(2 * (i - 1) + 1);
+        
+        auto Minus = Token(TOKEN_MINUS, BufferAndLength(buf + 2 * (i - 1), 1), Source(SourceLocation(1, col), SourceLocation(1, col + 1)));
+        
+        NodeSeq Args(session.get());
+        
+        Args.append(NodePtr(session->arena->make<LeafNode>(Minus)));
+        Args.append(NodePtr(N));
+        
+        N = session->arena->make<PrefixNode>(SYMBOL_MINUS, std::move(Args));
+        
+        levels.push_back(N);
+    }
+    
+    EXPECT_EQ(Leaf->count, 1u);
+    
+    for (auto L : levels) {
+        EXPECT_EQ(L->getSource().End, SourceLocation(1, static_cast<uint32_t>(2 * depth + 2)));
+    }
+        
+    std::ostringstream s;
+        
+    N->print(session.get(), s);
+        
+    EXPECT_EQ(Leaf->count, 1u);
+        
+    session->releaseAllNodes();
+}
+
+#if USE_EXPR_LIB
+//
+// Expr_BuildExpr releases its head with the expression, so a head that is used twice must not be the session's symbol
+//
+// Building and releasing the tree twice releases the cached symbols twice if it is
+//
+TEST_F(NodeTest, ToExprRepeatedHead) {
+    
+    std::string input = "f[f[x]]";
+    
+    auto session = std::unique_ptr<ParserSession>(new ParserSession);
+    
+    for (auto i = 0; i < 2; i++) {
+        
+        session->init(BufferAndLength(Buffer(input.c_str()), input.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session->parseExpressions();
+        
+        ExprBuilder B(session.get());
+        
+        N->toExpr(session.get(), B);
+        
+        auto e = B.get();
+        
+        ASSERT_NE(e, nullptr);
+        
+        Expr_Release(e);
+        
+        session->releaseAllNodes();
+        
+        session->deinit();
+    }
 }
+#endif // USE_EXPR_LIB
@@ -11,17 +11,19 @@
 
 
 
+static std::unique_ptr<ParserSession> session;
+
 class ParseletTest : public ::testing::Test {
 protected:
     
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -29,7 +31,7 @@ protected:
     }
     
     void TearDown() override {
-        TheParserSession->deinit();
+        session->deinit();
     }
 
 };
@@ -40,13 +42,13 @@ TEST_F(ParseletTest, Bug1) {
     
     auto str = reinterpret_cast<const unsigned char *>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     ParserContext Ctxt;
     
-    auto NP = prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    auto NP = session->parser->parse(prefixParselets[Tok.Tok.value()], Tok, Ctxt);
     
     auto N = NP.get();
     
@@ -62,13 +64,13 @@ TEST_F(ParseletTest, Bug2) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     ParserContext Ctxt;
     
-    prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    session->parser->parse(prefixParselets[Tok.Tok.value()], Tok, Ctxt);
     
     SUCCEED();
 }
@@ -82,13 +84,13 @@ TEST_F(ParseletTest, Bug3) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     ParserContext Ctxt;
     
-    prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    session->parser->parse(prefixParselets[Tok.Tok.value()], Tok, Ctxt);
     
     SUCCEED();
 }
@@ -102,13 +104,106 @@ TEST_F(ParseletTest, Bug4) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     ParserContext Ctxt;
     
-    prefixParselets[Tok.Tok.value()]->parse(Tok, Ctxt);
+    session->parser->parse(prefixParselets[Tok.Tok.value()], Tok, Ctxt);
     
     SUCCEED();
 }
+
+//
+// This used to give  +x  twice: Integral read the trivia after its operand again only after the infix loop had
+// already parsed  +x
+//
+TEST_F(ParseletTest, IntegralTrailingTrivia) {
+    
+    auto strIn = std::string("\\[Integral]f +x");
+    
+    auto str = reinterpret_cast<Buffer>(strIn.c_str());
+    
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session->parseExpressions();
+    
+    std::ostringstream s;
+    
+    N->print(session.get(), s);
+    
+    session->releaseAllNodes();
+    
+    EXPECT_EQ(s.str(), "List[List["
+        "CodeParser`Library`MakeInfixNode[Plus, List["
+            "CodeParser`Library`MakePrefixNode[Integral, List["
+                "CodeParser`Library`MakeLeafNode[Token`LongName`Integral, \\[Integral], 11112], "
+                "CodeParser`Library`MakeLeafNode[Symbol, f, 112113], ], 11113], "
+            "CodeParser`Library`MakeLeafNode[Whitespace,  , 113114], , , "
+            "CodeParser`Library`MakeLeafNode[Token`Plus, +, 114115], "
+            "CodeParser`Library`MakeLeafNode[Symbol, x, 115116], ], 11116], ], "
+        "List[], List[], List[], List[], List[], ]");
+}
+
+static std::string parseAndPrint(const std::string& strIn, SourceConvention srcConvention = SOURCECONVENTION_LINECOLUMN) {
+    
+    auto str = reinterpret_cast<Buffer>(strIn.c_str());
+    
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, srcConvention, DEFAULT_TAB_WIDTH, false);
+    
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
+    
+    ParserContext Ctxt;
+    
+    auto NP = session->parser->parse(prefixParselets[Tok.Tok.value()], Tok, Ctxt);
+    
+    std::ostringstream s;
+    
+    NP->print(session.get(), s);
+    
+    return s.str();
+}
+
+//
+// Only the leaves up to the end of the first chunk of lines are kept
+//
+TEST_F(ParseletTest, UnterminatedGroup) {
+    
+    EXPECT_EQ(parseAndPrint("{a,\n\nb = 1\n"), "CodeParser`Library`MakeUnterminatedGroupNode[List, List[CodeParser`Library`MakeLeafNode[Token`OpenCurly, {, 1112], CodeParser`Library`MakeLeafNode[Symbol, a, 1213], CodeParser`Library`MakeLeafNode[Token`Comma, ,, 1314], ], 1114]");
+    
+    EXPECT_EQ(parseAndPrint("f[x,\n\ty\n\nBegin[\"`Private`\"]"), "CodeParser`Library`MakeCallNode[List[CodeParser`Library`MakeLeafNode[Symbol, f, 1112], ], List[CodeParser`Library`MakeUnterminatedGroupNode[CodeParser`GroupSquare, List[CodeParser`Library`MakeLeafNode[Token`OpenSquare, [, 1213], CodeParser`Library`MakeLeafNode[Symbol, x, 1314], CodeParser`Library`MakeLeafNode[Token`Comma, ,, 1415], CodeParser`Library`MakeLeafNode[Token`Newline, , 1521], CodeParser`Library`MakeLeafNode[Whitespace, \t, 2125], CodeParser`Library`MakeLeafNode[Symbol, y, 2526], CodeParser`Library`MakeLeafNode[Token`Fake`ImplicitTimes, , 2626], ], 1226], ], 1126]");
+}
+
+TEST_F(ParseletTest, UnterminatedToken) {
+    
+    EXPECT_EQ(parseAndPrint("\"abc\nd\nx := 1"), "CodeParser`Library`MakeErrorNode[Token`Error`UnterminatedString, \"abc\nd, 1122]");
+    
+    EXPECT_EQ(parseAndPrint("\"abc\r\nd\r\nx := 1", SOURCECONVENTION_SOURCECHARACTERINDEX), "CodeParser`Library`MakeErrorNode[Token`Error`UnterminatedString, \"abc\r\nd, 0108]");
+}
+
+//
+// Bytes that are not valid UTF-8 are 1 column each, the same as the decoder counts them
+//
+TEST_F(ParseletTest, UnterminatedTokenInvalidUTF8) {
+    
+    EXPECT_EQ(parseAndPrint("\"a\xC0\x80\nx := 1"), "CodeParser`Library`MakeErrorNode[Token`Error`UnterminatedString, \"a\xEF\xBF\xBD\xEF\xBF\xBD, 1115]");
+    
+    EXPECT_EQ(parseAndPrint("\"a\xC3\xA9\xE2\x82\nx := 1"), "CodeParser`Library`MakeErrorNode[Token`Error`UnterminatedString, \"a\xC3\xA9\xEF\xBF\xBD\xEF\xBF\xBD, 1116]");
+}
+
+//
+// Openers on separate lines of the same chunk are recovered with one scan
+//
+TEST_F(ParseletTest, UnterminatedGroupManyLines) {
+    
+    std::string strIn;
+    
+    for (auto i = 0; i < 2000; i++) {
+        strIn += "f[\n";
+    }
+    
+    parseAndPrint(strIn);
+    
+    EXPECT_EQ(session->tokenizer->getRecoverScanCount(), 1u);
+}
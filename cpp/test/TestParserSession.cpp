@@ -0,0 +1,956 @@
+#include "API.h"
+
+#include "gtest/gtest.h"
+
+#include <sstream>
+#include <fstream>
+#include <thread>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <type_traits>
+#include <random>
+
+static const std::vector<std::string> corpus = {
+    "comments.wl",
+    "inputs-0001.txt",
+    "inputs-0002.txt",
+    "inputs-0003.txt",
+    "inputs-0004.txt",
+    "inputs-0005.txt",
+    "inputs-characternameoperations.txt",
+    "inputs-characternames.txt",
+    "inputs-characternamestrings.txt",
+    "inputs-contexts.txt",
+    "inputs-integers.txt",
+    "inputs-nestedsymbolicarithmetic.txt",
+    "inputs-random.txt",
+    "inputs-reals.txt",
+    "inputs-specialchararacters.txt",
+    "inputs-symbolicarithmetic.txt",
+    "inputs-symbolicarithmetic2.txt",
+    "inputs-symbolicarithmetic3.txt",
+    "inputs-symbolicarithmetic4.txt",
+    "linearsyntax.wl",
+    "package.wl",
+    "script.wl",
+    "stackoverflow1.txt",
+    "stackoverflow2.txt",
+    "stackoverflow3.txt",
+};
+
+static std::vector<unsigned char> readCorpusFile(const std::string& name) {
+
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/" + name, std::ios::binary);
+
+    return std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+}
+
+//
+// Parse and print with the given session
+//
+static std::string parseAndPrint(ParserSession& session, const std::vector<unsigned char>& bytes) {
+
+    std::ostringstream s;
+
+    session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+
+    auto N = session.parseExpressions();
+
+    N->print(&session, s);
+
+    session.releaseAllNodes();
+
+    session.deinit();
+
+    return s.str();
+}
+
+//
+// Print every expression, issue, and location of a List[CollectedExpressions, CollectedIssues, ...] on its own line
+//
+// Appends to exprs and outOfBand, so that the results of several calls can be compared with the result of one
+//
+static void printParts(ParserSession& session, Node *N, std::vector<std::string>& exprs, std::vector<std::vector<std::string>>& outOfBand) {
+    
+    auto& nodes = dynamic_cast<ListNode *>(N)->getNodes();
+    
+    for (auto& E : dynamic_cast<const CollectedExpressionsNode&>(*nodes[0]).getExpressions()) {
+        
+        std::ostringstream s;
+        
+        E->print(&session, s);
+        
+        exprs.push_back(s.str());
+    }
+    
+    outOfBand.resize(nodes.size() - 1);
+    
+    for (auto& I : dynamic_cast<const CollectedIssuesNode&>(*nodes[1]).getIssues()) {
+        
+        std::ostringstream s;
+        
+        I.print(s);
+        
+        outOfBand[0].push_back(s.str());
+    }
+    
+    for (size_t i = 2; i < nodes.size(); i++) {
+        for (auto& L : dynamic_cast<const CollectedSourceLocationsNode&>(*nodes[i]).getSourceLocations()) {
+            
+            std::ostringstream s;
+            
+            L.print(s);
+            
+            outOfBand[i - 1].push_back(s.str());
+        }
+    }
+}
+
+class ParserSessionTest : public ::testing::Test {
+protected:
+
+    static std::vector<std::vector<unsigned char>> inputs;
+
+    static void SetUpTestSuite() {
+
+        for (auto& name : corpus) {
+            inputs.push_back(readCorpusFile(name));
+        }
+    }
+
+    static void TearDownTestSuite() {
+
+        inputs.clear();
+    }
+};
+
+std::vector<std::vector<unsigned char>> ParserSessionTest::inputs;
+
+//
+// Independent sessions on different threads must produce exactly the same output as a single session run serially
+//
+TEST_F(ParserSessionTest, ParallelMatchesSerial) {
+
+    for (auto& bytes : inputs) {
+        ASSERT_FALSE(bytes.empty());
+    }
+
+    std::vector<std::string> serial;
+    {
+        ParserSession session;
+
+        for (auto& bytes : inputs) {
+            serial.push_back(parseAndPrint(session, bytes));
+        }
+    }
+
+    const size_t threadCount = 8;
+
+    std::vector<std::vector<std::string>> parallel(threadCount, std::vector<std::string>(inputs.size()));
+
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < threadCount; t++) {
+
+        threads.push_back(std::thread([t, &parallel]() {
+
+            ParserSession session;
+
+            //
+            // Every thread parses the whole corpus, each starting at a different file
+            //
+            for (size_t i = 0; i < inputs.size(); i++) {
+
+                auto idx = (i + t) % inputs.size();
+
+                parallel[t][idx] = parseAndPrint(session, inputs[idx]);
+            }
+        }));
+    }
+
+    for (auto& th : threads) {
+        th.join();
+    }
+
+    for (size_t t = 0; t < threadCount; t++) {
+        for (size_t i = 0; i < inputs.size(); i++) {
+            EXPECT_EQ(parallel[t][i], serial[i]) << corpus[i] << " differs on thread " << t;
+        }
+    }
+}
+
+//
+// A pool must give the same nodes, in input order, as a single session run serially
+//
+TEST_F(ParserSessionTest, PoolMatchesSerial) {
+    
+    std::vector<BufferAndLength> bufs;
+    for (auto& bytes : inputs) {
+        bufs.push_back(BufferAndLength(bytes.data(), bytes.size()));
+    }
+    
+    std::vector<std::string> serial;
+    {
+        ParserSession session;
+        
+        for (auto& bytes : inputs) {
+            serial.push_back(parseAndPrint(session, bytes));
+        }
+    }
+    
+    auto threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    
+    ParserSessionPool pool(threadCount);
+    
+    pool.run(bufs, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false, &ParserSession::parseExpressions, nullptr);
+    
+    std::vector<std::string> pooled;
+    for (size_t i = 0; i < inputs.size(); i++) {
+        
+        std::ostringstream s;
+        
+        pool.node(i)->print(pool.session(i), s);
+        
+        pooled.push_back(s.str());
+    }
+    
+    pool.release();
+    
+    for (size_t i = 0; i < inputs.size(); i++) {
+        EXPECT_EQ(pooled[i], serial[i]) << corpus[i] << " differs";
+    }
+}
+    
+//
+// Workers have no libData, so the pool reports the inputs that wanted a long name suggestion, and the caller parses
+// them again with libData
+//
+TEST_F(ParserSessionTest, PoolMissedSuggestion) {
+    
+    std::string unknown = "\\[Alpa]";
+    std::string known = "\\[Alpha]";
+    
+    std::vector<BufferAndLength> bufs = {
+        BufferAndLength(reinterpret_cast<Buffer>(unknown.data()), unknown.size()),
+        BufferAndLength(reinterpret_cast<Buffer>(known.data()), known.size()),
+    };
+    
+    ParserSessionPool pool(2);
+    
+    pool.run(bufs, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false, &ParserSession::parseExpressions, nullptr);
+    
+    EXPECT_TRUE(pool.missedSuggestion(0));
+    EXPECT_FALSE(pool.missedSuggestion(1));
+    
+    pool.run(bufs, INCLUDE_SOURCE | SKIP_LONG_NAME_SUGGESTIONS, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false, &ParserSession::parseExpressions, nullptr);
+    
+    EXPECT_FALSE(pool.missedSuggestion(0));
+    
+    pool.release();
+}
+
+//
+// Every line of the input has the same 4 issues at different places
+//
+// The collected issues must come out sorted, without duplicates from tokens that were lexed more than once
+//
+TEST_F(ParserSessionTest, IssueHeavy) {
+    
+    const size_t lines = 20000;
+    
+    std::string str;
+    for (size_t i = 0; i < lines; i++) {
+        str += "x\\[DiscretionaryHyphen]y" + std::to_string(i) + " + \"a\x01" "b\" \\:0001 c\n";
+    }
+    
+    auto bytes = std::vector<unsigned char>(str.begin(), str.end());
+    
+    ParserSession session;
+    
+    session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session.parseExpressions();
+    
+    //
+    // parseExpressions returns List[exprs, issues, ...]
+    //
+    auto& Issues = dynamic_cast<const CollectedIssuesNode&>(*dynamic_cast<ListNode *>(N)->getNodes()[1]).getIssues();
+    
+    std::vector<SourceLocation> issueLocs;
+    for (auto& I : Issues) {
+        issueLocs.push_back(I.getSource().Start);
+    }
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    EXPECT_EQ(issueLocs.size(), 4 * lines);
+    
+    EXPECT_TRUE(std::is_sorted(issueLocs.begin(), issueLocs.end()));
+}
+
+//
+// Issues only keep a few enums, a character, and slices of the input
+//
+// The messages and actions are formatted from them when asked for
+//
+TEST_F(ParserSessionTest, IssueMessages) {
+    
+    EXPECT_TRUE(std::is_trivially_copyable<Issue>::value);
+    
+    std::string str = "\\[Alpa] \\:00z1 x\\[DiscretionaryHyphen]y \\Q";
+    
+    auto bytes = std::vector<unsigned char>(str.begin(), str.end());
+    
+    ParserSession session;
+    
+    session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session.parseExpressions();
+    
+    auto& Issues = dynamic_cast<const CollectedIssuesNode&>(*dynamic_cast<ListNode *>(N)->getNodes()[1]).getIssues();
+    
+    std::vector<std::string> messages;
+    std::vector<size_t> actionCounts;
+    for (auto& I : Issues) {
+        messages.push_back(I.getMessage());
+        actionCounts.push_back(I.getActions().size());
+    }
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    ASSERT_EQ(messages.size(), 4u);
+    
+    EXPECT_EQ(messages[0], "Unrecognized character: ``\\[Alpa]``.");
+    EXPECT_EQ(messages[1], "Unrecognized character: ``\\:00``.");
+    EXPECT_EQ(messages[2], "Unexpected letterlike character: ``\\[DiscretionaryHyphen]``.");
+    EXPECT_EQ(messages[3], "Unrecognized character ``\\Q``.");
+    
+    //
+    // No suggestion without a kernel
+    //
+    EXPECT_EQ(actionCounts[0], 0u);
+    EXPECT_EQ(actionCounts[1], 1u);
+    EXPECT_EQ(actionCounts[2], 0u);
+    EXPECT_EQ(actionCounts[3], 1u);
+}
+
+//
+// Parsing one top-level expression at a time must give the same expressions, issues, and locations as parsing the
+// whole input at once
+//
+TEST_F(ParserSessionTest, StreamMatchesWhole) {
+    
+    ParserSession session;
+    
+    for (size_t i = 0; i < inputs.size(); i++) {
+        
+        auto& bytes = inputs[i];
+        
+        std::vector<std::string> wholeExprs;
+        std::vector<std::vector<std::string>> wholeOutOfBand;
+        {
+            session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+            
+            auto N = session.parseExpressions();
+            
+            printParts(session, N, wholeExprs, wholeOutOfBand);
+            
+            session.releaseAllNodes();
+            
+            session.deinit();
+        }
+        
+        std::vector<std::string> streamExprs;
+        std::vector<std::vector<std::string>> streamOutOfBand;
+        {
+            session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+            
+            while (auto N = session.nextTopLevelExpression()) {
+                
+                printParts(session, N, streamExprs, streamOutOfBand);
+                
+                //
+                // Each expression is released before the next is parsed
+                //
+                session.releaseAllNodes();
+            }
+            
+            session.deinit();
+        }
+        
+        EXPECT_EQ(streamExprs, wholeExprs) << corpus[i];
+        EXPECT_EQ(streamOutOfBand, wholeOutOfBand) << corpus[i];
+    }
+}
+
+//
+// An empty input may have a null buffer, and must not be confused with what was peeked at in the previous input
+//
+TEST_F(ParserSessionTest, EmptyAfterNonEmpty) {
+    
+    ParserSession session;
+    
+    auto first = parseAndPrint(session, inputs[0]);
+    
+    EXPECT_NE(first, "List[List[], List[], List[], List[], List[], List[], ]");
+    
+    std::ostringstream s;
+    
+    session.init(BufferAndLength(nullptr, 0), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session.parseExpressions();
+    
+    N->print(&session, s);
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    EXPECT_EQ(s.str(), "List[List[], List[], List[], List[], List[], List[], ]");
+}
+
+//
+// Nesting depth is limited only by memory: parsing, printing, and checking must not use the native stack for each
+// level
+//
+TEST_F(ParserSessionTest, DeepNesting) {
+    
+    static const size_t depth = 200000;
+    
+    static const std::vector<std::pair<std::string, std::string>> shapes = {
+        { "(", ")" },
+        { "{", "}" },
+        { "f[", "]" },
+        { "a[[", "]]" },
+        { "- ", "" },
+        { "a=", "" },
+    };
+    
+    ParserSession session;
+    
+    for (auto& shape : shapes) {
+        
+        std::string str;
+        
+        for (size_t i = 0; i < depth; i++) {
+            str += shape.first;
+        }
+        
+        str += "x";
+        
+        for (size_t i = 0; i < depth; i++) {
+            str += shape.second;
+        }
+        
+        std::vector<std::string> exprs;
+        std::vector<std::vector<std::string>> outOfBand;
+        
+        session.init(BufferAndLength(reinterpret_cast<Buffer>(str.data()), str.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session.parseExpressions();
+        
+        auto& E = dynamic_cast<const CollectedExpressionsNode&>(*dynamic_cast<ListNode *>(N)->getNodes()[0]).getExpressions();
+        
+        ASSERT_EQ(E.size(), 1u) << shape.first;
+        
+        EXPECT_TRUE(E[0]->check()) << shape.first;
+        
+        printParts(session, N, exprs, outOfBand);
+        
+        EXPECT_TRUE(outOfBand[0].empty()) << shape.first;
+        
+        EXPECT_NE(exprs[0].find("Symbol, x, "), std::string::npos) << shape.first;
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+    }
+}
+
+//
+// Print the parts of a fresh parse of bytes
+//
+static void parseParts(ParserSession& session, const std::vector<unsigned char>& bytes, SourceConvention srcConvention, std::vector<std::string>& exprs, std::vector<std::vector<std::string>>& outOfBand) {
+    
+    session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, srcConvention, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session.parseExpressions();
+    
+    printParts(session, N, exprs, outOfBand);
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+}
+
+//
+// After every edit, an incremental session must give the same expressions, issues, and locations as parsing the
+// edited text from scratch
+//
+// The edits are random, and insert text that changes how the following lines are parsed, such as the start of a
+// comment or a string, or a \n after a \r
+//
+TEST_F(ParserSessionTest, IncrementalMatchesWhole) {
+    
+    static const std::vector<std::string> snippets = {
+        "\n", "\r", "\r\n", " ", "\t", "(*", "*)", "\"", "[", "]", "{", "}", "\\\n", "\\[Alpha]", "\\[Alpa]",
+        "f[x]", "a + b\n", "x_.\n", "::", "#!", "\x80", "1.5`",
+    };
+    
+    std::mt19937 gen(1234);
+    
+    ParserSession whole;
+    
+    for (auto srcConvention : { SOURCECONVENTION_LINECOLUMN, SOURCECONVENTION_SOURCECHARACTERINDEX }) {
+        
+        for (size_t i = 0; i < inputs.size(); i++) {
+            
+            auto bytes = inputs[i];
+            
+            IncrementalParserSession incremental;
+            
+            incremental.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, srcConvention, DEFAULT_TAB_WIDTH, false);
+            
+            for (size_t e = 0; e < 10; e++) {
+                
+                auto off = std::uniform_int_distribution<size_t>(0, bytes.size())(gen);
+                auto removed = std::uniform_int_distribution<size_t>(0, std::min<size_t>(bytes.size() - off, 8))(gen);
+                
+                std::string inserted;
+                if (e % 2 == 0) {
+                    inserted = snippets[std::uniform_int_distribution<size_t>(0, snippets.size() - 1)(gen)];
+                } else if (!bytes.empty()) {
+                    //
+                    // Some text from elsewhere in the input
+                    //
+                    auto from = std::uniform_int_distribution<size_t>(0, bytes.size() - 1)(gen);
+                    inserted = std::string(bytes.begin() + from, bytes.begin() + std::min(bytes.size(), from + 20));
+                }
+                
+                bytes.erase(bytes.begin() + off, bytes.begin() + off + removed);
+                bytes.insert(bytes.begin() + off, inserted.begin(), inserted.end());
+                
+                ASSERT_TRUE(incremental.edit(off, removed, BufferAndLength(reinterpret_cast<Buffer>(inserted.data()), inserted.size())));
+                
+                std::vector<std::string> incrementalExprs;
+                std::vector<std::vector<std::string>> incrementalOutOfBand;
+                
+                printParts(*incremental.getSession(), incremental.parseExpressions(), incrementalExprs, incrementalOutOfBand);
+                
+                std::vector<std::string> wholeExprs;
+                std::vector<std::vector<std::string>> wholeOutOfBand;
+                
+                parseParts(whole, bytes, srcConvention, wholeExprs, wholeOutOfBand);
+                
+                ASSERT_EQ(incrementalExprs, wholeExprs) << corpus[i] << " edit " << e << " at " << off << " removing " << removed << " inserting " << inserted;
+                ASSERT_EQ(incrementalOutOfBand, wholeOutOfBand) << corpus[i] << " edit " << e << " at " << off << " removing " << removed << " inserting " << inserted;
+            }
+            
+            incremental.deinit();
+        }
+    }
+    
+    //
+    // An edit outside of the text
+    //
+    IncrementalParserSession empty;
+    
+    empty.init(BufferAndLength(), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    EXPECT_FALSE(empty.edit(1, 0, BufferAndLength()));
+    EXPECT_TRUE(empty.edit(0, 0, BufferAndLength()));
+    
+    empty.deinit();
+}
+
+//
+// Typing into the middle of a large package only parses the lines around the edit
+//
+TEST_F(ParserSessionTest, IncrementalKeystrokes) {
+    
+    const size_t lines = 10000;
+    
+    std::string str = "BeginPackage[\"Foo`\"]\n\n";
+    for (size_t i = 0; i < lines; i++) {
+        str += "f" + std::to_string(i) + "[x_, y_:1] := Module[{z = x + y}, (* comment *) g[z, \"str\"]]\n";
+    }
+    str += "EndPackage[]\n";
+    
+    auto bytes = std::vector<unsigned char>(str.begin(), str.end());
+    
+    IncrementalParserSession incremental;
+    
+    incremental.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    //
+    // Type a new definition in the middle, one byte at a time, and then a newline
+    //
+    // Without brackets, because an unclosed [ really does make the rest of the file one expression
+    //
+    const std::string typed = "h = a^2 + b;\n";
+    
+    auto off = bytes.size() / 2;
+    while (bytes[off - 1] != '\n') {
+        off++;
+    }
+    
+    size_t maxParsed = 0;
+    
+    for (size_t i = 0; i < typed.size(); i++) {
+        
+        ASSERT_TRUE(incremental.edit(off + i, 0, BufferAndLength(reinterpret_cast<Buffer>(typed.data() + i), 1)));
+        
+        maxParsed = std::max(maxParsed, incremental.getLastParsedSize());
+    }
+    
+    bytes.insert(bytes.begin() + off, typed.begin(), typed.end());
+    
+    EXPECT_LT(maxParsed, 200u);
+    
+    std::vector<std::string> incrementalExprs;
+    std::vector<std::vector<std::string>> incrementalOutOfBand;
+    
+    printParts(*incremental.getSession(), incremental.parseExpressions(), incrementalExprs, incrementalOutOfBand);
+    
+    incremental.deinit();
+    
+    std::vector<std::string> wholeExprs;
+    std::vector<std::vector<std::string>> wholeOutOfBand;
+    {
+        ParserSession whole;
+        
+        parseParts(whole, bytes, SOURCECONVENTION_LINECOLUMN, wholeExprs, wholeOutOfBand);
+    }
+    
+    EXPECT_EQ(incrementalExprs, wholeExprs);
+    EXPECT_EQ(incrementalOutOfBand, wholeOutOfBand);
+}
+
+//
+// Skipping issues and trivia must not change the expressions themselves
+//
+TEST_F(ParserSessionTest, FastPathMatchesDefault) {
+    
+    ParserSession session;
+    
+    for (auto& bytes : inputs) {
+        
+        std::vector<std::string> exprs;
+        std::vector<std::vector<std::string>> outOfBand;
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session.parseExpressions();
+        
+        printParts(session, N, exprs, outOfBand);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+        std::vector<std::string> fastExprs;
+        std::vector<std::vector<std::string>> fastOutOfBand;
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE | FAST_PATH_POLICY, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        N = session.parseExpressions();
+        
+        printParts(session, N, fastExprs, fastOutOfBand);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+        EXPECT_EQ(fastExprs, exprs);
+        
+        for (auto& v : fastOutOfBand) {
+            EXPECT_TRUE(v.empty());
+        }
+        
+        //
+        // Without INCLUDE_SOURCE, there are no locations to compare, but there are the same number of expressions
+        //
+        std::vector<std::string> noSourceExprs;
+        std::vector<std::vector<std::string>> noSourceOutOfBand;
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, FAST_PATH_POLICY, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        N = session.parseExpressions();
+        
+        printParts(session, N, noSourceExprs, noSourceOutOfBand);
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+        EXPECT_EQ(noSourceExprs.size(), exprs.size());
+    }
+}
+
+//
+// The columns of tokenizeArrays must be the tokens of tokenize
+//
+TEST_F(ParserSessionTest, TokenArraysMatchTokenize) {
+    
+    ParserSession session;
+    
+    TokenArrays A;
+    
+    for (auto& bytes : inputs) {
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        auto N = session.tokenize();
+        
+        std::vector<Token> toks;
+        for (auto& L : dynamic_cast<ListNode *>(N)->getNodes()) {
+            toks.push_back(L->lastToken());
+        }
+        
+        session.releaseAllNodes();
+        
+        session.deinit();
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        session.tokenizeArrays(A);
+        
+        session.deinit();
+        
+        ASSERT_EQ(A.size(), toks.size());
+        
+        for (size_t i = 0; i < toks.size(); i++) {
+            EXPECT_EQ(A.Toks[i], toks[i].Tok.value());
+            EXPECT_EQ(A.Starts[i], static_cast<uint32_t>(toks[i].BufLen.buffer - bytes.data()));
+            EXPECT_EQ(A.Ends[i], static_cast<uint32_t>(toks[i].BufLen.end - bytes.data()));
+            EXPECT_EQ(A.Srcs[i], toks[i].Src);
+        }
+    }
+}
+
+//
+// Columns that fill up must continue where they stopped, as TokenizeBytesArrays_LibraryLink does when it grows them
+//
+TEST_F(ParserSessionTest, TokenArraysWithCapacity) {
+    
+    ParserSession session;
+    
+    TokenArrays A;
+    
+    for (auto& bytes : inputs) {
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        session.tokenizeArrays(A);
+        
+        session.deinit();
+        
+        std::vector<uint16_t> Toks(A.size() + 3);
+        std::vector<uint32_t> Starts(A.size() + 3);
+        std::vector<uint32_t> Ends(A.size() + 3);
+        std::vector<Source> Srcs(A.size() + 3);
+        
+        session.init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+        
+        size_t n = 0;
+        
+        while (true) {
+            
+            auto written = session.tokenizeArrays(Toks.data() + n, Starts.data() + n, Ends.data() + n, Srcs.data() + n, 3);
+            
+            n += written;
+            
+            if (written < 3) {
+                break;
+            }
+        }
+        
+        session.deinit();
+        
+        ASSERT_EQ(n, A.size());
+        
+        for (size_t i = 0; i < n; i++) {
+            EXPECT_EQ(Toks[i], A.Toks[i]);
+            EXPECT_EQ(Starts[i], A.Starts[i]);
+            EXPECT_EQ(Ends[i], A.Ends[i]);
+            EXPECT_EQ(Srcs[i], A.Srcs[i]);
+        }
+    }
+}
+
+//
+// Splitting one input into chunks that are parsed on different threads must give the same result as parsing it
+// serially, whether or not the splits turn out to be safe
+//
+TEST_F(ParserSessionTest, ParallelChunksMatchSerial) {
+    
+    std::vector<std::vector<unsigned char>> bigInputs;
+    
+    //
+    // The whole corpus as one input, which has splits that are not safe, such as in the middle of unterminated groups
+    //
+    {
+        std::vector<unsigned char> bytes;
+        
+        for (auto& input : inputs) {
+            bytes.insert(bytes.end(), input.begin(), input.end());
+            bytes.push_back('\n');
+        }
+        
+        bigInputs.push_back(std::move(bytes));
+    }
+    
+    //
+    // A generated package, where every line can be split
+    //
+    {
+        std::string str;
+        
+        for (size_t i = 0; str.size() < 1000000; i++) {
+            str += "x[" + std::to_string(i) + "] = {" + std::to_string(i) + ", \"a\\n\tb\", (* ( *) 1.5, <|\"k\" -> \n\t" + std::to_string(i) + "|>};\n";
+        }
+        
+        bigInputs.push_back(std::vector<unsigned char>(str.begin(), str.end()));
+    }
+    
+    for (auto srcConvention : { SOURCECONVENTION_LINECOLUMN, SOURCECONVENTION_SOURCECHARACTERINDEX }) {
+        
+        for (size_t b = 0; b < bigInputs.size(); b++) {
+            
+            auto& bytes = bigInputs[b];
+            
+            ParserSession session;
+            
+            std::vector<std::string> serialExprs;
+            std::vector<std::vector<std::string>> serialOutOfBand;
+            
+            parseParts(session, bytes, srcConvention, serialExprs, serialOutOfBand);
+            
+            ParallelParserSession parallel(4);
+            
+            parallel.init(BufferAndLength(bytes.data(), bytes.size()), INCLUDE_SOURCE, srcConvention, DEFAULT_TAB_WIDTH, false);
+            
+            auto N = parallel.parseExpressions(nullptr);
+            
+            std::vector<std::string> parallelExprs;
+            std::vector<std::vector<std::string>> parallelOutOfBand;
+            
+            printParts(*parallel.getSession(), N, parallelExprs, parallelOutOfBand);
+            
+            if (b == 1) {
+                EXPECT_FALSE(parallel.wasSerial());
+            }
+            
+            parallel.deinit();
+            
+            EXPECT_EQ(parallelExprs, serialExprs) << b;
+            EXPECT_EQ(parallelOutOfBand, serialOutOfBand) << b;
+        }
+    }
+}
+
+//
+// Splits are only at the start of a line after something that ends an expression, outside of groups, strings, and
+// comments
+//
+TEST_F(ParserSessionTest, ParallelSplit) {
+    
+    std::string str = "f[\na]\n\"b\nc\"\n(* d\n*)\ne +\nf \\\ng\n<|\nh|>\n\\[Rule]\ni;\nj";
+    
+    auto buf = reinterpret_cast<Buffer>(str.data());
+    
+    auto splits = ParallelParserSession::split(BufferAndLength(buf, str.size()), false, str.size());
+    
+    std::vector<size_t> offsets;
+    for (auto S : splits) {
+        offsets.push_back(static_cast<size_t>(S - buf));
+    }
+    
+    //
+    // After  f[\na]  "b\nc"  (* d\n*)  e +\nf \\\ng  <|\nh|>  and  i;
+    //
+    std::vector<size_t> expected = {
+        str.find("\"b"),
+        str.find("(*"),
+        str.find("e +"),
+        str.find("<|"),
+        str.find("\\[Rule]"),
+        str.find("j"),
+    };
+    
+    EXPECT_EQ(offsets, expected);
+    
+    //
+    // The first line is skipped when it is a shebang
+    //
+    std::string shebang = "#!/usr/bin/env wolframscript\na\nb";
+    
+    splits = ParallelParserSession::split(BufferAndLength(reinterpret_cast<Buffer>(shebang.data()), shebang.size()), true, shebang.size());
+    
+    ASSERT_EQ(splits.size(), 1u);
+    EXPECT_EQ(static_cast<size_t>(splits[0] - reinterpret_cast<Buffer>(shebang.data())), shebang.find("\nb") + 1);
+}
+
+//
+// The abort callback is asked once every so many tokens, and every so many bytes inside of a single long token
+//
+TEST_F(ParserSessionTest, AbortIsBudgeted) {
+    
+    ParserSession session;
+    
+    size_t calls = 0;
+    
+    std::string many;
+    for (size_t i = 0; i < 100000; i++) {
+        many += "a;";
+    }
+    
+    session.init(BufferAndLength(reinterpret_cast<Buffer>(many.data()), many.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    session.currentAbortQ = [&calls]() {
+        calls++;
+        return false;
+    };
+    
+    auto N = session.parseExpressions();
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    EXPECT_GT(calls, 0u);
+    EXPECT_LT(calls, 1000u);
+    
+    //
+    // A single string token of 1MB, with characters that are not plain ASCII so that they are not skipped over
+    //
+    std::string one = "\"";
+    for (size_t i = 0; i < 512 * 1024; i++) {
+        one += "\xc3\xa9";
+    }
+    one += "\"";
+    
+    calls = 0;
+    
+    session.init(BufferAndLength(reinterpret_cast<Buffer>(one.data()), one.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    session.currentAbortQ = [&calls]() {
+        calls++;
+        return calls == 2;
+    };
+    
+    N = session.parseExpressions();
+    
+    EXPECT_TRUE(session.isAbort());
+    
+    session.releaseAllNodes();
+    
+    session.deinit();
+    
+    EXPECT_EQ(calls, 2u);
+}
@@ -7,20 +7,23 @@
 #include "gtest/gtest.h"
 
 #include <sstream>
+#include <fstream>
 
 
 
+static std::unique_ptr<ParserSession> session;
+
 class TokenizerTest : public ::testing::Test {
 protected:
     
     static void SetUpTestSuite() {
         
-        TheParserSession = std::unique_ptr<ParserSession>(new ParserSession);
+        session = std::unique_ptr<ParserSession>(new ParserSession);
     }
     
     static void TearDownTestSuite() {
         
-        TheParserSession.reset(nullptr);
+        session.reset(nullptr);
     }
     
     void SetUp() override {
@@ -28,7 +31,7 @@ protected:
     }
     
     void TearDown() override {
-        TheParserSession->deinit();
+        session->deinit();
     }
     
 };
@@ -42,7 +45,7 @@ TEST_F(TokenizerTest, Bug1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
     SUCCEED();
 }
@@ -56,11 +59,11 @@ TEST_F(TokenizerTest, Bug2) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
     
     SUCCEED();
 }
@@ -74,7 +77,7 @@ TEST_F(TokenizerTest, Bug3) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
     SUCCEED();
 }
@@ -85,7 +88,7 @@ TEST_F(TokenizerTest, Bug4) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
     SUCCEED();
 }
@@ -96,7 +99,7 @@ TEST_F(TokenizerTest, Bug5) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
     SUCCEED();
 }
@@ -107,21 +110,21 @@ TEST_F(TokenizerTest, IntegerRealMixup) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok1 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok1 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok1, Token(TOKEN_INTEGER, BufferAndLength(str, 1), Source(SourceLocation(1, 1), SourceLocation(1, 2))));
     
-    TheTokenizer->nextToken(Tok1);
+    session->tokenizer->nextToken(Tok1);
     
-    auto Tok2 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok2 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok2, Token(TOKEN_DOTDOT, BufferAndLength(str + 1, 2), Source(SourceLocation(1, 2), SourceLocation(1, 4))));
     
-    TheTokenizer->nextToken(Tok2);
+    session->tokenizer->nextToken(Tok2);
     
-    auto Tok3 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok3 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok3, Token(TOKEN_ENDOFFILE, BufferAndLength(str + 3, 0), Source(SourceLocation(1, 4), SourceLocation(1, 4))));
 }
@@ -132,27 +135,27 @@ TEST_F(TokenizerTest, Basic2) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok1 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok1 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok1, Token(TOKEN_SYMBOL, BufferAndLength(str + 0, 10), Source(SourceLocation(1, 1), SourceLocation(1, 11))));
     
-    TheTokenizer->nextToken(Tok1);
+    session->tokenizer->nextToken(Tok1);
     
-    auto Tok2 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok2 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok2, Token(TOKEN_PLUS, BufferAndLength(str + 10, 1), Source(SourceLocation(1, 11), SourceLocation(1, 12))));
     
-    TheTokenizer->nextToken(Tok2);
+    session->tokenizer->nextToken(Tok2);
     
-    auto Tok3 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok3 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok3, Token(TOKEN_INTEGER, BufferAndLength(str + 11, 1), Source(SourceLocation(1, 12), SourceLocation(1, 13))));
     
-    TheTokenizer->nextToken(Tok3);
+    session->tokenizer->nextToken(Tok3);
     
-    auto Tok4 = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok4 = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok4, Token(TOKEN_ENDOFFILE, BufferAndLength(str + 12, 0), Source(SourceLocation(1, 13), SourceLocation(1, 13))));
 }
@@ -163,9 +166,9 @@ TEST_F(TokenizerTest, OldAssert1) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok, Token(TOKEN_INTEGER, BufferAndLength(str, 1), Source(SourceLocation(1, 1), SourceLocation(1, 2))));
 }
@@ -176,70 +179,100 @@ TEST_F(TokenizerTest, Basic3) {
     
     auto str = reinterpret_cast<Buffer>(strIn.c_str());
     
-    TheParserSession->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(str, strIn.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok, Token(TOKEN_OPENCURLY, BufferAndLength(str, 1), Source(SourceLocation(1, 1), SourceLocation(1, 2))));
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
     
     //
     // Clear 0x100 because we are inside a group now
     //
-    Tok = TheTokenizer->currentToken(TOPLEVEL & ~(RETURN_TOPLEVELNEWLINE));
+    Tok = session->tokenizer->currentToken(TOPLEVEL & ~(RETURN_TOPLEVELNEWLINE));
     
     EXPECT_EQ(Tok, Token(TOKEN_INTERNALNEWLINE, BufferAndLength(str + 1, 1), Source(SourceLocation(1, 2), SourceLocation(2, 1))));
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
     
-    Tok = TheTokenizer->currentToken(TOPLEVEL);
+    Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok, Token(TOKEN_CLOSECURLY, BufferAndLength(str + 2, 1), Source(SourceLocation(2, 1), SourceLocation(2, 2))));
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
 }
 
 TEST_F(TokenizerTest, Basic4) {
     
     const unsigned char arr[] = { 0xff };
     
-    TheParserSession->init(BufferAndLength(arr, 1), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 1), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    EXPECT_EQ(TheByteDecoder->SrcLoc, SourceLocation(1, 1));
+    EXPECT_EQ(session->byteDecoder->SrcLoc, SourceLocation(1, 1));
     
-    EXPECT_EQ(TheByteBuffer->wasEOF, false);
+    EXPECT_EQ(session->byteBuffer->wasEOF, false);
     
-    auto Tok = TheTokenizer->currentToken(TOPLEVEL);
+    auto Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok, Token(TOKEN_SYMBOL, BufferAndLength(arr, 1, UTF8STATUS_INVALID), Source(SourceLocation(1, 1), SourceLocation(1, 2))));
     
-    EXPECT_EQ(TheByteDecoder->SrcLoc, SourceLocation(1, 1));
+    EXPECT_EQ(session->byteDecoder->SrcLoc, SourceLocation(1, 1));
     
-    EXPECT_EQ(TheByteBuffer->wasEOF, false);
+    EXPECT_EQ(session->byteBuffer->wasEOF, false);
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
     
-    Tok = TheTokenizer->currentToken(TOPLEVEL);
+    Tok = session->tokenizer->currentToken(TOPLEVEL);
     
     EXPECT_EQ(Tok, Token(TOKEN_ENDOFFILE, BufferAndLength(arr + 1, 0), Source(SourceLocation(1, 2), SourceLocation(1, 2))));
     
-    TheTokenizer->nextToken(Tok);
+    session->tokenizer->nextToken(Tok);
     
-    EXPECT_EQ(TheByteDecoder->SrcLoc, SourceLocation(1, 2));
+    EXPECT_EQ(session->byteDecoder->SrcLoc, SourceLocation(1, 2));
     
-    EXPECT_EQ(TheByteBuffer->wasEOF, true);
+    EXPECT_EQ(session->byteBuffer->wasEOF, true);
 }
 
 TEST_F(TokenizerTest, Crash1) {
     
     const unsigned char arr[] = { '6', '`', '5', '.', '.' };
     
-    TheParserSession->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH);
+    session->init(BufferAndLength(arr, 5), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
     
-    TheTokenizer->currentToken(TOPLEVEL);
+    session->tokenizer->currentToken(TOPLEVEL);
     
     SUCCEED();
 }
 
-
+//
+// Peeking at the same token again must not lex it again
+//
+// Every peek cache hit would have been another lex before the cache
+//
+TEST_F(TokenizerTest, LexOnce) {
+    
+    std::ifstream in(std::string(TESTS_FILES_DIR) + "/inputs-random.txt", std::ios::binary);
+    
+    auto bytes = std::vector<unsigned char>((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    
+    ASSERT_FALSE(bytes.empty());
+    
+    session->init(BufferAndLength(bytes.data(), bytes.size()), nullptr, INCLUDE_SOURCE, SOURCECONVENTION_LINECOLUMN, DEFAULT_TAB_WIDTH, false);
+    
+    auto N = session->parseExpressions();
+    
+    session->releaseAllNodes();
+    
+    auto lexes = session->tokenizer->getLexCount();
+    auto hits = session->tokenizer->getPeekHitCount();
+    auto tokens = session->tokenizer->getTokenCount();
+    
+    ASSERT_GT(tokens, 0u);
+    EXPECT_GT(hits, 0u);
+    
+    auto before = static_cast<double>(lexes + hits) / tokens;
+    auto after = static_cast<double>(lexes) / tokens;
+    
+    EXPECT_LT(after, before);
+}
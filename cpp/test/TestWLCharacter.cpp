@@ -177,3 +177,25 @@ TEST_F(WLCharacterTest, RawGraphical) {
     EXPECT_EQ(c.graphicalString(), "~");
     
 }
+
+TEST_F(WLCharacterTest, MBClass) {
+    
+    EXPECT_EQ(WLCharacter(CODEPOINT_LINEARSYNTAX_SPACE).mbClass(), MBCLASS_LINEARSYNTAX);
+    EXPECT_EQ(WLCharacter(CODEPOINT_STRINGMETA_DOUBLEQUOTE).mbClass(), MBCLASS_STRINGMETA);
+    EXPECT_EQ(WLCharacter(CODEPOINT_CRLF).mbClass(), MBCLASS_NEWLINE);
+    EXPECT_EQ(WLCharacter(CODEPOINT_ENDOFFILE).mbClass(), 0);
+    
+    EXPECT_TRUE(WLCharacter(CODEPOINT_LONGNAME_ALPHA, ESCAPE_LONGNAME).isMBLetterlike());
+    EXPECT_FALSE(WLCharacter(CODEPOINT_LONGNAME_ALPHA, ESCAPE_LONGNAME).isMBStrangeLetterlike());
+    EXPECT_TRUE(WLCharacter(CODEPOINT_LONGNAME_WOLF, ESCAPE_LONGNAME).isMBStrangeLetterlike());
+    EXPECT_FALSE(WLCharacter(CODEPOINT_CRLF).isMBStrangeNewline());
+    EXPECT_TRUE(WLCharacter(CODEPOINT_LONGNAME_LINESEPARATOR).isMBStrangeNewline());
+    
+    //
+    // Unsupported characters are only unsupported as long names
+    //
+    EXPECT_TRUE(WLCharacter(CODEPOINT_LONGNAME_INLINEPART, ESCAPE_LONGNAME).isMBUnsupported());
+    EXPECT_FALSE(WLCharacter(CODEPOINT_LONGNAME_INLINEPART, ESCAPE_LONGNAME).isMBLetterlike());
+    EXPECT_FALSE(WLCharacter(CODEPOINT_LONGNAME_INLINEPART).isMBUnsupported());
+    EXPECT_TRUE(WLCharacter(CODEPOINT_LONGNAME_INLINEPART).isMBLetterlike());
+}